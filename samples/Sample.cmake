@@ -16,14 +16,41 @@ function(add_sample_inner_gles3 TARGET SOURCES)
 	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/jni)
 endfunction()
 
+# Samples whose JNI entry points are only compiled for Android. On other platforms they are built as
+# plain shared libraries, which malisdk-benchmark loads and runs off-screen. AssetLoading is left out
+# because it links the prebuilt Android Assimp library.
+set(HOST_SAMPLES
+	AntiAlias Cube EGLPreserve ETCAtlasAlpha ETCCompressedAlpha ETCMipmap ETCUncompressedAlpha FrameBufferObject
+	Metaballs MultisampledFBO RotoZoom Template Triangle
+	Boids EtcTexture InstancedTessellation Instancing IntegerLogic Lighting MinMaxBlending Mipmapping
+	Multiview NormalMapping OcclusionQueries ProjectedLights ShadowMapping SimpleCube SimpleTriangle TextureCube Vbo)
+
+function(add_sample_host TARGET SOURCES COMMON_LIBRARY)
+	add_library(${TARGET} SHARED ${SOURCES})
+	target_link_libraries(${TARGET} ${COMMON_LIBRARY})
+	target_include_directories(${TARGET} PRIVATE ${CMAKE_CURRENT_SOURCE_DIR}/jni)
+	# On Android the assets are extracted to the application's data directory. On the host the sample reads
+	# a copy in the build tree, so files it writes there, such as caches, stay out of the source tree.
+	if (EXISTS ${CMAKE_CURRENT_SOURCE_DIR}/assets)
+		file(COPY ${CMAKE_CURRENT_SOURCE_DIR}/assets/ DESTINATION ${CMAKE_CURRENT_BINARY_DIR}/assets)
+	endif()
+	target_compile_definitions(${TARGET} PRIVATE ASSET_DIRECTORY="${CMAKE_CURRENT_BINARY_DIR}/assets/")
+endfunction()
+
+# Samples are JNI libraries, so on Android only the one selected by FILTER_TARGET is built.
+# Other platforms build common-native and the samples listed in HOST_SAMPLES.
 function(add_sample TARGET SOURCES)
-	if (${FILTER_TARGET} STREQUAL ${TARGET})
+	if (ANDROID AND "${FILTER_TARGET}" STREQUAL ${TARGET})
 		add_sample_inner(${TARGET} "${SOURCES}")
-	endif(${FILTER_TARGET} STREQUAL ${TARGET})
+	elseif (NOT ANDROID AND ${TARGET} IN_LIST HOST_SAMPLES)
+		add_sample_host(${TARGET} "${SOURCES}" common-native)
+	endif()
 endfunction()
 
 function(add_sample_gles3 TARGET SOURCES)
-	if (${FILTER_TARGET} STREQUAL ${TARGET})
+	if (ANDROID AND "${FILTER_TARGET}" STREQUAL ${TARGET})
 		add_sample_inner_gles3(${TARGET} "${SOURCES}")
-	endif(${FILTER_TARGET} STREQUAL ${TARGET})
+	elseif (NOT ANDROID AND ${TARGET} IN_LIST HOST_SAMPLES)
+		add_sample_host(${TARGET} "${SOURCES}" common-native-gles3)
+	endif()
 endfunction()
@@ -0,0 +1,40 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#version 100
+#ifdef GL_OES_standard_derivatives
+#extension GL_OES_standard_derivatives : enable
+#endif
+precision mediump float;
+uniform sampler2D u_s2dTexture;
+varying vec2 v_v2TexCoord;
+varying vec4 v_v4FontColor;
+void main()
+{
+    /* The outline is at 128 / 255; smooth over about one screen pixel around it. */
+    float distance = texture2D(u_s2dTexture, v_v2TexCoord).r;
+#ifdef GL_OES_standard_derivatives
+    float smoothing = 0.7 * fwidth(distance);
+#else
+    float smoothing = 0.06;
+#endif
+    float coverage = smoothstep(0.502 - smoothing, 0.502 + smoothing, distance);
+    gl_FragColor = vec4(v_v4FontColor.rgb, v_v4FontColor.a * coverage);
+}
@@ -37,24 +37,37 @@
 #include <cstdlib>
 #include <cmath>
 #include <string>
+#include <vector>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 #include <unistd.h> 
 
 #include "AntiAlias.h"
 #include "Text.h"
+#include "SDFFont.h"
 #include "Shader.h"
 #include "Matrix.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
+using std::vector;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.antialias/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string vertexShaderFilename = "AntiAlias_triangle.vert";
 string fragmentShaderFilename = "AntiAlias_triangle.frag";
+string fontShaderFilename = "font_sdf.frag";
+string fontCacheFilename = "font.sdf";
 
 /* Shader variables. */
 GLuint programID = 0;
@@ -68,6 +81,9 @@ int numberOfSamples = 0;
 /* A text object to draw text on the screen. */ 
 Text* text;
 
+/* Signed distance field atlas of the text, generated from the bitmap font on the first launch. */
+SDFFont font;
+
 bool setupGraphics(int width, int height)
 {
     /* Full paths to the shader files */
@@ -79,8 +95,18 @@ bool setupGraphics(int width, int height)
     /* Should do src * (src alpha) + dest * (1-src alpha). */
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
-    /* Initialize the Text object and add some text. */
-    text = new Text(resourceDirectory.c_str(), width, height);
+    /* Initialize the Text object and add some text. font.raw is a 256x48 grid of characters, starting with a space. */
+    string bitmapFontPath = resourceDirectory + "font.raw";
+    string fontCachePath = resourceDirectory + fontCacheFilename;
+    BitmapFontGlyphSource glyphSource(bitmapFontPath.c_str(), 256, 48, Text::textureCharacterWidth, Text::textureCharacterHeight, ' ');
+    vector<unsigned int> codePoints;
+    SDFFont::addCodePoints(' ', '~', &codePoints);
+    if (!font.create(&glyphSource, codePoints, fontCachePath.c_str()))
+    {
+        LOGE("Could not create the font atlas.");
+        return false;
+    }
+    text = new Text(resourceDirectory.c_str(), width, height, &font);
     text->addString(0, 0, "Anti-aliased triangle", 255, 255, 0, 255);
 
     /* Process shaders. */
@@ -173,6 +199,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
 
@@ -182,6 +209,7 @@ extern "C"
         /* Make sure that all resource files are in place */
         AndroidPlatform::getAndroidAsset(env, resourceDirectory.c_str(), vertexShaderFilename.c_str());
         AndroidPlatform::getAndroidAsset(env, resourceDirectory.c_str(), fragmentShaderFilename.c_str());
+        AndroidPlatform::getAndroidAsset(env, resourceDirectory.c_str(), fontShaderFilename.c_str());
 
         setupGraphics(width, height);
     }
@@ -189,6 +217,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_antialias_AntiAlias_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -198,3 +227,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("AntiAlias", setupGraphics, renderFrame)
@@ -0,0 +1,960 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AstcDecoder.h"
+#include "ParallelBands.h"
+
+#include <cstring>
+#include <vector>
+
+namespace AstcTextures
+{
+    /* Integer sequence encoding of a range: number of levels, and whether each value carries a trit or a quint on top of its bits. */
+    typedef struct integer_range
+    {
+        int n_levels;
+        int n_trits;
+        int n_quints;
+        int n_bits;
+    } integer_range;
+
+    static const integer_range integer_ranges[] =
+    {
+        {   2, 0, 0, 1 }, {   3, 1, 0, 0 }, {   4, 0, 0, 2 }, {   5, 0, 1, 0 }, {   6, 1, 0, 1 }, {   8, 0, 0, 3 },
+        {  10, 0, 1, 1 }, {  12, 1, 0, 2 }, {  16, 0, 0, 4 }, {  20, 0, 1, 2 }, {  24, 1, 0, 3 }, {  32, 0, 0, 5 },
+        {  40, 0, 1, 3 }, {  48, 1, 0, 4 }, {  64, 0, 0, 6 }, {  80, 0, 1, 4 }, {  96, 1, 0, 5 }, { 128, 0, 0, 7 },
+        { 160, 0, 1, 5 }, { 192, 1, 0, 6 }, { 256, 0, 0, 8 }
+    };
+
+    /* Colour endpoints need at least 6 levels. */
+    static const int min_color_range = 4;
+    static const int n_integer_ranges = sizeof(integer_ranges) / sizeof(integer_ranges[0]);
+
+    /* Block data is padded so that bit reads never run past the end of the buffer. */
+    static const int padded_block_size = 20;
+
+    /* Work description for one band of block rows. */
+    typedef struct decode_band
+    {
+        const AstcDecoder*   decoder;
+        const unsigned char* data;
+        int                  width;
+        int                  height;
+        unsigned char*       rgba;
+        int                  first_block_row;
+        int                  end_block_row;
+        int                  n_error_blocks;
+    } decode_band;
+
+    static inline int clamp_to_byte(int value)
+    {
+        return value < 0 ? 0 : (value > 255 ? 255 : value);
+    }
+
+    /* Read up to 24 bits starting at any bit position. */
+    static inline int read_bits(const unsigned char* data, int position, int n_bits)
+    {
+        const int byte = position >> 3;
+        const unsigned int word = data[byte] | (data[byte + 1] << 8) | (data[byte + 2] << 16) | ((unsigned int)data[byte + 3] << 24);
+
+        return (int)((word >> (position & 7)) & ((1u << n_bits) - 1));
+    }
+
+    /* Read bits of an integer sequence. Bits past the end of the sequence are implicitly zero. */
+    static inline int read_sequence_bits(const unsigned char* data, int* position, int n_bits, int end)
+    {
+        int value = 0;
+
+        if (*position < end)
+        {
+            value = read_bits(data, *position, n_bits);
+
+            if (*position + n_bits > end)
+            {
+                value &= (1 << (end - *position)) - 1;
+            }
+        }
+
+        *position += n_bits;
+
+        return value;
+    }
+
+    static int get_sequence_length(const integer_range& range, int n_values)
+    {
+        return range.n_bits * n_values + (range.n_trits ? (8 * n_values + 4) / 5 : 0) + (range.n_quints ? (7 * n_values + 2) / 3 : 0);
+    }
+
+    /* Split the 8 bits of a trit block into five trits. */
+    static void decode_trits(int t, int* trits)
+    {
+        int c = 0;
+
+        if (((t >> 2) & 7) == 7)
+        {
+            c = (((t >> 5) & 7) << 2) | (t & 3);
+            trits[4] = 2;
+            trits[3] = 2;
+        }
+        else
+        {
+            c = t & 0x1F;
+
+            if (((t >> 5) & 3) == 3)
+            {
+                trits[4] = 2;
+                trits[3] = (t >> 7) & 1;
+            }
+            else
+            {
+                trits[4] = (t >> 7) & 1;
+                trits[3] = (t >> 5) & 3;
+            }
+        }
+
+        if ((c & 3) == 3)
+        {
+            trits[2] = 2;
+            trits[1] = (c >> 4) & 1;
+            trits[0] = (((c >> 3) & 1) << 1) | ((c >> 2) & 1 & ~(c >> 3));
+        }
+        else if (((c >> 2) & 3) == 3)
+        {
+            trits[2] = 2;
+            trits[1] = 2;
+            trits[0] = c & 3;
+        }
+        else
+        {
+            trits[2] = (c >> 4) & 1;
+            trits[1] = (c >> 2) & 3;
+            trits[0] = (c & 2) | (c & 1 & ~(c >> 1));
+        }
+    }
+
+    /* Split the 7 bits of a quint block into three quints. */
+    static void decode_quints(int q, int* quints)
+    {
+        if (((q >> 1) & 3) == 3 && ((q >> 5) & 3) == 0)
+        {
+            quints[2] = ((q & 1) << 2) | (((q >> 4) & 1 & ~q) << 1) | ((q >> 3) & 1 & ~q);
+            quints[1] = 4;
+            quints[0] = 4;
+            return;
+        }
+
+        int c = 0;
+
+        if (((q >> 1) & 3) == 3)
+        {
+            quints[2] = 4;
+            c = (((q >> 3) & 3) << 3) | ((~(q >> 5) & 3) << 1) | (q & 1);
+        }
+        else
+        {
+            quints[2] = (q >> 5) & 3;
+            c = q & 0x1F;
+        }
+
+        if ((c & 7) == 5)
+        {
+            quints[1] = 4;
+            quints[0] = (c >> 3) & 3;
+        }
+        else
+        {
+            quints[1] = (c >> 3) & 3;
+            quints[0] = c & 7;
+        }
+    }
+
+    /* Decode n_values integers of an integer sequence starting at bit position. */
+    static void decode_sequence(const unsigned char* data, int position, int n_values, const integer_range& range, int* values)
+    {
+        const int end = position + get_sequence_length(range, n_values);
+        const int bits = range.n_bits;
+
+        for (int first = 0; first < n_values; )
+        {
+            if (range.n_trits)
+            {
+                int m[5];
+                int t = 0;
+                int trits[5];
+
+                m[0] = read_sequence_bits(data, &position, bits, end);
+                t   |= read_sequence_bits(data, &position, 2, end);
+                m[1] = read_sequence_bits(data, &position, bits, end);
+                t   |= read_sequence_bits(data, &position, 2, end) << 2;
+                m[2] = read_sequence_bits(data, &position, bits, end);
+                t   |= read_sequence_bits(data, &position, 1, end) << 4;
+                m[3] = read_sequence_bits(data, &position, bits, end);
+                t   |= read_sequence_bits(data, &position, 2, end) << 5;
+                m[4] = read_sequence_bits(data, &position, bits, end);
+                t   |= read_sequence_bits(data, &position, 1, end) << 7;
+
+                decode_trits(t, trits);
+
+                for (int i = 0; i < 5 && first < n_values; i++, first++)
+                {
+                    values[first] = (trits[i] << bits) | m[i];
+                }
+            }
+            else if (range.n_quints)
+            {
+                int m[3];
+                int q = 0;
+                int quints[3];
+
+                m[0] = read_sequence_bits(data, &position, bits, end);
+                q   |= read_sequence_bits(data, &position, 3, end);
+                m[1] = read_sequence_bits(data, &position, bits, end);
+                q   |= read_sequence_bits(data, &position, 2, end) << 3;
+                m[2] = read_sequence_bits(data, &position, bits, end);
+                q   |= read_sequence_bits(data, &position, 2, end) << 5;
+
+                decode_quints(q, quints);
+
+                for (int i = 0; i < 3 && first < n_values; i++, first++)
+                {
+                    values[first] = (quints[i] << bits) | m[i];
+                }
+            }
+            else
+            {
+                values[first++] = read_sequence_bits(data, &position, bits, end);
+            }
+        }
+    }
+
+    /* Replicate the n_bits low bits of value until n_target_bits bits are filled. */
+    static int replicate_bits(int value, int n_bits, int n_target_bits)
+    {
+        int result = 0;
+        int n_filled = 0;
+
+        while (n_filled < n_target_bits)
+        {
+            const int shift = n_target_bits - n_filled - n_bits;
+
+            result |= shift >= 0 ? value << shift : value >> -shift;
+            n_filled += n_bits;
+        }
+
+        return result;
+    }
+
+    /* Map an encoded colour endpoint value to [0, 255]. */
+    static int unquantize_color(const integer_range& range, int value)
+    {
+        if (!range.n_trits && !range.n_quints)
+        {
+            return replicate_bits(value, range.n_bits, 8);
+        }
+
+        const int m = value & ((1 << range.n_bits) - 1);
+        const int d = value >> range.n_bits;
+        const int a = (m & 1) ? 0x1FF : 0;
+        const int b = (m >> 1) & 1;
+        const int c = (m >> 2) & 1;
+        const int e = (m >> 3) & 1;
+        const int f = (m >> 4) & 1;
+        const int g = (m >> 5) & 1;
+
+        /* Bit patterns and scale factors from the colour unquantisation table of the specification. */
+        int bb = 0;
+        int cc = 0;
+
+        switch (range.n_levels)
+        {
+            case   6: bb = 0;                                                                   cc = 204; break;
+            case  10: bb = 0;                                                                   cc = 113; break;
+            case  12: bb = (b << 8) | (b << 4) | (b << 2) | (b << 1);                             cc =  93; break;
+            case  20: bb = (b << 8) | (b << 3) | (b << 2);                                        cc =  54; break;
+            case  24: bb = (c << 8) | (b << 7) | (c << 3) | (b << 2) | (c << 1) | b;              cc =  44; break;
+            case  40: bb = (c << 8) | (b << 7) | (c << 2) | (b << 1) | c;                         cc =  26; break;
+            case  48: bb = (e << 8) | (c << 7) | (b << 6) | (e << 2) | (c << 1) | b;              cc =  22; break;
+            case  80: bb = (e << 8) | (c << 7) | (b << 6) | (e << 1) | c;                         cc =  13; break;
+            case  96: bb = (f << 8) | (e << 7) | (c << 6) | (b << 5) | (f << 1) | e;              cc =  11; break;
+            case 160: bb = (f << 8) | (e << 7) | (c << 6) | (b << 5) | f;                         cc =   6; break;
+            case 192: bb = (g << 8) | (f << 7) | (e << 6) | (c << 5) | (b << 4) | g;              cc =   5; break;
+            default:  break;
+        }
+
+        const int t = (d * cc + bb) ^ a;
+
+        return (a & 0x80) | (t >> 2);
+    }
+
+    /* Map an encoded weight to [0, 64]. */
+    static int unquantize_weight(const integer_range& range, int value)
+    {
+        int result = 0;
+
+        if (!range.n_trits && !range.n_quints)
+        {
+            result = replicate_bits(value, range.n_bits, 6);
+        }
+        else if (range.n_bits == 0)
+        {
+            /* 3 and 5 levels are evenly spaced. */
+            return value * 64 / (range.n_levels - 1);
+        }
+        else
+        {
+            const int m = value & ((1 << range.n_bits) - 1);
+            const int d = value >> range.n_bits;
+            const int a = (m & 1) ? 0x7F : 0;
+            const int b = (m >> 1) & 1;
+            const int c = (m >> 2) & 1;
+
+            int bb = 0;
+            int cc = 0;
+
+            switch (range.n_levels)
+            {
+                case  6: bb = 0;                                        cc = 50; break;
+                case 10: bb = 0;                                        cc = 28; break;
+                case 12: bb = (b << 6) | (b << 2) | b;                  cc = 23; break;
+                case 20: bb = (b << 6) | (b << 1);                      cc = 13; break;
+                case 24: bb = (c << 6) | (b << 5) | (c << 1) | b;       cc = 11; break;
+                default: break;
+            }
+
+            const int t = (d * cc + bb) ^ a;
+
+            result = (a & 0x20) | (t >> 2);
+        }
+
+        return result > 32 ? result + 1 : result;
+    }
+
+    static void bit_transfer_signed(int* a, int* b)
+    {
+        *b >>= 1;
+        *b |= *a & 0x80;
+        *a >>= 1;
+        *a &= 0x3F;
+
+        if (*a & 0x20)
+        {
+            *a -= 0x40;
+        }
+    }
+
+    static void set_endpoint(int* endpoint, int r, int g, int b, int a)
+    {
+        endpoint[0] = clamp_to_byte(r);
+        endpoint[1] = clamp_to_byte(g);
+        endpoint[2] = clamp_to_byte(b);
+        endpoint[3] = clamp_to_byte(a);
+    }
+
+    /* Move some of the blue precision into red and green. */
+    static void set_blue_contracted_endpoint(int* endpoint, int r, int g, int b, int a)
+    {
+        set_endpoint(endpoint, (r + b) >> 1, (g + b) >> 1, b, a);
+    }
+
+    /* Build the two endpoints of a partition from its unquantised values. Returns false for HDR modes. */
+    static bool decode_endpoints(int mode, const int* values, int* endpoint0, int* endpoint1)
+    {
+        int v[8];
+
+        memcpy(v, values, sizeof(v));
+
+        switch (mode)
+        {
+            case 0: /* Luminance, direct. */
+                set_endpoint(endpoint0, v[0], v[0], v[0], 255);
+                set_endpoint(endpoint1, v[1], v[1], v[1], 255);
+                return true;
+            case 1: /* Luminance, base and offset. */
+            {
+                const int l0 = (v[0] >> 2) | (v[1] & 0xC0);
+                const int l1 = l0 + (v[1] & 0x3F);
+
+                set_endpoint(endpoint0, l0, l0, l0, 255);
+                set_endpoint(endpoint1, l1, l1, l1, 255);
+                return true;
+            }
+            case 4: /* Luminance and alpha, direct. */
+                set_endpoint(endpoint0, v[0], v[0], v[0], v[2]);
+                set_endpoint(endpoint1, v[1], v[1], v[1], v[3]);
+                return true;
+            case 5: /* Luminance and alpha, base and offset. */
+                bit_transfer_signed(&v[1], &v[0]);
+                bit_transfer_signed(&v[3], &v[2]);
+                set_endpoint(endpoint0, v[0], v[0], v[0], v[2]);
+                set_endpoint(endpoint1, v[0] + v[1], v[0] + v[1], v[0] + v[1], v[2] + v[3]);
+                return true;
+            case 6: /* RGB, base and scale. */
+                set_endpoint(endpoint0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, 255);
+                set_endpoint(endpoint1, v[0], v[1], v[2], 255);
+                return true;
+            case 8:  /* RGB, direct. */
+            case 12: /* RGBA, direct. */
+            {
+                const int a0 = mode == 12 ? v[6] : 255;
+                const int a1 = mode == 12 ? v[7] : 255;
+
+                if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+                {
+                    set_endpoint(endpoint0, v[0], v[2], v[4], a0);
+                    set_endpoint(endpoint1, v[1], v[3], v[5], a1);
+                }
+                else
+                {
+                    set_blue_contracted_endpoint(endpoint0, v[1], v[3], v[5], a1);
+                    set_blue_contracted_endpoint(endpoint1, v[0], v[2], v[4], a0);
+                }
+                return true;
+            }
+            case 9:  /* RGB, base and offset. */
+            case 13: /* RGBA, base and offset. */
+            {
+                bit_transfer_signed(&v[1], &v[0]);
+                bit_transfer_signed(&v[3], &v[2]);
+                bit_transfer_signed(&v[5], &v[4]);
+
+                int a0 = 255;
+                int a1 = 255;
+
+                if (mode == 13)
+                {
+                    bit_transfer_signed(&v[7], &v[6]);
+                    a0 = v[6];
+                    a1 = v[6] + v[7];
+                }
+
+                if (v[1] + v[3] + v[5] >= 0)
+                {
+                    set_endpoint(endpoint0, v[0], v[2], v[4], a0);
+                    set_endpoint(endpoint1, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                }
+                else
+                {
+                    set_blue_contracted_endpoint(endpoint0, v[0] + v[1], v[2] + v[3], v[4] + v[5], a1);
+                    set_blue_contracted_endpoint(endpoint1, v[0], v[2], v[4], a0);
+                }
+                return true;
+            }
+            case 10: /* RGB, base and scale, plus two alpha values. */
+                set_endpoint(endpoint0, (v[0] * v[3]) >> 8, (v[1] * v[3]) >> 8, (v[2] * v[3]) >> 8, v[4]);
+                set_endpoint(endpoint1, v[0], v[1], v[2], v[5]);
+                return true;
+            default:
+                /* Modes 2, 3, 7, 11, 14 and 15 are HDR only. */
+                return false;
+        }
+    }
+
+    static unsigned int hash52(unsigned int p)
+    {
+        p ^= p >> 15;
+        p -= p << 17;
+        p += p << 7;
+        p += p << 4;
+        p ^= p >> 5;
+        p += p << 16;
+        p ^= p >> 7;
+        p ^= p >> 3;
+        p ^= p << 6;
+        p ^= p >> 17;
+
+        return p;
+    }
+
+    /* Partition assignment function of the specification. */
+    static int select_partition(int seed, int x, int y, int n_partitions, bool small_block)
+    {
+        if (small_block)
+        {
+            x <<= 1;
+            y <<= 1;
+        }
+
+        seed += (n_partitions - 1) * 1024;
+
+        const unsigned int rnum = hash52(seed);
+
+        int seeds[8];
+
+        for (int i = 0; i < 8; i++)
+        {
+            const int s = (rnum >> (i * 4)) & 0xF;
+
+            seeds[i] = s * s;
+        }
+
+        int sh1 = 0;
+        int sh2 = 0;
+
+        if (seed & 1)
+        {
+            sh1 = (seed & 2) ? 4 : 5;
+            sh2 = (n_partitions == 3) ? 6 : 5;
+        }
+        else
+        {
+            sh1 = (n_partitions == 3) ? 6 : 5;
+            sh2 = (seed & 2) ? 4 : 5;
+        }
+
+        int a = ((seeds[0] >> sh1) * x + (seeds[1] >> sh2) * y + (rnum >> 14)) & 0x3F;
+        int b = ((seeds[2] >> sh1) * x + (seeds[3] >> sh2) * y + (rnum >> 10)) & 0x3F;
+        int c = ((seeds[4] >> sh1) * x + (seeds[5] >> sh2) * y + (rnum >>  6)) & 0x3F;
+        int d = ((seeds[6] >> sh1) * x + (seeds[7] >> sh2) * y + (rnum >>  2)) & 0x3F;
+
+        if (n_partitions < 4)
+        {
+            d = 0;
+        }
+        if (n_partitions < 3)
+        {
+            c = 0;
+        }
+
+        if (a >= b && a >= c && a >= d)
+        {
+            return 0;
+        }
+        if (b >= c && b >= d)
+        {
+            return 1;
+        }
+        return c >= d ? 2 : 3;
+    }
+
+    /* Please see header for specification. */
+    AstcDecoder::AstcDecoder(const int block_width, const int block_height, const bool srgb)
+        : block_width(block_width)
+        , block_height(block_height)
+        , srgb(srgb)
+    {
+        const int  n_texels    = block_width * block_height;
+        const bool small_block = n_texels < 31;
+
+        /* Hashing is the expensive part of partitioning, so do it once for every seed rather than for every block. */
+        partition_table.resize(3 * 1024 * n_texels);
+
+        for (int n_partitions = 2; n_partitions <= 4; n_partitions++)
+        {
+            for (int seed = 0; seed < 1024; seed++)
+            {
+                unsigned char* partitions = &partition_table[((n_partitions - 2) * 1024 + seed) * n_texels];
+
+                for (int y = 0; y < block_height; y++)
+                {
+                    for (int x = 0; x < block_width; x++)
+                    {
+                        partitions[y * block_width + x] = (unsigned char)select_partition(seed, x, y, n_partitions, small_block);
+                    }
+                }
+            }
+        }
+    }
+
+    /* Please see header for specification. */
+    bool AstcDecoder::decodeBlock(const unsigned char* block, unsigned char* rgba, const int rgba_stride) const
+    {
+        unsigned char data[padded_block_size] = { 0 };
+
+        memcpy(data, block, 16);
+
+        const int block_mode = read_bits(data, 0, 11);
+
+        /* Void-extent blocks hold one constant colour. */
+        if ((block_mode & 0x1FF) == 0x1FC)
+        {
+            const bool hdr         = (block_mode & 0x200) != 0;
+            const bool coordinates = read_bits(data, 12, 13) != 0x1FFF || read_bits(data, 25, 13) != 0x1FFF ||
+                                     read_bits(data, 38, 13) != 0x1FFF || read_bits(data, 51, 13) != 0x1FFF;
+            const bool invalid     = coordinates && (read_bits(data, 12, 13) >= read_bits(data, 25, 13) ||
+                                                     read_bits(data, 38, 13) >= read_bits(data, 51, 13));
+
+            /* Bits 10 and 11 are reserved and must be set. */
+            if (!hdr && read_bits(data, 10, 2) == 3 && !invalid)
+            {
+                unsigned char color[4];
+
+                for (int channel = 0; channel < 4; channel++)
+                {
+                    const int value = data[8 + channel * 2] | (data[9 + channel * 2] << 8);
+
+                    color[channel] = (unsigned char)(value >> 8);
+                }
+
+                for (int y = 0; y < block_height; y++)
+                {
+                    for (int x = 0; x < block_width; x++)
+                    {
+                        memcpy(rgba + y * rgba_stride + x * 4, color, 4);
+                    }
+                }
+                return true;
+            }
+        }
+        else
+        {
+            /* Weight grid size, weight range and dual plane flag from the block mode table of the specification. */
+            int  grid_width   = 0;
+            int  grid_height  = 0;
+            int  range        = 0;
+            bool high_range   = (block_mode >> 9) & 1;
+            bool dual_plane   = (block_mode >> 10) & 1;
+            bool valid        = true;
+            const int a       = (block_mode >> 5) & 3;
+
+            if (block_mode & 3)
+            {
+                const int b = (block_mode >> 7) & 3;
+
+                range = ((block_mode & 3) << 1) | ((block_mode >> 4) & 1);
+
+                switch ((block_mode >> 2) & 3)
+                {
+                    case 0:  grid_width = b + 4; grid_height = a + 2; break;
+                    case 1:  grid_width = b + 8; grid_height = a + 2; break;
+                    case 2:  grid_width = a + 2; grid_height = b + 8; break;
+                    default:
+                        if (block_mode & 0x100)
+                        {
+                            grid_width  = (b & 1) + 2;
+                            grid_height = a + 2;
+                        }
+                        else
+                        {
+                            grid_width  = a + 2;
+                            grid_height = (b & 1) + 6;
+                        }
+                        break;
+                }
+            }
+            else
+            {
+                range = (((block_mode >> 2) & 3) << 1) | ((block_mode >> 4) & 1);
+
+                switch ((block_mode >> 7) & 3)
+                {
+                    case 0:  grid_width = 12;    grid_height = a + 2; break;
+                    case 1:  grid_width = a + 2; grid_height = 12;    break;
+                    case 2:
+                        grid_width  = a + 6;
+                        grid_height = ((block_mode >> 9) & 3) + 6;
+                        high_range  = false;
+                        dual_plane  = false;
+                        break;
+                    default:
+                        if (a == 0)
+                        {
+                            grid_width  = 6;
+                            grid_height = 10;
+                        }
+                        else if (a == 1)
+                        {
+                            grid_width  = 10;
+                            grid_height = 6;
+                        }
+                        else
+                        {
+                            valid = false;
+                        }
+                        break;
+                }
+            }
+
+            const int n_partitions = read_bits(data, 11, 2) + 1;
+            const int n_planes     = dual_plane ? 2 : 1;
+            const int n_weights    = grid_width * grid_height * n_planes;
+
+            valid = valid && range >= 2 && grid_width <= block_width && grid_height <= block_height &&
+                    n_weights <= 64 && !(dual_plane && n_partitions == 4);
+
+            const integer_range& weight_range = integer_ranges[valid ? range - 2 + (high_range ? 6 : 0) : 0];
+            const int n_weight_bits = get_sequence_length(weight_range, n_weights);
+
+            valid = valid && n_weight_bits >= 24 && n_weight_bits <= 96;
+
+            if (valid)
+            {
+                /* Endpoint modes, and the position of the colour data and of the bits stored below the weights. */
+                int modes[4];
+                int color_start       = 17;
+                int below_weights     = 128 - n_weight_bits;
+
+                if (n_partitions == 1)
+                {
+                    modes[0] = read_bits(data, 13, 4);
+                }
+                else
+                {
+                    color_start = 29;
+
+                    int encoded_modes = read_bits(data, 23, 6);
+
+                    if ((encoded_modes & 3) == 0)
+                    {
+                        for (int partition = 0; partition < n_partitions; partition++)
+                        {
+                            modes[partition] = (encoded_modes >> 2) & 0xF;
+                        }
+                    }
+                    else
+                    {
+                        /* Per-partition modes spill into the bits just below the weights. */
+                        const int n_extra_bits = 3 * n_partitions - 4;
+
+                        below_weights -= n_extra_bits;
+                        encoded_modes |= read_bits(data, below_weights, n_extra_bits) << 6;
+
+                        const int base_class = (encoded_modes & 3) - 1;
+
+                        for (int partition = 0; partition < n_partitions; partition++)
+                        {
+                            modes[partition] = ((((encoded_modes >> (2 + partition)) & 1) + base_class) << 2) |
+                                               ((encoded_modes >> (2 + n_partitions + partition * 2)) & 3);
+                        }
+                    }
+                }
+
+                int plane2_channel = -1;
+
+                if (dual_plane)
+                {
+                    below_weights -= 2;
+                    plane2_channel = read_bits(data, below_weights, 2);
+                }
+
+                int n_color_values = 0;
+
+                for (int partition = 0; partition < n_partitions; partition++)
+                {
+                    n_color_values += ((modes[partition] >> 2) + 1) * 2;
+                }
+
+                /* The colour endpoints use the largest range which fits in the remaining bits. */
+                const int n_color_bits = below_weights - color_start;
+                int color_range = -1;
+
+                for (int i = n_integer_ranges - 1; i >= min_color_range && color_range < 0; i--)
+                {
+                    if (get_sequence_length(integer_ranges[i], n_color_values) <= n_color_bits)
+                    {
+                        color_range = i;
+                    }
+                }
+
+                valid = n_color_values <= 18 && color_range >= 0;
+
+                int endpoints[4][2][4];
+
+                if (valid)
+                {
+                    /* Padded so that every partition can read eight values. */
+                    int color_values[18 + 6] = { 0 };
+
+                    decode_sequence(data, color_start, n_color_values, integer_ranges[color_range], color_values);
+
+                    for (int i = 0; i < n_color_values; i++)
+                    {
+                        color_values[i] = unquantize_color(integer_ranges[color_range], color_values[i]);
+                    }
+
+                    for (int partition = 0, first = 0; partition < n_partitions && valid; partition++)
+                    {
+                        valid = decode_endpoints(modes[partition], color_values + first, endpoints[partition][0], endpoints[partition][1]);
+                        first += ((modes[partition] >> 2) + 1) * 2;
+                    }
+                }
+
+                if (valid)
+                {
+                    /* Weights are stored bit-reversed from the top of the block. */
+                    unsigned char reversed[padded_block_size] = { 0 };
+
+                    for (int byte = 0; byte < 16; byte++)
+                    {
+                        unsigned char value = data[15 - byte];
+
+                        value = (unsigned char)(((value & 0xF0) >> 4) | ((value & 0x0F) << 4));
+                        value = (unsigned char)(((value & 0xCC) >> 2) | ((value & 0x33) << 2));
+                        value = (unsigned char)(((value & 0xAA) >> 1) | ((value & 0x55) << 1));
+                        reversed[byte] = value;
+                    }
+
+                    /* Padded so that the bilinear infill may address one row and column past the grid. */
+                    int weights[64 + 16] = { 0 };
+                    int grid_weights[2][64 + 16] = { { 0 } };
+
+                    decode_sequence(reversed, 0, n_weights, weight_range, weights);
+
+                    for (int i = 0; i < n_weights; i++)
+                    {
+                        grid_weights[i % n_planes][i / n_planes] = unquantize_weight(weight_range, weights[i]);
+                    }
+
+                    const int n_texels = block_width * block_height;
+                    const unsigned char* partitions = n_partitions > 1
+                                                    ? &partition_table[((n_partitions - 2) * 1024 + read_bits(data, 13, 10)) * n_texels]
+                                                    : NULL;
+                    const int ds = (1024 + block_width  / 2) / (block_width  - 1);
+                    const int dt = (1024 + block_height / 2) / (block_height - 1);
+
+                    for (int y = 0; y < block_height; y++)
+                    {
+                        for (int x = 0; x < block_width; x++)
+                        {
+                            /* Bilinear infill of the weight grid. */
+                            const int gs = (ds * x * (grid_width  - 1) + 32) >> 6;
+                            const int gt = (dt * y * (grid_height - 1) + 32) >> 6;
+                            const int fs = gs & 0xF;
+                            const int ft = gt & 0xF;
+                            const int v0 = (gs >> 4) + (gt >> 4) * grid_width;
+                            const int w11 = (fs * ft + 8) >> 4;
+                            const int w10 = ft - w11;
+                            const int w01 = fs - w11;
+                            const int w00 = 16 - fs - ft + w11;
+
+                            int texel_weights[2];
+
+                            for (int plane = 0; plane < n_planes; plane++)
+                            {
+                                const int* grid = grid_weights[plane];
+
+                                texel_weights[plane] = (grid[v0] * w00 + grid[v0 + 1] * w01 +
+                                                        grid[v0 + grid_width] * w10 + grid[v0 + grid_width + 1] * w11 + 8) >> 4;
+                            }
+
+                            const int partition = partitions ? partitions[y * block_width + x] : 0;
+                            unsigned char* texel = rgba + y * rgba_stride + x * 4;
+
+                            for (int channel = 0; channel < 4; channel++)
+                            {
+                                const int weight = texel_weights[channel == plane2_channel ? 1 : 0];
+                                const int e0 = endpoints[partition][0][channel];
+                                const int e1 = endpoints[partition][1][channel];
+
+                                /* Endpoints are expanded to 16 bits before interpolation, and the top 8 bits of the result are kept,
+                                   as for GL_EXT_texture_compression_astc_decode_mode with GL_RGBA8. */
+                                const int c0 = srgb ? (e0 << 8) | 0x80 : (e0 << 8) | e0;
+                                const int c1 = srgb ? (e1 << 8) | 0x80 : (e1 << 8) | e1;
+                                const int c  = (c0 * (64 - weight) + c1 * weight + 32) >> 6;
+
+                                texel[channel] = (unsigned char)(c >> 8);
+                            }
+                        }
+                    }
+                    return true;
+                }
+            }
+        }
+
+        /* Illegal and HDR blocks decode to the error colour. */
+        for (int y = 0; y < block_height; y++)
+        {
+            for (int x = 0; x < block_width; x++)
+            {
+                unsigned char* texel = rgba + y * rgba_stride + x * 4;
+
+                texel[0] = 255;
+                texel[1] = 0;
+                texel[2] = 255;
+                texel[3] = 255;
+            }
+        }
+        return false;
+    }
+
+    static void decode_band_rows(decode_band* band)
+    {
+        const AstcDecoder* decoder = band->decoder;
+        const int block_width      = decoder->getBlockWidth();
+        const int block_height     = decoder->getBlockHeight();
+        const int xblocks          = (band->width + block_width - 1) / block_width;
+        const int rgba_stride      = band->width * 4;
+
+        std::vector<unsigned char> texels(block_width * block_height * 4);
+
+        for (int block_y = band->first_block_row; block_y < band->end_block_row; block_y++)
+        {
+            for (int block_x = 0; block_x < xblocks; block_x++)
+            {
+                const unsigned char* block  = band->data + (block_y * xblocks + block_x) * 16;
+                unsigned char*       output = band->rgba + block_y * block_height * rgba_stride + block_x * block_width * 4;
+
+                if ((block_x + 1) * block_width <= band->width && (block_y + 1) * block_height <= band->height)
+                {
+                    band->n_error_blocks += decoder->decodeBlock(block, output, rgba_stride) ? 0 : 1;
+                    continue;
+                }
+
+                /* Blocks on the right and bottom edges may be partially outside the image. */
+                const int n_columns = band->width - block_x * block_width < block_width ? band->width - block_x * block_width : block_width;
+
+                band->n_error_blocks += decoder->decodeBlock(block, &texels[0], block_width * 4) ? 0 : 1;
+
+                for (int y = 0; y < block_height && block_y * block_height + y < band->height; y++)
+                {
+                    memcpy(output + y * rgba_stride, &texels[y * block_width * 4], n_columns * 4);
+                }
+            }
+        }
+    }
+
+    static void decode_band_entry(void* band)
+    {
+        decode_band_rows((decode_band*)band);
+    }
+
+    /* Please see header for specification. */
+    int AstcDecoder::decodeImage(const unsigned char* data, const int width, const int height, unsigned char* rgba, const int n_threads) const
+    {
+        const int yblocks = (height + block_height - 1) / block_height;
+        const int n_bands = n_threads < 1 ? 1 : (n_threads > yblocks ? (yblocks > 0 ? yblocks : 1) : n_threads);
+
+        std::vector<decode_band> bands(n_bands);
+
+        for (int band_index = 0; band_index < n_bands; band_index++)
+        {
+            decode_band& band = bands[band_index];
+
+            band.decoder         = this;
+            band.data            = data;
+            band.width           = width;
+            band.height          = height;
+            band.rgba            = rgba;
+            band.first_block_row = yblocks * band_index / n_bands;
+            band.end_block_row   = yblocks * (band_index + 1) / n_bands;
+            band.n_error_blocks  = 0;
+        }
+
+        MaliSDK::runBands(decode_band_entry, &bands[0], sizeof(decode_band), n_bands);
+
+        int n_error_blocks = 0;
+
+        for (int band_index = 0; band_index < n_bands; band_index++)
+        {
+            n_error_blocks += bands[band_index].n_error_blocks;
+        }
+
+        return n_error_blocks;
+    }
+}
@@ -0,0 +1,85 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ASTC_DECODER_H
+#define ASTC_DECODER_H
+
+#include <vector>
+
+namespace AstcTextures
+{
+    /**
+     * \brief CPU decoder for 2D ASTC LDR textures.
+     *
+     * Decodes every 2D block footprint from 4x4 to 12x12 to RGBA8, following the LDR profile of the
+     * ASTC specification: blocks using HDR endpoint modes, and other illegal encodings, decode to the
+     * error colour (opaque magenta). Used to transcode textures on implementations without
+     * GL_KHR_texture_compression_astc_ldr and to produce reference images without a GPU.
+     */
+    class AstcDecoder
+    {
+        public:
+            /** \brief Create a decoder for one block footprint.
+             *
+             *  \param[in] block_width  Block width in texels, 4 to 12.
+             *  \param[in] block_height Block height in texels, 4 to 12.
+             *  \param[in] srgb         True for the GL_COMPRESSED_SRGB8_ALPHA8_ASTC_* formats. Texels stay sRGB encoded,
+             *                          so the output should be uploaded as GL_SRGB8_ALPHA8.
+             */
+            AstcDecoder(const int block_width, const int block_height, const bool srgb);
+
+            /** \brief Decode one block.
+             *
+             *  \param[in]  block       16 bytes of compressed data.
+             *  \param[out] rgba        Receives block_width x block_height RGBA8 texels.
+             *  \param[in]  rgba_stride Distance in bytes between two rows of rgba.
+             *  \return     False if the block is illegal in the LDR profile and was decoded to the error colour.
+             */
+            bool decodeBlock(const unsigned char* block, unsigned char* rgba, const int rgba_stride) const;
+
+            /** \brief Decode a whole image, splitting the rows of blocks between threads.
+             *
+             *  \param[in]  data      Compressed blocks in row-major order, as stored after the header of an .astc file.
+             *  \param[in]  width     Image width in texels.
+             *  \param[in]  height    Image height in texels.
+             *  \param[out] rgba      Receives width x height RGBA8 texels.
+             *  \param[in]  n_threads Number of threads to decode with. Values below 1 are treated as 1.
+             *  \return     Number of blocks decoded to the error colour.
+             */
+            int decodeImage(const unsigned char* data, const int width, const int height, unsigned char* rgba, const int n_threads) const;
+
+            /** \brief Returns block width in texels. */
+            int getBlockWidth(void) const { return block_width; }
+
+            /** \brief Returns block height in texels. */
+            int getBlockHeight(void) const { return block_height; }
+
+        private:
+            int  block_width;
+            int  block_height;
+            bool srgb;
+
+            /* Partition of every texel for every partition count and seed, indexed by
+               ((partition count - 2) * 1024 + seed) * texels per block + texel. */
+            std::vector<unsigned char> partition_table;
+    };
+}
+
+#endif /* ASTC_DECODER_H */
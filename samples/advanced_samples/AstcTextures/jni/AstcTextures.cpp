@@ -26,9 +26,12 @@
 #include <string>
 
 #include "Text.h"
+#include "AstcDecoder.h"
 #include "AstcTextures.h"
+#include "TextureSetCache.h"
 #include "Timer.h"
 #include "SolidSphere.h"
+#include "Profiler.h"
 
 using namespace AstcTextures;
 using namespace std;
@@ -110,6 +113,12 @@ Matrix perspective_matrix;
 /* Rotation matrix. */
 Matrix rotate_matrix;
 
+/* True if the implementation cannot sample ASTC textures, which are then decoded on the CPU. */
+bool decode_astc_on_cpu = false;
+
+/* Set to true to log the cost of decoding each block size on the CPU at startup. */
+const bool run_astc_decoder_benchmark = false;
+
 /* Indicates which texture set is to be bound to texture units. */
 unsigned int current_texture_set_id = 0;
 
@@ -153,8 +162,8 @@ texture_set_info texture_sets_info[] =
 /* Number of texture sets. */
 const int n_texture_ids = sizeof(texture_sets_info) / sizeof(texture_sets_info[0]);
 
-/* Array storing texture bindings. */
-texture_set texture_ids[n_texture_ids] = { 0 };
+/* Loads texture sets when they are needed and keeps the most recently used ones. */
+TextureSetCache* texture_cache = NULL;
 
 /* Please see header for specification. */
 GLint get_and_check_attrib_location(GLuint program, const GLchar* attrib_name)
@@ -281,6 +290,14 @@ GLuint create_program(const char* vertex_source, const char* fragment_source)
  */
 void update_texture_bindings(bool force_switch_texture)
 {
+    /* Upload the next texture set if it has been read in the background. */
+    texture_cache->update();
+
+    if (timer.getTime() >= ASTC_TEXTURE_SWITCH_INTERVAL - ASTC_TEXTURE_PREFETCH_TIME)
+    {
+        texture_cache->prefetch((current_texture_set_id + 1) % n_texture_ids);
+    }
+
     if (timer.getTime() >= ASTC_TEXTURE_SWITCH_INTERVAL || force_switch_texture)
     {
         /* If the current texture set is to be changed, reset timer to start counting time again. */
@@ -302,146 +319,138 @@ void update_texture_bindings(bool force_switch_texture)
         }
 
         /* Change displayed text. */
-        text_displayer->addString((window_width - (Text::textureCharacterWidth * strlen(texture_ids[current_texture_set_id].name))) >> 1,
+        text_displayer->addString((window_width - (Text::textureCharacterWidth * strlen(texture_sets_info[current_texture_set_id].compressed_texture_format_name))) >> 1,
                                    window_height - Text::textureCharacterHeight,
-                                   texture_ids[current_texture_set_id].name,
+                                   texture_sets_info[current_texture_set_id].compressed_texture_format_name,
                                    255,  /* Red channel. */
                                    255,  /* Green channel. */
                                    0,    /* Blue channel. */
                                    255); /* Alpha channel. */
     }
 
+    /* Loads the set now if the prefetch has not been started or is still running. */
+    const texture_set& texture_ids = texture_cache->acquire(current_texture_set_id);
+
     /* Update texture units with new bindings. */
     GL_CHECK(glActiveTexture(GL_TEXTURE0));
-    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids[current_texture_set_id].cloud_and_gloss_texture_id));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids.cloud_and_gloss_texture_id));
     GL_CHECK(glActiveTexture(GL_TEXTURE1));
-    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids[current_texture_set_id].earth_color_texture_id));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids.earth_color_texture_id));
     GL_CHECK(glActiveTexture(GL_TEXTURE2));
-    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids[current_texture_set_id].earth_night_texture_id));
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D, texture_ids.earth_night_texture_id));
 }
 
-/**
- * \brief Define and retrieve compressed texture image.
- *
- * \param[in] file_name                       Texture file name.
- * \param[in] compressed_data_internal_format ASTC compression internal format.
- */
-GLuint load_texture(const char* file_name, GLenum compressed_data_internal_format)
+/* Please see header for specification. */
+unsigned char* read_file(const char* file_name, long* file_size)
 {
-    unsigned char* compressed_data = NULL;
-    unsigned char* input_data      = NULL;
+    unsigned char* file_data = NULL;
+    size_t         result    = 0;
 
-    long         file_size       = 0;
-    unsigned int n_bytes_to_read = 0;
-    size_t       result          = 0;
-    GLuint       to_id           = 0;
+    FILE* file = fopen(file_name, "rb");
 
-    /* Number of blocks in the x, y and z direction. */
-    int xblocks = 0;
-    int yblocks = 0;
-    int zblocks = 0;
-
-    /* Number of bytes for each dimension. */
-    int xsize = 0;
-    int ysize = 0;
-    int zsize = 0;
-
-    FILE* compressed_data_file = fopen(file_name, "rb");
-
-    if (compressed_data_file == NULL)
+    if (file == NULL)
     {
         LOGE("Could not open a file.\n");
         exit(EXIT_FAILURE);
     }
 
-    LOGI("Loading texture [%s]\n", file_name);
-
     /* Obtain file size. */
-    fseek(compressed_data_file, 0, SEEK_END);
-    file_size = ftell(compressed_data_file);
-    rewind(compressed_data_file);
+    fseek(file, 0, SEEK_END);
+    *file_size = ftell(file);
+    rewind(file);
 
     /* Allocate memory to contain the whole file. */
-    MALLOC_CHECK(unsigned char*, input_data, sizeof(unsigned char) * file_size);
+    MALLOC_CHECK(unsigned char*, file_data, sizeof(unsigned char) * *file_size);
 
     /* Copy the file into the buffer. */
-    result = fread(input_data, 1, file_size, compressed_data_file);
+    result = fread(file_data, 1, *file_size, file);
 
-    if (result != file_size)
+    if (result != *file_size)
     {
         LOGE("Reading error [%s] ... FILE: %s LINE: %i\n", file_name, __FILE__, __LINE__);
         exit(EXIT_FAILURE);
     }
 
-    /* Traverse the file structure. */
-    astc_header* astc_data_ptr = (astc_header*) input_data;
-
-    /* Merge x,y,z-sizes from 3 chars into one integer value. */
-    xsize = astc_data_ptr->xsize[0] + (astc_data_ptr->xsize[1] << 8) + (astc_data_ptr->xsize[2] << 16);
-    ysize = astc_data_ptr->ysize[0] + (astc_data_ptr->ysize[1] << 8) + (astc_data_ptr->ysize[2] << 16);
-    zsize = astc_data_ptr->zsize[0] + (astc_data_ptr->zsize[1] << 8) + (astc_data_ptr->zsize[2] << 16);
-
-    /* Compute number of blocks in each direction. */
-    xblocks = (xsize + astc_data_ptr->blockdim_x - 1) / astc_data_ptr->blockdim_x;
-    yblocks = (ysize + astc_data_ptr->blockdim_y - 1) / astc_data_ptr->blockdim_y;
-    zblocks = (zsize + astc_data_ptr->blockdim_z - 1) / astc_data_ptr->blockdim_z;
-
-    /* Each block is encoded on 16 bytes, so calculate total compressed image data size. */
-    n_bytes_to_read = xblocks * yblocks * zblocks << 4;
-
-    /* We now have file contents in memory so let's fill a texture object with the data. */
-    GL_CHECK(glGenTextures(1, &to_id));
-    GL_CHECK(glBindTexture(GL_TEXTURE_2D, to_id));
-
-    /* Upload texture data to ES. */
-    GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D,
-                                    0,
-                                    compressed_data_internal_format,
-                                    xsize,
-                                    ysize,
-                                    0,
-                                    n_bytes_to_read,
-                                    (const GLvoid*)&astc_data_ptr[1]));
-
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_REPEAT));
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_REPEAT));
-
-    /* Unbind texture from target. */
-    GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0));
-
-    /* Terminate file operations. */
-    fclose(compressed_data_file);
-    FREE_CHECK(input_data);
-
-    return to_id;
+    fclose(file);
+
+    return file_data;
 }
 
 /**
- * \brief Define 32 texture sets that the demo will switch between every 5 seconds.
+ * \brief Log the cost of decoding the day texture on the CPU for every block size.
+ *
+ * Bit rate and decoding throughput are shown side by side to help choosing a block footprint.
  */
-void load_textures(void)
+void benchmark_astc_decoder(void)
 {
-    /* Paths to texture images. */
-    string cloud_and_gloss_texture_file_path;
-    string earth_color_texture_file_path;
-    string earth_night_texture_file_path;
+    LOGI("ASTC decoder benchmark: %d threads\n", ASTC_DECODER_N_THREADS);
 
-    for (int i = 0; i < n_texture_ids; i++)
+    /* The sRGB sets use the same files as the linear ones. */
+    for (int i = 0; i < n_texture_ids && texture_sets_info[i].compressed_data_internal_format < GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR; i++)
     {
-        cloud_and_gloss_texture_file_path = resource_directory + texture_sets_info[i].cloud_and_gloss_texture_file_path;
-        earth_color_texture_file_path     = resource_directory + texture_sets_info[i].earth_color_texture_file_path;
-        earth_night_texture_file_path     = resource_directory + texture_sets_info[i].earth_night_texture_file_path;
-
-        texture_ids[i].cloud_and_gloss_texture_id = load_texture(cloud_and_gloss_texture_file_path.c_str(), texture_sets_info[i].compressed_data_internal_format);
-        texture_ids[i].earth_color_texture_id     = load_texture(earth_color_texture_file_path.c_str(),     texture_sets_info[i].compressed_data_internal_format);
-        texture_ids[i].earth_night_texture_id     = load_texture(earth_night_texture_file_path.c_str(),     texture_sets_info[i].compressed_data_internal_format);
-        texture_ids[i].name                       = texture_sets_info[i].compressed_texture_format_name;
+        const string file_path = resource_directory + texture_sets_info[i].earth_color_texture_file_path;
+
+        long           file_size    = 0;
+        unsigned char* input_data   = read_file(file_path.c_str(), &file_size);
+        unsigned char* decoded_data = NULL;
+        astc_header*   header       = (astc_header*) input_data;
+
+        const int xsize = header->xsize[0] + (header->xsize[1] << 8) + (header->xsize[2] << 16);
+        const int ysize = header->ysize[0] + (header->ysize[1] << 8) + (header->ysize[2] << 16);
+
+        AstcDecoder decoder(header->blockdim_x, header->blockdim_y, false);
+
+        MALLOC_CHECK(unsigned char*, decoded_data, xsize * ysize * 4);
+
+        Timer benchmark_timer;
+        int   n_iterations = 0;
+        float elapsed_time = 0.0f;
+
+        benchmark_timer.reset();
+
+        do
+        {
+            decoder.decodeImage((const unsigned char*)&header[1], xsize, ysize, decoded_data, ASTC_DECODER_N_THREADS);
+            n_iterations++;
+            elapsed_time = benchmark_timer.getTime();
+        }
+        while (elapsed_time < 0.5f);
+
+        LOGI("%-10s %5.2f bpp %8.2f ms per %dx%d image %8.1f Mtexels/s\n",
+             texture_sets_info[i].compressed_texture_format_name,
+             128.0f / (header->blockdim_x * header->blockdim_y),
+             elapsed_time * 1000.0f / n_iterations,
+             xsize,
+             ysize,
+             (float)xsize * ysize * n_iterations / elapsed_time / 1000000.0f);
+
+        FREE_CHECK(decoded_data);
+        FREE_CHECK(input_data);
     }
+}
+
+/**
+ * \brief Create the texture cache and make the first texture set resident.
+ *
+ * The other sets are loaded while the demo runs, shortly before they are shown.
+ */
+void load_textures(void)
+{
+    Timer load_timer;
+
+    load_timer.reset();
+
+    texture_cache = new TextureSetCache(texture_sets_info,
+                                        n_texture_ids,
+                                        resource_directory,
+                                        ASTC_TEXTURE_BUDGET,
+                                        ASTC_FILE_CACHE_BUDGET,
+                                        decode_astc_on_cpu);
 
     /* Configure texture set. */
     update_texture_bindings(true);
+
+    LOGI("First texture set loaded in %.1f ms.\n", load_timer.getTime() * 1000.0f);
 }
 
 /**
@@ -563,8 +572,13 @@ void setup_graphics(int width, int height)
 
     if (strstr((const char*) extensions, "GL_KHR_texture_compression_astc_ldr") == NULL)
     {
-        LOGI("OpenGL ES 3.0 implementation does not support GL_KHR_texture_compression_astc_ldr extension.\n");
-        exit(EXIT_SUCCESS);
+        LOGI("OpenGL ES 3.0 implementation does not support GL_KHR_texture_compression_astc_ldr extension, decoding textures on the CPU.\n");
+        decode_astc_on_cpu = true;
+    }
+
+    if (run_astc_decoder_benchmark)
+    {
+        benchmark_astc_decoder();
     }
 
     /* Enable culling and depth testing. */
@@ -645,13 +659,9 @@ void render_frame(void)
  */
 void cleanup_graphics(void)
 {
-    /* Delete all used textures. */
-    for (int i = 0; i < n_texture_ids; i++)
-    {
-        GL_CHECK(glDeleteTextures(1, &texture_ids[i].cloud_and_gloss_texture_id));
-        GL_CHECK(glDeleteTextures(1, &texture_ids[i].earth_color_texture_id));
-        GL_CHECK(glDeleteTextures(1, &texture_ids[i].earth_night_texture_id));
-    }
+    /* Delete all resident textures. */
+    delete texture_cache;
+    texture_cache = NULL;
 
     /* Cleanup shaders. */
     GL_CHECK(glUseProgram(0));
@@ -690,6 +700,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_astctextures_Nativ
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_astctextures_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     render_frame();
 }
 
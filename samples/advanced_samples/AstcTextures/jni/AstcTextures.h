@@ -56,16 +56,7 @@
     ptr = NULL;         \
 }
 
-#define GL_CHECK(x)                                                                             \
-    x;                                                                                          \
-    {                                                                                           \
-        GLenum glError = glGetError();                                                          \
-        if(glError != GL_NO_ERROR)                                                              \
-        {                                                                                       \
-            LOGE("glGetError() = %i (%#.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(EXIT_FAILURE);                                                                 \
-        }                                                                                       \
-    }
+#include "GLCheck.h"
 
 /* ASTC texture compression internal formats. */
 #define GL_COMPRESSED_RGBA_ASTC_4x4_KHR            (0x93B0)
@@ -100,6 +91,18 @@
 /* Time period for each texture set to be displayed. */
 #define ASTC_TEXTURE_SWITCH_INTERVAL               (5) /* sec */
 
+/* Number of threads used to decode ASTC textures on the CPU. */
+#define ASTC_DECODER_N_THREADS                     (4)
+
+/* Time before a switch at which the next texture set starts loading in the background. */
+#define ASTC_TEXTURE_PREFETCH_TIME                 (2) /* sec */
+
+/* Size of texture data kept on the GPU. A set of 4x4 textures takes 1.5 MB, so several sets stay resident. */
+#define ASTC_TEXTURE_BUDGET                        (4 * 1024 * 1024)
+
+/* Size of file contents kept in memory, so that the sRGB variant of a set does not read its files again. */
+#define ASTC_FILE_CACHE_BUDGET                     (4 * 1024 * 1024)
+
 /* Angular rates around several axes. */
 #define X_ROTATION_SPEED                           (5)
 #define Y_ROTATION_SPEED                           (4)
@@ -218,6 +221,15 @@ typedef struct texture_set_info
     const char* compressed_texture_format_name;
 } texture_set_info;
 
+/**
+ * \brief Read a whole file into memory. Print a message and exit on failure.
+ *
+ * \param[in]  file_name Name of the file.
+ * \param[out] file_size Size of the file in bytes.
+ * \return     Pointer to the file contents, to be released with FREE_CHECK.
+ */
+unsigned char* read_file(const char* file_name, long* file_size);
+
 /**
  * \brief Invoke glGetAttribLocation(), if it has returned a positive value.
  *        Otherwise, print a message and exit. Function used for clarity reasons.
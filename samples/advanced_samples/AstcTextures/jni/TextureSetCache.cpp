@@ -0,0 +1,480 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "TextureSetCache.h"
+#include "AstcDecoder.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace AstcTextures
+{
+    /* Number of textures in a set: cloud and gloss, day colour and night colour. */
+    static const int n_set_textures = 3;
+
+    /* Please see header for specification. */
+    TextureSetCache::TextureSetCache(const texture_set_info* sets_info, const int n_sets, const std::string& resource_directory,
+                                     const size_t texture_budget, const size_t file_budget, const bool decode_on_cpu)
+        : sets_info(sets_info)
+        , n_sets(n_sets)
+        , resource_directory(resource_directory)
+        , texture_budget(texture_budget)
+        , file_budget(file_budget)
+        , decode_on_cpu(decode_on_cpu)
+        , sets(n_sets)
+        , is_resident(n_sets, false)
+        , set_bytes(n_sets, 0)
+        , set_last_use(n_sets, 0)
+        , resident_bytes(0)
+        , file_bytes(0)
+        , use_counter(0)
+        , current_set_id(-1)
+        , pending_job(NULL)
+    {
+        for (int i = 0; i < n_sets; i++)
+        {
+            sets[i].cloud_and_gloss_texture_id = 0;
+            sets[i].earth_color_texture_id     = 0;
+            sets[i].earth_night_texture_id     = 0;
+            sets[i].name                       = sets_info[i].compressed_texture_format_name;
+        }
+
+        pthread_mutex_init(&job_mutex, NULL);
+    }
+
+    /* Please see header for specification. */
+    TextureSetCache::~TextureSetCache()
+    {
+        if (pending_job != NULL)
+        {
+            /* Let the worker finish, then release everything it produced. */
+            finishJob(pending_job);
+        }
+
+        for (int i = 0; i < n_sets; i++)
+        {
+            if (is_resident[i])
+            {
+                GL_CHECK(glDeleteTextures(1, &sets[i].cloud_and_gloss_texture_id));
+                GL_CHECK(glDeleteTextures(1, &sets[i].earth_color_texture_id));
+                GL_CHECK(glDeleteTextures(1, &sets[i].earth_night_texture_id));
+            }
+        }
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            FREE_CHECK(files[i].data);
+        }
+
+        pthread_mutex_destroy(&job_mutex);
+    }
+
+    /* Please see header for specification. */
+    const texture_set& TextureSetCache::acquire(const int set_id)
+    {
+        if (!is_resident[set_id])
+        {
+            if (pending_job != NULL && pending_job->set_id == set_id)
+            {
+                /* Waits for the worker if the prefetch is still running. */
+                finishJob(pending_job);
+            }
+            else
+            {
+                /* Not prefetched: load it now. A prefetch of another set keeps running. */
+                load_job* job = createJob(set_id);
+
+                runJob(job);
+                finishJob(job);
+            }
+        }
+
+        current_set_id       = set_id;
+        set_last_use[set_id] = ++use_counter;
+
+        return sets[set_id];
+    }
+
+    /* Please see header for specification. */
+    void TextureSetCache::prefetch(const int set_id)
+    {
+        if (is_resident[set_id] || pending_job != NULL)
+        {
+            return;
+        }
+
+        pending_job = createJob(set_id);
+        pending_job->is_thread_started = (pthread_create(&pending_job->thread, NULL, jobThreadEntry, pending_job) == 0);
+
+        if (!pending_job->is_thread_started)
+        {
+            /* Could not spawn a worker: load on this thread instead, the upload still happens in update(). */
+            runJob(pending_job);
+        }
+    }
+
+    /* Please see header for specification. */
+    void TextureSetCache::update(void)
+    {
+        if (pending_job == NULL)
+        {
+            return;
+        }
+
+        pthread_mutex_lock(&job_mutex);
+        const bool is_finished = pending_job->is_finished;
+        pthread_mutex_unlock(&job_mutex);
+
+        if (is_finished)
+        {
+            finishJob(pending_job);
+        }
+    }
+
+    /* Please see header for specification. */
+    int TextureSetCache::getNumberOfResidentSets(void) const
+    {
+        int n_resident_sets = 0;
+
+        for (int i = 0; i < n_sets; i++)
+        {
+            n_resident_sets += is_resident[i] ? 1 : 0;
+        }
+
+        return n_resident_sets;
+    }
+
+    /**
+     * \brief Prepare a load on the rendering thread.
+     *
+     * Files already in the cache are pinned and handed to the job, so that the worker only reads the missing ones
+     * and never touches the cache itself.
+     */
+    TextureSetCache::load_job* TextureSetCache::createJob(const int set_id)
+    {
+        load_job* job = new load_job;
+
+        job->cache             = this;
+        job->set_id            = set_id;
+        job->paths[0]          = resource_directory + sets_info[set_id].cloud_and_gloss_texture_file_path;
+        job->paths[1]          = resource_directory + sets_info[set_id].earth_color_texture_file_path;
+        job->paths[2]          = resource_directory + sets_info[set_id].earth_night_texture_file_path;
+        job->is_finished       = false;
+        job->is_thread_started = false;
+
+        for (int i = 0; i < n_set_textures; i++)
+        {
+            job->file_data[i]    = NULL;
+            job->file_sizes[i]   = 0;
+            job->is_cached[i]    = false;
+            job->decoded_data[i] = NULL;
+
+            const int file = findFile(job->paths[i]);
+
+            if (file >= 0)
+            {
+                files[file].n_users++;
+                files[file].last_use = ++use_counter;
+
+                job->file_data[i]  = files[file].data;
+                job->file_sizes[i] = files[file].size;
+                job->is_cached[i]  = true;
+            }
+        }
+
+        return job;
+    }
+
+    /**
+     * \brief Read the missing files and decode them if needed. Runs on the worker thread.
+     */
+    void TextureSetCache::runJob(load_job* job)
+    {
+        for (int i = 0; i < n_set_textures; i++)
+        {
+            if (!job->is_cached[i])
+            {
+                job->file_data[i] = read_file(job->paths[i].c_str(), &job->file_sizes[i]);
+            }
+
+            if (job->cache->decode_on_cpu)
+            {
+                const astc_header* header  = (const astc_header*) job->file_data[i];
+                const GLenum       format  = job->cache->sets_info[job->set_id].compressed_data_internal_format;
+                const bool         is_srgb = format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+
+                int xsize   = 0;
+                int ysize   = 0;
+                int n_bytes = 0;
+
+                getImageSize(job->file_data[i], &xsize, &ysize, &n_bytes);
+
+                AstcDecoder decoder(header->blockdim_x, header->blockdim_y, is_srgb);
+
+                MALLOC_CHECK(unsigned char*, job->decoded_data[i], xsize * ysize * 4);
+
+                int n_error_blocks = decoder.decodeImage((const unsigned char*)&header[1], xsize, ysize, job->decoded_data[i], ASTC_DECODER_N_THREADS);
+
+                if (n_error_blocks > 0)
+                {
+                    LOGE("%d blocks of [%s] could not be decoded.\n", n_error_blocks, job->paths[i].c_str());
+                }
+            }
+        }
+
+        pthread_mutex_lock(&job->cache->job_mutex);
+        job->is_finished = true;
+        pthread_mutex_unlock(&job->cache->job_mutex);
+    }
+
+    void* TextureSetCache::jobThreadEntry(void* argument)
+    {
+        runJob((load_job*)argument);
+
+        return NULL;
+    }
+
+    /**
+     * \brief Upload the textures of a job, add its files to the cache and delete it. Runs on the rendering thread.
+     */
+    void TextureSetCache::finishJob(load_job* job)
+    {
+        if (job->is_thread_started)
+        {
+            pthread_join(job->thread, NULL);
+        }
+
+        const int    set_id = job->set_id;
+        const GLenum format = sets_info[set_id].compressed_data_internal_format;
+        GLuint       texture_ids[n_set_textures];
+
+        set_bytes[set_id] = 0;
+
+        for (int i = 0; i < n_set_textures; i++)
+        {
+            int xsize   = 0;
+            int ysize   = 0;
+            int n_bytes = 0;
+
+            getImageSize(job->file_data[i], &xsize, &ysize, &n_bytes);
+
+            texture_ids[i]     = uploadTexture(job->file_data[i], format, job->decoded_data[i]);
+            set_bytes[set_id] += job->decoded_data[i] != NULL ? xsize * ysize * 4 : n_bytes;
+
+            FREE_CHECK(job->decoded_data[i]);
+
+            if (job->is_cached[i])
+            {
+                files[findFile(job->paths[i])].n_users--;
+            }
+            else if (findFile(job->paths[i]) >= 0)
+            {
+                /* Another job read the same file in the meantime. */
+                FREE_CHECK(job->file_data[i]);
+            }
+            else
+            {
+                file_entry entry;
+
+                entry.path     = job->paths[i];
+                entry.data     = job->file_data[i];
+                entry.size     = job->file_sizes[i];
+                entry.last_use = ++use_counter;
+                entry.n_users  = 0;
+
+                files.push_back(entry);
+                file_bytes += entry.size;
+            }
+        }
+
+        sets[set_id].cloud_and_gloss_texture_id = texture_ids[0];
+        sets[set_id].earth_color_texture_id     = texture_ids[1];
+        sets[set_id].earth_night_texture_id     = texture_ids[2];
+
+        is_resident[set_id]  = true;
+        set_last_use[set_id] = ++use_counter;
+        resident_bytes      += set_bytes[set_id];
+
+        if (pending_job == job)
+        {
+            pending_job = NULL;
+        }
+        delete job;
+
+        evictSets(set_id);
+        evictFiles();
+
+        LOGI("Texture set [%s] resident: %d sets, %u KB of textures, %u KB of files in memory.\n",
+             sets[set_id].name, getNumberOfResidentSets(), (unsigned int)(resident_bytes / 1024), (unsigned int)(file_bytes / 1024));
+    }
+
+    /**
+     * \brief Delete least recently used sets until the resident textures fit the budget.
+     *        The current set, the given set and a set being prefetched are kept.
+     */
+    void TextureSetCache::evictSets(const int keep_set_id)
+    {
+        while (resident_bytes > texture_budget)
+        {
+            int victim = -1;
+
+            for (int i = 0; i < n_sets; i++)
+            {
+                const bool is_protected = i == keep_set_id || i == current_set_id || (pending_job != NULL && i == pending_job->set_id);
+
+                if (is_resident[i] && !is_protected && (victim < 0 || set_last_use[i] < set_last_use[victim]))
+                {
+                    victim = i;
+                }
+            }
+
+            if (victim < 0)
+            {
+                break;
+            }
+
+            GL_CHECK(glDeleteTextures(1, &sets[victim].cloud_and_gloss_texture_id));
+            GL_CHECK(glDeleteTextures(1, &sets[victim].earth_color_texture_id));
+            GL_CHECK(glDeleteTextures(1, &sets[victim].earth_night_texture_id));
+
+            is_resident[victim] = false;
+            resident_bytes     -= set_bytes[victim];
+        }
+    }
+
+    /**
+     * \brief Release least recently used file contents until they fit the budget. Files used by a pending job are kept.
+     */
+    void TextureSetCache::evictFiles(void)
+    {
+        while (file_bytes > file_budget)
+        {
+            int victim = -1;
+
+            for (size_t i = 0; i < files.size(); i++)
+            {
+                if (files[i].n_users == 0 && (victim < 0 || files[i].last_use < files[victim].last_use))
+                {
+                    victim = (int)i;
+                }
+            }
+
+            if (victim < 0)
+            {
+                break;
+            }
+
+            file_bytes -= files[victim].size;
+            FREE_CHECK(files[victim].data);
+            files.erase(files.begin() + victim);
+        }
+    }
+
+    /**
+     * \brief Returns the index of a file in the cache, or -1 if its contents are not in memory.
+     */
+    int TextureSetCache::findFile(const std::string& path) const
+    {
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            if (files[i].path == path)
+            {
+                return (int)i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * \brief Read the image size and the size of the compressed data from the header of an .astc file.
+     */
+    void TextureSetCache::getImageSize(const unsigned char* file_data, int* xsize, int* ysize, int* n_bytes)
+    {
+        const astc_header* astc_data_ptr = (const astc_header*) file_data;
+
+        /* Merge x,y,z-sizes from 3 chars into one integer value. */
+        *xsize    = astc_data_ptr->xsize[0] + (astc_data_ptr->xsize[1] << 8) + (astc_data_ptr->xsize[2] << 16);
+        *ysize    = astc_data_ptr->ysize[0] + (astc_data_ptr->ysize[1] << 8) + (astc_data_ptr->ysize[2] << 16);
+        int zsize = astc_data_ptr->zsize[0] + (astc_data_ptr->zsize[1] << 8) + (astc_data_ptr->zsize[2] << 16);
+
+        /* Compute number of blocks in each direction. */
+        int xblocks = (*xsize + astc_data_ptr->blockdim_x - 1) / astc_data_ptr->blockdim_x;
+        int yblocks = (*ysize + astc_data_ptr->blockdim_y - 1) / astc_data_ptr->blockdim_y;
+        int zblocks = (zsize  + astc_data_ptr->blockdim_z - 1) / astc_data_ptr->blockdim_z;
+
+        /* Each block is encoded on 16 bytes, so calculate total compressed image data size. */
+        *n_bytes = xblocks * yblocks * zblocks << 4;
+    }
+
+    /**
+     * \brief Define a texture from the contents of an .astc file, or from its decoded texels if decoded_data is not NULL.
+     */
+    GLuint TextureSetCache::uploadTexture(const unsigned char* file_data, GLenum internal_format, const unsigned char* decoded_data)
+    {
+        GLuint to_id   = 0;
+        int    xsize   = 0;
+        int    ysize   = 0;
+        int    n_bytes = 0;
+
+        getImageSize(file_data, &xsize, &ysize, &n_bytes);
+
+        GL_CHECK(glGenTextures(1, &to_id));
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D, to_id));
+
+        if (decoded_data != NULL)
+        {
+            /* sRGB variants stay sRGB encoded after decoding, so they keep sRGB sampling. */
+            const bool is_srgb = internal_format >= GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR;
+
+            GL_CHECK(glTexImage2D(GL_TEXTURE_2D,
+                                  0,
+                                  is_srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+                                  xsize,
+                                  ysize,
+                                  0,
+                                  GL_RGBA,
+                                  GL_UNSIGNED_BYTE,
+                                  decoded_data));
+        }
+        else
+        {
+            /* Upload texture data to ES. */
+            GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D,
+                                            0,
+                                            internal_format,
+                                            xsize,
+                                            ysize,
+                                            0,
+                                            n_bytes,
+                                            (const GLvoid*)&((const astc_header*) file_data)[1]));
+        }
+
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S,     GL_REPEAT));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T,     GL_REPEAT));
+
+        /* Unbind texture from target. */
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D, 0));
+
+        return to_id;
+    }
+}
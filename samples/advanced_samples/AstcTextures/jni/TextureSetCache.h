@@ -0,0 +1,143 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TEXTURE_SET_CACHE_H
+#define TEXTURE_SET_CACHE_H
+
+#include "AstcTextures.h"
+
+#include <pthread.h>
+#include <string>
+#include <vector>
+
+namespace AstcTextures
+{
+    /**
+     * \brief Keeps a bounded number of texture sets resident.
+     *
+     * Sets are loaded when they are first needed, or ahead of time with prefetch(), which reads (and, if required,
+     * decodes) the files on a worker thread and uploads them from update() once they are ready. When the textures
+     * exceed the budget, the least recently used sets are deleted. The set in use and a set being prefetched are
+     * never evicted, so both stay resident even if together they exceed the budget.
+     *
+     * File contents are kept in a separate least recently used cache, so the linear and sRGB variants of a block
+     * size, which are stored in the same files, read them only once.
+     */
+    class TextureSetCache
+    {
+        public:
+            /** \brief Create an empty cache. No file is read until a set is requested.
+             *
+             *  \param[in] sets_info          Description of every texture set. Not copied, must outlive the cache.
+             *  \param[in] n_sets             Number of texture sets.
+             *  \param[in] resource_directory Directory holding the texture files.
+             *  \param[in] texture_budget     Size in bytes of texture data to keep resident.
+             *  \param[in] file_budget        Size in bytes of file contents to keep in memory.
+             *  \param[in] decode_on_cpu      True to decode the textures with AstcDecoder and upload them uncompressed.
+             */
+            TextureSetCache(const texture_set_info* sets_info, const int n_sets, const std::string& resource_directory,
+                            const size_t texture_budget, const size_t file_budget, const bool decode_on_cpu);
+
+            /** \brief Wait for a pending prefetch and delete all textures. Must be called with the context current. */
+            ~TextureSetCache();
+
+            /** \brief Returns the bindings of a set, loading it now if it is not resident yet.
+             *
+             *  \param[in] set_id Index of the texture set.
+             *  \return    Texture bindings of the set, valid until the set is evicted.
+             */
+            const texture_set& acquire(const int set_id);
+
+            /** \brief Start loading a set on a worker thread. Does nothing if the set is resident or another prefetch is pending.
+             *
+             *  \param[in] set_id Index of the texture set.
+             */
+            void prefetch(const int set_id);
+
+            /** \brief Upload a prefetched set once its worker has finished. Call once per frame. */
+            void update(void);
+
+            /** \brief Returns the size in bytes of all resident textures. */
+            size_t getResidentBytes(void) const { return resident_bytes; }
+
+            /** \brief Returns the number of resident texture sets. */
+            int getNumberOfResidentSets(void) const;
+
+        private:
+            /* Contents of one file, shared by all sets which use it. */
+            typedef struct file_entry
+            {
+                std::string    path;
+                unsigned char* data;
+                long           size;
+                unsigned int   last_use;
+                int            n_users;
+            } file_entry;
+
+            /* Work needed to make one set resident, split between the worker and the rendering thread. */
+            typedef struct load_job
+            {
+                TextureSetCache* cache;
+                int              set_id;
+                std::string      paths[3];
+                unsigned char*   file_data[3];
+                long             file_sizes[3];
+                bool             is_cached[3];
+                unsigned char*   decoded_data[3];
+                bool             is_finished;
+                bool             is_thread_started;
+                pthread_t        thread;
+            } load_job;
+
+            const texture_set_info*   sets_info;
+            int                       n_sets;
+            std::string               resource_directory;
+            size_t                    texture_budget;
+            size_t                    file_budget;
+            bool                      decode_on_cpu;
+
+            std::vector<texture_set>  sets;
+            std::vector<bool>         is_resident;
+            std::vector<size_t>       set_bytes;
+            std::vector<unsigned int> set_last_use;
+            std::vector<file_entry>   files;
+
+            size_t                    resident_bytes;
+            size_t                    file_bytes;
+            unsigned int              use_counter;
+            int                       current_set_id;
+
+            load_job*                 pending_job;
+            pthread_mutex_t           job_mutex;
+
+            load_job* createJob(const int set_id);
+            void      finishJob(load_job* job);
+            void      evictSets(const int keep_set_id);
+            void      evictFiles(void);
+            int       findFile(const std::string& path) const;
+
+            static void   runJob(load_job* job);
+            static void*  jobThreadEntry(void* argument);
+            static void   getImageSize(const unsigned char* file_data, int* xsize, int* ysize, int* n_bytes);
+            static GLuint uploadTexture(const unsigned char* file_data, GLenum internal_format, const unsigned char* decoded_data);
+    };
+}
+
+#endif /* TEXTURE_SET_CACHE_H */
@@ -29,6 +29,7 @@
 #include "AstcTextures.h"
 #include "Timer.h"
 #include "SolidSphere.h"
+#include "Profiler.h"
 
 using namespace AstcTextures;
 using namespace std;
@@ -720,6 +721,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_astctextureslowpre
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_astctextureslowprecision_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     render_frame();
 }
 
@@ -56,16 +56,7 @@
     ptr = NULL;         \
 }
 
-#define GL_CHECK(x)                                                                             \
-    x;                                                                                          \
-    {                                                                                           \
-        GLenum glError = glGetError();                                                          \
-        if(glError != GL_NO_ERROR)                                                              \
-        {                                                                                       \
-            LOGE("glGetError() = %i (%#.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(EXIT_FAILURE);                                                                 \
-        }                                                                                       \
-    }
+#include "GLCheck.h"
 
 /* ASTC texture compression internal formats. */
 #define GL_COMPRESSED_RGBA_ASTC_4x4_KHR            (0x93B0)
@@ -126,7 +126,7 @@ void free_app()
     plane.dispose();
     sphere.dispose();
 
-    glDeleteTextures(1, &shadow_map_tex);
+    gl_state->deleteTextures(1, &shadow_map_tex);
     glDeleteFramebuffers(1, &shadow_map_fbo);
 
     sort_free();
@@ -135,13 +135,13 @@ void free_app()
 void init_shadowmap(int width, int height)
 {
     glGenTextures(1, &shadow_map_tex);
-    glBindTexture(GL_TEXTURE_2D, shadow_map_tex);
+    gl_state->bindTexture(0, GL_TEXTURE_2D, shadow_map_tex);
     glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, width, height);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    gl_state->bindTexture(0, GL_TEXTURE_2D, 0);
 
     glGenFramebuffers(1, &shadow_map_fbo);
     glBindFramebuffer(GL_FRAMEBUFFER, shadow_map_fbo);
@@ -238,7 +238,7 @@ void update_particles()
     uniform("time", get_elapsed_time());
     uniform("emitterPos", emitter_pos);
     uniform("particleLifetime", particle_lifetime);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer_spawn);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer_spawn);
     glDispatchCompute(NUM_PARTICLES / WORK_GROUP_SIZE, 1, 1);
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
@@ -249,11 +249,9 @@ void update_particles()
     uniform("seed", vec3(13.0f, 127.0f, 449.0f));
     uniform("spherePos", sphere_pos);
     uniform("particleLifetime", particle_lifetime);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffer_position);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buffer_position);
     glDispatchCompute(NUM_PARTICLES / WORK_GROUP_SIZE, 1, 1);
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
 }
 
 void update_shadow_map()
@@ -263,7 +261,7 @@ void update_shadow_map()
 
     // Clear shadowmap (all components 0!)
     glBindFramebuffer(GL_FRAMEBUFFER, shadow_map_fbo);
-    glViewport(0, 0, shadow_map_width, shadow_map_height);
+    gl_state->viewport(0, 0, shadow_map_width, shadow_map_height);
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT);
 
@@ -271,13 +269,13 @@ void update_shadow_map()
     use_shader(shader_shadow_map);
     uniform("projection", mat_projection_light);
     uniform("view", mat_view_light);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer_position);
+    gl_state->bindBuffer(GL_ARRAY_BUFFER, buffer_position);
     attribfv("position", 4, 0, 0);
     glDrawArrays(GL_POINTS, 0, NUM_PARTICLES);
 
     blend_mode(false);
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, window_width, window_height);
+    gl_state->viewport(0, 0, window_width, window_height);
 }
 
 void update_app(float dt)
@@ -307,7 +305,7 @@ void update_app(float dt)
 void render_geometry()
 {
     // Sphere
-    glBindTexture(GL_TEXTURE_2D, shadow_map_tex);
+    gl_state->bindTexture(0, GL_TEXTURE_2D, shadow_map_tex);
     cull(true, GL_CW, GL_BACK);
     use_shader(shader_sphere);
     uniform("projection", mat_projection);
@@ -347,20 +345,21 @@ void render_particles()
     uniform("smokeColor", smoke_color);
     uniform("smokeShadow", smoke_shadow);
     uniform("shadowMap0", 0);
-    glBindTexture(GL_TEXTURE_2D, shadow_map_tex);
-    glBindBuffer(GL_ARRAY_BUFFER, buffer_position);
+    gl_state->bindTexture(0, GL_TEXTURE_2D, shadow_map_tex);
+    gl_state->bindBuffer(GL_ARRAY_BUFFER, buffer_position);
     attribfv("position", 4, 0, 0);
     glDrawArrays(GL_POINTS, 0, NUM_PARTICLES);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // The shadow map is rendered to at the start of the next frame, so it must not stay bound for sampling.
+    gl_state->bindTexture(0, GL_TEXTURE_2D, 0);
 }
 
 void render_app(float dt)
 {
-    glEnable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
+    gl_state->enable(GL_DEPTH_TEST);
+    gl_state->depthMask(GL_TRUE);
     glDepthRangef(0.0f, 1.0f);
-    glDepthFunc(GL_LEQUAL);
+    gl_state->depthFunc(GL_LEQUAL);
     glClearDepthf(1.0f);
     glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -369,7 +368,7 @@ void render_app(float dt)
 
     // The particles are rendered without depth writes, but with depth testing
     // If they write to the depth buffer you'll likely get some artifacts here and there.
-    glDepthMask(GL_FALSE);
+    gl_state->depthMask(GL_FALSE);
     render_particles();
 }
 
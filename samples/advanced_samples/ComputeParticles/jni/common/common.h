@@ -49,14 +49,6 @@ using std::vector;
         exit(1);                                                        \
     }
 
-#define GL_CHECK(x)                                                                              \
-    x;                                                                                           \
-    {                                                                                            \
-        GLenum glError = glGetError();                                                           \
-        if(glError != GL_NO_ERROR) {                                                             \
-            LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1);                                                                             \
-        }                                                                                        \
-    }
+#include "GLCheck.h"
 
 #endif /* COMMON_H */
@@ -23,18 +23,19 @@
 #include <iostream>
 
 Shader current;
+MaliSDK::GLStateCache *gl_state = MaliSDK::GLStateCache::getInstance();
 
 void cull(bool enabled, GLenum front, GLenum mode)
 {
     if (enabled)
     {
-        glEnable(GL_CULL_FACE);
-        glFrontFace(front);
-        glCullFace(mode);
+        gl_state->enable(GL_CULL_FACE);
+        gl_state->frontFace(front);
+        gl_state->cullFace(mode);
     }
     else
     {
-        glDisable(GL_CULL_FACE);
+        gl_state->disable(GL_CULL_FACE);
     }
 }
 
@@ -42,12 +43,12 @@ void depth_test(bool enabled, GLenum func)
 {
     if (enabled)
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(func);
+        gl_state->enable(GL_DEPTH_TEST);
+        gl_state->depthFunc(func);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        gl_state->disable(GL_DEPTH_TEST);
     }
 }
 
@@ -55,12 +56,12 @@ void depth_write(bool enabled)
 {
     if (enabled)
     {
-        glDepthMask(GL_TRUE);
+        gl_state->depthMask(GL_TRUE);
         glDepthRangef(0.0f, 1.0f);
     }
     else
     {
-        glDepthMask(GL_FALSE);
+        gl_state->depthMask(GL_FALSE);
     }
 }
 
@@ -68,13 +69,13 @@ void blend_mode(bool enabled, GLenum src, GLenum dest, GLenum func)
 {
     if (enabled)
     {
-        glEnable(GL_BLEND);
-        glBlendFunc(src, dest);
-        glBlendEquation(func);
+        gl_state->enable(GL_BLEND);
+        gl_state->blendFunc(src, dest);
+        gl_state->blendEquation(func);
     }
     else
     {
-        glDisable(GL_BLEND);
+        gl_state->disable(GL_BLEND);
     }
 }
 
@@ -123,9 +124,8 @@ GLuint gen_buffer(GLenum target, GLenum usage, GLsizei size, const void *data)
 {
     GLuint buffer;
     glGenBuffers(1, &buffer);
-    glBindBuffer(target, buffer);
+    gl_state->bindBuffer(target, buffer);
     glBufferData(target, size, data, usage);
-    glBindBuffer(target, 0);
     return buffer;
 }
 
@@ -136,5 +136,5 @@ GLuint gen_buffer(GLenum target, GLsizei size, const void *data)
 
 void del_buffer(GLuint buffer)
 {
-    glDeleteBuffers(1, &buffer);
+    gl_state->deleteBuffers(1, &buffer);
 }
\ No newline at end of file
@@ -23,9 +23,15 @@
 #include "matrix.h"
 #include "common.h"
 #include "shader.h"
+#include "GLStateCache.h"
 #include <string>
 #include <sstream>
 
+/*
+All state changes of the sample go through this cache, which drops the ones that would not change anything.
+*/
+extern MaliSDK::GLStateCache *gl_state;
+
  /*
 Triangles are either drawn in a clockwise or counterclockwise order. Facets that face away from the viewer
 can be hidden by setting the rasterizer state to cull such facets.
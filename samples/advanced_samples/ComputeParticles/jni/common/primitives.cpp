@@ -121,6 +121,6 @@ void Mesh::dispose()
 
 void Mesh::bind()
 {
-    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    gl_state->bindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    gl_state->bindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
 }
\ No newline at end of file
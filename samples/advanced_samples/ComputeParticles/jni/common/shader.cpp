@@ -132,17 +132,17 @@ void Shader::dispose()
     m_uniforms.clear();
     for (int i = 0; i < m_shaders.size(); ++i)
         glDeleteShader(m_shaders[i]);
-    glDeleteProgram(m_id);
+    gl_state->deleteProgram(m_id);
 }
 
 void Shader::use()
 {
-    glUseProgram(m_id);
+    gl_state->useProgram(m_id);
 }
 
 void Shader::unuse()
 {
-    glUseProgram(0);
+    gl_state->useProgram(0);
 }
 
 GLint Shader::get_uniform_location(string name)
@@ -183,7 +183,7 @@ void Shader::set_attribfv(string name, GLsizei num_components,
                           GLsizei stride, GLsizei offset)
 {
     GLint loc = get_attribute_location(name);
-    glEnableVertexAttribArray(loc);
+    gl_state->enableVertexAttribArray(loc);
     glVertexAttribPointer(
         loc, 
         num_components, // in the attribute,
@@ -196,7 +196,7 @@ void Shader::set_attribfv(string name, GLsizei num_components,
 
 void Shader::unset_attrib(string name)
 {
-    glDisableVertexAttribArray(get_attribute_location(name));
+    gl_state->disableVertexAttribArray(get_attribute_location(name));
 }
 
 void Shader::set_uniform(string name, const mat4 &v) { glUniformMatrix4fv(get_uniform_location(name), 1, GL_FALSE, v.value_ptr()); }
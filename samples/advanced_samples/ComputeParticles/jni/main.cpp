@@ -28,6 +28,8 @@
 #include "app.h"
 #include "timer.h"
 #include "common.h"
+#include "glutil.h"
+#include "Profiler.h"
 
 float last_tick;
 
@@ -52,6 +54,8 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_computeparticles_ComputeParticles_init
     (JNIEnv *env, jclass jcls, jint width, jint height)
     {
+        /* The context may have been recreated since the last init, so nothing the cache remembers is valid. */
+        gl_state->invalidate();
         ASSERT(load_app(), "Failed to load content");
         init_app(width, height);
 
@@ -62,6 +66,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_computeparticles_ComputeParticles_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         double curr_tick = get_elapsed_time();
         double dt = curr_tick - last_tick;
         last_tick = curr_tick;
@@ -109,10 +109,10 @@ void sort_bits(GLuint buf_input, int bit_offset, vec3 axis, float z_min, float z
     unsigned blocks = NUM_BLOCKS;
 
     // First pass. Compute 16-bit unsigned depth and apply first pass of scan algorithm.
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_input);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[0]);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[0]);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buf_flags);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_input);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[0]);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[0]);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buf_flags);
     use_shader(shader_scan_first);
     uniform("bitOffset", bit_offset);
     uniform("axis", axis);
@@ -131,18 +131,18 @@ void sort_bits(GLuint buf_input, int bit_offset, vec3 axis, float z_min, float z
         blocks = (blocks + BLOCK_SIZE - 1) / BLOCK_SIZE;
         dispatch_sizes[i] = blocks;
 
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_sums[i - 1]);
+        gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_sums[i - 1]);
         // If we only do one work group we don't need to resolve it later,
         // and we can update the scan buffer inplace.
         if (blocks <= 1)
         {
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_sums[i - 1]);
+            gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_sums[i - 1]);
         }
         else
         {
-            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[i]);
+            gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[i]);
         }
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[i]);
+        gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[i]);
 
         glDispatchCompute(blocks, 1, 1);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
@@ -158,20 +158,20 @@ void sort_bits(GLuint buf_input, int bit_offset, vec3 axis, float z_min, float z
             continue;
         }
 
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_scan[i]);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_sums[i]);
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[i - 1]);
+        gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_scan[i]);
+        gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_sums[i]);
+        gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[i - 1]);
         glDispatchCompute(dispatch_sizes[i], 1, 1);
         glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
     }
 
     // We can now reorder our input properly.
     use_shader(shader_reorder);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_input);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[0]);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[0]);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buf_sorted);
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, buf_flags);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buf_input);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, buf_scan[0]);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, buf_sums[0]);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, buf_sorted);
+    gl_state->bindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, buf_flags);
     glDispatchCompute(NUM_BLOCKS, 1, 1);
     glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
@@ -28,22 +28,30 @@
 
 #include <string>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "Cube.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
 #include "Text.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "Matrix.h"
 #include "Timer.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.cube/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string vertexShaderFilename = "Cube_cube.vert";
 string fragmentShaderFilename = "Cube_cube.frag";
 
@@ -165,6 +173,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_cube_Cube_init
@@ -180,6 +189,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_cube_Cube_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -189,3 +199,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Cube", setupGraphics, renderFrame)
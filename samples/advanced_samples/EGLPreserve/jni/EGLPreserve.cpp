@@ -43,8 +43,10 @@
 
 #include <string>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <sys/time.h>
  
@@ -55,13 +57,19 @@
 #include "Matrix.h"
 #include "Platform.h"
 #include "Timer.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.eglpreserve/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string vertexShaderFilename = "EGLPreserve_cube.vert";
 string fragmentShaderFilename = "EGLPreserve_cube.frag";
 
@@ -304,6 +312,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_eglpreserve_EGLPreserve_init
@@ -322,6 +331,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_eglpreserve_EGLPreserve_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -331,3 +341,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("EGLPreserve", setupGraphics, renderFrame)
@@ -38,19 +38,27 @@
 #include <string>
 #include <sstream>
 
+#if defined(ANDROID)
 #include <jni.h>
-#include <android/log.h> 
+#include <android/log.h>
+#endif
  
 #include "ETCAtlasAlpha.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "ETCHeader.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::stringstream;
 using std::string;
 using namespace MaliSDK;
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.etcatlasalpha/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string textureFilename = "good_atlas_mip_";
 string imageExtension = ".pkm";
 
@@ -89,7 +97,11 @@ bool setupGraphics(int width, int height)
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
     /* Initialize textures. Using an atlas, load atlas and all mipmap levels from files. */
-    Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID);
+    if (!Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID))
+    {
+        LOGE("Could not load texture %s\n", texturePath.c_str());
+        return false;
+    }
 
     /* Process shaders. */
     GLuint vertexShaderID = 0;
@@ -168,6 +180,7 @@ void renderFrame(void)
     GL_CHECK(glDrawElements(GL_TRIANGLE_STRIP, sizeof(indices) / sizeof(GLubyte), GL_UNSIGNED_BYTE, indices));
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcatlasalpha_ETCAtlasAlpha_init
@@ -194,6 +207,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcatlasalpha_ETCAtlasAlpha_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -203,3 +217,7 @@ extern "C"
 
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ETCAtlasAlpha", setupGraphics, renderFrame)
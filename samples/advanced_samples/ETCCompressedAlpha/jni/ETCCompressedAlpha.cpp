@@ -38,19 +38,27 @@
 #include <string>
 #include <sstream>
 
+#if defined(ANDROID)
 #include <jni.h>
-#include <android/log.h> 
+#include <android/log.h>
+#endif
  
 #include "ETCCompressedAlpha.h"
 #include "Shader.h"
 #include "Texture.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::stringstream;
 using std::string;
 using namespace MaliSDK;
 
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.etccompressedalpha/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string textureFilename = "good_compressed_mip_";
 string imageExtension = ".pkm";
 string alphaExtension = "_alpha.pkm";
@@ -95,9 +103,17 @@ bool setupGraphics(int w, int h)
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
     /* Initialize textures using separate files */
-    Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID);
+    if (!Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID))
+    {
+        LOGE("Could not load texture %s\n", texturePath.c_str());
+        return false;
+    }
     GL_CHECK(glActiveTexture(GL_TEXTURE1));
-    Texture::loadCompressedMipmaps(texturePath.c_str(), alphaExtension.c_str(), &alphaTextureID);
+    if (!Texture::loadCompressedMipmaps(texturePath.c_str(), alphaExtension.c_str(), &alphaTextureID))
+    {
+        LOGE("Could not load texture %s\n", texturePath.c_str());
+        return false;
+    }
 
     /* Process shaders. */
     Shader::processShader(&vertexShaderID, vertexShaderPath.c_str(), GL_VERTEX_SHADER);
@@ -184,6 +200,7 @@ void renderFrame(void)
     GL_CHECK(glDrawElements(GL_TRIANGLE_STRIP, sizeof(indices) / sizeof(GLubyte), GL_UNSIGNED_BYTE, indices));
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etccompressedalpha_ETCCompressedAlpha_init
@@ -213,6 +230,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etccompressedalpha_ETCCompressedAlpha_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -222,3 +240,7 @@ extern "C"
 
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ETCCompressedAlpha", setupGraphics, renderFrame)
@@ -39,21 +39,30 @@
 #include <string>
 #include <sstream>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "ETCMipmap.h"
 #include "Shader.h"
 #include "Text.h"
 #include "Texture.h"
 #include "ETCHeader.h"
-#include "AndroidPlatform.h"
+#include "ETCDecoder.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::stringstream;
 using std::string;
 using namespace MaliSDK;
 
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.etcmipmap/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string textureFilename = "good_mip_";
 string imageExtension = ".pkm";
 
@@ -74,6 +83,11 @@ GLint iLocSampler = -1;
 /* A text object to draw text on the screen. */
 Text *text;
 
+/* Set to true to log the throughput of the CPU ETC decoder at startup. */
+const bool runETCDecoderBenchmark = false;
+/* Number of threads used by the benchmark. */
+const int numberOfDecoderThreads = 4;
+
 bool setupGraphics(int w, int h)
 {
     LOGD("setupGraphics(%d, %d)", w, h);
@@ -91,6 +105,11 @@ bool setupGraphics(int w, int h)
     /* Should do src * (src alpha) + dest * (1-src alpha). */
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
+    if (runETCDecoderBenchmark)
+    {
+        ETCDecoder::benchmark(1024, 1024, numberOfDecoderThreads);
+    }
+
     /* Check which formats are supported. */
     if (!Texture::isETCSupported(true))
     {
@@ -112,20 +131,29 @@ bool setupGraphics(int w, int h)
      */
 #ifdef LOAD_MIPMAPS
     /* Load all Mipmap levels from files. */
-    Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID);
+    if (!Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID))
+    {
+        LOGE("Could not load texture %s\n", texturePath.c_str());
+        return false;
+    }
 #else /* LOAD_MIPMAPS */
     /* Load just base level texture data. */
     GL_CHECK(glGenTextures(1, &textureID));
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
     string mainTexturePath = texturePath + "0" + imageExtension;
-    unsigned char *textureData;
-    Texture::loadData(mainTexturePath.c_str(), &textureData);
-    ETCHeader loadedETCHeader = ETCHeader(textureData);
+    AssetFile textureFile;
+    ETCHeader loadedETCHeader;
+    AssetSpan textureData;
+    if (!textureFile.open(mainTexturePath.c_str()) || !Texture::loadPKMData(textureFile, &loadedETCHeader, &textureData))
+    {
+        LOGE("Could not load texture %s\n", mainTexturePath.c_str());
+        return false;
+    }
     GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_ETC1_RGB8_OES,
              loadedETCHeader.getWidth(), loadedETCHeader.getHeight(), 0,
              loadedETCHeader.getPaddedWidth() * loadedETCHeader.getPaddedHeight() >> 1,
-             textureData + 16));
-    free(textureData);
+             textureData.data));
+    textureFile.close();
 
 #    ifdef DISABLE_MIPMAPS
     /* Disable Mipmaps. */
@@ -216,6 +244,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcmipmap_ETCMipmap_init
@@ -242,6 +271,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcmipmap_ETCMipmap_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -251,3 +281,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ETCMipmap", setupGraphics, renderFrame)
@@ -38,19 +38,27 @@
 #include <string>
 #include <sstream>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "ETCUncompressedAlpha.h"
 #include "Shader.h"
 #include "Texture.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::stringstream;
 using std::string;
 using namespace MaliSDK;
 
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.etcuncompressedalpha/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string textureFilename = "good_uncompressed_mip_";
 string imageExtension = ".pkm";
 string alphaExtension = "_alpha.pgm";
@@ -146,7 +154,11 @@ bool setupGraphics(int w, int h)
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
     /* Initialize textures using separate files. */
-    Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID);
+    if (!Texture::loadCompressedMipmaps(texturePath.c_str(), imageExtension.c_str(), &textureID))
+    {
+        LOGE("Could not load texture %s\n", texturePath.c_str());
+        return false;
+    }
     GL_CHECK(glActiveTexture(GL_TEXTURE1));
     /* Use only the level 0 mipmap of the uncompressed alpha image, use OpenGL ES to generate the remaining levels */
     loadUncompressedAlpha((texturePath + "0" + alphaExtension).c_str(), &alphaTextureID);
@@ -237,6 +249,7 @@ void renderFrame(void)
     GL_CHECK(glDrawElements(GL_TRIANGLE_STRIP, sizeof(indices) / sizeof(GLubyte), GL_UNSIGNED_BYTE, indices));
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcuncompressedalpha_ETCUncompressedAlpha_init
@@ -265,6 +278,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcuncompressedalpha_ETCUncompressedAlpha_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -274,3 +288,7 @@ extern "C"
 
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ETCUncompressedAlpha", setupGraphics, renderFrame)
@@ -33,6 +33,7 @@
 #include "Timer.h"
 #include "Text.h"
 #include <jni.h>
+#include "Profiler.h"
 
 using namespace std;
 using namespace GLFFT;
@@ -294,6 +295,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_ocean_Ocean_step
         (JNIEnv *, jclass)
     {
+        MaliSDK::ProfileFrame profileFrame;
         float delta_time = timer.getInterval();
         total_time += delta_time;
         method_timer += delta_time;
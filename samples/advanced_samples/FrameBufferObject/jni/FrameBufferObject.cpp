@@ -32,21 +32,29 @@
 
 #include <string>
 
+#if defined(ANDROID)
 #include <jni.h>
-#include <android/log.h> 
+#include <android/log.h>
+#endif
  
 #include "FrameBufferObject.h"
 #include "Text.h"
 #include "Shader.h"
 #include "Texture.h"
 #include "Matrix.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.framebufferobject/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string vertexShaderFilename = "FrameBufferObject_cube.vert";
 string fragmentShaderFilename = "FrameBufferObject_cube.frag";
 
@@ -337,6 +345,7 @@ void renderFrame(void)
     if(angleZ >= 360) angleZ -= 360;
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_framebufferobject_FrameBufferObject_init
@@ -352,6 +361,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_framebufferobject_FrameBufferObject_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -361,3 +371,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("FrameBufferObject", setupGraphics, renderFrame)
@@ -36,6 +36,7 @@
 
 #include "Platform.h"
 #include "AndroidPlatform.h"
+#include "Profiler.h"
 
 using namespace MaliSDK;
 
@@ -283,6 +284,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_listeglconfigs_ListEGLConfigs_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         /* We don't need to render frames. */
     }
 
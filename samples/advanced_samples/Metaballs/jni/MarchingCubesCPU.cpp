@@ -0,0 +1,538 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MarchingCubesCPU.h"
+
+#include "ParallelBands.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MC_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MC_USE_SSE2 1
+#endif
+
+/** Precision to avoid division-by-zero errors. Same value as in the scalar field shader. */
+#define EPSILON 0.000001f
+
+/** Value stored in edgeVertices for edges not crossed by the isosurface. */
+#define NO_VERTEX 0xFFFFFFFFu
+
+namespace
+{
+    /** Maximum amount of vertices a single cell can define (one row of tri_table). */
+    const int mcVerticesPerCell = 15;
+
+    /**
+     * Edges of a cell expressed as the corner with the lowest coordinates plus the axis
+     * the edge runs along (0 = x, 1 = y, 2 = z). Edge and corner numbering follows the
+     * edge_begins_in_cell_corner / edge_ends_in_cell_corner arrays of the triangle shader.
+     */
+    const unsigned int edgeBase[12][3] =
+    {
+        {0, 0, 0}, {1, 0, 0}, {0, 0, 1}, {0, 0, 0},
+        {0, 1, 0}, {1, 1, 0}, {0, 1, 1}, {0, 1, 0},
+        {0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}
+    };
+    const unsigned int edgeAxis[12] = { 0, 2, 0, 2, 0, 2, 0, 2, 1, 1, 1, 1 };
+}
+
+namespace MaliSDK
+{
+    bool MarchingCubesMesh::exportOBJ(const char* filename) const
+    {
+        FILE* file = fopen(filename, "w");
+        if (file == NULL)
+        {
+            return false;
+        }
+
+        fprintf(file, "# Metaballs Marching Cubes mesh: %u vertices, %u triangles\n", getNumberOfVertices(), getNumberOfTriangles());
+
+        for (unsigned int vertex = 0; vertex < getNumberOfVertices(); vertex++)
+        {
+            fprintf(file, "v %.6f %.6f %.6f\n", positions[vertex * 3 + 0], positions[vertex * 3 + 1], positions[vertex * 3 + 2]);
+        }
+
+        for (unsigned int vertex = 0; vertex < getNumberOfVertices(); vertex++)
+        {
+            const GLfloat* normal = &normals[vertex * 3];
+            float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            if (length < EPSILON)
+            {
+                length = 1.0f;
+            }
+            fprintf(file, "vn %.6f %.6f %.6f\n", normal[0] / length, normal[1] / length, normal[2] / length);
+        }
+
+        /* OBJ indices are 1-based. */
+        for (unsigned int triangle = 0; triangle < getNumberOfTriangles(); triangle++)
+        {
+            GLuint a = indices[triangle * 3 + 0] + 1;
+            GLuint b = indices[triangle * 3 + 1] + 1;
+            GLuint c = indices[triangle * 3 + 2] + 1;
+            fprintf(file, "f %u//%u %u//%u %u//%u\n", a, a, b, b, c, c);
+        }
+
+        bool success = (ferror(file) == 0);
+        if (fclose(file) != 0)
+        {
+            success = false;
+        }
+        return success;
+    }
+
+    MarchingCubesCPU::MarchingCubesCPU(const GLint* triTable, unsigned int samplesPerAxis, unsigned int numberOfThreads)
+        : triTable(triTable)
+        , samplesPerAxis(samplesPerAxis < 2 ? 2 : samplesPerAxis)
+        , cellsPerAxis(0)
+        , numberOfThreads(numberOfThreads < 1 ? 1 : numberOfThreads)
+        , spheres(NULL)
+        , numberOfSpheres(0)
+        , currentFunction(NULL)
+    {
+        cellsPerAxis = this->samplesPerAxis - 1;
+
+        /* More slabs than z planes would leave threads without work. */
+        if (this->numberOfThreads > this->samplesPerAxis)
+        {
+            this->numberOfThreads = this->samplesPerAxis;
+        }
+
+        const unsigned int samplesInSpace = this->samplesPerAxis * this->samplesPerAxis * this->samplesPerAxis;
+
+        scalarField.resize(samplesInSpace, 0.0f);
+        insideFlags.resize(samplesInSpace, 0);
+        edgeVertices.resize(samplesInSpace * 3, NO_VERTEX);
+        cellTypes.resize(cellsPerAxis * cellsPerAxis * cellsPerAxis, 0);
+
+        /* Split z planes evenly between slabs. */
+        slabs.resize(this->numberOfThreads);
+        for (unsigned int slabIndex = 0; slabIndex < this->numberOfThreads; slabIndex++)
+        {
+            Slab& slab = slabs[slabIndex];
+
+            memset(&slab, 0, sizeof(Slab));
+            slab.engine = this;
+            slab.firstZ = (this->samplesPerAxis * slabIndex) / this->numberOfThreads;
+            slab.endZ   = (this->samplesPerAxis * (slabIndex + 1)) / this->numberOfThreads;
+        }
+
+        /* Number of tri_table entries used by each cell type, so that output can be sized up front. */
+        for (int cellType = 0; cellType < 256; cellType++)
+        {
+            int vertexCount = 0;
+            while (vertexCount < mcVerticesPerCell && triTable[cellType * mcVerticesPerCell + vertexCount] != -1)
+            {
+                vertexCount++;
+            }
+            verticesPerCellType[cellType] = (unsigned char)vertexCount;
+        }
+    }
+
+    void MarchingCubesCPU::slabEntry(void* argument)
+    {
+        Slab* slab = (Slab*)argument;
+        MarchingCubesCPU* engine = slab->engine;
+
+        (engine->*(engine->currentFunction))(slab);
+    }
+
+    void MarchingCubesCPU::runSlabs(SlabFunction function)
+    {
+        currentFunction = function;
+
+        runBands(slabEntry, &slabs[0], sizeof(Slab), numberOfThreads);
+    }
+
+    void MarchingCubesCPU::calculateScalarField(const GLfloat* spheres, int numberOfSpheres)
+    {
+        this->spheres         = spheres;
+        this->numberOfSpheres = numberOfSpheres;
+
+        runSlabs(&MarchingCubesCPU::fieldSlab);
+
+        this->spheres = NULL;
+    }
+
+    void MarchingCubesCPU::setScalarField(const GLfloat* field)
+    {
+        memcpy(&scalarField[0], field, scalarField.size() * sizeof(GLfloat));
+    }
+
+    void MarchingCubesCPU::fieldSlab(Slab* slab)
+    {
+        const unsigned int S           = samplesPerAxis;
+        const float        denominator = float(S - 1);
+        const float        epsilon2    = EPSILON * EPSILON;
+
+        for (unsigned int z = slab->firstZ; z < slab->endZ; z++)
+        {
+            const float pz = float(z) / denominator;
+
+            for (unsigned int y = 0; y < S; y++)
+            {
+                const float py  = float(y) / denominator;
+                GLfloat*    row = &scalarField[S * (y + S * z)];
+                unsigned int x  = 0;
+
+#if defined(MC_USE_SSE2) || (defined(MC_USE_NEON) && defined(__aarch64__))
+                /* Evaluate four samples along x at once. Same operation order as the scalar loop below. */
+                for (; x + 4 <= S; x += 4)
+                {
+#if defined(MC_USE_SSE2)
+                    __m128 px    = _mm_div_ps(_mm_set_ps(float(x + 3), float(x + 2), float(x + 1), float(x)), _mm_set1_ps(denominator));
+                    __m128 field = _mm_setzero_ps();
+
+                    for (int sphere = 0; sphere < numberOfSpheres; sphere++)
+                    {
+                        const GLfloat* s  = spheres + sphere * 4;
+                        __m128 dx         = _mm_sub_ps(_mm_set1_ps(s[0]), px);
+                        float  dy         = s[1] - py;
+                        float  dz         = s[2] - pz;
+                        __m128 distance2  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_set1_ps(dy * dy)), _mm_set1_ps(dz * dz));
+
+                        field = _mm_add_ps(field, _mm_div_ps(_mm_set1_ps(s[3]), _mm_max_ps(_mm_set1_ps(epsilon2), distance2)));
+                    }
+                    _mm_storeu_ps(row + x, field);
+#else
+                    const float    lanes[4] = { float(x), float(x + 1), float(x + 2), float(x + 3) };
+                    float32x4_t    px       = vdivq_f32(vld1q_f32(lanes), vdupq_n_f32(denominator));
+                    float32x4_t    field    = vdupq_n_f32(0.0f);
+
+                    for (int sphere = 0; sphere < numberOfSpheres; sphere++)
+                    {
+                        const GLfloat* s         = spheres + sphere * 4;
+                        float32x4_t    dx        = vsubq_f32(vdupq_n_f32(s[0]), px);
+                        float          dy        = s[1] - py;
+                        float          dz        = s[2] - pz;
+                        float32x4_t    distance2 = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vdupq_n_f32(dy * dy)), vdupq_n_f32(dz * dz));
+
+                        field = vaddq_f32(field, vdivq_f32(vdupq_n_f32(s[3]), vmaxq_f32(vdupq_n_f32(epsilon2), distance2)));
+                    }
+                    vst1q_f32(row + x, field);
+#endif
+                }
+#endif
+                for (; x < S; x++)
+                {
+                    const float px    = float(x) / denominator;
+                    float       field = 0.0f;
+
+                    for (int sphere = 0; sphere < numberOfSpheres; sphere++)
+                    {
+                        const GLfloat* s         = spheres + sphere * 4;
+                        float          dx        = s[0] - px;
+                        float          dy        = s[1] - py;
+                        float          dz        = s[2] - pz;
+                        float          distance2 = dx * dx + dy * dy + dz * dz;
+
+                        /* max(EPSILON, distance)^2 == max(EPSILON^2, distance^2) as both are non-negative. */
+                        field += s[3] / (distance2 > epsilon2 ? distance2 : epsilon2);
+                    }
+                    row[x] = field;
+                }
+            }
+        }
+    }
+
+    void MarchingCubesCPU::polygonise(GLfloat isoLevel, MarchingCubesMesh* mesh)
+    {
+        for (unsigned int slabIndex = 0; slabIndex < slabs.size(); slabIndex++)
+        {
+            slabs[slabIndex].mesh     = mesh;
+            slabs[slabIndex].isoLevel = isoLevel;
+        }
+
+        /* Stage 1: inside/outside flag for every sample. */
+        runSlabs(&MarchingCubesCPU::classifySlab);
+
+        /* Stage 2: cell types, and number of vertices and indices produced by each slab. */
+        runSlabs(&MarchingCubesCPU::countSlab);
+
+        unsigned int numberOfVertices = 0;
+        unsigned int numberOfIndices  = 0;
+        for (unsigned int slabIndex = 0; slabIndex < slabs.size(); slabIndex++)
+        {
+            slabs[slabIndex].firstVertex = numberOfVertices;
+            slabs[slabIndex].firstIndex  = numberOfIndices;
+            numberOfVertices += slabs[slabIndex].numberOfVertices;
+            numberOfIndices  += slabs[slabIndex].numberOfIndices;
+        }
+
+        mesh->positions.resize(numberOfVertices * 3);
+        mesh->normals.resize(numberOfVertices * 3);
+        mesh->indices.resize(numberOfIndices);
+
+        /* Stage 3: one vertex per crossed edge. Output order does not depend on the thread count. */
+        runSlabs(&MarchingCubesCPU::vertexSlab);
+
+        /* Stage 4: triangles referencing the shared edge vertices. */
+        runSlabs(&MarchingCubesCPU::triangleSlab);
+    }
+
+    void MarchingCubesCPU::classifySlab(Slab* slab)
+    {
+        const unsigned int S     = samplesPerAxis;
+        const unsigned int begin = S * S * slab->firstZ;
+        const unsigned int end   = S * S * slab->endZ;
+        const GLfloat*     field = &scalarField[0];
+        unsigned char*     flags = &insideFlags[0];
+        unsigned int       index = begin;
+
+        /* Flags are stored as 0x00 / 0xFF masks so that cell types can be built with AND / OR only. */
+#if defined(MC_USE_NEON)
+        const float32x4_t iso = vdupq_n_f32(slab->isoLevel);
+        for (; index + 16 <= end; index += 16)
+        {
+            uint16x8_t low  = vcombine_u16(vmovn_u32(vcltq_f32(vld1q_f32(field + index +  0), iso)),
+                                           vmovn_u32(vcltq_f32(vld1q_f32(field + index +  4), iso)));
+            uint16x8_t high = vcombine_u16(vmovn_u32(vcltq_f32(vld1q_f32(field + index +  8), iso)),
+                                           vmovn_u32(vcltq_f32(vld1q_f32(field + index + 12), iso)));
+            vst1q_u8(flags + index, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+        }
+#elif defined(MC_USE_SSE2)
+        const __m128 iso = _mm_set1_ps(slab->isoLevel);
+        for (; index + 16 <= end; index += 16)
+        {
+            __m128i low  = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(field + index +  0), iso)),
+                                           _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(field + index +  4), iso)));
+            __m128i high = _mm_packs_epi32(_mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(field + index +  8), iso)),
+                                           _mm_castps_si128(_mm_cmplt_ps(_mm_loadu_ps(field + index + 12), iso)));
+            _mm_storeu_si128((__m128i*)(flags + index), _mm_packs_epi16(low, high));
+        }
+#endif
+        for (; index < end; index++)
+        {
+            flags[index] = (field[index] < slab->isoLevel) ? 0xFF : 0x00;
+        }
+    }
+
+    void MarchingCubesCPU::countSlab(Slab* slab)
+    {
+        const unsigned int   S     = samplesPerAxis;
+        const unsigned int   C     = cellsPerAxis;
+        const unsigned char* flags = &insideFlags[0];
+        unsigned int         numberOfVertices = 0;
+        unsigned int         numberOfIndices  = 0;
+
+        /* Cell types for cells whose origin lies in this slab. */
+        const unsigned int cellEndZ = slab->endZ < C ? slab->endZ : C;
+        for (unsigned int z = slab->firstZ; z < cellEndZ; z++)
+        {
+            for (unsigned int y = 0; y < C; y++)
+            {
+                /* Sample rows holding the cell corners: (y, z), (y, z + 1), (y + 1, z), (y + 1, z + 1). */
+                const unsigned char* r00   = flags + S * (y     + S * z      );
+                const unsigned char* r01   = flags + S * (y     + S * (z + 1));
+                const unsigned char* r10   = flags + S * (y + 1 + S * z      );
+                const unsigned char* r11   = flags + S * (y + 1 + S * (z + 1));
+                unsigned char*       types = &cellTypes[C * (y + C * z)];
+                unsigned int         x     = 0;
+
+                /* Sixteen cells per iteration. Corner bits follow cell_corners_offsets of the cell shader. */
+#if defined(MC_USE_NEON)
+                for (; x + 16 <= C; x += 16)
+                {
+                    uint8x16_t type = vandq_u8(vld1q_u8(r00 + x), vdupq_n_u8(0x01));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r00 + x + 1), vdupq_n_u8(0x02)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r01 + x + 1), vdupq_n_u8(0x04)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r01 + x    ), vdupq_n_u8(0x08)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r10 + x    ), vdupq_n_u8(0x10)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r10 + x + 1), vdupq_n_u8(0x20)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r11 + x + 1), vdupq_n_u8(0x40)));
+                    type = vorrq_u8(type, vandq_u8(vld1q_u8(r11 + x    ), vdupq_n_u8(0x80)));
+                    vst1q_u8(types + x, type);
+                }
+#elif defined(MC_USE_SSE2)
+                for (; x + 16 <= C; x += 16)
+                {
+#define MC_LOAD(row, bit) _mm_and_si128(_mm_loadu_si128((const __m128i*)(row)), _mm_set1_epi8((char)(bit)))
+                    __m128i type = MC_LOAD(r00 + x, 0x01);
+                    type = _mm_or_si128(type, MC_LOAD(r00 + x + 1, 0x02));
+                    type = _mm_or_si128(type, MC_LOAD(r01 + x + 1, 0x04));
+                    type = _mm_or_si128(type, MC_LOAD(r01 + x,     0x08));
+                    type = _mm_or_si128(type, MC_LOAD(r10 + x,     0x10));
+                    type = _mm_or_si128(type, MC_LOAD(r10 + x + 1, 0x20));
+                    type = _mm_or_si128(type, MC_LOAD(r11 + x + 1, 0x40));
+                    type = _mm_or_si128(type, MC_LOAD(r11 + x,     0x80));
+#undef MC_LOAD
+                    _mm_storeu_si128((__m128i*)(types + x), type);
+                }
+#endif
+                for (; x < C; x++)
+                {
+                    types[x] = (unsigned char)((r00[x    ] & 0x01) | (r00[x + 1] & 0x02) |
+                                               (r01[x + 1] & 0x04) | (r01[x    ] & 0x08) |
+                                               (r10[x    ] & 0x10) | (r10[x + 1] & 0x20) |
+                                               (r11[x + 1] & 0x40) | (r11[x    ] & 0x80));
+                }
+
+                for (x = 0; x < C; x++)
+                {
+                    numberOfIndices += verticesPerCellType[types[x]];
+                }
+            }
+        }
+
+        /* An edge carries a vertex when its two end samples lie on different sides of the isosurface. */
+        for (unsigned int z = slab->firstZ; z < slab->endZ; z++)
+        {
+            for (unsigned int y = 0; y < S; y++)
+            {
+                const unsigned int base = S * (y + S * z);
+
+                for (unsigned int x = 0; x < S; x++)
+                {
+                    const unsigned char inside = flags[base + x];
+
+                    numberOfVertices += (x + 1 < S && inside != flags[base + x + 1    ]) ? 1 : 0;
+                    numberOfVertices += (y + 1 < S && inside != flags[base + x + S    ]) ? 1 : 0;
+                    numberOfVertices += (z + 1 < S && inside != flags[base + x + S * S]) ? 1 : 0;
+                }
+            }
+        }
+
+        slab->numberOfVertices = numberOfVertices;
+        slab->numberOfIndices  = numberOfIndices;
+    }
+
+    GLfloat MarchingCubesCPU::gradient(unsigned int x, unsigned int y, unsigned int z, unsigned int axis) const
+    {
+        /* Central difference with clamp-to-edge addressing, as calc_cell_corner_normal() does through the 3D texture. */
+        const unsigned int S           = samplesPerAxis;
+        unsigned int       lower[3]    = { x, y, z };
+        unsigned int       upper[3]    = { x, y, z };
+
+        if (lower[axis] > 0)
+        {
+            lower[axis]--;
+        }
+        if (upper[axis] + 1 < S)
+        {
+            upper[axis]++;
+        }
+
+        const GLfloat valueBegin = scalarField[lower[0] + S * (lower[1] + S * lower[2])];
+        const GLfloat valueEnd   = scalarField[upper[0] + S * (upper[1] + S * upper[2])];
+
+        return (valueEnd - valueBegin) / (2.0f / float(S - 1));
+    }
+
+    void MarchingCubesCPU::emitVertex(MarchingCubesMesh* mesh, GLuint vertexIndex, unsigned int x, unsigned int y, unsigned int z, unsigned int axis, GLfloat isoLevel) const
+    {
+        const unsigned int S       = samplesPerAxis;
+        const unsigned int start[3] = { x, y, z };
+        unsigned int       end[3]   = { x, y, z };
+
+        end[axis]++;
+
+        const GLfloat startValue = scalarField[start[0] + S * (start[1] + S * start[2])];
+        const GLfloat endValue   = scalarField[end[0]   + S * (end[1]   + S * end[2]  )];
+        const GLfloat delta      = fabsf(startValue - endValue);
+
+        /* Same as get_start_corner_portion() in the triangle shader. */
+        const GLfloat startPortion = (delta > EPSILON) ? fabsf(endValue - isoLevel) / delta : 0.5f;
+
+        GLfloat* position = &mesh->positions[vertexIndex * 3];
+        GLfloat* normal   = &mesh->normals[vertexIndex * 3];
+
+        for (int component = 0; component < 3; component++)
+        {
+            /* mix(end, start, portion) */
+            const GLfloat startCoordinate = float(start[component]) / float(S - 1);
+            const GLfloat endCoordinate   = float(end[component])   / float(S - 1);
+
+            position[component] = endCoordinate + (startCoordinate - endCoordinate) * startPortion;
+
+            const GLfloat startNormal = gradient(start[0], start[1], start[2], component);
+            const GLfloat endNormal   = gradient(end[0],   end[1],   end[2],   component);
+
+            normal[component] = endNormal + (startNormal - endNormal) * startPortion;
+        }
+    }
+
+    void MarchingCubesCPU::vertexSlab(Slab* slab)
+    {
+        const unsigned int   S           = samplesPerAxis;
+        const unsigned char* flags       = &insideFlags[0];
+        GLuint               vertexIndex = slab->firstVertex;
+
+        for (unsigned int z = slab->firstZ; z < slab->endZ; z++)
+        {
+            for (unsigned int y = 0; y < S; y++)
+            {
+                for (unsigned int x = 0; x < S; x++)
+                {
+                    const unsigned int  index     = x + S * (y + S * z);
+                    const unsigned int  coords[3] = { x, y, z };
+                    const unsigned int  steps[3]  = { 1, S, S * S };
+                    const unsigned char inside    = flags[index];
+
+                    for (unsigned int axis = 0; axis < 3; axis++)
+                    {
+                        if (coords[axis] + 1 < S && inside != flags[index + steps[axis]])
+                        {
+                            emitVertex(slab->mesh, vertexIndex, x, y, z, axis, slab->isoLevel);
+                            edgeVertices[index * 3 + axis] = vertexIndex++;
+                        }
+                        else
+                        {
+                            edgeVertices[index * 3 + axis] = NO_VERTEX;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    void MarchingCubesCPU::triangleSlab(Slab* slab)
+    {
+        const unsigned int S        = samplesPerAxis;
+        const unsigned int C        = cellsPerAxis;
+        const unsigned int cellEndZ = slab->endZ < C ? slab->endZ : C;
+        GLuint*            output   = slab->numberOfIndices > 0 ? &slab->mesh->indices[slab->firstIndex] : NULL;
+
+        for (unsigned int z = slab->firstZ; z < cellEndZ; z++)
+        {
+            for (unsigned int y = 0; y < C; y++)
+            {
+                for (unsigned int x = 0; x < C; x++)
+                {
+                    const unsigned char cellType = cellTypes[x + C * (y + C * z)];
+                    const GLint*        edges    = triTable + cellType * mcVerticesPerCell;
+
+                    for (int vertex = 0; vertex < verticesPerCellType[cellType]; vertex++)
+                    {
+                        const int          edge  = edges[vertex];
+                        const unsigned int point = (x + edgeBase[edge][0]) + S * ((y + edgeBase[edge][1]) + S * (z + edgeBase[edge][2]));
+
+                        *output++ = edgeVertices[point * 3 + edgeAxis[edge]];
+                    }
+                }
+            }
+        }
+    }
+}
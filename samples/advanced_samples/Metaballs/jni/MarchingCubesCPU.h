@@ -0,0 +1,164 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MARCHING_CUBES_CPU_H
+#define MARCHING_CUBES_CPU_H
+
+#include <GLES3/gl3.h>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Indexed triangle mesh produced by MarchingCubesCPU.
+     *
+     * Vertices are welded: every cell edge crossed by the isosurface owns exactly one vertex,
+     * which is shared by all triangles of all cells adjacent to that edge.
+     * Positions are in the same normalized [0.0 .. 1.0] model space used by the shaders.
+     */
+    struct MarchingCubesMesh
+    {
+        std::vector<GLfloat> positions; /**< Vertex positions, 3 floats per vertex. */
+        std::vector<GLfloat> normals;   /**< Unnormalized field gradients, 3 floats per vertex. */
+        std::vector<GLuint>  indices;   /**< Triangle list, 3 indices per triangle. */
+
+        /**
+         * \brief Number of vertices in the mesh.
+         */
+        unsigned int getNumberOfVertices() const { return (unsigned int)(positions.size() / 3); }
+
+        /**
+         * \brief Number of triangles in the mesh.
+         */
+        unsigned int getNumberOfTriangles() const { return (unsigned int)(indices.size() / 3); }
+
+        /**
+         * \brief Write the mesh as a Wavefront OBJ file.
+         *
+         * The output is deterministic for a given mesh, so it can be stored and diffed as a golden mesh.
+         * \param[in] filename Path of the file to create.
+         * \return true on success, false if the file could not be written.
+         */
+        bool exportOBJ(const char* filename) const;
+    };
+
+    /**
+     * \brief CPU reference implementation of the Metaballs Marching Cubes pipeline.
+     *
+     * Mirrors the four GPU stages of the sample: the scalar field is sampled on the same
+     * samples_per_axis^3 grid with the same falloff, cells are classified with the same
+     * corner numbering and "field < isolevel" rule, and triangles are emitted from the
+     * same tri_table rows, so the resulting surface matches the transform feedback output.
+     *
+     * Field evaluation and cell classification are vectorised across cells along the x axis
+     * (NEON or SSE2 where available), and every stage is split into z slabs processed by
+     * separate threads. The output does not depend on the number of threads.
+     */
+    class MarchingCubesCPU
+    {
+    public:
+        /**
+         * \brief Create an engine for a cubic grid.
+         * \param[in] triTable        Pointer to the 256 x 15 edge table shared with the GPU path. Not copied, must outlive the engine.
+         * \param[in] samplesPerAxis  Number of scalar field samples along each axis. Must be at least 2.
+         * \param[in] numberOfThreads Number of threads used for each stage. Values below 1 are treated as 1.
+         */
+        MarchingCubesCPU(const GLint* triTable, unsigned int samplesPerAxis, unsigned int numberOfThreads);
+
+        /**
+         * \brief Calculate the scalar field from a set of spheres.
+         *
+         * Uses the same formula as the scalar field stage shader:
+         * field = sum(weight / max(EPSILON, distance)^2).
+         * \param[in] spheres         Sphere data, 4 floats per sphere: xyz position and weight in w.
+         * \param[in] numberOfSpheres Number of spheres in the array.
+         */
+        void calculateScalarField(const GLfloat* spheres, int numberOfSpheres);
+
+        /**
+         * \brief Replace the scalar field with externally computed values.
+         * \param[in] field samplesPerAxis^3 values, encoded as x + y * samplesPerAxis + z * samplesPerAxis^2.
+         */
+        void setScalarField(const GLfloat* field);
+
+        /**
+         * \brief Read access to the current scalar field, laid out as in setScalarField().
+         */
+        const GLfloat* getScalarField() const { return &scalarField[0]; }
+
+        /**
+         * \brief Triangulate the isosurface of the current scalar field.
+         * \param[in]  isoLevel Scalar field value which defines the isosurface.
+         * \param[out] mesh     Receives the welded, indexed mesh. Previous contents are discarded.
+         */
+        void polygonise(GLfloat isoLevel, MarchingCubesMesh* mesh);
+
+        /**
+         * \brief Number of samples along each axis.
+         */
+        unsigned int getSamplesPerAxis() const { return samplesPerAxis; }
+
+    private:
+        /** Per-slab work description handed to the worker threads. */
+        struct Slab
+        {
+            MarchingCubesCPU*  engine;
+            MarchingCubesMesh* mesh;
+            GLfloat            isoLevel;
+            unsigned int       firstZ;
+            unsigned int       endZ;
+            unsigned int       numberOfVertices;
+            unsigned int       firstVertex;
+            unsigned int       numberOfIndices;
+            unsigned int       firstIndex;
+        };
+
+        /** Signature of a function run by runSlabs() for every slab. */
+        typedef void (MarchingCubesCPU::*SlabFunction)(Slab* slab);
+
+        const GLint*              triTable;
+        unsigned int              samplesPerAxis;
+        unsigned int              cellsPerAxis;
+        unsigned int              numberOfThreads;
+        const GLfloat*            spheres;
+        int                       numberOfSpheres;
+
+        std::vector<GLfloat>      scalarField;
+        std::vector<unsigned char> insideFlags;
+        std::vector<unsigned char> cellTypes;
+        std::vector<GLuint>       edgeVertices;
+        std::vector<Slab>         slabs;
+        SlabFunction              currentFunction;
+        unsigned char             verticesPerCellType[256];
+
+        void runSlabs(SlabFunction function);
+        static void slabEntry(void* argument);
+
+        void fieldSlab(Slab* slab);
+        void classifySlab(Slab* slab);
+        void countSlab(Slab* slab);
+        void vertexSlab(Slab* slab);
+        void triangleSlab(Slab* slab);
+
+        void emitVertex(MarchingCubesMesh* mesh, GLuint vertexIndex, unsigned int x, unsigned int y, unsigned int z, unsigned int axis, GLfloat isoLevel) const;
+        GLfloat gradient(unsigned int x, unsigned int y, unsigned int z, unsigned int axis) const;
+    };
+}
+#endif /* MARCHING_CUBES_CPU_H */
@@ -25,8 +25,6 @@
 #include <cstdio>
 #include <cstdlib>
 
-#include <android/log.h>
-
 namespace MaliSDK
 {
     /* Identity matrix. */
@@ -35,12 +35,15 @@
 #include <cstdio>
 #include <cstdlib>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "Shader.h"
 #include "Timer.h"
 #include "Matrix.h"
+#include "MarchingCubesCPU.h"
 
 #include "GLES3/gl3.h"
 #include "EGL/egl.h"
@@ -48,10 +51,16 @@
 
 #include <string>
 #include <cmath>
+#include "Profiler.h"
+#include "Benchmark.h"
 
+#if defined(ANDROID)
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include "Platform.h"
+#endif
 
 using std::string;
 using namespace MaliSDK;
@@ -763,6 +772,35 @@ const char* marching_cubes_triangles_frag_shader = "#version 300 es\n"
 "    FragColor = vec4(ambient_lighting + diffuse_reflection + specular_reflection, 1.0);\n"
 "}\n";
 
+/**
+ * Vertex shader used to render a mesh triangulated by the CPU Marching Cubes implementation.
+ * It produces the same outputs as marching_cubes_triangles_vert_shader, so the same fragment shader is used.
+ */
+const char* cpu_mesh_vert_shader                 = "#version 300 es\n"
+"\n"
+"/** Vertex position in model space ([0.0 .. 1.0] range). */\n"
+"in vec3 vertex_position;\n"
+"\n"
+"/** Scalar field gradient in the vertex. */\n"
+"in vec3 vertex_normal;\n"
+"\n"
+"/** Combined model view and projection matrices. */\n"
+"uniform mat4 mvp;\n"
+"\n"
+"/* Phong shading output variables for fragment shader. */\n"
+"out vec4 phong_vertex_position;      /**< position of the vertex in world space.  */\n"
+"out vec3 phong_vertex_normal_vector; /**< surface normal vector in world space.   */\n"
+"out vec3 phong_vertex_color;         /**< vertex color for fragment colorisation. */\n"
+"\n"
+"/** Shader entry point. */\n"
+"void main()\n"
+"{\n"
+"    gl_Position                = mvp * vec4(vertex_position, 1.0);\n"
+"    phong_vertex_position      = gl_Position;\n"
+"    phong_vertex_normal_vector = vertex_normal;\n"
+"    phong_vertex_color         = vec3(0.7);\n"
+"}\n";
+
 /* General metaballs example properties. */
 GLfloat      model_time        = 0.0f;  /**< Time (in seconds), increased each rendering iteration.                                         */
 const GLuint tesselation_level = 32;    /**< Level of details you would like to split model into. Please use values from th range [8..256]. */
@@ -1058,6 +1096,21 @@ const GLint tri_table[mc_cells_types_count * mc_vertices_per_cell] =
 /** Instance of a timer to measure time moments. */
 Timer timer;
 
+/* CPU Marching Cubes reference path. */
+const bool         use_cpu_marching_cubes       = false; /**< Triangulate on the CPU and draw an indexed mesh instead of running the transform feedback stages. */
+const unsigned int cpu_marching_cubes_threads   = 4;     /**< Amount of threads used by the CPU implementation.                                                  */
+const char*        cpu_mesh_export_path         = NULL;  /**< If not NULL, the CPU mesh at time 0.0 is written to this path as an OBJ file during setup.       */
+const unsigned int cpu_timing_report_interval   = 100;   /**< Amount of frames between reports of average CPU triangulation time.                               */
+
+/** CPU implementation of the Marching Cubes stages. Created in setupGraphics(). */
+MarchingCubesCPU*  cpu_marching_cubes           = NULL;
+/** Mesh produced by cpu_marching_cubes, reused between frames to avoid reallocations. */
+MarchingCubesMesh  cpu_mesh;
+/** Accumulated CPU triangulation time since the last report (in seconds). */
+float              cpu_triangulation_time       = 0.0f;
+/** Amount of frames accumulated in cpu_triangulation_time. */
+unsigned int       cpu_triangulation_frames     = 0;
+
 /** Amount of spheres defining scalar field. This value should be synchronized between all files. */
 const int n_spheres = 3;
 
@@ -1213,6 +1266,26 @@ GLuint        marching_cubes_triangles_lookup_table_texture_id           = 0;
 GLuint        marching_cubes_triangles_vao_id                            = 0;
 
 
+/* 5. CPU Marching Cubes mesh rendering variable data. */
+/** Program object id for rendering the CPU generated mesh. */
+GLuint        cpu_mesh_program_id                                        = 0;
+/** Vertex shader id for rendering the CPU generated mesh. */
+GLuint        cpu_mesh_vert_shader_id                                    = 0;
+/** Fragment shader id for rendering the CPU generated mesh. */
+GLuint        cpu_mesh_frag_shader_id                                    = 0;
+
+/** Location of time uniform. */
+GLint         cpu_mesh_uniform_time_id                                   = 0;
+/** Location of mvp uniform. */
+GLint         cpu_mesh_uniform_mvp_id                                    = 0;
+
+/** Buffer object ids for vertex positions, normals and triangle indices of the CPU generated mesh. */
+GLuint        cpu_mesh_buffer_object_ids[3]                              = { 0, 0, 0 };
+
+/** Id of vertex array object used for the CPU generated mesh. */
+GLuint        cpu_mesh_vao_id                                            = 0;
+
+
 /** Calculates combined model view and projection matrix.
  *
  *  @param mvp combined mvp matrix
@@ -1248,6 +1321,151 @@ void calc_mvp(Matrix& mvp)
 }
 
 
+/** Calculates sphere positions on the CPU for the specified time moment.
+ *  Uses the same sphere descriptors and Lissajou equations as spheres_updater_vert_shader.
+ *
+ *  @param time             time moment
+ *  @param sphere_positions receives n_spheres * n_sphere_position_components floats (xyz position and weight in w)
+ */
+void calc_sphere_positions(float time, GLfloat* sphere_positions)
+{
+    /*                                   (---- center ----)  (--- amplitude --)  (--- frequency ---)  (----- phase -----)  (weight) */
+    const float spheres[n_spheres][13] = {{0.50f, 0.50f, 0.50f, 0.20f, 0.25f, 0.25f, 11.0f, 21.0f, 31.0f, 30.0f, 45.0f,  90.0f, 0.100f},
+                                          {0.50f, 0.50f, 0.50f, 0.25f, 0.20f, 0.25f, 22.0f, 32.0f, 12.0f, 45.0f, 90.0f, 120.0f, 0.050f},
+                                          {0.50f, 0.50f, 0.50f, 0.25f, 0.25f, 0.20f, 33.0f, 13.0f, 23.0f, 90.0f, 120.0f, 150.0f, 0.250f}};
+    const float degrees_to_radians = atanf(1) / 45;
+
+    for (int sphere = 0; sphere < n_spheres; sphere++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            sphere_positions[sphere * n_sphere_position_components + axis] = spheres[sphere][axis]
+                                                                           + spheres[sphere][3 + axis]
+                                                                           * sinf(degrees_to_radians * spheres[sphere][6 + axis] * time + degrees_to_radians * spheres[sphere][9 + axis]);
+        }
+
+        sphere_positions[sphere * n_sphere_position_components + 3] = spheres[sphere][12];
+    }
+}
+
+/** Runs the CPU Marching Cubes implementation for the specified time moment.
+ *
+ *  @param time time moment
+ */
+void triangulate_on_cpu(float time)
+{
+    GLfloat sphere_positions[n_spheres * n_sphere_position_components];
+
+    calc_sphere_positions(time, sphere_positions);
+
+    cpu_marching_cubes->calculateScalarField(sphere_positions, n_spheres);
+    cpu_marching_cubes->polygonise(isosurface_level, &cpu_mesh);
+}
+
+/** Creates the program and buffers used to render the CPU generated mesh. */
+void setup_cpu_marching_cubes()
+{
+    cpu_marching_cubes = new MarchingCubesCPU(tri_table, samples_per_axis, cpu_marching_cubes_threads);
+
+    /* Golden mesh: time 0.0 makes the output independent of the wall clock. */
+    if (cpu_mesh_export_path != NULL)
+    {
+        triangulate_on_cpu(0.0f);
+
+        if (cpu_mesh.exportOBJ(cpu_mesh_export_path))
+        {
+            LOGI("Exported CPU Marching Cubes mesh (%u vertices, %u triangles) to %s\n", cpu_mesh.getNumberOfVertices(), cpu_mesh.getNumberOfTriangles(), cpu_mesh_export_path);
+        }
+        else
+        {
+            LOGE("Could not export CPU Marching Cubes mesh to %s\n", cpu_mesh_export_path);
+        }
+    }
+
+    if (!use_cpu_marching_cubes)
+    {
+        return;
+    }
+
+    cpu_mesh_program_id = GL_CHECK(glCreateProgram());
+
+    /* The fragment stage is shared with the GPU path. */
+    Shader::processShader(&cpu_mesh_vert_shader_id, cpu_mesh_vert_shader,                 GL_VERTEX_SHADER  );
+    Shader::processShader(&cpu_mesh_frag_shader_id, marching_cubes_triangles_frag_shader, GL_FRAGMENT_SHADER);
+
+    GL_CHECK(glAttachShader(cpu_mesh_program_id, cpu_mesh_vert_shader_id));
+    GL_CHECK(glAttachShader(cpu_mesh_program_id, cpu_mesh_frag_shader_id));
+    GL_CHECK(glBindAttribLocation(cpu_mesh_program_id, 0, "vertex_position"));
+    GL_CHECK(glBindAttribLocation(cpu_mesh_program_id, 1, "vertex_normal"  ));
+    GL_CHECK(glLinkProgram(cpu_mesh_program_id));
+
+    cpu_mesh_uniform_time_id = GL_CHECK(glGetUniformLocation(cpu_mesh_program_id, "time"));
+    cpu_mesh_uniform_mvp_id  = GL_CHECK(glGetUniformLocation(cpu_mesh_program_id, "mvp" ));
+
+    GL_CHECK(glUseProgram(cpu_mesh_program_id));
+    GL_CHECK(glUniformMatrix4fv(cpu_mesh_uniform_mvp_id, 1, GL_FALSE, mvp.getAsArray()));
+
+    GL_CHECK(glGenBuffers     (3, cpu_mesh_buffer_object_ids));
+    GL_CHECK(glGenVertexArrays(1, &cpu_mesh_vao_id          ));
+
+    GL_CHECK(glBindVertexArray(cpu_mesh_vao_id));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, cpu_mesh_buffer_object_ids[0]));
+    GL_CHECK(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, NULL));
+    GL_CHECK(glEnableVertexAttribArray(0));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, cpu_mesh_buffer_object_ids[1]));
+    GL_CHECK(glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, NULL));
+    GL_CHECK(glEnableVertexAttribArray(1));
+    GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cpu_mesh_buffer_object_ids[2]));
+    GL_CHECK(glBindVertexArray(0));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+}
+
+/** Triangulates the scalar field on the CPU and renders the resulting indexed mesh. */
+void render_cpu_marching_cubes()
+{
+    float start_time = timer.getTime();
+
+    triangulate_on_cpu(model_time);
+
+    cpu_triangulation_time += timer.getTime() - start_time;
+    cpu_triangulation_frames++;
+
+    if (cpu_triangulation_frames == cpu_timing_report_interval)
+    {
+        LOGI("CPU Marching Cubes: %.3f ms per frame (%u vertices, %u triangles, %u threads)\n",
+             1000.0f * cpu_triangulation_time / cpu_triangulation_frames,
+             cpu_mesh.getNumberOfVertices(),
+             cpu_mesh.getNumberOfTriangles(),
+             cpu_marching_cubes_threads);
+
+        cpu_triangulation_time   = 0.0f;
+        cpu_triangulation_frames = 0;
+    }
+
+    if (cpu_mesh.indices.empty())
+    {
+        return;
+    }
+
+    /* Orphan and refill the buffers, the mesh changes every frame. */
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, cpu_mesh_buffer_object_ids[0]));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER, cpu_mesh.positions.size() * sizeof(GLfloat), &cpu_mesh.positions[0], GL_STREAM_DRAW));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, cpu_mesh_buffer_object_ids[1]));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER, cpu_mesh.normals.size() * sizeof(GLfloat), &cpu_mesh.normals[0], GL_STREAM_DRAW));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+
+    GL_CHECK(glUseProgram(cpu_mesh_program_id));
+    GL_CHECK(glUniform1f(cpu_mesh_uniform_time_id, model_time));
+
+    GL_CHECK(glBindVertexArray(cpu_mesh_vao_id));
+    GL_CHECK(glBufferData(GL_ELEMENT_ARRAY_BUFFER, cpu_mesh.indices.size() * sizeof(GLuint), &cpu_mesh.indices[0], GL_STREAM_DRAW));
+    GL_CHECK(glDrawElements(GL_TRIANGLES, (GLsizei)cpu_mesh.indices.size(), GL_UNSIGNED_INT, NULL));
+
+    /* Restore the vertex array object used by the GPU path. */
+    GL_CHECK(glBindVertexArray(marching_cubes_triangles_vao_id));
+}
+
+
 /** Initialises OpenGL ES and model environments.
  *
  *  @param width  window width reported by operating system
@@ -1528,6 +1746,9 @@ void setupGraphics(int width, int height)
     GL_CHECK(glEnable   (GL_CULL_FACE ));
     GL_CHECK(glFrontFace(GL_CW        ));
 
+    /* 5. CPU Marching Cubes reference path. */
+    setup_cpu_marching_cubes();
+
     /* Start counting time. */
     timer.reset();
 }
@@ -1544,6 +1765,13 @@ void renderFrame(void)
     /* Clear the buffers that we are going to render to in a moment. */
     GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
 
+    /* All four stages can alternatively be executed on the CPU. */
+    if (use_cpu_marching_cubes)
+    {
+        render_cpu_marching_cubes();
+        return;
+    }
+
     /* [Stage 1 Calculate sphere positions stage] */
     /* 1. Calculate sphere positions stage.
      *
@@ -1718,6 +1946,18 @@ void renderFrame(void)
 /** Deinitialises OpenGL ES environment. */
 void cleanup()
 {
+    if (use_cpu_marching_cubes)
+    {
+        GL_CHECK(glDeleteVertexArrays(1, &cpu_mesh_vao_id           ));
+        GL_CHECK(glDeleteBuffers     (3, cpu_mesh_buffer_object_ids ));
+        GL_CHECK(glDeleteShader      (    cpu_mesh_frag_shader_id   ));
+        GL_CHECK(glDeleteShader      (    cpu_mesh_vert_shader_id   ));
+        GL_CHECK(glDeleteProgram     (    cpu_mesh_program_id       ));
+    }
+
+    delete cpu_marching_cubes;
+    cpu_marching_cubes = NULL;
+
     GL_CHECK(glDeleteVertexArrays      (1, &marching_cubes_triangles_vao_id                  ));
     GL_CHECK(glDeleteShader            (    marching_cubes_triangles_frag_shader_id          ));
     GL_CHECK(glDeleteShader            (    marching_cubes_triangles_vert_shader_id          ));
@@ -1743,6 +1983,7 @@ void cleanup()
 }
 
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_metaballs_NativeLibrary_init
@@ -1755,6 +1996,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_metaballs_NativeLibrary_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         /* Render a frame */
         renderFrame();
     }
@@ -1765,3 +2007,7 @@ extern "C"
         cleanup();
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Metaballs", setupGraphics, renderFrame)
@@ -24,17 +24,11 @@
 #include <GLES3/gl3.h>
 #include <cstdio>
 #include <cstdlib>
+#if defined(ANDROID)
 #include <android/log.h>
+#endif
 
-#define GL_CHECK(x) \
-    x; \
-    { \
-        GLenum glError = glGetError(); \
-        if(glError != GL_NO_ERROR) { \
-            LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1); \
-        } \
-    }
+#include "GLCheck.h"
 
 namespace MaliSDK
 {
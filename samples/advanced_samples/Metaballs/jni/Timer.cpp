@@ -51,6 +51,8 @@ namespace MaliSDK
 }
 #else
 
+#include "Benchmark.h"
+
 #include <sys/time.h>
 
 namespace MaliSDK
@@ -69,12 +71,12 @@ namespace MaliSDK
 
     void Timer::reset()
     {
-        gettimeofday(&startTime, NULL);
+        Benchmark::getTimeOfDay(&startTime);
     }
 
     float Timer::getTime()
     {
-        gettimeofday(&currentTime, NULL);
+        Benchmark::getTimeOfDay(&currentTime);
         float seconds = (currentTime.tv_sec - startTime.tv_sec);
         float milliseconds = (float(currentTime.tv_usec - startTime.tv_usec)) / 1000000.0f;
         return seconds + milliseconds;
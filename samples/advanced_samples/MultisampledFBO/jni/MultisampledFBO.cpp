@@ -77,16 +77,20 @@
 #include <sstream>
 #include <math.h>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "MultisampledFBO.h"
 #include "Teapot.h"
 
 #include "Text.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
 #include "Shader.h"
 #include "Matrix.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 /* OpenGL ES extension functions. */
 PFNGLFRAMEBUFFERTEXTURE2DMULTISAMPLEIMGPROC glFramebufferTexture2DMultisampleEXT = NULL;
@@ -97,7 +101,11 @@ using std::ostringstream;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 const string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.multisampledfbo/";
+#else
+const string resourceDirectory = ASSET_DIRECTORY;
+#endif
 const string teapotVertexShaderFilename = "MultisampledFBO_teapot.vert";
 const string teapotFragmentShaderFilename = "MultisampledFBO_teapot.frag";
 string quadVertexShaderFilename = "MultisampledFBO_quad.vert";
@@ -631,6 +639,7 @@ void renderFrame(void)
 	GL_CHECK(glDisable(GL_BLEND));
 }
 
+#if defined(ANDROID)
 extern "C"
 {
 	JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_multisampledfbo_MultisampledFBO_init
@@ -648,6 +657,7 @@ extern "C"
 	JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_multisampledfbo_MultisampledFBO_step
 	(JNIEnv *env, jclass jcls)
 	{
+		MaliSDK::ProfileFrame profileFrame;
 		renderFrame();
 	}
 
@@ -754,3 +764,7 @@ extern "C"
 		GL_CHECK(glDeleteFramebuffers(1, &frameBufferMSAA));
 	}
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("MultisampledFBO", setupGraphics, renderFrame)
@@ -46,6 +46,7 @@ layout(binding = 0, std140) uniform UBO
     mat4 uView; // View
     vec4 uProj[4]; // Projection matrix
     vec4 uFrustum[6]; // Frustum planes for frustum test
+    vec4 uLODDistance; // Distance, in sphere radii, from which each LOD is detailed enough.
     vec2 zNearFar; // NearFar values for near plane intersection test.
 };
 
@@ -92,20 +93,20 @@ layout(std430, binding = 4) buffer PerInstanceOutputLOD3
     writeonly vec4 data[];
 } output_instance_lod3;
 
-void append_instance(float minz)
+void append_instance(float distance)
 {
-    // Test non-linear depth value and place the instance in the appropriate instance buffer.
-    if (minz < 0.8)
+    // Pick the coarsest LOD whose simplification error still projects to less than the allowed number of pixels.
+    if (distance < uLODDistance.y)
     {
         uint count = atomicCounterIncrement(instanceCountLOD0);
         output_instance_lod0.data[count] = input_instance.data[gl_GlobalInvocationID.x].position;
     }
-    else if (minz < 0.9)
+    else if (distance < uLODDistance.z)
     {
         uint count = atomicCounterIncrement(instanceCountLOD1);
         output_instance_lod1.data[count] = input_instance.data[gl_GlobalInvocationID.x].position;
     }
-    else if (minz < 0.95)
+    else if (distance < uLODDistance.w)
     {
         uint count = atomicCounterIncrement(instanceCountLOD2);
         output_instance_lod2.data[count] = input_instance.data[gl_GlobalInvocationID.x].position;
@@ -147,6 +148,9 @@ void main()
     vec3 view_center = (uView * vec4(center, 1.0)).xyz;
     float nearest_z = view_center.z + radius;
 
+    // The sphere mesh has unit radius, so LOD errors scale with the radius of the instance.
+    float lod_distance = -view_center.z / radius;
+
     // Sphere clips against near plane, just assume visibility.
     if (nearest_z >= -zNearFar.x)
     {
@@ -203,6 +207,6 @@ void main()
 
     // Test visibility.
     if (textureLod(uDepth, vec3(mid_pix, nearest_z), lod) > 0.0)
-        append_instance(nearest_z);
+        append_instance(lod_distance);
 }
 
@@ -35,6 +35,7 @@ layout(binding = 0, std140) uniform UBO
     mat4 uView;
     vec4 uProj[4];
     vec4 uFrustum[6];
+    vec4 uLODDistance;
     vec2 zNearFar;
 };
 
@@ -48,6 +48,9 @@ class CullingInterface
         // Sets current view and projection matrices.
         virtual void set_view_projection(const mat4 &projection, const mat4& view, const vec2 &zNearFar) = 0;
 
+        // Sets the distances, in multiples of the instance radius, from which LOD 1 to 3 may be used.
+        virtual void set_lod_distances(const vec4 &distances) = 0;
+
         // Rasterize occluders to depth map.
         virtual void rasterize_occluders() = 0;
 
@@ -77,6 +80,7 @@ class HiZCulling : public CullingInterface
 
         void setup_occluder_geometry(const std::vector<vec4> &positions, const std::vector<uint32_t> &indices);
         void set_view_projection(const mat4 &projection, const mat4 &view, const vec2 &zNearFar);
+        void set_lod_distances(const vec4 &distances);
 
         void rasterize_occluders();
         void test_bounding_boxes(GLuint counter_buffer, const unsigned *counter_offsets, unsigned num_offsets,
@@ -112,6 +116,7 @@ class HiZCulling : public CullingInterface
             mat4 uView;
             mat4 uProj;
             vec4 planes[6];
+            vec4 uLODDistance;
             vec2 zNearFar;
         };
         Uniforms uniforms;
@@ -19,6 +19,7 @@
  */
 
 #include "culling.hpp"
+#include "GLStateCache.h"
 #include <string.h>
 
 using namespace std;
@@ -178,6 +179,8 @@ void HiZCulling::rasterize_occluders()
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, depth_texture));
     GL_CHECK(glUseProgram(depth_mip_program));
 
+    MaliSDK::GLStateCache *state_cache = MaliSDK::GLStateCache::getInstance();
+
     for (unsigned lod = 1; lod < lod_levels; lod++)
     {
         GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, framebuffers[lod]));
@@ -186,16 +189,15 @@ void HiZCulling::rasterize_occluders()
 
         // Need to do this to ensure that we cannot possibly read from the miplevel we are rendering to.
         // Otherwise, we have undefined behavior.
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, lod - 1));
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, lod - 1));
+        // The level range is cached per texture, so only the parameter that actually changes is set.
+        state_cache->setTextureLevels(GL_TEXTURE_2D, depth_texture, lod - 1, lod - 1);
 
         // Mipmap.
         GL_CHECK(glDrawElements(GL_TRIANGLES, quad.get_num_elements(), GL_UNSIGNED_SHORT, 0));
     }
 
     // Restore miplevels. MAX_LEVEL will be clamped accordingly.
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0));
-    GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000));
+    state_cache->setTextureLevels(GL_TEXTURE_2D, depth_texture, 0, 1000);
     GL_CHECK(glBindFramebuffer(GL_FRAMEBUFFER, 0));
 }
 
@@ -213,9 +215,14 @@ void HiZCulling::set_view_projection(const mat4 &projection, const mat4 &view, c
     compute_frustum_from_view_projection(uniforms.planes, view_projection);
 }
 
+void HiZCulling::set_lod_distances(const vec4 &distances)
+{
+    uniforms.uLODDistance = distances;
+}
+
 HiZCulling::~HiZCulling()
 {
-    GL_CHECK(glDeleteTextures(1, &depth_texture));
+    MaliSDK::GLStateCache::getInstance()->deleteTextures(1, &depth_texture);
     GL_CHECK(glDeleteProgram(depth_render_program));
     GL_CHECK(glDeleteProgram(depth_mip_program));
     GL_CHECK(glDeleteProgram(culling_program));
@@ -19,6 +19,8 @@
  */
 
 #include "mesh.hpp"
+#include "MeshSimplifier.h"
+#include <algorithm>
 #include <utility>
 using namespace std;
 
@@ -203,6 +205,55 @@ Mesh create_sphere_mesh(float radius, vec3 center, unsigned vertices_per_circumf
     return mesh;
 }
 
+vector<Mesh> create_lod_meshes(const Mesh &mesh, unsigned num_lods, float *lod_errors)
+{
+    MaliSDK::IndexedMesh source;
+    for (unsigned i = 0; i < mesh.vbo.size(); i++)
+    {
+        const Vertex &vertex = mesh.vbo[i];
+        MaliSDK::Vec3f position = { vertex.position.c.x, vertex.position.c.y, vertex.position.c.z };
+        MaliSDK::Vec3f normal = { vertex.normal.c.x, vertex.normal.c.y, vertex.normal.c.z };
+        MaliSDK::Vec2f tex = { vertex.tex.c.x, vertex.tex.c.y };
+        source.addVertex(position, normal, tex);
+    }
+    for (unsigned i = 0; i + 2 < mesh.ibo.size(); i += 3)
+    {
+        source.addTriangle(mesh.ibo[i], mesh.ibo[i + 1], mesh.ibo[i + 2]);
+    }
+
+    MaliSDK::IndexedMesh *lods = MaliSDK::MeshSimplifier::createLevelsOfDetail(source, num_lods);
+    const vector<float> &positions = lods->getPositions();
+    const vector<float> &normals = lods->getNormals();
+    const vector<float> &tex = lods->getUVs();
+    const vector<unsigned> &indices = lods->getIndices();
+
+    // All LODs index into the same vertices. If the mesh could not be simplified that far, the coarsest LOD is repeated.
+    // Vertices are numbered starting from the coarsest LOD, so each LOD only needs the vertices up to its highest index.
+    vector<Mesh> meshes(num_lods);
+    for (unsigned lod = 0; lod < num_lods; lod++)
+    {
+        MaliSDK::IndexedMesh::LevelOfDetail level = lods->getLevel(lod);
+
+        meshes[lod].ibo.assign(indices.begin() + level.firstIndex, indices.begin() + level.firstIndex + level.numberOfIndices);
+
+        unsigned num_vertices = 0;
+        for (unsigned i = 0; i < meshes[lod].ibo.size(); i++)
+        {
+            num_vertices = max(num_vertices, unsigned(meshes[lod].ibo[i]) + 1);
+        }
+
+        for (unsigned i = 0; i < num_vertices; i++)
+        {
+            meshes[lod].vbo.push_back(Vertex(vec3(&positions[3 * i]), vec3(&normals[3 * i]), vec2(&tex[2 * i])));
+        }
+        meshes[lod].aabb = mesh.aabb;
+        lod_errors[lod] = level.error;
+    }
+
+    delete lods;
+    return meshes;
+}
+
 Mesh create_box_mesh(const AABB &aabb)
 {
     static const Vertex vertex_data[] = {
@@ -52,6 +52,9 @@ struct Mesh
 Mesh create_box_mesh(const AABB &aabb);
 Mesh create_sphere_mesh(float radius, vec3 center, unsigned vertices_per_circumference);
 
+// Simplifies mesh into num_lods meshes of halving triangle counts. lod_errors receives the largest deviation of each from mesh.
+std::vector<Mesh> create_lod_meshes(const Mesh &mesh, unsigned num_lods, float *lod_errors);
+
 class GLDrawable
 {
     public:
@@ -26,6 +26,7 @@
 #define GLES_VERSION 3
 #include "Timer.h"
 #include "Text.h"
+#include "Profiler.h"
 
 using namespace std;
 
@@ -82,6 +83,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_occlusionculling_OcclusionCulling_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         float delta_time = timer.getInterval();
 
         // Render scene.
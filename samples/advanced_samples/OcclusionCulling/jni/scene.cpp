@@ -35,24 +35,17 @@ using namespace std;
 
 #define SPHERE_RADIUS 0.30f
 
-// Defines how densely spheres should be tesselated (offline) at each LOD level.
-#define SPHERE_VERT_PER_CIRC_LOD0 24
-#define SPHERE_VERT_PER_CIRC_LOD1 20
-#define SPHERE_VERT_PER_CIRC_LOD2 16
-#define SPHERE_VERT_PER_CIRC_LOD3 12
+// Defines how densely spheres are tesselated at LOD 0. The other LOD levels are simplified from it.
+#define SPHERE_VERT_PER_CIRC 24
+
+// Largest error, in pixels, a LOD level may show on screen.
+#define SPHERE_LOD_MAX_SCREEN_ERROR 1.0f
 
 // We use fixed uniform locations in the shaders (GLES 3.1 feature).
 #define UNIFORM_MVP_LOCATION 0
 #define UNIFORM_COLOR_LOCATION 1
 #define UNIFORM_LIGHT_DIR_LOCATION 2
 
-static const unsigned verts_per_circ[] = {
-    SPHERE_VERT_PER_CIRC_LOD0,
-    SPHERE_VERT_PER_CIRC_LOD1,
-    SPHERE_VERT_PER_CIRC_LOD2,
-    SPHERE_VERT_PER_CIRC_LOD3,
-};
-
 Scene::Scene()
 {
     // Compile shaders.
@@ -143,9 +136,11 @@ void Scene::init_instances()
     box = new GLDrawable(box_mesh);
 
     // Create meshes for spheres at various LOD levels.
+    vector<Mesh> sphere_meshes = create_lod_meshes(create_sphere_mesh(1.0f, vec3(0, 0, 0), SPHERE_VERT_PER_CIRC),
+            SPHERE_LODS, sphere_lod_error);
     for (unsigned i = 0; i < SPHERE_LODS; i++)
     {
-        sphere[i] = new GLDrawable(create_sphere_mesh(1.0f, vec3(0, 0, 0), verts_per_circ[i]));
+        sphere[i] = new GLDrawable(sphere_meshes[i]);
     }
 
     // Spread occluder geometry out on a grid on the XZ plane.
@@ -228,6 +223,7 @@ void Scene::init_instances()
 
 #define Z_NEAR 1.0f
 #define Z_FAR 500.0f
+#define FOV_Y 60.0f
 void Scene::update_camera(float rotation_y, float rotation_x, unsigned viewport_width, unsigned viewport_height)
 {
     // Compute view and projection matrices.
@@ -241,9 +237,16 @@ void Scene::update_camera(float rotation_y, float rotation_x, unsigned viewport_
     vec3 camera_position = vec3(0, 2, 0);
 
     view = mat_look_at(camera_position, camera_position + camera_dir, vec3(0, 1, 0));
-    projection = mat_perspective_fov(60.0f, float(viewport_width) / viewport_height, Z_NEAR, Z_FAR);
+    projection = mat_perspective_fov(FOV_Y, float(viewport_width) / viewport_height, Z_NEAR, Z_FAR);
     mat4 view_projection = projection * view;
 
+    // A LOD level may be used once its error, scaled by distance, projects to less than the allowed number of pixels.
+    float projection_scale = 0.5f * viewport_height / tanf(FOV_Y * PI / 360.0f);
+    for (unsigned i = 0; i < SPHERE_LODS; i++)
+    {
+        sphere_lod_distance.data[i] = sphere_lod_error[i] * projection_scale / SPHERE_LOD_MAX_SCREEN_ERROR;
+    }
+
     GL_CHECK(glProgramUniformMatrix4fv(occluder_program, UNIFORM_MVP_LOCATION, 1, GL_FALSE, value_ptr(view_projection)));
     GL_CHECK(glProgramUniformMatrix4fv(sphere_program, UNIFORM_MVP_LOCATION, 1, GL_FALSE, value_ptr(view_projection)));
 }
@@ -299,6 +302,7 @@ void Scene::update(float delta_time, unsigned width, unsigned height)
 
         // Rasterize occluders to depth map and mipmap it.
         culler->set_view_projection(projection, view, vec2(Z_NEAR, Z_FAR));
+        culler->set_lod_distances(sphere_lod_distance);
         culler->rasterize_occluders();
 
         // We need physics results after this.
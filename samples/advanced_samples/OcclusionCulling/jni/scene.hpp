@@ -51,6 +51,8 @@ class Scene
     private:
         GLDrawable *box;
         GLDrawable *sphere[SPHERE_LODS];
+        float sphere_lod_error[SPHERE_LODS];
+        vec4 sphere_lod_distance;
         std::vector<CullingInterface*> culling_implementations;
 
         unsigned culling_implementation_index;
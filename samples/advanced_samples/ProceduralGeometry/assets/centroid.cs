@@ -22,7 +22,7 @@
 
 precision highp float;
 precision highp image3D;
-layout (local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 2) in;
 layout (binding = 0, r32f) uniform readonly image3D inSurface;
 layout (binding = 1, rgba8) uniform writeonly image3D outCentroid;
 
@@ -31,11 +31,24 @@ layout (binding = 3, std430) buffer IndexBuffer {
     uint outIndices[];
 };
 
+// One work group is dispatched per resident brick, see classify.cs
+layout (binding = 1, std430) readonly buffer BrickList {
+    uint inBricks[];
+};
+
 uniform float voxel_mode;
+uniform int dimension;
+uniform ivec3 pool_size;
+
+// Must match BRICK_SIZE in geometry.cpp
+#define BRICK_SIZE 8
+#define BRICK_SAMPLES (BRICK_SIZE + 1)
 
+// texel: the cell's first corner in the surface brick pool
+//  cell: the cell's position in the full grid
 // return: offset (x, y, z) in the local cell
 //    and: if the cell was on the surface (w)
-vec4 ComputeCentroid(ivec3 texel)
+vec4 ComputeCentroid(ivec3 texel, ivec3 cell)
 {
     // Load the isovalue at each corner of the cube
     float val[8] = float[8](
@@ -170,9 +183,8 @@ vec4 ComputeCentroid(ivec3 texel)
 
     // Finally, since we were on the surface, we write out this
     // cell's index to the index buffer.
-    ivec3 size = imageSize(outCentroid);
     uint unique = atomicCounterIncrement(outCount);
-    int index = texel.z * size.x * size.y + texel.y * size.x + texel.x;
+    int index = cell.z * dimension * dimension + cell.y * dimension + cell.x;
     outIndices[unique] = uint(index);
 
     return vec4(offset, 1.0);
@@ -180,11 +192,26 @@ vec4 ComputeCentroid(ivec3 texel)
 
 void main()
 {
-    ivec3 texel = ivec3(gl_GlobalInvocationID.xyz);
-    vec4 v = ComputeCentroid(texel);
+    uint slot = gl_WorkGroupID.x;
+    if (slot >= uint(pool_size.x * pool_size.y * pool_size.z))
+        return;
+
+    uint code = inBricks[slot];
+    ivec3 brick = ivec3(code & 0x3ffu, (code >> 10) & 0x3ffu, code >> 20);
+    int pool_index = int(slot);
+    ivec3 pool = ivec3(pool_index % pool_size.x,
+                       (pool_index / pool_size.x) % pool_size.y,
+                       pool_index / (pool_size.x * pool_size.y));
+
+    for (int z = 0; z < BRICK_SIZE; z += int(gl_WorkGroupSize.z))
+    {
+        ivec3 local = ivec3(gl_LocalInvocationID.xyz) + ivec3(0, 0, z);
+        vec4 v = ComputeCentroid(pool * BRICK_SAMPLES + local,
+                                 brick * BRICK_SIZE + local);
 
-    // Remap to fit into 8-bit
-    vec3 offset = vec3(0.5) + 0.5 * v.xyz;
+        // Remap to fit into 8-bit
+        vec3 offset = vec3(0.5) + 0.5 * v.xyz;
 
-    imageStore(outCentroid, texel, vec4(offset, v.w));
+        imageStore(outCentroid, pool * BRICK_SIZE + local, vec4(offset, v.w));
+    }
 }
@@ -0,0 +1,153 @@
+#version 310 es
+
+/* Copyright (c) 2015-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+// Decides which 8x8x8 bricks of the cell grid may contain the isosurface.
+// Instead of sampling the field, we evaluate the Scene function from
+// generate.cs over each brick's bounding box using interval arithmetic.
+// The resulting range is conservative, so a brick whose range does not
+// contain zero can never produce a surface cell and is skipped by the
+// generate and centroid passes.
+
+precision highp float;
+precision highp uimage3D;
+layout (local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+layout (binding = 0, r32ui) writeonly uniform uimage3D outBrickTable;
+
+layout (binding = 0) uniform atomic_uint outBrickCount;
+layout (binding = 1, std430) writeonly buffer BrickList {
+    uint outBricks[];
+};
+
+uniform vec3 sphere_pos;
+uniform float sphere_radius;
+uniform int dimension;
+uniform float time;
+uniform uint capacity;
+
+// Must match BRICK_SIZE in geometry.cpp
+#define BRICK_SIZE 8
+#define INVALID_BRICK 0xffffffffu
+
+// Upper bound on |snoise(x)|, with some slack for rounding
+#define NOISE_BOUND 1.1
+
+// An interval is stored as vec2(min, max)
+vec2 ISquare(vec2 a)
+{
+    if (a.x >= 0.0) return a * a;
+    if (a.y <= 0.0) return vec2(a.y * a.y, a.x * a.x);
+    return vec2(0.0, max(a.x * a.x, a.y * a.y));
+}
+
+vec2 IMin(vec2 a, vec2 b)
+{
+    return vec2(min(a.x, b.x), min(a.y, b.y));
+}
+
+vec2 IHull(vec2 a, vec2 b)
+{
+    return vec2(min(a.x, b.x), max(a.y, b.y));
+}
+
+// Range of mod(x, m) over x in [a.x, a.y]. If the interval
+// straddles a wrap point, the whole period can be reached.
+vec2 IMod(vec2 a, float m)
+{
+    float k = floor(a.x / m);
+    if (floor(a.y / m) != k)
+        return vec2(0.0, m);
+    return a - k * m;
+}
+
+// Range of Sphere(q, r2) with q in the box [lo, hi]
+vec2 ISphere(vec3 lo, vec3 hi, float r2)
+{
+    vec2 d = ISquare(vec2(lo.x, hi.x)) +
+             ISquare(vec2(lo.y, hi.y)) +
+             ISquare(vec2(lo.z, hi.z));
+    return d - vec2(r2);
+}
+
+vec2 IWeirdFloor(vec3 lo, vec3 hi)
+{
+    vec2 f = vec2(lo.y, hi.y);
+    if (lo.y < 0.1 && hi.y > -0.1)
+        f += vec2(-0.4, 0.4) * NOISE_BOUND;
+    return f;
+}
+
+vec2 ICloud(vec3 lo, vec3 hi, vec3 center)
+{
+    vec3 shift = -center + vec3(0.03, 0.0, 0.02) * time;
+    vec2 qx = IMod(vec2(lo.x, hi.x) + shift.x + 1.0, 2.0) - 1.0;
+    vec2 qy = vec2(lo.y, hi.y) + shift.y;
+    vec2 qz = IMod(vec2(lo.z, hi.z) + shift.z + 1.5, 3.0) - 1.5;
+    qy *= 4.0;
+    qx *= 1.5;
+    qz *= 1.5;
+    vec2 f = ISphere(vec3(qx.x, qy.x, qz.x), vec3(qx.y, qy.y, qz.y), 0.3*0.3);
+    return f + vec2(-0.2, 0.2) * NOISE_BOUND;
+}
+
+vec2 IScene(vec3 lo, vec3 hi)
+{
+    vec2 f = IWeirdFloor(lo, hi);
+    if (hi.y > 0.5)
+    {
+        vec2 c = f;
+        c = IMin(c, ICloud(lo, hi, vec3(0.5, 0.7, -0.3)));
+        c = IMin(c, ICloud(lo, hi, vec3(-0.5, 0.7, 0.7)));
+
+        // Points below y = 0.5 do not see the clouds
+        f = lo.y > 0.5 ? c : IHull(f, c);
+    }
+    vec2 s = ISphere(lo - sphere_pos, hi - sphere_pos, sphere_radius);
+    f = max(f, -s.yx);
+    return f;
+}
+
+void main()
+{
+    ivec3 brick = ivec3(gl_GlobalInvocationID.xyz);
+    int bricks_per_axis = dimension / BRICK_SIZE;
+    if (any(greaterThanEqual(brick, ivec3(bricks_per_axis))))
+        return;
+
+    // The cells of a brick read the samples [0, BRICK_SIZE] along
+    // each axis, i.e. including the first sample of the next brick.
+    vec3 lo = vec3(-1.0) + 2.0 * vec3(brick * BRICK_SIZE) / float(dimension - 1);
+    vec3 hi = vec3(-1.0) + 2.0 * vec3(brick * BRICK_SIZE + BRICK_SIZE) / float(dimension - 1);
+    vec2 f = IScene(lo, hi);
+
+    // A cell is on the surface if some corners are below zero
+    // and some are not, which requires min < 0 <= max.
+    uint slot = INVALID_BRICK;
+    if (f.x < 0.0 && f.y >= 0.0)
+    {
+        slot = atomicCounterIncrement(outBrickCount);
+        if (slot < capacity)
+            outBricks[slot] = uint(brick.x) | (uint(brick.y) << 10) | (uint(brick.z) << 20);
+        else
+            slot = INVALID_BRICK;
+    }
+    imageStore(outBrickTable, brick, uvec4(slot));
+}
@@ -21,13 +21,23 @@
  */
 
 precision highp float;
-layout (local_size_x = 4, local_size_y = 4, local_size_z = 4) in;
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 2) in;
 layout (binding = 0, r32f) writeonly highp uniform image3D outSurface;
 
+// One work group is dispatched per resident brick, see classify.cs
+layout (binding = 1, std430) readonly buffer BrickList {
+    uint inBricks[];
+};
+
 uniform vec3 sphere_pos;
 uniform float sphere_radius;
 uniform int dimension;
 uniform float time;
+uniform ivec3 pool_size;
+
+// Must match BRICK_SIZE in geometry.cpp
+#define BRICK_SIZE 8
+#define BRICK_SAMPLES (BRICK_SIZE + 1)
 
 float snoise(vec3 v);
 
@@ -74,27 +84,41 @@ float Scene(vec3 p)
 
 void main()
 {
-    ivec3 texel = ivec3(gl_GlobalInvocationID.xyz);
-    ivec3 size = imageSize(outSurface);
-
-    // Don't write outside texture
-    // (Needed for this texture, since we invoke more
-    // work units than the size of the texture).
-    if (texel.x >= size.x ||
-        texel.y >= size.y ||
-        texel.z >= size.z)
+    // The classification pass may have found more bricks
+    // than fit in the pool. Those were never given a slot.
+    uint slot = gl_WorkGroupID.x;
+    if (slot >= uint(pool_size.x * pool_size.y * pool_size.z))
         return;
 
-    // Make sure that we sample the correct position in space here!
-    // Let's say our (1D) cell complex has a grid size of N=4, like so:
-    //      | o | o | o | o |
-    //      +---+---+---+---+---> x
-    //     -1  -.5  0  .5   1
-    // The world space position of the centroids are -.75, -.25, .25, and .75.
-    // Each cell must sample its 2 adjacent edges. I.e. the first cell
-    // should sample the function at -1.0 and -0.5.
-    vec3 p = vec3(-1.0) + 2.0 * vec3(texel) / float(dimension - 1);
-    imageStore(outSurface, texel, vec4(Scene(p)));
+    uint code = inBricks[slot];
+    ivec3 brick = ivec3(code & 0x3ffu, (code >> 10) & 0x3ffu, code >> 20);
+    int pool_index = int(slot);
+    ivec3 pool = ivec3(pool_index % pool_size.x,
+                       (pool_index / pool_size.x) % pool_size.y,
+                       pool_index / (pool_size.x * pool_size.y));
+
+    // Each brick stores one more sample than it has cells along
+    // each axis, so that its cells never need to read a neighbour brick.
+    const uint samples = uint(BRICK_SAMPLES * BRICK_SAMPLES * BRICK_SAMPLES);
+    const uint group_size = gl_WorkGroupSize.x * gl_WorkGroupSize.y * gl_WorkGroupSize.z;
+    for (uint i = gl_LocalInvocationIndex; i < samples; i += group_size)
+    {
+        ivec3 local = ivec3(i % uint(BRICK_SAMPLES),
+                            (i / uint(BRICK_SAMPLES)) % uint(BRICK_SAMPLES),
+                            i / uint(BRICK_SAMPLES * BRICK_SAMPLES));
+        ivec3 texel = brick * BRICK_SIZE + local;
+
+        // Make sure that we sample the correct position in space here!
+        // Let's say our (1D) cell complex has a grid size of N=4, like so:
+        //      | o | o | o | o |
+        //      +---+---+---+---+---> x
+        //     -1  -.5  0  .5   1
+        // The world space position of the centroids are -.75, -.25, .25, and .75.
+        // Each cell must sample its 2 adjacent edges. I.e. the first cell
+        // should sample the function at -1.0 and -0.5.
+        vec3 p = vec3(-1.0) + 2.0 * vec3(texel) / float(dimension - 1);
+        imageStore(outSurface, pool * BRICK_SAMPLES + local, vec4(Scene(p)));
+    }
 }
 
 // Description : Array and textureless GLSL 2D/3D/4D simplex
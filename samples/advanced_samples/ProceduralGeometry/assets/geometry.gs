@@ -23,6 +23,7 @@
 #extension GL_EXT_geometry_shader : require
 precision highp float;
 precision highp sampler3D;
+precision highp usampler3D;
 
 layout(points) in;
 layout(triangle_strip, max_vertices = 12) out;
@@ -33,8 +34,44 @@ out vec2 gs_quadcoord;
 out vec3 gs_normal;
 uniform sampler3D inSurface;
 uniform sampler3D inCentroid;
+uniform usampler3D inBricks;
 uniform mat4 projection;
 uniform mat4 view;
+uniform int dimension;
+uniform ivec3 pool_size;
+
+// Must match BRICK_SIZE in geometry.cpp
+#define BRICK_SIZE 8
+#define BRICK_SAMPLES (BRICK_SIZE + 1)
+#define INVALID_BRICK 0xffffffffu
+
+// The surface and centroid volumes only store the bricks that were
+// classified as containing the surface. The brick table maps a brick
+// coordinate to its slot in the pools, or INVALID_BRICK.
+uint LookupBrick(ivec3 texel)
+{
+    if (any(lessThan(texel, ivec3(0))) ||
+        any(greaterThanEqual(texel, ivec3(dimension))))
+        return INVALID_BRICK;
+    return texelFetch(inBricks, texel / BRICK_SIZE, 0).r;
+}
+
+ivec3 PoolOrigin(uint slot)
+{
+    int i = int(slot);
+    return ivec3(i % pool_size.x,
+                 (i / pool_size.x) % pool_size.y,
+                 i / (pool_size.x * pool_size.y));
+}
+
+// Cells in bricks that were skipped are never on the surface
+vec4 FetchCentroid(ivec3 texel)
+{
+    uint slot = LookupBrick(texel);
+    if (slot == INVALID_BRICK)
+        return vec4(0.0);
+    return texelFetch(inCentroid, PoolOrigin(slot) * BRICK_SIZE + texel % BRICK_SIZE, 0);
+}
 
 void EmitQuad(mat4 pv, vec3 v0, vec3 v1, vec3 v2, vec3 v3)
 {
@@ -74,13 +111,13 @@ void main()
     // Sample the centroid offsets and the the surface boolean
     // The offset is stored in the .xyz components, the surface
     // boolean in the .w component.
-    vec4 c_mid          = texelFetch(inCentroid, texel, 0);
-    vec4 c_left         = texelFetch(inCentroid, texel - ivec3(1, 0, 0), 0);
-    vec4 c_bottom       = texelFetch(inCentroid, texel - ivec3(0, 1, 0), 0);
-    vec4 c_back         = texelFetch(inCentroid, texel - ivec3(0, 0, 1), 0);
-    vec4 c_bottom_left  = texelFetch(inCentroid, texel - ivec3(1, 1, 0), 0);
-    vec4 c_back_left    = texelFetch(inCentroid, texel - ivec3(1, 0, 1), 0);
-    vec4 c_bottom_back  = texelFetch(inCentroid, texel - ivec3(0, 1, 1), 0);
+    vec4 c_mid          = FetchCentroid(texel);
+    vec4 c_left         = FetchCentroid(texel - ivec3(1, 0, 0));
+    vec4 c_bottom       = FetchCentroid(texel - ivec3(0, 1, 0));
+    vec4 c_back         = FetchCentroid(texel - ivec3(0, 0, 1));
+    vec4 c_bottom_left  = FetchCentroid(texel - ivec3(1, 1, 0));
+    vec4 c_back_left    = FetchCentroid(texel - ivec3(1, 0, 1));
+    vec4 c_bottom_back  = FetchCentroid(texel - ivec3(0, 1, 1));
 
     // Next we compute the resulting vertex positions in world-space
     // The centroid offset is a triple in the range [0, 1]
@@ -88,7 +125,7 @@ void main()
     // half a tile's width to the left. When it is 1, we push
     // it the same amount to the right. When it is 0.5, the
     // vertex stays in the cell center.
-    float one_over_n = 1.0 / float(textureSize(inCentroid, 0).x);
+    float one_over_n = 1.0 / float(dimension);
     vec3 one            = vec3(1.0);
     vec3 v_mid          = -one + 2.0 * one_over_n * (vec3(texel) + c_mid.xyz);
     vec3 v_left         = -one + 2.0 * one_over_n * (vec3(texel - ivec3(1, 0, 0)) + c_left.xyz);
@@ -101,10 +138,13 @@ void main()
     // Sample the volume texture in the lower octant
     // (We use these samples to compute the normal
     // and determine triangle orientation below).
-    float volume000 = texelFetch(inSurface, texel, 0).r;
-    float volume100 = texelFetch(inSurface, texel + ivec3(1, 0, 0), 0).r;
-    float volume010 = texelFetch(inSurface, texel + ivec3(0, 1, 0), 0).r;
-    float volume001 = texelFetch(inSurface, texel + ivec3(0, 0, 1), 0).r;
+    // This cell is on the surface, so its brick is resident,
+    // and the brick apron holds the samples at +1.
+    ivec3 corner = PoolOrigin(LookupBrick(texel)) * BRICK_SAMPLES + texel % BRICK_SIZE;
+    float volume000 = texelFetch(inSurface, corner, 0).r;
+    float volume100 = texelFetch(inSurface, corner + ivec3(1, 0, 0), 0).r;
+    float volume010 = texelFetch(inSurface, corner + ivec3(0, 1, 0), 0).r;
+    float volume001 = texelFetch(inSurface, corner + ivec3(0, 0, 1), 0).r;
 
     // Before constructing the triangles, we need to find the
     // correct orientation. We define CCW to be frontfacing,
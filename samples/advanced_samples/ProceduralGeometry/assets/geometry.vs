@@ -22,10 +22,15 @@
 
 precision highp float;
 
-in ivec3 texel;
+uniform int dimension;
 flat out ivec3 v_texel;
 
+// The index buffer written by centroid.cs holds the linear cell
+// index of each surface cell, so we decode it back into a texel.
 void main()
 {
-    v_texel = texel;
+    int index = gl_VertexID;
+    v_texel = ivec3(index % dimension,
+                    (index / dimension) % dimension,
+                    index / (dimension * dimension));
 }
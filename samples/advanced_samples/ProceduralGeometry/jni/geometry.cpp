@@ -24,14 +24,32 @@
 // The size of one grid side length
 #define N 64
 
-Volume make_surface_volume()
+// The grid is split into bricks of BRICK_SIZE^3 cells. Only bricks
+// that may contain the surface are generated, and they are stored
+// in pools with room for pool_x * pool_y * pool_z bricks. This must
+// match BRICK_SIZE in the compute and geometry shaders.
+#define BRICK_SIZE 8
+#define BRICKS_PER_AXIS (N / BRICK_SIZE)
+
+// The pools start out with room for half of the grid, which covers
+// the usual scene, and grow along z if more bricks are resident.
+#define POOL_X BRICKS_PER_AXIS
+#define POOL_Y BRICKS_PER_AXIS
+#define INITIAL_POOL_Z (BRICKS_PER_AXIS / 2)
+
+int pool_capacity(App *app)
 {
-    // This should be one more than the dimensions of
-    // the centroid texture, since each centroid should
-    // have two neighbor noise values.
-    int width  = N + 1;
-    int height = N + 1;
-    int depth  = N + 1;
+    return app->pool_x * app->pool_y * app->pool_z;
+}
+
+Volume make_surface_volume(App *app)
+{
+    // Each brick stores one more sample than it has cells
+    // along each axis, since each centroid should have two
+    // neighbor noise values.
+    int width  = app->pool_x * (BRICK_SIZE + 1);
+    int height = app->pool_y * (BRICK_SIZE + 1);
+    int depth  = app->pool_z * (BRICK_SIZE + 1);
 
     GLuint handle;
     glGenTextures(1, &handle);
@@ -50,11 +68,11 @@ Volume make_surface_volume()
     return result;
 }
 
-Volume make_centroid_volume()
+Volume make_centroid_volume(App *app)
 {
-    int width  = N;
-    int height = N;
-    int depth  = N;
+    int width  = app->pool_x * BRICK_SIZE;
+    int height = app->pool_y * BRICK_SIZE;
+    int depth  = app->pool_z * BRICK_SIZE;
 
     GLuint handle;
     glGenTextures(1, &handle);
@@ -73,6 +91,30 @@ Volume make_centroid_volume()
     return result;
 }
 
+// Maps a brick coordinate to its slot in the pools
+Volume make_brick_table()
+{
+    int width  = BRICKS_PER_AXIS;
+    int height = BRICKS_PER_AXIS;
+    int depth  = BRICKS_PER_AXIS;
+
+    GLuint handle;
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_3D, handle);
+    glTexStorage3D(GL_TEXTURE_3D, 1, GL_R32UI, width, height, depth);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    Volume result;
+    result.tex = handle;
+    result.x = width;
+    result.y = height;
+    result.z = depth;
+    return result;
+}
+
 GLuint make_quad()
 {
     float v[] = {
@@ -90,31 +132,6 @@ GLuint make_quad()
     return result;
 }
 
-void make_points(GLuint *vbo, GLuint *ibo)
-{
-    std::vector<int> v(N*N*N*3);
-    int *vptr = &v[0];
-    unsigned int i = 0;
-    std::vector<unsigned int> I(N*N*N);
-    for (int z = 0; z < N; z++)
-    for (int y = 0; y < N; y++)
-    for (int x = 0; x < N; x++)
-    {
-        vptr[0] = x;
-        vptr[1] = y;
-        vptr[2] = z;
-        vptr += 3;
-        I[i] = i;
-        i++;
-    }
-    glGenBuffers(1, vbo);
-    glBindBuffer(GL_ARRAY_BUFFER, *vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(v[0]) * v.size(), v.data(), GL_STATIC_DRAW);
-    glGenBuffers(1, ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, *ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(I[0]) * I.size(), I.data(), GL_STATIC_DRAW);
-}
-
 void clear_indirect_buffer(App *app)
 {
     typedef  struct {
@@ -131,27 +148,131 @@ void clear_indirect_buffer(App *app)
     glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(cmd), &cmd, GL_STREAM_DRAW);
 }
 
-void update_surface(App *app)
+void clear_brick_dispatch_buffer(App *app)
+{
+    // The brick counter doubles as the x dimension
+    // of the indirect dispatch for the later passes.
+    GLuint cmd[3] = { 0, 1, 1 };
+    glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, app->brick_dispatch_buffer);
+    glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(cmd), cmd, GL_STREAM_DRAW);
+}
+
+// (Re)creates everything that is sized by the pool capacity
+void allocate_pools(App *app)
+{
+    if (app->tex_centroid.tex != 0)
+    {
+        glDeleteTextures(1, &app->tex_centroid.tex);
+        glDeleteTextures(1, &app->tex_surface.tex);
+        glDeleteBuffers(1, &app->index_buffer);
+        glDeleteBuffers(1, &app->brick_buffer);
+    }
+
+    app->tex_centroid = make_centroid_volume(app);
+    app->tex_surface = make_surface_volume(app);
+
+    // At most every cell of every resident brick is on the surface
+    glGenBuffers(1, &app->index_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, app->index_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, pool_capacity(app)*BRICK_SIZE*BRICK_SIZE*BRICK_SIZE*sizeof(GLuint), 0, GL_STREAM_DRAW);
+
+    glGenBuffers(1, &app->brick_buffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, app->brick_buffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, pool_capacity(app)*sizeof(GLuint), 0, GL_STREAM_DRAW);
+}
+
+// The classify pass counts every resident brick, but drops the
+// ones that do not fit in the pools. Those leave holes in the
+// surface, so grow the pools as soon as that is seen.
+void grow_pools_on_overflow(App *app)
+{
+    if (app->brick_count_fence == 0 ||
+        glClientWaitSync(app->brick_count_fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+        return;
+
+    glDeleteSync(app->brick_count_fence);
+    app->brick_count_fence = 0;
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, app->brick_count_buffer);
+    GLuint *count = (GLuint*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, sizeof(GLuint), GL_MAP_READ_BIT);
+    if (count == NULL)
+        return;
+    int resident = (int)*count;
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+
+    if (resident <= pool_capacity(app))
+        return;
+
+    // The whole grid always fits
+    int slice = app->pool_x * app->pool_y;
+    app->pool_z = (resident + slice - 1) / slice;
+    if (app->pool_z > BRICKS_PER_AXIS)
+        app->pool_z = BRICKS_PER_AXIS;
+
+    LOGI("%d resident bricks, growing the pools to %d bricks\n", resident, pool_capacity(app));
+    allocate_pools(app);
+}
+
+void update_bricks(App *app)
 {
     int local_size_x = 4;
     int local_size_y = 4;
     int local_size_z = 4;
 
-    // Since the surface volume texture has a resolution
-    // one higher than the centroid texture, we cannot divide
-    // it evenly to work groups of size larger than one. To
-    // accommodate this, we add one work group for the edge.
-    int work_groups_x = 1 + (app->tex_surface.x - 1) / local_size_x;
-    int work_groups_y = 1 + (app->tex_surface.y - 1) / local_size_y;
-    int work_groups_z = 1 + (app->tex_surface.z - 1) / local_size_z;
+    int work_groups_x = 1 + (app->tex_bricks.x - 1) / local_size_x;
+    int work_groups_y = 1 + (app->tex_bricks.y - 1) / local_size_y;
+    int work_groups_z = 1 + (app->tex_bricks.z - 1) / local_size_z;
+
+    grow_pools_on_overflow(app);
+    clear_brick_dispatch_buffer(app);
+
+    glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, app->brick_dispatch_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, app->brick_buffer);
+
+    glUseProgram(app->program_classify);
+    uniform1f(classify,  time,          app->elapsed_time);
+    uniform1i(classify,  dimension,     N);
+    uniform3fv(classify, sphere_pos,    app->sphere_pos);
+    uniform1f(classify,  sphere_radius, app->sphere_radius);
+    uniform1ui(classify, capacity,      pool_capacity(app));
+    glBindImageTexture(0, app->tex_bricks.tex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R32UI);
+    glDispatchCompute(work_groups_x, work_groups_y, work_groups_z);
+
+    // Ensure that the brick list and count are written before
+    // they are read by the later passes and the dispatch command,
+    // and that the brick table is written before it is sampled.
+    glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT |
+                    GL_COMMAND_BARRIER_BIT |
+                    GL_TEXTURE_FETCH_BARRIER_BIT |
+                    GL_BUFFER_UPDATE_BARRIER_BIT);
+
+    // Keep a copy of the brick count to check for overflow
+    // once the GPU has finished with it. Only one readback
+    // is in flight at a time, so mapping never stalls.
+    if (app->brick_count_fence == 0)
+    {
+        glBindBuffer(GL_COPY_READ_BUFFER, app->brick_dispatch_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, app->brick_count_buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(GLuint));
+        app->brick_count_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void update_surface(App *app)
+{
+    // One work group per resident brick. The number of
+    // work groups is read from the brick counter.
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, app->brick_buffer);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, app->brick_dispatch_buffer);
 
     glUseProgram(app->program_generate);
     uniform1f(generate,  time,          app->elapsed_time);
     uniform1i(generate,  dimension,     N);
     uniform3fv(generate, sphere_pos,    app->sphere_pos);
     uniform1f(generate,  sphere_radius, app->sphere_radius);
+    uniform3i(generate,  pool_size,     app->pool_x, app->pool_y, app->pool_z);
     glBindImageTexture(0, app->tex_surface.tex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_R32F);
-    glDispatchCompute(work_groups_x, work_groups_y, work_groups_z);
+    glDispatchComputeIndirect(0);
 
     // Ensure that the surface texture is properly updated
     // before it is sampled in the centroid shader (using imageLoad)
@@ -160,24 +281,20 @@ void update_surface(App *app)
 
 void update_centroid(App *app)
 {
-    int local_size_x = 4;
-    int local_size_y = 4;
-    int local_size_z = 4;
-
-    int work_groups_x = app->tex_centroid.x / local_size_x;
-    int work_groups_y = app->tex_centroid.y / local_size_y;
-    int work_groups_z = app->tex_centroid.z / local_size_z;
-
     clear_indirect_buffer(app);
 
     glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 2, app->indirect_buffer);
     glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, app->index_buffer);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, app->brick_buffer);
+    glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, app->brick_dispatch_buffer);
 
     glUseProgram(app->program_centroid);
     uniform1f(centroid, voxel_mode, app->voxel_mode);
+    uniform1i(centroid, dimension,  N);
+    uniform3i(centroid, pool_size,  app->pool_x, app->pool_y, app->pool_z);
     glBindImageTexture(0, app->tex_surface.tex, 0, GL_TRUE, 0, GL_READ_ONLY, GL_R32F);
     glBindImageTexture(1, app->tex_centroid.tex, 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RGBA8);
-    glDispatchCompute(work_groups_x, work_groups_y, work_groups_z);
+    glDispatchComputeIndirect(0);
 
     // Ensure that the centroid offsets are properly written
     // before we attempt to read them in the geometry shader.
@@ -248,13 +365,17 @@ mat4 animate_view(App *app)
 void app_initialize(App *app)
 {
     glGenVertexArrays(1, &app->vao);
+    glGenVertexArrays(1, &app->vao_geometry);
     glBindVertexArray(app->vao);
     glViewport(0, 0, app->window_width, app->window_height);
 
-    app->tex_centroid = make_centroid_volume();
-    app->tex_surface = make_surface_volume();
+    app->pool_x = POOL_X;
+    app->pool_y = POOL_Y;
+    app->pool_z = INITIAL_POOL_Z;
+    app->tex_centroid.tex = 0;
+    app->tex_bricks = make_brick_table();
+    allocate_pools(app);
     app->vbo_quad = make_quad();
-    make_points(&app->vbo_points, &app->ibo_points);
 
     app->fov = PI / 7.0f;
     app->z_near = 1.0f;
@@ -271,31 +392,46 @@ void app_initialize(App *app)
 
     get_attrib_location (backdrop, position);
 
-    get_attrib_location (geometry, texel);
     get_uniform_location(geometry, inCentroid);
     get_uniform_location(geometry, inSurface);
+    get_uniform_location(geometry, inBricks);
     get_uniform_location(geometry, inMaterial);
     get_uniform_location(geometry, view);
     get_uniform_location(geometry, projection);
+    get_uniform_location(geometry, dimension);
+    get_uniform_location(geometry, pool_size);
 
     get_uniform_location(generate, sphere_radius);
     get_uniform_location(generate, sphere_pos);
     get_uniform_location(generate, dimension);
     get_uniform_location(generate, time);
+    get_uniform_location(generate, pool_size);
+
+    get_uniform_location(classify, sphere_radius);
+    get_uniform_location(classify, sphere_pos);
+    get_uniform_location(classify, dimension);
+    get_uniform_location(classify, time);
+    get_uniform_location(classify, capacity);
 
     get_uniform_location(centroid, voxel_mode);
+    get_uniform_location(centroid, dimension);
+    get_uniform_location(centroid, pool_size);
 
     glGenBuffers(1, &app->indirect_buffer);
-    glGenBuffers(1, &app->index_buffer);
-    glBindBuffer(GL_SHADER_STORAGE_BUFFER, app->index_buffer);
-    glBufferData(GL_SHADER_STORAGE_BUFFER, N*N*N*sizeof(GLuint), 0, GL_STREAM_DRAW);
+    glGenBuffers(1, &app->brick_dispatch_buffer);
+    glGenBuffers(1, &app->brick_count_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, app->brick_count_buffer);
+    glBufferData(GL_COPY_WRITE_BUFFER, sizeof(GLuint), 0, GL_STREAM_READ);
+    app->brick_count_fence = 0;
 
+    update_bricks(app);
     update_surface(app);
     update_centroid(app);
 }
 
 void app_update_and_render(App *app)
 {
+    update_bricks(app);
     update_surface(app);
     update_centroid(app);
 
@@ -317,6 +453,7 @@ void app_update_and_render(App *app)
     // Backdrop shader
 
     glDepthMask(GL_FALSE);
+    glBindVertexArray(app->vao);
     glUseProgram(app->program_backdrop);
     glBindBuffer(GL_ARRAY_BUFFER, app->vbo_quad);
     attribfv(backdrop, position, 2, 0);
@@ -332,17 +469,23 @@ void app_update_and_render(App *app)
     glBindTexture(GL_TEXTURE_3D, app->tex_centroid.tex);
     glActiveTexture(GL_TEXTURE2);
     glBindTexture(GL_TEXTURE_2D, app->tex_material);
+    glActiveTexture(GL_TEXTURE3);
+    glBindTexture(GL_TEXTURE_3D, app->tex_bricks.tex);
 
     glUseProgram(app->program_geometry);
     uniform1i(geometry, inSurface,  0);
     uniform1i(geometry, inCentroid, 1);
     uniform1i(geometry, inMaterial, 2);
+    uniform1i(geometry, inBricks,   3);
+    uniform1i(geometry, dimension,  N);
+    uniform3i(geometry, pool_size,  app->pool_x, app->pool_y, app->pool_z);
     uniformm4(geometry, projection, mat_projection);
     uniformm4(geometry, view,       mat_view);
 
-    glBindBuffer(GL_ARRAY_BUFFER, app->vbo_points);
+    // The cell coordinates are decoded from the indices
+    // in the vertex shader, so no vertex attributes are needed.
+    glBindVertexArray(app->vao_geometry);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, app->index_buffer);
     glBindBuffer(GL_DRAW_INDIRECT_BUFFER, app->indirect_buffer);
-    attribiv(geometry, texel, 3, 0);
     glDrawElementsIndirect(GL_POINTS, GL_UNSIGNED_INT, 0);
 }
@@ -54,12 +54,14 @@ struct App
 
     // Geometry construction shader
     GLuint program_geometry;
-    GLuint a_geometry_texel;
     GLuint u_geometry_inCentroid;
     GLuint u_geometry_inSurface;
+    GLuint u_geometry_inBricks;
     GLuint u_geometry_inMaterial;
     GLuint u_geometry_view;
     GLuint u_geometry_projection;
+    GLuint u_geometry_dimension;
+    GLuint u_geometry_pool_size;
 
     // Backdrop shader
     GLuint program_backdrop;
@@ -68,6 +70,8 @@ struct App
     // Centroid placement shader
     GLuint program_centroid;
     GLuint u_centroid_voxel_mode;
+    GLuint u_centroid_dimension;
+    GLuint u_centroid_pool_size;
 
     // Isosurface generation shader
     GLuint program_generate;
@@ -75,12 +79,21 @@ struct App
     GLuint u_generate_sphere_pos;
     GLuint u_generate_dimension;
     GLuint u_generate_time;
-
-    // Geometry
+    GLuint u_generate_pool_size;
+
+    // Brick classification shader
+    GLuint program_classify;
+    GLuint u_classify_sphere_radius;
+    GLuint u_classify_sphere_pos;
+    GLuint u_classify_dimension;
+    GLuint u_classify_time;
+    GLuint u_classify_capacity;
+
+    // Geometry. The isosurface is drawn without
+    // vertex attributes, from a VAO of its own.
     GLuint vao;
+    GLuint vao_geometry;
     GLuint vbo_point;
-    GLuint vbo_points;
-    GLuint ibo_points;
     GLuint vbo_quad;
 
     // Indirect draw call buffer and
@@ -88,10 +101,26 @@ struct App
     GLuint indirect_buffer;
     GLuint index_buffer;
 
+    // Resident brick list, and the indirect dispatch
+    // buffer holding the number of resident bricks
+    GLuint brick_buffer;
+    GLuint brick_dispatch_buffer;
+
+    // Copy of the brick count that is read back once the
+    // GPU is done with it, to grow the pools on overflow
+    GLuint brick_count_buffer;
+    GLsync brick_count_fence;
+
+    // Number of bricks along each axis of the pools
+    int pool_x, pool_y, pool_z;
+
     // 2D textures
     GLuint tex_material;
 
     // 3D textures
+    // The centroid and surface volumes are brick pools,
+    // indexed through the brick table.
+    Volume tex_bricks;
     Volume tex_centroid;
     Volume tex_surface;
 };
@@ -129,6 +158,8 @@ void app_update_and_render(App *app);
 #define uniform2f(prog, name, x, y)   glUniform2f(app->u_##prog##_##name, x, y);
 #define uniform3fv(prog, name, value) glUniform3fv(app->u_##prog##_##name, 1, &value[0]);
 #define uniform1i(prog, name, value)  glUniform1i(app->u_##prog##_##name, value);
+#define uniform1ui(prog, name, value) glUniform1ui(app->u_##prog##_##name, value);
+#define uniform3i(prog, name, x, y, z) glUniform3i(app->u_##prog##_##name, x, y, z);
 #define uniformm4(prog, name, value)  glUniformMatrix4fv(app->u_##prog##_##name, 1, GL_FALSE, value.value_ptr());
 
 #endif
@@ -172,11 +172,22 @@ void load_generate_shader(App *app)
     free(cs_src);
 }
 
+void load_classify_shader(App *app)
+{
+    char *cs_src = read_file(SHADER_PATH("classify.cs"));
+
+    GLuint shaders[] = { compile_shader(cs_src, GL_COMPUTE_SHADER) };
+    app->program_classify = link_program(shaders, 1);
+
+    free(cs_src);
+}
+
 void load_assets(App *app)
 {
     load_geometry_shader(app);
     load_centroid_shader(app);
     load_generate_shader(app);
+    load_classify_shader(app);
     load_backdrop_shader(app);
 
     app->tex_material = load_texture(TEXTURE_PATH("texture11.jpg"));
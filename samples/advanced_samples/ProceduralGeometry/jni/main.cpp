@@ -41,6 +41,7 @@
 #include "loader.cpp"
 
 #include <sys/time.h>
+#include "Profiler.h"
 static timeval start_time;
 static App app;
 
@@ -95,6 +96,7 @@ extern "C"
 
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_proceduralgeometry_ProceduralGeometry_step(JNIEnv* env, jobject obj)
     {
+        MaliSDK::ProfileFrame profileFrame;
         timeval now;
         gettimeofday(&now, NULL);
         float seconds  = (now.tv_sec - start_time.tv_sec);
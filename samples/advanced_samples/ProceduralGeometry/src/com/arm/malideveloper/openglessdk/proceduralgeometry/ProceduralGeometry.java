@@ -48,6 +48,7 @@ public class ProceduralGeometry extends Activity {
         extractAsset("backdrop.vs");
         extractAsset("backdrop.fs");
 
+        extractAsset("classify.cs");
         extractAsset("generate.cs");
         extractAsset("centroid.cs");
 
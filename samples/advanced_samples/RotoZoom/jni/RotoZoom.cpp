@@ -27,8 +27,10 @@
 #include <cmath>
 #include <string>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
  
 #include "RotoZoom.h"
 #include "Timer.h"
@@ -38,12 +40,18 @@
 #include "Matrix.h"
 #include "Platform.h"
 #include "Mathematics.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.rotozoom/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string textureFilename = "RotoZoom.raw";
 string vertexShaderFilename = "RotoZoom_cube.vert";
 string fragmentShaderFilename = "RotoZoom_cube.frag";
@@ -105,10 +113,16 @@ bool setupGraphics(int width, int height)
     /* Load just base level texture data. */
     GL_CHECK(glGenTextures(1, &textureID));
     GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
-    unsigned char *textureData = NULL;
-    Texture::loadData(texturePath.c_str(), &textureData);
+    /* The texture is uploaded straight from the mapped file. */
+    AssetFile textureFile;
+    if (!textureFile.open(texturePath.c_str()))
+    {
+        LOGE("Could not load texture: %s\n", textureFile.getError());
+        return false;
+    }
         
-    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData));        
+    GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 256, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureFile.getSpan(0, 256 * 256 * 4).data));
+    textureFile.close();
 
     /* Set texture mode. */
     GL_CHECK(glGenerateMipmap(GL_TEXTURE_2D));
@@ -251,6 +265,7 @@ void renderFrame(void)
     if(angleZoom < 0) angleZoom += 360;
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_rotozoom_RotoZoom_init
@@ -267,6 +282,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_rotozoom_RotoZoom_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -276,3 +292,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("RotoZoom", setupGraphics, renderFrame)
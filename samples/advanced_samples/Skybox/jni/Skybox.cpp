@@ -28,6 +28,7 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include "Profiler.h"
 
 /* Window resolution. */
 unsigned int window_width  = 0;
@@ -340,6 +341,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_skybox_NativeLibra
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_skybox_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     render_frame();
 }
 
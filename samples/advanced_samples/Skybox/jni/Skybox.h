@@ -56,16 +56,7 @@
     ptr = NULL;         \
 }
 
-#define GL_CHECK(x)                                                                             \
-    x;                                                                                          \
-    {                                                                                           \
-        GLenum glError = glGetError();                                                          \
-        if(glError != GL_NO_ERROR)                                                              \
-        {                                                                                       \
-            LOGE("glGetError() = %i (%#.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(EXIT_FAILURE);                                                                 \
-        }                                                                                       \
-    }
+#include "GLCheck.h"
 
 /* Vertex shader source code. */
 const char skybox_vertex_shader_source[] =
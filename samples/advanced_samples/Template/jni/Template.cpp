@@ -34,18 +34,26 @@
 #include <cstdio>
 #include <cstdlib>
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include "Template.h"
 #include "Text.h"
-#include "AndroidPlatform.h"
+#include "Platform.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.template/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 
 /* A text object to draw text on the screen.*/
 Text* text;
@@ -74,6 +82,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_template_Template_init
@@ -85,6 +94,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_template_Template_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -94,3 +104,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Template", setupGraphics, renderFrame)
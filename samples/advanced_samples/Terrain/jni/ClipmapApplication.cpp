@@ -21,6 +21,7 @@
 #include "ClipmapApplication.h"
 #include "shaders.h"
 #include "Platform.h"
+#include "ProgramLibrary.h"
 #include <cstdio>
 
 using namespace MaliSDK;
@@ -29,8 +30,9 @@ using namespace std;
 ClipmapApplication::ClipmapApplication(unsigned int size, unsigned int levels, float clip_scale)
     : mesh(size, levels, clip_scale), heightmap(size * 4 - 1, levels), frame(0)
 {
-    // Compile shaders and grab uniform locations for later use.
-    program = compile_program(vertex_shader_source, fragment_shader_source);
+    // The program library hands out the program linked by the warm-up thread, loads the binary
+    // saved by an earlier launch, or compiles and links the shaders. Grab uniform locations for later use.
+    program = ProgramLibrary::getInstance()->getProgram(get_shader_set());
     GL_CHECK(glUseProgram(program));
     GL_CHECK(glUniformBlockBinding(program, glGetUniformBlockIndex(program, "InstanceData"), 0));
 
@@ -58,63 +60,13 @@ ClipmapApplication::~ClipmapApplication()
     GL_CHECK(glDeleteProgram(program));
 }
 
-GLuint ClipmapApplication::compile_program(const char *vertex_shader, const char *fragment_shader)
+ShaderSet ClipmapApplication::get_shader_set()
 {
-    GL_CHECK(GLuint prog = glCreateProgram());
-    GL_CHECK(GLuint vertex = compile_shader(GL_VERTEX_SHADER, vertex_shader));
-    GL_CHECK(GLuint fragment = compile_shader(GL_FRAGMENT_SHADER, fragment_shader));
+    ShaderSet shader_set;
+    shader_set.addSource(GL_VERTEX_SHADER, vertex_shader_source);
+    shader_set.addSource(GL_FRAGMENT_SHADER, fragment_shader_source);
 
-    GL_CHECK(glAttachShader(prog, vertex));
-    GL_CHECK(glAttachShader(prog, fragment));
-    GL_CHECK(glLinkProgram(prog));
-
-    GLint status = 0;
-    GL_CHECK(glGetProgramiv(prog, GL_LINK_STATUS, &status));
-    if (!status)
-    {
-        GLint info_len = 0;
-        GL_CHECK(glGetProgramiv(prog, GL_INFO_LOG_LENGTH, &info_len));
-        if (info_len)
-        {
-            char *buffer = new char[info_len];
-            GLint actual_len;
-            GL_CHECK(glGetProgramInfoLog(prog, info_len, &actual_len, buffer));
-            LOGE("Program failed to link: %s.\n", buffer);
-            delete[] buffer;
-        }
-    }
-
-    // Don't need these anymore.
-    GL_CHECK(glDeleteShader(vertex));
-    GL_CHECK(glDeleteShader(fragment));
-    return prog;
-}
-
-GLuint ClipmapApplication::compile_shader(GLenum type, const char *source)
-{
-    GL_CHECK(GLuint shader = glCreateShader(type));
-    GL_CHECK(glShaderSource(shader, 1, &source, NULL));
-    GL_CHECK(glCompileShader(shader));
-
-    GLint status = 0;
-    GL_CHECK(glGetShaderiv(shader, GL_COMPILE_STATUS, &status));
-
-    if (!status)
-    {
-        GLint info_len = 0;
-        GL_CHECK(glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &info_len));
-        if (info_len)
-        {
-            char *buffer = new char[info_len];
-            GLint actual_len;
-            GL_CHECK(glGetShaderInfoLog(shader, info_len, &actual_len, buffer));
-
-            LOGE("Shader error: %s.\n", buffer);
-            delete[] buffer;
-        }
-    }
-
-    return shader;
+    return shader_set;
 }
 
 void ClipmapApplication::render(unsigned int width, unsigned int height)
@@ -26,6 +26,7 @@
 
 #include "GroundMesh.h"
 #include "Heightmap.h"
+#include "ProgramLibrary.h"
 #include "vector_math.h"
 
 class ClipmapApplication
@@ -35,10 +36,11 @@ public:
     ~ClipmapApplication();
     void render(unsigned int viewport_width, unsigned int viewport_height);
 
+    // The shaders of the terrain program, so it can be warmed up before the application is created.
+    static MaliSDK::ShaderSet get_shader_set();
+
 private:
     GLuint program;
-    GLuint compile_program(const char *vertex_shader_source, const char *fragment_shader_source);
-    GLuint compile_shader(GLenum type, const char *source);
     std::string load_shader_string(const char *path);
 
     GroundMesh mesh;
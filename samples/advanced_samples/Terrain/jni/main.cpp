@@ -24,9 +24,12 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <vector>
 
 #include <jni.h>
 #include <android/log.h>
+#include "Profiler.h"
+#include "ProgramLibrary.h"
 
 using namespace MaliSDK;
 
@@ -50,10 +53,19 @@ int surface_width, surface_height;
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_terrain_Terrain_init
-    (JNIEnv *env, jclass jcls, jint width, jint height)
+    (JNIEnv *env, jclass jcls, jint width, jint height, jstring cache_directory)
     {
+      const char *directory = env->GetStringUTFChars(cache_directory, 0);
+      ProgramLibrary::getInstance()->setCacheDirectory(directory);
+      env->ReleaseStringUTFChars(cache_directory, directory);
+
+      // Link the terrain program on a background thread while the mesh and heightmap are set up.
+      std::vector<ShaderSet> shader_sets(1, ClipmapApplication::get_shader_set());
+      ProgramLibrary::getInstance()->startWarmUp(shader_sets);
+
       delete app;
       app = new ClipmapApplication(CLIPMAP_SIZE, CLIPMAP_LEVELS, CLIPMAP_SCALE);
+      ProgramLibrary::getInstance()->finishWarmUp();
       surface_width = width;
       surface_height = height;
     }
@@ -61,6 +73,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_terrain_Terrain_step
     (JNIEnv *env, jclass jcls)
     {
+      MaliSDK::ProfileFrame profileFrame;
       app->render(surface_width, surface_height);
     }
 
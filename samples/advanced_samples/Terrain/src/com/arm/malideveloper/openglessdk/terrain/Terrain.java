@@ -55,7 +55,7 @@ class TerrainView extends MaliSamplesView
 
         public void onSurfaceChanged(GL10 gl, int width, int height) 
         {
-        	Terrain.init(width, height);
+        	Terrain.init(width, height, getContext().getFilesDir().getPath() + "/");
         }
 
         public void onSurfaceCreated(GL10 gl, EGLConfig config) 
@@ -68,7 +68,7 @@ public class Terrain extends MaliSamplesActivity
 {
 	TerrainView mView;
     
-    public static native void init(int width, int height);
+    public static native void init(int width, int height, String cacheDirectory);
     public static native void step();
     public static native void uninit();
     
@@ -50,6 +50,7 @@ using namespace MaliSDK;
 #define DIFFUSEMAP_PATH(name)   BASE_ASSET_PATH name "_diffusemap.png"
 #define SHADER_PATH(name)       BASE_ASSET_PATH name
 #include "loader.cpp"
+#include "Profiler.h"
 
 static timeval start_time;
 static App app;
@@ -107,6 +108,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_tessellation_NativeLibrary_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         timeval now;
         gettimeofday(&now, NULL);
         float seconds  = (now.tv_sec - start_time.tv_sec);
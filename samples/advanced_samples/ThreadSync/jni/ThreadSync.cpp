@@ -47,6 +47,7 @@ static bool useFence = true;
 #include "Text.h"
 #include "Shader.h"
 #include "Matrix.h"
+#include "Profiler.h"
 
 using std::string;
 using namespace MaliSDK;
@@ -648,6 +649,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_threadsync_ThreadSync_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
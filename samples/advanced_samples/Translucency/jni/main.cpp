@@ -27,6 +27,7 @@
 #include <android/log.h>
 #include "common.h"
 #include "timer.h"
+#include "Profiler.h"
 
 double last_tick = 0.0;
 
@@ -70,6 +71,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_translucency_NativeLibrary_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         double now = get_elapsed_time();
         double dt = now - last_tick;
         last_tick = now;
@@ -28,24 +28,32 @@
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
  
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <cstdio>
 #include <cstdlib>
 #include <cmath> 
 
-#include "AndroidPlatform.h"
+#include "Platform.h"
 #include "Triangle.h"
 #include "Text.h"
 #include "Shader.h"
 #include "Timer.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using std::string;
 using namespace MaliSDK;
 
 /* Asset directories and filenames. */
+#if defined(ANDROID)
 string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.triangle/";
+#else
+string resourceDirectory = ASSET_DIRECTORY;
+#endif
 string vertexShaderFilename = "Triangle_triangle.vert";
 string fragmentShaderFilename = "Triangle_triangle.frag";
 
@@ -139,6 +147,7 @@ void renderFrame(void)
     text->draw();
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_triangle_Triangle_init
@@ -154,6 +163,7 @@ extern "C"
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_triangle_Triangle_step
     (JNIEnv *env, jclass jcls)
     {
+        MaliSDK::ProfileFrame profileFrame;
         renderFrame();
     }
 
@@ -163,3 +173,7 @@ extern "C"
         delete text;
     }
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Triangle", setupGraphics, renderFrame)
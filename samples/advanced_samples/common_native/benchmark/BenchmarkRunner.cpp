@@ -0,0 +1,175 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * malisdk-benchmark: runs a sample library registered with BENCHMARK_SAMPLE() on an off-screen
+ * context, or compares a result file with a baseline. See Benchmark.h for the options.
+ */
+
+#include "Benchmark.h"
+#include "Platform.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <dlfcn.h>
+
+using namespace MaliSDK;
+
+typedef int (*BenchmarkEntryPoint)(int argc, char **argv);
+
+#if defined(ANDROID)
+/* Android has no EGLRuntime: create a pbuffer context directly. */
+static bool createContext(int width, int height)
+{
+    const EGLint configAttributes[] =
+    {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_ES3_BIT_KHR,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_STENCIL_SIZE, 8,
+        EGL_NONE
+    };
+    const EGLint surfaceAttributes[] = { EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE };
+    const EGLint contextAttributes[] = { EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE };
+
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLConfig config;
+    EGLint numberOfConfigs = 0;
+
+    if (!eglInitialize(display, NULL, NULL) ||
+        !eglChooseConfig(display, configAttributes, &config, 1, &numberOfConfigs) || numberOfConfigs == 0)
+    {
+        LOGE("No EGL config with OpenGL ES 3.0 and pbuffer support.\n");
+        return false;
+    }
+
+    EGLSurface surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttributes);
+
+    if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+    {
+        LOGE("Failed to create an off-screen context, eglGetError(): 0x%.4x.\n", (unsigned int)eglGetError());
+        return false;
+    }
+
+    return true;
+}
+#else
+static bool createContext(int width, int height)
+{
+    Platform::getInstance()->createWindow(width, height);
+    EGLRuntime::initializeEGL(EGLRuntime::OPENGLES3);
+
+    return eglMakeCurrent(EGLRuntime::display, EGLRuntime::surface, EGLRuntime::surface, EGLRuntime::context) == EGL_TRUE;
+}
+#endif
+
+static int printUsage(void)
+{
+    LOGI("Usage: malisdk-benchmark [--frames N] [--warmup N] [--timestep S] [--width W] [--height H] [--output FILE] LIBRARY\n"
+         "       malisdk-benchmark --compare BASELINE RESULT [--threshold PERCENT]\n");
+    return 2;
+}
+
+static int compare(int argc, char **argv)
+{
+    double threshold = 10.0;
+
+    if (argc != 4 && !(argc == 6 && strcmp(argv[4], "--threshold") == 0))
+    {
+        return printUsage();
+    }
+
+    if (argc == 6)
+    {
+        threshold = atof(argv[5]);
+    }
+
+    const int regressions = Benchmark::compare(argv[2], argv[3], threshold);
+
+    if (regressions < 0)
+    {
+        return 2;
+    }
+
+    LOGI("%d regression%s over %.1f%%.\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions > 0 ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc >= 2 && strcmp(argv[1], "--compare") == 0)
+    {
+        return compare(argc, argv);
+    }
+
+    /* The library is the only argument which is not an option or an option's value. */
+    const char *libraryPath = NULL;
+
+    for (int index = 1; index < argc; index++)
+    {
+        if (strncmp(argv[index], "--", 2) == 0)
+        {
+            index++;
+        }
+        else
+        {
+            libraryPath = argv[index];
+        }
+    }
+
+    Benchmark::Settings settings;
+
+    if (libraryPath == NULL || !Benchmark::parseArguments(argc, argv, &settings))
+    {
+        return printUsage();
+    }
+
+    if (!createContext(settings.width, settings.height))
+    {
+        return 1;
+    }
+
+    void *library = dlopen(libraryPath, RTLD_NOW | RTLD_LOCAL);
+
+    if (library == NULL)
+    {
+        LOGE("%s\n", dlerror());
+        return 1;
+    }
+
+    BenchmarkEntryPoint entryPoint = (BenchmarkEntryPoint)dlsym(library, BENCHMARK_ENTRY_POINT);
+
+    if (entryPoint == NULL)
+    {
+        LOGE("%s does not register a sample with BENCHMARK_SAMPLE().\n", libraryPath);
+        return 1;
+    }
+
+    /* The sample runs with its own copy of common-native, where its timers read the simulated clock. */
+    return entryPoint(argc, argv);
+}
@@ -24,16 +24,14 @@
 #include <jni.h>
 #include <android/log.h>
 
+#include "GLCheck.h"
+
 #define  LOG_TAG    __FILE__
 
 #define  LOGI(format, args...) { fprintf(stderr, format, ##args); __android_log_print(ANDROID_LOG_INFO,  LOG_TAG, format, ##args); }
 #define  LOGE(format, args...) { fprintf(stderr, format, ##args); __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, format, ##args); }
 #define  LOGD(format, args...) { fprintf(stderr, format, ##args); __android_log_print(ANDROID_LOG_DEBUG, LOG_TAG, format, ##args); }
 
-#define GL_CHECK(x) \
-        x; \
-        AndroidPlatform::checkGlesError(#x);
-
 namespace MaliSDK
 {
     /**
@@ -0,0 +1,147 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ASSETFILE_H
+#define ASSETFILE_H
+
+#include <cstddef>
+#include <string>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Non-owning view of a range of bytes inside an AssetFile.
+     *
+     * A span does not keep the file alive: it is valid only until the AssetFile it was taken from is closed or destroyed.
+     */
+    struct AssetSpan
+    {
+        const unsigned char *data; /**< First byte of the range, NULL for an empty span. */
+        size_t size;               /**< Number of bytes in the range. */
+
+        AssetSpan() : data(NULL), size(0) {}
+        AssetSpan(const unsigned char *data, size_t size) : data(data), size(size) {}
+
+        /**
+         * \brief Reports whether the span contains no bytes.
+         */
+        bool isEmpty(void) const { return size == 0; }
+
+        /**
+         * \brief Take a range of bytes from inside this span.
+         * \param[in] offset Offset of the first byte, relative to the start of this span.
+         * \param[in] length Number of bytes.
+         * \return The requested range, or an empty span if it does not lie entirely inside this span.
+         */
+        AssetSpan subspan(size_t offset, size_t length) const
+        {
+            if (offset > size || length > size - offset)
+            {
+                return AssetSpan();
+            }
+            return AssetSpan(data + offset, length);
+        }
+    };
+
+    /**
+     * \brief Read-only access to the contents of an asset file.
+     *
+     * Where the platform supports it the file is memory-mapped, so its contents are paged in by the
+     * operating system as they are used and can be handed to OpenGL ES without an intermediate copy.
+     * If mapping fails the file is read into a single buffer in fixed-size chunks instead.
+     * Either way the contents are exposed through AssetSpan objects which stay valid until close() is called
+     * or the AssetFile is destroyed.
+     *
+     * Failures are reported through return values and getError(); AssetFile never terminates the application.
+     */
+    class AssetFile
+    {
+    public:
+        AssetFile();
+
+        /**
+         * \brief Closes the file. All spans taken from it become invalid.
+         */
+        ~AssetFile();
+
+        /**
+         * \brief Open a file and make its contents available.
+         *
+         * Any file which was previously open is closed first.
+         * \param[in] filename Path of the file to open.
+         * \return true on success. On failure the file is left closed and getError() describes the problem.
+         */
+        bool open(const char *filename);
+
+        /**
+         * \brief Release the mapping or buffer. All spans taken from the file become invalid.
+         */
+        void close(void);
+
+        /**
+         * \brief Reports whether a file is currently open.
+         */
+        bool isOpen(void) const { return opened; }
+
+        /**
+         * \brief Reports whether the contents are memory-mapped rather than read into a buffer.
+         */
+        bool isMapped(void) const { return mapped; }
+
+        /**
+         * \brief The whole contents of the file.
+         */
+        AssetSpan getSpan(void) const { return AssetSpan(data, size); }
+
+        /**
+         * \brief A range of bytes from the file.
+         * \param[in] offset Offset of the first byte.
+         * \param[in] length Number of bytes.
+         * \return The requested range, or an empty span if it does not lie entirely inside the file.
+         */
+        AssetSpan getSpan(size_t offset, size_t length) const { return getSpan().subspan(offset, length); }
+
+        /**
+         * \brief Size of the file in bytes.
+         */
+        size_t getSize(void) const { return size; }
+
+        /**
+         * \brief Description of the last failure, or an empty string.
+         */
+        const char *getError(void) const { return error.c_str(); }
+
+    private:
+        /* Spans point into the mapping, so copying the owner would leave them dangling. */
+        AssetFile(const AssetFile &);
+        AssetFile &operator=(const AssetFile &);
+
+        bool mapFile(const char *filename);
+        bool readFile(const char *filename);
+
+        const unsigned char *data;
+        size_t size;
+        bool opened;
+        bool mapped;
+        unsigned char *buffer;
+        std::string error;
+    };
+}
+#endif /* ASSETFILE_H */
@@ -0,0 +1,175 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <string>
+#include <sys/time.h>
+
+namespace MaliSDK
+{
+    /**
+     * \brief The entry points of a sample, as registered with BENCHMARK_SAMPLE().
+     *
+     * Samples return either bool or void from setupGraphics(); both are accepted.
+     */
+    class BenchmarkSample
+    {
+    public:
+        BenchmarkSample(const char *name, bool (*setupGraphics)(int width, int height), void (*renderFrame)(void));
+        BenchmarkSample(const char *name, void (*setupGraphics)(int width, int height), void (*renderFrame)(void));
+
+        /**
+         * \brief The name the sample was registered with.
+         */
+        const char *getName(void) const { return name; }
+
+        /**
+         * \brief Call the sample's setupGraphics().
+         * \return false if the sample reported a failure.
+         */
+        bool setup(int width, int height) const;
+
+        /**
+         * \brief Call the sample's renderFrame().
+         */
+        void render(void) const { renderFrame(); }
+
+    private:
+        const char *name;
+        bool (*setupGraphics)(int width, int height);
+        void (*setupGraphicsWithoutResult)(int width, int height);
+        void (*renderFrame)(void);
+    };
+
+    /**
+     * \brief Reproducible performance runs of a sample.
+     *
+     * run() calls the sample's setupGraphics() and then renderFrame() for a number of warm-up frames followed
+     * by the measured frames, on the context current on the calling thread. While it runs, time read through
+     * getTimeOfDay(), and so through Timer, advances by exactly one fixed timestep per frame, and rand() is
+     * seeded with a constant, so every run renders the same frames. CPU and GPU times of every measured frame
+     * are taken by the Profiler and written to a JSON result file, which compare() checks against a baseline.
+     *
+     * Samples register with BENCHMARK_SAMPLE(); the malisdk-benchmark tool loads the sample's library,
+     * creates an off-screen context and runs it:
+     *
+     *     malisdk-benchmark [--frames N] [--warmup N] [--timestep S] [--width W] [--height H] [--output FILE] libNative.so
+     *     malisdk-benchmark --compare baseline.json result.json [--threshold PERCENT]
+     *
+     * On desktop Linux, the samples listed in HOST_SAMPLES in Sample.cmake are built without their JNI entry
+     * points, as lib<Sample>.so next to a copy of their assets, e.g. advanced_samples/Triangle/libTriangle.so
+     * in the build directory. Other samples are only built into their APK as libNative.so.
+     */
+    class Benchmark
+    {
+    public:
+        /**
+         * \brief Options of a run.
+         */
+        struct Settings
+        {
+            /** Size passed to setupGraphics(), and of the off-screen surface. Defaults to 1280x720. */
+            int width;
+            int height;
+            /** Frames rendered before measuring starts. Defaults to 60. */
+            int warmupFrames;
+            /** Frames measured. Defaults to 300. */
+            int frames;
+            /** Simulated seconds per frame. Defaults to 1/60. */
+            double timestep;
+            /** Result file. Defaults to "<sample>.benchmark.json". */
+            std::string output;
+
+            Settings(void);
+        };
+
+        /**
+         * \brief Read settings from command line options, see the class description.
+         * \param[in]     argc     Number of arguments, including the program name.
+         * \param[in]     argv     The arguments. Arguments which are not options are ignored.
+         * \param[in,out] settings Receives the options given, other fields are left unchanged.
+         * \return false if an option is unknown or its value is invalid.
+         */
+        static bool parseArguments(int argc, char **argv, Settings *settings);
+
+        /**
+         * \brief Run a sample and write its result file. Needs a current context.
+         * \return true if the sample was set up and the result file was written.
+         */
+        static bool run(const BenchmarkSample &sample, const Settings &settings);
+
+        /**
+         * \brief Parse the arguments and run the sample. Called by the function BENCHMARK_SAMPLE() exports.
+         * \return 0 on success, 1 otherwise.
+         */
+        static int main(const BenchmarkSample &sample, int argc, char **argv);
+
+        /**
+         * \brief Whether run() is in progress.
+         */
+        static bool isRunning(void) { return running; }
+
+        /**
+         * \brief gettimeofday(), or the simulated time while run() is in progress.
+         *
+         * Timers should read the time through this function for their animation to be reproducible.
+         */
+        static int getTimeOfDay(timeval *time);
+
+        /**
+         * \brief Compare a result file with a baseline.
+         *
+         * The median and 95th percentile of the CPU and GPU frame times are compared. GPU times are
+         * skipped if either file has none.
+         * \param[in] baselineFilename Stored result of an earlier run.
+         * \param[in] resultFilename   Result to check.
+         * \param[in] threshold        Allowed increase, in percent.
+         * \return The number of times which increased by more than threshold, or -1 if a file could not be read.
+         */
+        static int compare(const char *baselineFilename, const char *resultFilename, double threshold);
+
+    private:
+        static bool running;
+        static timeval origin;
+        static long long simulatedFrames;
+        static double timestep;
+
+        static bool writeResult(const BenchmarkSample &sample, const Settings &settings, const std::string &filename);
+    };
+}
+
+/** Name of the function BENCHMARK_SAMPLE() exports, looked up by malisdk-benchmark. */
+#define BENCHMARK_ENTRY_POINT "malisdkBenchmarkMain"
+
+/**
+ * Register the entry points of a sample for benchmarking. Use once, at file scope, in the sample's library.
+ * \param name          Name of the sample, written to the result file.
+ * \param setupGraphics Function taking the surface width and height, returning bool or void.
+ * \param renderFrame   Function rendering one frame, taking no arguments.
+ */
+#define BENCHMARK_SAMPLE(name, setupGraphics, renderFrame) \
+    extern "C" __attribute__((visibility("default"))) int malisdkBenchmarkMain(int argc, char **argv) \
+    { \
+        return MaliSDK::Benchmark::main(MaliSDK::BenchmarkSample(name, setupGraphics, renderFrame), argc, argv); \
+    }
+
+#endif /* BENCHMARK_H */
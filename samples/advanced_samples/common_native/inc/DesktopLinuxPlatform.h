@@ -0,0 +1,66 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef DESKTOPLINUXPLATFORM_H
+#define DESKTOPLINUXPLATFORM_H
+
+#include "Platform.h"
+
+namespace MaliSDK
+{
+    /**
+     * \brief Platform for desktop Linux, without a window system.
+     *
+     * No native window is created. EGLRuntime renders to an off-screen pbuffer of the size passed to
+     * createWindow(), or to no surface at all (see EGLRuntime::setSurfaceType()), on a display which needs
+     * neither X11 nor Wayland. Samples can therefore run on build servers, using Mesa's software rasteriser
+     * (LIBGL_ALWAYS_SOFTWARE=1) where there is no GPU.
+     */
+    class DesktopLinuxPlatform : public Platform
+    {
+    private:
+        static Platform* instance;
+        DesktopLinuxPlatform(void);
+
+    public:
+        /**
+         * \brief Get the single instance of the platform.
+         */
+        static Platform* getInstance(void);
+
+        /**
+         * \brief Set the size of the off-screen surface. No window is opened.
+         * \param[in] width The required width of the surface.
+         * \param[in] height The required height of the surface.
+         */
+        virtual void createWindow(int width, int height);
+
+        /**
+         * \brief There is no window for the user to close, so this always returns WINDOW_IDLE.
+         */
+        virtual WindowStatus checkWindow(void);
+
+        /**
+         * \brief Nothing to clean up; the surface is destroyed by EGLRuntime::terminateEGL().
+         */
+        virtual void destroyWindow(void);
+    };
+}
+#endif /* DESKTOPLINUXPLATFORM_H */
@@ -72,9 +72,52 @@ namespace MaliSDK
          * Passed to eglCreateWindowSurface() to get the required window surface type.
          */
         static EGLint windowAttributes [];
-        
-     
+
+        /**
+         * \brief Size of a pbuffer surface, as set by setSurfaceType().
+         */
+        static EGLint surfaceWidth;
+        static EGLint surfaceHeight;
+
+        /**
+         * \brief Get a display which needs no window system.
+         *
+         * Tries EGL_MESA_platform_surfaceless, then the first EGL device (EGL_EXT_platform_device),
+         * then the default display.
+         */
+        static EGLDisplay getHeadlessDisplay(void);
+
     public:
+        /**
+         * \brief Kinds of surface initializeEGL() can create.
+         */
+        enum SurfaceType
+        {
+            /** A window surface for the native window of the platform. */
+            SURFACE_WINDOW,
+            /** An off-screen pbuffer surface, which serves as the default framebuffer. */
+            SURFACE_PBUFFER,
+            /**
+             * No surface: the context is made current without one (EGL_KHR_surfaceless_context), and the
+             * application renders to framebuffer objects only. Falls back to SURFACE_PBUFFER where unsupported.
+             */
+            SURFACE_NONE
+        };
+
+        /**
+         * \brief Choose the surface initializeEGL() creates.
+         *
+         * Desktop Linux defaults to SURFACE_PBUFFER, every other platform to SURFACE_WINDOW.
+         * \param[in] type   Kind of surface.
+         * \param[in] width  Width of a pbuffer surface.
+         * \param[in] height Height of a pbuffer surface.
+         */
+        static void setSurfaceType(SurfaceType type, int width, int height);
+
+        /**
+         * \brief The kind of surface initializeEGL() creates, or created.
+         */
+        static SurfaceType getSurfaceType(void);
         /**
          * \brief Set the value of EGL_SAMPLES (AntiAliasing level) to be requested.
          *
@@ -115,8 +158,8 @@ namespace MaliSDK
         /**
          * \brief The EGL surface in use.
          *
-         * Initialized by initializeEGL(). This surface is of window type and is used for 
-         * rendering to the native window.
+         * Initialized by initializeEGL(), of the type chosen with setSurfaceType().
+         * EGL_NO_SURFACE for SURFACE_NONE.
          */
         static EGLSurface surface;
                 
@@ -133,6 +176,12 @@ namespace MaliSDK
          * \brief Shuts down EGL.
          */
         static void terminateEGL(void);
+
+    private:
+        /**
+         * \brief The kind of surface chosen with setSurfaceType().
+         */
+        static SurfaceType surfaceType;
     };
 }
 
@@ -0,0 +1,140 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ETCDECODER_H
+#define ETCDECODER_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#else 
+#error "GLES_VERSION must be defined as either 2 or 3"
+#endif
+
+namespace MaliSDK
+{
+    /**
+     * \brief CPU decoder for ETC1, ETC2 and EAC compressed textures.
+     *
+     * Used to transcode textures to RGBA8 on devices which cannot sample the compressed format,
+     * to check decoded texels without a GPU and in offline tools.
+     *
+     * Supported formats are GL_ETC1_RGB8_OES, the (s)RGB8, punch-through alpha and RGBA8 variants of ETC2,
+     * and the unsigned and signed R11 and RG11 EAC formats. sRGB formats are decoded without conversion.
+     * Images are split into bands of block rows decoded by separate threads, and the clamping and
+     * packing of texels is vectorised with NEON or SSE2 where available.
+     * The output does not depend on the number of threads.
+     */
+    class ETCDecoder
+    {
+    public:
+        /**
+         * \brief Reports whether decode() can handle a format.
+         * \param[in] internalFormat OpenGL ES internal format.
+         */
+        static bool isFormatSupported(GLenum internalFormat);
+
+        /**
+         * \brief Size in bytes of one 4 x 4 block of a format.
+         * \param[in] internalFormat OpenGL ES internal format.
+         * \return 8 or 16, or 0 if the format is not supported.
+         */
+        static int getBlockSize(GLenum internalFormat);
+
+        /**
+         * \brief Decode a compressed image to RGBA8.
+         *
+         * R11 and RG11 EAC data is written to the red and green channels. Signed values are biased
+         * so that -1.0 maps to 0 and 1.0 maps to 255; use decodeEACBlock() for the full 11-bit values.
+         * \param[in]  internalFormat  OpenGL ES internal format of the data.
+         * \param[in]  data            Compressed blocks, in row-major order.
+         * \param[in]  width           Width of the image in texels.
+         * \param[in]  height          Height of the image in texels.
+         * \param[out] rgba            Receives width * height * 4 bytes.
+         * \param[in]  numberOfThreads Number of threads to decode with. Values below 1 are treated as 1.
+         * \return false if the format is not supported.
+         */
+        static bool decode(GLenum internalFormat, const unsigned char *data, int width, int height, unsigned char *rgba, int numberOfThreads = 1);
+
+        /**
+         * \brief Decode one block of any supported format to RGBA8.
+         *
+         * \param[in]  internalFormat OpenGL ES internal format of the block.
+         * \param[in]  block          8 or 16 bytes of compressed data, see getBlockSize().
+         * \param[out] rgba           Receives 4 x 4 RGBA8 texels, rows rgbaStride bytes apart.
+         * \param[in]  rgbaStride     Distance in bytes between two rows of rgba.
+         * \return false if the format is not supported.
+         */
+        static bool decodeBlock(GLenum internalFormat, const unsigned char *block, unsigned char *rgba, int rgbaStride);
+
+        /**
+         * \brief Decode one ETC1 block.
+         *
+         * \param[in]  block  8 bytes of compressed data.
+         * \param[out] rgba   Receives 4 x 4 RGBA8 texels, rows rgbaStride bytes apart.
+         * \param[in]  rgbaStride Distance in bytes between two rows of rgba.
+         */
+        static void decodeETC1Block(const unsigned char *block, unsigned char *rgba, int rgbaStride);
+
+        /**
+         * \brief Decode one ETC2 RGB block.
+         *
+         * \param[in]  block        8 bytes of compressed data.
+         * \param[out] rgba         Receives 4 x 4 RGBA8 texels, rows rgbaStride bytes apart.
+         * \param[in]  rgbaStride   Distance in bytes between two rows of rgba.
+         * \param[in]  punchthrough true for the punch-through alpha formats, where the differential bit is the opaque bit.
+         */
+        static void decodeETC2Block(const unsigned char *block, unsigned char *rgba, int rgbaStride, bool punchthrough);
+
+        /**
+         * \brief Decode one 8-bit EAC alpha block, as used by GL_COMPRESSED_RGBA8_ETC2_EAC.
+         *
+         * \param[in]  block       8 bytes of compressed data.
+         * \param[out] values      Receives 4 x 4 values.
+         * \param[in]  valueStride Distance in bytes between two values in a row.
+         * \param[in]  rowStride   Distance in bytes between two rows.
+         */
+        static void decodeEACAlphaBlock(const unsigned char *block, unsigned char *values, int valueStride, int rowStride);
+
+        /**
+         * \brief Decode one 11-bit EAC block, as used by the R11 and RG11 formats.
+         *
+         * \param[in]  block       8 bytes of compressed data.
+         * \param[in]  isSigned    true for the signed formats.
+         * \param[out] values      Receives 4 x 4 values, in [0, 2047] for unsigned and [-1023, 1023] for signed data.
+         * \param[in]  valueStride Distance in elements between two values in a row.
+         * \param[in]  rowStride   Distance in elements between two rows.
+         */
+        static void decodeEACBlock(const unsigned char *block, bool isSigned, short *values, int valueStride, int rowStride);
+
+        /**
+         * \brief Measure the decoding throughput of every supported format.
+         *
+         * Decodes a width x height image of pseudo-random blocks for about half a second per format,
+         * and logs the throughput in MB/s of compressed data and in millions of texels per second.
+         * \param[in] width           Width of the test image in texels.
+         * \param[in] height          Height of the test image in texels.
+         * \param[in] numberOfThreads Number of threads passed to decode().
+         */
+        static void benchmark(int width, int height, int numberOfThreads);
+    };
+}
+#endif /* ETCDECODER_H */
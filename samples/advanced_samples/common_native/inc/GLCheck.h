@@ -0,0 +1,137 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GLCHECK_H
+#define GLCHECK_H
+
+/**
+ * GL_CHECK_LEVEL selects how much GL error checking is compiled in:
+ * 0 compiles GL_CHECK() down to the bare call, any other value is the initial GLCheck::Level.
+ * By default release builds check once per frame and debug builds check after every call.
+ */
+#if !defined(GL_CHECK_LEVEL)
+#if defined(NDEBUG)
+#define GL_CHECK_LEVEL 1
+#else
+#define GL_CHECK_LEVEL 2
+#endif
+#endif
+
+namespace MaliSDK
+{
+    /**
+     * \brief OpenGL ES error checking shared by all the samples.
+     *
+     * Calls wrapped in GL_CHECK() record their location and, depending on the current level,
+     * are followed by a glGetError() check. The level can be changed at runtime with setLevel(),
+     * or with the debug.malisdk.glcheck system property (MALISDK_GL_CHECK environment variable
+     * on other platforms) set to "off", "frame", "full" or "debug".
+     *
+     * Errors are logged with the file, line and text of the call; they do not stop the application.
+     */
+    class GLCheck
+    {
+    public:
+        /**
+         * \brief How GL errors are detected.
+         */
+        enum Level
+        {
+            /** No checking. */
+            LEVEL_OFF = 0,
+            /** One glGetError() per frame in endFrame(), reported against the last GL_CHECK() location. */
+            LEVEL_FRAME = 1,
+            /** glGetError() after every GL_CHECK(). */
+            LEVEL_FULL = 2,
+            /**
+             * Errors are delivered by a synchronous GL_KHR_debug message callback and reported
+             * against the GL_CHECK() they happened in, without calling glGetError().
+             * Falls back to LEVEL_FRAME if GL_KHR_debug is not supported.
+             */
+            LEVEL_DEBUG_OUTPUT = 3
+        };
+
+        /**
+         * \brief Change the checking level.
+         *
+         * LEVEL_DEBUG_OUTPUT installs the debug callback, so needs a current context.
+         * \param[in] newLevel The level to use from now on.
+         */
+        static void setLevel(Level newLevel);
+
+        /**
+         * \brief The current checking level.
+         */
+        static Level getLevel(void) { return level; }
+
+        /**
+         * \brief Called by GL_CHECK() after the wrapped call.
+         * \param[in] file      Source file of the call.
+         * \param[in] line      Source line of the call.
+         * \param[in] operation Text of the call.
+         */
+        static void afterCall(const char *file, int line, const char *operation)
+        {
+            lastFile = file;
+            lastLine = line;
+            lastOperation = operation;
+
+            if (level == LEVEL_FULL || (level == LEVEL_DEBUG_OUTPUT && messagesPending))
+            {
+                report(file, line, operation);
+            }
+        }
+
+        /**
+         * \brief Run the once per frame checks. Called by ProfileFrame at the end of every frame.
+         *
+         * Applies the runtime level setting if no checked call has done so yet.
+         */
+        static void endFrame(void);
+
+        /**
+         * \brief The name of a GL error code, e.g. "GL_INVALID_ENUM".
+         */
+        static const char *getErrorString(unsigned int error);
+
+    private:
+        static Level level;
+        static bool configured;
+        static bool messagesPending;
+        static const char *lastFile;
+        static int lastLine;
+        static const char *lastOperation;
+
+        static void configure(void);
+        static bool enableDebugOutput(bool enable);
+        static void report(const char *file, int line, const char *operation);
+    };
+}
+
+#if GL_CHECK_LEVEL == 0
+#define GL_CHECK(x) \
+    x;
+#else
+#define GL_CHECK(x) \
+    x; \
+    MaliSDK::GLCheck::afterCall(__FILE__, __LINE__, #x);
+#endif
+
+#endif /* GLCHECK_H */
@@ -0,0 +1,281 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+
+#include <map>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Shadow copy of GL state which filters out redundant state changes.
+     *
+     * Every function issues the GL call of the same name only if it changes the state
+     * last set through the cache, so callers can set the state they need before every
+     * draw or dispatch without paying for what is already bound.
+     *
+     * State starts as unknown, so the first call of each kind always goes to GL.
+     * The state set through the cache must not be changed by direct GL calls, or
+     * invalidate() has to be called afterwards. Deleting objects through the cache
+     * forgets the bindings which refer to them.
+     *
+     * Tracked state: program, vertex array (with its element array buffer and enabled
+     * attributes), buffers per target and per indexed binding point, textures per unit
+     * and target, samplers per unit, texture base and max levels, enabled capabilities,
+     * blend function and equation, depth function and mask, face culling and viewport.
+     */
+    class GLStateCache
+    {
+    public:
+        /**
+         * \brief Number of state changing calls made through the cache.
+         */
+        struct Counters
+        {
+            /** Calls passed on to GL. */
+            unsigned int issued;
+            /** Calls dropped because they would not have changed the state. */
+            unsigned int elided;
+        };
+
+        GLStateCache(void);
+
+        /**
+         * \brief The cache of the application's rendering context.
+         */
+        static GLStateCache *getInstance(void);
+
+        /**
+         * \brief Forget all tracked state, e.g. after code which does not use the cache changed it.
+         */
+        void invalidate(void);
+
+        /**
+         * \brief Start counting a new frame. Called by ProfileFrame at the end of every frame.
+         */
+        void endFrame(void);
+
+        /**
+         * \brief Counters of the last completed frame.
+         */
+        const Counters &getFrameCounters(void) const { return lastFrame; }
+
+        /**
+         * \brief Counters of the frame in progress.
+         */
+        const Counters &getCurrentCounters(void) const { return currentFrame; }
+
+        void useProgram(GLuint program);
+
+        void bindBuffer(GLenum target, GLuint buffer);
+
+        void enableVertexAttribArray(GLuint index);
+        void disableVertexAttribArray(GLuint index);
+
+        void activeTexture(GLenum unit);
+
+        /**
+         * \brief Bind a texture to the active texture unit.
+         */
+        void bindTexture(GLenum target, GLuint texture);
+
+        /**
+         * \brief Bind a texture to a texture unit, selecting the unit first.
+         * \param[in] unit Index of the unit, not a GL_TEXTUREi enum.
+         */
+        void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+        void enable(GLenum capability);
+        void disable(GLenum capability);
+
+        void blendFunc(GLenum sourceFactor, GLenum destinationFactor);
+        void blendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha);
+        void blendEquation(GLenum mode);
+        void blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha);
+
+        void depthFunc(GLenum function);
+        void depthMask(GLboolean flag);
+
+        void cullFace(GLenum mode);
+        void frontFace(GLenum mode);
+
+        void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        void deleteProgram(GLuint program);
+        void deleteBuffers(GLsizei count, const GLuint *buffers);
+        void deleteTextures(GLsizei count, const GLuint *textures);
+
+#if GLES_VERSION >= 3
+        void bindVertexArray(GLuint vertexArray);
+
+        /**
+         * \brief Bind a whole buffer to an indexed binding point. Also sets the generic binding of the target, as GL does.
+         */
+        void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+        void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+        void bindSampler(GLuint unit, GLuint sampler);
+
+        /**
+         * \brief Set GL_TEXTURE_BASE_LEVEL and GL_TEXTURE_MAX_LEVEL of a texture.
+         *
+         * The levels are remembered per texture object, so this can be used on its own
+         * by code which binds textures directly.
+         * \param[in] target   Target the texture is bound to on the active texture unit.
+         * \param[in] texture  The bound texture, used to look up its levels.
+         * \param[in] baseLevel New GL_TEXTURE_BASE_LEVEL.
+         * \param[in] maxLevel  New GL_TEXTURE_MAX_LEVEL.
+         */
+        void setTextureLevels(GLenum target, GLuint texture, GLint baseLevel, GLint maxLevel);
+
+        void deleteVertexArrays(GLsizei count, const GLuint *vertexArrays);
+        void deleteSamplers(GLsizei count, const GLuint *samplers);
+#endif
+
+    private:
+        enum BufferTarget
+        {
+            BUFFER_ARRAY,
+#if GLES_VERSION >= 3
+            BUFFER_COPY_READ,
+            BUFFER_COPY_WRITE,
+            BUFFER_PIXEL_PACK,
+            BUFFER_PIXEL_UNPACK,
+            BUFFER_TRANSFORM_FEEDBACK,
+            BUFFER_UNIFORM,
+            BUFFER_SHADER_STORAGE,
+            BUFFER_ATOMIC_COUNTER,
+            BUFFER_DRAW_INDIRECT,
+            BUFFER_DISPATCH_INDIRECT,
+#endif
+            NUMBER_OF_BUFFER_TARGETS
+        };
+
+        enum TextureTarget
+        {
+            TEXTURE_2D,
+            TEXTURE_CUBE_MAP,
+#if GLES_VERSION >= 3
+            TEXTURE_3D,
+            TEXTURE_2D_ARRAY,
+#endif
+            NUMBER_OF_TEXTURE_TARGETS
+        };
+
+        enum Capability
+        {
+            CAPABILITY_BLEND,
+            CAPABILITY_CULL_FACE,
+            CAPABILITY_DEPTH_TEST,
+            CAPABILITY_DITHER,
+            CAPABILITY_POLYGON_OFFSET_FILL,
+            CAPABILITY_SAMPLE_ALPHA_TO_COVERAGE,
+            CAPABILITY_SAMPLE_COVERAGE,
+            CAPABILITY_SCISSOR_TEST,
+            CAPABILITY_STENCIL_TEST,
+#if GLES_VERSION >= 3
+            CAPABILITY_PRIMITIVE_RESTART_FIXED_INDEX,
+            CAPABILITY_RASTERIZER_DISCARD,
+#endif
+            NUMBER_OF_CAPABILITIES
+        };
+
+        /** State which belongs to a vertex array object. */
+        struct VertexArrayState
+        {
+            GLuint elementArrayBuffer;
+            unsigned int enabledAttributes;
+            unsigned int knownAttributes;
+        };
+
+        struct IndexedBinding
+        {
+            GLuint buffer;
+            GLintptr offset;
+            GLsizeiptr size;
+        };
+
+        struct TextureUnit
+        {
+            GLuint textures[NUMBER_OF_TEXTURE_TARGETS];
+            GLuint sampler;
+        };
+
+        struct TextureLevels
+        {
+            GLint baseLevel;
+            GLint maxLevel;
+        };
+
+        Counters currentFrame;
+        Counters lastFrame;
+
+        GLuint program;
+        GLuint vertexArray;
+        std::map<GLuint, VertexArrayState> vertexArrays;
+        GLuint buffers[NUMBER_OF_BUFFER_TARGETS];
+        std::vector<IndexedBinding> indexedBuffers[NUMBER_OF_BUFFER_TARGETS];
+        GLuint activeUnit;
+        std::vector<TextureUnit> textureUnits;
+        std::map<GLuint, TextureLevels> textureLevels;
+        signed char capabilities[NUMBER_OF_CAPABILITIES];
+        GLenum blendFactors[4];
+        GLenum blendEquations[2];
+        GLenum depthFunction;
+        GLenum depthWriteMask;
+        GLenum cullFaceMode;
+        GLenum frontFaceMode;
+        GLint viewportRectangle[4];
+        bool isViewportKnown;
+
+        /** Returns true, and counts an issued call, if cached differs from value; the caller then makes the GL call. */
+        template <typename T>
+        bool update(T &cached, T value)
+        {
+            if (cached == value)
+            {
+                currentFrame.elided++;
+                return false;
+            }
+
+            cached = value;
+            currentFrame.issued++;
+            return true;
+        }
+
+        VertexArrayState &getVertexArrayState(void);
+        TextureUnit &getTextureUnit(GLuint unit);
+        void setVertexAttribArray(GLuint index, bool enabled);
+        void setCapability(GLenum capability, bool enabled);
+
+        static int getBufferTargetIndex(GLenum target);
+        static int getTextureTargetIndex(GLenum target);
+        static int getCapabilityIndex(GLenum capability);
+    };
+}
+#endif /* GLSTATECACHE_H */
@@ -21,6 +21,9 @@
 #ifndef HDR_IMAGE_LOADER_H
 #define HDR_IMAGE_LOADER_H
 
+#include <cstddef>
+#include <string>
+
 namespace MaliSDK
 {
     /**
@@ -28,11 +31,30 @@ namespace MaliSDK
      *
      * This class implements a loader for the Picture Radiance format.
      * Will only load HDR images with FORMAT=32-bit_rle_rgbe and coordinates specified in -Y +X.
+     * Scan lines may be run-length encoded or flat; the older run-length encoding, which predates 1991, is not supported.
      * See http://radsite.lbl.gov/radiance/refer/filefmts.pdf for more information.
+     *
+     * The file is memory-mapped and, once the start of every scan line is known, the lines are decoded
+     * and converted by several threads straight into the requested pixel format.
      */
     class HDRImage
     {
         public:
+            /**
+             * \brief Pixel formats an image can be decoded to.
+             *
+             * All of them can be passed to glTexImage2D without further conversion.
+             */
+            enum Format
+            {
+                /** 3 floats per pixel. Upload as GL_RGB32F (or GL_RGB16F), GL_RGB, GL_FLOAT. */
+                FORMAT_RGB32F,
+                /** 3 half floats per pixel, clamped to 65504. Upload as GL_RGB16F, GL_RGB, GL_HALF_FLOAT. */
+                FORMAT_RGB16F,
+                /** One 32-bit shared exponent value per pixel. Upload as GL_RGB9_E5, GL_RGB, GL_UNSIGNED_INT_5_9_9_9_REV. */
+                FORMAT_RGB9E5
+            };
+
             /**
              * \brief Default constructor.
              */
@@ -41,16 +63,18 @@ namespace MaliSDK
             /**
              * \brief Constructor which loads a HDR image from a file.
              *
-             * \param[in] filePath The path to the HDR image to load.
+             * \param[in] filePath        The path to the HDR image to load.
+             * \param[in] format          Pixel format to decode to.
+             * \param[in] numberOfThreads Number of threads decoding scan lines. Values below 1 are treated as 1.
              */
-            HDRImage(const std::string& filePath);
+            HDRImage(const std::string& filePath, Format format = FORMAT_RGB32F, int numberOfThreads = 1);
 
             /**
              * \brief Copy constructor to copy the contents of one HDRImage to another.
              *
              * \param[in] another The HDRImage to copy from.
              */
-            HDRImage(HDRImage& another);
+            HDRImage(const HDRImage& another);
 
             /**
              * \brief Destructor.
@@ -58,11 +82,14 @@ namespace MaliSDK
             virtual ~HDRImage(void);
 
             /**
-             * \brief Load a HDRImage from a file.
+             * \brief Load a HDRImage from a file, replacing the current contents.
              *
-             * \param[in] filePath The path to the HDR image to load.
+             * \param[in] filePath        The path to the HDR image to load.
+             * \param[in] format          Pixel format to decode to.
+             * \param[in] numberOfThreads Number of threads decoding scan lines. Values below 1 are treated as 1.
+             * \return true on success. On failure the image is left empty.
              */
-            void loadFromFile(const std::string& filePath);
+            bool loadFromFile(const std::string& filePath, Format format = FORMAT_RGB32F, int numberOfThreads = 1);
           
             /**
              * \brief Overloading assignment operater to do deep copy of the HDRImage data.
@@ -72,10 +99,31 @@ namespace MaliSDK
             HDRImage& operator=(const HDRImage &another);
 
             /**
-             * \brief The HDR image data.
+             * \brief Pixel format of the image data.
+             */
+            Format getFormat(void) const { return format; }
+
+            /**
+             * \brief The image data, laid out row by row from the top of the image, in the format returned by getFormat().
+             */
+            const void* getData(void) const { return pixelData; }
+
+            /**
+             * \brief Size of the image data in bytes.
+             */
+            size_t getDataSize(void) const { return (size_t)width * height * getBytesPerPixel(format); }
+
+            /**
+             * \brief Number of bytes used by one pixel of a format.
+             */
+            static int getBytesPerPixel(Format format);
+
+            /**
+             * \brief The HDR image data as floating point values.
              *
              * Data is stored a floating point RBG values for all the pixels.
              * Total size is width * height * 3 floating point values.
+             * Only set when the image was loaded as FORMAT_RGB32F, NULL otherwise.
              */
             float* rgbData;
 
@@ -90,23 +138,12 @@ namespace MaliSDK
             int height;
 
         private:
+            Format format;
+            unsigned char* pixelData;
 
-            struct RGBEPixel
-            {
-                unsigned char r;
-                unsigned char g;
-                unsigned char b;
-                unsigned char e;
-            };
-
-            static void convertRGBEPixel(const RGBEPixel& pixel, float* rgbData);
-
-            static float convertSingleComponent(unsigned char value, int exponent);
-
-            static bool decodeLine(FILE* file, int lineLength, RGBEPixel* scanLine);
-
-            static void writeDecodedComponent(int componentIndicator, unsigned char value, RGBEPixel* pixel);
+            void release(void);
+            void copyFrom(const HDRImage& another);
     };
 
 }
-#endif /* HDR_IMAGE_LOADER_H */
\ No newline at end of file
+#endif /* HDR_IMAGE_LOADER_H */
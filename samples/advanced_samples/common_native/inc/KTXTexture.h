@@ -0,0 +1,168 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef KTXTEXTURE_H
+#define KTXTEXTURE_H
+
+#include "AssetFile.h"
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#else 
+#error "GLES_VERSION must be defined as either 2 or 3"
+#endif
+
+#include <string>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Block layout of a compressed texture format.
+     */
+    struct CompressedFormatInfo
+    {
+        GLenum internalFormat;  /**< OpenGL ES internal format. */
+        int blockWidth;         /**< Width of a block in texels. */
+        int blockHeight;        /**< Height of a block in texels. */
+        int bytesPerBlock;      /**< Size of a block in bytes. */
+        unsigned int vkFormat;  /**< Equivalent VkFormat used by KTX2 files, 0 if there is none. */
+    };
+
+    /**
+     * \brief Compressed texture stored in a single KTX (version 1) or KTX2 container.
+     *
+     * One file holds every mipmap level, cube map face and array layer of the texture, so a texture is loaded
+     * with a single open instead of one file per level. The file is read through AssetFile: unless the levels are
+     * supercompressed they are uploaded straight from the mapping without being copied.
+     *
+     * ETC1, ETC2/EAC and ASTC LDR formats are supported. KTX2 files may use ZLIB supercompression,
+     * and Zstandard supercompression when built with KTX_SUPPORT_ZSTD defined. BasisLZ is not supported.
+     */
+    class KTXTexture
+    {
+    public:
+        KTXTexture();
+
+        /**
+         * \brief Open a KTX or KTX2 file and locate all of its images.
+         *
+         * \param[in] filename Path of the file.
+         * \return true on success. On failure getError() describes the problem.
+         */
+        bool load(const char *filename);
+
+        /**
+         * \brief Create a texture object holding every image of the file.
+         *
+         * On OpenGL ES 3.0 the storage is allocated with glTexStorage2D/3D and filled with glCompressedTexSubImage2D/3D.
+         * On OpenGL ES 2.0 every level is uploaded with glCompressedTexImage2D; array textures are not available.
+         * The new texture is left bound to getTarget().
+         * \param[out] textureID The texture ID of the texture that has been created.
+         * \return true on success. On failure no texture is created and getError() describes the problem.
+         */
+        bool upload(GLuint *textureID);
+
+        /**
+         * \brief Release the file and any decompressed levels.
+         */
+        void close(void);
+
+        /**
+         * \brief Compressed data of one image.
+         *
+         * \param[in] level Mipmap level.
+         * \param[in] layer Array layer, 0 for non-array textures.
+         * \param[in] face  Cube map face, 0 for non-cube textures.
+         * \return The image, or an empty span if it does not exist. Valid until close() or load() is called.
+         */
+        AssetSpan getImage(int level, int layer, int face) const;
+
+        /** \brief OpenGL ES internal format of the images. */
+        GLenum getInternalFormat(void) const { return format.internalFormat; }
+        /** \brief Texture target the images belong to: GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP or GL_TEXTURE_2D_ARRAY. */
+        GLenum getTarget(void) const { return target; }
+        /** \brief Width of the base level. */
+        int getWidth(void) const { return width; }
+        /** \brief Height of the base level. */
+        int getHeight(void) const { return height; }
+        /** \brief Number of mipmap levels stored in the file. */
+        int getNumberOfLevels(void) const { return (int)levels.size(); }
+        /** \brief Number of array layers, 1 for non-array textures. */
+        int getNumberOfLayers(void) const { return layers; }
+        /** \brief Number of cube map faces, 1 for non-cube textures. */
+        int getNumberOfFaces(void) const { return faces; }
+        /** \brief Description of the last failure, or an empty string. */
+        const char *getError(void) const { return error.c_str(); }
+
+        /**
+         * \brief Look up the block layout of a compressed format.
+         *
+         * \param[in] internalFormat OpenGL ES internal format.
+         * \return The layout, or NULL if the format is not an ETC1, ETC2/EAC or 2D ASTC format.
+         */
+        static const CompressedFormatInfo *getFormatInfo(GLenum internalFormat);
+
+        /**
+         * \brief Look up the block layout of a compressed format by its VkFormat, as used in KTX2 files.
+         *
+         * \param[in] vkFormat VkFormat value.
+         * \return The layout, or NULL if the format is not supported.
+         */
+        static const CompressedFormatInfo *getFormatInfoFromVkFormat(unsigned int vkFormat);
+
+        /**
+         * \brief Size in bytes of one compressed image.
+         *
+         * \param[in] info   Block layout of the format.
+         * \param[in] width  Width of the image in texels.
+         * \param[in] height Height of the image in texels.
+         */
+        static size_t getImageSize(const CompressedFormatInfo &info, int width, int height);
+
+    private:
+        /** \brief Location of the images of one mipmap level. */
+        struct Level
+        {
+            const unsigned char *data;  /**< First image of the level. */
+            size_t imageSize;           /**< Size of one image (one face of one layer). */
+            size_t imageStride;         /**< Distance between consecutive images, including padding. */
+        };
+
+        bool loadKTX1(void);
+        bool loadKTX2(void);
+        bool fail(const std::string &message);
+
+        AssetFile file;
+        CompressedFormatInfo format;
+        GLenum target;
+        int width;
+        int height;
+        int layers;
+        int faces;
+        std::vector<Level> levels;
+        /* Storage for levels which had to be decompressed. */
+        std::vector<std::vector<unsigned char> > inflatedLevels;
+        std::string error;
+    };
+}
+#endif /* KTXTEXTURE_H */
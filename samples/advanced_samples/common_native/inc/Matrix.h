@@ -44,7 +44,7 @@ namespace MaliSDK
          * \param[in] right Second matrix to multiply.
          * \return The result of left * right 
          */
-        static Matrix multiply(Matrix *left, Matrix *right);
+        static Matrix multiply(const Matrix *left, const Matrix *right);
     public:       
         /**
          * \brief Get the matrix elements as a column major order array.
@@ -69,7 +69,7 @@ namespace MaliSDK
          * \param[in] right The matrix to post multiply by.
          * \return The result of matrix * right.
          */
-        Matrix operator* (Matrix right);
+        Matrix operator* (const Matrix& right) const;
 
         /**
          * \brief Overloading assingment operater to do deep copy of the Matrix elements.
@@ -95,7 +95,7 @@ namespace MaliSDK
          * \param[in] matrix The transformation matrix.
          * \return The result of matrix x vector
          */
-        static Vec4f vertexTransform(Vec4f *vector, Matrix *matrix);
+        static Vec4f vertexTransform(const Vec4f *vector, const Matrix *matrix);
 
         /**
          * \brief Transform a 3D vertex by a matrix.
@@ -103,7 +103,70 @@ namespace MaliSDK
          * \param[in] matrix The transformation matrix.
          * \return The result of matrix x vector
          */
-        static Vec3f vertexTransform(Vec3f *vector, Matrix *matrix);
+        static Vec3f vertexTransform(const Vec3f *vector, const Matrix *matrix);
+
+        /**
+         * \brief Transform an array of 3D positions by a matrix.
+         *
+         * Positions are extended with w = 1 and, as in vertexTransform(), the w component of the result is dropped.
+         * Input and output may be the same array. Strides are counted in floats.
+         * \param[in]  matrix       The transformation matrix.
+         * \param[in]  input        The first position.
+         * \param[in]  inputStride  Distance between consecutive positions, at least 3.
+         * \param[out] output       Receives the first transformed position.
+         * \param[in]  outputStride Distance between consecutive results, at least 3.
+         * \param[in]  count        Number of positions.
+         */
+        static void transformPositions(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count);
+
+        /**
+         * \brief Transform an array of 3D directions by a matrix.
+         *
+         * Same as transformPositions() with w = 0, so the translation of the matrix is ignored.
+         */
+        static void transformDirections(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count);
+
+        /**
+         * \brief Transform an array of 3D normals by a matrix.
+         *
+         * Normals are transformed by the inverse transpose of the upper 3x3 part of the matrix, so they stay
+         * perpendicular to the surface under non-uniform scaling, and are then normalized.
+         * Arguments are as in transformPositions().
+         */
+        static void transformNormals(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count);
+
+        /**
+         * \brief Transform an array of 4D vectors by a matrix.
+         *
+         * Arguments are as in transformPositions(), with strides of at least 4.
+         */
+        static void transformVectors(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count);
+
+        /**
+         * \brief Transform 3D positions stored as separate x, y and z arrays.
+         *
+         * Positions are extended with w = 1 and the w component of the result is dropped.
+         * Output arrays may be the same as the input arrays.
+         * \param[in]  matrix  The transformation matrix.
+         * \param[in]  x       x coordinates of the positions.
+         * \param[in]  y       y coordinates of the positions.
+         * \param[in]  z       z coordinates of the positions.
+         * \param[out] outputX Receives the transformed x coordinates.
+         * \param[out] outputY Receives the transformed y coordinates.
+         * \param[out] outputZ Receives the transformed z coordinates.
+         * \param[in]  count   Number of positions.
+         */
+        static void transformPositionsSoA(const Matrix *matrix, const float *x, const float *y, const float *z,
+                                          float *outputX, float *outputY, float *outputZ, int count);
+
+        /**
+         * \brief Log the throughput of the matrix and transform functions.
+         *
+         * The portable scalar code and the per-vertex vertexTransform() are timed next to the NEON or SSE2 code
+         * and the batch transforms, so the gain on a given device can be checked.
+         * \param[in] numberOfVertices Number of vertices transformed by each batch.
+         */
+        static void benchmark(int numberOfVertices);
 
         /**
          * \brief Transpose a matrix in-place.
@@ -195,7 +258,7 @@ namespace MaliSDK
          * \param[in] matrix The matrix to invert.
          * \return The inverse matrix of matrix.
          */
-        static Matrix matrixInvert(Matrix *matrix);
+        static Matrix matrixInvert(const Matrix *matrix);
 
         /**
          * \brief Calculate determinant of supplied 3x3 matrix.
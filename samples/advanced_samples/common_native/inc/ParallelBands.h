@@ -0,0 +1,42 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PARALLELBANDS_H
+#define PARALLELBANDS_H
+
+#include <cstddef>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Process independent bands of work, such as rows of an image, in parallel.
+     *
+     * Band 0 runs on the calling thread and the others on worker threads that are kept alive between
+     * calls. If fewer workers could be started than there are bands, the calling thread and the
+     * started workers share the rest, so every band has been processed when the function returns.
+     * Calls from different threads are serialised; function must not call runBands() itself.
+     * \param[in] function      Called once per band, with a pointer to that band's element.
+     * \param[in] bands         Array of numberOfBands elements of bandSize bytes each.
+     * \param[in] bandSize      Size of one element, e.g. sizeof(Band).
+     * \param[in] numberOfBands Number of elements in bands.
+     */
+    void runBands(void (*function)(void *band), void *bands, size_t bandSize, int numberOfBands);
+}
+#endif /* PARALLELBANDS_H */
@@ -24,6 +24,7 @@
 #if !defined(ANDROID)
 
 #include "EGLRuntime.h"
+#include "GLCheck.h"
 #include "VectorTypes.h"
 
 #include <cstdio>
@@ -57,9 +58,9 @@ namespace MaliSDK
     #elif defined(__arm__) && defined(__linux__)
         fbdev_window *window;
     #elif defined(__linux__)
-        Window window;
-        Display* display;
-    #endif    
+        /** Always 0: desktop Linux runs without a window system. */
+        EGLNativeWindowType window;
+    #endif
         /**
          * \brief Create a native window on the target device.
          * \param[in] width The required width of the window.
@@ -103,22 +104,12 @@ namespace MaliSDK
 
 #endif
 
-#define GL_CHECK(x) \
-    x; \
-    { \
-        GLenum glError = glGetError(); \
-        if(glError != GL_NO_ERROR) { \
-            LOGD("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1); \
-        } \
-    }
-    
-#define LOGI Platform::log 
-#define LOGE fprintf (stderr, "Error: "); Platform::log
+#define LOGI(...) do { MaliSDK::Platform::log(__VA_ARGS__); } while (0)
+#define LOGE(...) do { fprintf(stderr, "Error: "); MaliSDK::Platform::log(__VA_ARGS__); } while (0)
 #ifdef DEBUG
-#define LOGD fprintf (stderr, "Debug: "); Platform::log
+#define LOGD(...) do { fprintf(stderr, "Debug: "); MaliSDK::Platform::log(__VA_ARGS__); } while (0)
 #else
-#define LOGD
+#define LOGD(...)
 #endif
 
 #else
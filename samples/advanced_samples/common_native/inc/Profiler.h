@@ -0,0 +1,305 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <pthread.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Frame profiler with CPU and GPU scopes.
+     *
+     * Nothing is recorded until a capture is started, either with start() or, for automated runs, through
+     * the system properties (Android) or environment variables (elsewhere) below, which are read on the first frame:
+     *
+     * | Android property              | Environment variable   | Meaning                                              |
+     * |-------------------------------|------------------------|------------------------------------------------------|
+     * | debug.malisdk.profile.frames  | MALISDK_PROFILE_FRAMES | Number of frames to capture.                         |
+     * | debug.malisdk.profile.warmup  | MALISDK_PROFILE_WARMUP | Frames to skip before the capture starts.            |
+     * | debug.malisdk.profile.output  | MALISDK_PROFILE_OUTPUT | Output path without extension. Defaults to "profile" |
+     * |                               |                        | in the application's files directory on Android.     |
+     *
+     * For example: adb shell setprop debug.malisdk.profile.frames 300
+     *
+     * When the last frame of a capture ends, p50/p95/p99 statistics of the frame, CPU and GPU times are logged
+     * and written to <output>.json together with per-scope statistics, and every scope is written to
+     * <output>.trace.json in the Chrome trace event format (load it in chrome://tracing or Perfetto).
+     *
+     * CPU scopes can be opened on any thread and nest freely. GPU scopes use GL_EXT_disjoint_timer_query
+     * and must be opened and closed on the thread with the GL context, in the same frame. Time elapsed queries
+     * cannot overlap, so the query of an open scope is closed while a nested scope runs and reopened after it.
+     * Results are read three frames after they were issued, so the CPU does not wait for the GPU during a capture.
+     *
+     * Scope names are stored as pointers and must stay valid until the capture ends; string literals are best.
+     */
+    class Profiler
+    {
+    public:
+        /**
+         * \brief Summary of a set of durations, in milliseconds.
+         */
+        struct Statistics
+        {
+            int count;
+            double mean;
+            double minimum;
+            double p50;
+            double p95;
+            double p99;
+            double maximum;
+        };
+
+        /**
+         * \brief The profiler used by ProfileFrame and the scope classes.
+         */
+        static Profiler *getInstance(void);
+
+        /**
+         * \brief Current CLOCK_MONOTONIC time in nanoseconds.
+         */
+        static unsigned long long getTime(void);
+
+        /**
+         * \brief Read a debug setting: an Android system property, or an environment variable elsewhere.
+         * \param[in] propertyName Name of the system property, e.g. "debug.malisdk.profile.frames".
+         * \param[in] variableName Name of the environment variable, e.g. "MALISDK_PROFILE_FRAMES".
+         * \return The value, or an empty string if it is not set.
+         */
+        static std::string getSetting(const char *propertyName, const char *variableName);
+
+        /**
+         * \brief Capture a number of frames.
+         * \param[in] numberOfFrames Frames to record.
+         * \param[in] outputPath     Path of the reports, without extension. NULL to only log the summary.
+         * \param[in] warmupFrames   Frames to skip before recording starts.
+         */
+        void start(int numberOfFrames, const char *outputPath, int warmupFrames = 0);
+
+        /**
+         * \brief Whether the current frame is being recorded.
+         */
+        bool isCapturing(void) const { return capturing; }
+
+        /**
+         * \brief Mark the start of a frame. Must be called on the thread with the GL context.
+         *
+         * Frames nest: only the outermost beginFrame()/endFrame() pair counts, so a harness can frame
+         * a renderFrame() that already contains a ProfileFrame.
+         */
+        void beginFrame(void);
+
+        /**
+         * \brief Mark the end of a frame. Ends the capture after its last frame.
+         */
+        void endFrame(void);
+
+        /**
+         * \brief Whether beginFrame() has been called more often than endFrame().
+         */
+        bool isInFrame(void) const { return frameDepth > 0; }
+
+        /**
+         * \brief Open a CPU scope.
+         * \param[in] name Name of the scope.
+         * \return Handle to pass to endScope(), or -1 when not capturing.
+         */
+        int beginScope(const char *name);
+
+        /**
+         * \brief Close a CPU scope opened with beginScope().
+         */
+        void endScope(int scope);
+
+        /**
+         * \brief Open a GPU scope measuring the GL commands issued until endGPUScope().
+         * \param[in] name Name of the scope.
+         * \return Handle to pass to endGPUScope(), or -1 when not capturing or timer queries are not supported.
+         */
+        int beginGPUScope(const char *name);
+
+        /**
+         * \brief Close the innermost GPU scope, which must be the one opened with the given handle.
+         */
+        void endGPUScope(int scope);
+
+        /**
+         * \brief Statistics of the last capture.
+         * \param[out] frameTime Time between the start of consecutive frames.
+         * \param[out] cpuTime   Time between beginFrame() and endFrame().
+         * \param[out] gpuTime   GPU time of the frames. count is 0 without timer queries.
+         */
+        void getStatistics(Statistics *frameTime, Statistics *cpuTime, Statistics *gpuTime) const;
+
+        /**
+         * \brief Per frame times of the last capture, in milliseconds.
+         * \param[out] cpuTimes Time between beginFrame() and endFrame() of every frame.
+         * \param[out] gpuTimes GPU time of every frame. Empty without timer queries.
+         */
+        void getFrameTimes(std::vector<double> *cpuTimes, std::vector<double> *gpuTimes) const;
+
+        /**
+         * \brief Whether a disjoint operation (e.g. a GPU frequency change) happened during the last capture.
+         */
+        bool isGPUTimeDisjoint(void) const { return isGPUDisjoint; }
+
+        /**
+         * \brief Summarize a set of durations. Sorts values.
+         */
+        static void computeStatistics(std::vector<double> &values, Statistics *statistics);
+
+        /**
+         * \brief Write a string as a quoted, escaped JSON string.
+         */
+        static void writeJSONString(FILE *file, const char *string);
+
+        /**
+         * \brief Write statistics as a JSON object, in milliseconds.
+         */
+        static void writeJSONStatistics(FILE *file, const Statistics &statistics);
+
+        /**
+         * \brief Write the statistics of the last capture as JSON.
+         */
+        bool writeReport(const char *filename) const;
+
+        /**
+         * \brief Write the scopes of the last capture in the Chrome trace event format.
+         *
+         * GPU scopes are shown on their own track, starting when their first command was issued.
+         */
+        bool writeChromeTrace(const char *filename) const;
+
+    private:
+        struct Event
+        {
+            const char *name;
+            unsigned long long start;
+            unsigned long long end;
+            unsigned long long gpuTime;
+            int frame;
+            int parent;
+            int thread;
+            bool isGPU;
+        };
+
+        struct Frame
+        {
+            unsigned long long start;
+            unsigned long long end;
+            int cpuEvent;
+            int gpuEvent;
+            unsigned int issuedStateCalls;
+            unsigned int elidedStateCalls;
+        };
+
+        struct Query
+        {
+            unsigned int id;
+            int event;
+            int frame;
+        };
+
+        bool isConfigured;
+        bool capturing;
+        bool isGPUDisjoint;
+        int warmupFramesLeft;
+        int framesToCapture;
+        int frameIndex;
+        int frameDepth;
+        std::string outputPath;
+
+        std::vector<Event> events;
+        std::vector<Frame> frames;
+        std::vector<int> gpuScopes;
+        std::vector<Query> pendingQueries;
+        std::vector<unsigned int> freeQueries;
+        unsigned int activeQuery;
+        bool isTimerQuerySupported;
+        bool isTimerQueryChecked;
+        pthread_mutex_t mutex;
+
+        Profiler(void);
+
+        void configure(void);
+        bool checkTimerQuery(void);
+        void startQuery(int event);
+        void stopQuery(void);
+        void readQueries(bool waitForAll);
+        void finishCapture(void);
+    };
+
+    /**
+     * \brief Records the lifetime of the object as a CPU scope.
+     */
+    class ProfileScope
+    {
+    private:
+        int scope;
+
+    public:
+        explicit ProfileScope(const char *name) : scope(Profiler::getInstance()->beginScope(name)) {}
+        ~ProfileScope(void) { Profiler::getInstance()->endScope(scope); }
+    };
+
+    /**
+     * \brief Records the GL commands issued during the lifetime of the object as a GPU scope.
+     */
+    class GPUProfileScope
+    {
+    private:
+        int scope;
+
+    public:
+        explicit GPUProfileScope(const char *name) : scope(Profiler::getInstance()->beginGPUScope(name)) {}
+        ~GPUProfileScope(void) { Profiler::getInstance()->endGPUScope(scope); }
+    };
+
+    /**
+     * \brief Marks the lifetime of the object as one frame. Put one at the top of the per-frame entry point.
+     *
+     * Also runs the once per frame GL error checks, see GLCheck::endFrame(), and starts a new
+     * frame of GLStateCache counters. Nested inside another frame, it does nothing.
+     */
+    class ProfileFrame
+    {
+    private:
+        bool isOutermost;
+
+    public:
+        ProfileFrame(void) : isOutermost(!Profiler::getInstance()->isInFrame()) { Profiler::getInstance()->beginFrame(); }
+        ~ProfileFrame(void);
+    };
+}
+
+#define PROFILE_SCOPE_CONCATENATE_(a, b) a##b
+#define PROFILE_SCOPE_CONCATENATE(a, b) PROFILE_SCOPE_CONCATENATE_(a, b)
+
+/** Profile the rest of the enclosing block on the CPU. */
+#define PROFILE_SCOPE(name) MaliSDK::ProfileScope PROFILE_SCOPE_CONCATENATE(profileScope, __LINE__)(name)
+
+/** Profile the GL commands issued in the rest of the enclosing block on the GPU. */
+#define PROFILE_GPU_SCOPE(name) MaliSDK::GPUProfileScope PROFILE_SCOPE_CONCATENATE(gpuProfileScope, __LINE__)(name)
+
+#endif /* PROFILER_H */
@@ -0,0 +1,216 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef PROGRAMLIBRARY_H
+#define PROGRAMLIBRARY_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+#include <EGL/egl.h>
+
+#include <pthread.h>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief The shader stages and preprocessor defines which make up one program.
+     *
+     * Stages are read from files or taken from strings. The defines are inserted after the
+     * #version line of every stage, followed by a #line directive so that compiler messages
+     * still refer to the lines of the original source.
+     */
+    class ShaderSet
+    {
+    public:
+        /** One shader stage of the program. */
+        struct Stage
+        {
+            GLenum type;          /**< GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_COMPUTE_SHADER. */
+            std::string filename; /**< File holding the source, empty if the source is given directly. */
+            std::string source;   /**< Source given directly, used when filename is empty. */
+        };
+
+        /**
+         * \brief Add a stage whose source is read from a file.
+         */
+        ShaderSet &addFile(GLenum shaderType, const std::string &filename);
+
+        /**
+         * \brief Add a stage whose source is given as a string.
+         */
+        ShaderSet &addSource(GLenum shaderType, const std::string &source);
+
+        /**
+         * \brief Add a preprocessor define to all stages.
+         */
+        ShaderSet &addDefine(const std::string &name, const std::string &value = "");
+
+        const std::vector<Stage> &getStages(void) const { return stages; }
+        const std::vector<std::pair<std::string, std::string> > &getDefines(void) const { return defines; }
+
+    private:
+        std::vector<Stage> stages;
+        std::vector<std::pair<std::string, std::string> > defines;
+    };
+
+    /**
+     * \brief Links programs from shader sets and keeps their binaries on disk.
+     *
+     * Once a program has been linked, the output of glGetProgramBinary is written to the cache directory,
+     * and on later launches the program is created from that binary instead of being compiled again.
+     * Binaries are named after a hash of the final sources of all stages, defines included, so editing
+     * a shader or changing a define selects a different file. Each file also records GL_RENDERER and
+     * GL_VERSION, and a binary written by a different driver, or one which the driver rejects, is
+     * recompiled and overwritten.
+     *
+     * Programs can be warmed up ahead of time by a background thread which links them in a context
+     * shared with the rendering context. getProgram() then hands out the warmed up program, and only
+     * waits if the program it asks for is the one being linked at that moment.
+     *
+     * Without a cache directory, or if the driver does not support program binaries, every program
+     * is compiled and linked on request.
+     */
+    class ProgramLibrary
+    {
+    public:
+        /**
+         * \brief Number of programs created by the library since it was created.
+         */
+        struct Counters
+        {
+            /** Programs created from a binary on disk. */
+            unsigned int loaded;
+            /** Programs compiled and linked from source. */
+            unsigned int compiled;
+            /** Binaries found on disk which could not be used and were replaced. */
+            unsigned int invalidated;
+            /** Programs handed out by getProgram() which were linked by the warm-up thread. */
+            unsigned int warmedUp;
+        };
+
+        ProgramLibrary(void);
+
+        /**
+         * \brief Waits for the warm-up thread. Call finishWarmUp() first to also delete unclaimed programs.
+         */
+        ~ProgramLibrary(void);
+
+        /**
+         * \brief The library shared by the application and common-native classes such as Text.
+         */
+        static ProgramLibrary *getInstance(void);
+
+        /**
+         * \brief Set the directory which holds program binaries.
+         *
+         * Must not be changed while a warm-up is running.
+         * \param[in] directory Writable directory, ending with a path separator. An empty string disables the disk cache.
+         */
+        void setCacheDirectory(const std::string &directory);
+
+        /**
+         * \brief Create a linked program from a shader set.
+         *
+         * Requires a current context. The caller owns the returned program.
+         * \param[in] shaderSet Stages and defines of the program.
+         * \return The program, or 0 if a stage could not be read, did not compile or the program did not link.
+         */
+        GLuint getProgram(const ShaderSet &shaderSet);
+
+        /**
+         * \brief Start linking programs on a background thread.
+         *
+         * Creates a context shared with the one current on the calling thread. Programs are processed in order;
+         * getProgram() takes over any program the thread has not started yet.
+         * \param[in] shaderSets Programs to warm up.
+         * \return true if the thread was started, false if a warm-up is already running or no shared context could be created.
+         */
+        bool startWarmUp(const std::vector<ShaderSet> &shaderSets);
+
+        /**
+         * \brief Wait for the warm-up thread to finish and delete the programs nobody asked for.
+         *
+         * Requires the context which was current when startWarmUp() was called.
+         */
+        void finishWarmUp(void);
+
+        /**
+         * \brief Counters since the library was created.
+         */
+        Counters getCounters(void);
+
+    private:
+        /** A shader set with its files read and its defines applied. */
+        struct PreparedProgram
+        {
+            std::vector<GLenum> types;
+            std::vector<std::string> sources;
+            unsigned long long hash;
+        };
+
+        /* The warm-up thread hands out programs it linked, so copying the library would make them ambiguous. */
+        ProgramLibrary(const ProgramLibrary &);
+        ProgramLibrary &operator=(const ProgramLibrary &);
+
+        void initializeDriver(void);
+        bool prepare(const ShaderSet &shaderSet, PreparedProgram *program) const;
+        GLuint build(const PreparedProgram &program);
+        GLuint loadBinary(const PreparedProgram &program, bool *invalid) const;
+        void saveBinary(const PreparedProgram &program, GLuint programID) const;
+        std::string getBinaryFilename(const PreparedProgram &program) const;
+
+        static void *warmUpThreadEntry(void *argument);
+        void warmUp(void);
+        void joinWarmUp(bool cancel);
+
+        std::string cacheDirectory;
+        bool driverInitialized;
+        bool binariesSupported;
+        std::string driverIdentity;
+        std::vector<GLint> binaryFormats;
+
+        pthread_mutex_t mutex;
+        pthread_cond_t condition;
+        Counters counters;
+
+        /* State shared with the warm-up thread, guarded by mutex. */
+        pthread_t thread;
+        bool threadStarted;
+        bool stopRequested;
+        std::vector<PreparedProgram> queue;
+        std::set<unsigned long long> queued;
+        bool busy;
+        unsigned long long busyHash;
+        std::map<unsigned long long, GLuint> warmedUp;
+
+        EGLDisplay display;
+        EGLContext warmUpContext;
+        EGLSurface warmUpSurface;
+    };
+}
+#endif /* PROGRAMLIBRARY_H */
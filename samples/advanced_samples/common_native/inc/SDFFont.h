@@ -0,0 +1,271 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SDF_FONT_H
+#define SDF_FONT_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#else 
+#error "GLES_VERSION must be defined as either 2 or 3"
+#endif
+
+#include <string>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Coverage image of a single glyph, as provided by a GlyphSource.
+     *
+     * All sizes are in font units, which are the pixels of the source images.
+     */
+    struct GlyphImage
+    {
+        /** Width of the image. May be 0 for glyphs without ink, such as a space. */
+        int width;
+        /** Height of the image. */
+        int height;
+        /** Distance from the pen position to the left edge of the image. */
+        float bearingX;
+        /** Distance from the baseline up to the bottom edge of the image. */
+        float bearingY;
+        /** Distance the pen moves after the glyph. */
+        float advance;
+        /** width * height coverage values, top row first. Values of 128 and above are inside the glyph. */
+        std::vector<unsigned char> coverage;
+    };
+
+    /**
+     * \brief Provides glyph images to SDFFont.
+     *
+     * Implement this to build atlases from any rasteriser, for example glyphs rendered offline at a large size.
+     */
+    class GlyphSource
+    {
+    public:
+        virtual ~GlyphSource(void) {}
+
+        /**
+         * \brief Distance between two lines of text, in font units.
+         */
+        virtual float getLineHeight(void) const = 0;
+
+        /**
+         * \brief A string which changes whenever the glyphs produced by this source change.
+         *
+         * Used to decide whether a cached atlas is still valid.
+         */
+        virtual std::string getIdentifier(void) const = 0;
+
+        /**
+         * \brief Get the image of a glyph.
+         * \param[in]  codePoint Unicode code point of the glyph.
+         * \param[out] image     Receives the glyph.
+         * \return false if the source has no glyph for the code point.
+         */
+        virtual bool getGlyph(unsigned int codePoint, GlyphImage *image) = 0;
+    };
+
+    /**
+     * \brief GlyphSource reading a bitmap font laid out as a grid of equally sized cells, such as font.raw.
+     *
+     * Cells hold consecutive code points, left to right and top to bottom. A texel is inside a glyph when its alpha is 128 or above.
+     */
+    class BitmapFontGlyphSource : public GlyphSource
+    {
+    private:
+        std::string filename;
+        int textureWidth;
+        int textureHeight;
+        int cellWidth;
+        int cellHeight;
+        unsigned int firstCodePoint;
+        unsigned char *textureData;
+
+    public:
+        /**
+         * \brief Load an RGBA bitmap font.
+         * \param[in] filename       Path of the raw RGBA texture.
+         * \param[in] textureWidth   Width of the texture in texels.
+         * \param[in] textureHeight  Height of the texture in texels.
+         * \param[in] cellWidth      Width of one character cell in texels.
+         * \param[in] cellHeight     Height of one character cell in texels.
+         * \param[in] firstCodePoint Code point of the top left cell.
+         */
+        BitmapFontGlyphSource(const char *filename, int textureWidth, int textureHeight, int cellWidth, int cellHeight, unsigned int firstCodePoint);
+
+        virtual ~BitmapFontGlyphSource(void);
+
+        virtual float getLineHeight(void) const;
+        virtual std::string getIdentifier(void) const;
+        virtual bool getGlyph(unsigned int codePoint, GlyphImage *image);
+    };
+
+    /**
+     * \brief Placement of a glyph in an SDFFont atlas.
+     *
+     * Metrics are in font units and describe the whole atlas rectangle, including the distance field border.
+     */
+    struct SDFGlyph
+    {
+        unsigned int codePoint;
+        /** Rectangle in the atlas, in texels. Empty for glyphs without ink. */
+        unsigned short atlasX, atlasY, atlasWidth, atlasHeight;
+        /** Offset of the rectangle's left edge from the pen position. */
+        float left;
+        /** Offset of the rectangle's bottom edge from the baseline. */
+        float bottom;
+        /** Size of the rectangle. */
+        float width, height;
+        /** Distance the pen moves after the glyph. */
+        float advance;
+    };
+
+    /**
+     * \brief Single channel signed distance field atlas for any set of glyphs.
+     *
+     * Every glyph is stored once, at a fixed number of texels per line, as the distance to its outline:
+     * 128 lies on the outline and each step of 127 / spread is one texel further in or out.
+     * Thresholding this with a smooth step in the fragment shader gives sharp edges at any text size, so
+     * a single small atlas replaces a bitmap font per size.
+     *
+     * Generating an atlas takes a few milliseconds per glyph. Use create() to generate it once and keep it in
+     * a cache file, or save() it offline and ship the file with the application.
+     */
+    class SDFFont
+    {
+    private:
+        int atlasWidth;
+        int atlasHeight;
+        int spread;
+        float lineHeight;
+        float texelsPerUnit;
+        std::vector<unsigned char> atlas;
+        std::vector<SDFGlyph> glyphs;
+        std::string key;
+
+        static std::string makeKey(const GlyphSource &source, const std::vector<unsigned int> &codePoints, int texelsPerLine, int spread);
+        static void distanceTransform(double *values, int count, int stride, double *line, double *envelope, int *parabolas);
+        void renderGlyph(const GlyphImage &image, const SDFGlyph &glyph);
+
+    public:
+        /**
+         * \brief Create an empty font.
+         */
+        SDFFont(void);
+
+        /**
+         * \brief Build the atlas from a glyph source.
+         * \param[in] source        Provides the glyph images.
+         * \param[in] codePoints    Glyphs to put in the atlas. Duplicates are ignored, missing glyphs are logged and skipped.
+         * \param[in] texelsPerLine Height of a line of text in the atlas, in texels. Sets how much detail is kept.
+         * \param[in] spread        Largest distance stored, in atlas texels. Also the border kept around every glyph.
+         * \return false if no glyph could be added or they did not fit in the largest atlas.
+         */
+        bool generate(GlyphSource *source, const std::vector<unsigned int> &codePoints, int texelsPerLine = 32, int spread = 4);
+
+        /**
+         * \brief Load an atlas written by save().
+         * \param[in] filename Path of the atlas file.
+         * \return false if the file could not be read or is not an atlas.
+         */
+        bool load(const char *filename);
+
+        /**
+         * \brief Write the atlas to a file.
+         * \param[in] filename Path of the file to create.
+         * \return false if the file could not be written.
+         */
+        bool save(const char *filename) const;
+
+        /**
+         * \brief Load the atlas from a cache file, or generate it and write the cache file if that is missing or out of date.
+         *
+         * The cache is keyed on the source identifier, the code points and the generation settings.
+         * \param[in] source        Provides the glyph images when the cache cannot be used.
+         * \param[in] codePoints    As in generate().
+         * \param[in] cacheFilename Path of the cache file. Must be writable for the cache to be created.
+         * \param[in] texelsPerLine As in generate().
+         * \param[in] spread        As in generate().
+         * \return false if the atlas could neither be loaded nor generated.
+         */
+        bool create(GlyphSource *source, const std::vector<unsigned int> &codePoints, const char *cacheFilename, int texelsPerLine = 32, int spread = 4);
+
+        /**
+         * \brief Upload the atlas to a new texture with linear filtering.
+         *
+         * The distance is in the red channel: GL_R8 on OpenGL ES 3.0, GL_LUMINANCE on OpenGL ES 2.0.
+         * \return The texture name, or 0 if the font is empty.
+         */
+        GLuint createTexture(void) const;
+
+        /**
+         * \brief Find the glyph for a code point.
+         * \return NULL if the glyph is not in the atlas.
+         */
+        const SDFGlyph *findGlyph(unsigned int codePoint) const;
+
+        /**
+         * \brief Distance between two lines of text, in font units.
+         */
+        float getLineHeight(void) const { return lineHeight; }
+
+        /**
+         * \brief Largest distance stored in the atlas, in texels.
+         */
+        int getSpread(void) const { return spread; }
+
+        int getAtlasWidth(void) const { return atlasWidth; }
+        int getAtlasHeight(void) const { return atlasHeight; }
+
+        /**
+         * \brief The atlas texels, top row first.
+         */
+        const unsigned char *getAtlas(void) const { return atlas.empty() ? NULL : &atlas[0]; }
+
+        /**
+         * \brief Append the code points of a UTF-8 string to a list.
+         *
+         * Useful to collect every character used by the localised strings of an application.
+         * \param[in]     string     Null terminated UTF-8 string.
+         * \param[in,out] codePoints List to append to.
+         */
+        static void addCodePoints(const char *string, std::vector<unsigned int> *codePoints);
+
+        /**
+         * \brief Append a range of code points to a list.
+         * \param[in]     first      First code point of the range.
+         * \param[in]     last       Last code point of the range, included.
+         * \param[in,out] codePoints List to append to.
+         */
+        static void addCodePoints(unsigned int first, unsigned int last, std::vector<unsigned int> *codePoints);
+
+        /**
+         * \brief Decode the next code point of a UTF-8 string.
+         * \param[in,out] string Position in the string. Moved past the decoded character.
+         * \return The code point, 0 at the end of the string, or U+FFFD for malformed input.
+         */
+        static unsigned int decodeUTF8(const char **string);
+    };
+}
+#endif /* SDF_FONT_H */
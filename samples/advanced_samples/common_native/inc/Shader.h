@@ -29,6 +29,8 @@
 #error "GLES_VERSION must be defined as either 2 or 3"
 #endif
 
+#include "AssetFile.h"
+
 namespace MaliSDK
 {
     /**
@@ -38,11 +40,14 @@ namespace MaliSDK
     {
     private:
         /**
-         * \brief Load shader source from a file into memory.
+         * \brief Open a shader source file.
+         *
+         * The source is not copied: it can be passed to glShaderSource together with its length straight from the file.
          * \param[in] filename File name of the shader to load.
-         * \return A character array containing the contents of the shader source file. 
+         * \param[out] file Receives the opened file. The source stays valid until the file is closed.
+         * \return true on success, false if the file could not be read or is empty.
          */
-        static char *loadShader(const char *filename);
+        static bool loadShader(const char *filename, AssetFile *file);
     public:
         /**
          * \brief Create shader, load in source, compile, and dump debug as necessary.
@@ -55,6 +60,21 @@ namespace MaliSDK
          * \param[in] shaderType Passed to glCreateShader to define the type of shader being processed. Must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
          */
         static void processShader(GLuint *shader, const char *filename, GLint shaderType);
+
+        /**
+         * \brief Create and compile a shader from sources held in memory.
+         *
+         * The source strings are concatenated by OpenGL ES, so defines or other preamble can be passed
+         * in front of the file contents without copying them.
+         * If compilation fails the source and the compilation log are printed and the shader is deleted.
+         * \param[out] shader Receives the shader ID of the newly compiled shader, or 0 on failure.
+         * \param[in] shaderType Passed to glCreateShader to define the type of shader being processed.
+         * \param[in] count Number of source strings.
+         * \param[in] strings Source strings.
+         * \param[in] lengths Length of each source string, or NULL if all of them are null-terminated.
+         * \return true on success, false if the shader did not compile.
+         */
+        static bool compileShader(GLuint *shader, GLenum shaderType, GLsizei count, const char * const *strings, const GLint *lengths);
     };
 }
 #endif /* SHADER_H */
\ No newline at end of file
@@ -21,7 +21,9 @@
 #ifndef TEXT_H
 #define TEXT_H
 
+#include "GLStateCache.h"
 #include "Matrix.h"
+#include "SDFFont.h"
 
 #if GLES_VERSION == 2
 #include <GLES2/gl2.h>
@@ -32,6 +34,7 @@
 #endif
 
 #include <string>
+#include <vector>
 
 namespace MaliSDK
 {
@@ -40,6 +43,14 @@ namespace MaliSDK
      *
      * Uses a texture with images of alphanumeric and punctuation symbols.
      * The class converts strings into texture coordinates in order to render the correct symbol from the texture for each character of the string.
+     *
+     * All strings are drawn with a single draw call from interleaved vertices kept in buffer objects.
+     * Strings added after clear() are compared with the ones added before it, so when the same text is added
+     * again every frame nothing is rebuilt or uploaded; only strings which changed are written to the buffers.
+     * The vertex buffers are used in turn, so a buffer is not updated while the GPU may still be reading it.
+     *
+     * Constructed with an SDFFont, glyphs come from its signed distance field atlas instead of the bitmap font.
+     * Strings are then read as UTF-8, may use any glyph in the atlas and stay sharp at any scale.
      */
     class Text
     {
@@ -47,6 +58,7 @@ namespace MaliSDK
         static const std::string textureFilename;
         static const std::string vertexShaderFilename;
         static const std::string fragmentShaderFilename;
+        static const std::string distanceFieldFragmentShaderFilename;
         
         /**
          * \brief Scaling factor to use when rendering the text. 
@@ -58,21 +70,62 @@ namespace MaliSDK
         
 
         
+        /** Number of vertex buffers used in turn. */
+        static const int numberOfVertexBuffers = 3;
+
+        /** Interleaved vertex of a glyph quad. */
+        struct TextVertex
+        {
+            GLfloat x, y;
+            GLfloat s, t;
+            GLubyte red, green, blue, alpha;
+        };
+
+        /** A string as it was last added, with the characters it occupies in the vertex buffers. */
+        struct TextString
+        {
+            std::string text;
+            int xPosition;
+            int yPosition;
+            GLubyte color[4];
+            float textScale;
+            int firstCharacter;
+            int numberOfGlyphs;
+            unsigned int version;
+        };
+
         Matrix projectionMatrix;
         int numberOfCharacters;
-        float *textVertex;
-        float *textTextureCoordinates;
-        float *color;
-        GLshort *textIndex;
+        int numberOfStrings;
+        std::vector<TextString> strings;
+        std::vector<TextVertex> vertices;
+        unsigned int nextVersion;
+
+        GLuint vertexBufferIDs[numberOfVertexBuffers];
+        std::vector<unsigned int> uploadedVersions[numberOfVertexBuffers];
+        int currentVertexBuffer;
+        GLuint indexBufferID;
+        int bufferCapacity;
+#if GLES_VERSION == 3
+        GLuint vertexArrayIDs[numberOfVertexBuffers];
+#endif
         int m_iLocPosition;
         int m_iLocProjection;
         int m_iLocTextColor;
         int m_iLocTexCoord;
         int m_iLocTexture;
-        GLuint vertexShaderID;
-        GLuint fragmentShaderID;
         GLuint programID;
         GLuint textureID;
+        const SDFFont *font;
+        GLStateCache *stateCache;
+
+        void initialize(const char *resourceDirectory, const std::string &fragmentShaderName, int windowWidth, int windowHeight);
+        int addBitmapGlyphs(const TextString &textString, TextVertex *quads);
+        int addDistanceFieldGlyphs(const TextString &textString, TextVertex *quads);
+        void reserveBuffers(int characters);
+        void setVertexAttributes(void);
+        void bindBuffer(GLenum target, GLuint buffer);
+        void enableVertexAttribArray(GLuint index);
 
     public: 
 
@@ -94,6 +147,15 @@ namespace MaliSDK
          * \param[in] windowHeight The height of the window (in pixles) that the text is being used in.
          */
         Text(const char * resourceDirectory, int windowWidth, int windowHeight);
+
+        /**
+         * \brief Constructor for Text drawing glyphs from a signed distance field font.
+         * \param[in] resourceDirectory Path to the resources. Where the shaders are located.
+         * \param[in] windowWidth The width of the window (in pixles) that the text is being used in.
+         * \param[in] windowHeight The height of the window (in pixles) that the text is being used in.
+         * \param[in] font The glyph atlas. Not copied, must outlive the Text. A line of text is textureCharacterHeight pixels high at a scale of 1.
+         */
+        Text(const char * resourceDirectory, int windowWidth, int windowHeight, const SDFFont *font);
         
         /**
          * \brief Default destructor.
@@ -101,9 +163,10 @@ namespace MaliSDK
         virtual ~Text(void);
         
         /**
-         * \brief Removes the current string from the class.
+         * \brief Removes the current strings from the class.
          *
          * Should be called before adding a new string to render using addString().
+         * The removed strings are remembered, so adding them again afterwards costs almost nothing.
          */
         void clear(void);
 
@@ -116,8 +179,9 @@ namespace MaliSDK
          * \param[in] green The green component of the text colour (accepts values 0-255).
          * \param[in] blue The blue component of the text colour (accepts values 0-255).
          * \param[in] alpha The alpha component of the text colour (accepts values 0-255). Affects the transparency of the text.
+         * \param[in] textScale Size of the text relative to the font texture. Use with a distance field font to draw large text without blurring.
          */
-        void addString(int xPosition, int yPosition, const char *string, int red, int green, int blue, int alpha);
+        void addString(int xPosition, int yPosition, const char *string, int red, int green, int blue, int alpha, float textScale = 1.0f);
 
         /**
          * \brief Draw the text to the screen.
@@ -125,6 +189,16 @@ namespace MaliSDK
          * Should be called each time through the render loop so that the text is drawn every frame.
          */
         void draw(void);
+
+        /**
+         * \brief Set the state cache the application changes GL state through.
+         *
+         * With a cache, draw() binds its program, buffers and texture through it and leaves them
+         * bound, instead of binding them directly and unbinding them again after every draw.
+         * The cache is invalidated, as Text changed GL state directly while it was created.
+         * \param[in] cache The cache to use, or NULL to bind state directly.
+         */
+        void setStateCache(GLStateCache *cache);
     };
 }
 #endif /* TEXT_H */
\ No newline at end of file
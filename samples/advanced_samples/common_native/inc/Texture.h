@@ -21,7 +21,9 @@
 #ifndef TEXTURE_H
 #define TEXTURE_H
 
+#include "AssetFile.h"
 #include "ETCHeader.h"
+#include "TextureFormats.h"
 
 #if GLES_VERSION == 2
 #include <GLES2/gl2.h>
@@ -40,19 +42,19 @@ namespace MaliSDK
     {
     private:
         /**
-         * \brief Uses glGetIntegerv to get the number of compressed texture formats and the formats themselves.
-         
-         * Calls glGetIntegerv with GL_NUM_COMPRESSED_TEXTURE_FORMATS and GL_COMPRESSED_TEXTURE_FORMATS.
-         * \param[out] textureFormats Pointer to the array of texture formats.
-         * \param[out] numberOfTextureFormats Pointer to the number of compressed texture formats.
+         * \brief Decode a KTX or KTX2 file on the CPU and upload it as an uncompressed RGBA8 texture.
+         *
+         * \param[in] filename The filename of the KTX or KTX2 file. Its format must be supported by ETCDecoder.
+         * \param[out] textureID The texture ID of the texture that has been loaded.
+         * \return true on success, false if the file could not be loaded or decoded.
          */
-        static void getCompressedTextureFormats(GLint **textureFormats, int* numberOfTextureFormats);
+        static bool loadTranscodedKTX(const char *filename, GLuint *textureID);
     public:
         /**
          * \brief Reports whether or not ETC (Ericsson Texture Compression) is supported.
          *
-         * Uses getCompressedTextureFormats to get the list of supported compression 
-         * formats and then checks to see if any of them are GL_ETC1_RGB8_OES.
+         * Uses the capabilities recorded by TextureFormats, which probes the context only once.
+         * On OpenGL ES 3.0 ETC1 textures are always supported as a subset of ETC2.
          * \param[in] verbose If true, prints out the number of supported texture compression formats and then lists the formats supported.
          */
         static bool isETCSupported(bool verbose = false);
@@ -96,19 +98,33 @@ namespace MaliSDK
         /**
          * \brief Load texture data from a file into memory.
          *
+         * The file is read through AssetFile and copied into a buffer owned by the caller.
+         * Use AssetFile directly to upload from the file without the copy.
          * \param[in] filename The filename of the texture to load.
-         * \param[out] textureData Pointer to the texture that has been loaded.
+         * \param[out] textureData Pointer to the texture that has been loaded. Must be released with free(). Set to NULL on failure.
+         * \return true on success, false if the file could not be read.
          */
-        static void loadData(const char *filename, unsigned char **textureData);
+        static bool loadData(const char *filename, unsigned char **textureData);
 
         /**
          * \brief Load header and texture data from a pkm file into memory.
          *
          * \param[in] filename The filename of the texture to load.
          * \param[out] etcHeader Pointer to the header that has been loaded.
-         * \param[out] textureData Pointer to the texture that has been loaded.      
+         * \param[out] textureData Pointer to the texture that has been loaded. Points 16 bytes into a buffer allocated with malloc().
+         * \return true on success, false if the file could not be read or is not a pkm file.
+         */
+        static bool loadPKMData(const char *filename, ETCHeader* etcHeader, unsigned char **textureData);
+
+        /**
+         * \brief Parse the header of a pkm file and locate its texture data without copying it.
+         *
+         * \param[in] file An open pkm file.
+         * \param[out] etcHeader Pointer to the header that has been parsed.
+         * \param[out] textureData The compressed texture data inside the file. Valid until file is closed.
+         * \return true on success, false if the file is not a pkm file or is truncated.
          */
-        static void loadPKMData(const char *filename, ETCHeader* etcHeader, unsigned char **textureData);
+        static bool loadPKMData(const AssetFile &file, ETCHeader* etcHeader, AssetSpan *textureData);
 
         /**
          * \brief Load compressed mipmaps into memory
@@ -121,8 +137,33 @@ namespace MaliSDK
          * \param[in] filenameSuffix Any suffix to the mipmap filenames. Most commonly used for file extensions.
          * For example, if filenameSuffix = ".pkm", this method will append ".pkm" to all the files it tries to load.
          * \param[out] textureID The texture ID of the texture that has been loaded.
+         * \return true on success, false if any of the levels could not be loaded, in which case no texture is left behind and textureID is 0.
+         */
+        static bool loadCompressedMipmaps(const char *filenameBase, const char *filenameSuffix, GLuint *textureID);
+
+        /**
+         * \brief Load a compressed texture with all of its mipmap levels from a single KTX or KTX2 file.
+         *
+         * Unlike loadCompressedMipmaps, which opens one PKM file per level, every level, face and array layer
+         * is read from one file. See KTXTexture for the supported formats.
+         * \param[in] filename The filename of the KTX or KTX2 file.
+         * \param[out] textureID The texture ID of the texture that has been loaded. It is left bound to its target.
+         * \return true on success, false if the file could not be loaded.
+         */
+        static bool loadKTX(const char *filename, GLuint *textureID);
+
+        /**
+         * \brief Load the most suitable encoding of a texture asset.
+         *
+         * The variant is chosen with TextureFormats::selectVariant in its default order: ASTC 6x6, other ASTC, ETC2/EAC, then ETC1.
+         * If the device supports none of them, a variant which can be decoded on the CPU is transcoded to RGBA8 instead.
+         * \param[in] variants Encodings available in the asset package, each stored in a KTX or KTX2 file.
+         * \param[in] numberOfVariants Number of entries in variants.
+         * \param[out] textureID The texture ID of the texture that has been loaded.
+         * \param[in] requiredChannels TextureChannels the asset needs. Variants which would drop one of them are not loaded.
+         * \return true on success, false if no variant could be loaded.
          */
-        static void loadCompressedMipmaps(const char *filenameBase, const char *filenameSuffix, GLuint *textureID);
+        static bool loadBestVariant(const TextureVariant *variants, int numberOfVariants, GLuint *textureID, unsigned int requiredChannels = 0);
 
         /**
          * \brief Copies float pixel data of one line of the image from source to
@@ -0,0 +1,159 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef TEXTUREFORMATS_H
+#define TEXTUREFORMATS_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#else 
+#error "GLES_VERSION must be defined as either 2 or 3"
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Channels of a texture asset which its encoding has to keep, beyond RGB.
+     */
+    enum TextureChannels
+    {
+        TEXTURE_CHANNELS_ALPHA = 1 << 0, /**< The asset has meaningful alpha. */
+        TEXTURE_CHANNELS_SRGB  = 1 << 1  /**< The asset's colours are sRGB encoded. */
+    };
+
+    /**
+     * \brief One encoding of a texture asset, stored in its own KTX or KTX2 file.
+     */
+    struct TextureVariant
+    {
+        const char *filename;   /**< Path of the file. */
+        GLenum internalFormat;  /**< Compressed format of the data in the file. */
+    };
+
+    /**
+     * \brief Compressed texture formats and extensions supported by the current context.
+     *
+     * The context is probed once, the first time getInstance() is called, so later queries do not touch OpenGL ES.
+     * ETC2/EAC formats are always reported on OpenGL ES 3.0, where they are part of the core specification.
+     */
+    class TextureFormats
+    {
+    public:
+        /**
+         * \brief Access the capabilities of the current context, probing it on the first call.
+         *
+         * Must be called with a current context.
+         */
+        static const TextureFormats &getInstance(void);
+
+        /**
+         * \brief Forget the probed capabilities, for example after the context has been recreated.
+         */
+        static void invalidate(void);
+
+        /**
+         * \brief Reports whether a compressed format can be used with glCompressedTexImage2D.
+         * \param[in] internalFormat OpenGL ES internal format.
+         */
+        bool isFormatSupported(GLenum internalFormat) const;
+
+        /**
+         * \brief Reports whether an extension is exposed by the context.
+         * \param[in] name Full name of the extension, for example "GL_KHR_texture_compression_astc_ldr".
+         */
+        bool hasExtension(const char *name) const;
+
+        /** \brief ETC1 (GL_ETC1_RGB8_OES) textures can be used. */
+        bool isETC1Supported(void) const { return etc1; }
+        /** \brief ETC2 and EAC textures can be used. */
+        bool isETC2Supported(void) const { return etc2; }
+        /** \brief Low dynamic range ASTC textures can be used. */
+        bool isASTCLDRSupported(void) const { return astcLdr; }
+        /** \brief High dynamic range ASTC textures can be used. */
+        bool isASTCHDRSupported(void) const { return astcHdr; }
+        /** \brief sRGB textures can be used. */
+        bool isSRGBSupported(void) const { return srgb; }
+
+        /**
+         * \brief Choose the variant of an asset to load on this device.
+         *
+         * Variants whose format is not supported, or which lack a channel the asset needs, are skipped. The rest are
+         * ranked by their position in formatOrder or, without one, by the default order: ASTC 6x6, other ASTC block
+         * sizes, ETC2/EAC, ETC1, then anything else. Formats missing from formatOrder rank after those listed. Between
+         * variants of the same rank the one with fewer bits per texel wins, then the earlier variant.
+         * \param[in] variants          Encodings available in the asset package.
+         * \param[in] numberOfVariants  Number of entries in variants.
+         * \param[in] requiredChannels  TextureChannels the asset needs, e.g. TEXTURE_CHANNELS_ALPHA for a texture with
+         *                              transparency. A format which would drop one of them is never chosen.
+         * \param[in] formatOrder       Internal formats, most preferred first, or NULL for the default order.
+         * \param[in] numberOfFormats   Number of entries in formatOrder.
+         * \return Index of the chosen variant, or -1 if none of them can be used directly.
+         */
+        int selectVariant(const TextureVariant *variants, int numberOfVariants, unsigned int requiredChannels = 0,
+                          const GLenum *formatOrder = NULL, int numberOfFormats = 0) const;
+
+        /**
+         * \brief Print the supported formats and the texture compression capabilities.
+         */
+        void log(void) const;
+
+        /**
+         * \brief Human readable name of a compressed format.
+         * \param[in] internalFormat OpenGL ES internal format.
+         * \return The name of the format's enumerant, or "UNKNOWN".
+         */
+        static const char *getFormatName(GLenum internalFormat);
+
+        /**
+         * \brief Storage cost of a compressed format.
+         * \param[in] internalFormat OpenGL ES internal format.
+         * \return Bits per texel, or 0 if the format is unknown.
+         */
+        static float getBitsPerTexel(GLenum internalFormat);
+
+        /**
+         * \brief Channels kept by a compressed format.
+         * \param[in] internalFormat OpenGL ES internal format.
+         * \return Combination of TextureChannels. 0 for RGB-only or unknown formats.
+         */
+        static unsigned int getFormatChannels(GLenum internalFormat);
+
+    private:
+        TextureFormats();
+        void probe(void);
+
+        std::vector<GLenum> formats;
+        std::string extensions;
+        bool etc1;
+        bool etc2;
+        bool astcLdr;
+        bool astcHdr;
+        bool srgb;
+
+        static TextureFormats *instance;
+    };
+}
+#endif /* TEXTUREFORMATS_H */
@@ -32,7 +32,7 @@ namespace MaliSDK
 {
     /**
      * \brief Provides a platform independent high resolution timer.
-     * \note The timer measures real time, not CPU time.
+     * \note The timer measures real time, not CPU time. While a Benchmark runs, it measures the simulated time.
      */
     class Timer
     {
@@ -22,6 +22,7 @@
 #define CUBE_MODEL_H
 
 #include "VectorTypes.h"
+#include "IndexedMesh.h"
 
 namespace MaliSDK
 {
@@ -47,6 +48,17 @@ namespace MaliSDK
          * \param[out] normals Deref will be used to store generated coordinates. Cannot be null.
          */
         static void getNormals(int* numberOfCoordinates, float** normals);
+
+        /**
+         * \brief Get an indexed mesh of a cube, with face normals and texture coordinates covering every face.
+         *
+         * Each face has its own 4 vertices, so the cube has 24 vertices and 36 indices.
+         * Meshes are generated once per scaling factor and shared; the caller must not delete them.
+         *
+         * \param[in] scalingFactor Scaling factor indicating size of a cube.
+         * \return The mesh.
+         */
+        static const IndexedMesh* getIndexedMesh(float scalingFactor);
     };
 }
 #endif /* CUBE_MODEL_H */
\ No newline at end of file
@@ -0,0 +1,263 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef INDEXED_MESH_H
+#define INDEXED_MESH_H
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+
+#include "VectorTypes.h"
+#include "Matrix.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Indexed triangle mesh with positions, normals and texture coordinates, as produced by the model generators.
+     *
+     * Vertices are kept in full precision and converted to one of the vertex formats when the vertex data is requested:
+     *
+     * - VERTEX_FORMAT_FLOAT: position (3 floats), normal (3 floats), texture coordinates (2 floats). 32 bytes per vertex.
+     * - VERTEX_FORMAT_QUANTISED: position (4 normalized shorts, w is always 1.0), octahedron-encoded normal
+     *   (2 normalized shorts), texture coordinates (2 normalized unsigned shorts). 16 bytes per vertex.
+     *
+     * Quantised positions are relative to the bounding box of the mesh. Multiply the model matrix by
+     * getDequantisationMatrix() to get the original positions back. Quantised normals are decoded in the
+     * vertex shader with:
+     *
+     *     vec3 decodeNormal(vec2 e)
+     *     {
+     *         vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+     *         if (n.z < 0.0)
+     *         {
+     *             n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+     *         }
+     *         return normalize(n);
+     *     }
+     *
+     * Triangles are counter-clockwise when seen from outside the shape.
+     *
+     * A mesh can hold several levels of detail, see MeshSimplifier. All levels share the vertices; each level
+     * is a range of the index list, finest first. A mesh built with addTriangle() has a single level.
+     */
+    class IndexedMesh
+    {
+        friend class MeshSimplifier;
+
+    public:
+        /**
+         * \brief Layouts in which vertex data can be requested.
+         */
+        enum VertexFormat
+        {
+            VERTEX_FORMAT_FLOAT,
+            VERTEX_FORMAT_QUANTISED
+        };
+
+        /**
+         * \brief Arguments of glVertexAttribPointer for one attribute.
+         */
+        struct VertexAttribute
+        {
+            GLint size;
+            GLenum type;
+            GLboolean normalized;
+            GLsizei offset;
+        };
+
+        /**
+         * \brief Interleaved layout of one vertex format.
+         */
+        struct VertexLayout
+        {
+            GLsizei stride;
+            VertexAttribute position;
+            VertexAttribute normal;
+            VertexAttribute uv;
+        };
+
+        /**
+         * \brief Range of the index list which draws one level of detail.
+         */
+        struct LevelOfDetail
+        {
+            /** First index of the level, for the offset argument of glDrawElements. */
+            unsigned int firstIndex;
+            unsigned int numberOfIndices;
+            /** Largest distance, in model space, by which the level may deviate from level 0. */
+            float error;
+        };
+
+        /**
+         * \brief Append a vertex.
+         * \return Index of the new vertex.
+         */
+        unsigned int addVertex(const Vec3f &position, const Vec3f &normal, const Vec2f &uv);
+
+        /**
+         * \brief Append a triangle. Triangles which cover no area, such as those at the poles of a sphere, are dropped.
+         */
+        void addTriangle(unsigned int first, unsigned int second, unsigned int third);
+
+        /**
+         * \brief Append the two triangles of a quad, given counter-clockwise.
+         */
+        void addQuad(unsigned int first, unsigned int second, unsigned int third, unsigned int fourth);
+
+        /**
+         * \brief Reorder triangles for the post-transform vertex cache, then vertices in the order they are first used.
+         *
+         * Triangles are ordered with Tom Forsyth's linear-speed vertex cache optimisation, which does not
+         * depend on the exact cache size of the GPU. Renumbering the vertices afterwards makes vertex fetches
+         * walk through the vertex buffer mostly sequentially. Vertices which no triangle uses are removed.
+         *
+         * Each level of detail is ordered on its own. Vertices are numbered starting from the coarsest level,
+         * so coarse levels only fetch from the start of the vertex buffer.
+         */
+        void optimise(void);
+
+        unsigned int getNumberOfVertices(void) const { return (unsigned int)(positions.size() / 3); }
+        unsigned int getNumberOfIndices(void) const { return (unsigned int)indices.size(); }
+
+        /** Positions, 3 floats per vertex. */
+        const std::vector<float> &getPositions(void) const { return positions; }
+        /** Unit normals, 3 floats per vertex. */
+        const std::vector<float> &getNormals(void) const { return normals; }
+        /** Texture coordinates, 2 floats per vertex. */
+        const std::vector<float> &getUVs(void) const { return uvs; }
+        /** Triangle list, 3 indices per triangle. Holds the triangles of all levels of detail. */
+        const std::vector<unsigned int> &getIndices(void) const { return indices; }
+
+        unsigned int getNumberOfLevels(void) const { return levels.empty() ? 1 : (unsigned int)levels.size(); }
+
+        /**
+         * \brief Index range and error of a level of detail. Level 0 is the full mesh.
+         */
+        LevelOfDetail getLevel(unsigned int level) const;
+
+        /**
+         * \brief Distance from the camera at which a level of detail becomes acceptable.
+         *
+         * Beyond this distance the error of the level projects to at most maximumScreenError pixels.
+         * \param[in] level              Level of detail.
+         * \param[in] projectionScale    Pixels covered by one model space unit at distance 1, see getProjectionScale().
+         * \param[in] maximumScreenError Largest acceptable error in pixels.
+         */
+        float getLevelDistance(unsigned int level, float projectionScale, float maximumScreenError) const;
+
+        /**
+         * \brief Pick the coarsest level of detail whose error projects to at most maximumScreenError pixels.
+         *
+         * \param[in] distance           Distance from the camera to the mesh, in model space units.
+         *                               Divide the view space distance by the scale of the model matrix.
+         * \param[in] projectionScale    Pixels covered by one model space unit at distance 1, see getProjectionScale().
+         * \param[in] maximumScreenError Largest acceptable error in pixels.
+         */
+        unsigned int selectLevel(float distance, float projectionScale, float maximumScreenError) const;
+
+        /**
+         * \brief Pixels covered by one unit at distance 1 from the camera.
+         *
+         * \param[in] projection     Perspective projection matrix, as created by Matrix::matrixPerspective().
+         * \param[in] viewportHeight Height of the viewport in pixels.
+         */
+        static float getProjectionScale(Matrix projection, float viewportHeight);
+
+        /**
+         * \brief Interleaved layout of a vertex format.
+         */
+        static VertexLayout getVertexLayout(VertexFormat format);
+
+        /**
+         * \brief Interleaved vertex data in the given format, ready for glBufferData.
+         */
+        void getVertexData(VertexFormat format, std::vector<unsigned char> *data) const;
+
+        /**
+         * \brief GL_UNSIGNED_SHORT if every index fits in 16 bits, GL_UNSIGNED_INT otherwise.
+         */
+        GLenum getIndexType(void) const;
+
+        /**
+         * \brief Index data of the type returned by getIndexType(), ready for glBufferData.
+         */
+        void getIndexData(std::vector<unsigned char> *data) const;
+
+        /**
+         * \brief Matrix which maps quantised positions back to the original model space.
+         */
+        Matrix getDequantisationMatrix(void) const;
+
+        /**
+         * \brief Set up and enable the vertex attributes of a vertex format for the bound array buffer.
+         *
+         * Attributes whose location is negative are skipped.
+         * \param[in] format           Format the vertex data was created in.
+         * \param[in] positionLocation Location of the position attribute.
+         * \param[in] normalLocation   Location of the normal attribute.
+         * \param[in] uvLocation       Location of the texture coordinate attribute.
+         * \param[in] offset           Offset of the vertex data in the buffer.
+         */
+        static void setVertexAttribPointers(VertexFormat format, GLint positionLocation, GLint normalLocation, GLint uvLocation, size_t offset = 0);
+
+        /**
+         * \brief Average number of vertices transformed per triangle, with a FIFO post-transform cache.
+         *
+         * 3.0 means no vertex reuse at all, 0.5 is the best a regular grid can reach.
+         * \param[in] cacheSize Number of entries in the simulated cache.
+         * \param[in] level     Level of detail to measure.
+         */
+        float getAverageCacheMissRatio(unsigned int cacheSize, unsigned int level = 0) const;
+
+        /**
+         * \brief Look up a mesh generated earlier with the same key.
+         * \return The mesh, or NULL if none was stored under the key.
+         */
+        static const IndexedMesh *findCached(const std::string &key);
+
+        /**
+         * \brief Keep a generated mesh for the lifetime of the application.
+         *
+         * \param[in] key  Generator name and parameters.
+         * \param[in] mesh Mesh allocated with new. The cache takes ownership.
+         * \return The cached mesh. If another thread stored one under the same key first, that one is returned and mesh is deleted.
+         */
+        static const IndexedMesh *storeCached(const std::string &key, IndexedMesh *mesh);
+
+    private:
+        std::vector<float> positions;
+        std::vector<float> normals;
+        std::vector<float> uvs;
+        std::vector<unsigned int> indices;
+        /* Empty for a mesh with a single level. */
+        std::vector<LevelOfDetail> levels;
+
+        void optimiseVertexOrder(void);
+        void getBounds(Vec3f *centre, Vec3f *extent) const;
+    };
+}
+#endif /* INDEXED_MESH_H */
@@ -0,0 +1,69 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef MESH_SIMPLIFIER_H
+#define MESH_SIMPLIFIER_H
+
+#include "IndexedMesh.h"
+
+namespace MaliSDK
+{
+    /**
+     * \brief Builds levels of detail for indexed meshes by quadric error edge collapse.
+     *
+     * Edges are collapsed cheapest first, where the cost of moving a vertex onto a neighbour is measured by the
+     * quadric of Garland and Heckbert: the sum of squared distances to the planes of the original triangles
+     * the vertex has absorbed. A vertex is only ever moved onto an existing vertex, so every level draws a
+     * subset of the original vertices and all levels share one vertex buffer.
+     *
+     * Collapses which would fold a triangle over, or join two sheets of the surface, are rejected. Vertices on
+     * open borders and on seams, where several vertices share a position with different normals or texture
+     * coordinates, stay in place so the mesh does not tear. The error of a level is the largest distance from
+     * a vertex of the source mesh to the triangles near the vertex it was collapsed onto.
+     */
+    class MeshSimplifier
+    {
+    public:
+        /**
+         * \brief Create a mesh with levels of detail.
+         *
+         * Level 0 holds the triangles of the source mesh. Every further level has reduction times the triangles
+         * of the previous one. Fewer levels are created when the mesh can not be simplified further,
+         * for example because all its vertices lie on seams.
+         * The result is optimised with IndexedMesh::optimise().
+         *
+         * \param[in] mesh                  Source mesh. Only its first level is used.
+         * \param[in] maximumNumberOfLevels Number of levels to create, including level 0.
+         * \param[in] reduction             Triangle count ratio between consecutive levels, between 0.0 and 1.0.
+         * \return A new mesh, which the caller must delete.
+         */
+        static IndexedMesh *createLevelsOfDetail(const IndexedMesh &mesh, unsigned int maximumNumberOfLevels, float reduction = 0.5f);
+
+        /**
+         * \brief Get levels of detail for a mesh returned by one of the model generators.
+         *
+         * Like createLevelsOfDetail(), but the result is created once per source mesh and parameters and shared;
+         * the caller must not delete it. The source mesh must live as long as the application, as the meshes
+         * returned by getIndexedMesh() of the models do.
+         */
+        static const IndexedMesh *getLevelsOfDetail(const IndexedMesh *mesh, unsigned int maximumNumberOfLevels, float reduction = 0.5f);
+    };
+}
+#endif /* MESH_SIMPLIFIER_H */
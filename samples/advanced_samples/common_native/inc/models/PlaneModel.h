@@ -23,6 +23,7 @@
 
 #include "VectorTypes.h"
 #include "Matrix.h"
+#include "IndexedMesh.h"
 
 namespace MaliSDK
 {
@@ -66,6 +67,15 @@ namespace MaliSDK
          * \param[in, out] coordinates Pointer to the verticies to be transformed. The transformed verticies will be returned in the same memory. Cannot be null.
          */
         static void transform(Matrix transform, int numberOfCoordinates, float** coordinates);
+
+        /**
+         * \brief Get an indexed mesh of the plane generated by getTriangleRepresentation(), facing +Y.
+         *
+         * The mesh is generated once and shared; the caller must not delete it.
+         *
+         * \return The mesh: 4 vertices and 6 indices.
+         */
+        static const IndexedMesh* getIndexedMesh(void);
     };
 }
 #endif /* PLANE_MODEL_H */
\ No newline at end of file
@@ -22,6 +22,7 @@
 #define SPHERE_MODEL_H
 
 #include "VectorTypes.h"
+#include "IndexedMesh.h"
 
 namespace MaliSDK
 {
@@ -69,6 +70,19 @@ namespace MaliSDK
          * \param[out] coordinates Deref will be used to store generated coordinates. Cannot be null.
          */
         static void getTriangleRepresentation(const float radius, const int numberOfSamples, int* numberOfCoordinates, float** coordinates);
+
+        /**
+         * \brief Get an optimised indexed mesh of a sphere, with normals and texture coordinates.
+         *
+         * The points are the same as in getTriangleRepresentation(). Every circle has one more vertex closing the
+         * texture seam, and the triangles which collapse at the poles are left out.
+         * Meshes are generated once per set of parameters and shared; the caller must not delete them.
+         *
+         * \param[in] radius Radius of a sphere. Has to be greater than zero.
+         * \param[in] numberOfSamples A sphere consists of numberOfSamples circles and numberOfSamples points lying on one circle. Has to be at least 2.
+         * \return The mesh, or NULL if the parameters are invalid.
+         */
+        static const IndexedMesh* getIndexedMesh(float radius, int numberOfSamples);
     };
 }
 #endif /* SPHERE_MODEL_H */
\ No newline at end of file
@@ -22,6 +22,7 @@
 #define SUPER_ELLIPSOID_MODEL_H
 
 #include "VectorTypes.h"
+#include "IndexedMesh.h"
 
 namespace MaliSDK
 {
@@ -100,6 +101,20 @@ namespace MaliSDK
          * \param[out] numberOfNormals Number of generated normal vectors.
          */
         static void create(int samples, float n1, float n2, float scale, float** roundedCubeCoordinates, float** roundedCubeNormalVectors, int* numberOfVertices, int* numberOfCoordinates, int* numberOfNormals);
+
+        /**
+         * \brief Get an optimised indexed mesh of the super ellipsoid generated by create().
+         *
+         * Every vertex of the sampling grid is stored once instead of up to six times. Texture coordinates follow
+         * the two angles. Meshes are generated once per set of parameters and shared; the caller must not delete them.
+         *
+         * \param[in] samples The number of samples around the XZ plane; half as many are taken from pole to pole. Has to be at least 2.
+         * \param[in] n1 The "squareness" of our figure - property that tells how rounded the geometry will be in XZ space.
+         * \param[in] n2 The "squareness" of our figure - property that tells how rounded the geometry will be in XY space.
+         * \param[in] scale Scale factor applied to the object.
+         * \return The mesh, or NULL if the parameters are invalid.
+         */
+        static const IndexedMesh* getIndexedMesh(int samples, float n1, float n2, float scale);
     };
 }
 #endif /* SUPER_ELLIPSOID_MODEL_H */
\ No newline at end of file
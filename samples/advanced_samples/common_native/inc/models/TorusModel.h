@@ -22,6 +22,7 @@
 #define TORUS_MODEL_H
 
 #include "VectorTypes.h"
+#include "IndexedMesh.h"
 
 namespace MaliSDK
 {
@@ -111,6 +112,20 @@ namespace MaliSDK
          * \param[out] vertices Deref will be used to sotre generated vertices. Cannot be null.
          */
         static void generateBezierVertices(float torusRadius, float circleRadius, float* vertices);
+
+        /**
+         * \brief Get an optimised indexed triangle mesh of the torus generated by generateVertices(), with normals and texture coordinates.
+         *
+         * The first circle and the first point of each circle are repeated at the end to close the texture seams.
+         * Meshes are generated once per set of parameters and shared; the caller must not delete them.
+         *
+         * \param[in] torusRadius Distance between the center of torus and the center of its tube.
+         * \param[in] circleRadius Radius of circles that model the tube.
+         * \param[in] circlesCount Number of circles in torus model. Has to be at least 3.
+         * \param[in] pointsPerCircleCount Number of points in one circle. Has to be at least 3.
+         * \return The mesh, or NULL if the parameters are invalid.
+         */
+        static const IndexedMesh* getIndexedMesh(float torusRadius, float circleRadius, unsigned int circlesCount, unsigned int pointsPerCircleCount);
     };
 }
 #endif /* TORUS_MODEL_H */
\ No newline at end of file
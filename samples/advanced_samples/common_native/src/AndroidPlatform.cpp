@@ -50,35 +50,9 @@ namespace MaliSDK
         }
     }
 
-    /**
-     * Converts the error codes into strings using the definitions found in <GLES2/gl2.h>
-     */
     const char* AndroidPlatform::glErrorToString(int glErrorCode)
     {
-        switch(glErrorCode)
-        {
-            case GL_NO_ERROR: 
-                return "GL_NO_ERROR"; 
-                break;
-            case GL_INVALID_ENUM:
-                return "GL_INVALID_ENUM"; 
-                break;
-            case GL_INVALID_VALUE: 
-                return "GL_INVALID_VALUE";
-                break;
-            case GL_INVALID_OPERATION: 
-                return "GL_INVALID_OPERATION"; 
-                break;
-            case GL_OUT_OF_MEMORY: 
-                return "GL_OUT_OF_MEMORY"; 
-                break;
-            case GL_INVALID_FRAMEBUFFER_OPERATION:
-                return "GL_INVALID_FRAMEBUFFER_OPERATION";
-                break;
-            default:   
-                return "unknown"; 
-                break;
-        }
+        return GLCheck::getErrorString(glErrorCode);
     }
 
     char* AndroidPlatform::copyString(const char* string)
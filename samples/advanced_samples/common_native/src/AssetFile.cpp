@@ -0,0 +1,212 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "AssetFile.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MaliSDK
+{
+    /* Size of the chunks used when the file cannot be mapped. */
+    static const size_t readChunkSize = 64 * 1024;
+
+    AssetFile::AssetFile()
+        : data(NULL),
+          size(0),
+          opened(false),
+          mapped(false),
+          buffer(NULL)
+    {
+    }
+
+    AssetFile::~AssetFile()
+    {
+        close();
+    }
+
+    bool AssetFile::open(const char *filename)
+    {
+        close();
+        error.clear();
+
+        if (filename == NULL)
+        {
+            error = "No filename given";
+            return false;
+        }
+
+        if (mapFile(filename) || readFile(filename))
+        {
+            opened = true;
+            return true;
+        }
+
+        return false;
+    }
+
+    void AssetFile::close(void)
+    {
+#if !defined(_WIN32)
+        if (mapped && size > 0)
+        {
+            munmap((void *)data, size);
+        }
+#endif
+        free(buffer);
+
+        data = NULL;
+        size = 0;
+        opened = false;
+        mapped = false;
+        buffer = NULL;
+    }
+
+    bool AssetFile::mapFile(const char *filename)
+    {
+#if defined(_WIN32)
+        (void)filename;
+        return false;
+#else
+        int descriptor = ::open(filename, O_RDONLY);
+        if (descriptor < 0)
+        {
+            error = std::string("Cannot open '") + filename + "': " + strerror(errno);
+            return false;
+        }
+
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            ::close(descriptor);
+            return false;
+        }
+
+        size_t fileSize = (size_t)status.st_size;
+        void *mapping = NULL;
+
+        /* mmap() rejects empty ranges, an empty file is simply an empty span. */
+        if (fileSize > 0)
+        {
+            mapping = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+
+        /* The mapping keeps its own reference to the file. */
+        ::close(descriptor);
+
+        if (mapping == MAP_FAILED)
+        {
+            return false;
+        }
+
+        if (mapping != NULL)
+        {
+            /* Assets are usually consumed front to back, so let the kernel read ahead. */
+            madvise(mapping, fileSize, MADV_SEQUENTIAL);
+        }
+
+        data = (const unsigned char *)mapping;
+        size = fileSize;
+        mapped = true;
+
+        return true;
+#endif
+    }
+
+    bool AssetFile::readFile(const char *filename)
+    {
+        FILE *file = fopen(filename, "rb");
+        if (file == NULL)
+        {
+            if (error.empty())
+            {
+                error = std::string("Cannot open '") + filename + "': " + strerror(errno);
+            }
+            return false;
+        }
+
+        error.clear();
+
+        if (fseek(file, 0, SEEK_END) != 0)
+        {
+            error = std::string("Cannot seek in '") + filename + "'";
+            fclose(file);
+            return false;
+        }
+
+        long length = ftell(file);
+        if (length < 0)
+        {
+            error = std::string("Cannot determine the size of '") + filename + "'";
+            fclose(file);
+            return false;
+        }
+        fseek(file, 0, SEEK_SET);
+
+        /* Allocate one byte more than needed so an empty file still gets a valid buffer. */
+        buffer = (unsigned char *)malloc((size_t)length + 1);
+        if (buffer == NULL)
+        {
+            error = std::string("Out of memory while reading '") + filename + "'";
+            fclose(file);
+            return false;
+        }
+
+        size_t totalRead = 0;
+        while (totalRead < (size_t)length)
+        {
+            size_t chunk = (size_t)length - totalRead;
+            if (chunk > readChunkSize)
+            {
+                chunk = readChunkSize;
+            }
+
+            size_t chunkRead = fread(buffer + totalRead, 1, chunk, file);
+            if (chunkRead == 0)
+            {
+                break;
+            }
+            totalRead += chunkRead;
+        }
+        fclose(file);
+
+        if (totalRead != (size_t)length)
+        {
+            error = std::string("Failed to read in '") + filename + "'";
+            free(buffer);
+            buffer = NULL;
+            return false;
+        }
+
+        data = buffer;
+        size = totalRead;
+
+        return true;
+    }
+}
@@ -0,0 +1,357 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Benchmark.h"
+#include "Profiler.h"
+#include "Platform.h"
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+#include <EGL/egl.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    bool Benchmark::running = false;
+    timeval Benchmark::origin;
+    long long Benchmark::simulatedFrames = 0;
+    double Benchmark::timestep = 1.0 / 60.0;
+
+    BenchmarkSample::BenchmarkSample(const char *name, bool (*setupGraphics)(int width, int height), void (*renderFrame)(void))
+        : name(name),
+          setupGraphics(setupGraphics),
+          setupGraphicsWithoutResult(NULL),
+          renderFrame(renderFrame)
+    {
+    }
+
+    BenchmarkSample::BenchmarkSample(const char *name, void (*setupGraphics)(int width, int height), void (*renderFrame)(void))
+        : name(name),
+          setupGraphics(NULL),
+          setupGraphicsWithoutResult(setupGraphics),
+          renderFrame(renderFrame)
+    {
+    }
+
+    bool BenchmarkSample::setup(int width, int height) const
+    {
+        if (setupGraphics != NULL)
+        {
+            return setupGraphics(width, height);
+        }
+
+        setupGraphicsWithoutResult(width, height);
+        return true;
+    }
+
+    Benchmark::Settings::Settings(void)
+        : width(1280),
+          height(720),
+          warmupFrames(60),
+          frames(300),
+          timestep(1.0 / 60.0)
+    {
+    }
+
+    bool Benchmark::parseArguments(int argc, char **argv, Settings *settings)
+    {
+        for (int index = 1; index < argc; index++)
+        {
+            const char *option = argv[index];
+
+            if (strncmp(option, "--", 2) != 0)
+            {
+                continue;
+            }
+
+            if (index + 1 >= argc)
+            {
+                LOGE("Benchmark: %s needs a value.\n", option);
+                return false;
+            }
+
+            const char *value = argv[++index];
+
+            if (strcmp(option, "--frames") == 0)
+            {
+                settings->frames = atoi(value);
+            }
+            else if (strcmp(option, "--warmup") == 0)
+            {
+                settings->warmupFrames = atoi(value);
+            }
+            else if (strcmp(option, "--timestep") == 0)
+            {
+                settings->timestep = atof(value);
+            }
+            else if (strcmp(option, "--width") == 0)
+            {
+                settings->width = atoi(value);
+            }
+            else if (strcmp(option, "--height") == 0)
+            {
+                settings->height = atoi(value);
+            }
+            else if (strcmp(option, "--output") == 0)
+            {
+                settings->output = value;
+            }
+            else
+            {
+                LOGE("Benchmark: unknown option %s.\n", option);
+                return false;
+            }
+        }
+
+        if (settings->frames <= 0 || settings->warmupFrames < 0 || settings->timestep <= 0.0 ||
+            settings->width <= 0 || settings->height <= 0)
+        {
+            LOGE("Benchmark: invalid settings.\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    int Benchmark::getTimeOfDay(timeval *time)
+    {
+        if (!running)
+        {
+            return gettimeofday(time, NULL);
+        }
+
+        const long long microseconds = (long long)origin.tv_usec + llround(simulatedFrames * timestep * 1e6);
+
+        time->tv_sec = origin.tv_sec + (time_t)(microseconds / 1000000);
+        time->tv_usec = (suseconds_t)(microseconds % 1000000);
+
+        return 0;
+    }
+
+    bool Benchmark::run(const BenchmarkSample &sample, const Settings &settings)
+    {
+        LOGI("Benchmark: %s, %d warm-up and %d measured frames of %.4f s at %dx%d.\n", sample.getName(),
+             settings.warmupFrames, settings.frames, settings.timestep, settings.width, settings.height);
+
+        /* The simulated clock starts at the current time, so absolute times still look plausible. */
+        gettimeofday(&origin, NULL);
+        simulatedFrames = 0;
+        timestep = settings.timestep;
+        running = true;
+        srand(1);
+
+        if (!sample.setup(settings.width, settings.height))
+        {
+            LOGE("Benchmark: setupGraphics() failed.\n");
+            running = false;
+            return false;
+        }
+
+        Profiler *profiler = Profiler::getInstance();
+        profiler->start(settings.frames, NULL, settings.warmupFrames);
+
+        /* Swap when there is a surface, as the application would; tiled GPUs render on swap. */
+        const EGLDisplay display = eglGetCurrentDisplay();
+        const EGLSurface surface = eglGetCurrentSurface(EGL_DRAW);
+
+        for (int frame = 0; frame < settings.warmupFrames + settings.frames; frame++)
+        {
+            {
+                ProfileFrame profileFrame;
+                sample.render();
+            }
+
+            if (surface != EGL_NO_SURFACE)
+            {
+                eglSwapBuffers(display, surface);
+            }
+
+            simulatedFrames++;
+        }
+
+        running = false;
+
+        const string filename = settings.output.empty() ? string(sample.getName()) + ".benchmark.json" : settings.output;
+
+        if (!writeResult(sample, settings, filename))
+        {
+            return false;
+        }
+
+        LOGI("Benchmark: wrote %s.\n", filename.c_str());
+        return true;
+    }
+
+    int Benchmark::main(const BenchmarkSample &sample, int argc, char **argv)
+    {
+        Settings settings;
+
+        if (!parseArguments(argc, argv, &settings))
+        {
+            return 1;
+        }
+
+        return run(sample, settings) ? 0 : 1;
+    }
+
+    static void writeJSONTimes(FILE *file, const char *name, vector<double> &times)
+    {
+        fprintf(file, "  \"%sFrames\": [", name);
+        for (size_t index = 0; index < times.size(); index++)
+        {
+            fprintf(file, "%s%.4f", index > 0 ? ", " : "", times[index]);
+        }
+        fprintf(file, "],\n");
+
+        /* Sorts the times, so done after writing them in frame order. */
+        Profiler::Statistics statistics;
+        Profiler::computeStatistics(times, &statistics);
+
+        fprintf(file, "  \"%sTime\": ", name);
+        Profiler::writeJSONStatistics(file, statistics);
+    }
+
+    bool Benchmark::writeResult(const BenchmarkSample &sample, const Settings &settings, const string &filename)
+    {
+        FILE *file = fopen(filename.c_str(), "w");
+
+        if (file == NULL)
+        {
+            LOGE("Benchmark: could not create %s.\n", filename.c_str());
+            return false;
+        }
+
+        const Profiler *profiler = Profiler::getInstance();
+        const char *renderer = (const char *)glGetString(GL_RENDERER);
+        vector<double> cpuTimes, gpuTimes;
+
+        profiler->getFrameTimes(&cpuTimes, &gpuTimes);
+
+        fprintf(file, "{\n  \"sample\": ");
+        Profiler::writeJSONString(file, sample.getName());
+        fprintf(file, ",\n  \"renderer\": ");
+        Profiler::writeJSONString(file, renderer != NULL ? renderer : "");
+        fprintf(file, ",\n  \"width\": %d,\n  \"height\": %d,\n  \"timestep\": %.6f,\n  \"warmupFrames\": %d,\n  \"frames\": %d,\n",
+                settings.width, settings.height, settings.timestep, settings.warmupFrames, (int)cpuTimes.size());
+        fprintf(file, "  \"unit\": \"ms\",\n  \"gpuDisjoint\": %s,\n", profiler->isGPUTimeDisjoint() ? "true" : "false");
+        writeJSONTimes(file, "cpu", cpuTimes);
+        fprintf(file, ",\n");
+        writeJSONTimes(file, "gpu", gpuTimes);
+        fprintf(file, "\n}\n");
+
+        return fclose(file) == 0;
+    }
+
+    static bool readFile(const char *filename, string *contents)
+    {
+        FILE *file = fopen(filename, "rb");
+
+        if (file == NULL)
+        {
+            LOGE("Benchmark: could not open %s.\n", filename);
+            return false;
+        }
+
+        char buffer[4096];
+        size_t length;
+
+        contents->clear();
+        while ((length = fread(buffer, 1, sizeof(buffer), file)) > 0)
+        {
+            contents->append(buffer, length);
+        }
+
+        fclose(file);
+        return true;
+    }
+
+    /* The number following "key": in the object following "object":, or -1 if there is none. Enough for result files. */
+    static double findValue(const string &json, const char *object, const char *key)
+    {
+        const size_t objectStart = json.find(string("\"") + object + "\"");
+
+        if (objectStart == string::npos)
+        {
+            return -1.0;
+        }
+
+        const size_t objectEnd = json.find('}', objectStart);
+        const size_t keyStart = json.find(string("\"") + key + "\":", objectStart);
+
+        if (keyStart == string::npos || keyStart > objectEnd)
+        {
+            return -1.0;
+        }
+
+        return atof(json.c_str() + keyStart + strlen(key) + 3);
+    }
+
+    int Benchmark::compare(const char *baselineFilename, const char *resultFilename, double threshold)
+    {
+        string baseline, result;
+
+        if (!readFile(baselineFilename, &baseline) || !readFile(resultFilename, &result))
+        {
+            return -1;
+        }
+
+        static const char *const objects[] = { "cpuTime", "gpuTime" };
+        static const char *const keys[] = { "p50", "p95" };
+        int regressions = 0;
+
+        for (int object = 0; object < 2; object++)
+        {
+            if (findValue(baseline, objects[object], "count") <= 0.0 || findValue(result, objects[object], "count") <= 0.0)
+            {
+                LOGI("Benchmark: no %s in both files, skipped.\n", objects[object]);
+                continue;
+            }
+
+            for (int key = 0; key < 2; key++)
+            {
+                const double before = findValue(baseline, objects[object], keys[key]);
+                const double after = findValue(result, objects[object], keys[key]);
+                const double change = before > 0.0 ? (after - before) / before * 100.0 : 0.0;
+                const bool isRegression = change > threshold;
+
+                LOGI("Benchmark: %s %s %.3f ms -> %.3f ms (%+.1f%%)%s\n", objects[object], keys[key], before, after, change,
+                     isRegression ? " REGRESSION" : "");
+
+                if (isRegression)
+                {
+                    regressions++;
+                }
+            }
+        }
+
+        return regressions;
+    }
+}
@@ -0,0 +1,61 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "DesktopLinuxPlatform.h"
+
+namespace MaliSDK
+{
+    Platform* DesktopLinuxPlatform::instance = NULL;
+
+    DesktopLinuxPlatform::DesktopLinuxPlatform(void)
+    {
+        window = 0;
+    }
+
+    Platform* DesktopLinuxPlatform::getInstance(void)
+    {
+        if (instance == NULL)
+        {
+            instance = new DesktopLinuxPlatform();
+        }
+        return instance;
+    }
+
+    void DesktopLinuxPlatform::createWindow(int width, int height)
+    {
+        /* Keep a surfaceless setup if one was asked for; otherwise the pbuffer stands in for the window. */
+        EGLRuntime::SurfaceType surfaceType = EGLRuntime::getSurfaceType();
+
+        if (surfaceType == EGLRuntime::SURFACE_WINDOW)
+        {
+            surfaceType = EGLRuntime::SURFACE_PBUFFER;
+        }
+        EGLRuntime::setSurfaceType(surfaceType, width, height);
+    }
+
+    Platform::WindowStatus DesktopLinuxPlatform::checkWindow(void)
+    {
+        return WINDOW_IDLE;
+    }
+
+    void DesktopLinuxPlatform::destroyWindow(void)
+    {
+    }
+}
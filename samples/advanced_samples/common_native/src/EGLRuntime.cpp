@@ -22,6 +22,7 @@
 #include "Platform.h"
 
 #include <cstdlib>
+#include <cstring>
 
 namespace MaliSDK
 {
@@ -32,6 +33,29 @@ namespace MaliSDK
     EGLSurface EGLRuntime::surface;
     EGLConfig EGLRuntime::config;
 
+    EGLint EGLRuntime::surfaceWidth = 1;
+    EGLint EGLRuntime::surfaceHeight = 1;
+#if defined(__linux__) && !defined(__arm__)
+    EGLRuntime::SurfaceType EGLRuntime::surfaceType = EGLRuntime::SURFACE_PBUFFER;
+#else
+    EGLRuntime::SurfaceType EGLRuntime::surfaceType = EGLRuntime::SURFACE_WINDOW;
+#endif
+
+    /* Whether the space separated extension list contains name. */
+    static bool hasExtension(const char *extensions, const char *name)
+    {
+        const size_t length = strlen(name);
+
+        for (const char *found = extensions != NULL ? strstr(extensions, name) : NULL; found != NULL; found = strstr(found + length, name))
+        {
+            if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
     EGLint EGLRuntime::configAttributes[] =
     {
         /* DO NOT MODIFY. */
@@ -220,6 +244,49 @@ namespace MaliSDK
         return configToReturn;
     }
 
+    EGLDisplay EGLRuntime::getHeadlessDisplay(void)
+    {
+        /* Client extensions, which are queried without a display. */
+        const char *extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = NULL;
+
+        if (hasExtension(extensions, "EGL_EXT_platform_base"))
+        {
+            getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+        }
+
+        if (getPlatformDisplay != NULL && hasExtension(extensions, "EGL_MESA_platform_surfaceless"))
+        {
+            EGLDisplay surfacelessDisplay = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+
+            if (surfacelessDisplay != EGL_NO_DISPLAY)
+            {
+                LOGD("Using the Mesa surfaceless platform.\n");
+                return surfacelessDisplay;
+            }
+        }
+
+        if (getPlatformDisplay != NULL && hasExtension(extensions, "EGL_EXT_platform_device"))
+        {
+            PFNEGLQUERYDEVICESEXTPROC queryDevices = (PFNEGLQUERYDEVICESEXTPROC)eglGetProcAddress("eglQueryDevicesEXT");
+            EGLDeviceEXT device;
+            EGLint numberOfDevices = 0;
+
+            if (queryDevices != NULL && queryDevices(1, &device, &numberOfDevices) && numberOfDevices > 0)
+            {
+                EGLDisplay deviceDisplay = getPlatformDisplay(EGL_PLATFORM_DEVICE_EXT, device, NULL);
+
+                if (deviceDisplay != EGL_NO_DISPLAY)
+                {
+                    LOGD("Using the first EGL device.\n");
+                    return deviceDisplay;
+                }
+            }
+        }
+
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+
     void EGLRuntime::initializeEGL(OpenGLESVersion requestedAPIVersion)
     {
         EGLBoolean success = EGL_FALSE;
@@ -231,9 +298,8 @@ namespace MaliSDK
         /* Linux on ARM */
         display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
 #else
-        /* Desktop Linux */
-        platform->display = XOpenDisplay(NULL);
-        display = eglGetDisplay(platform->display);
+        /* Desktop Linux, without a window system. */
+        display = getHeadlessDisplay();
 #endif
 
         if(display == EGL_NO_DISPLAY)
@@ -283,19 +349,38 @@ namespace MaliSDK
          * On ARM devices perform a strict match to ensure we get the best performance.
          * On desktop devices perform a loose match to ensure greatest compatability.
          */
+        if (surfaceType == SURFACE_NONE && !hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context"))
+        {
+            LOGI("EGL_KHR_surfaceless_context is not supported, using a %dx%d pbuffer surface instead.\n", (int)surfaceWidth, (int)surfaceHeight);
+            surfaceType = SURFACE_PBUFFER;
+        }
+
+        /* A surfaceless context can use any config. */
+        configAttributes[17] = surfaceType == SURFACE_WINDOW ? EGL_WINDOW_BIT : surfaceType == SURFACE_PBUFFER ? EGL_PBUFFER_BIT : 0;
+
 #if defined(__arm__)
         config = findConfig(true);
 #else
         config = findConfig(false);
 #endif
 
-#if defined(__linux__) && !defined(__arm__)
-        ((DesktopLinuxPlatform*)(platform))->createX11Window();
-#endif
-
         /* Create a surface. */
-        surface = eglCreateWindowSurface(display, config, (EGLNativeWindowType)(platform->window), windowAttributes);
-        if(surface == EGL_NO_SURFACE)
+        if (surfaceType == SURFACE_WINDOW)
+        {
+            surface = eglCreateWindowSurface(display, config, (EGLNativeWindowType)(platform->window), windowAttributes);
+        }
+        else if (surfaceType == SURFACE_PBUFFER)
+        {
+            const EGLint pbufferAttributes[] = { EGL_WIDTH, surfaceWidth, EGL_HEIGHT, surfaceHeight, EGL_NONE };
+
+            surface = eglCreatePbufferSurface(display, config, pbufferAttributes);
+        }
+        else
+        {
+            surface = EGL_NO_SURFACE;
+        }
+
+        if(surfaceType != SURFACE_NONE && surface == EGL_NO_SURFACE)
         {
             EGLint error = eglGetError();
             LOGE("eglGetError(): %i (0x%.4x)\n", (int)error, (int)error);
@@ -316,6 +401,18 @@ namespace MaliSDK
         }
     }
 
+    void EGLRuntime::setSurfaceType(SurfaceType type, int width, int height)
+    {
+        surfaceType = type;
+        surfaceWidth = width > 0 ? width : 1;
+        surfaceHeight = height > 0 ? height : 1;
+    }
+
+    EGLRuntime::SurfaceType EGLRuntime::getSurfaceType(void)
+    {
+        return surfaceType;
+    }
+
     void EGLRuntime::setEGLSamples(EGLint requiredEGLSamples)
     {
         configAttributes[1] = requiredEGLSamples;
@@ -328,7 +425,10 @@ namespace MaliSDK
         eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context);
         eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
         eglDestroyContext(display, context);
-        eglDestroySurface(display, surface);
+        if (surface != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(display, surface);
+        }
         eglTerminate(display);
     }
 }
\ No newline at end of file
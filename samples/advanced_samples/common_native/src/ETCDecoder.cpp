@@ -0,0 +1,629 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ETCDecoder.h"
+#include "ParallelBands.h"
+#include "Platform.h"
+#include "TextureFormats.h"
+#include "Timer.h"
+
+#include <cstring>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ETC_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ETC_USE_SSE2 1
+#endif
+
+namespace MaliSDK
+{
+    /* Intensity modifiers, indexed by table codeword. Pixel indices 0 and 1 add the two values, 2 and 3 subtract them. */
+    static const int etcModifierTable[8][2] =
+    {
+        {  2,   8 },
+        {  5,  17 },
+        {  9,  29 },
+        { 13,  42 },
+        { 18,  60 },
+        { 24,  80 },
+        { 33, 106 },
+        { 47, 183 }
+    };
+
+    /* Distances between the paint colours of the ETC2 T and H modes. */
+    static const int etc2DistanceTable[8] = { 3, 6, 11, 16, 23, 32, 41, 64 };
+
+    /* EAC modifiers, indexed by table index and 3-bit pixel index. */
+    static const int eacModifierTable[16][8] =
+    {
+        { -3, -6,  -9, -15, 2, 5, 8, 14 },
+        { -3, -7, -10, -13, 2, 6, 9, 12 },
+        { -2, -5,  -8, -13, 1, 4, 7, 12 },
+        { -2, -4,  -6, -13, 1, 3, 5, 12 },
+        { -3, -6,  -8, -12, 2, 5, 7, 11 },
+        { -3, -7,  -9, -11, 2, 6, 8, 10 },
+        { -4, -7,  -8, -11, 3, 6, 7, 10 },
+        { -3, -5,  -8, -11, 2, 4, 7, 10 },
+        { -2, -6,  -8, -10, 1, 5, 7,  9 },
+        { -2, -5,  -8, -10, 1, 4, 7,  9 },
+        { -2, -4,  -8, -10, 1, 3, 7,  9 },
+        { -2, -5,  -7, -10, 1, 4, 6,  9 },
+        { -3, -4,  -7, -10, 2, 3, 6,  9 },
+        { -1, -2,  -3, -10, 0, 1, 2,  9 },
+        { -4, -6,  -8,  -9, 3, 5, 7,  8 },
+        { -3, -5,  -7,  -9, 2, 4, 6,  8 }
+    };
+
+    /* Work description for one band of block rows. */
+    struct DecodeBand
+    {
+        GLenum               internalFormat;
+        const unsigned char *data;
+        int                  width;
+        int                  height;
+        unsigned char       *rgba;
+        int                  firstBlockRow;
+        int                  endBlockRow;
+    };
+
+    static inline int clamp(int value, int minimum, int maximum)
+    {
+        return value < minimum ? minimum : (value > maximum ? maximum : value);
+    }
+
+    static inline int extend4(int value) { return (value << 4) | value; }
+    static inline int extend5(int value) { return (value << 3) | (value >> 2); }
+    static inline int extend6(int value) { return (value << 2) | (value >> 4); }
+    static inline int extend7(int value) { return (value << 1) | (value >> 6); }
+
+    /* Sign-extend the 3-bit colour delta of the differential mode. */
+    static inline int delta3(int value)
+    {
+        return value >= 4 ? value - 8 : value;
+    }
+
+    /* 2-bit pixel index of pixel x * 4 + y, as used by ETC1 and ETC2. */
+    static inline int pixelIndex(const unsigned char *block, int pixel)
+    {
+        const unsigned int mostSignificantBits  = (block[4] << 8) | block[5];
+        const unsigned int leastSignificantBits = (block[6] << 8) | block[7];
+
+        return (((mostSignificantBits >> pixel) & 1) << 1) | ((leastSignificantBits >> pixel) & 1);
+    }
+
+    /*
+     * Clamp a block of 4 x 4 RGBA texels held as 16-bit values to [0, 255] and store it.
+     * This is where most of the per-texel work of every mode ends up, so it is done 16 channels at a time.
+     */
+    static inline void storeBlock(const short *values, unsigned char *rgba, int rgbaStride)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            const short *row = values + y * 16;
+            unsigned char *output = rgba + y * rgbaStride;
+#if defined(ETC_USE_NEON)
+            const int16x8_t low  = vld1q_s16(row);
+            const int16x8_t high = vld1q_s16(row + 8);
+
+            vst1q_u8(output, vcombine_u8(vqmovun_s16(low), vqmovun_s16(high)));
+#elif defined(ETC_USE_SSE2)
+            const __m128i low  = _mm_loadu_si128((const __m128i *)row);
+            const __m128i high = _mm_loadu_si128((const __m128i *)(row + 8));
+
+            _mm_storeu_si128((__m128i *)output, _mm_packus_epi16(low, high));
+#else
+            for (int channel = 0; channel < 16; channel++)
+            {
+                output[channel] = (unsigned char)clamp(row[channel], 0, 255);
+            }
+#endif
+        }
+    }
+
+    /*
+     * Individual and differential modes: two sub-blocks, each with a base colour and a modifier table.
+     * With transparentIndices (punch-through alpha, opaque bit clear) pixel index 2 is transparent black
+     * and pixel index 0 has no modifier.
+     */
+    static void decodeSubblocks(const unsigned char *block, const int baseColors[2][3], bool transparentIndices, short *values)
+    {
+        const bool flipped     = (block[3] & 0x01) != 0;
+        const int  tables[2]   = { block[3] >> 5, (block[3] >> 2) & 0x07 };
+
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                /* Pixel indices are stored column by column. */
+                const int subblock = flipped ? (y >= 2) : (x >= 2);
+                const int index    = pixelIndex(block, x * 4 + y);
+                short *texel = values + y * 16 + x * 4;
+
+                if (transparentIndices && index == 2)
+                {
+                    texel[0] = texel[1] = texel[2] = texel[3] = 0;
+                    continue;
+                }
+
+                int modifier = (index & 2) ? -etcModifierTable[tables[subblock]][index & 1]
+                                           :  etcModifierTable[tables[subblock]][index & 1];
+                if (transparentIndices && index == 0)
+                {
+                    modifier = 0;
+                }
+
+                texel[0] = (short)(baseColors[subblock][0] + modifier);
+                texel[1] = (short)(baseColors[subblock][1] + modifier);
+                texel[2] = (short)(baseColors[subblock][2] + modifier);
+                texel[3] = 255;
+            }
+        }
+    }
+
+    /* T and H modes: every pixel index selects one of four paint colours. */
+    static void decodePaintColors(const unsigned char *block, const int paintColors[4][3], bool transparentIndices, short *values)
+    {
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                const int index = pixelIndex(block, x * 4 + y);
+                short *texel = values + y * 16 + x * 4;
+
+                if (transparentIndices && index == 2)
+                {
+                    texel[0] = texel[1] = texel[2] = texel[3] = 0;
+                    continue;
+                }
+
+                texel[0] = (short)paintColors[index][0];
+                texel[1] = (short)paintColors[index][1];
+                texel[2] = (short)paintColors[index][2];
+                texel[3] = 255;
+            }
+        }
+    }
+
+    static void decodeTMode(const unsigned char *block, bool transparentIndices, short *values)
+    {
+        const int color1[3] =
+        {
+            extend4((((block[0] >> 3) & 0x03) << 2) | (block[0] & 0x03)),
+            extend4(block[1] >> 4),
+            extend4(block[1] & 0x0F)
+        };
+        const int color2[3] =
+        {
+            extend4(block[2] >> 4),
+            extend4(block[2] & 0x0F),
+            extend4(block[3] >> 4)
+        };
+        const int distance = etc2DistanceTable[(((block[3] >> 2) & 0x03) << 1) | (block[3] & 0x01)];
+        int paintColors[4][3];
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            paintColors[0][channel] = color1[channel];
+            paintColors[1][channel] = color2[channel] + distance;
+            paintColors[2][channel] = color2[channel];
+            paintColors[3][channel] = color2[channel] - distance;
+        }
+
+        decodePaintColors(block, paintColors, transparentIndices, values);
+    }
+
+    static void decodeHMode(const unsigned char *block, bool transparentIndices, short *values)
+    {
+        const int color1[3] =
+        {
+            (block[0] >> 3) & 0x0F,
+            ((block[0] & 0x07) << 1) | ((block[1] >> 4) & 0x01),
+            (block[1] & 0x08) | ((block[1] & 0x03) << 1) | (block[2] >> 7)
+        };
+        const int color2[3] =
+        {
+            (block[2] >> 3) & 0x0F,
+            ((block[2] & 0x07) << 1) | (block[3] >> 7),
+            (block[3] >> 3) & 0x0F
+        };
+
+        /* The least significant bit of the distance index is implied by the order of the base colours. */
+        const int order = ((color1[0] << 8) | (color1[1] << 4) | color1[2]) >= ((color2[0] << 8) | (color2[1] << 4) | color2[2]);
+        const int distance = etc2DistanceTable[(block[3] & 0x04) | ((block[3] & 0x01) << 1) | order];
+        int paintColors[4][3];
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            paintColors[0][channel] = extend4(color1[channel]) + distance;
+            paintColors[1][channel] = extend4(color1[channel]) - distance;
+            paintColors[2][channel] = extend4(color2[channel]) + distance;
+            paintColors[3][channel] = extend4(color2[channel]) - distance;
+        }
+
+        decodePaintColors(block, paintColors, transparentIndices, values);
+    }
+
+    /* Planar mode: three colours at the origin and at the horizontal and vertical ends of the block, interpolated per texel. */
+    static void decodePlanarMode(const unsigned char *block, short *values)
+    {
+        const int origin[3] =
+        {
+            extend6((block[0] >> 1) & 0x3F),
+            extend7(((block[0] & 0x01) << 6) | ((block[1] >> 1) & 0x3F)),
+            extend6(((block[1] & 0x01) << 5) | (block[2] & 0x18) | ((block[2] & 0x03) << 1) | (block[3] >> 7))
+        };
+        const int horizontal[3] =
+        {
+            extend6(((block[3] >> 1) & 0x3E) | (block[3] & 0x01)),
+            extend7(block[4] >> 1),
+            extend6(((block[4] & 0x01) << 5) | (block[5] >> 3))
+        };
+        const int vertical[3] =
+        {
+            extend6(((block[5] & 0x07) << 3) | (block[6] >> 5)),
+            extend7(((block[6] & 0x1F) << 2) | (block[7] >> 6)),
+            extend6(block[7] & 0x3F)
+        };
+
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                short *texel = values + y * 16 + x * 4;
+
+                for (int channel = 0; channel < 3; channel++)
+                {
+                    texel[channel] = (short)((x * (horizontal[channel] - origin[channel]) + y * (vertical[channel] - origin[channel]) + 4 * origin[channel] + 2) >> 2);
+                }
+                texel[3] = 255;
+            }
+        }
+    }
+
+    /* ETC2 RGB decoding, shared by the opaque and punch-through formats. ETC1 is the subset without the T, H and planar modes. */
+    static void decodeColorBlock(const unsigned char *block, bool etc2, bool punchthrough, short *values)
+    {
+        int baseColors[2][3];
+        const bool differentialBit = (block[3] & 0x02) != 0;
+
+        /* In the punch-through formats the differential bit is the opaque bit, and the individual mode does not exist. */
+        if (!punchthrough && !differentialBit)
+        {
+            for (int channel = 0; channel < 3; channel++)
+            {
+                baseColors[0][channel] = extend4(block[channel] >> 4);
+                baseColors[1][channel] = extend4(block[channel] & 0x0F);
+            }
+            decodeSubblocks(block, baseColors, false, values);
+            return;
+        }
+
+        const bool transparentIndices = punchthrough && !differentialBit;
+        int second[3];
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            second[channel] = (block[channel] >> 3) + delta3(block[channel] & 0x07);
+        }
+
+        /* In ETC2 an overflowing second base colour selects one of the additional modes. */
+        if (etc2 && (second[0] < 0 || second[0] > 31))
+        {
+            decodeTMode(block, transparentIndices, values);
+            return;
+        }
+        if (etc2 && (second[1] < 0 || second[1] > 31))
+        {
+            decodeHMode(block, transparentIndices, values);
+            return;
+        }
+        if (etc2 && (second[2] < 0 || second[2] > 31))
+        {
+            decodePlanarMode(block, values);
+            return;
+        }
+
+        for (int channel = 0; channel < 3; channel++)
+        {
+            baseColors[0][channel] = extend5(block[channel] >> 3);
+            baseColors[1][channel] = extend5(second[channel] & 0x1F);
+        }
+        decodeSubblocks(block, baseColors, transparentIndices, values);
+    }
+
+    /* 3-bit EAC pixel index of pixel x * 4 + y. */
+    static inline int eacPixelIndex(const unsigned char *block, int pixel)
+    {
+        const unsigned int high = (block[2] << 16) | (block[3] << 8) | block[4];
+        const unsigned int low  = (block[5] << 16) | (block[6] << 8) | block[7];
+
+        return pixel < 8 ? (high >> (21 - pixel * 3)) & 0x07 : (low >> (21 - (pixel - 8) * 3)) & 0x07;
+    }
+
+    /* Signed 11-bit values in [-1023, 1023] are biased to [0, 255], unsigned ones in [0, 2047] are rescaled. */
+    static inline short eacToByte(int value, bool isSigned)
+    {
+        return isSigned ? (short)(((value + 1023) * 255 + 1023) / 2046) : (short)((value * 255 + 1023) / 2047);
+    }
+
+    static void decodeBand(const DecodeBand *band)
+    {
+        const int blockSize    = ETCDecoder::getBlockSize(band->internalFormat);
+        const int blocksAcross = (band->width + 3) / 4;
+        const int rgbaStride   = band->width * 4;
+
+        for (int blockY = band->firstBlockRow; blockY < band->endBlockRow; blockY++)
+        {
+            for (int blockX = 0; blockX < blocksAcross; blockX++)
+            {
+                const unsigned char *block = band->data + (blockY * blocksAcross + blockX) * blockSize;
+                unsigned char *output = band->rgba + (blockY * 4) * rgbaStride + blockX * 4 * 4;
+
+                if (blockX * 4 + 4 <= band->width && blockY * 4 + 4 <= band->height)
+                {
+                    ETCDecoder::decodeBlock(band->internalFormat, block, output, rgbaStride);
+                    continue;
+                }
+
+                /* Blocks on the right and bottom edges may be partially outside the image. */
+                unsigned char texels[4 * 4 * 4];
+                const int columns = band->width - blockX * 4 < 4 ? band->width - blockX * 4 : 4;
+
+                ETCDecoder::decodeBlock(band->internalFormat, block, texels, 4 * 4);
+
+                for (int y = 0; y < 4 && blockY * 4 + y < band->height; y++)
+                {
+                    memcpy(output + y * rgbaStride, texels + y * 16, columns * 4);
+                }
+            }
+        }
+    }
+
+    static void decodeBandEntry(void *band)
+    {
+        decodeBand((const DecodeBand *)band);
+    }
+
+    bool ETCDecoder::isFormatSupported(GLenum internalFormat)
+    {
+        return getBlockSize(internalFormat) != 0;
+    }
+
+    int ETCDecoder::getBlockSize(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case 0x8D64: /* GL_ETC1_RGB8_OES */
+            case 0x9270: /* GL_COMPRESSED_R11_EAC */
+            case 0x9271: /* GL_COMPRESSED_SIGNED_R11_EAC */
+            case 0x9274: /* GL_COMPRESSED_RGB8_ETC2 */
+            case 0x9275: /* GL_COMPRESSED_SRGB8_ETC2 */
+            case 0x9276: /* GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+            case 0x9277: /* GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+                return 8;
+            case 0x9272: /* GL_COMPRESSED_RG11_EAC */
+            case 0x9273: /* GL_COMPRESSED_SIGNED_RG11_EAC */
+            case 0x9278: /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+            case 0x9279: /* GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC */
+                return 16;
+            default:
+                return 0;
+        }
+    }
+
+    void ETCDecoder::decodeETC1Block(const unsigned char *block, unsigned char *rgba, int rgbaStride)
+    {
+        short values[4 * 4 * 4];
+
+        decodeColorBlock(block, false, false, values);
+        storeBlock(values, rgba, rgbaStride);
+    }
+
+    void ETCDecoder::decodeETC2Block(const unsigned char *block, unsigned char *rgba, int rgbaStride, bool punchthrough)
+    {
+        short values[4 * 4 * 4];
+
+        decodeColorBlock(block, true, punchthrough, values);
+        storeBlock(values, rgba, rgbaStride);
+    }
+
+    void ETCDecoder::decodeEACAlphaBlock(const unsigned char *block, unsigned char *values, int valueStride, int rowStride)
+    {
+        const int  base       = block[0];
+        const int  multiplier = block[1] >> 4;
+        const int *modifiers  = eacModifierTable[block[1] & 0x0F];
+
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                values[y * rowStride + x * valueStride] = (unsigned char)clamp(base + modifiers[eacPixelIndex(block, x * 4 + y)] * multiplier, 0, 255);
+            }
+        }
+    }
+
+    void ETCDecoder::decodeEACBlock(const unsigned char *block, bool isSigned, short *values, int valueStride, int rowStride)
+    {
+        const int  multiplier = block[1] >> 4;
+        const int *modifiers  = eacModifierTable[block[1] & 0x0F];
+        int base;
+
+        if (isSigned)
+        {
+            /* -128 is treated as -127 so that the range is symmetric. */
+            base = (signed char)block[0];
+            base = base == -128 ? -127 * 8 : base * 8;
+        }
+        else
+        {
+            base = block[0] * 8 + 4;
+        }
+
+        for (int y = 0; y < 4; y++)
+        {
+            for (int x = 0; x < 4; x++)
+            {
+                const int modifier = modifiers[eacPixelIndex(block, x * 4 + y)];
+
+                /* A multiplier of zero means one eighth, giving the lowest bits of precision. */
+                const int value = multiplier == 0 ? base + modifier : base + modifier * multiplier * 8;
+
+                values[y * rowStride + x * valueStride] = (short)(isSigned ? clamp(value, -1023, 1023) : clamp(value, 0, 2047));
+            }
+        }
+    }
+
+    bool ETCDecoder::decodeBlock(GLenum internalFormat, const unsigned char *block, unsigned char *rgba, int rgbaStride)
+    {
+        switch (internalFormat)
+        {
+            case 0x8D64: /* GL_ETC1_RGB8_OES */
+                decodeETC1Block(block, rgba, rgbaStride);
+                return true;
+            case 0x9274: /* GL_COMPRESSED_RGB8_ETC2 */
+            case 0x9275: /* GL_COMPRESSED_SRGB8_ETC2 */
+                decodeETC2Block(block, rgba, rgbaStride, false);
+                return true;
+            case 0x9276: /* GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+            case 0x9277: /* GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+                decodeETC2Block(block, rgba, rgbaStride, true);
+                return true;
+            case 0x9278: /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+            case 0x9279: /* GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC */
+                /* The alpha block comes first and overwrites the opaque alpha of the colour block. */
+                decodeETC2Block(block + 8, rgba, rgbaStride, false);
+                decodeEACAlphaBlock(block, rgba + 3, 4, rgbaStride);
+                return true;
+            case 0x9270: /* GL_COMPRESSED_R11_EAC */
+            case 0x9271: /* GL_COMPRESSED_SIGNED_R11_EAC */
+            case 0x9272: /* GL_COMPRESSED_RG11_EAC */
+            case 0x9273: /* GL_COMPRESSED_SIGNED_RG11_EAC */
+            {
+                const bool isSigned   = internalFormat == 0x9271 || internalFormat == 0x9273;
+                const bool twoChannel = internalFormat == 0x9272 || internalFormat == 0x9273;
+                short channels[4 * 4 * 2];
+                short values[4 * 4 * 4];
+
+                decodeEACBlock(block, isSigned, channels, 2, 4 * 2);
+                if (twoChannel)
+                {
+                    decodeEACBlock(block + 8, isSigned, channels + 1, 2, 4 * 2);
+                }
+
+                for (int texel = 0; texel < 4 * 4; texel++)
+                {
+                    values[texel * 4 + 0] = eacToByte(channels[texel * 2], isSigned);
+                    values[texel * 4 + 1] = twoChannel ? eacToByte(channels[texel * 2 + 1], isSigned) : 0;
+                    values[texel * 4 + 2] = 0;
+                    values[texel * 4 + 3] = 255;
+                }
+                storeBlock(values, rgba, rgbaStride);
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    bool ETCDecoder::decode(GLenum internalFormat, const unsigned char *data, int width, int height, unsigned char *rgba, int numberOfThreads)
+    {
+        if (!isFormatSupported(internalFormat))
+        {
+            return false;
+        }
+
+        const int blocksDown = (height + 3) / 4;
+
+        numberOfThreads = clamp(numberOfThreads, 1, blocksDown > 0 ? blocksDown : 1);
+
+        std::vector<DecodeBand> bands(numberOfThreads);
+
+        for (int bandIndex = 0; bandIndex < numberOfThreads; bandIndex++)
+        {
+            DecodeBand &band = bands[bandIndex];
+
+            band.internalFormat = internalFormat;
+            band.data           = data;
+            band.width          = width;
+            band.height         = height;
+            band.rgba           = rgba;
+            band.firstBlockRow  = blocksDown * bandIndex / numberOfThreads;
+            band.endBlockRow    = blocksDown * (bandIndex + 1) / numberOfThreads;
+        }
+
+        runBands(decodeBandEntry, &bands[0], sizeof(DecodeBand), numberOfThreads);
+
+        return true;
+    }
+
+    void ETCDecoder::benchmark(int width, int height, int numberOfThreads)
+    {
+        static const GLenum formats[] =
+        {
+            0x8D64, /* GL_ETC1_RGB8_OES */
+            0x9274, /* GL_COMPRESSED_RGB8_ETC2 */
+            0x9276, /* GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+            0x9278, /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+            0x9270, /* GL_COMPRESSED_R11_EAC */
+            0x9271, /* GL_COMPRESSED_SIGNED_R11_EAC */
+            0x9272, /* GL_COMPRESSED_RG11_EAC */
+            0x9273  /* GL_COMPRESSED_SIGNED_RG11_EAC */
+        };
+
+        const int numberOfBlocks = ((width + 3) / 4) * ((height + 3) / 4);
+        std::vector<unsigned char> data(numberOfBlocks * 16);
+        std::vector<unsigned char> rgba(width * height * 4);
+
+        /* Every bit pattern is a valid block, so random data exercises all of the modes. */
+        unsigned int seed = 12345;
+        for (size_t byte = 0; byte < data.size(); byte++)
+        {
+            seed = seed * 1103515245 + 12345;
+            data[byte] = (unsigned char)(seed >> 16);
+        }
+
+        LOGI("ETC decoder benchmark: %d x %d texels, %d threads\n", width, height, numberOfThreads);
+
+        for (size_t formatIndex = 0; formatIndex < sizeof(formats) / sizeof(formats[0]); formatIndex++)
+        {
+            Timer timer;
+            int iterations = 0;
+            float elapsed = 0.0f;
+
+            timer.reset();
+            do
+            {
+                decode(formats[formatIndex], &data[0], width, height, &rgba[0], numberOfThreads);
+                iterations++;
+                elapsed = timer.getTime();
+            }
+            while (elapsed < 0.5f);
+
+            const double compressedBytes = (double)numberOfBlocks * getBlockSize(formats[formatIndex]) * iterations;
+            const double texels          = (double)width * height * iterations;
+
+            LOGI("%-44s %8.1f MB/s %8.1f Mtexels/s\n", TextureFormats::getFormatName(formats[formatIndex]),
+                 compressedBytes / elapsed / (1024.0 * 1024.0), texels / elapsed / 1000000.0);
+        }
+    }
+}
@@ -0,0 +1,236 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "GLCheck.h"
+#include "Platform.h"
+#include "Profiler.h"
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+#include <GLES2/gl2ext.h>
+#include <EGL/egl.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    /* LEVEL_DEBUG_OUTPUT needs a context to install its callback, so it is only entered from configure(). */
+    GLCheck::Level GLCheck::level = GL_CHECK_LEVEL >= GLCheck::LEVEL_DEBUG_OUTPUT ? GLCheck::LEVEL_FRAME : (GLCheck::Level)GL_CHECK_LEVEL;
+    bool GLCheck::configured = false;
+    bool GLCheck::messagesPending = false;
+    const char *GLCheck::lastFile = NULL;
+    int GLCheck::lastLine = 0;
+    const char *GLCheck::lastOperation = NULL;
+
+    /* Messages delivered by the debug callback since the last report. */
+    static vector<string> pendingMessages;
+
+    static void GL_APIENTRY debugMessageCallback(GLenum source, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar *message, const void *userParam)
+    {
+        (void)source;
+        (void)id;
+        (void)length;
+
+        if (type != GL_DEBUG_TYPE_ERROR_KHR && severity != GL_DEBUG_SEVERITY_HIGH_KHR)
+        {
+            return;
+        }
+
+        /* userParam points at GLCheck::messagesPending, which afterCall() tests without a call into GL. */
+        pendingMessages.push_back(message);
+        *(bool *)userParam = true;
+    }
+
+    void GLCheck::setLevel(Level newLevel)
+    {
+        configured = true;
+
+        if (newLevel == LEVEL_DEBUG_OUTPUT && level != LEVEL_DEBUG_OUTPUT && !enableDebugOutput(true))
+        {
+            LOGI("GL_KHR_debug is not supported, checking for GL errors once per frame instead.\n");
+            newLevel = LEVEL_FRAME;
+        }
+        else if (newLevel != LEVEL_DEBUG_OUTPUT && level == LEVEL_DEBUG_OUTPUT)
+        {
+            enableDebugOutput(false);
+        }
+
+        level = newLevel;
+    }
+
+    void GLCheck::configure(void)
+    {
+        const string setting = Profiler::getSetting("debug.malisdk.glcheck", "MALISDK_GL_CHECK");
+        Level newLevel = (Level)GL_CHECK_LEVEL;
+
+        if (setting == "off")
+        {
+            newLevel = LEVEL_OFF;
+        }
+        else if (setting == "frame")
+        {
+            newLevel = LEVEL_FRAME;
+        }
+        else if (setting == "full")
+        {
+            newLevel = LEVEL_FULL;
+        }
+        else if (setting == "debug")
+        {
+            newLevel = LEVEL_DEBUG_OUTPUT;
+        }
+        else if (!setting.empty())
+        {
+            LOGE("Unknown GL check level \"%s\", expected off, frame, full or debug.\n", setting.c_str());
+        }
+
+        setLevel(newLevel);
+    }
+
+    bool GLCheck::enableDebugOutput(bool enable)
+    {
+        static PFNGLDEBUGMESSAGECALLBACKKHRPROC debugMessageCallbackKHR = NULL;
+
+        if (!enable)
+        {
+            if (debugMessageCallbackKHR != NULL)
+            {
+                glDisable(GL_DEBUG_OUTPUT_KHR);
+                debugMessageCallbackKHR(NULL, NULL);
+            }
+            return true;
+        }
+
+        const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+        if (extensions == NULL || strstr(extensions, "GL_KHR_debug") == NULL)
+        {
+            return false;
+        }
+
+        if (debugMessageCallbackKHR == NULL)
+        {
+            debugMessageCallbackKHR = (PFNGLDEBUGMESSAGECALLBACKKHRPROC)eglGetProcAddress("glDebugMessageCallbackKHR");
+        }
+        if (debugMessageCallbackKHR == NULL)
+        {
+            return false;
+        }
+
+        debugMessageCallbackKHR(debugMessageCallback, &messagesPending);
+
+        /* Synchronous delivery makes the callback run inside the call that raised the message. */
+        glEnable(GL_DEBUG_OUTPUT_KHR);
+        glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS_KHR);
+
+        /* Errors are now reported through the callback; drop the flags raised before it was installed. */
+        while (glGetError() != GL_NO_ERROR)
+        {
+        }
+
+        return true;
+    }
+
+    void GLCheck::report(const char *file, int line, const char *operation)
+    {
+        if (level == LEVEL_FULL)
+        {
+            for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+            {
+                LOGE("GL error %s (0x%x) after `%s` at %s:%d\n", getErrorString(error), error, operation, file, line);
+            }
+        }
+        else if (level == LEVEL_DEBUG_OUTPUT)
+        {
+            for (size_t message = 0; message < pendingMessages.size(); message++)
+            {
+                LOGE("GL debug message after `%s` at %s:%d: %s\n", operation, file, line, pendingMessages[message].c_str());
+            }
+            pendingMessages.clear();
+            messagesPending = false;
+        }
+
+        /*
+         * At LEVEL_FULL this runs after the first checked call, so the runtime setting applies from the start.
+         * It is applied after the check, as switching to LEVEL_DEBUG_OUTPUT discards the pending GL errors.
+         */
+        if (!configured)
+        {
+            configure();
+        }
+    }
+
+    void GLCheck::endFrame(void)
+    {
+        const char *operation = lastOperation != NULL ? lastOperation : "(none)";
+        const char *file = lastFile != NULL ? lastFile : "";
+
+        if (level == LEVEL_FRAME)
+        {
+            for (GLenum error = glGetError(); error != GL_NO_ERROR; error = glGetError())
+            {
+                LOGE("GL error %s (0x%x) during the frame, last checked call `%s` at %s:%d\n", getErrorString(error), error, operation, file, lastLine);
+            }
+        }
+        else if (level == LEVEL_DEBUG_OUTPUT && messagesPending)
+        {
+            /* Raised by calls made without GL_CHECK() after the last checked one. */
+            for (size_t message = 0; message < pendingMessages.size(); message++)
+            {
+                LOGE("GL debug message during the frame, last checked call `%s` at %s:%d: %s\n", operation, file, lastLine, pendingMessages[message].c_str());
+            }
+            pendingMessages.clear();
+            messagesPending = false;
+        }
+
+        if (!configured)
+        {
+            configure();
+        }
+    }
+
+    const char *GLCheck::getErrorString(unsigned int error)
+    {
+        switch (error)
+        {
+            case GL_NO_ERROR:
+                return "GL_NO_ERROR";
+            case GL_INVALID_ENUM:
+                return "GL_INVALID_ENUM";
+            case GL_INVALID_VALUE:
+                return "GL_INVALID_VALUE";
+            case GL_INVALID_OPERATION:
+                return "GL_INVALID_OPERATION";
+            case GL_OUT_OF_MEMORY:
+                return "GL_OUT_OF_MEMORY";
+            case GL_INVALID_FRAMEBUFFER_OPERATION:
+                return "GL_INVALID_FRAMEBUFFER_OPERATION";
+            default:
+                return "unknown";
+        }
+    }
+}
@@ -0,0 +1,687 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "GLStateCache.h"
+#include "Platform.h"
+
+#include <cstring>
+
+/* GLES 3.1 binding points, so the cache can track them when built against the GLES 3.0 headers. */
+#if GLES_VERSION >= 3
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+#ifndef GL_ATOMIC_COUNTER_BUFFER
+#define GL_ATOMIC_COUNTER_BUFFER 0x92C0
+#endif
+#ifndef GL_DRAW_INDIRECT_BUFFER
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+#endif
+#ifndef GL_DISPATCH_INDIRECT_BUFFER
+#define GL_DISPATCH_INDIRECT_BUFFER 0x90EE
+#endif
+#endif
+
+using std::map;
+using std::vector;
+
+namespace MaliSDK
+{
+    /* Value of a binding or enum whose state is not known. No GL object or enum uses it. */
+    static const GLuint unknown = 0xFFFFFFFF;
+
+    GLStateCache::GLStateCache(void)
+    {
+        invalidate();
+
+        lastFrame.issued = 0;
+        lastFrame.elided = 0;
+        currentFrame = lastFrame;
+    }
+
+    GLStateCache *GLStateCache::getInstance(void)
+    {
+        static GLStateCache instance;
+
+        return &instance;
+    }
+
+    void GLStateCache::invalidate(void)
+    {
+        program = unknown;
+#if GLES_VERSION >= 3
+        vertexArray = unknown;
+#else
+        vertexArray = 0;
+#endif
+        vertexArrays.clear();
+
+        for (int target = 0; target < NUMBER_OF_BUFFER_TARGETS; target++)
+        {
+            buffers[target] = unknown;
+            indexedBuffers[target].clear();
+        }
+
+        activeUnit = unknown;
+        textureUnits.clear();
+        textureLevels.clear();
+
+        memset(capabilities, -1, sizeof(capabilities));
+
+        for (int factor = 0; factor < 4; factor++)
+        {
+            blendFactors[factor] = unknown;
+        }
+        blendEquations[0] = unknown;
+        blendEquations[1] = unknown;
+
+        depthFunction = unknown;
+        depthWriteMask = unknown;
+        cullFaceMode = unknown;
+        frontFaceMode = unknown;
+        isViewportKnown = false;
+    }
+
+    void GLStateCache::endFrame(void)
+    {
+        lastFrame = currentFrame;
+        currentFrame.issued = 0;
+        currentFrame.elided = 0;
+    }
+
+    int GLStateCache::getBufferTargetIndex(GLenum target)
+    {
+        switch (target)
+        {
+            case GL_ARRAY_BUFFER:
+                return BUFFER_ARRAY;
+#if GLES_VERSION >= 3
+            case GL_COPY_READ_BUFFER:
+                return BUFFER_COPY_READ;
+            case GL_COPY_WRITE_BUFFER:
+                return BUFFER_COPY_WRITE;
+            case GL_PIXEL_PACK_BUFFER:
+                return BUFFER_PIXEL_PACK;
+            case GL_PIXEL_UNPACK_BUFFER:
+                return BUFFER_PIXEL_UNPACK;
+            case GL_TRANSFORM_FEEDBACK_BUFFER:
+                return BUFFER_TRANSFORM_FEEDBACK;
+            case GL_UNIFORM_BUFFER:
+                return BUFFER_UNIFORM;
+            case GL_SHADER_STORAGE_BUFFER:
+                return BUFFER_SHADER_STORAGE;
+            case GL_ATOMIC_COUNTER_BUFFER:
+                return BUFFER_ATOMIC_COUNTER;
+            case GL_DRAW_INDIRECT_BUFFER:
+                return BUFFER_DRAW_INDIRECT;
+            case GL_DISPATCH_INDIRECT_BUFFER:
+                return BUFFER_DISPATCH_INDIRECT;
+#endif
+            default:
+                return -1;
+        }
+    }
+
+    int GLStateCache::getTextureTargetIndex(GLenum target)
+    {
+        switch (target)
+        {
+            case GL_TEXTURE_2D:
+                return TEXTURE_2D;
+            case GL_TEXTURE_CUBE_MAP:
+                return TEXTURE_CUBE_MAP;
+#if GLES_VERSION >= 3
+            case GL_TEXTURE_3D:
+                return TEXTURE_3D;
+            case GL_TEXTURE_2D_ARRAY:
+                return TEXTURE_2D_ARRAY;
+#endif
+            default:
+                return -1;
+        }
+    }
+
+    int GLStateCache::getCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND:
+                return CAPABILITY_BLEND;
+            case GL_CULL_FACE:
+                return CAPABILITY_CULL_FACE;
+            case GL_DEPTH_TEST:
+                return CAPABILITY_DEPTH_TEST;
+            case GL_DITHER:
+                return CAPABILITY_DITHER;
+            case GL_POLYGON_OFFSET_FILL:
+                return CAPABILITY_POLYGON_OFFSET_FILL;
+            case GL_SAMPLE_ALPHA_TO_COVERAGE:
+                return CAPABILITY_SAMPLE_ALPHA_TO_COVERAGE;
+            case GL_SAMPLE_COVERAGE:
+                return CAPABILITY_SAMPLE_COVERAGE;
+            case GL_SCISSOR_TEST:
+                return CAPABILITY_SCISSOR_TEST;
+            case GL_STENCIL_TEST:
+                return CAPABILITY_STENCIL_TEST;
+#if GLES_VERSION >= 3
+            case GL_PRIMITIVE_RESTART_FIXED_INDEX:
+                return CAPABILITY_PRIMITIVE_RESTART_FIXED_INDEX;
+            case GL_RASTERIZER_DISCARD:
+                return CAPABILITY_RASTERIZER_DISCARD;
+#endif
+            default:
+                return -1;
+        }
+    }
+
+    GLStateCache::VertexArrayState &GLStateCache::getVertexArrayState(void)
+    {
+        /* While the bound vertex array is unknown its state is kept under the unknown name, which invalidate() clears. */
+        map<GLuint, VertexArrayState>::iterator state = vertexArrays.find(vertexArray);
+
+        if (state == vertexArrays.end())
+        {
+            VertexArrayState newState;
+            newState.elementArrayBuffer = unknown;
+            newState.enabledAttributes = 0;
+            newState.knownAttributes = 0;
+
+            state = vertexArrays.insert(std::make_pair(vertexArray, newState)).first;
+        }
+
+        return state->second;
+    }
+
+    GLStateCache::TextureUnit &GLStateCache::getTextureUnit(GLuint unit)
+    {
+        if (unit >= textureUnits.size())
+        {
+            TextureUnit unknownUnit;
+
+            for (int target = 0; target < NUMBER_OF_TEXTURE_TARGETS; target++)
+            {
+                unknownUnit.textures[target] = unknown;
+            }
+            unknownUnit.sampler = unknown;
+
+            textureUnits.resize(unit + 1, unknownUnit);
+        }
+
+        return textureUnits[unit];
+    }
+
+    void GLStateCache::useProgram(GLuint newProgram)
+    {
+        if (update(program, newProgram))
+        {
+            GL_CHECK(glUseProgram(newProgram));
+        }
+    }
+
+    void GLStateCache::bindBuffer(GLenum target, GLuint buffer)
+    {
+        if (target == GL_ELEMENT_ARRAY_BUFFER)
+        {
+            if (update(getVertexArrayState().elementArrayBuffer, buffer))
+            {
+                GL_CHECK(glBindBuffer(target, buffer));
+            }
+            return;
+        }
+
+        const int index = getBufferTargetIndex(target);
+
+        if (index < 0)
+        {
+            currentFrame.issued++;
+            GL_CHECK(glBindBuffer(target, buffer));
+        }
+        else if (update(buffers[index], buffer))
+        {
+            GL_CHECK(glBindBuffer(target, buffer));
+        }
+    }
+
+    void GLStateCache::setVertexAttribArray(GLuint index, bool enabled)
+    {
+        VertexArrayState &state = getVertexArrayState();
+        const unsigned int bit = index < 32 ? 1u << index : 0;
+        const unsigned int value = enabled ? bit : 0;
+
+        if (bit != 0 && (state.knownAttributes & bit) != 0 && (state.enabledAttributes & bit) == value)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        state.knownAttributes |= bit;
+        state.enabledAttributes = (state.enabledAttributes & ~bit) | value;
+        currentFrame.issued++;
+
+        if (enabled)
+        {
+            GL_CHECK(glEnableVertexAttribArray(index));
+        }
+        else
+        {
+            GL_CHECK(glDisableVertexAttribArray(index));
+        }
+    }
+
+    void GLStateCache::enableVertexAttribArray(GLuint index)
+    {
+        setVertexAttribArray(index, true);
+    }
+
+    void GLStateCache::disableVertexAttribArray(GLuint index)
+    {
+        setVertexAttribArray(index, false);
+    }
+
+    void GLStateCache::activeTexture(GLenum unit)
+    {
+        if (update(activeUnit, (GLuint)(unit - GL_TEXTURE0)))
+        {
+            GL_CHECK(glActiveTexture(unit));
+        }
+    }
+
+    void GLStateCache::bindTexture(GLenum target, GLuint texture)
+    {
+        const int index = getTextureTargetIndex(target);
+
+        if (index < 0 || activeUnit == unknown)
+        {
+            currentFrame.issued++;
+            GL_CHECK(glBindTexture(target, texture));
+
+            if (index >= 0)
+            {
+                /* The unit which received the texture is unknown, so no unit can be trusted to still hold its texture. */
+                for (size_t unit = 0; unit < textureUnits.size(); unit++)
+                {
+                    textureUnits[unit].textures[index] = unknown;
+                }
+            }
+        }
+        else if (update(getTextureUnit(activeUnit).textures[index], texture))
+        {
+            GL_CHECK(glBindTexture(target, texture));
+        }
+    }
+
+    void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture)
+    {
+        const int index = getTextureTargetIndex(target);
+
+        /* Checked before the unit is selected, so an already bound texture costs no glActiveTexture() either. */
+        if (index >= 0 && getTextureUnit(unit).textures[index] == texture)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        activeTexture(GL_TEXTURE0 + unit);
+        bindTexture(target, texture);
+    }
+
+    void GLStateCache::setCapability(GLenum capability, bool enabled)
+    {
+        const int index = getCapabilityIndex(capability);
+
+        if (index >= 0 && !update(capabilities[index], (signed char)enabled))
+        {
+            return;
+        }
+        if (index < 0)
+        {
+            currentFrame.issued++;
+        }
+
+        if (enabled)
+        {
+            GL_CHECK(glEnable(capability));
+        }
+        else
+        {
+            GL_CHECK(glDisable(capability));
+        }
+    }
+
+    void GLStateCache::enable(GLenum capability)
+    {
+        setCapability(capability, true);
+    }
+
+    void GLStateCache::disable(GLenum capability)
+    {
+        setCapability(capability, false);
+    }
+
+    void GLStateCache::blendFunc(GLenum sourceFactor, GLenum destinationFactor)
+    {
+        if (blendFactors[0] == sourceFactor && blendFactors[1] == destinationFactor &&
+            blendFactors[2] == sourceFactor && blendFactors[3] == destinationFactor)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        blendFactors[0] = blendFactors[2] = sourceFactor;
+        blendFactors[1] = blendFactors[3] = destinationFactor;
+        currentFrame.issued++;
+        GL_CHECK(glBlendFunc(sourceFactor, destinationFactor));
+    }
+
+    void GLStateCache::blendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha)
+    {
+        if (blendFactors[0] == sourceRGB && blendFactors[1] == destinationRGB &&
+            blendFactors[2] == sourceAlpha && blendFactors[3] == destinationAlpha)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        blendFactors[0] = sourceRGB;
+        blendFactors[1] = destinationRGB;
+        blendFactors[2] = sourceAlpha;
+        blendFactors[3] = destinationAlpha;
+        currentFrame.issued++;
+        GL_CHECK(glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha));
+    }
+
+    void GLStateCache::blendEquation(GLenum mode)
+    {
+        if (blendEquations[0] == mode && blendEquations[1] == mode)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        blendEquations[0] = blendEquations[1] = mode;
+        currentFrame.issued++;
+        GL_CHECK(glBlendEquation(mode));
+    }
+
+    void GLStateCache::blendEquationSeparate(GLenum modeRGB, GLenum modeAlpha)
+    {
+        if (blendEquations[0] == modeRGB && blendEquations[1] == modeAlpha)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        blendEquations[0] = modeRGB;
+        blendEquations[1] = modeAlpha;
+        currentFrame.issued++;
+        GL_CHECK(glBlendEquationSeparate(modeRGB, modeAlpha));
+    }
+
+    void GLStateCache::depthFunc(GLenum function)
+    {
+        if (update(depthFunction, function))
+        {
+            GL_CHECK(glDepthFunc(function));
+        }
+    }
+
+    void GLStateCache::depthMask(GLboolean flag)
+    {
+        if (update(depthWriteMask, (GLenum)flag))
+        {
+            GL_CHECK(glDepthMask(flag));
+        }
+    }
+
+    void GLStateCache::cullFace(GLenum mode)
+    {
+        if (update(cullFaceMode, mode))
+        {
+            GL_CHECK(glCullFace(mode));
+        }
+    }
+
+    void GLStateCache::frontFace(GLenum mode)
+    {
+        if (update(frontFaceMode, mode))
+        {
+            GL_CHECK(glFrontFace(mode));
+        }
+    }
+
+    void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (isViewportKnown && viewportRectangle[0] == x && viewportRectangle[1] == y &&
+            viewportRectangle[2] == width && viewportRectangle[3] == height)
+        {
+            currentFrame.elided++;
+            return;
+        }
+
+        viewportRectangle[0] = x;
+        viewportRectangle[1] = y;
+        viewportRectangle[2] = width;
+        viewportRectangle[3] = height;
+        isViewportKnown = true;
+        currentFrame.issued++;
+        GL_CHECK(glViewport(x, y, width, height));
+    }
+
+    void GLStateCache::deleteProgram(GLuint deletedProgram)
+    {
+        GL_CHECK(glDeleteProgram(deletedProgram));
+
+        if (program == deletedProgram)
+        {
+            program = unknown;
+        }
+    }
+
+    void GLStateCache::deleteBuffers(GLsizei count, const GLuint *deletedBuffers)
+    {
+        GL_CHECK(glDeleteBuffers(count, deletedBuffers));
+
+        for (GLsizei buffer = 0; buffer < count; buffer++)
+        {
+            const GLuint name = deletedBuffers[buffer];
+
+            for (int target = 0; target < NUMBER_OF_BUFFER_TARGETS; target++)
+            {
+                if (buffers[target] == name)
+                {
+                    buffers[target] = unknown;
+                }
+
+                for (size_t index = 0; index < indexedBuffers[target].size(); index++)
+                {
+                    if (indexedBuffers[target][index].buffer == name)
+                    {
+                        indexedBuffers[target][index].buffer = unknown;
+                    }
+                }
+            }
+
+            for (map<GLuint, VertexArrayState>::iterator state = vertexArrays.begin(); state != vertexArrays.end(); ++state)
+            {
+                if (state->second.elementArrayBuffer == name)
+                {
+                    state->second.elementArrayBuffer = unknown;
+                }
+            }
+        }
+    }
+
+    void GLStateCache::deleteTextures(GLsizei count, const GLuint *deletedTextures)
+    {
+        GL_CHECK(glDeleteTextures(count, deletedTextures));
+
+        for (GLsizei texture = 0; texture < count; texture++)
+        {
+            const GLuint name = deletedTextures[texture];
+
+            for (size_t unit = 0; unit < textureUnits.size(); unit++)
+            {
+                for (int target = 0; target < NUMBER_OF_TEXTURE_TARGETS; target++)
+                {
+                    if (textureUnits[unit].textures[target] == name)
+                    {
+                        textureUnits[unit].textures[target] = unknown;
+                    }
+                }
+            }
+
+            textureLevels.erase(name);
+        }
+    }
+
+#if GLES_VERSION >= 3
+    void GLStateCache::bindVertexArray(GLuint newVertexArray)
+    {
+        const GLuint previousVertexArray = vertexArray;
+
+        if (update(vertexArray, newVertexArray))
+        {
+            GL_CHECK(glBindVertexArray(newVertexArray));
+
+            /* State recorded while the binding was unknown belongs to whichever vertex array that was. */
+            if (previousVertexArray == unknown)
+            {
+                vertexArrays.erase(unknown);
+            }
+        }
+    }
+
+    void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        bindBufferRange(target, index, buffer, 0, 0);
+    }
+
+    void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+    {
+        const int targetIndex = getBufferTargetIndex(target);
+
+        if (targetIndex < 0)
+        {
+            currentFrame.issued++;
+        }
+        else
+        {
+            vector<IndexedBinding> &bindings = indexedBuffers[targetIndex];
+
+            if (index >= bindings.size())
+            {
+                IndexedBinding unknownBinding;
+                unknownBinding.buffer = unknown;
+                unknownBinding.offset = 0;
+                unknownBinding.size = 0;
+
+                bindings.resize(index + 1, unknownBinding);
+            }
+
+            IndexedBinding &binding = bindings[index];
+
+            if (binding.buffer == buffer && binding.offset == offset && binding.size == size)
+            {
+                currentFrame.elided++;
+                return;
+            }
+
+            binding.buffer = buffer;
+            binding.offset = offset;
+            binding.size = size;
+            buffers[targetIndex] = buffer;
+            currentFrame.issued++;
+        }
+
+        /* A size of 0 is not valid for a range, so it marks a binding of the whole buffer. */
+        if (size == 0)
+        {
+            GL_CHECK(glBindBufferBase(target, index, buffer));
+        }
+        else
+        {
+            GL_CHECK(glBindBufferRange(target, index, buffer, offset, size));
+        }
+    }
+
+    void GLStateCache::bindSampler(GLuint unit, GLuint sampler)
+    {
+        if (update(getTextureUnit(unit).sampler, sampler))
+        {
+            GL_CHECK(glBindSampler(unit, sampler));
+        }
+    }
+
+    void GLStateCache::setTextureLevels(GLenum target, GLuint texture, GLint baseLevel, GLint maxLevel)
+    {
+        map<GLuint, TextureLevels>::iterator levels = textureLevels.find(texture);
+
+        if (levels == textureLevels.end())
+        {
+            TextureLevels unknownLevels;
+            unknownLevels.baseLevel = -1;
+            unknownLevels.maxLevel = -1;
+
+            levels = textureLevels.insert(std::make_pair(texture, unknownLevels)).first;
+        }
+
+        if (update(levels->second.baseLevel, baseLevel))
+        {
+            GL_CHECK(glTexParameteri(target, GL_TEXTURE_BASE_LEVEL, baseLevel));
+        }
+        if (update(levels->second.maxLevel, maxLevel))
+        {
+            GL_CHECK(glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, maxLevel));
+        }
+    }
+
+    void GLStateCache::deleteVertexArrays(GLsizei count, const GLuint *deletedVertexArrays)
+    {
+        GL_CHECK(glDeleteVertexArrays(count, deletedVertexArrays));
+
+        for (GLsizei index = 0; index < count; index++)
+        {
+            /* Deleting the bound vertex array binds the default one. */
+            if (vertexArray == deletedVertexArrays[index])
+            {
+                vertexArray = 0;
+            }
+
+            vertexArrays.erase(deletedVertexArrays[index]);
+        }
+    }
+
+    void GLStateCache::deleteSamplers(GLsizei count, const GLuint *deletedSamplers)
+    {
+        GL_CHECK(glDeleteSamplers(count, deletedSamplers));
+
+        for (GLsizei sampler = 0; sampler < count; sampler++)
+        {
+            for (size_t unit = 0; unit < textureUnits.size(); unit++)
+            {
+                if (textureUnits[unit].sampler == deletedSamplers[sampler])
+                {
+                    textureUnits[unit].sampler = unknown;
+                }
+            }
+        }
+    }
+#endif
+}
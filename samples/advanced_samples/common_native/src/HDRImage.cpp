@@ -18,274 +18,615 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <cassert>
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <cstdio>
+#include <new>
 #include <string>
+#include <vector>
 
+#include "AssetFile.h"
 #include "HDRImage.h"
+#include "ParallelBands.h"
 #include "Platform.h"
 
-using std::string;
-
-#ifndef _WIN32
-    #define MAXSHORT 0x7fff
-    #define MAXCHAR  0x7f
-#endif _WIN32
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define HDR_USE_NEON 1
+#endif
 
-static const string radianceHeader = "?#RADIANCE";
-const int    radianceHeaderLength = 11;
+using std::string;
 
 const int rgbComponentsCount = 3;
 const int rgbeComponentsCount = 4;
 const int minLineLength = 8;
-const int maxLineLength = MAXSHORT;
+const int maxLineLength = 0x7fff;
+const int maxHeaderLength = 4096;
+
+const unsigned char startOfText = '\002';
 
-const char startOfText = '\002';
+/* Largest values representable by the half float and shared exponent formats. */
+const float maxHalfValue = 65504.0f;
+const float maxRGB9E5Value = 65408.0f;
 
 namespace MaliSDK
 {
-    HDRImage::HDRImage(void)
+    /* Scan lines decoded by one thread. */
+    struct HDRDecodeBand
     {
-        width = 0;
-        height = 0;
-        rgbData = NULL;
-    }
-
-    HDRImage::HDRImage(const std::string& filePath)
+        const unsigned char* const* lineStarts;     /* height + 1 entries, the last is the end of the last line. */
+        const float*                exponentScales;
+        HDRImage::Format            format;
+        int                         width;
+        unsigned char*              output;
+        int                         firstLine;
+        int                         endLine;
+    };
+
+    /*
+     * Whether the scan line starting at data uses the run-length encoding: a 2, 2, width header.
+     * Any other line, including one whose first pixel happens to start with 2, 2, is flat.
+     */
+    static bool isRunLengthEncoded(const unsigned char* data, const unsigned char* end, int width)
     {
-        loadFromFile(filePath);
+        return width >= minLineLength && width <= maxLineLength && end - data >= 4 &&
+               data[0] == startOfText && data[1] == startOfText && ((data[2] << 8) | data[3]) == width;
     }
 
-    HDRImage::~HDRImage(void)
+    /*
+     * Find the end of a scan line starting at data, without decoding it.
+     * Returns NULL if the line runs past the end of the file or is not encoded correctly.
+     */
+    static const unsigned char* skipLine(const unsigned char* data, const unsigned char* end, int width)
     {
-        if (rgbData != NULL)
+        if (!isRunLengthEncoded(data, end, width))
         {
-            delete [] rgbData;
-            rgbData = NULL;
+            /* Flat scan line: one RGBE value per pixel. */
+            return end - data >= width * rgbeComponentsCount ? data + width * rgbeComponentsCount : NULL;
         }
-    }
 
-    HDRImage& HDRImage::operator= (const HDRImage &another)
-    {
-        if(this != &another)
+        data += 4;
+
+        /* Components are encoded one after another, so only the run codes need to be read. */
+        for (int componentIndex = 0; componentIndex < rgbeComponentsCount; ++componentIndex)
         {
-            delete [] rgbData;
-            this->width = another.width;
-            this->height = another.height;
-            this->rgbData = new float[this->width * this->height * rgbComponentsCount];
-            memcpy(this->rgbData, another.rgbData, this->width * this->width * rgbComponentsCount * sizeof(float));
+            int pixelIndex = 0;
+
+            while (pixelIndex < width)
+            {
+                if (data >= end)
+                {
+                    return NULL;
+                }
+
+                int rleCode = *data++;
+
+                if (rleCode > 128)
+                {
+                    /* Run of rleCode - 128 equal values, stored once. */
+                    rleCode -= 128;
+                    data += 1;
+                }
+                else
+                {
+                    /* rleCode values stored one after another. */
+                    data += rleCode;
+                }
+
+                pixelIndex += rleCode;
+
+                if (rleCode == 0 || pixelIndex > width || data > end)
+                {
+                    return NULL;
+                }
+            }
         }
 
-        return *this;
+        return data;
     }
 
-    HDRImage::HDRImage(HDRImage& another)
+    /*
+     * Decode the scan line between data and end, as found by skipLine(), into separate
+     * R, G, B and E planes of width bytes each.
+     * Returns false, with the planes cleared, if the line does not decode to exactly width pixels.
+     */
+    static bool decodeLine(const unsigned char* data, const unsigned char* end, int width, unsigned char* planes)
     {
-        if(this != &another)
+        if (!isRunLengthEncoded(data, end, width))
+        {
+            if (end - data < width * rgbeComponentsCount)
+            {
+                memset(planes, 0, width * rgbeComponentsCount);
+                return false;
+            }
+
+            for (int pixelIndex = 0; pixelIndex < width; ++pixelIndex)
+            {
+                for (int componentIndex = 0; componentIndex < rgbeComponentsCount; ++componentIndex)
+                {
+                    planes[componentIndex * width + pixelIndex] = data[pixelIndex * rgbeComponentsCount + componentIndex];
+                }
+            }
+            return true;
+        }
+
+        data += 4;
+
+        for (int componentIndex = 0; componentIndex < rgbeComponentsCount; ++componentIndex)
         {
-            this->width = another.width;
-            this->height = another.height;
-            this->rgbData = new float[this->width * this->height * rgbComponentsCount];
-            memcpy(this->rgbData, another.rgbData, this->width * this->width * rgbComponentsCount * sizeof(float));
+            unsigned char* plane = planes + componentIndex * width;
+            int pixelIndex = 0;
+
+            while (pixelIndex < width)
+            {
+                int rleCode = data < end ? *data++ : 0;
+                const bool isRun = rleCode > 128;
+
+                if (isRun)
+                {
+                    rleCode -= 128;
+                }
+
+                /* Same checks as skipLine(): every run must fit in the rest of the plane and in the line. */
+                if (rleCode == 0 || rleCode > width - pixelIndex || end - data < (isRun ? 1 : rleCode))
+                {
+                    memset(planes, 0, width * rgbeComponentsCount);
+                    return false;
+                }
+
+                if (isRun)
+                {
+                    memset(plane + pixelIndex, *data++, rleCode);
+                }
+                else
+                {
+                    memcpy(plane + pixelIndex, data, rleCode);
+                    data += rleCode;
+                }
+
+                pixelIndex += rleCode;
+            }
         }
+
+        return true;
     }
 
-    void HDRImage::loadFromFile(const std::string& filePath)
+    /* Convert a non-negative float to a half float, rounding to nearest even and clamping to the largest finite half. */
+    static inline unsigned short convertToHalf(float value)
     {
-        FILE* file;
+        union { float f; unsigned int u; } bits;
 
-        file = fopen(filePath.c_str(), "rb");
+        bits.f = value < maxHalfValue ? value : maxHalfValue;
 
-        if (file == NULL)
+        if (bits.u >= 0x38800000)
         {
-            LOGE("Could not open file %s", filePath.c_str());
-            return;
+            /* Normal half: rebias the exponent and round away the 13 lowest mantissa bits. */
+            return (unsigned short)((bits.u - 0x38000000 + 0xfff + ((bits.u >> 13) & 1)) >> 13);
         }
 
-        /* Read header. */
-        char header[radianceHeaderLength];
+        /* Denormal half or zero: adding 0.5 makes the FPU round at the half denormal step of 2^-24. */
+        bits.f += 0.5f;
+
+        return (unsigned short)(bits.u - 0x3f000000);
+    }
 
-        fread(header, 1, radianceHeaderLength, file);
-        header[radianceHeaderLength - 1] = 0;
-        string readHeader = header;
+    /*
+     * Convert an RGBE value to RGB9E5 as described by the EXT_texture_shared_exponent specification.
+     * RGBE already stores a shared exponent, so apart from clamping the conversion is done on integers.
+     */
+    static inline unsigned int convertToRGB9E5(int r, int g, int b, int e, const float* exponentScales)
+    {
+        const int maxComponent = std::max(r, std::max(g, b));
 
-        if (!readHeader.compare(radianceHeader))
+        if (e == 0 || maxComponent == 0)
         {
-            LOGE("File header has not been recognized.\n");
-            fclose(file);
-            return;
+            return 0;
         }
 
-        /* Search for resolution data. */
-        char currentChar  = 0;
-        char previousChar = 0;
+        int log2Max = 0;
 
-        while ((previousChar != '\n' || currentChar != '\n') && currentChar != EOF)
+        while ((maxComponent >> (log2Max + 1)) != 0)
         {
-            previousChar = currentChar;
-            currentChar = fgetc(file);
+            log2Max++;
         }
 
-        int imageWidth = 0;
-        int imageHeight = 0;
-
-        fscanf(file, "-Y %d ", &imageHeight);
-        fscanf(file, "+X %d ", &imageWidth);
+        /* Each component is value * 2^(e - 136); floor(log2(max)) is log2Max + e - 136. */
+        int sharedExponent = std::max(-16, log2Max + e - 136) + 16;
 
-        if (imageWidth < minLineLength || imageWidth > maxLineLength)
+        if (sharedExponent > 31)
         {
-            LOGE("Cannot decode image with width lower than %d or higher than %d", minLineLength, maxLineLength);
-            return;
-        }
+            /* At least one component is above the largest representable value: clamp, then use the largest exponent. */
+            const float scale = exponentScales[e];
 
-        height = imageHeight;
-        width = imageWidth;
+            return (unsigned int)(std::min(r * scale, maxRGB9E5Value) / 128.0f + 0.5f) |
+                   ((unsigned int)(std::min(g * scale, maxRGB9E5Value) / 128.0f + 0.5f) << 9) |
+                   ((unsigned int)(std::min(b * scale, maxRGB9E5Value) / 128.0f + 0.5f) << 18) |
+                   (31u << 27);
+        }
 
-        RGBEPixel* scanLine = NULL;
+        /* Mantissas are round(value / 2^(sharedExponent - 24)) = round(component * 2^(e - 112 - sharedExponent)). */
+        int shift = e - 112 - sharedExponent;
+        int components[3] = { r, g, b };
+        unsigned int mantissas[3];
 
-        try
-        {
-            rgbData = new float[imageWidth * imageHeight * rgbComponentsCount];
-            scanLine = new RGBEPixel[imageWidth * rgbeComponentsCount];
-        }
-        catch (std::bad_alloc& ba)
+        for (int pass = 0; pass < 2; pass++)
         {
-            LOGE("Exception caught: %s", ba.what());
-            return;
+            for (int componentIndex = 0; componentIndex < rgbComponentsCount; ++componentIndex)
+            {
+                const int component = components[componentIndex];
+
+                if (shift >= 0)
+                {
+                    mantissas[componentIndex] = component << shift;
+                }
+                else
+                {
+                    mantissas[componentIndex] = -shift < 16 ? (component + (1 << (-shift - 1))) >> -shift : 0;
+                }
+            }
+
+            if (std::max(mantissas[0], std::max(mantissas[1], mantissas[2])) < 512)
+            {
+                break;
+            }
+
+            /* Rounding carried the largest mantissa to 2^9. */
+            sharedExponent++;
+            shift--;
         }
 
-        for (int y = 0; y < imageHeight; ++y)
+        return mantissas[0] | (mantissas[1] << 9) | (mantissas[2] << 18) | ((unsigned int)sharedExponent << 27);
+    }
+
+    /* Convert one scan line held as R, G, B and E planes to the output format. */
+    static void convertLine(const unsigned char* planes, int width, HDRImage::Format format, const float* exponentScales, unsigned char* output)
+    {
+        const unsigned char* r = planes;
+        const unsigned char* g = planes + width;
+        const unsigned char* b = planes + width * 2;
+        const unsigned char* e = planes + width * 3;
+        int x = 0;
+
+        switch (format)
         {
-            if (!decodeLine(file, imageWidth, scanLine))
+            case HDRImage::FORMAT_RGB32F:
             {
-                LOGE("One of the scan lines has not been encoded correctly.\n");
+                float* rgb = (float*)output;
+#if defined(HDR_USE_NEON)
+                for (; x + 8 <= width; x += 8)
+                {
+                    float scales[8];
+
+                    for (int i = 0; i < 8; i++)
+                    {
+                        scales[i] = exponentScales[e[x + i]];
+                    }
+
+                    const uint16x8_t r16 = vmovl_u8(vld1_u8(r + x));
+                    const uint16x8_t g16 = vmovl_u8(vld1_u8(g + x));
+                    const uint16x8_t b16 = vmovl_u8(vld1_u8(b + x));
+                    const float32x4_t scalesLow  = vld1q_f32(scales);
+                    const float32x4_t scalesHigh = vld1q_f32(scales + 4);
+                    float32x4x3_t low;
+                    float32x4x3_t high;
+
+                    low.val[0]  = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(r16))),  scalesLow);
+                    low.val[1]  = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(g16))),  scalesLow);
+                    low.val[2]  = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(b16))),  scalesLow);
+                    high.val[0] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(r16))), scalesHigh);
+                    high.val[1] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(g16))), scalesHigh);
+                    high.val[2] = vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(b16))), scalesHigh);
+
+                    vst3q_f32(rgb + x * 3, low);
+                    vst3q_f32(rgb + x * 3 + 12, high);
+                }
+#endif
+                for (; x < width; x++)
+                {
+                    const float scale = exponentScales[e[x]];
+
+                    rgb[x * 3]     = r[x] * scale;
+                    rgb[x * 3 + 1] = g[x] * scale;
+                    rgb[x * 3 + 2] = b[x] * scale;
+                }
+                break;
+            }
+
+            case HDRImage::FORMAT_RGB16F:
+            {
+                unsigned short* rgb = (unsigned short*)output;
+#if defined(HDR_USE_NEON) && defined(__aarch64__)
+                const float32x4_t maxValue = vdupq_n_f32(maxHalfValue);
 
-                delete [] scanLine;
-                fclose(file);
+                for (; x + 8 <= width; x += 8)
+                {
+                    float scales[8];
+
+                    for (int i = 0; i < 8; i++)
+                    {
+                        scales[i] = exponentScales[e[x + i]];
+                    }
+
+                    const uint16x8_t r16 = vmovl_u8(vld1_u8(r + x));
+                    const uint16x8_t g16 = vmovl_u8(vld1_u8(g + x));
+                    const uint16x8_t b16 = vmovl_u8(vld1_u8(b + x));
+                    const float32x4_t scalesLow  = vld1q_f32(scales);
+                    const float32x4_t scalesHigh = vld1q_f32(scales + 4);
+                    uint16x4x3_t low;
+                    uint16x4x3_t high;
+
+                    low.val[0]  = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(r16))),  scalesLow),  maxValue)));
+                    low.val[1]  = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(g16))),  scalesLow),  maxValue)));
+                    low.val[2]  = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(b16))),  scalesLow),  maxValue)));
+                    high.val[0] = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(r16))), scalesHigh), maxValue)));
+                    high.val[1] = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(g16))), scalesHigh), maxValue)));
+                    high.val[2] = vreinterpret_u16_f16(vcvt_f16_f32(vminq_f32(vmulq_f32(vcvtq_f32_u32(vmovl_u16(vget_high_u16(b16))), scalesHigh), maxValue)));
+
+                    vst3_u16(rgb + x * 3, low);
+                    vst3_u16(rgb + x * 3 + 12, high);
+                }
+#endif
+                for (; x < width; x++)
+                {
+                    const float scale = exponentScales[e[x]];
 
-                return;
+                    rgb[x * 3]     = convertToHalf(r[x] * scale);
+                    rgb[x * 3 + 1] = convertToHalf(g[x] * scale);
+                    rgb[x * 3 + 2] = convertToHalf(b[x] * scale);
+                }
+                break;
             }
 
-            for (int x = 0; x < imageWidth; ++x)
+            case HDRImage::FORMAT_RGB9E5:
             {
-                int rgbPixelMove = (y * imageWidth + x) * 3;
-                convertRGBEPixel(scanLine[x], rgbData + rgbPixelMove);
+                unsigned int* packed = (unsigned int*)output;
+
+                for (; x < width; x++)
+                {
+                    packed[x] = convertToRGB9E5(r[x], g[x], b[x], e[x], exponentScales);
+                }
+                break;
             }
         }
+    }
 
-        delete [] scanLine;
+    static void decodeBand(const HDRDecodeBand* band)
+    {
+        const size_t outputStride = (size_t)band->width * HDRImage::getBytesPerPixel(band->format);
+        std::vector<unsigned char> planes(band->width * rgbeComponentsCount);
 
-        fclose(file);
+        for (int y = band->firstLine; y < band->endLine; ++y)
+        {
+            /* Lines accepted by skipLine() always decode; the checks only keep a bad line inside planes. */
+            decodeLine(band->lineStarts[y], band->lineStarts[y + 1], band->width, &planes[0]);
+            convertLine(&planes[0], band->width, band->format, band->exponentScales, band->output + y * outputStride);
+        }
     }
 
-    inline void HDRImage::convertRGBEPixel(const RGBEPixel& pixel, float* rgbData)
+    static void decodeBandEntry(void* band)
     {
-        int exponent = pixel.e - 128;
+        decodeBand((const HDRDecodeBand*)band);
+    }
 
-        rgbData[0] = convertSingleComponent(pixel.r, exponent);
-        rgbData[1] = convertSingleComponent(pixel.g, exponent);
-        rgbData[2] = convertSingleComponent(pixel.b, exponent);
+    HDRImage::HDRImage(void)
+    {
+        width = 0;
+        height = 0;
+        format = FORMAT_RGB32F;
+        pixelData = NULL;
+        rgbData = NULL;
     }
 
-    inline float HDRImage::convertSingleComponent(unsigned char value, int exponent)
+    HDRImage::HDRImage(const std::string& filePath, Format format, int numberOfThreads)
     {
-        float floatValue = static_cast<float> (value) / MAXCHAR;
-        float multiplier = pow(2.0f, exponent);
+        width = 0;
+        height = 0;
+        this->format = format;
+        pixelData = NULL;
+        rgbData = NULL;
 
-        return floatValue * multiplier;
+        loadFromFile(filePath, format, numberOfThreads);
     }
 
-    bool HDRImage::decodeLine(FILE* file, int lineLength, RGBEPixel* scanLine)
+    HDRImage::~HDRImage(void)
     {
-        /* Check if line beginning is correct. */
-        char startLineChar1 = fgetc(file);
-        char startLineChar2 = fgetc(file);
-        char startLineChar3 = fgetc(file);
+        release();
+    }
 
-        if (startLineChar1 != startOfText || startLineChar2 != startOfText || startLineChar3 & 0x80)
+    HDRImage& HDRImage::operator= (const HDRImage &another)
+    {
+        if(this != &another)
         {
-            LOGE("Error occured while encoding HDR data. Unknown line beginnings.");
+            release();
+            copyFrom(another);
+        }
+
+        return *this;
+    }
+
+    HDRImage::HDRImage(const HDRImage& another)
+    {
+        pixelData = NULL;
+        rgbData = NULL;
 
+        copyFrom(another);
+    }
+
+    void HDRImage::release(void)
+    {
+        delete [] pixelData;
+
+        pixelData = NULL;
+        rgbData = NULL;
+        width = 0;
+        height = 0;
+    }
+
+    void HDRImage::copyFrom(const HDRImage& another)
+    {
+        width = another.width;
+        height = another.height;
+        format = another.format;
+
+        if (another.pixelData != NULL)
+        {
+            pixelData = new unsigned char[another.getDataSize()];
+            memcpy(pixelData, another.pixelData, another.getDataSize());
+        }
+
+        rgbData = format == FORMAT_RGB32F ? (float*)pixelData : NULL;
+    }
+
+    int HDRImage::getBytesPerPixel(Format format)
+    {
+        switch (format)
+        {
+            case FORMAT_RGB32F:
+                return rgbComponentsCount * sizeof(float);
+
+            case FORMAT_RGB16F:
+                return rgbComponentsCount * sizeof(unsigned short);
+
+            case FORMAT_RGB9E5:
+                return sizeof(unsigned int);
+        }
+
+        return 0;
+    }
+
+    bool HDRImage::loadFromFile(const std::string& filePath, Format format, int numberOfThreads)
+    {
+        release();
+        this->format = format;
+
+        AssetFile file;
+
+        if (!file.open(filePath.c_str()))
+        {
+            LOGE("Could not open file %s: %s", filePath.c_str(), file.getError());
             return false;
         }
 
-        /* Move file position indicator by one character. */
-        fgetc(file);
+        const unsigned char* data = file.getSpan().data;
+        const unsigned char* end  = data + file.getSize();
 
-        for (int componentIndex = 0; componentIndex < rgbeComponentsCount; ++componentIndex)
+        /* Radiance writes "#?RADIANCE", other tools "#?RGBE" or similar. */
+        if (file.getSize() < 2 || data[0] != '#' || data[1] != '?')
         {
-            int pixelIndex = 0;
+            LOGE("File header has not been recognized.\n");
+            return false;
+        }
 
-            while (pixelIndex < lineLength)
-            {
-                /* Code for RLE compression algorithm. */
-                unsigned char rleCode = fgetc(file);
+        /* The header is a list of text lines ended by an empty line. */
+        const unsigned char* position = data;
+        string line;
 
-                if (rleCode > MAXCHAR + 1)
-                {
-                    /* 
-                     * Read code indicates how many pixels are written with the same value,
-                     *.so it is read only once.
-                     */
-                    unsigned char value = fgetc(file);
+        while (true)
+        {
+            const unsigned char* lineEnd = (const unsigned char*)memchr(position, '\n', std::min<size_t>(end - position, maxHeaderLength));
 
-                    rleCode &= MAXCHAR;
+            if (lineEnd == NULL)
+            {
+                LOGE("File header is not terminated.\n");
+                return false;
+            }
 
-                    while (rleCode--)
-                    {
-                        writeDecodedComponent(componentIndex, value, &scanLine[pixelIndex++]);
-                    }
-                }
-                else
-                {
-                    while (rleCode--)
-                    {
-                        /* 
-                         * Read code indicates how many pixels are written next to each other,
-                         * so their value must be read each time this loop is executed.
-                         */
-                        unsigned char value = fgetc(file);
+            line.assign((const char*)position, lineEnd - position);
+            position = lineEnd + 1;
 
-                        writeDecodedComponent(componentIndex, value, &scanLine[pixelIndex++]);
-                    }
-                }
+            if (line.empty())
+            {
+                break;
+            }
+
+            if (line.compare(0, 7, "FORMAT=") == 0 && line.compare(7, string::npos, "32-bit_rle_rgbe") != 0)
+            {
+                LOGE("Unsupported pixel format %s.\n", line.c_str());
+                return false;
             }
         }
 
-        return true;
-    }
+        /* Resolution line. */
+        const unsigned char* lineEnd = (const unsigned char*)memchr(position, '\n', std::min<size_t>(end - position, maxHeaderLength));
+        int imageWidth = 0;
+        int imageHeight = 0;
 
-    inline void HDRImage::writeDecodedComponent(int componentIndicator, unsigned char value, RGBEPixel* rgbePixel)
-    {
-        if (rgbePixel == NULL)
+        if (lineEnd != NULL)
         {
-            LOGE("Cannot write encoded component to a NULL pointer.\n");
+            line.assign((const char*)position, lineEnd - position);
+            position = lineEnd + 1;
+        }
 
-            return;
+        if (lineEnd == NULL || sscanf(line.c_str(), "-Y %d +X %d", &imageHeight, &imageWidth) != 2 || imageWidth <= 0 || imageHeight <= 0)
+        {
+            LOGE("Only images with -Y +X resolution are supported.\n");
+            return false;
         }
 
-        switch (componentIndicator)
+        /*
+         * Scan lines have variable length: find where each of them starts so they can be decoded in any order.
+         * The extra entry is the end of the last line.
+         */
+        std::vector<const unsigned char*> lineStarts(imageHeight + 1);
+
+        for (int y = 0; y < imageHeight; ++y)
         {
-            case 0:
-                rgbePixel->r = value;
-                break;
+            lineStarts[y] = position;
+            position = skipLine(position, end, imageWidth);
 
-            case 1:
-                rgbePixel->g = value;
-                break;
+            if (position == NULL)
+            {
+                LOGE("One of the scan lines has not been encoded correctly.\n");
+                return false;
+            }
+        }
 
-            case 2:
-                rgbePixel->b = value;
-                break;
+        lineStarts[imageHeight] = position;
 
-            case 3:
-                rgbePixel->e = value;
-                break;
+        try
+        {
+            pixelData = new unsigned char[(size_t)imageWidth * imageHeight * getBytesPerPixel(format)];
+        }
+        catch (std::bad_alloc& ba)
+        {
+            LOGE("Exception caught: %s", ba.what());
+            return false;
+        }
+
+        /* A component c with exponent e stands for c * 2^(e - 136); exponent 0 is used for black. */
+        float exponentScales[256];
 
-            default:
-                LOGE("Invalid value of componentIndicator was passed.\n");
+        exponentScales[0] = 0.0f;
+
+        for (int exponent = 1; exponent < 256; ++exponent)
+        {
+            exponentScales[exponent] = ldexpf(1.0f, exponent - 136);
         }
+
+        numberOfThreads = std::max(1, std::min(numberOfThreads, imageHeight));
+
+        std::vector<HDRDecodeBand> bands(numberOfThreads);
+
+        for (int bandIndex = 0; bandIndex < numberOfThreads; bandIndex++)
+        {
+            HDRDecodeBand& band = bands[bandIndex];
+
+            band.lineStarts     = &lineStarts[0];
+            band.exponentScales = exponentScales;
+            band.format         = format;
+            band.width          = imageWidth;
+            band.output         = pixelData;
+            band.firstLine      = imageHeight * bandIndex / numberOfThreads;
+            band.endLine        = imageHeight * (bandIndex + 1) / numberOfThreads;
+        }
+
+        runBands(decodeBandEntry, &bands[0], sizeof(HDRDecodeBand), numberOfThreads);
+
+        width = imageWidth;
+        height = imageHeight;
+        rgbData = format == FORMAT_RGB32F ? (float*)pixelData : NULL;
+
+        return true;
     }
 }
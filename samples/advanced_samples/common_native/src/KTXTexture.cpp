@@ -0,0 +1,561 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "KTXTexture.h"
+#include "Platform.h"
+
+#include <cstring>
+#include <zlib.h>
+
+#if defined(KTX_SUPPORT_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace MaliSDK
+{
+    /* Block layouts of the supported formats. ETC1 shares its VkFormat with ETC2 RGB8, which can decode it. */
+    static const CompressedFormatInfo compressedFormats[] =
+    {
+        { 0x8D64, 4, 4,  8, 147 }, /* GL_ETC1_RGB8_OES */
+        { 0x9274, 4, 4,  8, 147 }, /* GL_COMPRESSED_RGB8_ETC2 */
+        { 0x9275, 4, 4,  8, 148 }, /* GL_COMPRESSED_SRGB8_ETC2 */
+        { 0x9276, 4, 4,  8, 149 }, /* GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+        { 0x9277, 4, 4,  8, 150 }, /* GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+        { 0x9278, 4, 4, 16, 151 }, /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+        { 0x9279, 4, 4, 16, 152 }, /* GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC */
+        { 0x9270, 4, 4,  8, 153 }, /* GL_COMPRESSED_R11_EAC */
+        { 0x9271, 4, 4,  8, 154 }, /* GL_COMPRESSED_SIGNED_R11_EAC */
+        { 0x9272, 4, 4, 16, 155 }, /* GL_COMPRESSED_RG11_EAC */
+        { 0x9273, 4, 4, 16, 156 }, /* GL_COMPRESSED_SIGNED_RG11_EAC */
+        /* ASTC: linear formats are GL_COMPRESSED_RGBA_ASTC_*_KHR, sRGB ones GL_COMPRESSED_SRGB8_ALPHA8_ASTC_*_KHR. */
+        { 0x93B0,  4,  4, 16, 157 }, { 0x93D0,  4,  4, 16, 158 },
+        { 0x93B1,  5,  4, 16, 159 }, { 0x93D1,  5,  4, 16, 160 },
+        { 0x93B2,  5,  5, 16, 161 }, { 0x93D2,  5,  5, 16, 162 },
+        { 0x93B3,  6,  5, 16, 163 }, { 0x93D3,  6,  5, 16, 164 },
+        { 0x93B4,  6,  6, 16, 165 }, { 0x93D4,  6,  6, 16, 166 },
+        { 0x93B5,  8,  5, 16, 167 }, { 0x93D5,  8,  5, 16, 168 },
+        { 0x93B6,  8,  6, 16, 169 }, { 0x93D6,  8,  6, 16, 170 },
+        { 0x93B7,  8,  8, 16, 171 }, { 0x93D7,  8,  8, 16, 172 },
+        { 0x93B8, 10,  5, 16, 173 }, { 0x93D8, 10,  5, 16, 174 },
+        { 0x93B9, 10,  6, 16, 175 }, { 0x93D9, 10,  6, 16, 176 },
+        { 0x93BA, 10,  8, 16, 177 }, { 0x93DA, 10,  8, 16, 178 },
+        { 0x93BB, 10, 10, 16, 179 }, { 0x93DB, 10, 10, 16, 180 },
+        { 0x93BC, 12, 10, 16, 181 }, { 0x93DC, 12, 10, 16, 182 },
+        { 0x93BD, 12, 12, 16, 183 }, { 0x93DD, 12, 12, 16, 184 },
+    };
+
+    static const int numberOfCompressedFormats = sizeof(compressedFormats) / sizeof(compressedFormats[0]);
+
+    static const unsigned char ktx1Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    static const unsigned char ktx2Identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+    /* KTX2 supercompression schemes. */
+    enum
+    {
+        KTX2_SUPERCOMPRESSION_NONE    = 0,
+        KTX2_SUPERCOMPRESSION_BASISLZ = 1,
+        KTX2_SUPERCOMPRESSION_ZSTD    = 2,
+        KTX2_SUPERCOMPRESSION_ZLIB    = 3
+    };
+
+    static unsigned int readUint32(const unsigned char *data, bool swapBytes)
+    {
+        if (swapBytes)
+        {
+            return ((unsigned int)data[0] << 24) | ((unsigned int)data[1] << 16) | ((unsigned int)data[2] << 8) | (unsigned int)data[3];
+        }
+        return (unsigned int)data[0] | ((unsigned int)data[1] << 8) | ((unsigned int)data[2] << 16) | ((unsigned int)data[3] << 24);
+    }
+
+    static unsigned long long readUint64(const unsigned char *data)
+    {
+        return (unsigned long long)readUint32(data, false) | ((unsigned long long)readUint32(data + 4, false) << 32);
+    }
+
+    /* Number of levels in a full mipmap chain, floor(log2(max(width, height))) + 1. */
+    static unsigned int getFullMipmapLevelCount(unsigned int width, unsigned int height)
+    {
+        unsigned int size       = width > height ? width : height;
+        unsigned int levelCount = 1;
+
+        while (size > 1)
+        {
+            size >>= 1;
+            levelCount++;
+        }
+        return levelCount;
+    }
+
+    static size_t alignTo4(size_t value)
+    {
+        return (value + 3) & ~(size_t)3;
+    }
+
+    KTXTexture::KTXTexture()
+        : target(GL_TEXTURE_2D),
+          width(0),
+          height(0),
+          layers(1),
+          faces(1)
+    {
+        memset(&format, 0, sizeof(format));
+    }
+
+    const CompressedFormatInfo *KTXTexture::getFormatInfo(GLenum internalFormat)
+    {
+        for (int i = 0; i < numberOfCompressedFormats; i++)
+        {
+            if (compressedFormats[i].internalFormat == internalFormat)
+            {
+                return &compressedFormats[i];
+            }
+        }
+        return NULL;
+    }
+
+    const CompressedFormatInfo *KTXTexture::getFormatInfoFromVkFormat(unsigned int vkFormat)
+    {
+        /* Skip ETC1, the first entry, so ETC2 RGB8 is returned for the shared VkFormat. */
+        for (int i = 1; i < numberOfCompressedFormats; i++)
+        {
+            if (compressedFormats[i].vkFormat == vkFormat)
+            {
+                return &compressedFormats[i];
+            }
+        }
+        return NULL;
+    }
+
+    size_t KTXTexture::getImageSize(const CompressedFormatInfo &info, int width, int height)
+    {
+        size_t blocksAcross = (width  + info.blockWidth  - 1) / info.blockWidth;
+        size_t blocksDown   = (height + info.blockHeight - 1) / info.blockHeight;
+
+        return blocksAcross * blocksDown * info.bytesPerBlock;
+    }
+
+    bool KTXTexture::fail(const std::string &message)
+    {
+        error = message;
+        close();
+        return false;
+    }
+
+    void KTXTexture::close(void)
+    {
+        file.close();
+        levels.clear();
+        inflatedLevels.clear();
+    }
+
+    bool KTXTexture::load(const char *filename)
+    {
+        close();
+        error.clear();
+
+        if (!file.open(filename))
+        {
+            return fail(file.getError());
+        }
+
+        AssetSpan identifier = file.getSpan(0, sizeof(ktx1Identifier));
+        if (!identifier.isEmpty() && memcmp(identifier.data, ktx1Identifier, sizeof(ktx1Identifier)) == 0)
+        {
+            return loadKTX1() || fail(std::string(filename) + ": " + error);
+        }
+        if (!identifier.isEmpty() && memcmp(identifier.data, ktx2Identifier, sizeof(ktx2Identifier)) == 0)
+        {
+            return loadKTX2() || fail(std::string(filename) + ": " + error);
+        }
+
+        return fail(std::string(filename) + " is not a KTX file");
+    }
+
+    bool KTXTexture::loadKTX1(void)
+    {
+        AssetSpan header = file.getSpan(0, 64);
+        if (header.isEmpty())
+        {
+            error = "truncated header";
+            return false;
+        }
+
+        /* The writer's byte order is recorded as 0x04030201. */
+        bool swapBytes = readUint32(header.data + 12, false) != 0x04030201;
+        if (swapBytes && readUint32(header.data + 12, true) != 0x04030201)
+        {
+            error = "invalid endianness field";
+            return false;
+        }
+
+        unsigned int glType             = readUint32(header.data + 16, swapBytes);
+        unsigned int glInternalFormat   = readUint32(header.data + 28, swapBytes);
+        unsigned int pixelWidth         = readUint32(header.data + 36, swapBytes);
+        unsigned int pixelHeight        = readUint32(header.data + 40, swapBytes);
+        unsigned int pixelDepth         = readUint32(header.data + 44, swapBytes);
+        unsigned int arrayElements      = readUint32(header.data + 48, swapBytes);
+        unsigned int numberOfFaces      = readUint32(header.data + 52, swapBytes);
+        unsigned int numberOfLevels     = readUint32(header.data + 56, swapBytes);
+        unsigned int keyValueDataLength = readUint32(header.data + 60, swapBytes);
+
+        const CompressedFormatInfo *info = getFormatInfo(glInternalFormat);
+        if (glType != 0 || info == NULL)
+        {
+            error = "unsupported format, only ETC and ASTC compressed textures can be loaded";
+            return false;
+        }
+        if (pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 1)
+        {
+            error = "only 2D textures are supported";
+            return false;
+        }
+        if (numberOfFaces != 1 && numberOfFaces != 6)
+        {
+            error = "invalid number of faces";
+            return false;
+        }
+
+        format = *info;
+        width  = pixelWidth;
+        height = pixelHeight;
+        layers = arrayElements > 0 ? arrayElements : 1;
+        faces  = numberOfFaces;
+
+        /* A level count of 0 asks the loader to generate the chain, which is not possible for compressed data. */
+        if (numberOfLevels == 0)
+        {
+            numberOfLevels = 1;
+        }
+        if (numberOfLevels > getFullMipmapLevelCount(pixelWidth, pixelHeight))
+        {
+            error = "more mipmap levels than the image size allows";
+            return false;
+        }
+
+        /* Faces of a cube map which is not an array are stored, and padded, one by one. */
+        const bool   separateFaces  = (faces == 6 && arrayElements == 0);
+        const size_t imagesPerLevel = (size_t)layers * faces;
+        size_t       offset         = 64 + (size_t)keyValueDataLength;
+
+        for (unsigned int level = 0; level < numberOfLevels; level++)
+        {
+            AssetSpan sizeField = file.getSpan(offset, 4);
+            if (sizeField.isEmpty())
+            {
+                error = "truncated level data";
+                return false;
+            }
+            size_t imageSizeField = readUint32(sizeField.data, swapBytes);
+            offset += 4;
+
+            int levelWidth  = width  >> level > 0 ? width  >> level : 1;
+            int levelHeight = height >> level > 0 ? height >> level : 1;
+
+            Level levelInfo;
+            size_t levelSize;
+
+            levelInfo.imageSize = getImageSize(format, levelWidth, levelHeight);
+
+            if (separateFaces)
+            {
+                levelInfo.imageStride = alignTo4(imageSizeField);
+                levelSize             = levelInfo.imageStride * faces;
+            }
+            else
+            {
+                levelInfo.imageStride = imageSizeField / imagesPerLevel;
+                levelSize             = imageSizeField;
+            }
+
+            AssetSpan levelData = file.getSpan(offset, levelSize);
+            if (levelData.isEmpty() || levelInfo.imageStride < levelInfo.imageSize)
+            {
+                error = "truncated level data";
+                return false;
+            }
+
+            levelInfo.data = levelData.data;
+            levels.push_back(levelInfo);
+
+            offset = alignTo4(offset + levelSize);
+        }
+
+        target = faces == 6 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        if (arrayElements > 0)
+        {
+#if GLES_VERSION == 3
+            if (faces != 1)
+            {
+                error = "cube map arrays are not supported";
+                return false;
+            }
+            target = GL_TEXTURE_2D_ARRAY;
+#else
+            error = "array textures need OpenGL ES 3.0";
+            return false;
+#endif
+        }
+
+        return true;
+    }
+
+    bool KTXTexture::loadKTX2(void)
+    {
+        AssetSpan header = file.getSpan(0, 80);
+        if (header.isEmpty())
+        {
+            error = "truncated header";
+            return false;
+        }
+
+        unsigned int vkFormat         = readUint32(header.data + 12, false);
+        unsigned int pixelWidth       = readUint32(header.data + 20, false);
+        unsigned int pixelHeight      = readUint32(header.data + 24, false);
+        unsigned int pixelDepth       = readUint32(header.data + 28, false);
+        unsigned int layerCount       = readUint32(header.data + 32, false);
+        unsigned int faceCount        = readUint32(header.data + 36, false);
+        unsigned int levelCount       = readUint32(header.data + 40, false);
+        unsigned int supercompression = readUint32(header.data + 44, false);
+
+        const CompressedFormatInfo *info = getFormatInfoFromVkFormat(vkFormat);
+        if (info == NULL)
+        {
+            error = supercompression == KTX2_SUPERCOMPRESSION_BASISLZ ? "BasisLZ supercompression is not supported"
+                                                                      : "unsupported format, only ETC and ASTC compressed textures can be loaded";
+            return false;
+        }
+        if (pixelWidth == 0 || pixelHeight == 0 || pixelDepth > 0)
+        {
+            error = "only 2D textures are supported";
+            return false;
+        }
+        if (faceCount != 1 && faceCount != 6)
+        {
+            error = "invalid number of faces";
+            return false;
+        }
+        if (supercompression != KTX2_SUPERCOMPRESSION_NONE &&
+            supercompression != KTX2_SUPERCOMPRESSION_ZLIB
+#if defined(KTX_SUPPORT_ZSTD)
+            && supercompression != KTX2_SUPERCOMPRESSION_ZSTD
+#endif
+           )
+        {
+            error = "unsupported supercompression scheme";
+            return false;
+        }
+
+        format = *info;
+        width  = pixelWidth;
+        height = pixelHeight;
+        layers = layerCount > 0 ? layerCount : 1;
+        faces  = faceCount;
+
+        if (levelCount == 0)
+        {
+            levelCount = 1;
+        }
+        if (levelCount > getFullMipmapLevelCount(pixelWidth, pixelHeight))
+        {
+            error = "more mipmap levels than the image size allows";
+            return false;
+        }
+
+        AssetSpan levelIndex = file.getSpan(80, (size_t)levelCount * 24);
+        if (levelIndex.isEmpty())
+        {
+            error = "truncated level index";
+            return false;
+        }
+
+        const size_t imagesPerLevel = (size_t)layers * faces;
+
+        inflatedLevels.resize(levelCount);
+
+        for (unsigned int level = 0; level < levelCount; level++)
+        {
+            unsigned long long byteOffset             = readUint64(levelIndex.data + level * 24);
+            unsigned long long byteLength             = readUint64(levelIndex.data + level * 24 + 8);
+            unsigned long long uncompressedByteLength = readUint64(levelIndex.data + level * 24 + 16);
+
+            AssetSpan levelData = file.getSpan((size_t)byteOffset, (size_t)byteLength);
+            if (levelData.isEmpty())
+            {
+                error = "truncated level data";
+                return false;
+            }
+
+            if (supercompression != KTX2_SUPERCOMPRESSION_NONE)
+            {
+                if (uncompressedByteLength == 0)
+                {
+                    error = "empty level";
+                    return false;
+                }
+
+                std::vector<unsigned char> &inflated = inflatedLevels[level];
+                inflated.resize((size_t)uncompressedByteLength);
+
+                bool decompressed = false;
+                if (supercompression == KTX2_SUPERCOMPRESSION_ZLIB)
+                {
+                    uLongf inflatedSize = (uLongf)uncompressedByteLength;
+                    decompressed = uncompress(&inflated[0], &inflatedSize, levelData.data, (uLong)levelData.size) == Z_OK &&
+                                   inflatedSize == uncompressedByteLength;
+                }
+#if defined(KTX_SUPPORT_ZSTD)
+                else if (supercompression == KTX2_SUPERCOMPRESSION_ZSTD)
+                {
+                    size_t inflatedSize = ZSTD_decompress(&inflated[0], inflated.size(), levelData.data, levelData.size);
+                    decompressed = !ZSTD_isError(inflatedSize) && inflatedSize == uncompressedByteLength;
+                }
+#endif
+                if (!decompressed)
+                {
+                    error = "cannot decompress level data";
+                    return false;
+                }
+
+                levelData = AssetSpan(&inflated[0], inflated.size());
+            }
+
+            int levelWidth  = width  >> level > 0 ? width  >> level : 1;
+            int levelHeight = height >> level > 0 ? height >> level : 1;
+
+            /* Images of a level are stored layer by layer, face by face, without padding. */
+            Level levelInfo;
+            levelInfo.data        = levelData.data;
+            levelInfo.imageSize   = getImageSize(format, levelWidth, levelHeight);
+            levelInfo.imageStride = levelData.size / imagesPerLevel;
+
+            if (levelInfo.imageStride < levelInfo.imageSize)
+            {
+                error = "truncated level data";
+                return false;
+            }
+
+            levels.push_back(levelInfo);
+        }
+
+        target = faces == 6 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        if (layerCount > 0)
+        {
+#if GLES_VERSION == 3
+            if (faces != 1)
+            {
+                error = "cube map arrays are not supported";
+                return false;
+            }
+            target = GL_TEXTURE_2D_ARRAY;
+#else
+            error = "array textures need OpenGL ES 3.0";
+            return false;
+#endif
+        }
+
+        return true;
+    }
+
+    AssetSpan KTXTexture::getImage(int level, int layer, int face) const
+    {
+        if (level < 0 || level >= (int)levels.size() || layer < 0 || layer >= layers || face < 0 || face >= faces)
+        {
+            return AssetSpan();
+        }
+
+        const Level &levelInfo = levels[level];
+
+        return AssetSpan(levelInfo.data + (layer * faces + face) * levelInfo.imageStride, levelInfo.imageSize);
+    }
+
+    bool KTXTexture::upload(GLuint *textureID)
+    {
+        if (levels.empty())
+        {
+            error = "no texture loaded";
+            return false;
+        }
+
+        const int numberOfLevels = (int)levels.size();
+        GLenum internalFormat = format.internalFormat;
+
+#if GLES_VERSION == 3
+        /* ETC2 is a superset of ETC1, and GL_ETC1_RGB8_OES is not part of OpenGL ES 3.0. */
+        if (internalFormat == 0x8D64)
+        {
+            internalFormat = GL_COMPRESSED_RGB8_ETC2;
+        }
+#endif
+
+        GL_CHECK(glGenTextures(1, textureID));
+        GL_CHECK(glBindTexture(target, *textureID));
+
+#if GLES_VERSION == 3
+        /* Immutable storage for the whole chain, then every image is copied into it. */
+        if (target == GL_TEXTURE_2D_ARRAY)
+        {
+            GL_CHECK(glTexStorage3D(target, numberOfLevels, internalFormat, width, height, layers));
+        }
+        else
+        {
+            GL_CHECK(glTexStorage2D(target, numberOfLevels, internalFormat, width, height));
+        }
+#endif
+
+        for (int level = 0; level < numberOfLevels; level++)
+        {
+            int levelWidth  = width  >> level > 0 ? width  >> level : 1;
+            int levelHeight = height >> level > 0 ? height >> level : 1;
+
+            for (int layer = 0; layer < layers; layer++)
+            {
+                for (int face = 0; face < faces; face++)
+                {
+                    AssetSpan image = getImage(level, layer, face);
+                    GLenum imageTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+
+#if GLES_VERSION == 3
+                    if (target == GL_TEXTURE_2D_ARRAY)
+                    {
+                        GL_CHECK(glCompressedTexSubImage3D(target, level, 0, 0, layer, levelWidth, levelHeight, 1,
+                                                           internalFormat, (GLsizei)image.size, image.data));
+                    }
+                    else
+                    {
+                        GL_CHECK(glCompressedTexSubImage2D(imageTarget, level, 0, 0, levelWidth, levelHeight,
+                                                           internalFormat, (GLsizei)image.size, image.data));
+                    }
+#elif GLES_VERSION == 2
+                    GL_CHECK(glCompressedTexImage2D(imageTarget, level, internalFormat, levelWidth, levelHeight, 0,
+                                                    (GLsizei)image.size, image.data));
+#endif
+                }
+            }
+        }
+
+        if (numberOfLevels == 1)
+        {
+            /* Compressed textures cannot use glGenerateMipmap, so make a single level complete without mipmaps. */
+            GL_CHECK(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        }
+
+        return true;
+    }
+}
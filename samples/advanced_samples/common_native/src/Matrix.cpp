@@ -22,14 +22,400 @@
 
 #include "Mathematics.h"
 #include "Platform.h"
+#include "Timer.h"
 
 #include <cmath>
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <vector>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MATRIX_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MATRIX_USE_SSE2 1
+#endif
 
 namespace MaliSDK
 {
+    /*
+     * Portable implementations. The public functions use them when neither NEON nor SSE2 is available,
+     * and benchmark() always times them as the reference.
+     * Matrices are 16 floats in column major order.
+     */
+    static void multiplyScalar(const float *left, const float *right, float *result)
+    {
+        for(int row = 0; row < 4; row ++)
+        {
+            for(int column = 0; column < 4; column ++)
+            {
+                float accumulator = 0.0f;
+                for(int allElements = 0; allElements < 4; allElements ++)
+                {
+                    accumulator += left[allElements * 4 + row] * right[column * 4 + allElements];
+                }
+                result[column * 4 + row] = accumulator;
+            }
+        }
+    }
+
+    static void transposeScalar(float *matrix)
+    {
+        for (int row = 0; row < 4; row++)
+        {
+            for (int column = row + 1; column < 4; column++)
+            {
+                float temp = matrix[column * 4 + row];
+                matrix[column * 4 + row] = matrix[row * 4 + column];
+                matrix[row * 4 + column] = temp;
+            }
+        }
+    }
+
+    static inline void cross3(const float *a, const float *b, float *result)
+    {
+        result[0] = a[1] * b[2] - a[2] * b[1];
+        result[1] = a[2] * b[0] - a[0] * b[2];
+        result[2] = a[0] * b[1] - a[1] * b[0];
+    }
+
+    static inline float dot3(const float *a, const float *b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    /*
+     * Inverse from the cross products of the columns, as described in Eric Lengyel,
+     * "Foundations of Game Engine Development, Volume 1", section 1.7.5.
+     * a, b, c and d are the upper three rows of the columns and x, y, z and w the bottom row.
+     */
+    static void invertScalar(const float *matrix, float *result)
+    {
+        const float *a = matrix;
+        const float *b = matrix + 4;
+        const float *c = matrix + 8;
+        const float *d = matrix + 12;
+        const float x = matrix[3];
+        const float y = matrix[7];
+        const float z = matrix[11];
+        const float w = matrix[15];
+        float s[3], t[3], u[3], v[3], r[3];
+
+        cross3(a, b, s);
+        cross3(c, d, t);
+
+        for (int i = 0; i < 3; i++)
+        {
+            u[i] = a[i] * y - b[i] * x;
+            v[i] = c[i] * w - d[i] * z;
+        }
+
+        const float inverseDeterminant = 1.0f / (dot3(s, v) + dot3(t, u));
+
+        for (int i = 0; i < 3; i++)
+        {
+            s[i] *= inverseDeterminant;
+            t[i] *= inverseDeterminant;
+            u[i] *= inverseDeterminant;
+            v[i] *= inverseDeterminant;
+        }
+
+        /* Rows of the inverse. */
+        cross3(b, v, r);
+        result[0] = r[0] + t[0] * y; result[4] = r[1] + t[1] * y; result[ 8] = r[2] + t[2] * y; result[12] = -dot3(b, t);
+        cross3(v, a, r);
+        result[1] = r[0] - t[0] * x; result[5] = r[1] - t[1] * x; result[ 9] = r[2] - t[2] * x; result[13] =  dot3(a, t);
+        cross3(d, u, r);
+        result[2] = r[0] + s[0] * w; result[6] = r[1] + s[1] * w; result[10] = r[2] + s[2] * w; result[14] = -dot3(d, s);
+        cross3(u, c, r);
+        result[3] = r[0] - s[0] * z; result[7] = r[1] - s[1] * z; result[11] = r[2] - s[2] * z; result[15] =  dot3(c, s);
+    }
+
+    /*
+     * Transform count vectors of inputComponents floats (3 or 4, missing w replaced by the w argument)
+     * and store outputComponents floats (3 or 4) of each result.
+     */
+    static void transformScalar(const float *matrix, const float *input, int inputStride, int inputComponents, float w,
+                                float *output, int outputStride, int outputComponents, int count)
+    {
+        for (int index = 0; index < count; index++)
+        {
+            const float *vector = input + index * inputStride;
+            float *result = output + index * outputStride;
+            const float x = vector[0];
+            const float y = vector[1];
+            const float z = vector[2];
+            const float vectorW = inputComponents == 4 ? vector[3] : w;
+
+            for (int row = 0; row < outputComponents; row++)
+            {
+                result[row] = x * matrix[row] + y * matrix[row + 4] + z * matrix[row + 8] + vectorW * matrix[row + 12];
+            }
+        }
+    }
+
+    static void transformSoAScalar(const float *matrix, const float *x, const float *y, const float *z,
+                                   float *outputX, float *outputY, float *outputZ, int first, int count)
+    {
+        for (int index = first; index < count; index++)
+        {
+            const float vectorX = x[index];
+            const float vectorY = y[index];
+            const float vectorZ = z[index];
+
+            outputX[index] = vectorX * matrix[0] + vectorY * matrix[4] + vectorZ * matrix[ 8] + matrix[12];
+            outputY[index] = vectorX * matrix[1] + vectorY * matrix[5] + vectorZ * matrix[ 9] + matrix[13];
+            outputZ[index] = vectorX * matrix[2] + vectorY * matrix[6] + vectorZ * matrix[10] + matrix[14];
+        }
+    }
+
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+    /* Four float lanes, with the few operations the SIMD versions below need. */
+#if defined(MATRIX_USE_NEON)
+    typedef float32x4_t Float4;
+
+    static inline Float4 load4(const float *data)              { return vld1q_f32(data); }
+    static inline void   store4(float *data, Float4 value)     { vst1q_f32(data, value); }
+    static inline Float4 splat4(float value)                   { return vdupq_n_f32(value); }
+    static inline Float4 add4(Float4 left, Float4 right)       { return vaddq_f32(left, right); }
+    static inline Float4 sub4(Float4 left, Float4 right)       { return vsubq_f32(left, right); }
+    static inline Float4 mul4(Float4 left, Float4 right)       { return vmulq_f32(left, right); }
+
+    static inline void store3(float *data, Float4 value)
+    {
+        vst1_f32(data, vget_low_f32(value));
+        vst1q_lane_f32(data + 2, value, 2);
+    }
+
+    /* (y, z, x, w) */
+    static inline Float4 rotate3(Float4 value)
+    {
+        const Float4 yzwx = vextq_f32(value, value, 1);
+
+        return vcombine_f32(vget_low_f32(yzwx), vrev64_f32(vget_high_f32(yzwx)));
+    }
+
+    static inline void transpose4(Float4 &row0, Float4 &row1, Float4 &row2, Float4 &row3)
+    {
+        const float32x4x2_t row01 = vtrnq_f32(row0, row1);
+        const float32x4x2_t row23 = vtrnq_f32(row2, row3);
+
+        row0 = vcombine_f32(vget_low_f32(row01.val[0]),  vget_low_f32(row23.val[0]));
+        row1 = vcombine_f32(vget_low_f32(row01.val[1]),  vget_low_f32(row23.val[1]));
+        row2 = vcombine_f32(vget_high_f32(row01.val[0]), vget_high_f32(row23.val[0]));
+        row3 = vcombine_f32(vget_high_f32(row01.val[1]), vget_high_f32(row23.val[1]));
+    }
+#else
+    typedef __m128 Float4;
+
+    static inline Float4 load4(const float *data)              { return _mm_loadu_ps(data); }
+    static inline void   store4(float *data, Float4 value)     { _mm_storeu_ps(data, value); }
+    static inline Float4 splat4(float value)                   { return _mm_set1_ps(value); }
+    static inline Float4 add4(Float4 left, Float4 right)       { return _mm_add_ps(left, right); }
+    static inline Float4 sub4(Float4 left, Float4 right)       { return _mm_sub_ps(left, right); }
+    static inline Float4 mul4(Float4 left, Float4 right)       { return _mm_mul_ps(left, right); }
+
+    static inline void store3(float *data, Float4 value)
+    {
+        _mm_storel_pi((__m64 *)data, value);
+        _mm_store_ss(data + 2, _mm_movehl_ps(value, value));
+    }
+
+    /* (y, z, x, w) */
+    static inline Float4 rotate3(Float4 value)
+    {
+        return _mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    static inline void transpose4(Float4 &row0, Float4 &row1, Float4 &row2, Float4 &row3)
+    {
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+    }
+#endif
+
+    /* Cross product of the xyz lanes. The w lane of the result is 0 for finite inputs. */
+    static inline Float4 cross4(Float4 a, Float4 b)
+    {
+        return rotate3(sub4(mul4(a, rotate3(b)), mul4(rotate3(a), b)));
+    }
+
+    static inline float dot4xyz(Float4 a, Float4 b)
+    {
+        float products[4];
+
+        store4(products, mul4(a, b));
+
+        return products[0] + products[1] + products[2];
+    }
+
+    static void multiplySIMD(const float *left, const float *right, float *result)
+    {
+        const Float4 column0 = load4(left);
+        const Float4 column1 = load4(left + 4);
+        const Float4 column2 = load4(left + 8);
+        const Float4 column3 = load4(left + 12);
+
+        /* Each column of the result is a combination of the columns of left, summed in the same order as multiplyScalar(). */
+        for (int column = 0; column < 4; column++)
+        {
+            const float *weights = right + column * 4;
+            Float4 accumulator = mul4(column0, splat4(weights[0]));
+
+            accumulator = add4(accumulator, mul4(column1, splat4(weights[1])));
+            accumulator = add4(accumulator, mul4(column2, splat4(weights[2])));
+            accumulator = add4(accumulator, mul4(column3, splat4(weights[3])));
+
+            store4(result + column * 4, accumulator);
+        }
+    }
+
+    static void transposeSIMD(float *matrix)
+    {
+        Float4 column0 = load4(matrix);
+        Float4 column1 = load4(matrix + 4);
+        Float4 column2 = load4(matrix + 8);
+        Float4 column3 = load4(matrix + 12);
+
+        transpose4(column0, column1, column2, column3);
+
+        store4(matrix,      column0);
+        store4(matrix + 4,  column1);
+        store4(matrix + 8,  column2);
+        store4(matrix + 12, column3);
+    }
+
+    /* Same method as invertScalar(), three components at a time. */
+    static void invertSIMD(const float *matrix, float *result)
+    {
+        const Float4 a = load4(matrix);
+        const Float4 b = load4(matrix + 4);
+        const Float4 c = load4(matrix + 8);
+        const Float4 d = load4(matrix + 12);
+        const Float4 x = splat4(matrix[3]);
+        const Float4 y = splat4(matrix[7]);
+        const Float4 z = splat4(matrix[11]);
+        const Float4 w = splat4(matrix[15]);
+
+        Float4 s = cross4(a, b);
+        Float4 t = cross4(c, d);
+        Float4 u = sub4(mul4(a, y), mul4(b, x));
+        Float4 v = sub4(mul4(c, w), mul4(d, z));
+
+        const Float4 inverseDeterminant = splat4(1.0f / (dot4xyz(s, v) + dot4xyz(t, u)));
+
+        s = mul4(s, inverseDeterminant);
+        t = mul4(t, inverseDeterminant);
+        u = mul4(u, inverseDeterminant);
+        v = mul4(v, inverseDeterminant);
+
+        /* Rows of the inverse, with the last element filled in afterwards. */
+        float rows[16];
+
+        store4(rows,      add4(cross4(b, v), mul4(t, y)));
+        store4(rows + 4,  sub4(cross4(v, a), mul4(t, x)));
+        store4(rows + 8,  add4(cross4(d, u), mul4(s, w)));
+        store4(rows + 12, sub4(cross4(u, c), mul4(s, z)));
+
+        rows[3]  = -dot4xyz(b, t);
+        rows[7]  =  dot4xyz(a, t);
+        rows[11] = -dot4xyz(d, s);
+        rows[15] =  dot4xyz(c, s);
+
+        Float4 row0 = load4(rows);
+        Float4 row1 = load4(rows + 4);
+        Float4 row2 = load4(rows + 8);
+        Float4 row3 = load4(rows + 12);
+
+        transpose4(row0, row1, row2, row3);
+
+        store4(result,      row0);
+        store4(result + 4,  row1);
+        store4(result + 8,  row2);
+        store4(result + 12, row3);
+    }
+
+    static void transformSIMD(const float *matrix, const float *input, int inputStride, int inputComponents, float w,
+                              float *output, int outputStride, int outputComponents, int count)
+    {
+        const Float4 column0 = load4(matrix);
+        const Float4 column1 = load4(matrix + 4);
+        const Float4 column2 = load4(matrix + 8);
+        const Float4 column3 = load4(matrix + 12);
+
+        for (int index = 0; index < count; index++)
+        {
+            const float *vector = input + index * inputStride;
+            float *result = output + index * outputStride;
+            const float vectorW = inputComponents == 4 ? vector[3] : w;
+
+            /* All of the input is read before anything is written, so transforming in place is safe. */
+            Float4 accumulator = mul4(column0, splat4(vector[0]));
+
+            accumulator = add4(accumulator, mul4(column1, splat4(vector[1])));
+            accumulator = add4(accumulator, mul4(column2, splat4(vector[2])));
+            accumulator = add4(accumulator, mul4(column3, splat4(vectorW)));
+
+            if (outputComponents == 4)
+            {
+                store4(result, accumulator);
+            }
+            else
+            {
+                store3(result, accumulator);
+            }
+        }
+    }
+
+    /* Four positions per iteration; returns the number of positions transformed. */
+    static int transformSoASIMD(const float *matrix, const float *x, const float *y, const float *z,
+                                float *outputX, float *outputY, float *outputZ, int count)
+    {
+        int index = 0;
+
+        for (; index + 4 <= count; index += 4)
+        {
+            const Float4 vectorX = load4(x + index);
+            const Float4 vectorY = load4(y + index);
+            const Float4 vectorZ = load4(z + index);
+
+            for (int row = 0; row < 3; row++)
+            {
+                Float4 accumulator = mul4(vectorX, splat4(matrix[row]));
+
+                accumulator = add4(accumulator, mul4(vectorY, splat4(matrix[row + 4])));
+                accumulator = add4(accumulator, mul4(vectorZ, splat4(matrix[row + 8])));
+                accumulator = add4(accumulator, splat4(matrix[row + 12]));
+
+                store4(row == 0 ? outputX + index : (row == 1 ? outputY + index : outputZ + index), accumulator);
+            }
+        }
+
+        return index;
+    }
+#endif
+
+    /* Entry points used by the public functions. */
+    static inline void multiplyColumns(const float *left, const float *right, float *result)
+    {
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+        multiplySIMD(left, right, result);
+#else
+        multiplyScalar(left, right, result);
+#endif
+    }
+
+    static inline void transformColumns(const float *matrix, const float *input, int inputStride, int inputComponents, float w,
+                                        float *output, int outputStride, int outputComponents, int count)
+    {
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+        transformSIMD(matrix, input, inputStride, inputComponents, w, output, outputStride, outputComponents, count);
+#else
+        transformScalar(matrix, input, inputStride, inputComponents, w, output, outputStride, outputComponents, count);
+#endif
+    }
+
     /* Identity matrix. */
     const float identityArray[16] =
     {
@@ -60,7 +446,7 @@ namespace MaliSDK
         return elements[element]; 
     }
 
-    Matrix Matrix::operator* (Matrix right)
+    Matrix Matrix::operator* (const Matrix& right) const
     {
         return multiply(this, &right);
     }
@@ -152,209 +538,15 @@ namespace MaliSDK
         return result;
     }
 
-    Matrix Matrix::matrixInvert(Matrix *matrix)
+    Matrix Matrix::matrixInvert(const Matrix *matrix)
     {
         Matrix result;
-        float matrix3x3[9];
-
-        /* Find the cofactor of each element. */
-        /* Element (i, j) (1, 1) */
-        matrix3x3[0] = matrix->elements[ 5];
-        matrix3x3[1] = matrix->elements[ 6];
-        matrix3x3[2] = matrix->elements[ 7];
-        matrix3x3[3] = matrix->elements[ 9];
-        matrix3x3[4] = matrix->elements[10];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[13];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[0] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (1, 2) */
-        matrix3x3[0] = matrix->elements[ 1];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 9];
-        matrix3x3[4] = matrix->elements[10];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[13];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[4] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (1, 3) */
-        matrix3x3[0] = matrix->elements[ 1];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 5];
-        matrix3x3[4] = matrix->elements[ 6];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[13];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[8] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (1, 4) */
-        matrix3x3[0] = matrix->elements[ 1];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 5];
-        matrix3x3[4] = matrix->elements[ 6];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[ 9];
-        matrix3x3[7] = matrix->elements[10];
-        matrix3x3[8] = matrix->elements[11];
-        result.elements[12] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (2, 1) */
-        matrix3x3[0] = matrix->elements[ 4];
-        matrix3x3[1] = matrix->elements[ 6];
-        matrix3x3[2] = matrix->elements[ 7];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[10];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[1] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (2, 2) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[10];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[5] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (2, 3) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 6];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[14];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[9] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (2, 4) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 2];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 6];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[ 8];
-        matrix3x3[7] = matrix->elements[10];
-        matrix3x3[8] = matrix->elements[11];
-        result.elements[13] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (3, 1) */
-        matrix3x3[0] = matrix->elements[ 4];
-        matrix3x3[1] = matrix->elements[ 5];
-        matrix3x3[2] = matrix->elements[ 7];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[ 9];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[2] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (3, 2) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[ 9];
-        matrix3x3[5] = matrix->elements[11];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[6] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (3, 3) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 5];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[15];
-        result.elements[10] = matrixDeterminant(matrix3x3);
 
-        /* Element (i, j) (3, 4) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 3];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 5];
-        matrix3x3[5] = matrix->elements[ 7];
-        matrix3x3[6] = matrix->elements[ 8];
-        matrix3x3[7] = matrix->elements[ 9];
-        matrix3x3[8] = matrix->elements[11];
-        result.elements[14] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (4, 1) */
-        matrix3x3[0] = matrix->elements[ 4];
-        matrix3x3[1] = matrix->elements[ 5];
-        matrix3x3[2] = matrix->elements[ 6];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[ 9];
-        matrix3x3[5] = matrix->elements[10];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[14];
-        result.elements[3] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (4, 2) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 2];
-        matrix3x3[3] = matrix->elements[ 8];
-        matrix3x3[4] = matrix->elements[ 9];
-        matrix3x3[5] = matrix->elements[10];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[14];
-        result.elements[7] = matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (4, 3) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 2];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 5];
-        matrix3x3[5] = matrix->elements[ 6];
-        matrix3x3[6] = matrix->elements[12];
-        matrix3x3[7] = matrix->elements[13];
-        matrix3x3[8] = matrix->elements[14];
-        result.elements[11] = -matrixDeterminant(matrix3x3);
-
-        /* Element (i, j) (4, 4) */
-        matrix3x3[0] = matrix->elements[ 0];
-        matrix3x3[1] = matrix->elements[ 1];
-        matrix3x3[2] = matrix->elements[ 2];
-        matrix3x3[3] = matrix->elements[ 4];
-        matrix3x3[4] = matrix->elements[ 5];
-        matrix3x3[5] = matrix->elements[ 6];
-        matrix3x3[6] = matrix->elements[ 8];
-        matrix3x3[7] = matrix->elements[ 9];
-        matrix3x3[8] = matrix->elements[10];
-        result.elements[15] = matrixDeterminant(matrix3x3);
-
-        /* The adjoint is the transpose of the cofactor matrix. */
-        matrixTranspose(&result);
-
-        /* The inverse is the adjoint divided by the determinant. */
-        result = matrixScale(&result, 1.0f / matrixDeterminant(matrix));
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+        invertSIMD(matrix->elements, result.elements);
+#else
+        invertScalar(matrix->elements, result.elements);
+#endif
 
         return result;
     }
@@ -373,31 +565,11 @@ namespace MaliSDK
 
     void Matrix::matrixTranspose(Matrix *matrix)
     {
-        float temp;
-
-        temp = matrix->elements[1];
-        matrix->elements[1] = matrix->elements[4];
-        matrix->elements[4] = temp;
-
-        temp = matrix->elements[2];
-        matrix->elements[2] = matrix->elements[8];
-        matrix->elements[8] = temp;
-
-        temp = matrix->elements[3];
-        matrix->elements[3] = matrix->elements[12];
-        matrix->elements[12] = temp;
-
-        temp = matrix->elements[6];
-        matrix->elements[6] = matrix->elements[9];
-        matrix->elements[9] = temp;
-
-        temp = matrix->elements[7];
-        matrix->elements[7] = matrix->elements[13];
-        matrix->elements[13] = temp;
-
-        temp = matrix->elements[11];
-        matrix->elements[11] = matrix->elements[14];
-        matrix->elements[14] = temp;
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+        transposeSIMD(matrix->elements);
+#else
+        transposeScalar(matrix->elements);
+#endif
     }
 
     Matrix Matrix::createScaling(float x, float y, float z)
@@ -532,31 +704,16 @@ namespace MaliSDK
         return result;
     }
 
-    Matrix Matrix::multiply(Matrix *left, Matrix *right)
+    Matrix Matrix::multiply(const Matrix *left, const Matrix *right)
     {
         Matrix result;
 
-        for(int row = 0; row < 4; row ++)
-        {
-            for(int column = 0; column < 4; column ++)
-            {
-                /*result.elements[row * 4 + column]  = left->elements[0 + row * 4] * right->elements[column + 0 * 4];
-                result.elements[row * 4 + column] += left->elements[1 + row * 4] * right->elements[column + 1 * 4];
-                result.elements[row * 4 + column] += left->elements[2 + row * 4] * right->elements[column + 2 * 4];
-                result.elements[row * 4 + column] += left->elements[3 + row * 4] * right->elements[column + 3 * 4];*/
-                float accumulator = 0.0f;
-                for(int allElements = 0; allElements < 4; allElements ++)
-                {
-                    accumulator += left->elements[allElements * 4 + row] * right->elements[column * 4 + allElements];
-                }
-                result.elements[column * 4 + row] = accumulator;
-            }
-        }
+        multiplyColumns(left->elements, right->elements, result.elements);
 
         return result;
     }
 
-    Vec4f Matrix::vertexTransform(Vec4f *vertex, Matrix *matrix)
+    Vec4f Matrix::vertexTransform(const Vec4f *vertex, const Matrix *matrix)
     {
         Vec4f result;
         
@@ -583,7 +740,7 @@ namespace MaliSDK
         return result;
     }
 
-    Vec3f Matrix::vertexTransform(Vec3f *vertex, Matrix *matrix)
+    Vec3f Matrix::vertexTransform(const Vec3f *vertex, const Matrix *matrix)
     {
         Vec3f result;
         Vec4f extendedVertex;
@@ -611,6 +768,286 @@ namespace MaliSDK
         return result;
     }
 
+    void Matrix::transformPositions(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count)
+    {
+        transformColumns(matrix->elements, input, inputStride, 3, 1.0f, output, outputStride, 3, count);
+    }
+
+    void Matrix::transformDirections(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count)
+    {
+        transformColumns(matrix->elements, input, inputStride, 3, 0.0f, output, outputStride, 3, count);
+    }
+
+    void Matrix::transformNormals(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count)
+    {
+        /*
+         * The inverse transpose of a 3x3 matrix with columns a, b and c has columns b x c, c x a and a x b
+         * divided by the determinant. Only the sign of the determinant matters once the results are normalized.
+         */
+        const float *a = matrix->elements;
+        const float *b = matrix->elements + 4;
+        const float *c = matrix->elements + 8;
+        Matrix normalMatrix = identityMatrix;
+
+        cross3(b, c, normalMatrix.elements);
+        cross3(c, a, normalMatrix.elements + 4);
+        cross3(a, b, normalMatrix.elements + 8);
+
+        if (dot3(a, normalMatrix.elements) < 0.0f)
+        {
+            for (int element = 0; element < 12; element++)
+            {
+                normalMatrix.elements[element] = -normalMatrix.elements[element];
+            }
+        }
+
+        transformColumns(normalMatrix.elements, input, inputStride, 3, 0.0f, output, outputStride, 3, count);
+
+        for (int index = 0; index < count; index++)
+        {
+            float *normal = output + index * outputStride;
+            const float length = sqrtf(dot3(normal, normal));
+
+            if (length > 0.0f)
+            {
+                normal[0] /= length;
+                normal[1] /= length;
+                normal[2] /= length;
+            }
+        }
+    }
+
+    void Matrix::transformVectors(const Matrix *matrix, const float *input, int inputStride, float *output, int outputStride, int count)
+    {
+        transformColumns(matrix->elements, input, inputStride, 4, 0.0f, output, outputStride, 4, count);
+    }
+
+    void Matrix::transformPositionsSoA(const Matrix *matrix, const float *x, const float *y, const float *z,
+                                       float *outputX, float *outputY, float *outputZ, int count)
+    {
+        int first = 0;
+
+#if defined(MATRIX_USE_NEON) || defined(MATRIX_USE_SSE2)
+        first = transformSoASIMD(matrix->elements, x, y, z, outputX, outputY, outputZ, count);
+#endif
+
+        transformSoAScalar(matrix->elements, x, y, z, outputX, outputY, outputZ, first, count);
+    }
+
+    /* Run an operation until half a second has passed; returns nanoseconds per item. */
+    template <typename Operation>
+    static double measure(Operation &operation, int itemsPerCall)
+    {
+        Timer timer;
+        int calls = 0;
+        float elapsed = 0.0f;
+
+        timer.reset();
+        do
+        {
+            operation();
+            calls++;
+            elapsed = timer.getTime();
+        }
+        while (elapsed < 0.5f);
+
+        return elapsed * 1.0e9 / ((double)calls * itemsPerCall);
+    }
+
+    /* Operations timed by benchmark(). Each works on the same set of matrices or vertices. */
+    struct MatrixBenchmarkData
+    {
+        std::vector<Matrix> matrices;
+        std::vector<Matrix> results;
+        std::vector<float>  vertices;
+        std::vector<float>  transformed;
+        Matrix              transform;
+    };
+
+    struct MultiplyScalarOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index + 1 < data->matrices.size(); index++)
+            {
+                multiplyScalar(data->matrices[index].getAsArray(), data->matrices[index + 1].getAsArray(), data->results[index].getAsArray());
+            }
+        }
+    };
+
+    struct MultiplyOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index + 1 < data->matrices.size(); index++)
+            {
+                data->results[index] = data->matrices[index] * data->matrices[index + 1];
+            }
+        }
+    };
+
+    struct InvertScalarOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index < data->matrices.size(); index++)
+            {
+                invertScalar(data->matrices[index].getAsArray(), data->results[index].getAsArray());
+            }
+        }
+    };
+
+    struct InvertOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index < data->matrices.size(); index++)
+            {
+                data->results[index] = Matrix::matrixInvert(&data->matrices[index]);
+            }
+        }
+    };
+
+    struct TransposeScalarOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index < data->results.size(); index++)
+            {
+                transposeScalar(data->results[index].getAsArray());
+            }
+        }
+    };
+
+    struct TransposeOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index < data->results.size(); index++)
+            {
+                Matrix::matrixTranspose(&data->results[index]);
+            }
+        }
+    };
+
+    struct VertexTransformOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            for (size_t index = 0; index + 4 <= data->vertices.size(); index += 4)
+            {
+                Vec4f vertex = { data->vertices[index], data->vertices[index + 1], data->vertices[index + 2], data->vertices[index + 3] };
+                Vec4f result = Matrix::vertexTransform(&vertex, &data->transform);
+
+                data->transformed[index]     = result.x;
+                data->transformed[index + 1] = result.y;
+                data->transformed[index + 2] = result.z;
+                data->transformed[index + 3] = result.w;
+            }
+        }
+    };
+
+    struct TransformScalarOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            transformScalar(data->transform.getAsArray(), &data->vertices[0], 4, 4, 0.0f, &data->transformed[0], 4, 4, (int)data->vertices.size() / 4);
+        }
+    };
+
+    struct TransformVectorsOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            Matrix::transformVectors(&data->transform, &data->vertices[0], 4, &data->transformed[0], 4, (int)data->vertices.size() / 4);
+        }
+    };
+
+    struct TransformPositionsOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            Matrix::transformPositions(&data->transform, &data->vertices[0], 4, &data->transformed[0], 4, (int)data->vertices.size() / 4);
+        }
+    };
+
+    struct TransformPositionsSoAOperation
+    {
+        MatrixBenchmarkData *data;
+        void operator()(void)
+        {
+            /* The vertex array is reused as three planes of a quarter of its size each. */
+            const int count = (int)data->vertices.size() / 4;
+            const float *input = &data->vertices[0];
+            float *output = &data->transformed[0];
+
+            Matrix::transformPositionsSoA(&data->transform, input, input + count, input + count * 2,
+                                          output, output + count, output + count * 2, count);
+        }
+    };
+
+    void Matrix::benchmark(int numberOfVertices)
+    {
+        const int numberOfMatrices = 1024;
+        MatrixBenchmarkData data;
+
+        data.matrices.resize(numberOfMatrices);
+        data.results.resize(numberOfMatrices);
+        data.vertices.resize(numberOfVertices * 4);
+        data.transformed.resize(numberOfVertices * 4);
+        data.transform = createRotationX(30.0f) * createTranslation(1.0f, 2.0f, 3.0f);
+
+        /* Rotations with a translation are well conditioned, so the inverses stay finite. */
+        for (int index = 0; index < numberOfMatrices; index++)
+        {
+            data.matrices[index] = createRotationY(index * 7.0f) * createTranslation(index * 0.25f, 1.0f, -2.0f);
+        }
+
+        for (size_t index = 0; index < data.vertices.size(); index++)
+        {
+            data.vertices[index] = (float)(index % 97) * 0.125f;
+        }
+
+#if defined(MATRIX_USE_NEON)
+        const char *simdName = "NEON";
+#elif defined(MATRIX_USE_SSE2)
+        const char *simdName = "SSE2";
+#else
+        const char *simdName = "scalar";
+#endif
+
+        MultiplyScalarOperation        multiplyScalarOperation        = { &data };
+        MultiplyOperation              multiplyOperation              = { &data };
+        InvertScalarOperation          invertScalarOperation          = { &data };
+        InvertOperation                invertOperation                = { &data };
+        TransposeScalarOperation       transposeScalarOperation       = { &data };
+        TransposeOperation             transposeOperation             = { &data };
+        VertexTransformOperation       vertexTransformOperation       = { &data };
+        TransformScalarOperation       transformScalarOperation       = { &data };
+        TransformVectorsOperation      transformVectorsOperation      = { &data };
+        TransformPositionsOperation    transformPositionsOperation    = { &data };
+        TransformPositionsSoAOperation transformPositionsSoAOperation = { &data };
+
+        LOGI("Matrix benchmark: %s build, %d vertices per batch, ns per item\n", simdName, numberOfVertices);
+        LOGI("multiply              scalar %8.2f  %s %8.2f\n", measure(multiplyScalarOperation, numberOfMatrices - 1), simdName, measure(multiplyOperation, numberOfMatrices - 1));
+        LOGI("invert                scalar %8.2f  %s %8.2f\n", measure(invertScalarOperation, numberOfMatrices), simdName, measure(invertOperation, numberOfMatrices));
+        LOGI("transpose             scalar %8.2f  %s %8.2f\n", measure(transposeScalarOperation, numberOfMatrices), simdName, measure(transposeOperation, numberOfMatrices));
+        LOGI("vertexTransform loop         %8.2f\n", measure(vertexTransformOperation, numberOfVertices));
+        LOGI("transformVectors      scalar %8.2f  %s %8.2f\n", measure(transformScalarOperation, numberOfVertices), simdName, measure(transformVectorsOperation, numberOfVertices));
+        LOGI("transformPositions           %8.2f\n", measure(transformPositionsOperation, numberOfVertices));
+        LOGI("transformPositionsSoA        %8.2f\n", measure(transformPositionsSoAOperation, numberOfVertices));
+    }
+
     void Matrix::print(void)
     {
         LOGI("\n");
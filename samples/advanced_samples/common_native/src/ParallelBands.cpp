@@ -0,0 +1,136 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ParallelBands.h"
+
+#include <pthread.h>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Worker threads shared by every runBands() call.
+     *
+     * The workers are started the first time they are needed and then wait for the next call, so
+     * code that runs bands every frame does not pay for creating and joining threads each time.
+     */
+    struct BandPool
+    {
+        pthread_mutex_t mutex;
+        pthread_cond_t workAvailable;
+        pthread_cond_t workDone;
+        std::vector<pthread_t> threads;
+
+        void (*function)(void *band);
+        char *bands;
+        size_t bandSize;
+        int numberOfBands;
+        int nextBand;
+        int bandsRemaining;
+    };
+
+    static BandPool bandPool = { PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER };
+
+    /* Only one runBands() call uses the pool at a time. */
+    static pthread_mutex_t runBandsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    /* Called with bandPool.mutex held, which is released while the band is processed. */
+    static void processBand(int bandIndex)
+    {
+        void (*function)(void *band) = bandPool.function;
+        void *band = bandPool.bands + bandIndex * bandPool.bandSize;
+
+        pthread_mutex_unlock(&bandPool.mutex);
+        function(band);
+        pthread_mutex_lock(&bandPool.mutex);
+
+        bandPool.bandsRemaining--;
+        if (bandPool.bandsRemaining == 0)
+        {
+            pthread_cond_signal(&bandPool.workDone);
+        }
+    }
+
+    static void *bandThreadEntry(void *argument)
+    {
+        pthread_mutex_lock(&bandPool.mutex);
+
+        for (;;)
+        {
+            while (bandPool.nextBand >= bandPool.numberOfBands)
+            {
+                pthread_cond_wait(&bandPool.workAvailable, &bandPool.mutex);
+            }
+
+            processBand(bandPool.nextBand++);
+        }
+
+        return NULL;
+    }
+
+    void runBands(void (*function)(void *band), void *bands, size_t bandSize, int numberOfBands)
+    {
+        if (numberOfBands <= 0)
+        {
+            return;
+        }
+
+        pthread_mutex_lock(&runBandsMutex);
+        pthread_mutex_lock(&bandPool.mutex);
+
+        /* One worker per band other than band 0. If a worker cannot be started the bands are shared among those that could. */
+        while (bandPool.threads.size() < (size_t)(numberOfBands - 1))
+        {
+            pthread_t thread;
+
+            if (pthread_create(&thread, NULL, bandThreadEntry, NULL) != 0)
+            {
+                break;
+            }
+
+            pthread_detach(thread);
+            bandPool.threads.push_back(thread);
+        }
+
+        bandPool.function = function;
+        bandPool.bands = (char *)bands;
+        bandPool.bandSize = bandSize;
+        bandPool.numberOfBands = numberOfBands;
+        bandPool.bandsRemaining = numberOfBands;
+
+        /* Band 0 is processed by the calling thread. */
+        bandPool.nextBand = 1;
+        pthread_cond_broadcast(&bandPool.workAvailable);
+        processBand(0);
+
+        /* Help with whatever the workers have not picked up yet, then wait for the rest. */
+        while (bandPool.nextBand < bandPool.numberOfBands)
+        {
+            processBand(bandPool.nextBand++);
+        }
+        while (bandPool.bandsRemaining > 0)
+        {
+            pthread_cond_wait(&bandPool.workDone, &bandPool.mutex);
+        }
+
+        pthread_mutex_unlock(&bandPool.mutex);
+        pthread_mutex_unlock(&runBandsMutex);
+    }
+}
@@ -22,6 +22,7 @@
 
 #include <cstdio>
 #include <cstdarg>
+#include <cstring>
 
 namespace MaliSDK
 {
@@ -41,7 +42,13 @@ namespace MaliSDK
         va_list ap;
         va_start (ap, format);
         vfprintf (stderr, format, ap);
-        fprintf (stderr, "\n");
         va_end (ap);
+
+        /* Messages shared with Android mostly end in a newline already. */
+        size_t length = strlen(format);
+        if (length == 0 || format[length - 1] != '\n')
+        {
+            fprintf (stderr, "\n");
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,723 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "Profiler.h"
+#include "GLCheck.h"
+#include "GLStateCache.h"
+#include "Platform.h"
+
+#if GLES_VERSION == 2
+#include <GLES2/gl2.h>
+#elif GLES_VERSION == 3
+#include <GLES3/gl3.h>
+#endif
+#include <GLES2/gl2ext.h>
+#include <EGL/egl.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(ANDROID)
+#include <sys/system_properties.h>
+#endif
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    /*
+     * GPU results are read this many frames after their queries were issued, when the GPU has finished
+     * with them. Polling for availability earlier would flush the command stream every frame.
+     */
+    static const int queryLatency = 3;
+
+    static PFNGLGENQUERIESEXTPROC genQueries = NULL;
+    static PFNGLDELETEQUERIESEXTPROC deleteQueries = NULL;
+    static PFNGLBEGINQUERYEXTPROC beginQuery = NULL;
+    static PFNGLENDQUERYEXTPROC endQuery = NULL;
+    static PFNGLGETQUERYOBJECTUI64VEXTPROC getQueryObjectui64v = NULL;
+
+    static int getThreadID(void)
+    {
+#if defined(__linux__)
+        return (int)syscall(SYS_gettid);
+#else
+        return 1;
+#endif
+    }
+
+    string Profiler::getSetting(const char *propertyName, const char *variableName)
+    {
+#if defined(ANDROID)
+        char value[PROP_VALUE_MAX] = "";
+
+        (void)variableName;
+        __system_property_get(propertyName, value);
+
+        return value;
+#else
+        (void)propertyName;
+        const char *value = getenv(variableName);
+
+        return value != NULL ? value : "";
+#endif
+    }
+
+    static string getDefaultOutputPath(void)
+    {
+#if defined(ANDROID)
+        /* The command line of an application process is its package name. */
+        char packageName[256] = "";
+        FILE *file = fopen("/proc/self/cmdline", "rb");
+
+        if (file != NULL)
+        {
+            size_t length = fread(packageName, 1, sizeof(packageName) - 1, file);
+            packageName[length] = '\0';
+            fclose(file);
+        }
+
+        if (packageName[0] != '\0')
+        {
+            return string("/data/data/") + packageName + "/files/profile";
+        }
+#endif
+        return "profile";
+    }
+
+    Profiler *Profiler::getInstance(void)
+    {
+        static Profiler profiler;
+
+        return &profiler;
+    }
+
+    unsigned long long Profiler::getTime(void)
+    {
+        struct timespec now;
+
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+    }
+
+    Profiler::Profiler(void)
+        : isConfigured(false),
+          capturing(false),
+          isGPUDisjoint(false),
+          warmupFramesLeft(0),
+          framesToCapture(0),
+          frameIndex(0),
+          frameDepth(0),
+          activeQuery(0),
+          isTimerQuerySupported(false),
+          isTimerQueryChecked(false)
+    {
+        pthread_mutex_init(&mutex, NULL);
+    }
+
+    void Profiler::configure(void)
+    {
+        isConfigured = true;
+
+        const int numberOfFrames = atoi(getSetting("debug.malisdk.profile.frames", "MALISDK_PROFILE_FRAMES").c_str());
+
+        if (numberOfFrames > 0 && framesToCapture == 0)
+        {
+            string output = getSetting("debug.malisdk.profile.output", "MALISDK_PROFILE_OUTPUT");
+            const int warmupFrames = atoi(getSetting("debug.malisdk.profile.warmup", "MALISDK_PROFILE_WARMUP").c_str());
+
+            if (output.empty())
+            {
+                output = getDefaultOutputPath();
+            }
+
+            start(numberOfFrames, output.c_str(), warmupFrames);
+        }
+    }
+
+    void Profiler::start(int numberOfFrames, const char *outputPath, int warmupFrames)
+    {
+        if (capturing)
+        {
+            LOGE("Profiler: a capture is already running.\n");
+            return;
+        }
+
+        isConfigured = true;
+        framesToCapture = std::max(numberOfFrames, 0);
+        warmupFramesLeft = std::max(warmupFrames, 0);
+        this->outputPath = outputPath != NULL ? outputPath : "";
+
+        LOGI("Profiler: capturing %d frames after %d warm-up frames.\n", framesToCapture, warmupFramesLeft);
+    }
+
+    bool Profiler::checkTimerQuery(void)
+    {
+        if (isTimerQueryChecked)
+        {
+            return isTimerQuerySupported;
+        }
+
+        isTimerQueryChecked = true;
+
+        const char *extensions = (const char *)glGetString(GL_EXTENSIONS);
+
+        if (extensions == NULL || strstr(extensions, "GL_EXT_disjoint_timer_query") == NULL)
+        {
+            LOGI("Profiler: GL_EXT_disjoint_timer_query is not supported, GPU scopes are disabled.\n");
+            return false;
+        }
+
+        genQueries = (PFNGLGENQUERIESEXTPROC)eglGetProcAddress("glGenQueriesEXT");
+        deleteQueries = (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress("glDeleteQueriesEXT");
+        beginQuery = (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress("glBeginQueryEXT");
+        endQuery = (PFNGLENDQUERYEXTPROC)eglGetProcAddress("glEndQueryEXT");
+        getQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress("glGetQueryObjectui64vEXT");
+
+        isTimerQuerySupported = genQueries != NULL && deleteQueries != NULL && beginQuery != NULL &&
+                                endQuery != NULL && getQueryObjectui64v != NULL;
+
+        return isTimerQuerySupported;
+    }
+
+    void Profiler::beginFrame(void)
+    {
+        if (frameDepth++ > 0)
+        {
+            return;
+        }
+
+        if (!isConfigured)
+        {
+            configure();
+        }
+
+        if (!capturing)
+        {
+            if (framesToCapture == 0)
+            {
+                return;
+            }
+
+            if (warmupFramesLeft > 0)
+            {
+                warmupFramesLeft--;
+                return;
+            }
+
+            events.clear();
+            frames.clear();
+            frameIndex = 0;
+            isGPUDisjoint = false;
+            capturing = true;
+
+            if (checkTimerQuery())
+            {
+                /* Clears the disjoint flag. */
+                GLint disjoint = 0;
+                glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+            }
+        }
+
+        Frame frame;
+        frame.start = getTime();
+        frame.end = frame.start;
+        frame.cpuEvent = -1;
+        frame.gpuEvent = -1;
+        frame.issuedStateCalls = 0;
+        frame.elidedStateCalls = 0;
+        frames.push_back(frame);
+
+        frames.back().cpuEvent = beginScope("Frame");
+        frames.back().gpuEvent = beginGPUScope("Frame");
+    }
+
+    void Profiler::endFrame(void)
+    {
+        if (frameDepth > 0 && --frameDepth > 0)
+        {
+            return;
+        }
+
+        if (!capturing)
+        {
+            return;
+        }
+
+        if (gpuScopes.size() > 1)
+        {
+            LOGE("Profiler: %d GPU scopes still open at the end of frame %d.\n", (int)gpuScopes.size() - 1, frameIndex);
+
+            while (gpuScopes.size() > 1)
+            {
+                endGPUScope(gpuScopes.back());
+            }
+        }
+
+        endGPUScope(frames.back().gpuEvent);
+        endScope(frames.back().cpuEvent);
+        frames.back().end = getTime();
+
+        /* ProfileFrame has just closed the frame's GLStateCache counters. */
+        const GLStateCache::Counters &stateCalls = GLStateCache::getInstance()->getFrameCounters();
+        frames.back().issuedStateCalls = stateCalls.issued;
+        frames.back().elidedStateCalls = stateCalls.elided;
+
+        if (isTimerQuerySupported)
+        {
+            GLint disjoint = 0;
+            glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+            isGPUDisjoint = isGPUDisjoint || disjoint != 0;
+
+            readQueries(false);
+        }
+
+        frameIndex++;
+
+        if (frameIndex >= framesToCapture)
+        {
+            finishCapture();
+        }
+    }
+
+    int Profiler::beginScope(const char *name)
+    {
+        if (!capturing)
+        {
+            return -1;
+        }
+
+        Event event;
+        event.name = name;
+        event.start = getTime();
+        event.end = event.start;
+        event.gpuTime = 0;
+        event.frame = frameIndex;
+        event.parent = -1;
+        event.thread = getThreadID();
+        event.isGPU = false;
+
+        pthread_mutex_lock(&mutex);
+        const int scope = (int)events.size();
+        events.push_back(event);
+        pthread_mutex_unlock(&mutex);
+
+        return scope;
+    }
+
+    void Profiler::endScope(int scope)
+    {
+        if (scope < 0)
+        {
+            return;
+        }
+
+        const unsigned long long end = getTime();
+
+        pthread_mutex_lock(&mutex);
+        if (scope < (int)events.size())
+        {
+            events[scope].end = end;
+        }
+        pthread_mutex_unlock(&mutex);
+    }
+
+    int Profiler::beginGPUScope(const char *name)
+    {
+        if (!capturing || !checkTimerQuery())
+        {
+            return -1;
+        }
+
+        const int scope = beginScope(name);
+
+        pthread_mutex_lock(&mutex);
+        events[scope].isGPU = true;
+        events[scope].parent = gpuScopes.empty() ? -1 : gpuScopes.back();
+        pthread_mutex_unlock(&mutex);
+
+        /* Queries cannot overlap: pause the enclosing scope while this one runs. */
+        stopQuery();
+        gpuScopes.push_back(scope);
+        startQuery(scope);
+
+        return scope;
+    }
+
+    void Profiler::endGPUScope(int scope)
+    {
+        if (scope < 0)
+        {
+            return;
+        }
+
+        if (gpuScopes.empty() || gpuScopes.back() != scope)
+        {
+            LOGE("Profiler: GPU scopes closed out of order.\n");
+            return;
+        }
+
+        stopQuery();
+        endScope(scope);
+        gpuScopes.pop_back();
+
+        if (!gpuScopes.empty())
+        {
+            startQuery(gpuScopes.back());
+        }
+    }
+
+    void Profiler::startQuery(int event)
+    {
+        Query query;
+
+        if (freeQueries.empty())
+        {
+            genQueries(1, &query.id);
+        }
+        else
+        {
+            query.id = freeQueries.back();
+            freeQueries.pop_back();
+        }
+
+        query.event = event;
+        query.frame = frameIndex;
+
+        beginQuery(GL_TIME_ELAPSED_EXT, query.id);
+        activeQuery = query.id;
+        pendingQueries.push_back(query);
+    }
+
+    void Profiler::stopQuery(void)
+    {
+        if (activeQuery != 0)
+        {
+            endQuery(GL_TIME_ELAPSED_EXT);
+            activeQuery = 0;
+        }
+    }
+
+    void Profiler::readQueries(bool waitForAll)
+    {
+        size_t numberOfRead = 0;
+
+        /* Queries are pending in the order they were issued. */
+        for (; numberOfRead < pendingQueries.size(); numberOfRead++)
+        {
+            const Query &query = pendingQueries[numberOfRead];
+
+            if (query.id == activeQuery || (!waitForAll && query.frame > frameIndex - queryLatency))
+            {
+                break;
+            }
+
+            GLuint64 elapsed = 0;
+            getQueryObjectui64v(query.id, GL_QUERY_RESULT_EXT, &elapsed);
+
+            /* A scope's time includes the time of the scopes nested in it. */
+            pthread_mutex_lock(&mutex);
+            for (int event = query.event; event >= 0; event = events[event].parent)
+            {
+                events[event].gpuTime += elapsed;
+            }
+            pthread_mutex_unlock(&mutex);
+
+            freeQueries.push_back(query.id);
+        }
+
+        pendingQueries.erase(pendingQueries.begin(), pendingQueries.begin() + numberOfRead);
+    }
+
+    void Profiler::finishCapture(void)
+    {
+        if (isTimerQuerySupported)
+        {
+            readQueries(true);
+
+            if (!freeQueries.empty())
+            {
+                deleteQueries((GLsizei)freeQueries.size(), &freeQueries[0]);
+                freeQueries.clear();
+            }
+        }
+
+        capturing = false;
+        framesToCapture = 0;
+
+        Statistics frameTime, cpuTime, gpuTime;
+        getStatistics(&frameTime, &cpuTime, &gpuTime);
+
+        LOGI("Profiler: %d frames. Frame time p50 %.2f ms, p95 %.2f ms, p99 %.2f ms. CPU p50 %.2f ms, p95 %.2f ms, p99 %.2f ms.\n",
+             (int)frames.size(), frameTime.p50, frameTime.p95, frameTime.p99, cpuTime.p50, cpuTime.p95, cpuTime.p99);
+
+        if (gpuTime.count > 0)
+        {
+            LOGI("Profiler: GPU p50 %.2f ms, p95 %.2f ms, p99 %.2f ms%s.\n",
+                 gpuTime.p50, gpuTime.p95, gpuTime.p99, isGPUDisjoint ? " (disjoint, GPU times are unreliable)" : "");
+        }
+
+        if (!outputPath.empty())
+        {
+            const string reportFilename = outputPath + ".json";
+            const string traceFilename = outputPath + ".trace.json";
+
+            if (writeReport(reportFilename.c_str()) && writeChromeTrace(traceFilename.c_str()))
+            {
+                LOGI("Profiler: wrote %s and %s.\n", reportFilename.c_str(), traceFilename.c_str());
+            }
+        }
+    }
+
+    void Profiler::computeStatistics(vector<double> &values, Statistics *statistics)
+    {
+        memset(statistics, 0, sizeof(*statistics));
+        statistics->count = (int)values.size();
+
+        if (values.empty())
+        {
+            return;
+        }
+
+        std::sort(values.begin(), values.end());
+
+        double sum = 0.0;
+
+        for (size_t index = 0; index < values.size(); index++)
+        {
+            sum += values[index];
+        }
+
+        /* Nearest rank percentiles. */
+        const int count = (int)values.size();
+        const int rank50 = std::max((int)ceil(0.50 * count) - 1, 0);
+        const int rank95 = std::max((int)ceil(0.95 * count) - 1, 0);
+        const int rank99 = std::max((int)ceil(0.99 * count) - 1, 0);
+
+        statistics->mean = sum / count;
+        statistics->minimum = values.front();
+        statistics->p50 = values[rank50];
+        statistics->p95 = values[rank95];
+        statistics->p99 = values[rank99];
+        statistics->maximum = values.back();
+    }
+
+    void Profiler::writeJSONString(FILE *file, const char *string)
+    {
+        fputc('"', file);
+
+        for (const char *character = string; *character != '\0'; character++)
+        {
+            if (*character == '"' || *character == '\\')
+            {
+                fprintf(file, "\\%c", *character);
+            }
+            else if ((unsigned char)*character < 0x20)
+            {
+                fprintf(file, "\\u%04x", *character);
+            }
+            else
+            {
+                fputc(*character, file);
+            }
+        }
+
+        fputc('"', file);
+    }
+
+    void Profiler::writeJSONStatistics(FILE *file, const Statistics &statistics)
+    {
+        fprintf(file, "{\"count\": %d, \"mean\": %.4f, \"min\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f}",
+                statistics.count, statistics.mean, statistics.minimum, statistics.p50, statistics.p95, statistics.p99, statistics.maximum);
+    }
+
+    void Profiler::getFrameTimes(vector<double> *cpuTimes, vector<double> *gpuTimes) const
+    {
+        cpuTimes->clear();
+        gpuTimes->clear();
+
+        for (size_t index = 0; index < frames.size(); index++)
+        {
+            const Frame &frame = frames[index];
+
+            cpuTimes->push_back((frame.end - frame.start) * 1e-6);
+
+            if (frame.gpuEvent >= 0)
+            {
+                gpuTimes->push_back(events[frame.gpuEvent].gpuTime * 1e-6);
+            }
+        }
+    }
+
+    void Profiler::getStatistics(Statistics *frameTime, Statistics *cpuTime, Statistics *gpuTime) const
+    {
+        vector<double> frameTimes, cpuTimes, gpuTimes;
+
+        for (size_t index = 0; index + 1 < frames.size(); index++)
+        {
+            frameTimes.push_back((frames[index + 1].start - frames[index].start) * 1e-6);
+        }
+
+        getFrameTimes(&cpuTimes, &gpuTimes);
+
+        computeStatistics(frameTimes, frameTime);
+        computeStatistics(cpuTimes, cpuTime);
+        computeStatistics(gpuTimes, gpuTime);
+    }
+
+    bool Profiler::writeReport(const char *filename) const
+    {
+        FILE *file = fopen(filename, "w");
+
+        if (file == NULL)
+        {
+            LOGE("Profiler: could not create %s.\n", filename);
+            return false;
+        }
+
+        Statistics frameTime, cpuTime, gpuTime;
+        getStatistics(&frameTime, &cpuTime, &gpuTime);
+
+        fprintf(file, "{\n  \"frames\": %d,\n  \"unit\": \"ms\",\n  \"gpuDisjoint\": %s,\n", (int)frames.size(), isGPUDisjoint ? "true" : "false");
+        fprintf(file, "  \"frameTime\": ");
+        writeJSONStatistics(file, frameTime);
+        fprintf(file, ",\n  \"cpuTime\": ");
+        writeJSONStatistics(file, cpuTime);
+        fprintf(file, ",\n  \"gpuTime\": ");
+        writeJSONStatistics(file, gpuTime);
+
+        /* State changes made through GLStateCache, per frame. Not in milliseconds. */
+        vector<double> issuedStateCalls, elidedStateCalls;
+        for (size_t index = 0; index < frames.size(); index++)
+        {
+            issuedStateCalls.push_back(frames[index].issuedStateCalls);
+            elidedStateCalls.push_back(frames[index].elidedStateCalls);
+        }
+
+        Statistics callStatistics;
+        fprintf(file, ",\n  \"stateCalls\": {\"issued\": ");
+        computeStatistics(issuedStateCalls, &callStatistics);
+        writeJSONStatistics(file, callStatistics);
+        fprintf(file, ", \"elided\": ");
+        computeStatistics(elidedStateCalls, &callStatistics);
+        writeJSONStatistics(file, callStatistics);
+        fprintf(file, "}");
+        fprintf(file, ",\n  \"scopes\": [");
+
+        /* Per scope, the total time spent in it in every frame it appears in. */
+        map<string, vector<double> > scopeTimes;
+        map<string, int> lastFrames;
+
+        for (size_t index = 0; index < events.size(); index++)
+        {
+            const Event &event = events[index];
+            const string key = string(event.isGPU ? "gpu:" : "cpu:") + event.name;
+            const double time = event.isGPU ? event.gpuTime * 1e-6 : (event.end - event.start) * 1e-6;
+
+            vector<double> &times = scopeTimes[key];
+            map<string, int>::iterator lastFrame = lastFrames.find(key);
+
+            if (lastFrame != lastFrames.end() && lastFrame->second == event.frame)
+            {
+                times.back() += time;
+            }
+            else
+            {
+                times.push_back(time);
+                lastFrames[key] = event.frame;
+            }
+        }
+
+        const char *separator = "";
+
+        for (map<string, vector<double> >::iterator scope = scopeTimes.begin(); scope != scopeTimes.end(); ++scope)
+        {
+            Statistics statistics;
+            computeStatistics(scope->second, &statistics);
+
+            fprintf(file, "%s\n    {\"name\": ", separator);
+            writeJSONString(file, scope->first.c_str() + 4);
+            fprintf(file, ", \"type\": \"%.3s\", \"perFrame\": ", scope->first.c_str());
+            writeJSONStatistics(file, statistics);
+            fprintf(file, "}");
+            separator = ",";
+        }
+
+        fprintf(file, "\n  ]\n}\n");
+
+        return fclose(file) == 0;
+    }
+
+    bool Profiler::writeChromeTrace(const char *filename) const
+    {
+        FILE *file = fopen(filename, "w");
+
+        if (file == NULL)
+        {
+            LOGE("Profiler: could not create %s.\n", filename);
+            return false;
+        }
+
+        const unsigned long long origin = frames.empty() ? 0 : frames[0].start;
+        const int gpuTrack = 0;
+
+        fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+        fprintf(file, "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": \"GPU\"}}", gpuTrack);
+
+        for (size_t index = 0; index < events.size(); index++)
+        {
+            const Event &event = events[index];
+            const unsigned long long duration = event.isGPU ? event.gpuTime : event.end - event.start;
+
+            fprintf(file, ",\n  {\"name\": ");
+            writeJSONString(file, event.name);
+            fprintf(file, ", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"args\": {\"frame\": %d}}",
+                    event.isGPU ? "gpu" : "cpu", event.isGPU ? gpuTrack : event.thread,
+                    (event.start - origin) * 1e-3, duration * 1e-3, event.frame);
+        }
+
+        fprintf(file, "\n]}\n");
+
+        return fclose(file) == 0;
+    }
+
+    ProfileFrame::~ProfileFrame(void)
+    {
+        if (isOutermost)
+        {
+            GLCheck::endFrame();
+            GLStateCache::getInstance()->endFrame();
+        }
+        Profiler::getInstance()->endFrame();
+    }
+}
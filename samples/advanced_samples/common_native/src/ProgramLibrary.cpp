@@ -0,0 +1,712 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ProgramLibrary.h"
+#include "AssetFile.h"
+#include "Platform.h"
+#include "Shader.h"
+
+#include <GLES2/gl2ext.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using std::map;
+using std::pair;
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    static const char binaryFileMagic[4] = { 'M', 'P', 'G', 'B' };
+    static const unsigned int binaryFileVersion = 1;
+
+#if GLES_VERSION == 2
+    /* OpenGL ES 2.0 only has program binaries through OES_get_program_binary. */
+    static PFNGLGETPROGRAMBINARYOESPROC getProgramBinaryOES = NULL;
+    static PFNGLPROGRAMBINARYOESPROC programBinaryOES = NULL;
+#endif
+
+    static void getProgramBinary(GLuint program, GLsizei bufferSize, GLsizei *length, GLenum *binaryFormat, void *binary)
+    {
+#if GLES_VERSION >= 3
+        GL_CHECK(glGetProgramBinary(program, bufferSize, length, binaryFormat, binary));
+#else
+        GL_CHECK(getProgramBinaryOES(program, bufferSize, length, binaryFormat, binary));
+#endif
+    }
+
+    static void programBinary(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length)
+    {
+#if GLES_VERSION >= 3
+        GL_CHECK(glProgramBinary(program, binaryFormat, binary, length));
+#else
+        GL_CHECK(programBinaryOES(program, binaryFormat, binary, length));
+#endif
+    }
+
+    /* FNV-1a, the same hash SDFFont uses for its cache keys. */
+    static void hashBytes(unsigned long long *hash, const void *data, size_t size)
+    {
+        const unsigned char *bytes = (const unsigned char *)data;
+
+        for (size_t index = 0; index < size; index++)
+        {
+            *hash ^= bytes[index];
+            *hash *= 1099511628211ULL;
+        }
+    }
+
+    ShaderSet &ShaderSet::addFile(GLenum shaderType, const string &filename)
+    {
+        Stage stage;
+        stage.type = shaderType;
+        stage.filename = filename;
+        stages.push_back(stage);
+
+        return *this;
+    }
+
+    ShaderSet &ShaderSet::addSource(GLenum shaderType, const string &source)
+    {
+        Stage stage;
+        stage.type = shaderType;
+        stage.source = source;
+        stages.push_back(stage);
+
+        return *this;
+    }
+
+    ShaderSet &ShaderSet::addDefine(const string &name, const string &value)
+    {
+        defines.push_back(std::make_pair(name, value));
+
+        return *this;
+    }
+
+    ProgramLibrary::ProgramLibrary(void)
+        : driverInitialized(false),
+          binariesSupported(false),
+          threadStarted(false),
+          stopRequested(false),
+          busy(false),
+          busyHash(0),
+          display(EGL_NO_DISPLAY),
+          warmUpContext(EGL_NO_CONTEXT),
+          warmUpSurface(EGL_NO_SURFACE)
+    {
+        memset(&counters, 0, sizeof(counters));
+        pthread_mutex_init(&mutex, NULL);
+        pthread_cond_init(&condition, NULL);
+    }
+
+    ProgramLibrary::~ProgramLibrary(void)
+    {
+        joinWarmUp(true);
+
+        pthread_cond_destroy(&condition);
+        pthread_mutex_destroy(&mutex);
+    }
+
+    ProgramLibrary *ProgramLibrary::getInstance(void)
+    {
+        static ProgramLibrary library;
+
+        return &library;
+    }
+
+    void ProgramLibrary::setCacheDirectory(const string &directory)
+    {
+        cacheDirectory = directory;
+    }
+
+    ProgramLibrary::Counters ProgramLibrary::getCounters(void)
+    {
+        pthread_mutex_lock(&mutex);
+        Counters result = counters;
+        pthread_mutex_unlock(&mutex);
+
+        return result;
+    }
+
+    void ProgramLibrary::initializeDriver(void)
+    {
+        if (driverInitialized)
+        {
+            return;
+        }
+        driverInitialized = true;
+
+        /* GL_CHECK expands to more than one statement, so the results are stored before they are cast. */
+        const GLubyte *renderer = GL_CHECK(glGetString(GL_RENDERER));
+        const GLubyte *version = GL_CHECK(glGetString(GL_VERSION));
+
+        driverIdentity = string(renderer != NULL ? (const char *)renderer : "") + "\n" + (version != NULL ? (const char *)version : "");
+
+#if GLES_VERSION == 2
+        const GLubyte *extensions = GL_CHECK(glGetString(GL_EXTENSIONS));
+
+        if (extensions == NULL || strstr((const char *)extensions, "GL_OES_get_program_binary") == NULL)
+        {
+            LOGD("ProgramLibrary: GL_OES_get_program_binary is not supported, programs will not be cached.\n");
+            return;
+        }
+
+        getProgramBinaryOES = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+        programBinaryOES = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+
+        if (getProgramBinaryOES == NULL || programBinaryOES == NULL)
+        {
+            return;
+        }
+#endif
+
+        GLint numberOfFormats = 0;
+        GL_CHECK(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &numberOfFormats));
+
+        if (numberOfFormats > 0)
+        {
+            binaryFormats.resize(numberOfFormats);
+            GL_CHECK(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS_OES, &binaryFormats[0]));
+            binariesSupported = true;
+        }
+        else
+        {
+            LOGD("ProgramLibrary: the driver has no program binary formats, programs will not be cached.\n");
+        }
+    }
+
+    bool ProgramLibrary::prepare(const ShaderSet &shaderSet, PreparedProgram *program) const
+    {
+        const vector<ShaderSet::Stage> &stages = shaderSet.getStages();
+        const vector<pair<string, string> > &defines = shaderSet.getDefines();
+
+        string preamble;
+        for (size_t index = 0; index < defines.size(); index++)
+        {
+            preamble += "#define " + defines[index].first + " " + defines[index].second + "\n";
+        }
+
+        program->types.clear();
+        program->sources.clear();
+        program->hash = 14695981039346656037ULL;
+
+        for (size_t index = 0; index < stages.size(); index++)
+        {
+            string source = stages[index].source;
+
+            if (!stages[index].filename.empty())
+            {
+                AssetFile file;
+
+                if (!file.open(stages[index].filename.c_str()))
+                {
+                    LOGE("ProgramLibrary: cannot read shader: %s\n", file.getError());
+                    return false;
+                }
+                source.assign((const char *)file.getSpan().data, file.getSize());
+            }
+
+            if (!preamble.empty())
+            {
+                /* Defines have to follow #version, which must come first. */
+                size_t insertAt = 0;
+                int versionNumber = 100;
+                size_t version = source.find("#version");
+
+                if (version != string::npos)
+                {
+                    versionNumber = atoi(source.c_str() + version + strlen("#version"));
+                    insertAt = source.find('\n', version);
+                    if (insertAt == string::npos)
+                    {
+                        source += '\n';
+                        insertAt = source.size();
+                    }
+                    else
+                    {
+                        insertAt++;
+                    }
+                }
+
+                /* GLSL ES 1.00 numbers the line after "#line n" as n + 1, later versions as n. */
+                const int nextLine = (int)std::count(source.begin(), source.begin() + insertAt, '\n') + 1;
+                char lineDirective[32];
+                snprintf(lineDirective, sizeof(lineDirective), "#line %d\n", versionNumber >= 300 ? nextLine : nextLine - 1);
+
+                source.insert(insertAt, preamble + lineDirective);
+            }
+
+            const unsigned int type = stages[index].type;
+            hashBytes(&program->hash, &type, sizeof(type));
+            hashBytes(&program->hash, source.data(), source.size() + 1);
+
+            program->types.push_back(stages[index].type);
+            program->sources.push_back(source);
+        }
+
+        return true;
+    }
+
+    string ProgramLibrary::getBinaryFilename(const PreparedProgram &program) const
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "program-%016llx.bin", program.hash);
+
+        return cacheDirectory + name;
+    }
+
+    GLuint ProgramLibrary::loadBinary(const PreparedProgram &program, bool *invalid) const
+    {
+        const string filename = getBinaryFilename(program);
+        FILE *file = fopen(filename.c_str(), "rb");
+
+        *invalid = false;
+        if (file == NULL)
+        {
+            return 0;
+        }
+
+        char magic[4];
+        unsigned int version = 0;
+        unsigned int identityLength = 0;
+        unsigned long long hash = 0;
+        GLenum binaryFormat = 0;
+        unsigned int binaryLength = 0;
+
+        bool isValid = fread(magic, sizeof(magic), 1, file) == 1 &&
+                       memcmp(magic, binaryFileMagic, sizeof(magic)) == 0 &&
+                       fread(&version, sizeof(version), 1, file) == 1 &&
+                       version == binaryFileVersion &&
+                       fread(&identityLength, sizeof(identityLength), 1, file) == 1 &&
+                       identityLength < 65536;
+
+        string identity(identityLength, '\0');
+
+        isValid = isValid &&
+                  (identityLength == 0 || fread(&identity[0], identityLength, 1, file) == 1) &&
+                  identity == driverIdentity &&
+                  fread(&hash, sizeof(hash), 1, file) == 1 &&
+                  hash == program.hash &&
+                  fread(&binaryFormat, sizeof(binaryFormat), 1, file) == 1 &&
+                  std::find(binaryFormats.begin(), binaryFormats.end(), (GLint)binaryFormat) != binaryFormats.end() &&
+                  fread(&binaryLength, sizeof(binaryLength), 1, file) == 1 &&
+                  binaryLength > 0;
+
+        vector<unsigned char> binary(isValid ? binaryLength : 0);
+
+        isValid = isValid && fread(&binary[0], binaryLength, 1, file) == 1;
+
+        fclose(file);
+
+        if (!isValid)
+        {
+            LOGD("ProgramLibrary: %s was written by another driver or is damaged, recompiling.\n", filename.c_str());
+            *invalid = true;
+            return 0;
+        }
+
+        GLuint programID = GL_CHECK(glCreateProgram());
+        programBinary(programID, binaryFormat, &binary[0], (GLsizei)binaryLength);
+
+        /* Drivers may reject their own binaries, e.g. after an update which kept the version string. */
+        GLint status = GL_FALSE;
+        GL_CHECK(glGetProgramiv(programID, GL_LINK_STATUS, &status));
+
+        if (status != GL_TRUE)
+        {
+            LOGD("ProgramLibrary: the driver rejected %s, recompiling.\n", filename.c_str());
+            GL_CHECK(glDeleteProgram(programID));
+            *invalid = true;
+            return 0;
+        }
+
+        return programID;
+    }
+
+    void ProgramLibrary::saveBinary(const PreparedProgram &program, GLuint programID) const
+    {
+        GLint binaryLength = 0;
+        GL_CHECK(glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH_OES, &binaryLength));
+
+        if (binaryLength <= 0)
+        {
+            return;
+        }
+
+        vector<unsigned char> binary(binaryLength);
+        GLenum binaryFormat = 0;
+        GLsizei writtenLength = 0;
+        getProgramBinary(programID, binaryLength, &writtenLength, &binaryFormat, &binary[0]);
+
+        if (writtenLength <= 0)
+        {
+            return;
+        }
+
+        /* Written under a temporary name first, so an interrupted write never leaves a damaged binary behind. */
+        const string filename = getBinaryFilename(program);
+        const string temporaryFilename = filename + ".tmp";
+        FILE *file = fopen(temporaryFilename.c_str(), "wb");
+
+        if (file == NULL)
+        {
+            LOGE("ProgramLibrary: could not create %s.\n", temporaryFilename.c_str());
+            return;
+        }
+
+        const unsigned int identityLength = (unsigned int)driverIdentity.size();
+        const unsigned int length = (unsigned int)writtenLength;
+
+        bool isWritten = fwrite(binaryFileMagic, sizeof(binaryFileMagic), 1, file) == 1 &&
+                         fwrite(&binaryFileVersion, sizeof(binaryFileVersion), 1, file) == 1 &&
+                         fwrite(&identityLength, sizeof(identityLength), 1, file) == 1 &&
+                         (identityLength == 0 || fwrite(driverIdentity.data(), identityLength, 1, file) == 1) &&
+                         fwrite(&program.hash, sizeof(program.hash), 1, file) == 1 &&
+                         fwrite(&binaryFormat, sizeof(binaryFormat), 1, file) == 1 &&
+                         fwrite(&length, sizeof(length), 1, file) == 1 &&
+                         fwrite(&binary[0], length, 1, file) == 1;
+
+        isWritten = fclose(file) == 0 && isWritten;
+        isWritten = isWritten && rename(temporaryFilename.c_str(), filename.c_str()) == 0;
+
+        if (!isWritten)
+        {
+            LOGE("ProgramLibrary: could not write %s.\n", filename.c_str());
+            remove(temporaryFilename.c_str());
+        }
+    }
+
+    GLuint ProgramLibrary::build(const PreparedProgram &program)
+    {
+        const bool useCache = binariesSupported && !cacheDirectory.empty();
+
+        if (useCache)
+        {
+            bool invalid = false;
+            GLuint programID = loadBinary(program, &invalid);
+
+            pthread_mutex_lock(&mutex);
+            counters.loaded += programID != 0 ? 1 : 0;
+            counters.invalidated += invalid ? 1 : 0;
+            pthread_mutex_unlock(&mutex);
+
+            if (programID != 0)
+            {
+                return programID;
+            }
+        }
+
+        vector<GLuint> shaders;
+        for (size_t index = 0; index < program.sources.size(); index++)
+        {
+            const char *strings[1] = { program.sources[index].c_str() };
+            GLuint shader = 0;
+
+            if (!Shader::compileShader(&shader, program.types[index], 1, strings, NULL))
+            {
+                for (size_t compiled = 0; compiled < shaders.size(); compiled++)
+                {
+                    GL_CHECK(glDeleteShader(shaders[compiled]));
+                }
+                return 0;
+            }
+            shaders.push_back(shader);
+        }
+
+        GLuint programID = GL_CHECK(glCreateProgram());
+
+        for (size_t index = 0; index < shaders.size(); index++)
+        {
+            GL_CHECK(glAttachShader(programID, shaders[index]));
+        }
+
+#if GLES_VERSION >= 3
+        if (useCache)
+        {
+            GL_CHECK(glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE));
+        }
+#endif
+
+        GL_CHECK(glLinkProgram(programID));
+
+        /* The program keeps what it needs from the shaders. */
+        for (size_t index = 0; index < shaders.size(); index++)
+        {
+            GL_CHECK(glDetachShader(programID, shaders[index]));
+            GL_CHECK(glDeleteShader(shaders[index]));
+        }
+
+        GLint status = GL_FALSE;
+        GL_CHECK(glGetProgramiv(programID, GL_LINK_STATUS, &status));
+
+        if (status != GL_TRUE)
+        {
+            GLint length = 0;
+            GL_CHECK(glGetProgramiv(programID, GL_INFO_LOG_LENGTH, &length));
+
+            vector<char> errorLog(length > 0 ? length : 1, '\0');
+            GL_CHECK(glGetProgramInfoLog(programID, (GLsizei)errorLog.size(), NULL, &errorLog[0]));
+            LOGE("ProgramLibrary: program failed to link:\n%s\n", &errorLog[0]);
+
+            GL_CHECK(glDeleteProgram(programID));
+            return 0;
+        }
+
+        pthread_mutex_lock(&mutex);
+        counters.compiled++;
+        pthread_mutex_unlock(&mutex);
+
+        if (useCache)
+        {
+            saveBinary(program, programID);
+        }
+
+        return programID;
+    }
+
+    GLuint ProgramLibrary::getProgram(const ShaderSet &shaderSet)
+    {
+        initializeDriver();
+
+        PreparedProgram program;
+        if (!prepare(shaderSet, &program))
+        {
+            return 0;
+        }
+
+        pthread_mutex_lock(&mutex);
+
+        /* Only the program being linked right now is worth waiting for. */
+        while (busy && busyHash == program.hash)
+        {
+            pthread_cond_wait(&condition, &mutex);
+        }
+
+        map<unsigned long long, GLuint>::iterator warmedUpProgram = warmedUp.find(program.hash);
+        if (warmedUpProgram != warmedUp.end())
+        {
+            GLuint programID = warmedUpProgram->second;
+
+            warmedUp.erase(warmedUpProgram);
+            counters.warmedUp++;
+            pthread_mutex_unlock(&mutex);
+
+            return programID;
+        }
+
+        /* Not started yet, so take it over from the warm-up thread. */
+        queued.erase(program.hash);
+        pthread_mutex_unlock(&mutex);
+
+        return build(program);
+    }
+
+    bool ProgramLibrary::startWarmUp(const vector<ShaderSet> &shaderSets)
+    {
+        if (threadStarted)
+        {
+            return false;
+        }
+
+        initializeDriver();
+
+        EGLContext context = eglGetCurrentContext();
+        display = eglGetCurrentDisplay();
+
+        if (context == EGL_NO_CONTEXT)
+        {
+            LOGE("ProgramLibrary: warm-up needs a current context to share with.\n");
+            return false;
+        }
+
+        /* A shared context has to match the client API version and should use the same configuration. */
+        EGLint configID = 0;
+        EGLint clientVersion = 2;
+        eglQueryContext(display, context, EGL_CONFIG_ID, &configID);
+        eglQueryContext(display, context, EGL_CONTEXT_CLIENT_VERSION, &clientVersion);
+
+        const EGLint configAttributes[] = { EGL_CONFIG_ID, configID, EGL_NONE };
+        const EGLint contextAttributes[] = { EGL_CONTEXT_CLIENT_VERSION, clientVersion, EGL_NONE };
+        EGLConfig config;
+        EGLint numberOfConfigs = 0;
+
+        if (!eglChooseConfig(display, configAttributes, &config, 1, &numberOfConfigs) || numberOfConfigs != 1)
+        {
+            LOGE("ProgramLibrary: could not find the configuration of the current context.\n");
+            return false;
+        }
+
+        warmUpContext = eglCreateContext(display, config, context, contextAttributes);
+        if (warmUpContext == EGL_NO_CONTEXT)
+        {
+            LOGE("ProgramLibrary: could not create a shared context (EGL error 0x%x).\n", (unsigned int)eglGetError());
+            return false;
+        }
+
+        /* The thread never renders, so it only needs a surface where surfaceless contexts are not supported. */
+        const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+        warmUpSurface = EGL_NO_SURFACE;
+
+        if (extensions == NULL || strstr(extensions, "EGL_KHR_surfaceless_context") == NULL)
+        {
+            const EGLint surfaceAttributes[] = { EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE };
+
+            warmUpSurface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+            if (warmUpSurface == EGL_NO_SURFACE)
+            {
+                LOGE("ProgramLibrary: could not create a surface for the warm-up thread.\n");
+                eglDestroyContext(display, warmUpContext);
+                warmUpContext = EGL_NO_CONTEXT;
+                return false;
+            }
+        }
+
+        pthread_mutex_lock(&mutex);
+        stopRequested = false;
+        for (size_t index = 0; index < shaderSets.size(); index++)
+        {
+            PreparedProgram program;
+
+            if (prepare(shaderSets[index], &program))
+            {
+                queue.push_back(program);
+                queued.insert(program.hash);
+            }
+        }
+        pthread_mutex_unlock(&mutex);
+
+        threadStarted = pthread_create(&thread, NULL, warmUpThreadEntry, this) == 0;
+
+        if (!threadStarted)
+        {
+            LOGE("ProgramLibrary: could not start the warm-up thread.\n");
+            joinWarmUp(true);
+        }
+
+        return threadStarted;
+    }
+
+    void *ProgramLibrary::warmUpThreadEntry(void *argument)
+    {
+        ((ProgramLibrary *)argument)->warmUp();
+
+        return NULL;
+    }
+
+    void ProgramLibrary::warmUp(void)
+    {
+        if (!eglMakeCurrent(display, warmUpSurface, warmUpSurface, warmUpContext))
+        {
+            LOGE("ProgramLibrary: could not make the warm-up context current (EGL error 0x%x).\n", (unsigned int)eglGetError());
+
+            /* Leave the queued programs to getProgram(). */
+            pthread_mutex_lock(&mutex);
+            queue.clear();
+            queued.clear();
+            pthread_mutex_unlock(&mutex);
+
+            eglReleaseThread();
+            return;
+        }
+
+        pthread_mutex_lock(&mutex);
+
+        for (size_t index = 0; index < queue.size() && !stopRequested; index++)
+        {
+            const PreparedProgram &program = queue[index];
+
+            /* Skip programs which getProgram() took over, and repeated entries. */
+            if (queued.erase(program.hash) == 0)
+            {
+                continue;
+            }
+
+            busy = true;
+            busyHash = program.hash;
+            pthread_mutex_unlock(&mutex);
+
+            GLuint programID = build(program);
+
+            /* Changes to shared objects are only guaranteed to be visible in other contexts once they have completed. */
+            if (programID != 0)
+            {
+                GL_CHECK(glFinish());
+            }
+
+            pthread_mutex_lock(&mutex);
+            if (programID != 0)
+            {
+                warmedUp[program.hash] = programID;
+            }
+            busy = false;
+            pthread_cond_broadcast(&condition);
+        }
+
+        queue.clear();
+        queued.clear();
+        pthread_mutex_unlock(&mutex);
+
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglReleaseThread();
+    }
+
+    void ProgramLibrary::joinWarmUp(bool cancel)
+    {
+        if (threadStarted)
+        {
+            pthread_mutex_lock(&mutex);
+            stopRequested = cancel;
+            pthread_mutex_unlock(&mutex);
+
+            pthread_join(thread, NULL);
+            threadStarted = false;
+        }
+
+        pthread_mutex_lock(&mutex);
+        queue.clear();
+        queued.clear();
+        pthread_mutex_unlock(&mutex);
+
+        if (warmUpSurface != EGL_NO_SURFACE)
+        {
+            eglDestroySurface(display, warmUpSurface);
+            warmUpSurface = EGL_NO_SURFACE;
+        }
+        if (warmUpContext != EGL_NO_CONTEXT)
+        {
+            eglDestroyContext(display, warmUpContext);
+            warmUpContext = EGL_NO_CONTEXT;
+        }
+    }
+
+    void ProgramLibrary::finishWarmUp(void)
+    {
+        joinWarmUp(false);
+
+        for (map<unsigned long long, GLuint>::iterator program = warmedUp.begin(); program != warmedUp.end(); ++program)
+        {
+            GL_CHECK(glDeleteProgram(program->second));
+        }
+        warmedUp.clear();
+    }
+}
@@ -0,0 +1,740 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SDFFont.h"
+#include "Platform.h"
+#include "Texture.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/stat.h>
+
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    /* Identifies atlas files written by SDFFont::save(). */
+    static const char atlasFileMagic[4] = { 'S', 'D', 'F', 'A' };
+    static const unsigned int atlasFileVersion = 1;
+
+    /* Largest atlas generate() will create. */
+    static const int maximumAtlasSize = 4096;
+
+    /* Squared distance used for "no feature" in the distance transform. */
+    static const double infiniteDistance = 1e20;
+
+    BitmapFontGlyphSource::BitmapFontGlyphSource(const char *filename, int textureWidth, int textureHeight, int cellWidth, int cellHeight, unsigned int firstCodePoint)
+        : filename(filename),
+          textureWidth(textureWidth),
+          textureHeight(textureHeight),
+          cellWidth(cellWidth),
+          cellHeight(cellHeight),
+          firstCodePoint(firstCodePoint),
+          textureData(NULL)
+    {
+    }
+
+    BitmapFontGlyphSource::~BitmapFontGlyphSource(void)
+    {
+        free(textureData);
+    }
+
+    float BitmapFontGlyphSource::getLineHeight(void) const
+    {
+        return (float)cellHeight;
+    }
+
+    string BitmapFontGlyphSource::getIdentifier(void) const
+    {
+        struct stat fileStatus;
+        long long modificationTime = 0;
+        long long fileSize = 0;
+
+        if (stat(filename.c_str(), &fileStatus) == 0)
+        {
+            modificationTime = (long long)fileStatus.st_mtime;
+            fileSize = (long long)fileStatus.st_size;
+        }
+
+        char description[128];
+        snprintf(description, sizeof(description), ":%dx%d:%dx%d:%u:%lld:%lld",
+                 textureWidth, textureHeight, cellWidth, cellHeight, firstCodePoint, fileSize, modificationTime);
+
+        return filename + description;
+    }
+
+    bool BitmapFontGlyphSource::getGlyph(unsigned int codePoint, GlyphImage *image)
+    {
+        const int columns = textureWidth / cellWidth;
+        const int rows = textureHeight / cellHeight;
+
+        if (codePoint < firstCodePoint || codePoint - firstCodePoint >= (unsigned int)(columns * rows))
+        {
+            return false;
+        }
+
+        /* The texture is only read when the first glyph is needed, so a valid cache never touches it. */
+        if (textureData == NULL && !Texture::loadData(filename.c_str(), &textureData))
+        {
+            return false;
+        }
+
+        const int cell = codePoint - firstCodePoint;
+        const int cellX = (cell % columns) * cellWidth;
+        const int cellY = (cell / columns) * cellHeight;
+
+        /* Trim the cell to the texels with ink. */
+        int left = cellWidth, right = 0, top = cellHeight, bottom = 0;
+
+        for (int y = 0; y < cellHeight; y++)
+        {
+            for (int x = 0; x < cellWidth; x++)
+            {
+                if (textureData[((cellY + y) * textureWidth + cellX + x) * 4 + 3] >= 128)
+                {
+                    left = std::min(left, x);
+                    right = std::max(right, x + 1);
+                    top = std::min(top, y);
+                    bottom = std::max(bottom, y + 1);
+                }
+            }
+        }
+
+        image->advance = (float)cellWidth;
+
+        if (left >= right)
+        {
+            image->width = 0;
+            image->height = 0;
+            image->bearingX = 0.0f;
+            image->bearingY = 0.0f;
+            image->coverage.clear();
+
+            return true;
+        }
+
+        image->width = right - left;
+        image->height = bottom - top;
+        image->bearingX = (float)left;
+        image->bearingY = (float)(cellHeight - bottom);
+        image->coverage.resize(image->width * image->height);
+
+        for (int y = 0; y < image->height; y++)
+        {
+            for (int x = 0; x < image->width; x++)
+            {
+                image->coverage[y * image->width + x] = textureData[((cellY + top + y) * textureWidth + cellX + left + x) * 4 + 3];
+            }
+        }
+
+        return true;
+    }
+
+    SDFFont::SDFFont(void)
+        : atlasWidth(0),
+          atlasHeight(0),
+          spread(0),
+          lineHeight(0.0f),
+          texelsPerUnit(0.0f)
+    {
+    }
+
+    string SDFFont::makeKey(const GlyphSource &source, const vector<unsigned int> &codePoints, int texelsPerLine, int spread)
+    {
+        /* FNV-1a over the code points keeps the key short for large glyph sets. */
+        unsigned long long hash = 14695981039346656037ULL;
+
+        for (size_t index = 0; index < codePoints.size(); index++)
+        {
+            for (int byte = 0; byte < 4; byte++)
+            {
+                hash ^= (codePoints[index] >> (byte * 8)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        }
+
+        char settings[96];
+        snprintf(settings, sizeof(settings), "|%d|%d|%u|%016llx", texelsPerLine, spread, (unsigned int)codePoints.size(), hash);
+
+        return source.getIdentifier() + settings;
+    }
+
+    /*
+     * One dimensional squared Euclidean distance transform of sampled functions
+     * (Felzenszwalb and Huttenlocher), applied in place to count values spaced stride apart.
+     */
+    void SDFFont::distanceTransform(double *values, int count, int stride, double *line, double *envelope, int *parabolas)
+    {
+        for (int index = 0; index < count; index++)
+        {
+            line[index] = values[index * stride];
+        }
+
+        int lowest = 0;
+        parabolas[0] = 0;
+        envelope[0] = -infiniteDistance;
+        envelope[1] = infiniteDistance;
+
+        for (int q = 1; q < count; q++)
+        {
+            double intersection;
+
+            while (true)
+            {
+                const int p = parabolas[lowest];
+
+                intersection = ((line[q] + (double)q * q) - (line[p] + (double)p * p)) / (2.0 * (q - p));
+
+                if (intersection > envelope[lowest])
+                {
+                    break;
+                }
+                lowest--;
+            }
+
+            lowest++;
+            parabolas[lowest] = q;
+            envelope[lowest] = intersection;
+            envelope[lowest + 1] = infiniteDistance;
+        }
+
+        lowest = 0;
+
+        for (int q = 0; q < count; q++)
+        {
+            while (envelope[lowest + 1] < q)
+            {
+                lowest++;
+            }
+
+            const int p = parabolas[lowest];
+
+            values[q * stride] = (double)(q - p) * (q - p) + line[p];
+        }
+    }
+
+    void SDFFont::renderGlyph(const GlyphImage &image, const SDFGlyph &glyph)
+    {
+        /*
+         * Distances are found on a working grid at least as fine as both the source image and the atlas:
+         * the atlas grid when the glyph is enlarged, the source grid when it is reduced.
+         */
+        const float texelsPerWorkingTexel = texelsPerUnit >= 1.0f ? 1.0f : texelsPerUnit;
+        const float unitsPerWorkingTexel = texelsPerWorkingTexel / texelsPerUnit;
+        const int workingWidth = (int)ceilf(glyph.atlasWidth / texelsPerWorkingTexel);
+        const int workingHeight = (int)ceilf(glyph.atlasHeight / texelsPerWorkingTexel);
+        const float border = spread / texelsPerUnit;
+        const int longestSide = std::max(workingWidth, workingHeight);
+
+        vector<double> toInside(workingWidth * workingHeight);
+        vector<double> toOutside(workingWidth * workingHeight);
+        vector<double> line(longestSide);
+        vector<double> envelope(longestSide + 1);
+        vector<int> parabolas(longestSide);
+
+        for (int y = 0; y < workingHeight; y++)
+        {
+            const int imageY = (int)floorf((y + 0.5f) * unitsPerWorkingTexel - border);
+
+            for (int x = 0; x < workingWidth; x++)
+            {
+                const int imageX = (int)floorf((x + 0.5f) * unitsPerWorkingTexel - border);
+                const bool isInside = imageX >= 0 && imageX < image.width &&
+                                      imageY >= 0 && imageY < image.height &&
+                                      image.coverage[imageY * image.width + imageX] >= 128;
+
+                toInside[y * workingWidth + x] = isInside ? 0.0 : infiniteDistance;
+                toOutside[y * workingWidth + x] = isInside ? infiniteDistance : 0.0;
+            }
+        }
+
+        for (int x = 0; x < workingWidth; x++)
+        {
+            distanceTransform(&toInside[x], workingHeight, workingWidth, &line[0], &envelope[0], &parabolas[0]);
+            distanceTransform(&toOutside[x], workingHeight, workingWidth, &line[0], &envelope[0], &parabolas[0]);
+        }
+
+        for (int y = 0; y < workingHeight; y++)
+        {
+            distanceTransform(&toInside[y * workingWidth], workingWidth, 1, &line[0], &envelope[0], &parabolas[0]);
+            distanceTransform(&toOutside[y * workingWidth], workingWidth, 1, &line[0], &envelope[0], &parabolas[0]);
+        }
+
+        /* Signed distance from texel centre to the outline, positive outside. The outline lies half a texel from the nearest centre. */
+        vector<float> distances(workingWidth * workingHeight);
+
+        for (int index = 0; index < workingWidth * workingHeight; index++)
+        {
+            if (toOutside[index] > 0.0)
+            {
+                distances[index] = 0.5f - (float)sqrt(toOutside[index]);
+            }
+            else
+            {
+                distances[index] = (float)sqrt(toInside[index]) - 0.5f;
+            }
+        }
+
+        const float valuePerTexel = 127.0f / spread;
+
+        for (int y = 0; y < glyph.atlasHeight; y++)
+        {
+            const float workingY = std::min(std::max((y + 0.5f) / texelsPerWorkingTexel - 0.5f, 0.0f), (float)(workingHeight - 1));
+            const int y0 = (int)workingY;
+            const int y1 = std::min(y0 + 1, workingHeight - 1);
+            const float fractionY = workingY - y0;
+
+            unsigned char *row = &atlas[(glyph.atlasY + y) * atlasWidth + glyph.atlasX];
+
+            for (int x = 0; x < glyph.atlasWidth; x++)
+            {
+                const float workingX = std::min(std::max((x + 0.5f) / texelsPerWorkingTexel - 0.5f, 0.0f), (float)(workingWidth - 1));
+                const int x0 = (int)workingX;
+                const int x1 = std::min(x0 + 1, workingWidth - 1);
+                const float fractionX = workingX - x0;
+
+                const float top = distances[y0 * workingWidth + x0] * (1.0f - fractionX) + distances[y0 * workingWidth + x1] * fractionX;
+                const float bottom = distances[y1 * workingWidth + x0] * (1.0f - fractionX) + distances[y1 * workingWidth + x1] * fractionX;
+                const float distance = (top * (1.0f - fractionY) + bottom * fractionY) * texelsPerWorkingTexel;
+                const float value = floorf(128.0f - distance * valuePerTexel + 0.5f);
+
+                row[x] = (unsigned char)std::min(std::max(value, 0.0f), 255.0f);
+            }
+        }
+    }
+
+    /* Sorts glyphs for shelf packing: tallest first. */
+    struct CompareGlyphHeight
+    {
+        const vector<SDFGlyph> *glyphs;
+
+        bool operator()(int first, int second) const
+        {
+            return (*glyphs)[first].atlasHeight > (*glyphs)[second].atlasHeight;
+        }
+    };
+
+    bool SDFFont::generate(GlyphSource *source, const vector<unsigned int> &codePoints, int texelsPerLine, int spread)
+    {
+        vector<unsigned int> uniqueCodePoints(codePoints);
+        std::sort(uniqueCodePoints.begin(), uniqueCodePoints.end());
+        uniqueCodePoints.erase(std::unique(uniqueCodePoints.begin(), uniqueCodePoints.end()), uniqueCodePoints.end());
+
+        this->spread = std::max(spread, 1);
+        lineHeight = source->getLineHeight();
+        texelsPerUnit = texelsPerLine / lineHeight;
+        key = makeKey(*source, uniqueCodePoints, texelsPerLine, this->spread);
+        glyphs.clear();
+        atlas.clear();
+        atlasWidth = 0;
+        atlasHeight = 0;
+
+        vector<GlyphImage> images;
+        images.reserve(uniqueCodePoints.size());
+
+        const float border = this->spread / texelsPerUnit;
+        int area = 0;
+        int widest = 0;
+
+        for (size_t index = 0; index < uniqueCodePoints.size(); index++)
+        {
+            GlyphImage image;
+
+            if (!source->getGlyph(uniqueCodePoints[index], &image))
+            {
+                LOGE("SDFFont: no glyph for U+%04X.\n", uniqueCodePoints[index]);
+                continue;
+            }
+
+            SDFGlyph glyph;
+            memset(&glyph, 0, sizeof(glyph));
+            glyph.codePoint = uniqueCodePoints[index];
+            glyph.advance = image.advance;
+
+            if (image.width > 0 && image.height > 0)
+            {
+                const int imageWidth = (int)ceilf(image.width * texelsPerUnit);
+                const int imageHeight = (int)ceilf(image.height * texelsPerUnit);
+
+                glyph.atlasWidth = (unsigned short)(imageWidth + 2 * this->spread);
+                glyph.atlasHeight = (unsigned short)(imageHeight + 2 * this->spread);
+                glyph.width = glyph.atlasWidth / texelsPerUnit;
+                glyph.height = glyph.atlasHeight / texelsPerUnit;
+                glyph.left = image.bearingX - border;
+                glyph.bottom = image.bearingY - (glyph.atlasHeight - this->spread) / texelsPerUnit + image.height;
+
+                area += (glyph.atlasWidth + 1) * (glyph.atlasHeight + 1);
+                widest = std::max(widest, (int)glyph.atlasWidth + 1);
+            }
+
+            glyphs.push_back(glyph);
+            images.push_back(image);
+        }
+
+        if (glyphs.empty())
+        {
+            LOGE("SDFFont: no glyphs to put in the atlas.\n");
+            return false;
+        }
+
+        /* Square-ish power of two width, then shelves of the tallest glyphs first. */
+        atlasWidth = 16;
+
+        while (atlasWidth < maximumAtlasSize && (atlasWidth * atlasWidth < area || atlasWidth < widest))
+        {
+            atlasWidth *= 2;
+        }
+
+        vector<int> order(glyphs.size());
+
+        for (size_t index = 0; index < order.size(); index++)
+        {
+            order[index] = (int)index;
+        }
+
+        CompareGlyphHeight compare = { &glyphs };
+        std::stable_sort(order.begin(), order.end(), compare);
+
+        int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+        for (size_t index = 0; index < order.size(); index++)
+        {
+            SDFGlyph &glyph = glyphs[order[index]];
+
+            if (glyph.atlasWidth == 0)
+            {
+                continue;
+            }
+
+            if (shelfX + glyph.atlasWidth > atlasWidth)
+            {
+                shelfX = 0;
+                shelfY += shelfHeight + 1;
+                shelfHeight = 0;
+            }
+
+            glyph.atlasX = (unsigned short)shelfX;
+            glyph.atlasY = (unsigned short)shelfY;
+            shelfX += glyph.atlasWidth + 1;
+            shelfHeight = std::max(shelfHeight, (int)glyph.atlasHeight);
+        }
+
+        atlasHeight = (shelfY + shelfHeight + 3) & ~3;
+
+        if (atlasWidth > maximumAtlasSize || atlasHeight > maximumAtlasSize || widest > maximumAtlasSize)
+        {
+            LOGE("SDFFont: %u glyphs do not fit in a %dx%d atlas.\n", (unsigned int)glyphs.size(), maximumAtlasSize, maximumAtlasSize);
+            glyphs.clear();
+            atlasWidth = 0;
+            atlasHeight = 0;
+            return false;
+        }
+
+        atlasHeight = std::max(atlasHeight, 4);
+        atlas.assign(atlasWidth * atlasHeight, 0);
+
+        for (size_t index = 0; index < glyphs.size(); index++)
+        {
+            if (glyphs[index].atlasWidth > 0)
+            {
+                renderGlyph(images[index], glyphs[index]);
+            }
+        }
+
+        LOGD("SDFFont: %u glyphs in a %dx%d atlas.\n", (unsigned int)glyphs.size(), atlasWidth, atlasHeight);
+
+        return true;
+    }
+
+    bool SDFFont::load(const char *filename)
+    {
+        FILE *file = fopen(filename, "rb");
+
+        if (file == NULL)
+        {
+            return false;
+        }
+
+        char magic[4];
+        unsigned int version = 0;
+        unsigned int keyLength = 0;
+        int header[3];
+        float metrics[2];
+        unsigned int numberOfGlyphs = 0;
+
+        bool isValid = fread(magic, sizeof(magic), 1, file) == 1 &&
+                       memcmp(magic, atlasFileMagic, sizeof(magic)) == 0 &&
+                       fread(&version, sizeof(version), 1, file) == 1 &&
+                       version == atlasFileVersion &&
+                       fread(&keyLength, sizeof(keyLength), 1, file) == 1 &&
+                       keyLength < 65536;
+
+        string fileKey(keyLength, '\0');
+
+        isValid = isValid &&
+                  (keyLength == 0 || fread(&fileKey[0], keyLength, 1, file) == 1) &&
+                  fread(header, sizeof(header), 1, file) == 1 &&
+                  fread(metrics, sizeof(metrics), 1, file) == 1 &&
+                  fread(&numberOfGlyphs, sizeof(numberOfGlyphs), 1, file) == 1 &&
+                  header[0] > 0 && header[0] <= maximumAtlasSize &&
+                  header[1] > 0 && header[1] <= maximumAtlasSize &&
+                  numberOfGlyphs > 0 && numberOfGlyphs <= 1 << 20;
+
+        vector<SDFGlyph> fileGlyphs;
+        vector<unsigned char> fileAtlas;
+
+        if (isValid)
+        {
+            fileGlyphs.resize(numberOfGlyphs);
+            fileAtlas.resize(header[0] * header[1]);
+
+            isValid = fread(&fileGlyphs[0], sizeof(SDFGlyph), numberOfGlyphs, file) == numberOfGlyphs &&
+                      fread(&fileAtlas[0], fileAtlas.size(), 1, file) == 1;
+        }
+
+        /* findGlyph() relies on the order, and Text reads the atlas through the rectangles. */
+        for (size_t index = 0; isValid && index < fileGlyphs.size(); index++)
+        {
+            const SDFGlyph &glyph = fileGlyphs[index];
+
+            isValid = glyph.atlasX + glyph.atlasWidth <= header[0] &&
+                      glyph.atlasY + glyph.atlasHeight <= header[1] &&
+                      (index == 0 || fileGlyphs[index - 1].codePoint < glyph.codePoint);
+        }
+
+        fclose(file);
+
+        if (!isValid)
+        {
+            LOGE("SDFFont: %s is not a valid atlas file.\n", filename);
+            return false;
+        }
+
+        key.swap(fileKey);
+        atlasWidth = header[0];
+        atlasHeight = header[1];
+        spread = header[2];
+        lineHeight = metrics[0];
+        texelsPerUnit = metrics[1];
+        glyphs.swap(fileGlyphs);
+        atlas.swap(fileAtlas);
+
+        return true;
+    }
+
+    bool SDFFont::save(const char *filename) const
+    {
+        if (glyphs.empty())
+        {
+            return false;
+        }
+
+        FILE *file = fopen(filename, "wb");
+
+        if (file == NULL)
+        {
+            LOGE("SDFFont: could not create %s.\n", filename);
+            return false;
+        }
+
+        const unsigned int keyLength = (unsigned int)key.size();
+        const int header[3] = { atlasWidth, atlasHeight, spread };
+        const float metrics[2] = { lineHeight, texelsPerUnit };
+        const unsigned int numberOfGlyphs = (unsigned int)glyphs.size();
+
+        bool isWritten = fwrite(atlasFileMagic, sizeof(atlasFileMagic), 1, file) == 1 &&
+                         fwrite(&atlasFileVersion, sizeof(atlasFileVersion), 1, file) == 1 &&
+                         fwrite(&keyLength, sizeof(keyLength), 1, file) == 1 &&
+                         (keyLength == 0 || fwrite(key.data(), keyLength, 1, file) == 1) &&
+                         fwrite(header, sizeof(header), 1, file) == 1 &&
+                         fwrite(metrics, sizeof(metrics), 1, file) == 1 &&
+                         fwrite(&numberOfGlyphs, sizeof(numberOfGlyphs), 1, file) == 1 &&
+                         fwrite(&glyphs[0], sizeof(SDFGlyph), numberOfGlyphs, file) == numberOfGlyphs &&
+                         fwrite(&atlas[0], atlas.size(), 1, file) == 1;
+
+        isWritten = fclose(file) == 0 && isWritten;
+
+        if (!isWritten)
+        {
+            LOGE("SDFFont: could not write %s.\n", filename);
+            remove(filename);
+        }
+
+        return isWritten;
+    }
+
+    bool SDFFont::create(GlyphSource *source, const vector<unsigned int> &codePoints, const char *cacheFilename, int texelsPerLine, int spread)
+    {
+        vector<unsigned int> uniqueCodePoints(codePoints);
+        std::sort(uniqueCodePoints.begin(), uniqueCodePoints.end());
+        uniqueCodePoints.erase(std::unique(uniqueCodePoints.begin(), uniqueCodePoints.end()), uniqueCodePoints.end());
+
+        if (load(cacheFilename) && key == makeKey(*source, uniqueCodePoints, texelsPerLine, std::max(spread, 1)))
+        {
+            LOGD("SDFFont: using cached atlas %s.\n", cacheFilename);
+            return true;
+        }
+
+        if (!generate(source, uniqueCodePoints, texelsPerLine, spread))
+        {
+            return false;
+        }
+
+        save(cacheFilename);
+
+        return true;
+    }
+
+    GLuint SDFFont::createTexture(void) const
+    {
+        if (atlas.empty())
+        {
+            return 0;
+        }
+
+        GLuint textureID = 0;
+        GLint unpackAlignment = 4;
+
+        GL_CHECK(glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment));
+        GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+        GL_CHECK(glGenTextures(1, &textureID));
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+#if GLES_VERSION == 3
+        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth, atlasHeight, 0, GL_RED, GL_UNSIGNED_BYTE, &atlas[0]));
+#else
+        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_LUMINANCE, atlasWidth, atlasHeight, 0, GL_LUMINANCE, GL_UNSIGNED_BYTE, &atlas[0]));
+#endif
+        GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment));
+
+        return textureID;
+    }
+
+    const SDFGlyph *SDFFont::findGlyph(unsigned int codePoint) const
+    {
+        /* Glyphs are stored sorted by code point. */
+        size_t first = 0;
+        size_t last = glyphs.size();
+
+        while (first < last)
+        {
+            const size_t middle = (first + last) / 2;
+
+            if (glyphs[middle].codePoint < codePoint)
+            {
+                first = middle + 1;
+            }
+            else
+            {
+                last = middle;
+            }
+        }
+
+        return first < glyphs.size() && glyphs[first].codePoint == codePoint ? &glyphs[first] : NULL;
+    }
+
+    unsigned int SDFFont::decodeUTF8(const char **string)
+    {
+        const unsigned char *bytes = (const unsigned char *)*string;
+        const unsigned int replacement = 0xFFFD;
+
+        if (bytes[0] == 0)
+        {
+            return 0;
+        }
+
+        int length;
+        unsigned int codePoint;
+
+        if (bytes[0] < 0x80)
+        {
+            length = 1;
+            codePoint = bytes[0];
+        }
+        else if ((bytes[0] & 0xE0) == 0xC0)
+        {
+            length = 2;
+            codePoint = bytes[0] & 0x1F;
+        }
+        else if ((bytes[0] & 0xF0) == 0xE0)
+        {
+            length = 3;
+            codePoint = bytes[0] & 0x0F;
+        }
+        else if ((bytes[0] & 0xF8) == 0xF0)
+        {
+            length = 4;
+            codePoint = bytes[0] & 0x07;
+        }
+        else
+        {
+            *string += 1;
+            return replacement;
+        }
+
+        for (int index = 1; index < length; index++)
+        {
+            if ((bytes[index] & 0xC0) != 0x80)
+            {
+                /* Truncated sequence: resume at the byte which broke it. */
+                *string += index;
+                return replacement;
+            }
+            codePoint = (codePoint << 6) | (bytes[index] & 0x3F);
+        }
+
+        *string += length;
+
+        static const unsigned int smallestCodePoint[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+        if (codePoint < smallestCodePoint[length] || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint <= 0xDFFF))
+        {
+            return replacement;
+        }
+
+        return codePoint;
+    }
+
+    void SDFFont::addCodePoints(const char *string, vector<unsigned int> *codePoints)
+    {
+        unsigned int codePoint;
+
+        while ((codePoint = decodeUTF8(&string)) != 0)
+        {
+            codePoints->push_back(codePoint);
+        }
+    }
+
+    void SDFFont::addCodePoints(unsigned int first, unsigned int last, vector<unsigned int> *codePoints)
+    {
+        for (unsigned int codePoint = first; codePoint <= last; codePoint++)
+        {
+            codePoints->push_back(codePoint);
+        }
+    }
+}
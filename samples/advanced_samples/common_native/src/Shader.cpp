@@ -28,16 +28,27 @@ namespace MaliSDK
 {
     void Shader::processShader(GLuint *shader, const char *filename, GLint shaderType)
     {  
-        const char *strings[1] = { NULL };
+        AssetFile file;
 
-        /* Create shader and load into GL. */
-        *shader = GL_CHECK(glCreateShader(shaderType));
-        strings[0] = loadShader(filename);
-        GL_CHECK(glShaderSource(*shader, 1, strings, NULL));
+        if (!loadShader(filename, &file))
+        {
+            exit(1);
+        }
+
+        /* The source is not null-terminated, so pass its length. */
+        const char *strings[1] = { (const char *)file.getSpan().data };
+        const GLint lengths[1] = { (GLint)file.getSize() };
+
+        if (!compileShader(shader, shaderType, 1, strings, lengths))
+        {
+            exit(1);
+        }
+    }
 
-        /* Clean up shader source. */
-        free((void *)(strings[0]));
-        strings[0] = NULL;
+    bool Shader::compileShader(GLuint *shader, GLenum shaderType, GLsizei count, const char * const *strings, const GLint *lengths)
+    {
+        *shader = GL_CHECK(glCreateShader(shaderType));
+        GL_CHECK(glShaderSource(*shader, count, strings, lengths));
 
         /* Try compiling the shader. */
         GL_CHECK(glCompileShader(*shader));
@@ -66,40 +77,29 @@ namespace MaliSDK
             free(errorLog);
 
             LOGE("Compilation FAILED!\n\n");
-            exit(1);
+
+            GL_CHECK(glDeleteShader(*shader));
+            *shader = 0;
+            return false;
         }
+
+        return true;
     }
 
-    char* Shader::loadShader(const char *filename)
+    bool Shader::loadShader(const char *filename, AssetFile *file)
     {
-        FILE *file = fopen(filename, "rb");
-        if(file == NULL)
+        if (!file->open(filename))
         {
-            LOGE("Cannot read file '%s'\n", filename);
-            exit(1);
+            LOGE("Cannot read shader: %s\n", file->getError());
+            return false;
         }
-        /* Seek end of file. */
-        fseek(file, 0, SEEK_END);
-        /* Record the size of the file for memory allocation. */
-        long length = ftell(file);
-        /* Seek start of file again. */
-        fseek(file, 0, SEEK_SET); 
-        char *shader = (char *)calloc(length + 1, sizeof(char));
-        if(shader == NULL)
+        if (file->getSize() == 0)
         {
-            LOGE("Out of memory at %s:%i\n", __FILE__, __LINE__);
-            exit(1);
-        }
-        /* Read in the file */
-        size_t numberOfBytesRead = fread(shader, sizeof(char), length, file);
-        if (numberOfBytesRead != length) 
-        {
-            LOGE("Error reading %s (read %zu of %ld)", filename, numberOfBytesRead, length);
-            exit(1);
+            LOGE("Shader file '%s' is empty\n", filename);
+            file->close();
+            return false;
         }
-        shader[length] = '\0';
-        fclose(file);
 
-        return shader;
+        return true;
     }
 }
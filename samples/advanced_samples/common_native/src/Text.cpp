@@ -20,11 +20,12 @@
 
 #include "Text.h"
 #include "Texture.h"
-#include "Shader.h"
+#include "ProgramLibrary.h"
 #include "Platform.h"
 #include "VectorTypes.h"
 #include <stdlib.h>
 
+#include <cstddef>
 #include <cstring>
 
 using std::string;
@@ -34,41 +35,87 @@ namespace MaliSDK
     const string Text::textureFilename = "font.raw";
     const string Text::vertexShaderFilename = "font.vert";
     const string Text::fragmentShaderFilename = "font.frag";
+    const string Text::distanceFieldFragmentShaderFilename = "font_sdf.frag";
 
     const float Text::scale = 1.0f;
 
     const int Text::textureCharacterWidth = 8;
     const int Text::textureCharacterHeight = 16;
 
+    /* Size of the font texture. */
+    static const int fontTextureWidth = 256;
+    static const int fontTextureHeight = 48;
+
+    /* Glyph quads are indexed with unsigned shorts. */
+    static const int maximumNumberOfCharacters = 65536 / 4;
+
     Text::Text(const char * resourceDirectory, int windowWidth, int windowHeight)
     {
-        vertexShaderID = 0;
-        fragmentShaderID = 0;
+        font = NULL;
+
+        initialize(resourceDirectory, fragmentShaderFilename, windowWidth, windowHeight);
+
+        /* Load texture. */
+        GL_CHECK(glActiveTexture(GL_TEXTURE0));
+        GL_CHECK(glGenTextures(1, &textureID));
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
+        /* Set filtering. */
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+
+        string texture = resourceDirectory + textureFilename;
+        unsigned char *textureData = NULL;
+        Texture::loadData(texture.c_str(), &textureData);
+
+        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, fontTextureWidth, fontTextureHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData));
+        free(textureData);
+        textureData = NULL;
+
+        LOGD("Text initialization done.\n");
+    }
+
+    Text::Text(const char * resourceDirectory, int windowWidth, int windowHeight, const SDFFont *font)
+    {
+        this->font = font;
+
+        initialize(resourceDirectory, distanceFieldFragmentShaderFilename, windowWidth, windowHeight);
+
+        GL_CHECK(glActiveTexture(GL_TEXTURE0));
+        textureID = font->createTexture();
+
+        LOGD("Text initialization done.\n");
+    }
+
+    void Text::initialize(const char *resourceDirectory, const string &fragmentShaderName, int windowWidth, int windowHeight)
+    {
         programID = 0;
         
         numberOfCharacters = 0;
-        textVertex = NULL;
-        textTextureCoordinates = NULL;
-        color = NULL;
-        textIndex = NULL;
+        numberOfStrings = 0;
+        nextVersion = 1;
+        currentVertexBuffer = 0;
+        indexBufferID = 0;
+        bufferCapacity = 0;
+        stateCache = NULL;
 
         LOGD("Text initialization started...\n");
 
         /* Create an orthographic projection. */
         projectionMatrix = Matrix::matrixOrthographic(0, (float)windowWidth, 0, (float)windowHeight, 0, 1);
 
-        /* Shaders. */
-        string vertexShader = resourceDirectory + vertexShaderFilename;
-        Shader::processShader(&vertexShaderID, vertexShader.c_str(), GL_VERTEX_SHADER);
-        
-        string fragmentShader = resourceDirectory + fragmentShaderFilename;
-        Shader::processShader(&fragmentShaderID, fragmentShader.c_str(), GL_FRAGMENT_SHADER);
-
-        /* Set up shaders. */
-        programID = GL_CHECK(glCreateProgram());
-        GL_CHECK(glAttachShader(programID, vertexShaderID));
-        GL_CHECK(glAttachShader(programID, fragmentShaderID));
-        GL_CHECK(glLinkProgram(programID));
+        /* Shaders. Linked through the program library, which reuses the binary from an earlier launch when it can. */
+        ShaderSet shaderSet;
+        shaderSet.addFile(GL_VERTEX_SHADER, resourceDirectory + vertexShaderFilename);
+        shaderSet.addFile(GL_FRAGMENT_SHADER, resourceDirectory + fragmentShaderName);
+
+        programID = ProgramLibrary::getInstance()->getProgram(shaderSet);
+        if (programID == 0)
+        {
+            LOGE("Text program could not be created\n");
+            exit(1);
+        }
         GL_CHECK(glUseProgram(programID));
 
         /* Vertex positions. */
@@ -118,191 +165,414 @@ namespace MaliSDK
             GL_CHECK(glUniform1i(m_iLocTexture, 0));
         }
 
-        /* Load texture. */
-        GL_CHECK(glActiveTexture(GL_TEXTURE0));
-        GL_CHECK(glGenTextures(1, &textureID));
-        GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
-        /* Set filtering. */
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-        GL_CHECK(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
+        /* Buffers get their storage when the first string is drawn. */
+        GL_CHECK(glGenBuffers(numberOfVertexBuffers, vertexBufferIDs));
+        GL_CHECK(glGenBuffers(1, &indexBufferID));
 
-        string texture = resourceDirectory + textureFilename;
-        unsigned char *textureData = NULL;
-        Texture::loadData(texture.c_str(), &textureData);
+#if GLES_VERSION == 3
+        /* The attribute layout never changes, so each vertex buffer gets a vertex array object set up once. */
+        GL_CHECK(glGenVertexArrays(numberOfVertexBuffers, vertexArrayIDs));
 
-        GL_CHECK(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 256, 48, 0, GL_RGBA, GL_UNSIGNED_BYTE, textureData));
-        free(textureData);
-        textureData = NULL;
+        for (int buffer = 0; buffer < numberOfVertexBuffers; buffer++)
+        {
+            GL_CHECK(glBindVertexArray(vertexArrayIDs[buffer]));
+            GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, vertexBufferIDs[buffer]));
+            GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID));
+            setVertexAttributes();
+        }
 
-        LOGD("Text initialization done.\n");
+        GL_CHECK(glBindVertexArray(0));
+        GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+#endif
     }
 
-    void Text::clear(void)
+    void Text::setVertexAttributes(void)
     {
-        numberOfCharacters = 0;
+        if(m_iLocPosition != -1)
+        {
+            enableVertexAttribArray(m_iLocPosition);
+            GL_CHECK(glVertexAttribPointer(m_iLocPosition, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const GLvoid *)offsetof(TextVertex, x)));
+        }
 
-        free(textVertex);
-        free(textTextureCoordinates);
-        free(color);
-        free(textIndex);
+        if(m_iLocTextColor != -1)
+        {
+            enableVertexAttribArray(m_iLocTextColor);
+            GL_CHECK(glVertexAttribPointer(m_iLocTextColor, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(TextVertex), (const GLvoid *)offsetof(TextVertex, red)));
+        }
 
-        textVertex = NULL;
-        textTextureCoordinates = NULL;
-        color = NULL;
-        textIndex = NULL;
+        if(m_iLocTexCoord != -1)
+        {
+            enableVertexAttribArray(m_iLocTexCoord);
+            GL_CHECK(glVertexAttribPointer(m_iLocTexCoord, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), (const GLvoid *)offsetof(TextVertex, s)));
+        }
     }
 
-    void Text::addString(int xPosition, int yPosition, const char *string, int red, int green, int blue, int alpha)
+    void Text::bindBuffer(GLenum target, GLuint buffer)
     {
-        int length = strlen(string);
-        int iTexCoordPos = 4 * 2 * numberOfCharacters;
-        int iVertexPos = 4 * 3 * numberOfCharacters;
-        int iColorPos = 4 * 4 * numberOfCharacters;
-        int iIndex = 0;
-        int iIndexPos = 0;
-
-        numberOfCharacters += length;
-
-        /* Realloc memory. */
-        textVertex = (float *)realloc(textVertex, numberOfCharacters * 4 * 3 * sizeof(float));
-        textTextureCoordinates = (float *)realloc(textTextureCoordinates, numberOfCharacters * 4 * 2 * sizeof(float));
-        color = (float *)realloc(color, numberOfCharacters * 4 * 4 * sizeof(float));
-        textIndex = (GLshort *)realloc(textIndex, (numberOfCharacters * 6 - 2) * sizeof(GLshort));
-        if((textVertex == NULL) || (textTextureCoordinates == NULL) || (color == NULL) || (textIndex == NULL))
-        {
-            LOGE("Out of memory at %s:%i\n", __FILE__, __LINE__);
-            exit(1);
+        if (stateCache != NULL)
+        {
+            stateCache->bindBuffer(target, buffer);
+        }
+        else
+        {
+            GL_CHECK(glBindBuffer(target, buffer));
+        }
+    }
+
+    void Text::enableVertexAttribArray(GLuint index)
+    {
+        if (stateCache != NULL)
+        {
+            stateCache->enableVertexAttribArray(index);
+        }
+        else
+        {
+            GL_CHECK(glEnableVertexAttribArray(index));
+        }
+    }
+
+    void Text::setStateCache(GLStateCache *cache)
+    {
+        stateCache = cache;
+
+        if (stateCache != NULL)
+        {
+            stateCache->invalidate();
+        }
+    }
+
+    void Text::reserveBuffers(int characters)
+    {
+        if (characters <= bufferCapacity)
+        {
+            return;
+        }
+
+        /* Grow in powers of two so that buffers are reallocated only a few times. */
+        int capacity = 64;
+
+        while (capacity < characters)
+        {
+            capacity *= 2;
+        }
+
+        bufferCapacity = capacity < maximumNumberOfCharacters ? capacity : maximumNumberOfCharacters;
+
+        /* Two triangles per character, sharing the same 4 vertices. */
+        std::vector<GLushort> indices(bufferCapacity * 6);
+
+        for (int character = 0; character < bufferCapacity; character++)
+        {
+            const GLushort firstVertex = (GLushort)(character * 4);
+
+            indices[character * 6 + 0] = firstVertex;
+            indices[character * 6 + 1] = firstVertex + 1;
+            indices[character * 6 + 2] = firstVertex + 2;
+            indices[character * 6 + 3] = firstVertex + 2;
+            indices[character * 6 + 4] = firstVertex + 1;
+            indices[character * 6 + 5] = firstVertex + 3;
         }
 
-        /* Re-init entire index array. */
-        textIndex[iIndex ++] = 0;
-        textIndex[iIndex ++] = 1;
-        textIndex[iIndex ++] = 2;
-        textIndex[iIndex ++] = 3;
+#if GLES_VERSION == 3
+        /* The element array binding belongs to the bound vertex array, which must not be the application's. */
+        if (stateCache != NULL)
+        {
+            stateCache->bindVertexArray(0);
+        }
+        else
+        {
+            GL_CHECK(glBindVertexArray(0));
+        }
+#endif
+
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+        GL_CHECK(glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLushort), &indices[0], GL_STATIC_DRAW));
 
-        iIndexPos = 4;
-        for(int cIndex = 1; cIndex < numberOfCharacters; cIndex ++)
+        for (int buffer = 0; buffer < numberOfVertexBuffers; buffer++)
         {
-            textIndex[iIndexPos ++] = iIndex - 1;
-            textIndex[iIndexPos ++] = iIndex;
-            textIndex[iIndexPos ++] = iIndex++;
-            textIndex[iIndexPos ++] = iIndex++;
-            textIndex[iIndexPos ++] = iIndex++;
-            textIndex[iIndexPos ++] = iIndex++;
+            bindBuffer(GL_ARRAY_BUFFER, vertexBufferIDs[buffer]);
+            GL_CHECK(glBufferData(GL_ARRAY_BUFFER, bufferCapacity * 4 * sizeof(TextVertex), NULL, GL_DYNAMIC_DRAW));
+
+            /* The new storage is empty: every string has to be uploaded again. */
+            uploadedVersions[buffer].clear();
         }
 
-        for(int iChar = 0; iChar < (signed int)strlen(string); iChar ++)
+        if (stateCache == NULL)
         {
-            char cChar = string[iChar];
-            int iCharX = 0;
-            int iCharY = 0;
-            Vec2 sBottom_left;
-            Vec2 sBottom_right;
-            Vec2 sTop_left;
-            Vec2 sTop_right;
+            GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+            GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
+        }
+    }
+
+    void Text::clear(void)
+    {
+        numberOfCharacters = 0;
+        numberOfStrings = 0;
+    }
+
+    int Text::addBitmapGlyphs(const TextString &textString, TextVertex *quads)
+    {
+        const int length = (int)textString.text.size();
+        const float characterWidth = textureCharacterWidth * scale * textString.textScale;
+        const float characterHeight = textureCharacterHeight * scale * textString.textScale;
+        const GLubyte *color = textString.color;
+
+        for(int iChar = 0; iChar < length; iChar ++)
+        {
+            int cChar = (unsigned char)textString.text[iChar];
+
+            /* The font has the 96 printable ASCII characters, anything else is drawn as a space. */
+            if (cChar < 32 || cChar > 127)
+            {
+                cChar = 32;
+            }
 
             /* Calculate tex coord for char here. */
             cChar -= 32;
-            iCharX = cChar % 32;
-            iCharY = cChar / 32;
-            iCharX *= textureCharacterWidth;
-            iCharY *= textureCharacterHeight;
-            sBottom_left.x = iCharX;
-            sBottom_left.y = iCharY;
-            sBottom_right.x = iCharX + textureCharacterWidth;
-            sBottom_right.y = iCharY;
-            sTop_left.x = iCharX;
-            sTop_left.y = iCharY + textureCharacterHeight;
-            sTop_right.x = iCharX + textureCharacterWidth;
-            sTop_right.y = iCharY + textureCharacterHeight;
-
-            /* Add vertex position data here. */
-            textVertex[iVertexPos++] = xPosition + iChar * textureCharacterWidth * scale;
-            textVertex[iVertexPos++] = (float)yPosition;
-            textVertex[iVertexPos++] = 0;
-
-            textVertex[iVertexPos++] = xPosition + (iChar + 1) * textureCharacterWidth * scale;
-            textVertex[iVertexPos++] = (float)yPosition;
-            textVertex[iVertexPos++] = 0;
-
-            textVertex[iVertexPos++] = xPosition + iChar * textureCharacterWidth * scale;
-            textVertex[iVertexPos++] = yPosition + textureCharacterHeight * scale;
-            textVertex[iVertexPos++] = 0;
-
-            textVertex[iVertexPos++] = xPosition + (iChar + 1) * textureCharacterWidth * scale;
-            textVertex[iVertexPos++] = yPosition + textureCharacterHeight * scale;
-            textVertex[iVertexPos++] = 0;
-
-            /* Texture coords here. Because textures are read in upside down, flip Y coords here. */
-            textTextureCoordinates[iTexCoordPos++] = sBottom_left.x / 256.0f;
-            textTextureCoordinates[iTexCoordPos++] = sTop_left.y / 48.0f;
-
-            textTextureCoordinates[iTexCoordPos++] = sBottom_right.x / 256.0f;
-            textTextureCoordinates[iTexCoordPos++] = sTop_right.y / 48.0f;
-
-            textTextureCoordinates[iTexCoordPos++] = sTop_left.x / 256.0f;
-            textTextureCoordinates[iTexCoordPos++] = sBottom_left.y / 48.0f;
-
-            textTextureCoordinates[iTexCoordPos++] = sTop_right.x / 256.0f;
-            textTextureCoordinates[iTexCoordPos++] = sBottom_right.y / 48.0f;
-
-            /* Color data. */
-            color[iColorPos ++] = red / 255.0f;
-            color[iColorPos ++] = green / 255.0f;
-            color[iColorPos ++] = blue / 255.0f;
-            color[iColorPos ++] = alpha / 255.0f;
-
-            /* Copy to the other 3 vertices. */
-            memcpy(&color[iColorPos], &color[iColorPos - 4], 4 * sizeof(float));
-            memcpy(&color[iColorPos + 4], &color[iColorPos], 4 * sizeof(float));
-            memcpy(&color[iColorPos + 8], &color[iColorPos + 4], 4 * sizeof(float));
-            iColorPos += 3 * 4;
+            const float left   = (float)((cChar % 32) * textureCharacterWidth) / fontTextureWidth;
+            const float right  = (float)((cChar % 32 + 1) * textureCharacterWidth) / fontTextureWidth;
+            const float bottom = (float)((cChar / 32) * textureCharacterHeight) / fontTextureHeight;
+            const float top    = (float)((cChar / 32 + 1) * textureCharacterHeight) / fontTextureHeight;
+
+            const float x0 = textString.xPosition + iChar * characterWidth;
+            const float x1 = textString.xPosition + (iChar + 1) * characterWidth;
+            const float y0 = (float)textString.yPosition;
+            const float y1 = textString.yPosition + characterHeight;
+
+            /* Because textures are read in upside down, the texture coordinates are flipped in Y. */
+            const TextVertex corners[4] =
+            {
+                { x0, y0, left,  top,    color[0], color[1], color[2], color[3] },
+                { x1, y0, right, top,    color[0], color[1], color[2], color[3] },
+                { x0, y1, left,  bottom, color[0], color[1], color[2], color[3] },
+                { x1, y1, right, bottom, color[0], color[1], color[2], color[3] },
+            };
+
+            memcpy(&quads[iChar * 4], corners, sizeof(corners));
+        }
+
+        return length;
+    }
+
+    int Text::addDistanceFieldGlyphs(const TextString &textString, TextVertex *quads)
+    {
+        /* A line is as high as a line of the bitmap font at the same scale. */
+        const float pixelsPerUnit = textureCharacterHeight * scale * textString.textScale / font->getLineHeight();
+        const float atlasWidth = (float)font->getAtlasWidth();
+        const float atlasHeight = (float)font->getAtlasHeight();
+        const SDFGlyph *fallback = font->findGlyph('?');
+        const GLubyte *color = textString.color;
+        const char *string = textString.text.c_str();
+        float pen = (float)textString.xPosition;
+        int numberOfGlyphs = 0;
+        unsigned int codePoint;
+
+        while ((codePoint = SDFFont::decodeUTF8(&string)) != 0)
+        {
+            const SDFGlyph *glyph = font->findGlyph(codePoint);
+
+            if (glyph == NULL)
+            {
+                glyph = fallback;
+
+                if (glyph == NULL)
+                {
+                    continue;
+                }
+            }
+
+            if (glyph->atlasWidth > 0)
+            {
+                const float x0 = pen + glyph->left * pixelsPerUnit;
+                const float x1 = x0 + glyph->width * pixelsPerUnit;
+                const float y0 = textString.yPosition + glyph->bottom * pixelsPerUnit;
+                const float y1 = y0 + glyph->height * pixelsPerUnit;
+
+                const float left   = glyph->atlasX / atlasWidth;
+                const float right  = (glyph->atlasX + glyph->atlasWidth) / atlasWidth;
+                const float top    = glyph->atlasY / atlasHeight;
+                const float bottom = (glyph->atlasY + glyph->atlasHeight) / atlasHeight;
+
+                /* The atlas is stored top row first. */
+                const TextVertex corners[4] =
+                {
+                    { x0, y0, left,  bottom, color[0], color[1], color[2], color[3] },
+                    { x1, y0, right, bottom, color[0], color[1], color[2], color[3] },
+                    { x0, y1, left,  top,    color[0], color[1], color[2], color[3] },
+                    { x1, y1, right, top,    color[0], color[1], color[2], color[3] },
+                };
+
+                memcpy(&quads[numberOfGlyphs * 4], corners, sizeof(corners));
+                numberOfGlyphs++;
+            }
+
+            pen += glyph->advance * pixelsPerUnit;
+        }
+
+        return numberOfGlyphs;
+    }
+
+    void Text::addString(int xPosition, int yPosition, const char *string, int red, int green, int blue, int alpha, float textScale)
+    {
+        const int firstCharacter = numberOfCharacters;
+        const int stringIndex = numberOfStrings;
+
+        numberOfStrings++;
+
+        if (stringIndex == (int)strings.size())
+        {
+            strings.push_back(TextString());
+            strings[stringIndex].version = 0;
+        }
+
+        TextString &textString = strings[stringIndex];
+        const GLubyte color[4] = { (GLubyte)red, (GLubyte)green, (GLubyte)blue, (GLubyte)alpha };
+
+        /* The same string as before at the same place in the buffers needs no work. */
+        if (textString.version != 0 &&
+            textString.firstCharacter == firstCharacter &&
+            textString.xPosition == xPosition &&
+            textString.yPosition == yPosition &&
+            textString.textScale == textScale &&
+            memcmp(textString.color, color, sizeof(color)) == 0 &&
+            textString.text == string)
+        {
+            numberOfCharacters += textString.numberOfGlyphs;
+            return;
+        }
+
+        textString.text = string;
+        textString.xPosition = xPosition;
+        textString.yPosition = yPosition;
+        textString.textScale = textScale;
+        memcpy(textString.color, color, sizeof(color));
+        textString.firstCharacter = firstCharacter;
+        textString.version = nextVersion++;
+
+        /* Every byte makes at most one glyph. */
+        const int maximumNumberOfGlyphs = (int)textString.text.size();
+
+        if ((int)vertices.size() < (firstCharacter + maximumNumberOfGlyphs) * 4)
+        {
+            vertices.resize((firstCharacter + maximumNumberOfGlyphs) * 4);
+        }
+
+        if (maximumNumberOfGlyphs == 0)
+        {
+            textString.numberOfGlyphs = 0;
+        }
+        else if (font != NULL)
+        {
+            textString.numberOfGlyphs = addDistanceFieldGlyphs(textString, &vertices[firstCharacter * 4]);
         }
+        else
+        {
+            textString.numberOfGlyphs = addBitmapGlyphs(textString, &vertices[firstCharacter * 4]);
+        }
+
+        numberOfCharacters += textString.numberOfGlyphs;
     }
 
     void Text::draw(void)
     {
-#if GLES_VERSION == 3
-        GL_CHECK(glBindVertexArray(0));
-        GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
-#endif
         if(numberOfCharacters == 0) 
         {
             return;
         }
 
-        GL_CHECK(glUseProgram(programID));
+        reserveBuffers(numberOfCharacters);
 
-        if(m_iLocPosition != -1)
+        int charactersToDraw = numberOfCharacters;
+
+        if (charactersToDraw > bufferCapacity)
         {
-            GL_CHECK(glEnableVertexAttribArray(m_iLocPosition));
-            GL_CHECK(glVertexAttribPointer(m_iLocPosition, 3, GL_FLOAT, GL_FALSE, 0, textVertex));
+            LOGE("Text can draw at most %d characters, %d were added.\n", bufferCapacity, numberOfCharacters);
+            charactersToDraw = bufferCapacity;
         }
 
-        if(m_iLocTextColor != -1)
+        /* Use the least recently drawn buffer and bring the strings which changed since it was last used up to date. */
+        currentVertexBuffer = (currentVertexBuffer + 1) % numberOfVertexBuffers;
+
+        std::vector<unsigned int> &versions = uploadedVersions[currentVertexBuffer];
+
+        if ((int)versions.size() < numberOfStrings)
         {
-            GL_CHECK(glEnableVertexAttribArray(m_iLocTextColor));
-            GL_CHECK(glVertexAttribPointer(m_iLocTextColor, 4, GL_FLOAT, GL_FALSE, 0, color));
+            versions.resize(numberOfStrings, 0);
         }
 
-        if(m_iLocTexCoord != -1)
+        bindBuffer(GL_ARRAY_BUFFER, vertexBufferIDs[currentVertexBuffer]);
+
+        /* Neighbouring strings which changed are uploaded together. */
+        int rangeStart = -1;
+        int rangeEnd = -1;
+
+        for (int stringIndex = 0; stringIndex <= numberOfStrings; stringIndex++)
         {
-            GL_CHECK(glEnableVertexAttribArray(m_iLocTexCoord));
-            GL_CHECK(glVertexAttribPointer(m_iLocTexCoord, 2, GL_FLOAT, GL_FALSE, 0, textTextureCoordinates));
+            const bool isChanged = stringIndex < numberOfStrings && versions[stringIndex] != strings[stringIndex].version;
+
+            if (isChanged)
+            {
+                const TextString &textString = strings[stringIndex];
+
+                if (rangeStart < 0)
+                {
+                    rangeStart = textString.firstCharacter;
+                }
+                rangeEnd = textString.firstCharacter + textString.numberOfGlyphs;
+                versions[stringIndex] = textString.version;
+            }
+            else if (rangeStart >= 0)
+            {
+                if (rangeEnd > charactersToDraw)
+                {
+                    rangeEnd = charactersToDraw;
+                }
+
+                if (rangeEnd > rangeStart)
+                {
+                    GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER,
+                                             rangeStart * 4 * sizeof(TextVertex),
+                                             (rangeEnd - rangeStart) * 4 * sizeof(TextVertex),
+                                             &vertices[rangeStart * 4]));
+                }
+                rangeStart = -1;
+            }
         }
 
-        if(m_iLocProjection != -1)
+        if (stateCache != NULL)
         {
-            GL_CHECK(glUniformMatrix4fv(m_iLocProjection, 1, GL_FALSE, projectionMatrix.getAsArray()));
+            stateCache->useProgram(programID);
+#if GLES_VERSION == 3
+            stateCache->bindVertexArray(vertexArrayIDs[currentVertexBuffer]);
+#endif
+            stateCache->bindTexture(0, GL_TEXTURE_2D, textureID);
+        }
+        else
+        {
+            GL_CHECK(glUseProgram(programID));
+#if GLES_VERSION == 3
+            GL_CHECK(glBindVertexArray(vertexArrayIDs[currentVertexBuffer]));
+#endif
+            GL_CHECK(glActiveTexture(GL_TEXTURE0));
+            GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
         }
 
-        GL_CHECK(glActiveTexture(GL_TEXTURE0));
-        GL_CHECK(glBindTexture(GL_TEXTURE_2D, textureID));
+#if GLES_VERSION == 2
+        bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+        setVertexAttributes();
+#endif
 
-        GL_CHECK(glDrawElements(GL_TRIANGLE_STRIP, numberOfCharacters * 6 - 2, GL_UNSIGNED_SHORT, textIndex));
+        GL_CHECK(glDrawElements(GL_TRIANGLES, charactersToDraw * 6, GL_UNSIGNED_SHORT, 0));
 
+        /* The cache keeps track of what is bound, so there is nothing to restore. */
+        if (stateCache != NULL)
+        {
+            return;
+        }
+
+#if GLES_VERSION == 3
+        GL_CHECK(glBindVertexArray(0));
+#else
         if(m_iLocTextColor != -1)
         {
             GL_CHECK(glDisableVertexAttribArray(m_iLocTextColor));
@@ -317,11 +587,33 @@ namespace MaliSDK
         {
             GL_CHECK(glDisableVertexAttribArray(m_iLocPosition));
         }
+
+        /* Samples drawing from client-side arrays after the text must not see these buffers bound. */
+        GL_CHECK(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0));
+#endif
+        GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
     }
 
     Text::~Text(void)
     {
         clear();
+
+        if (stateCache != NULL)
+        {
+            stateCache->deleteBuffers(numberOfVertexBuffers, vertexBufferIDs);
+            stateCache->deleteBuffers(1, &indexBufferID);
+#if GLES_VERSION == 3
+            stateCache->deleteVertexArrays(numberOfVertexBuffers, vertexArrayIDs);
+#endif
+        }
+        else
+        {
+            GL_CHECK(glDeleteBuffers(numberOfVertexBuffers, vertexBufferIDs));
+            GL_CHECK(glDeleteBuffers(1, &indexBufferID));
+#if GLES_VERSION == 3
+            GL_CHECK(glDeleteVertexArrays(numberOfVertexBuffers, vertexArrayIDs));
+#endif
+        }
         
          /*
           * NOTE FROM http://developer.android.com
@@ -19,7 +19,9 @@
  */
 
 #include "Texture.h"
+#include "ETCDecoder.h"
 #include "ETCHeader.h"
+#include "KTXTexture.h"
 #include "Platform.h"
 
 #if GLES_VERSION == 2
@@ -30,75 +32,27 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <vector>
 
 using std::string;
 
 namespace MaliSDK
 {
-    void Texture::getCompressedTextureFormats(GLint** textureFormats, int* numberOfTextureFormats)
-    {
-        GL_CHECK(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, numberOfTextureFormats));
-
-        *textureFormats = (GLint *)calloc(*numberOfTextureFormats, sizeof(GLint));
-        if(*textureFormats == NULL)
-        {
-            LOGE("Out of memory at %s:%i\n", __FILE__, __LINE__);
-            exit(1);
-        }
-
-        GL_CHECK(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, *textureFormats));
-    }
-
-#if GLES_VERSION == 2
     bool Texture::isETCSupported(bool verbose)
     {
-        bool supportETC = false;
-        GLint *textureFormat = NULL;
-        GLint numberOfTextureFormats = 0;
-        getCompressedTextureFormats(&textureFormat, &numberOfTextureFormats);
-
-        if (verbose != 0)
-        {
-            LOGI("Number of texture formats supported: %d\nFormats:\n", numberOfTextureFormats);
-            for(int allTextureFormats = 0; allTextureFormats < numberOfTextureFormats; allTextureFormats++)
-            {
-                LOGI("0x%.8x\t", textureFormat[allTextureFormats]);
-                switch(textureFormat[allTextureFormats])
-                {
-                    case GL_ETC1_RGB8_OES:
-                        LOGI("GL_ETC1_RGB8_OES\n");
-                        break;
-                    default:
-                        LOGI("UNKNOWN\n");
-                        break;
-                }
-            }
-        }  
+        const TextureFormats &textureFormats = TextureFormats::getInstance();
 
-        for(int allTextureFormats = 0; allTextureFormats < numberOfTextureFormats; allTextureFormats++)
+        if (verbose)
         {
-            if (textureFormat[allTextureFormats] == GL_ETC1_RGB8_OES)
-            {
-                supportETC = true;
-            }
+            textureFormats.log();
         }
 
-        free(textureFormat);
-        textureFormat = NULL;
-
-        if(!supportETC)
+        if (!textureFormats.isETC1Supported())
         {
             LOGD("Texture compression format GL_ETC1_RGB8_OES not supported\n");
         }
-        return supportETC;
-    }
-#elif GLES_VERSION == 3
-    bool Texture::isETCSupported(bool verbose)
-    {
-        /* TODO */
-        return true;
+        return textureFormats.isETC1Supported();
     }
-#endif
 
     void Texture::createTexture(unsigned int width, unsigned int height, GLvoid **textureData)
     {
@@ -164,155 +118,277 @@ namespace MaliSDK
         delete[] (unsigned char*)*textureData;
     }
 
-    void Texture::loadData(const char *filename, unsigned char **textureData)
+    bool Texture::loadData(const char *filename, unsigned char **textureData)
     {
         LOGD("Texture loadData started for %s...\n", filename);
 
-        FILE *file = fopen(filename, "rb");
-        if(file == NULL)
+        *textureData = NULL;
+
+        AssetFile file;
+        if (!file.open(filename))
         {
-            LOGE("Failed to open '%s'\n", filename);
-            exit(1);
+            LOGE("%s\n", file.getError());
+            return false;
         }
-        fseek(file, 0, SEEK_END);
-        unsigned int length = ftell(file);
-        unsigned char *loadedTexture = (unsigned char *)calloc(length, sizeof(unsigned char));
+
+        /* Callers own the result and release it with free(), so the mapped file has to be copied once. Loaders which can upload straight from the mapping use AssetFile instead. */
+        unsigned char *loadedTexture = (unsigned char *)malloc(file.getSize() + 1);
         if(loadedTexture == NULL)
         {
             LOGE("Out of memory at %s:%i\n", __FILE__, __LINE__);
-            exit(1);
-        }
-        fseek(file, 0, SEEK_SET);
-        size_t read = fread(loadedTexture, sizeof(unsigned char), length, file);
-        if(read != length)
-        {
-            LOGE("Failed to read in '%s'\n", filename);
-            exit(1);
+            return false;
         }
-        fclose(file);
+        memcpy(loadedTexture, file.getSpan().data, file.getSize());
 
         *textureData = loadedTexture;
 
         LOGD("Texture loadData for %s done.\n", filename);
+
+        return true;
     }
 
-    void Texture::loadPKMData(const char *filename, ETCHeader* etcHeader, unsigned char **textureData)
+    bool Texture::loadPKMData(const AssetFile &file, ETCHeader* etcHeader, AssetSpan *textureData)
     {
-        /* PKM file consists of a header with information about image (stored in 16 first bits) and image data. */
-        const int       sizeOfETCHeader = 16; 
-        unsigned char*  tempTextureData = NULL;
+        /* PKM file consists of a header with information about image (stored in 16 first bytes) and image data. */
+        const size_t sizeOfETCHeader = 16;
 
-        loadData(filename, &tempTextureData);
-
-        if (textureData == NULL)
+        if (etcHeader == NULL || textureData == NULL)
         {
-            LOGE("textureData is a NULL pointer.");
-            exit(1);
+            LOGE("loadPKMData called with a NULL pointer.\n");
+            return false;
         }
-        if (etcHeader == NULL)
+
+        AssetSpan header = file.getSpan(0, sizeOfETCHeader);
+        if (header.isEmpty() || memcmp(header.data, "PKM ", 4) != 0)
         {
-            LOGE("etcHeader is a NULL pointer.");
-            exit(1);
+            LOGE("File is not a PKM file.\n");
+            return false;
         }
 
-        if (tempTextureData != NULL)
+        *etcHeader   = ETCHeader(header.data);
+        *textureData = file.getSpan(sizeOfETCHeader, file.getSize() - sizeOfETCHeader);
+
+        return true;
+    }
+
+    bool Texture::loadPKMData(const char *filename, ETCHeader* etcHeader, unsigned char **textureData)
+    {
+        const int      sizeOfETCHeader = 16;
+        unsigned char* tempTextureData = NULL;
+
+        if (textureData == NULL || etcHeader == NULL)
         {
-            ETCHeader tempEtcHeader(tempTextureData);
+            LOGE("loadPKMData called with a NULL pointer.\n");
+            return false;
+        }
 
-            *etcHeader   = tempEtcHeader;
-            *textureData = tempTextureData + sizeOfETCHeader;
+        if (!loadData(filename, &tempTextureData))
+        {
+            LOGE("Could not load data from file %s.\n", filename);
+            return false;
         }
-        else
+
+        if (memcmp(tempTextureData, "PKM ", 4) != 0)
         {
-            LOGE("Could not load data from file %s.", filename);
-            exit(1);
+            LOGE("%s is not a PKM file.\n", filename);
+            free(tempTextureData);
+            return false;
         }
+
+        *etcHeader   = ETCHeader(tempTextureData);
+        *textureData = tempTextureData + sizeOfETCHeader;
+
+        return true;
     }
 
-    void Texture::loadCompressedMipmaps(const char *filenameBase, const char *filenameSuffix, GLuint *textureID)
+    bool Texture::loadCompressedMipmaps(const char *filenameBase, const char *filenameSuffix, GLuint *textureID)
     {
         /* Allocate texture name. */
         GL_CHECK(glGenTextures(1, textureID));
         GL_CHECK(glBindTexture(GL_TEXTURE_2D, *textureID));
-        
-        /* Load base level Mipmap. */
-        /* Construct filename, load and tidy up. */
-        string filename = filenameBase + string("0") + filenameSuffix;
-        unsigned char *data = NULL;
-        loadData(filename.c_str(), &data);
-        ETCHeader loadedETCHeader = ETCHeader(data);
-
-        /* Calculate number of Mipmap levels. */
-        LOGD("Base level Mipmap loaded: (%i, %i) padded to 4x4 blocks, (%i, %i) actual\n", loadedETCHeader.getPaddedWidth(), loadedETCHeader.getPaddedHeight(), loadedETCHeader.getWidth(), loadedETCHeader.getHeight());
-        int width = loadedETCHeader.getWidth();
-        int height = loadedETCHeader.getHeight();
-        int numberOfMipmaps = 1;
-        while((width > 1) || (height > 1))
-        {
-            numberOfMipmaps ++;
-            if(width > 1) width >>= 1;
-            if(height > 1) height >>= 1;
-        }
-        LOGD("Requires %i Mipmap levels in total\n", numberOfMipmaps);
-
-        /* Load base Mipmap level into level 0 of texture.
-         * Skip the 16 byte header of the PKM file before passing the data to OpenGL ES.
-         * Data size (taken in number of bytes) of the texture is:
-         *      Number of pixels = padded width * padded height.
-         *      The number of pixels is divided by two as there are 4 bits per pixel in ETC (half a byte)
-         */
+
 #if GLES_VERSION == 2
-        GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, 0, GL_ETC1_RGB8_OES, loadedETCHeader.getWidth(), loadedETCHeader.getHeight(), 0, (loadedETCHeader.getPaddedWidth() * loadedETCHeader.getPaddedHeight()) >> 1, data + 16));
+        const GLenum internalFormat = GL_ETC1_RGB8_OES;
 #elif GLES_VERSION == 3
-        /* TODO */
+        /* ETC2 is a superset of ETC1, so ETC1 data can be uploaded as ETC2 RGB8 in OpenGL ES 3.0. */
+        const GLenum internalFormat = GL_COMPRESSED_RGB8_ETC2;
 #endif
-        free(data);
-        data = NULL;
 
-        /* Load other levels. */
-        for(int allMipmaps = 1; allMipmaps < numberOfMipmaps; allMipmaps++)
+        int numberOfMipmaps = 1;
+        bool loaded = true;
+
+        /* Each level is mapped and handed straight to OpenGL ES, skipping the 16 byte header of the PKM file,
+         * so no level is ever copied into an intermediate buffer. */
+        for(int allMipmaps = 0; allMipmaps < numberOfMipmaps; allMipmaps++)
         {
-            /* Construct filename, load and tidy up. */
-            char *level = NULL;
-            int input = allMipmaps;
-            int inputLength = 0;
+            /* Construct filename. */
+            char level[16];
+            sprintf(level, "%i", allMipmaps);
+            string filename = filenameBase + string(level) + filenameSuffix;
 
-            /* Calculate the string length of the Mipmap level number (no snprintf in ANSI C). */
-            do
+            AssetFile file;
+            ETCHeader loadedETCHeader;
+            AssetSpan data;
+
+            if (!file.open(filename.c_str()))
             {
-                input /= 10;
-                inputLength ++;
+                LOGE("%s\n", file.getError());
+                loaded = false;
+                break;
             }
-            while(input != 0);
-
-            level = (char *)calloc(inputLength + 1, sizeof(char));
-            if(level == NULL)
+            if (!loadPKMData(file, &loadedETCHeader, &data))
             {
-                LOGE("Out of memory at %s:%i\n", __FILE__, __LINE__);
-                exit(1);
+                LOGE("Could not load Mipmap level %i from %s.\n", allMipmaps, filename.c_str());
+                loaded = false;
+                break;
             }
-            sprintf(level, "%i", allMipmaps);
 
-            filename = filenameBase + string(level) + filenameSuffix;
-            loadData(filename.c_str(), &data);
-            free(level);
-            level = NULL;
-            loadedETCHeader = ETCHeader(data);
+            if (allMipmaps == 0)
+            {
+                /* Calculate number of Mipmap levels. */
+                LOGD("Base level Mipmap loaded: (%i, %i) padded to 4x4 blocks, (%i, %i) actual\n", loadedETCHeader.getPaddedWidth(), loadedETCHeader.getPaddedHeight(), loadedETCHeader.getWidth(), loadedETCHeader.getHeight());
+                int width = loadedETCHeader.getWidth();
+                int height = loadedETCHeader.getHeight();
+                while((width > 1) || (height > 1))
+                {
+                    numberOfMipmaps ++;
+                    if(width > 1) width >>= 1;
+                    if(height > 1) height >>= 1;
+                }
+                LOGD("Requires %i Mipmap levels in total\n", numberOfMipmaps);
+            }
 
-            /* Load Mipmap level into texture.
-             * Skip the 16 byte header of the PKM file before passing the data to OpenGL ES.
-             * Data size (taken in number of bytes) of the texture is:
+            /* Data size (taken in number of bytes) of the texture is:
              *      Number of pixels = padded width * padded height.
              *      The number of pixels is divided by two as there are 4 bits per pixel in ETC (half a byte)
              */
+            GLsizei imageSize = (loadedETCHeader.getPaddedWidth() * loadedETCHeader.getPaddedHeight()) >> 1;
+            if ((size_t)imageSize > data.size)
+            {
+                LOGE("%s is truncated: %i bytes expected, %i found.\n", filename.c_str(), (int)imageSize, (int)data.size);
+                loaded = false;
+                break;
+            }
+
+            GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, allMipmaps, internalFormat, loadedETCHeader.getWidth(), loadedETCHeader.getHeight(), 0, imageSize, data.data));
+        }
+
+        if (!loaded)
+        {
+            /* Do not leave a partially specified texture behind. */
+            GL_CHECK(glDeleteTextures(1, textureID));
+            *textureID = 0;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool Texture::loadKTX(const char *filename, GLuint *textureID)
+    {
+        KTXTexture texture;
+
+        if (!texture.load(filename) || !texture.upload(textureID))
+        {
+            LOGE("Could not load KTX texture: %s\n", texture.getError());
+            return false;
+        }
+
+        LOGD("Loaded %s: %i x %i, %i levels, %i layers, %i faces\n", filename, texture.getWidth(), texture.getHeight(),
+             texture.getNumberOfLevels(), texture.getNumberOfLayers(), texture.getNumberOfFaces());
+
+        return true;
+    }
+
+    bool Texture::loadTranscodedKTX(const char *filename, GLuint *textureID)
+    {
+        KTXTexture texture;
+
+        if (!texture.load(filename))
+        {
+            LOGE("Could not load KTX texture: %s\n", texture.getError());
+            return false;
+        }
+        if (texture.getNumberOfLayers() > 1 || !ETCDecoder::isFormatSupported(texture.getInternalFormat()))
+        {
+            LOGE("Cannot transcode %s\n", filename);
+            return false;
+        }
+
+        /* A file may declare a single layer array, which is uploaded as a plain 2D texture with glTexImage2D. */
+        const GLenum target = texture.getNumberOfFaces() == 6 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+        std::vector<unsigned char> texels((size_t)texture.getWidth() * texture.getHeight() * 4);
+        GLint unpackAlignment = 4;
+#if GLES_VERSION == 3
+        /* Keep sRGB data sRGB, so it is still linearised when sampled. */
+        const GLint internalFormat = (TextureFormats::getFormatChannels(texture.getInternalFormat()) & TEXTURE_CHANNELS_SRGB) != 0 ? GL_SRGB8_ALPHA8 : GL_RGBA;
+#else
+        const GLint internalFormat = GL_RGBA;
+#endif
+
+        GL_CHECK(glGenTextures(1, textureID));
+        GL_CHECK(glBindTexture(target, *textureID));
+        GL_CHECK(glGetIntegerv(GL_UNPACK_ALIGNMENT, &unpackAlignment));
+        GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+
+        for (int level = 0; level < texture.getNumberOfLevels(); level++)
+        {
+            int levelWidth  = texture.getWidth()  >> level > 0 ? texture.getWidth()  >> level : 1;
+            int levelHeight = texture.getHeight() >> level > 0 ? texture.getHeight() >> level : 1;
+
+            for (int face = 0; face < texture.getNumberOfFaces(); face++)
+            {
+                GLenum imageTarget = target == GL_TEXTURE_CUBE_MAP ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : target;
+
+                ETCDecoder::decode(texture.getInternalFormat(), texture.getImage(level, 0, face).data, levelWidth, levelHeight, &texels[0]);
+                GL_CHECK(glTexImage2D(imageTarget, level, internalFormat, levelWidth, levelHeight, 0, GL_RGBA, GL_UNSIGNED_BYTE, &texels[0]));
+            }
+        }
+
+        GL_CHECK(glPixelStorei(GL_UNPACK_ALIGNMENT, unpackAlignment));
+
+        if (texture.getNumberOfLevels() == 1)
+        {
+            GL_CHECK(glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
+        }
+
+        LOGD("Transcoded %s (%s) to RGBA8\n", filename, TextureFormats::getFormatName(texture.getInternalFormat()));
+
+        return true;
+    }
+
+    bool Texture::loadBestVariant(const TextureVariant *variants, int numberOfVariants, GLuint *textureID, unsigned int requiredChannels)
+    {
+        const int chosenVariant = TextureFormats::getInstance().selectVariant(variants, numberOfVariants, requiredChannels);
+
+        if (chosenVariant >= 0)
+        {
+            LOGD("Loading %s (%s)\n", variants[chosenVariant].filename, TextureFormats::getFormatName(variants[chosenVariant].internalFormat));
+
+            return loadKTX(variants[chosenVariant].filename, textureID);
+        }
+
 #if GLES_VERSION == 2
-            GL_CHECK(glCompressedTexImage2D(GL_TEXTURE_2D, allMipmaps, GL_ETC1_RGB8_OES, loadedETCHeader.getWidth(), loadedETCHeader.getHeight(), 0, (loadedETCHeader.getPaddedWidth() * loadedETCHeader.getPaddedHeight()) >> 1, data + 16));
-#elif GLES_VERSION == 3
-        /* TODO */
+        /* Transcoded textures are plain RGBA8, which cannot hold sRGB data here. */
+        if ((requiredChannels & TEXTURE_CHANNELS_SRGB) != 0)
+        {
+            LOGE("None of the %d texture variants can be used on this device\n", numberOfVariants);
+            return false;
+        }
 #endif
-            free(data);
-            data = NULL;
+
+        /* The device cannot sample any of the packaged encodings, so decode one of them on the CPU. */
+        for (int i = 0; i < numberOfVariants; i++)
+        {
+            if (ETCDecoder::isFormatSupported(variants[i].internalFormat) &&
+                (TextureFormats::getFormatChannels(variants[i].internalFormat) & requiredChannels) == requiredChannels)
+            {
+                return loadTranscodedKTX(variants[i].filename, textureID);
+            }
         }
+
+        LOGE("None of the %d texture variants can be used on this device\n", numberOfVariants);
+        return false;
     }
 
     void Texture::reversePixelLine(float* destination, const float* source, int lineWidth)
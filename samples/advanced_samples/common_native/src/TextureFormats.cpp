@@ -0,0 +1,311 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "TextureFormats.h"
+#include "KTXTexture.h"
+#include "Platform.h"
+
+#include <cstring>
+
+namespace MaliSDK
+{
+    TextureFormats *TextureFormats::instance = NULL;
+
+    /* Formats which are part of the OpenGL ES 3.0 core specification. */
+    static const GLenum etc2Formats[] =
+    {
+        0x9270, 0x9271, 0x9272, 0x9273, 0x9274, 0x9275, 0x9276, 0x9277, 0x9278, 0x9279
+    };
+
+    struct FormatName
+    {
+        GLenum internalFormat;
+        const char *name;
+    };
+
+    static const FormatName formatNames[] =
+    {
+        { 0x8D64, "GL_ETC1_RGB8_OES" },
+        { 0x9270, "GL_COMPRESSED_R11_EAC" },
+        { 0x9271, "GL_COMPRESSED_SIGNED_R11_EAC" },
+        { 0x9272, "GL_COMPRESSED_RG11_EAC" },
+        { 0x9273, "GL_COMPRESSED_SIGNED_RG11_EAC" },
+        { 0x9274, "GL_COMPRESSED_RGB8_ETC2" },
+        { 0x9275, "GL_COMPRESSED_SRGB8_ETC2" },
+        { 0x9276, "GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2" },
+        { 0x9277, "GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2" },
+        { 0x9278, "GL_COMPRESSED_RGBA8_ETC2_EAC" },
+        { 0x9279, "GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC" },
+        { 0x93B0, "GL_COMPRESSED_RGBA_ASTC_4x4_KHR" },
+        { 0x93B1, "GL_COMPRESSED_RGBA_ASTC_5x4_KHR" },
+        { 0x93B2, "GL_COMPRESSED_RGBA_ASTC_5x5_KHR" },
+        { 0x93B3, "GL_COMPRESSED_RGBA_ASTC_6x5_KHR" },
+        { 0x93B4, "GL_COMPRESSED_RGBA_ASTC_6x6_KHR" },
+        { 0x93B5, "GL_COMPRESSED_RGBA_ASTC_8x5_KHR" },
+        { 0x93B6, "GL_COMPRESSED_RGBA_ASTC_8x6_KHR" },
+        { 0x93B7, "GL_COMPRESSED_RGBA_ASTC_8x8_KHR" },
+        { 0x93B8, "GL_COMPRESSED_RGBA_ASTC_10x5_KHR" },
+        { 0x93B9, "GL_COMPRESSED_RGBA_ASTC_10x6_KHR" },
+        { 0x93BA, "GL_COMPRESSED_RGBA_ASTC_10x8_KHR" },
+        { 0x93BB, "GL_COMPRESSED_RGBA_ASTC_10x10_KHR" },
+        { 0x93BC, "GL_COMPRESSED_RGBA_ASTC_12x10_KHR" },
+        { 0x93BD, "GL_COMPRESSED_RGBA_ASTC_12x12_KHR" },
+        { 0x93D0, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_4x4_KHR" },
+        { 0x93D1, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x4_KHR" },
+        { 0x93D2, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_5x5_KHR" },
+        { 0x93D3, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x5_KHR" },
+        { 0x93D4, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_6x6_KHR" },
+        { 0x93D5, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x5_KHR" },
+        { 0x93D6, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x6_KHR" },
+        { 0x93D7, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_8x8_KHR" },
+        { 0x93D8, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x5_KHR" },
+        { 0x93D9, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x6_KHR" },
+        { 0x93DA, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x8_KHR" },
+        { 0x93DB, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_10x10_KHR" },
+        { 0x93DC, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x10_KHR" },
+        { 0x93DD, "GL_COMPRESSED_SRGB8_ALPHA8_ASTC_12x12_KHR" },
+    };
+
+    TextureFormats::TextureFormats()
+        : etc1(false),
+          etc2(false),
+          astcLdr(false),
+          astcHdr(false),
+          srgb(false)
+    {
+    }
+
+    const TextureFormats &TextureFormats::getInstance(void)
+    {
+        if (instance == NULL)
+        {
+            instance = new TextureFormats();
+            instance->probe();
+        }
+        return *instance;
+    }
+
+    void TextureFormats::invalidate(void)
+    {
+        delete instance;
+        instance = NULL;
+    }
+
+    void TextureFormats::probe(void)
+    {
+        GLint numberOfFormats = 0;
+        GL_CHECK(glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &numberOfFormats));
+
+        if (numberOfFormats > 0)
+        {
+            std::vector<GLint> reportedFormats(numberOfFormats);
+            GL_CHECK(glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &reportedFormats[0]));
+            formats.assign(reportedFormats.begin(), reportedFormats.end());
+        }
+
+        const char *extensionString = (const char *)glGetString(GL_EXTENSIONS);
+        if (extensionString != NULL)
+        {
+            /* Pad with spaces so hasExtension() can match whole names only. */
+            extensions = std::string(" ") + extensionString + " ";
+        }
+
+#if GLES_VERSION == 3
+        /* ETC2/EAC are core, even if a driver leaves them out of GL_COMPRESSED_TEXTURE_FORMATS. */
+        for (unsigned int i = 0; i < sizeof(etc2Formats) / sizeof(etc2Formats[0]); i++)
+        {
+            if (!isFormatSupported(etc2Formats[i]))
+            {
+                formats.push_back(etc2Formats[i]);
+            }
+        }
+        srgb = true;
+#else
+        srgb = hasExtension("GL_EXT_sRGB");
+#endif
+
+        astcLdr = hasExtension("GL_KHR_texture_compression_astc_ldr") || hasExtension("GL_OES_texture_compression_astc");
+        astcHdr = hasExtension("GL_KHR_texture_compression_astc_hdr") || hasExtension("GL_OES_texture_compression_astc");
+
+        /* Some drivers expose ASTC through the extension only. */
+        if (astcLdr)
+        {
+            for (unsigned int i = 0; i < sizeof(formatNames) / sizeof(formatNames[0]); i++)
+            {
+                if (formatNames[i].internalFormat >= 0x93B0 && !isFormatSupported(formatNames[i].internalFormat))
+                {
+                    formats.push_back(formatNames[i].internalFormat);
+                }
+            }
+        }
+
+        etc2 = isFormatSupported(0x9274);
+#if GLES_VERSION == 3
+        /* ETC1 data is valid ETC2 RGB8 data, KTXTexture uploads it as GL_COMPRESSED_RGB8_ETC2. */
+        etc1 = true;
+#else
+        etc1 = isFormatSupported(0x8D64) || hasExtension("GL_OES_compressed_ETC1_RGB8_texture");
+#endif
+
+        if (etc1 && !isFormatSupported(0x8D64))
+        {
+            formats.push_back(0x8D64);
+        }
+    }
+
+    bool TextureFormats::isFormatSupported(GLenum internalFormat) const
+    {
+        for (unsigned int i = 0; i < formats.size(); i++)
+        {
+            if (formats[i] == internalFormat)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TextureFormats::hasExtension(const char *name) const
+    {
+        return extensions.find(std::string(" ") + name + " ") != std::string::npos;
+    }
+
+    /* Default ranking of formats, lower is preferred. */
+    static int getDefaultFormatRank(GLenum internalFormat)
+    {
+        if (internalFormat == 0x93B4 || internalFormat == 0x93D4)
+        {
+            /* ASTC 6x6 balances quality and size. */
+            return 0;
+        }
+        if ((internalFormat >= 0x93B0 && internalFormat <= 0x93BD) || (internalFormat >= 0x93D0 && internalFormat <= 0x93DD))
+        {
+            return 1;
+        }
+        if (internalFormat >= 0x9270 && internalFormat <= 0x9279)
+        {
+            return 2;
+        }
+        if (internalFormat == 0x8D64)
+        {
+            return 3;
+        }
+        return 4;
+    }
+
+    int TextureFormats::selectVariant(const TextureVariant *variants, int numberOfVariants, unsigned int requiredChannels,
+                                      const GLenum *formatOrder, int numberOfFormats) const
+    {
+        int bestVariant = -1;
+        int bestRank = 0;
+        float bestBitsPerTexel = 0.0f;
+
+        for (int i = 0; i < numberOfVariants; i++)
+        {
+            const GLenum internalFormat = variants[i].internalFormat;
+
+            if (!isFormatSupported(internalFormat) || (getFormatChannels(internalFormat) & requiredChannels) != requiredChannels)
+            {
+                continue;
+            }
+
+            int rank = getDefaultFormatRank(internalFormat);
+            if (formatOrder != NULL)
+            {
+                rank = numberOfFormats;
+                for (int j = 0; j < numberOfFormats; j++)
+                {
+                    if (formatOrder[j] == internalFormat)
+                    {
+                        rank = j;
+                        break;
+                    }
+                }
+            }
+
+            float bitsPerTexel = getBitsPerTexel(internalFormat);
+            if (bestVariant == -1 || rank < bestRank || (rank == bestRank && bitsPerTexel < bestBitsPerTexel))
+            {
+                bestVariant = i;
+                bestRank = rank;
+                bestBitsPerTexel = bitsPerTexel;
+            }
+        }
+
+        return bestVariant;
+    }
+
+    void TextureFormats::log(void) const
+    {
+        LOGI("Number of texture formats supported: %d\nFormats:\n", (int)formats.size());
+        for (unsigned int i = 0; i < formats.size(); i++)
+        {
+            LOGI("0x%.8x\t%s\n", formats[i], getFormatName(formats[i]));
+        }
+        LOGI("ETC1: %s, ETC2/EAC: %s, ASTC LDR: %s, ASTC HDR: %s, sRGB: %s\n",
+             etc1 ? "yes" : "no", etc2 ? "yes" : "no", astcLdr ? "yes" : "no", astcHdr ? "yes" : "no", srgb ? "yes" : "no");
+    }
+
+    const char *TextureFormats::getFormatName(GLenum internalFormat)
+    {
+        for (unsigned int i = 0; i < sizeof(formatNames) / sizeof(formatNames[0]); i++)
+        {
+            if (formatNames[i].internalFormat == internalFormat)
+            {
+                return formatNames[i].name;
+            }
+        }
+        return "UNKNOWN";
+    }
+
+    float TextureFormats::getBitsPerTexel(GLenum internalFormat)
+    {
+        const CompressedFormatInfo *info = KTXTexture::getFormatInfo(internalFormat);
+        if (info == NULL)
+        {
+            return 0.0f;
+        }
+        return 8.0f * info->bytesPerBlock / (info->blockWidth * info->blockHeight);
+    }
+
+    unsigned int TextureFormats::getFormatChannels(GLenum internalFormat)
+    {
+        switch (internalFormat)
+        {
+            case 0x9275: /* GL_COMPRESSED_SRGB8_ETC2 */
+                return TEXTURE_CHANNELS_SRGB;
+            case 0x9276: /* GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+            case 0x9278: /* GL_COMPRESSED_RGBA8_ETC2_EAC */
+                return TEXTURE_CHANNELS_ALPHA;
+            case 0x9277: /* GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 */
+            case 0x9279: /* GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC */
+                return TEXTURE_CHANNELS_ALPHA | TEXTURE_CHANNELS_SRGB;
+        }
+        if (internalFormat >= 0x93B0 && internalFormat <= 0x93BD)
+        {
+            return TEXTURE_CHANNELS_ALPHA;
+        }
+        if (internalFormat >= 0x93D0 && internalFormat <= 0x93DD)
+        {
+            return TEXTURE_CHANNELS_ALPHA | TEXTURE_CHANNELS_SRGB;
+        }
+        return 0;
+    }
+}
@@ -23,6 +23,7 @@
 #include "Platform.h"
 
 #include <cstdlib>
+#include <cstdio>
 
 namespace MaliSDK
 {   
@@ -457,4 +458,58 @@ namespace MaliSDK
         
         }
     }
+
+    const IndexedMesh* CubeModel::getIndexedMesh(float scalingFactor)
+    {
+        char key[64];
+        snprintf(key, sizeof(key), "CubeModel|%a", scalingFactor);
+
+        const IndexedMesh* cachedMesh = IndexedMesh::findCached(key);
+        if (cachedMesh != NULL)
+        {
+            return cachedMesh;
+        }
+
+        /* For each face: the normal and two axes along the face with cross(u, v) == normal, so corners go counter-clockwise. */
+        static const float faces[6][3][3] =
+        {
+            {{ 1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f, -1.0f}, {0.0f, 1.0f,  0.0f}},
+            {{-1.0f,  0.0f,  0.0f}, { 0.0f,  0.0f,  1.0f}, {0.0f, 1.0f,  0.0f}},
+            {{ 0.0f,  1.0f,  0.0f}, { 1.0f,  0.0f,  0.0f}, {0.0f, 0.0f, -1.0f}},
+            {{ 0.0f, -1.0f,  0.0f}, { 1.0f,  0.0f,  0.0f}, {0.0f, 0.0f,  1.0f}},
+            {{ 0.0f,  0.0f,  1.0f}, { 1.0f,  0.0f,  0.0f}, {0.0f, 1.0f,  0.0f}},
+            {{ 0.0f,  0.0f, -1.0f}, {-1.0f,  0.0f,  0.0f}, {0.0f, 1.0f,  0.0f}},
+        };
+        static const float corners[4][2] = {{-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f}, {-1.0f, 1.0f}};
+
+        IndexedMesh* mesh = new IndexedMesh();
+
+        for (int face = 0; face < 6; face++)
+        {
+            const float* normal = faces[face][0];
+            const float* u = faces[face][1];
+            const float* v = faces[face][2];
+            unsigned int faceVertices[4];
+
+            for (int corner = 0; corner < 4; corner++)
+            {
+                const float cu = corners[corner][0];
+                const float cv = corners[corner][1];
+                const Vec3f position = {scalingFactor * (normal[0] + cu * u[0] + cv * v[0]),
+                                        scalingFactor * (normal[1] + cu * u[1] + cv * v[1]),
+                                        scalingFactor * (normal[2] + cu * u[2] + cv * v[2])};
+                const Vec3f faceNormal = {normal[0], normal[1], normal[2]};
+                const Vec2f uv = {(cu + 1.0f) * 0.5f, (cv + 1.0f) * 0.5f};
+
+                faceVertices[corner] = mesh->addVertex(position, faceNormal, uv);
+            }
+
+            mesh->addQuad(faceVertices[0], faceVertices[1], faceVertices[2], faceVertices[3]);
+        }
+
+        /* Faces share no vertices, so only the vertex order benefits; optimise() is still cheap at this size. */
+        mesh->optimise();
+
+        return IndexedMesh::storeCached(key, mesh);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,605 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "IndexedMesh.h"
+#include "Platform.h"
+
+#include <pthread.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+using std::map;
+using std::string;
+using std::vector;
+
+namespace MaliSDK
+{
+    /* Size of the cache modelled by the triangle order optimisation. The result works well for smaller caches too. */
+    static const int modelledCacheSize = 32;
+
+    /* Meshes stored by storeCached(), never freed. */
+    static map<string, IndexedMesh *> cachedMeshes;
+    static pthread_mutex_t cachedMeshesMutex = PTHREAD_MUTEX_INITIALIZER;
+
+    /* Vertex score from Tom Forsyth, "Linear-Speed Vertex Cache Optimisation". */
+    static float calculateVertexScore(int cachePosition, int remainingTriangles)
+    {
+        if (remainingTriangles == 0)
+        {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+
+        if (cachePosition >= 0)
+        {
+            if (cachePosition < 3)
+            {
+                /* The vertices of the last triangle get a fixed score, so that strips are not favoured over fans. */
+                score = 0.75f;
+            }
+            else
+            {
+                score = powf(1.0f - float(cachePosition - 3) / float(modelledCacheSize - 3), 1.5f);
+            }
+        }
+
+        /* Vertices with few triangles left are finished off first, so they do not need to be fetched again later. */
+        return score + 2.0f / sqrtf((float)remainingTriangles);
+    }
+
+    /* Order the triangles of one index range with Tom Forsyth's algorithm. */
+    static void optimiseTriangleOrder(unsigned int *indices, size_t numberOfIndices, int numberOfVertices)
+    {
+        const int numberOfTriangles = (int)(numberOfIndices / 3);
+
+        if (numberOfTriangles == 0)
+        {
+            return;
+        }
+
+        /* Triangles using each vertex, packed into one array. The first remainingTriangles entries of each range are still to be emitted. */
+        vector<int> triangleOffsets(numberOfVertices + 1, 0);
+        vector<int> remainingTriangles(numberOfVertices, 0);
+
+        for (size_t index = 0; index < numberOfIndices; index++)
+        {
+            remainingTriangles[indices[index]]++;
+        }
+        for (int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            triangleOffsets[vertex + 1] = triangleOffsets[vertex] + remainingTriangles[vertex];
+        }
+
+        vector<int> vertexTriangles(numberOfIndices);
+        vector<int> fill(triangleOffsets.begin(), triangleOffsets.end() - 1);
+
+        for (size_t index = 0; index < numberOfIndices; index++)
+        {
+            vertexTriangles[fill[indices[index]]++] = (int)(index / 3);
+        }
+
+        vector<float> vertexScores(numberOfVertices);
+        vector<float> triangleScores(numberOfTriangles, 0.0f);
+        vector<bool> emitted(numberOfTriangles, false);
+
+        for (int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            vertexScores[vertex] = calculateVertexScore(-1, remainingTriangles[vertex]);
+        }
+        for (int triangle = 0; triangle < numberOfTriangles; triangle++)
+        {
+            for (int corner = 0; corner < 3; corner++)
+            {
+                triangleScores[triangle] += vertexScores[indices[triangle * 3 + corner]];
+            }
+        }
+
+        vector<unsigned int> optimisedIndices;
+        optimisedIndices.reserve(numberOfIndices);
+
+        /* The cache holds 3 more entries than modelled, so the vertices pushed out by a triangle can still be rescored. */
+        vector<int> cache;
+        vector<int> newCache;
+        cache.reserve(modelledCacheSize + 3);
+        newCache.reserve(modelledCacheSize + 3);
+
+        int bestTriangle = -1;
+        int searchStart = 0;
+
+        for (int emittedTriangles = 0; emittedTriangles < numberOfTriangles; emittedTriangles++)
+        {
+            if (bestTriangle < 0)
+            {
+                /* Nothing in the cache can continue, so start again from the best scoring triangle left anywhere. */
+                float bestScore = -1.0f;
+
+                while (emitted[searchStart])
+                {
+                    searchStart++;
+                }
+                for (int triangle = searchStart; triangle < numberOfTriangles; triangle++)
+                {
+                    if (!emitted[triangle] && triangleScores[triangle] > bestScore)
+                    {
+                        bestScore = triangleScores[triangle];
+                        bestTriangle = triangle;
+                    }
+                }
+            }
+
+            emitted[bestTriangle] = true;
+
+            newCache.clear();
+            for (int corner = 0; corner < 3; corner++)
+            {
+                const int vertex = (int)indices[bestTriangle * 3 + corner];
+
+                optimisedIndices.push_back(vertex);
+                newCache.push_back(vertex);
+
+                /* Remove the triangle from the ones still waiting on this vertex. */
+                int *first = &vertexTriangles[triangleOffsets[vertex]];
+                int *last = first + remainingTriangles[vertex] - 1;
+                std::swap(*std::find(first, last + 1, bestTriangle), *last);
+                remainingTriangles[vertex]--;
+            }
+
+            for (size_t entry = 0; entry < cache.size(); entry++)
+            {
+                if (std::find(newCache.begin(), newCache.begin() + 3, cache[entry]) == newCache.begin() + 3)
+                {
+                    newCache.push_back(cache[entry]);
+                }
+            }
+            cache.swap(newCache);
+
+            /* Rescore everything that is or was just in the cache, and pick the best triangle which uses those vertices. */
+            for (size_t entry = 0; entry < cache.size(); entry++)
+            {
+                const int vertex = cache[entry];
+                const int position = entry < (size_t)modelledCacheSize ? (int)entry : -1;
+                const float newScore = calculateVertexScore(position, remainingTriangles[vertex]);
+                const float change = newScore - vertexScores[vertex];
+                vertexScores[vertex] = newScore;
+
+                for (int triangle = 0; triangle < remainingTriangles[vertex]; triangle++)
+                {
+                    triangleScores[vertexTriangles[triangleOffsets[vertex] + triangle]] += change;
+                }
+            }
+
+            if (cache.size() > (size_t)modelledCacheSize)
+            {
+                cache.resize(modelledCacheSize);
+            }
+
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+
+            for (size_t entry = 0; entry < cache.size(); entry++)
+            {
+                const int vertex = cache[entry];
+
+                for (int triangle = 0; triangle < remainingTriangles[vertex]; triangle++)
+                {
+                    const int candidate = vertexTriangles[triangleOffsets[vertex] + triangle];
+
+                    if (triangleScores[candidate] > bestScore)
+                    {
+                        bestScore = triangleScores[candidate];
+                        bestTriangle = candidate;
+                    }
+                }
+            }
+        }
+
+        std::copy(optimisedIndices.begin(), optimisedIndices.end(), indices);
+    }
+
+    static short quantiseSigned(float value)
+    {
+        value = std::max(-1.0f, std::min(1.0f, value));
+
+        return (short)floorf(value * 32767.0f + 0.5f);
+    }
+
+    static unsigned short quantiseUnsigned(float value)
+    {
+        value = std::max(0.0f, std::min(1.0f, value));
+
+        return (unsigned short)floorf(value * 65535.0f + 0.5f);
+    }
+
+    unsigned int IndexedMesh::addVertex(const Vec3f &position, const Vec3f &normal, const Vec2f &uv)
+    {
+        positions.push_back(position.x);
+        positions.push_back(position.y);
+        positions.push_back(position.z);
+        normals.push_back(normal.x);
+        normals.push_back(normal.y);
+        normals.push_back(normal.z);
+        uvs.push_back(uv.x);
+        uvs.push_back(uv.y);
+
+        return getNumberOfVertices() - 1;
+    }
+
+    void IndexedMesh::addTriangle(unsigned int first, unsigned int second, unsigned int third)
+    {
+        const float *a = &positions[first * 3];
+        const float *b = &positions[second * 3];
+        const float *c = &positions[third * 3];
+
+        /*
+         * Pole rows of the generators collapse to a point, up to rounding, so their triangles cover no area.
+         * Such a triangle has edges which are (almost) parallel: |u x v| is tiny compared with |u| * |v|.
+         */
+        const float u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const float v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const float cross[3] = { u[1] * v[2] - u[2] * v[1], u[2] * v[0] - u[0] * v[2], u[0] * v[1] - u[1] * v[0] };
+        const float crossLengthSquared = cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2];
+        const float uLengthSquared = u[0] * u[0] + u[1] * u[1] + u[2] * u[2];
+        const float vLengthSquared = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+
+        if (crossLengthSquared <= 1e-10f * uLengthSquared * vLengthSquared)
+        {
+            return;
+        }
+
+        indices.push_back(first);
+        indices.push_back(second);
+        indices.push_back(third);
+    }
+
+    void IndexedMesh::addQuad(unsigned int first, unsigned int second, unsigned int third, unsigned int fourth)
+    {
+        addTriangle(first, second, third);
+        addTriangle(first, third, fourth);
+    }
+
+    void IndexedMesh::optimise(void)
+    {
+        for (unsigned int level = 0; level < getNumberOfLevels(); level++)
+        {
+            const LevelOfDetail range = getLevel(level);
+
+            if (range.numberOfIndices > 0)
+            {
+                optimiseTriangleOrder(&indices[range.firstIndex], range.numberOfIndices, (int)getNumberOfVertices());
+            }
+        }
+        optimiseVertexOrder();
+    }
+
+    void IndexedMesh::optimiseVertexOrder(void)
+    {
+        const unsigned int numberOfVertices = getNumberOfVertices();
+        const unsigned int unused = 0xFFFFFFFF;
+
+        vector<unsigned int> newIndices(numberOfVertices, unused);
+        vector<float> newPositions;
+        vector<float> newNormals;
+        vector<float> newUVs;
+        unsigned int nextIndex = 0;
+
+        newPositions.reserve(positions.size());
+        newNormals.reserve(normals.size());
+        newUVs.reserve(uvs.size());
+
+        /* Coarser levels use a subset of the vertices of finer ones, so number their vertices first. */
+        for (unsigned int level = getNumberOfLevels(); level-- > 0;)
+        {
+            const LevelOfDetail range = getLevel(level);
+
+            for (size_t index = range.firstIndex; index < range.firstIndex + range.numberOfIndices; index++)
+            {
+                const unsigned int vertex = indices[index];
+
+                if (newIndices[vertex] == unused)
+                {
+                    newIndices[vertex] = nextIndex++;
+                    newPositions.insert(newPositions.end(), &positions[vertex * 3], &positions[vertex * 3] + 3);
+                    newNormals.insert(newNormals.end(), &normals[vertex * 3], &normals[vertex * 3] + 3);
+                    newUVs.insert(newUVs.end(), &uvs[vertex * 2], &uvs[vertex * 2] + 2);
+                }
+            }
+        }
+
+        for (size_t index = 0; index < indices.size(); index++)
+        {
+            indices[index] = newIndices[indices[index]];
+        }
+
+        positions.swap(newPositions);
+        normals.swap(newNormals);
+        uvs.swap(newUVs);
+    }
+
+    IndexedMesh::VertexLayout IndexedMesh::getVertexLayout(VertexFormat format)
+    {
+        VertexLayout layout;
+
+        if (format == VERTEX_FORMAT_QUANTISED)
+        {
+            const VertexAttribute position = { 4, GL_SHORT, GL_TRUE, 0 };
+            const VertexAttribute normal = { 2, GL_SHORT, GL_TRUE, 8 };
+            const VertexAttribute uv = { 2, GL_UNSIGNED_SHORT, GL_TRUE, 12 };
+
+            layout.stride = 16;
+            layout.position = position;
+            layout.normal = normal;
+            layout.uv = uv;
+        }
+        else
+        {
+            const VertexAttribute position = { 3, GL_FLOAT, GL_FALSE, 0 };
+            const VertexAttribute normal = { 3, GL_FLOAT, GL_FALSE, 12 };
+            const VertexAttribute uv = { 2, GL_FLOAT, GL_FALSE, 24 };
+
+            layout.stride = 32;
+            layout.position = position;
+            layout.normal = normal;
+            layout.uv = uv;
+        }
+
+        return layout;
+    }
+
+    void IndexedMesh::getBounds(Vec3f *centre, Vec3f *extent) const
+    {
+        float minimum[3] = { 0.0f, 0.0f, 0.0f };
+        float maximum[3] = { 0.0f, 0.0f, 0.0f };
+
+        for (size_t index = 0; index < positions.size(); index++)
+        {
+            const int axis = index % 3;
+
+            if (index < 3 || positions[index] < minimum[axis])
+            {
+                minimum[axis] = positions[index];
+            }
+            if (index < 3 || positions[index] > maximum[axis])
+            {
+                maximum[axis] = positions[index];
+            }
+        }
+
+        centre->x = (minimum[0] + maximum[0]) * 0.5f;
+        centre->y = (minimum[1] + maximum[1]) * 0.5f;
+        centre->z = (minimum[2] + maximum[2]) * 0.5f;
+
+        /* A flat axis would divide by zero; any scale maps it to the centre. */
+        extent->x = maximum[0] > minimum[0] ? (maximum[0] - minimum[0]) * 0.5f : 1.0f;
+        extent->y = maximum[1] > minimum[1] ? (maximum[1] - minimum[1]) * 0.5f : 1.0f;
+        extent->z = maximum[2] > minimum[2] ? (maximum[2] - minimum[2]) * 0.5f : 1.0f;
+    }
+
+    Matrix IndexedMesh::getDequantisationMatrix(void) const
+    {
+        Vec3f centre;
+        Vec3f extent;
+        getBounds(&centre, &extent);
+
+        return Matrix::createTranslation(centre.x, centre.y, centre.z) * Matrix::createScaling(extent.x, extent.y, extent.z);
+    }
+
+    void IndexedMesh::getVertexData(VertexFormat format, vector<unsigned char> *data) const
+    {
+        const unsigned int numberOfVertices = getNumberOfVertices();
+        const VertexLayout layout = getVertexLayout(format);
+
+        data->resize(numberOfVertices * layout.stride);
+
+        if (format == VERTEX_FORMAT_FLOAT)
+        {
+            for (unsigned int vertex = 0; vertex < numberOfVertices; vertex++)
+            {
+                unsigned char *destination = &(*data)[vertex * layout.stride];
+
+                memcpy(destination + layout.position.offset, &positions[vertex * 3], 3 * sizeof(float));
+                memcpy(destination + layout.normal.offset, &normals[vertex * 3], 3 * sizeof(float));
+                memcpy(destination + layout.uv.offset, &uvs[vertex * 2], 2 * sizeof(float));
+            }
+            return;
+        }
+
+        Vec3f centre;
+        Vec3f extent;
+        getBounds(&centre, &extent);
+
+        for (unsigned int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            const float *position = &positions[vertex * 3];
+            const float *normal = &normals[vertex * 3];
+
+            /* w = 32767 decodes to exactly 1.0. */
+            const short quantisedPosition[4] =
+            {
+                quantiseSigned((position[0] - centre.x) / extent.x),
+                quantiseSigned((position[1] - centre.y) / extent.y),
+                quantiseSigned((position[2] - centre.z) / extent.z),
+                32767
+            };
+
+            /* Project the normal onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper one. */
+            const float length = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+            float octahedronX = length > 0.0f ? normal[0] / length : 0.0f;
+            float octahedronY = length > 0.0f ? normal[1] / length : 0.0f;
+
+            if (normal[2] < 0.0f)
+            {
+                const float foldedX = (1.0f - fabsf(octahedronY)) * (octahedronX >= 0.0f ? 1.0f : -1.0f);
+                const float foldedY = (1.0f - fabsf(octahedronX)) * (octahedronY >= 0.0f ? 1.0f : -1.0f);
+
+                octahedronX = foldedX;
+                octahedronY = foldedY;
+            }
+
+            const short quantisedNormal[2] = { quantiseSigned(octahedronX), quantiseSigned(octahedronY) };
+            const unsigned short quantisedUV[2] = { quantiseUnsigned(uvs[vertex * 2]), quantiseUnsigned(uvs[vertex * 2 + 1]) };
+
+            unsigned char *destination = &(*data)[vertex * layout.stride];
+
+            memcpy(destination + layout.position.offset, quantisedPosition, sizeof(quantisedPosition));
+            memcpy(destination + layout.normal.offset, quantisedNormal, sizeof(quantisedNormal));
+            memcpy(destination + layout.uv.offset, quantisedUV, sizeof(quantisedUV));
+        }
+    }
+
+    GLenum IndexedMesh::getIndexType(void) const
+    {
+        return getNumberOfVertices() <= 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    }
+
+    void IndexedMesh::getIndexData(vector<unsigned char> *data) const
+    {
+        if (getIndexType() == GL_UNSIGNED_INT)
+        {
+            data->resize(indices.size() * sizeof(unsigned int));
+            if (!indices.empty())
+            {
+                memcpy(&(*data)[0], &indices[0], data->size());
+            }
+            return;
+        }
+
+        data->resize(indices.size() * sizeof(unsigned short));
+
+        for (size_t index = 0; index < indices.size(); index++)
+        {
+            const unsigned short shortIndex = (unsigned short)indices[index];
+
+            memcpy(&(*data)[index * sizeof(unsigned short)], &shortIndex, sizeof(shortIndex));
+        }
+    }
+
+    void IndexedMesh::setVertexAttribPointers(VertexFormat format, GLint positionLocation, GLint normalLocation, GLint uvLocation, size_t offset)
+    {
+        const VertexLayout layout = getVertexLayout(format);
+        const GLint locations[3] = { positionLocation, normalLocation, uvLocation };
+        const VertexAttribute *attributes[3] = { &layout.position, &layout.normal, &layout.uv };
+
+        for (int attribute = 0; attribute < 3; attribute++)
+        {
+            if (locations[attribute] < 0)
+            {
+                continue;
+            }
+
+            GL_CHECK(glVertexAttribPointer(locations[attribute], attributes[attribute]->size, attributes[attribute]->type, attributes[attribute]->normalized,
+                                           layout.stride, (const void *)(offset + attributes[attribute]->offset)));
+            GL_CHECK(glEnableVertexAttribArray(locations[attribute]));
+        }
+    }
+
+    IndexedMesh::LevelOfDetail IndexedMesh::getLevel(unsigned int level) const
+    {
+        if (levels.empty())
+        {
+            const LevelOfDetail full = { 0, (unsigned int)indices.size(), 0.0f };
+
+            return full;
+        }
+
+        return levels[std::min(level, (unsigned int)levels.size() - 1)];
+    }
+
+    float IndexedMesh::getLevelDistance(unsigned int level, float projectionScale, float maximumScreenError) const
+    {
+        return getLevel(level).error * projectionScale / maximumScreenError;
+    }
+
+    unsigned int IndexedMesh::selectLevel(float distance, float projectionScale, float maximumScreenError) const
+    {
+        for (unsigned int level = getNumberOfLevels() - 1; level > 0; level--)
+        {
+            if (distance >= getLevelDistance(level, projectionScale, maximumScreenError))
+            {
+                return level;
+            }
+        }
+
+        return 0;
+    }
+
+    float IndexedMesh::getProjectionScale(Matrix projection, float viewportHeight)
+    {
+        /* Element 5 is cot(fieldOfView / 2), which maps a height of 1 at distance 1 to half the viewport. */
+        return projection[5] * viewportHeight * 0.5f;
+    }
+
+    float IndexedMesh::getAverageCacheMissRatio(unsigned int cacheSize, unsigned int level) const
+    {
+        const LevelOfDetail range = getLevel(level);
+
+        if (range.numberOfIndices == 0 || cacheSize == 0)
+        {
+            return 0.0f;
+        }
+
+        vector<unsigned int> cache(cacheSize, 0xFFFFFFFF);
+        unsigned int next = 0;
+        unsigned int misses = 0;
+
+        for (size_t index = range.firstIndex; index < range.firstIndex + range.numberOfIndices; index++)
+        {
+            if (std::find(cache.begin(), cache.end(), indices[index]) == cache.end())
+            {
+                cache[next] = indices[index];
+                next = (next + 1) % cacheSize;
+                misses++;
+            }
+        }
+
+        return float(misses) / float(range.numberOfIndices / 3);
+    }
+
+    const IndexedMesh *IndexedMesh::findCached(const string &key)
+    {
+        pthread_mutex_lock(&cachedMeshesMutex);
+
+        map<string, IndexedMesh *>::const_iterator mesh = cachedMeshes.find(key);
+        const IndexedMesh *result = mesh != cachedMeshes.end() ? mesh->second : NULL;
+
+        pthread_mutex_unlock(&cachedMeshesMutex);
+
+        return result;
+    }
+
+    const IndexedMesh *IndexedMesh::storeCached(const string &key, IndexedMesh *mesh)
+    {
+        pthread_mutex_lock(&cachedMeshesMutex);
+
+        std::pair<map<string, IndexedMesh *>::iterator, bool> stored = cachedMeshes.insert(std::make_pair(key, mesh));
+        const IndexedMesh *result = stored.first->second;
+
+        pthread_mutex_unlock(&cachedMeshesMutex);
+
+        if (!stored.second)
+        {
+            delete mesh;
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,708 @@
+/* Copyright (c) 2012-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iterator>
+#include <queue>
+#include <utility>
+
+using std::vector;
+
+namespace MaliSDK
+{
+    /* A closed mesh can not get simpler than a tetrahedron; collapsing further leaves two triangles back to back. */
+    static const unsigned int minimumNumberOfTriangles = 4;
+
+    /* Cosine of the largest angle by which a collapse may turn a triangle. Larger turns create folds along locked seams. */
+    static const double minimumTurnCosine = 0.5;
+
+    /* Symmetric 4x4 quadric matrix: the upper triangle, row by row. */
+    struct Quadric
+    {
+        double elements[10];
+    };
+
+    /* Candidate collapse of vertex "from" onto vertex "to". It is stale once either vertex has changed since. */
+    struct Collapse
+    {
+        double cost;
+        /* Squared length of the edge. Flat areas cost nothing, and collapsing their short edges first keeps the triangles even. */
+        double length;
+        unsigned int from;
+        unsigned int to;
+        unsigned int fromVersion;
+        unsigned int toVersion;
+
+        /* std::priority_queue keeps the largest element on top, so order by descending cost. */
+        bool operator<(const Collapse &other) const { return cost != other.cost ? cost > other.cost : length > other.length; }
+    };
+
+    static void addPlane(Quadric *quadric, double a, double b, double c, double d)
+    {
+        double *q = quadric->elements;
+
+        q[0] += a * a; q[1] += a * b; q[2] += a * c; q[3] += a * d;
+        q[4] += b * b; q[5] += b * c; q[6] += b * d;
+        q[7] += c * c; q[8] += c * d;
+        q[9] += d * d;
+    }
+
+    /* Sum of squared distances from position to the planes of the quadric. */
+    static double evaluateQuadric(const Quadric &quadric, const Quadric &other, const float *position)
+    {
+        double q[10];
+
+        for (int element = 0; element < 10; element++)
+        {
+            q[element] = quadric.elements[element] + other.elements[element];
+        }
+
+        const double x = position[0];
+        const double y = position[1];
+        const double z = position[2];
+
+        return x * (q[0] * x + 2.0 * (q[1] * y + q[2] * z + q[3])) +
+               y * (q[4] * y + 2.0 * (q[5] * z + q[6])) +
+               z * (q[7] * z + 2.0 * q[8]) +
+               q[9];
+    }
+
+    /* Unnormalised normal of the triangle a, b, c. */
+    static void getTriangleNormal(const float *a, const float *b, const float *c, double *normal)
+    {
+        const double u[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const double v[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+
+        normal[0] = u[1] * v[2] - u[2] * v[1];
+        normal[1] = u[2] * v[0] - u[0] * v[2];
+        normal[2] = u[0] * v[1] - u[1] * v[0];
+    }
+
+    static double dot3(const double *a, const double *b)
+    {
+        return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+    }
+
+    /* Squared distance from point p to the triangle a, b, c, from Christer Ericson, "Real-Time Collision Detection". */
+    static double getSquaredDistanceToTriangle(const float *p, const float *a, const float *b, const float *c)
+    {
+        const double ab[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+        const double ac[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+        const double ap[3] = { p[0] - a[0], p[1] - a[1], p[2] - a[2] };
+        const double bp[3] = { p[0] - b[0], p[1] - b[1], p[2] - b[2] };
+        const double cp[3] = { p[0] - c[0], p[1] - c[1], p[2] - c[2] };
+
+        const double d1 = dot3(ab, ap);
+        const double d2 = dot3(ac, ap);
+        const double d3 = dot3(ab, bp);
+        const double d4 = dot3(ac, bp);
+        const double d5 = dot3(ab, cp);
+        const double d6 = dot3(ac, cp);
+        const double va = d3 * d6 - d5 * d4;
+        const double vb = d5 * d2 - d1 * d6;
+        const double vc = d1 * d4 - d3 * d2;
+
+        /* Barycentric coordinates (1 - v - w, v, w) of the closest point, which may lie on a corner or an edge. */
+        double v = 0.0;
+        double w = 0.0;
+
+        if (d1 <= 0.0 && d2 <= 0.0)
+        {
+        }
+        else if (d3 >= 0.0 && d4 <= d3)
+        {
+            v = 1.0;
+        }
+        else if (d6 >= 0.0 && d5 <= d6)
+        {
+            w = 1.0;
+        }
+        else if (vc <= 0.0 && d1 >= 0.0 && d3 <= 0.0)
+        {
+            v = d1 / (d1 - d3);
+        }
+        else if (vb <= 0.0 && d2 >= 0.0 && d6 <= 0.0)
+        {
+            w = d2 / (d2 - d6);
+        }
+        else if (va <= 0.0 && d4 - d3 >= 0.0 && d5 - d6 >= 0.0)
+        {
+            w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+            v = 1.0 - w;
+        }
+        else
+        {
+            const double denominator = 1.0 / (va + vb + vc);
+
+            v = vb * denominator;
+            w = vc * denominator;
+        }
+
+        const double offset[3] =
+        {
+            ap[0] - ab[0] * v - ac[0] * w,
+            ap[1] - ab[1] * v - ac[1] * w,
+            ap[2] - ab[2] * v - ac[2] * w
+        };
+
+        return dot3(offset, offset);
+    }
+
+    /* Orders vertex indices by position, so vertices sharing a position end up next to each other. */
+    class PositionOrder
+    {
+    public:
+        explicit PositionOrder(const vector<float> &positions) : positions(positions) {}
+
+        bool operator()(unsigned int first, unsigned int second) const
+        {
+            return std::lexicographical_compare(&positions[first * 3], &positions[first * 3] + 3,
+                                                &positions[second * 3], &positions[second * 3] + 3);
+        }
+
+    private:
+        const vector<float> &positions;
+    };
+
+    /* Progressive edge collapse of one triangle list. Each call to simplify() continues where the previous one stopped. */
+    class EdgeCollapser
+    {
+    public:
+        EdgeCollapser(const vector<float> &positions, const unsigned int *indices, unsigned int numberOfIndices);
+
+        /* Collapse edges until at most targetNumberOfTriangles are left, or no collapse is allowed any more. */
+        void simplify(unsigned int targetNumberOfTriangles);
+
+        void appendTriangles(vector<unsigned int> *indices) const;
+
+        unsigned int getNumberOfTriangles(void) const { return numberOfTriangles; }
+
+        /*
+         * Largest distance from a vertex of the source mesh to the triangles near the vertex it was collapsed onto.
+         * Never less than the error of the previous call.
+         */
+        float measureError(void);
+
+    private:
+        const vector<float> &positions;
+        vector<unsigned int> triangles;
+        vector<bool> removedTriangles;
+        unsigned int numberOfTriangles;
+
+        /* Triangles around each vertex. May still list triangles which have been removed since. */
+        vector<vector<unsigned int> > vertexTriangles;
+        vector<Quadric> quadrics;
+        vector<bool> lockedVertices;
+        vector<bool> removedVertices;
+        vector<unsigned int> versions;
+
+        /* Source vertices collapsed onto each vertex, including the vertex itself. */
+        vector<vector<unsigned int> > members;
+
+        std::priority_queue<Collapse> collapses;
+        double maximumSquaredError;
+
+        void lockSeamsAndBorders(void);
+        void addCollapse(unsigned int from, unsigned int to);
+        void addCollapses(unsigned int vertex);
+        void getNeighbours(unsigned int vertex, vector<unsigned int> *neighbours) const;
+        bool isAllowed(const Collapse &collapse) const;
+        void apply(const Collapse &collapse);
+
+        const float *getPosition(unsigned int vertex) const { return &positions[vertex * 3]; }
+    };
+
+    EdgeCollapser::EdgeCollapser(const vector<float> &positions, const unsigned int *indices, unsigned int numberOfIndices)
+        : positions(positions),
+          triangles(indices, indices + numberOfIndices),
+          removedTriangles(numberOfIndices / 3, false),
+          numberOfTriangles(numberOfIndices / 3),
+          maximumSquaredError(0.0)
+    {
+        const unsigned int numberOfVertices = (unsigned int)(positions.size() / 3);
+        const Quadric zero = { { 0.0 } };
+
+        vertexTriangles.resize(numberOfVertices);
+        quadrics.resize(numberOfVertices, zero);
+        lockedVertices.resize(numberOfVertices, false);
+        removedVertices.resize(numberOfVertices, false);
+        versions.resize(numberOfVertices, 0);
+        members.resize(numberOfVertices);
+
+        for (unsigned int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            members[vertex].push_back(vertex);
+        }
+
+        for (unsigned int triangle = 0; triangle < numberOfTriangles; triangle++)
+        {
+            const unsigned int *corners = &triangles[triangle * 3];
+            double normal[3];
+
+            getTriangleNormal(getPosition(corners[0]), getPosition(corners[1]), getPosition(corners[2]), normal);
+
+            const double length = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+
+            if (length > 0.0)
+            {
+                const float *point = getPosition(corners[0]);
+                const double a = normal[0] / length;
+                const double b = normal[1] / length;
+                const double c = normal[2] / length;
+                const double d = -(a * point[0] + b * point[1] + c * point[2]);
+
+                for (int corner = 0; corner < 3; corner++)
+                {
+                    addPlane(&quadrics[corners[corner]], a, b, c, d);
+                }
+            }
+
+            for (int corner = 0; corner < 3; corner++)
+            {
+                vertexTriangles[corners[corner]].push_back(triangle);
+            }
+        }
+
+        lockSeamsAndBorders();
+
+        for (unsigned int triangle = 0; triangle < numberOfTriangles; triangle++)
+        {
+            for (int corner = 0; corner < 3; corner++)
+            {
+                addCollapse(triangles[triangle * 3 + corner], triangles[triangle * 3 + (corner + 1) % 3]);
+            }
+        }
+    }
+
+    void EdgeCollapser::lockSeamsAndBorders(void)
+    {
+        const unsigned int numberOfVertices = (unsigned int)vertexTriangles.size();
+
+        /* Weld vertices by position, so seams are seen as the same surface on both sides. */
+        vector<unsigned int> order(numberOfVertices);
+        vector<unsigned int> welded(numberOfVertices);
+        vector<bool> lockedPositions(numberOfVertices, false);
+
+        for (unsigned int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            order[vertex] = vertex;
+        }
+        std::sort(order.begin(), order.end(), PositionOrder(positions));
+
+        for (unsigned int rank = 0; rank < numberOfVertices; rank++)
+        {
+            const unsigned int vertex = order[rank];
+
+            if (rank > 0 && std::equal(getPosition(vertex), getPosition(vertex) + 3, getPosition(order[rank - 1])))
+            {
+                welded[vertex] = welded[order[rank - 1]];
+                lockedPositions[welded[vertex]] = true;
+            }
+            else
+            {
+                welded[vertex] = vertex;
+            }
+        }
+
+        /* Every edge inside a closed surface is used by exactly two triangles. Edges used once are borders, more often non-manifold. */
+        vector<std::pair<unsigned int, unsigned int> > edges;
+        edges.reserve(triangles.size());
+
+        for (size_t index = 0; index < triangles.size(); index++)
+        {
+            const unsigned int first = welded[triangles[index]];
+            const unsigned int second = welded[triangles[index % 3 == 2 ? index - 2 : index + 1]];
+
+            edges.push_back(std::make_pair(std::min(first, second), std::max(first, second)));
+        }
+        std::sort(edges.begin(), edges.end());
+
+        for (size_t edge = 0; edge < edges.size();)
+        {
+            size_t end = edge + 1;
+
+            while (end < edges.size() && edges[end] == edges[edge])
+            {
+                end++;
+            }
+            if (end - edge != 2)
+            {
+                lockedPositions[edges[edge].first] = true;
+                lockedPositions[edges[edge].second] = true;
+            }
+            edge = end;
+        }
+
+        for (unsigned int vertex = 0; vertex < numberOfVertices; vertex++)
+        {
+            lockedVertices[vertex] = lockedPositions[welded[vertex]];
+        }
+    }
+
+    void EdgeCollapser::addCollapse(unsigned int from, unsigned int to)
+    {
+        if (lockedVertices[from] || from == to)
+        {
+            return;
+        }
+
+        const float *a = getPosition(from);
+        const float *b = getPosition(to);
+        const Collapse collapse =
+        {
+            evaluateQuadric(quadrics[from], quadrics[to], b),
+            (b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]) + (b[2] - a[2]) * (b[2] - a[2]),
+            from,
+            to,
+            versions[from],
+            versions[to]
+        };
+
+        collapses.push(collapse);
+    }
+
+    void EdgeCollapser::addCollapses(unsigned int vertex)
+    {
+        const vector<unsigned int> &around = vertexTriangles[vertex];
+
+        for (size_t entry = 0; entry < around.size(); entry++)
+        {
+            const unsigned int *corners = &triangles[around[entry] * 3];
+
+            for (int corner = 0; corner < 3; corner++)
+            {
+                const unsigned int first = corners[corner];
+                const unsigned int second = corners[(corner + 1) % 3];
+
+                /* Each direction of an inner edge is the winding order of one of its two triangles. */
+                if (first == vertex || second == vertex)
+                {
+                    addCollapse(first, second);
+                }
+            }
+        }
+    }
+
+    void EdgeCollapser::getNeighbours(unsigned int vertex, vector<unsigned int> *neighbours) const
+    {
+        const vector<unsigned int> &around = vertexTriangles[vertex];
+
+        neighbours->clear();
+        for (size_t entry = 0; entry < around.size(); entry++)
+        {
+            if (removedTriangles[around[entry]])
+            {
+                continue;
+            }
+            for (int corner = 0; corner < 3; corner++)
+            {
+                const unsigned int neighbour = triangles[around[entry] * 3 + corner];
+
+                if (neighbour != vertex)
+                {
+                    neighbours->push_back(neighbour);
+                }
+            }
+        }
+        std::sort(neighbours->begin(), neighbours->end());
+        neighbours->erase(std::unique(neighbours->begin(), neighbours->end()), neighbours->end());
+    }
+
+    bool EdgeCollapser::isAllowed(const Collapse &collapse) const
+    {
+        const unsigned int from = collapse.from;
+        const unsigned int to = collapse.to;
+
+        if (removedVertices[from] || removedVertices[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion)
+        {
+            return false;
+        }
+
+        /*
+         * Link condition: the vertices next to both ends of the edge must be exactly the tips of the triangles
+         * on the edge. Any other common neighbour would end up joined to the surface by a single edge.
+         */
+        vector<unsigned int> fromNeighbours;
+        vector<unsigned int> toNeighbours;
+        vector<unsigned int> commonNeighbours;
+
+        getNeighbours(from, &fromNeighbours);
+        getNeighbours(to, &toNeighbours);
+        std::set_intersection(fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                              std::back_inserter(commonNeighbours));
+
+        const vector<unsigned int> &around = vertexTriangles[from];
+        unsigned int sharedTriangles = 0;
+
+        for (size_t entry = 0; entry < around.size(); entry++)
+        {
+            const unsigned int *corners = &triangles[around[entry] * 3];
+
+            if (removedTriangles[around[entry]])
+            {
+                continue;
+            }
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                sharedTriangles++;
+                continue;
+            }
+
+            /* The triangles which move with the vertex must not flip over or become slivers. */
+            const float *moved[3];
+            for (int corner = 0; corner < 3; corner++)
+            {
+                moved[corner] = getPosition(corners[corner] == from ? to : corners[corner]);
+            }
+
+            double oldNormal[3];
+            double newNormal[3];
+
+            getTriangleNormal(getPosition(corners[0]), getPosition(corners[1]), getPosition(corners[2]), oldNormal);
+            getTriangleNormal(moved[0], moved[1], moved[2], newNormal);
+
+            const double dot = oldNormal[0] * newNormal[0] + oldNormal[1] * newNormal[1] + oldNormal[2] * newNormal[2];
+            const double oldLengthSquared = oldNormal[0] * oldNormal[0] + oldNormal[1] * oldNormal[1] + oldNormal[2] * oldNormal[2];
+            const double newLengthSquared = newNormal[0] * newNormal[0] + newNormal[1] * newNormal[1] + newNormal[2] * newNormal[2];
+            double edgeLengthsSquared = 1.0;
+
+            for (int corner = 0; corner < 2; corner++)
+            {
+                const float *a = moved[0];
+                const float *b = moved[corner + 1];
+
+                edgeLengthsSquared *= (b[0] - a[0]) * (b[0] - a[0]) + (b[1] - a[1]) * (b[1] - a[1]) + (b[2] - a[2]) * (b[2] - a[2]);
+            }
+
+            if (dot <= 0.0 || dot * dot < minimumTurnCosine * minimumTurnCosine * oldLengthSquared * newLengthSquared ||
+                newLengthSquared <= 1e-10 * edgeLengthsSquared)
+            {
+                return false;
+            }
+        }
+
+        return sharedTriangles > 0 && commonNeighbours.size() == sharedTriangles;
+    }
+
+    void EdgeCollapser::apply(const Collapse &collapse)
+    {
+        const unsigned int from = collapse.from;
+        const unsigned int to = collapse.to;
+        vector<unsigned int> &fromTriangles = vertexTriangles[from];
+        vector<unsigned int> &toTriangles = vertexTriangles[to];
+
+        for (size_t entry = 0; entry < fromTriangles.size(); entry++)
+        {
+            const unsigned int triangle = fromTriangles[entry];
+            unsigned int *corners = &triangles[triangle * 3];
+
+            if (removedTriangles[triangle])
+            {
+                continue;
+            }
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                removedTriangles[triangle] = true;
+                numberOfTriangles--;
+                continue;
+            }
+            for (int corner = 0; corner < 3; corner++)
+            {
+                if (corners[corner] == from)
+                {
+                    corners[corner] = to;
+                }
+            }
+            toTriangles.push_back(triangle);
+        }
+
+        /* Drop the triangles which have just been removed, so the list does not keep growing. */
+        vector<unsigned int> liveTriangles;
+        liveTriangles.reserve(toTriangles.size());
+        for (size_t entry = 0; entry < toTriangles.size(); entry++)
+        {
+            if (!removedTriangles[toTriangles[entry]])
+            {
+                liveTriangles.push_back(toTriangles[entry]);
+            }
+        }
+        toTriangles.swap(liveTriangles);
+        vector<unsigned int>().swap(fromTriangles);
+
+        for (int element = 0; element < 10; element++)
+        {
+            quadrics[to].elements[element] += quadrics[from].elements[element];
+        }
+        members[to].insert(members[to].end(), members[from].begin(), members[from].end());
+        vector<unsigned int>().swap(members[from]);
+        removedVertices[from] = true;
+        versions[to]++;
+
+        /* The quadric of "to" has changed, so every collapse which involves it has a new cost. */
+        addCollapses(to);
+    }
+
+    void EdgeCollapser::simplify(unsigned int targetNumberOfTriangles)
+    {
+        targetNumberOfTriangles = std::max(targetNumberOfTriangles, minimumNumberOfTriangles);
+
+        while (numberOfTriangles > targetNumberOfTriangles && !collapses.empty())
+        {
+            const Collapse collapse = collapses.top();
+            collapses.pop();
+
+            if (isAllowed(collapse))
+            {
+                apply(collapse);
+            }
+        }
+    }
+
+    float EdgeCollapser::measureError(void)
+    {
+        vector<unsigned int> neighbours;
+        vector<unsigned int> nearbyTriangles;
+
+        for (unsigned int vertex = 0; vertex < (unsigned int)members.size(); vertex++)
+        {
+            /* Vertices which kept their own position and neighbours add no error. */
+            if (removedVertices[vertex] || members[vertex].size() < 2)
+            {
+                continue;
+            }
+
+            /*
+             * The source vertices can lie beside the triangles around the vertex they were collapsed onto,
+             * for example on a flat area, so also search the triangles one ring further out.
+             */
+            getNeighbours(vertex, &neighbours);
+            neighbours.push_back(vertex);
+            nearbyTriangles.clear();
+
+            for (size_t neighbour = 0; neighbour < neighbours.size(); neighbour++)
+            {
+                const vector<unsigned int> &around = vertexTriangles[neighbours[neighbour]];
+
+                for (size_t entry = 0; entry < around.size(); entry++)
+                {
+                    if (!removedTriangles[around[entry]])
+                    {
+                        nearbyTriangles.push_back(around[entry]);
+                    }
+                }
+            }
+            std::sort(nearbyTriangles.begin(), nearbyTriangles.end());
+            nearbyTriangles.erase(std::unique(nearbyTriangles.begin(), nearbyTriangles.end()), nearbyTriangles.end());
+
+            for (size_t member = 0; member < members[vertex].size(); member++)
+            {
+                const float *position = getPosition(members[vertex][member]);
+                double squaredDistance = -1.0;
+
+                for (size_t entry = 0; entry < nearbyTriangles.size(); entry++)
+                {
+                    const unsigned int *corners = &triangles[nearbyTriangles[entry] * 3];
+                    const double distance = getSquaredDistanceToTriangle(position, getPosition(corners[0]), getPosition(corners[1]), getPosition(corners[2]));
+
+                    if (squaredDistance < 0.0 || distance < squaredDistance)
+                    {
+                        squaredDistance = distance;
+                    }
+                }
+                maximumSquaredError = std::max(maximumSquaredError, squaredDistance);
+            }
+        }
+
+        return (float)sqrt(maximumSquaredError);
+    }
+
+    void EdgeCollapser::appendTriangles(vector<unsigned int> *indices) const
+    {
+        for (size_t triangle = 0; triangle < removedTriangles.size(); triangle++)
+        {
+            if (!removedTriangles[triangle])
+            {
+                indices->insert(indices->end(), &triangles[triangle * 3], &triangles[triangle * 3] + 3);
+            }
+        }
+    }
+
+    IndexedMesh *MeshSimplifier::createLevelsOfDetail(const IndexedMesh &mesh, unsigned int maximumNumberOfLevels, float reduction)
+    {
+        const IndexedMesh::LevelOfDetail source = mesh.getLevel(0);
+        IndexedMesh *result = new IndexedMesh;
+
+        result->positions = mesh.positions;
+        result->normals = mesh.normals;
+        result->uvs = mesh.uvs;
+        result->indices.assign(mesh.indices.begin() + source.firstIndex, mesh.indices.begin() + source.firstIndex + source.numberOfIndices);
+
+        const IndexedMesh::LevelOfDetail full = { 0, source.numberOfIndices, 0.0f };
+        result->levels.push_back(full);
+
+        if (source.numberOfIndices > 0)
+        {
+            EdgeCollapser collapser(result->positions, &result->indices[0], source.numberOfIndices);
+            float targetNumberOfTriangles = float(source.numberOfIndices / 3);
+
+            for (unsigned int level = 1; level < maximumNumberOfLevels; level++)
+            {
+                const unsigned int previousNumberOfTriangles = collapser.getNumberOfTriangles();
+
+                targetNumberOfTriangles *= reduction;
+                collapser.simplify((unsigned int)targetNumberOfTriangles);
+
+                if (collapser.getNumberOfTriangles() == previousNumberOfTriangles)
+                {
+                    break;
+                }
+
+                IndexedMesh::LevelOfDetail lod = { (unsigned int)result->indices.size(), 0, collapser.measureError() };
+
+                collapser.appendTriangles(&result->indices);
+                lod.numberOfIndices = (unsigned int)result->indices.size() - lod.firstIndex;
+                result->levels.push_back(lod);
+            }
+        }
+
+        result->optimise();
+
+        return result;
+    }
+
+    const IndexedMesh *MeshSimplifier::getLevelsOfDetail(const IndexedMesh *mesh, unsigned int maximumNumberOfLevels, float reduction)
+    {
+        char key[64];
+        snprintf(key, sizeof(key), "lod %p %u %a", (const void *)mesh, maximumNumberOfLevels, reduction);
+
+        const IndexedMesh *cached = IndexedMesh::findCached(key);
+
+        if (cached != NULL)
+        {
+            return cached;
+        }
+
+        return IndexedMesh::storeCached(key, createLevelsOfDetail(*mesh, maximumNumberOfLevels, reduction));
+    }
+}
@@ -280,17 +280,42 @@ namespace MaliSDK
 
     void PlaneModel::transform(Matrix transform, int numberOfCoordinates, float** squareCoordinates)
     {
-        /* Loop through all the coordinates and transform them using the rotation matrix. */
-        for (int allCoordinates = 0; allCoordinates < numberOfCoordinates; allCoordinates +=4)
-        {
-            Vec4f currentVertex = {(*squareCoordinates)[allCoordinates], (*squareCoordinates)[allCoordinates + 1], (*squareCoordinates)[allCoordinates + 2], (*squareCoordinates)[allCoordinates + 3]};
+        /* Coordinates are 4D vectors, transformed in place. */
+        Matrix::transformVectors(&transform, *squareCoordinates, 4, *squareCoordinates, 4, numberOfCoordinates / 4);
+    }
 
-            Vec4f rotatedVertex = Matrix::vertexTransform(&currentVertex, &transform);
+    const IndexedMesh* PlaneModel::getIndexedMesh(void)
+    {
+        static const char key[] = "PlaneModel";
 
-            (*squareCoordinates)[allCoordinates] = rotatedVertex.x;
-            (*squareCoordinates)[allCoordinates + 1] = rotatedVertex.y;
-            (*squareCoordinates)[allCoordinates + 2] = rotatedVertex.z;
-            (*squareCoordinates)[allCoordinates + 3] = rotatedVertex.w;
+        const IndexedMesh* cachedMesh = IndexedMesh::findCached(key);
+        if (cachedMesh != NULL)
+        {
+            return cachedMesh;
         }
+
+        IndexedMesh* mesh = new IndexedMesh();
+
+        /* Points A, B, C and D as in getTriangleRepresentation(), with the matching U/V coordinates. */
+        const Vec3f normal = {0.0f, 1.0f, 0.0f};
+        const Vec3f a = {-1.0f, 0.0f, -1.0f};
+        const Vec3f b = { 1.0f, 0.0f, -1.0f};
+        const Vec3f c = { 1.0f, 0.0f,  1.0f};
+        const Vec3f d = {-1.0f, 0.0f,  1.0f};
+        const Vec2f uvA = {0.0f, 0.0f};
+        const Vec2f uvB = {1.0f, 0.0f};
+        const Vec2f uvC = {1.0f, 1.0f};
+        const Vec2f uvD = {0.0f, 1.0f};
+
+        const unsigned int indexA = mesh->addVertex(a, normal, uvA);
+        const unsigned int indexB = mesh->addVertex(b, normal, uvB);
+        const unsigned int indexC = mesh->addVertex(c, normal, uvC);
+        const unsigned int indexD = mesh->addVertex(d, normal, uvD);
+
+        /* Counter-clockwise seen from +Y. */
+        mesh->addQuad(indexA, indexD, indexC, indexB);
+        mesh->optimise();
+
+        return IndexedMesh::storeCached(key, mesh);
     }
 }
\ No newline at end of file
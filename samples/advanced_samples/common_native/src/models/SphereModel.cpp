@@ -25,6 +25,8 @@
 #include <cstdlib>
 #include <cmath>
 #include <cassert>
+#include <cstdio>
+#include <algorithm>
 
 namespace MaliSDK
 {
@@ -361,6 +363,60 @@ namespace MaliSDK
         pointCoordinates = NULL;
     }
 
+    const IndexedMesh* SphereModel::getIndexedMesh(float radius, int numberOfSamples)
+    {
+        if (radius <= 0.0f || numberOfSamples < 2)
+        {
+            LOGE("radius has to be greater than zero and numberOfSamples at least 2.");
+            return NULL;
+        }
+
+        char key[64];
+        snprintf(key, sizeof(key), "SphereModel|%a|%d", radius, numberOfSamples);
+
+        const IndexedMesh* cachedMesh = IndexedMesh::findCached(key);
+        if (cachedMesh != NULL)
+        {
+            return cachedMesh;
+        }
+
+        IndexedMesh* mesh = new IndexedMesh();
+
+        /* Value of latitude step, as in getPointRepresentation(). */
+        const float radiusStep = (2 * radius) / float(numberOfSamples - 1);
+        /* Points per circle, including the one closing the texture seam. */
+        const int pointsPerCircle = numberOfSamples + 1;
+
+        for (int circleIndex = 0; circleIndex < numberOfSamples; circleIndex++)
+        {
+            const float r = std::min(-radius + circleIndex * radiusStep, radius);
+            const float circleRadius = sqrtf(std::max(radius * radius - r * r, 0.0f));
+
+            for (int pointIndex = 0; pointIndex < pointsPerCircle; pointIndex++)
+            {
+                const float theta = (pointIndex % numberOfSamples) * (2.0f * M_PI / float(numberOfSamples));
+                const Vec3f position = {circleRadius * cosf(theta), circleRadius * sinf(theta), r};
+                const Vec3f normal = {position.x / radius, position.y / radius, position.z / radius};
+                const Vec2f uv = {float(pointIndex) / float(numberOfSamples), float(circleIndex) / float(numberOfSamples - 1)};
+
+                mesh->addVertex(position, normal, uv);
+            }
+        }
+
+        /* Same triangles as getTriangleRepresentation(): A1 B1 B2 and A1 B2 A2. */
+        for (int circleIndex = 0; circleIndex < numberOfSamples - 1; circleIndex++)
+        {
+            for (int pointIndex = 0; pointIndex < numberOfSamples; pointIndex++)
+            {
+                const unsigned int a1 = circleIndex * pointsPerCircle + pointIndex;
+                const unsigned int a2 = a1 + pointsPerCircle;
+
+                mesh->addQuad(a1, a1 + 1, a2 + 1, a2);
+            }
+        }
+
+        mesh->optimise();
 
-    
+        return IndexedMesh::storeCached(key, mesh);
+    }
 }
\ No newline at end of file
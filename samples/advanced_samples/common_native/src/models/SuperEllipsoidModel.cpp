@@ -24,6 +24,7 @@
 #include "Mathematics.h"
 
 #include <cstdlib>
+#include <cstdio>
 
 namespace MaliSDK
 {      
@@ -228,4 +229,70 @@ namespace MaliSDK
 	    roundedCubeNormalVectors[normalVectorIndex++] = normalVector.y;
 	    roundedCubeNormalVectors[normalVectorIndex++] = normalVector.z;
     }
+
+    const IndexedMesh* SuperEllipsoidModel::getIndexedMesh(int samples, float n1, float n2, float scale)
+    {
+        if (samples < 2)
+        {
+            LOGE("Number of samples has to be at least 2.");
+            return NULL;
+        }
+
+        char key[128];
+        snprintf(key, sizeof(key), "SuperEllipsoidModel|%d|%a|%a|%a", samples, n1, n2, scale);
+
+        const IndexedMesh* cachedMesh = IndexedMesh::findCached(key);
+        if (cachedMesh != NULL)
+        {
+            return cachedMesh;
+        }
+
+        IndexedMesh* mesh = new IndexedMesh();
+
+        /* The same sampling grid as create(): samples / 2 steps of xyAngle and samples steps of xzAngle. */
+        const float angleDelta = 2.0f * M_PI / samples;
+        const int rows = samples / 2 + 1;
+        const int columns = samples + 1;
+
+        for (int j = 0; j < rows; j++)
+        {
+            const float xyAngle = -M_PI / 2.0f + j * angleDelta;
+
+            for (int i = 0; i < columns; i++)
+            {
+                const float xzAngle = -M_PI + i * angleDelta;
+                Vec3f vertex = sample(xyAngle, xzAngle, n1, n2, scale);
+                Vec3f normalVector = calculateNormal(xyAngle, xzAngle, n1, n2, scale);
+
+                /* In floating point cos(xyAngle) is not exactly zero at the poles, and its sign would mirror the pole ring. */
+                if (j == 0 || 2 * j == samples)
+                {
+                    const float pole = j == 0 ? -1.0f : 1.0f;
+
+                    vertex.x = vertex.z = 0.0f;
+                    vertex.y = pole * scale;
+                    normalVector.x = normalVector.z = 0.0f;
+                    normalVector.y = pole;
+                }
+
+                const Vec2f uv = {float(i) / float(samples), float(j) / float(rows - 1)};
+
+                mesh->addVertex(vertex, normalVector, uv);
+            }
+        }
+
+        for (int j = 0; j < rows - 1; j++)
+        {
+            for (int i = 0; i < samples; i++)
+            {
+                const unsigned int corner = j * columns + i;
+
+                mesh->addQuad(corner, corner + columns, corner + columns + 1, corner + 1);
+            }
+        }
+
+        mesh->optimise();
+
+        return IndexedMesh::storeCached(key, mesh);
+    }
 }
\ No newline at end of file
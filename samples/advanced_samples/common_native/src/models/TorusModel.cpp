@@ -24,6 +24,7 @@
 #include "Mathematics.h"
 
 #include <cassert>
+#include <cstdio>
 
 namespace MaliSDK
 {
@@ -408,4 +409,60 @@ namespace MaliSDK
             }
         }
     }
+
+    const IndexedMesh* TorusModel::getIndexedMesh(float torusRadius, float circleRadius, unsigned int circlesCount, unsigned int pointsPerCircleCount)
+    {
+        if (circlesCount < 3 || pointsPerCircleCount < 3)
+        {
+            LOGE("A torus needs at least 3 circles of at least 3 points.");
+            return NULL;
+        }
+
+        char key[128];
+        snprintf(key, sizeof(key), "TorusModel|%a|%a|%u|%u", torusRadius, circleRadius, circlesCount, pointsPerCircleCount);
+
+        const IndexedMesh* cachedMesh = IndexedMesh::findCached(key);
+        if (cachedMesh != NULL)
+        {
+            return cachedMesh;
+        }
+
+        IndexedMesh* mesh = new IndexedMesh();
+
+        for (unsigned int horizontalIndex = 0; horizontalIndex <= circlesCount; ++horizontalIndex)
+        {
+            /* Angle in radians on XZ plane. The last circle repeats the first one. */
+            float phi = (float) (horizontalIndex % circlesCount) * 2.0f * M_PI / circlesCount;
+
+            for (unsigned int verticalIndex = 0; verticalIndex <= pointsPerCircleCount; ++verticalIndex)
+            {
+                /* Angle in radians on XY plane. */
+                float theta = (float) (verticalIndex % pointsPerCircleCount) * 2.0f * M_PI / pointsPerCircleCount;
+
+                const Vec3f position = {(torusRadius + circleRadius * cosf(theta)) * cosf(phi),
+                                        circleRadius * sinf(theta),
+                                        (torusRadius + circleRadius * cosf(theta)) * sinf(phi)};
+                const Vec3f normal = {cosf(theta) * cosf(phi), sinf(theta), cosf(theta) * sinf(phi)};
+                const Vec2f uv = {float(horizontalIndex) / float(circlesCount), float(verticalIndex) / float(pointsPerCircleCount)};
+
+                mesh->addVertex(position, normal, uv);
+            }
+        }
+
+        const unsigned int pointsPerRow = pointsPerCircleCount + 1;
+
+        for (unsigned int horizontalIndex = 0; horizontalIndex < circlesCount; ++horizontalIndex)
+        {
+            for (unsigned int verticalIndex = 0; verticalIndex < pointsPerCircleCount; ++verticalIndex)
+            {
+                const unsigned int corner = horizontalIndex * pointsPerRow + verticalIndex;
+
+                mesh->addQuad(corner, corner + 1, corner + pointsPerRow + 1, corner + pointsPerRow);
+            }
+        }
+
+        mesh->optimise();
+
+        return IndexedMesh::storeCached(key, mesh);
+    }
 }
\ No newline at end of file
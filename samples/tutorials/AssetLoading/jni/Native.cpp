@@ -34,6 +34,8 @@
 #include <assimp/cimport.h>
 #include <assimp/scene.h>
 #include <vector>
+#include "Profiler.h"
+#include "Benchmark.h"
 
 /* The global Assimp scene object. */
 const struct aiScene* scene = NULL;
@@ -277,5 +279,9 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_assetloading_Nativ
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_assetloading_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("AssetLoading", setupGraphics, renderFrame)
@@ -45,6 +45,10 @@
  *            The colours of those two textures are mixed together with an appropriate factor value.
  *            (for more details please see the mix() function description in the OpenGL ES Shading Language documentation).
  *
+ *        The cost of step 3 grows with the strength of the effect. Setting bloomMode to one of the dual filter modes
+ *        replaces it with a mip chain: the luminance image is progressively downsampled and then upsampled back,
+ *        so the cost does not depend on the strength, which becomes a mix weight used by the upsampling passes.
+ *
  *        Besides the bloom effect, the application also shows:
  *        - matrix calculations (e.g. used for perspective view),
  *        - instanced drawing (each cube drawn on a screen is an instance of the same object),
@@ -57,10 +61,14 @@
 #include <android/log.h>
 
 #include <GLES3/gl3.h>
+#include <GLES3/gl31.h>
+
+#include <time.h>
 
 #include "CubeModel.h"
 #include "Matrix.h"
 #include "Shader.h"
+#include "Profiler.h"
 
 using namespace MaliSDK;
 
@@ -97,6 +105,13 @@ using namespace MaliSDK;
 /** Indicates how much time should it take to switch between number of blur passes. */
 #define TIME_INTERVAL              (1.0f)
 
+/** Number of dual filter mip chain levels below the downscaled luminance image. Each level halves the resolution. */
+#define DUAL_FILTER_NUMBER_OF_LEVELS (5)
+/** Diffusion used by the dual filter for the weakest bloom effect. The strongest effect uses 1.0. */
+#define DUAL_FILTER_MIN_DIFFUSION    (0.3f)
+/** Width and height of the work groups of the dual filter compute shaders. */
+#define DUAL_FILTER_WORK_GROUP_SIZE  (8)
+
 /* [Color texture unit define] */
 /** Texture unit which a color texture will be bound to. */
 #define TEXTURE_UNIT_COLOR_TEXTURE           (0)
@@ -111,6 +126,10 @@ using namespace MaliSDK;
 #define TEXTURE_UNIT_BLURRED_TEXTURE         (3)
 /** Texture unit which a texture with stronger blur effect will be bound to. */
 #define TEXTURE_UNIT_STRONGER_BLUR_TEXTURE   (4)
+/** Texture unit which the texture read by a dual filter pass will be bound to. */
+#define TEXTURE_UNIT_DUAL_FILTER_SOURCE      (5)
+/** Texture unit which the same resolution downsampled texture will be bound to during a dual filter upsampling pass. */
+#define TEXTURE_UNIT_DUAL_FILTER_DETAIL      (6)
 
 /** Camera depth location for horizontal position
  * (should be used when the window width is greater than window height).
@@ -141,6 +160,71 @@ struct BlendingProgramLocations
     }
 };
 
+/** \brief Structure holding program object ID and ID of a compute shader object attached to it.
+ */
+struct ComputeProgramAndShaderIds
+{
+    GLuint computeShaderObjectId;
+    GLuint programObjectId;
+
+    /* Default values constructor. */
+    ComputeProgramAndShaderIds()
+    {
+        computeShaderObjectId = 0;
+        programObjectId       = 0;
+    }
+};
+
+/** \brief Structure holding IDs and sizes of objects which were generated for the dual filter mip chain.
+ *         Level 0 is the downscaled luminance image, level n is 2^n times smaller.
+ */
+struct DualFilterObjects
+{
+    GLuint  framebufferObjectId;
+    /* Downsampled images. Element 0 is the luminance texture, which is not owned by this structure. */
+    GLuint  downsampleTextureObjectIds[DUAL_FILTER_NUMBER_OF_LEVELS + 1];
+    /* Upsampled images, of the same size as the downsampled ones. Element 0 holds the final blur. */
+    GLuint  upsampleTextureObjectIds  [DUAL_FILTER_NUMBER_OF_LEVELS];
+    GLsizei levelHeights              [DUAL_FILTER_NUMBER_OF_LEVELS + 1];
+    GLsizei levelWidths               [DUAL_FILTER_NUMBER_OF_LEVELS + 1];
+
+    /* Default values constructor. */
+    DualFilterObjects()
+    {
+        framebufferObjectId = 0;
+
+        for (int level = 0; level <= DUAL_FILTER_NUMBER_OF_LEVELS; level++)
+        {
+            downsampleTextureObjectIds[level] = 0;
+            levelHeights              [level] = 0;
+            levelWidths               [level] = 0;
+
+            if (level < DUAL_FILTER_NUMBER_OF_LEVELS)
+            {
+                upsampleTextureObjectIds[level] = 0;
+            }
+        }
+    }
+};
+
+/** \brief Structure holding locations of uniforms
+ *         used by a program object responsible for dual filter upsampling.
+ */
+struct DualFilterUpsampleProgramLocations
+{
+    GLint uniformDetailTexture;
+    GLint uniformDiffusion;
+    GLint uniformSourceTexture;
+
+    /* Default values constructor. */
+    DualFilterUpsampleProgramLocations()
+    {
+        uniformDetailTexture = -1;
+        uniformDiffusion     = -1;
+        uniformSourceTexture = -1;
+    }
+};
+
 /** \brief Structure holding ID of objects which were generated for blurring.
  */
 struct BlurringObjects
@@ -557,6 +641,165 @@ static const char renderTextureVertexShaderSource[] =   "#version 300 es\n"
                                                         "    texture_coordinates = texture_uv[gl_VertexID];\n"
                                                         "}\n";
 /* [Texture rendering vertex shader] */
+/* [Dual filter downsampling fragment shader source] */
+static const char dualFilterDownsampleFragmentShaderSource[] = "#version 300 es\n"
+                                                               "precision mediump float;\n"
+                                                               "/* UNIFORMS */\n"
+                                                               "/** Texture to be downsampled, twice the size of the render target. */\n"
+                                                               "uniform sampler2D source_texture;\n"
+                                                               "/* INPUTS */\n"
+                                                               "/** Texture coordinates. */\n"
+                                                               "in vec2 texture_coordinates;\n"
+                                                               "/* OUTPUTS */\n"
+                                                               "/** Fragment colour that will be returned. */\n"
+                                                               "out vec4 output_color;\n"
+                                                               "void main()\n"
+                                                               "{\n"
+                                                               "    /* Half a texel of the render target is a texel of the source, so the four diagonal samples\n"
+                                                               "     * fall on texel corners and each of the five bilinear fetches averages four texels. */\n"
+                                                               "    vec2 half_pixel = 1.0 / vec2(textureSize(source_texture, 0));\n"
+                                                               "    vec4 sum        = texture(source_texture, texture_coordinates) * 4.0;\n"
+                                                               "    sum += texture(source_texture, texture_coordinates - half_pixel);\n"
+                                                               "    sum += texture(source_texture, texture_coordinates + half_pixel);\n"
+                                                               "    sum += texture(source_texture, texture_coordinates + vec2(half_pixel.x, -half_pixel.y));\n"
+                                                               "    sum += texture(source_texture, texture_coordinates - vec2(half_pixel.x, -half_pixel.y));\n"
+                                                               "    /* Set the output colour. */\n"
+                                                               "    output_color = vec4((sum / 8.0).xyz, 1.0);\n"
+                                                               "}\n";
+/* [Dual filter downsampling fragment shader source] */
+/* [Dual filter upsampling fragment shader source] */
+static const char dualFilterUpsampleFragmentShaderSource[] = "#version 300 es\n"
+                                                             "precision mediump float;\n"
+                                                             "/* UNIFORMS */\n"
+                                                             "/** Weight of the upsampled blur against the detail texture: the higher, the wider the bloom. */\n"
+                                                             "uniform float     diffusion;\n"
+                                                             "/** Texture to be upsampled, half the size of the render target. */\n"
+                                                             "uniform sampler2D source_texture;\n"
+                                                             "/** Downsampled image of the same size as the render target. */\n"
+                                                             "uniform sampler2D detail_texture;\n"
+                                                             "/* INPUTS */\n"
+                                                             "/** Texture coordinates. */\n"
+                                                             "in vec2 texture_coordinates;\n"
+                                                             "/* OUTPUTS */\n"
+                                                             "/** Fragment colour that will be returned. */\n"
+                                                             "out vec4 output_color;\n"
+                                                             "void main()\n"
+                                                             "{\n"
+                                                             "    vec2 texel = 1.0 / vec2(textureSize(source_texture, 0));\n"
+                                                             "    /* Four samples one source texel away, weighted 1, and four diagonal samples half a texel away, weighted 2. */\n"
+                                                             "    vec4 sum = texture(source_texture, texture_coordinates + vec2(-texel.x, 0.0)) +\n"
+                                                             "               texture(source_texture, texture_coordinates + vec2( texel.x, 0.0)) +\n"
+                                                             "               texture(source_texture, texture_coordinates + vec2(0.0, -texel.y)) +\n"
+                                                             "               texture(source_texture, texture_coordinates + vec2(0.0,  texel.y));\n"
+                                                             "    sum += (texture(source_texture, texture_coordinates + vec2( 0.5,  0.5) * texel) +\n"
+                                                             "            texture(source_texture, texture_coordinates + vec2(-0.5,  0.5) * texel) +\n"
+                                                             "            texture(source_texture, texture_coordinates + vec2( 0.5, -0.5) * texel) +\n"
+                                                             "            texture(source_texture, texture_coordinates + vec2(-0.5, -0.5) * texel)) * 2.0;\n"
+                                                             "    vec4 detail = texture(detail_texture, texture_coordinates);\n"
+                                                             "    /* Set the output colour. */\n"
+                                                             "    output_color = vec4(mix(detail.xyz, sum.xyz / 12.0, diffusion), 1.0);\n"
+                                                             "}\n";
+/* [Dual filter upsampling fragment shader source] */
+/* [Dual filter downsampling compute shader source] */
+static const char dualFilterDownsampleComputeShaderSource[] = "#version 310 es\n"
+                                                              "precision highp float;\n"
+                                                              "precision highp sampler2D;\n"
+                                                              "/** Each invocation writes one texel, reading the 4x4 source texels around it. */\n"
+                                                              "layout(local_size_x = 8, local_size_y = 8) in;\n"
+                                                              "/** Source texels read by a work group: 2 * 8 + 2 in each direction. */\n"
+                                                              "#define TILE_SIZE 18\n"
+                                                              "/* UNIFORMS */\n"
+                                                              "/** Texture to be downsampled, twice the size of the destination. */\n"
+                                                              "uniform sampler2D source_texture;\n"
+                                                              "/** Downsampled image. */\n"
+                                                              "layout(rgba8, binding = 0) writeonly uniform highp image2D destination_image;\n"
+                                                              "/** Source texels shared by the work group, fetched once each. */\n"
+                                                              "shared vec4 tile[TILE_SIZE * TILE_SIZE];\n"
+                                                              "void main()\n"
+                                                              "{\n"
+                                                              "    ivec2 source_size = textureSize(source_texture, 0);\n"
+                                                              "    ivec2 tile_origin = ivec2(gl_WorkGroupID.xy) * 16 - 1;\n"
+                                                              "    for (int index = int(gl_LocalInvocationIndex); index < TILE_SIZE * TILE_SIZE; index += 64)\n"
+                                                              "    {\n"
+                                                              "        ivec2 texel = clamp(tile_origin + ivec2(index % TILE_SIZE, index / TILE_SIZE), ivec2(0), source_size - 1);\n"
+                                                              "        tile[index] = texelFetch(source_texture, texel, 0);\n"
+                                                              "    }\n"
+                                                              "    memoryBarrierShared();\n"
+                                                              "    barrier();\n"
+                                                              "    /* Same filter as the downsampling fragment shader, with its five bilinear fetches expanded to\n"
+                                                              "     * source texels: the central 2x2 texels weigh 5/32 and the 12 texels around them 1/32. */\n"
+                                                              "    ivec2 base = ivec2(gl_LocalInvocationID.xy) * 2;\n"
+                                                              "    vec4  sum  = vec4(0.0);\n"
+                                                              "    for (int y = 0; y < 4; ++y)\n"
+                                                              "    {\n"
+                                                              "        for (int x = 0; x < 4; ++x)\n"
+                                                              "        {\n"
+                                                              "            bool central = (x == 1 || x == 2) && (y == 1 || y == 2);\n"
+                                                              "            sum += tile[(base.y + y) * TILE_SIZE + base.x + x] * (central ? 5.0 : 1.0);\n"
+                                                              "        }\n"
+                                                              "    }\n"
+                                                              "    ivec2 destination = ivec2(gl_GlobalInvocationID.xy);\n"
+                                                              "    if (all(lessThan(destination, imageSize(destination_image))))\n"
+                                                              "    {\n"
+                                                              "        imageStore(destination_image, destination, vec4((sum / 32.0).xyz, 1.0));\n"
+                                                              "    }\n"
+                                                              "}\n";
+/* [Dual filter downsampling compute shader source] */
+/* [Dual filter upsampling compute shader source] */
+static const char dualFilterUpsampleComputeShaderSource[] = "#version 310 es\n"
+                                                            "precision highp float;\n"
+                                                            "precision highp sampler2D;\n"
+                                                            "/** Each invocation writes one texel. A work group reads 8x8 source texels. */\n"
+                                                            "layout(local_size_x = 8, local_size_y = 8) in;\n"
+                                                            "/** Source texels read by a work group: 8 / 2 + 4 in each direction. */\n"
+                                                            "#define TILE_SIZE 8\n"
+                                                            "/* UNIFORMS */\n"
+                                                            "/** Weight of the upsampled blur against the detail texture: the higher, the wider the bloom. */\n"
+                                                            "uniform float     diffusion;\n"
+                                                            "/** Texture to be upsampled, half the size of the destination. */\n"
+                                                            "uniform sampler2D source_texture;\n"
+                                                            "/** Downsampled image of the same size as the destination. */\n"
+                                                            "uniform sampler2D detail_texture;\n"
+                                                            "/** Upsampled image. */\n"
+                                                            "layout(rgba8, binding = 0) writeonly uniform highp image2D destination_image;\n"
+                                                            "/** Source texels shared by the work group, fetched once each. */\n"
+                                                            "shared vec4 tile[TILE_SIZE * TILE_SIZE];\n"
+                                                            "/** Bilinear filtering of the tile. The position is in source texels, texel i being centred at i + 0.5. */\n"
+                                                            "vec4 sampleTile(vec2 position, ivec2 tile_origin)\n"
+                                                            "{\n"
+                                                            "    vec2  texel_position = position - 0.5;\n"
+                                                            "    ivec2 index          = ivec2(floor(texel_position)) - tile_origin;\n"
+                                                            "    vec2  weight         = fract(texel_position);\n"
+                                                            "    vec4  bottom         = mix(tile[ index.y       * TILE_SIZE + index.x], tile[ index.y       * TILE_SIZE + index.x + 1], weight.x);\n"
+                                                            "    vec4  top            = mix(tile[(index.y + 1) * TILE_SIZE + index.x], tile[(index.y + 1) * TILE_SIZE + index.x + 1], weight.x);\n"
+                                                            "    return mix(bottom, top, weight.y);\n"
+                                                            "}\n"
+                                                            "void main()\n"
+                                                            "{\n"
+                                                            "    ivec2 source_size = textureSize(source_texture, 0);\n"
+                                                            "    ivec2 tile_origin = ivec2(gl_WorkGroupID.xy) * 4 - 2;\n"
+                                                            "    ivec2 texel       = clamp(tile_origin + ivec2(gl_LocalInvocationID.xy), ivec2(0), source_size - 1);\n"
+                                                            "    tile[gl_LocalInvocationIndex] = texelFetch(source_texture, texel, 0);\n"
+                                                            "    memoryBarrierShared();\n"
+                                                            "    barrier();\n"
+                                                            "    /* Same filter as the upsampling fragment shader. */\n"
+                                                            "    ivec2 destination = ivec2(gl_GlobalInvocationID.xy);\n"
+                                                            "    vec2  centre      = (vec2(destination) + 0.5) * 0.5;\n"
+                                                            "    vec4  sum         = sampleTile(centre + vec2(-1.0, 0.0), tile_origin) +\n"
+                                                            "                        sampleTile(centre + vec2( 1.0, 0.0), tile_origin) +\n"
+                                                            "                        sampleTile(centre + vec2(0.0, -1.0), tile_origin) +\n"
+                                                            "                        sampleTile(centre + vec2(0.0,  1.0), tile_origin);\n"
+                                                            "    sum += (sampleTile(centre + vec2( 0.5,  0.5), tile_origin) +\n"
+                                                            "            sampleTile(centre + vec2(-0.5,  0.5), tile_origin) +\n"
+                                                            "            sampleTile(centre + vec2( 0.5, -0.5), tile_origin) +\n"
+                                                            "            sampleTile(centre + vec2(-0.5, -0.5), tile_origin)) * 2.0;\n"
+                                                            "    if (all(lessThan(destination, imageSize(destination_image))))\n"
+                                                            "    {\n"
+                                                            "        vec4 detail = texelFetch(detail_texture, destination, 0);\n"
+                                                            "        imageStore(destination_image, destination, vec4(mix(detail.xyz, sum.xyz / 12.0, diffusion), 1.0));\n"
+                                                            "    }\n"
+                                                            "}\n";
+/* [Dual filter upsampling compute shader source] */
 
 /* Variables used for scene view configurations. */
 Matrix      cameraLookAtMatrix;
@@ -577,6 +820,18 @@ int         windowWidth                 = 0;
 /* Number of blur loop iterations. */
 int lastNumberOfIterations = 0;
 
+/** \brief Ways of blurring the luminance image. */
+enum BloomMode
+{
+    BLOOM_SEPARABLE_BLUR,     /* The tutorial: horizontal and vertical Gaussian passes, repeated more times for a stronger effect. */
+    BLOOM_DUAL_FILTER,        /* Mip chain downsampled and upsampled by fragment shaders. The cost does not depend on the strength. */
+    BLOOM_DUAL_FILTER_COMPUTE /* Same mip chain built by compute shaders working on shared memory tiles. Requires OpenGL ES 3.1. */
+};
+/* Way of blurring the luminance image. */
+const BloomMode bloomMode         = BLOOM_SEPARABLE_BLUR;
+/* If true, all the ways of blurring are timed for every strength on startup, and the results are logged. */
+const bool      runBloomBenchmark = false;
+
 /* Variables used for rendering a geometry. */
 GLfloat* cubeCoordinates    = NULL;
 GLfloat* cubeLocations      = NULL;
@@ -596,6 +851,15 @@ ProgramAndShadersIds           getLuminanceImageProgramShaderObjects;
 SceneRenderingProgramLocations sceneRenderingProgramLocations;
 ProgramAndShadersIds           sceneRenderingProgramShaderObjects;
 
+/* Variables used for the dual filter configurations. */
+ComputeProgramAndShaderIds         dualFilterDownsampleComputeProgramShaderObjects;
+ProgramAndShadersIds               dualFilterDownsampleProgramShaderObjects;
+DualFilterUpsampleProgramLocations dualFilterUpsampleComputeProgramLocations;
+ComputeProgramAndShaderIds         dualFilterUpsampleComputeProgramShaderObjects;
+DualFilterUpsampleProgramLocations dualFilterUpsampleProgramLocations;
+ProgramAndShadersIds               dualFilterUpsampleProgramShaderObjects;
+DualFilterObjects                  dualFilterObjects;
+
 /* Variables used to store generated objects IDs. */
 BlurringObjects               blurringObjects;
 GetLuminanceImageBloomObjects getLuminanceImageBloomObjects;
@@ -623,6 +887,44 @@ static void deleteBlurringObjects(BlurringObjects* objectIdsStoragePtr)
     objectIdsStoragePtr->framebufferObjectId       = 0;
 }
 
+/**  \brief Delete a compute program object and its shader object.
+ *          According to the OpenGL ES specification, program object will not be deleted if it is active.
+ *          It is the user's responsibility to call glUseProgram(0) at some point.
+ *
+ * \param objectsToBeDeletedPtr Objects described by the structure will be deleted by the function.
+ *                              Cannot be NULL.
+ */
+static void deleteComputeProgramShaderObjects(ComputeProgramAndShaderIds* objectsToBeDeletedPtr)
+{
+    ASSERT(objectsToBeDeletedPtr != NULL);
+
+    GL_CHECK(glDeleteShader (objectsToBeDeletedPtr->computeShaderObjectId) );
+    GL_CHECK(glDeleteProgram(objectsToBeDeletedPtr->programObjectId) );
+
+    objectsToBeDeletedPtr->computeShaderObjectId = 0;
+    objectsToBeDeletedPtr->programObjectId       = 0;
+}
+
+/** \brief Delete objects which were generated for the dual filter mip chain.
+ *         The luminance texture used as level 0 is not deleted.
+ *         According to the OpenGL ES specification, objects will not be deleted if bound.
+ *         It is the user's responsibility to call glBindFramebuffer() and glBindTexture()
+ *         with default object ids (id = 0) at some point.
+ *
+ * \param objectIdsStoragePtr Objects described by the structure will be deleted by the function.
+ *                            Cannot be NULL.
+ */
+static void deleteDualFilterObjects(DualFilterObjects* objectIdsStoragePtr)
+{
+    ASSERT(objectIdsStoragePtr != NULL);
+
+    GL_CHECK(glDeleteFramebuffers(1,                            &objectIdsStoragePtr->framebufferObjectId) );
+    GL_CHECK(glDeleteTextures    (DUAL_FILTER_NUMBER_OF_LEVELS, objectIdsStoragePtr->downsampleTextureObjectIds + 1) );
+    GL_CHECK(glDeleteTextures    (DUAL_FILTER_NUMBER_OF_LEVELS, objectIdsStoragePtr->upsampleTextureObjectIds) );
+
+    *objectIdsStoragePtr = DualFilterObjects();
+}
+
 /** \brief Delete objects which were generated for getting downscaled luminance image.
  *         According to the OpenGL ES specification, objects will not be deleted if bound.
  *         It is the user's responsibility to call glBindFramebuffer() and glBindTexture()
@@ -950,6 +1252,69 @@ static void generateDownscaledObjects(GLuint* fboIdPtr,
 }
 /* [Generate downscaled objects] */
 
+/** \brief Generate texture and framebuffer objects for the dual filter mip chain and configure texture parameters accordingly.
+ *         Level 0 is the texture holding the downscaled luminance image, which must already exist.
+ *         Finally, reset GL_TEXTURE_2D binding to 0 for active texture unit.
+ *
+ *  \param objectIdsStoragePtr Deref will be used to store generated object IDs and level sizes.
+ *                             Cannot be NULL.
+ *  \param luminanceToId       ID of the texture object holding the downscaled luminance image.
+ */
+static void generateDualFilterObjects(DualFilterObjects* objectIdsStoragePtr,
+                                      GLuint             luminanceToId)
+{
+    ASSERT(objectIdsStoragePtr != NULL);
+
+    GL_CHECK(glGenFramebuffers(1,
+                              &objectIdsStoragePtr->framebufferObjectId) );
+    GL_CHECK(glGenTextures    (DUAL_FILTER_NUMBER_OF_LEVELS,
+                               objectIdsStoragePtr->downsampleTextureObjectIds + 1) );
+    GL_CHECK(glGenTextures    (DUAL_FILTER_NUMBER_OF_LEVELS,
+                               objectIdsStoragePtr->upsampleTextureObjectIds) );
+
+    objectIdsStoragePtr->downsampleTextureObjectIds[0] = luminanceToId;
+    objectIdsStoragePtr->levelWidths               [0] = windowWidth  / WINDOW_RESOLUTION_DIVISOR;
+    objectIdsStoragePtr->levelHeights              [0] = windowHeight / WINDOW_RESOLUTION_DIVISOR;
+
+    for (int level = 1; level <= DUAL_FILTER_NUMBER_OF_LEVELS; level++)
+    {
+        objectIdsStoragePtr->levelWidths [level] = objectIdsStoragePtr->levelWidths [level - 1] > 1 ? objectIdsStoragePtr->levelWidths [level - 1] / 2 : 1;
+        objectIdsStoragePtr->levelHeights[level] = objectIdsStoragePtr->levelHeights[level - 1] > 1 ? objectIdsStoragePtr->levelHeights[level - 1] / 2 : 1;
+    }
+
+    /* Immutable storage, so that the textures can also be bound as images by the compute shaders. */
+    for (int textureIndex = 0; textureIndex < 2 * DUAL_FILTER_NUMBER_OF_LEVELS; textureIndex++)
+    {
+        const bool isDownsampleTexture = textureIndex < DUAL_FILTER_NUMBER_OF_LEVELS;
+        const int  level               = isDownsampleTexture ? textureIndex + 1 : textureIndex - DUAL_FILTER_NUMBER_OF_LEVELS;
+
+        GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                                 isDownsampleTexture ? objectIdsStoragePtr->downsampleTextureObjectIds[level]
+                                                     : objectIdsStoragePtr->upsampleTextureObjectIds  [level]) );
+        GL_CHECK(glTexStorage2D (GL_TEXTURE_2D,
+                                 1,
+                                 GL_RGBA8,
+                                 objectIdsStoragePtr->levelWidths [level],
+                                 objectIdsStoragePtr->levelHeights[level]) );
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                                 GL_TEXTURE_WRAP_S,
+                                 GL_CLAMP_TO_EDGE) );
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                                 GL_TEXTURE_WRAP_T,
+                                 GL_CLAMP_TO_EDGE) );
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                                 GL_TEXTURE_MAG_FILTER,
+                                 GL_LINEAR) );
+        GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                                 GL_TEXTURE_MIN_FILTER,
+                                 GL_LINEAR) );
+    }
+
+    /* At the end, restore default environment settings (bind default TO). */
+    GL_CHECK(glBindTexture(GL_TEXTURE_2D,
+                           0) );
+}
+
 /* [Calculate cube locations] */
 /** \brief Calculate the world space locations of all the cubes that we will be rendering.
  *         The cubes are arranged in a 2D array consisting of \p numberOfColumns columns
@@ -1051,6 +1416,28 @@ static void getLocationsForBlurringProgram(GLuint                    programObje
     ASSERT(locationsStoragePtr->uniformTextureSampler   != -1);
 }
 
+/** \brief Retrieve the locations of uniforms for a program object responsible for dual filter upsampling.
+ *         Can be called only if \p programObjectId is currently active.
+ *
+ * \param programObjectId     A valid program object ID. Indicates the program object for which locations are queried.
+ * \param locationsStoragePtr Deref will be used to store retrieved info.
+ *                            Cannot be NULL.
+ */
+static void getLocationsForDualFilterUpsampleProgram(GLuint                              programObjectId,
+                                                     DualFilterUpsampleProgramLocations* locationsStoragePtr)
+{
+    ASSERT(locationsStoragePtr != NULL);
+    ASSERT(programObjectId     != 0);
+
+    locationsStoragePtr->uniformDetailTexture = GL_CHECK(glGetUniformLocation(programObjectId, "detail_texture") );
+    locationsStoragePtr->uniformDiffusion     = GL_CHECK(glGetUniformLocation(programObjectId, "diffusion") );
+    locationsStoragePtr->uniformSourceTexture = GL_CHECK(glGetUniformLocation(programObjectId, "source_texture") );
+
+    ASSERT(locationsStoragePtr->uniformDetailTexture != -1);
+    ASSERT(locationsStoragePtr->uniformDiffusion     != -1);
+    ASSERT(locationsStoragePtr->uniformSourceTexture != -1);
+}
+
 /** \brief Retrieve the locations of attributes and uniforms for the program object responsible for scene rendering.
  *         Can be called only if \p programObjectId is currently active.
  *
@@ -1113,6 +1500,48 @@ static void getLocationsForSceneRenderingProgram(GLuint
     ASSERT(locationsStoragePtr->uniformMvpMatrix                            != -1);
 }
 
+/** \brief Get the time from a monotonic clock, used by the bloom benchmark.
+ *
+ * \return Time in seconds from an unspecified starting point.
+ */
+static double getTimeInSeconds()
+{
+    timespec currentTime;
+
+    clock_gettime(CLOCK_MONOTONIC, &currentTime);
+
+    return currentTime.tv_sec + currentTime.tv_nsec * 1e-9;
+}
+
+/** \brief Create and compile a compute shader object, create a program object and link it.
+ *
+ * \param objectIdsPtr        Deref will be used to store generated IDs.
+ *                            Cannot be NULL.
+ * \param computeShaderSource Compute shader source code.
+ *                            Cannot be NULL.
+ */
+static void initializeComputeProgramObject(ComputeProgramAndShaderIds* objectIdsPtr,
+                                           const char*                 computeShaderSource)
+{
+    ASSERT(objectIdsPtr != NULL);
+
+    GLint linkStatus = 0;
+
+    objectIdsPtr->programObjectId = GL_CHECK(glCreateProgram() );
+
+    Shader::processShader(&objectIdsPtr->computeShaderObjectId,
+                           computeShaderSource,
+                           GL_COMPUTE_SHADER);
+
+    GL_CHECK(glAttachShader(objectIdsPtr->programObjectId, objectIdsPtr->computeShaderObjectId) );
+
+    GL_CHECK(glLinkProgram(objectIdsPtr->programObjectId) );
+
+    GL_CHECK(glGetProgramiv(objectIdsPtr->programObjectId, GL_LINK_STATUS, &linkStatus) );
+
+    ASSERT(linkStatus == GL_TRUE);
+}
+
 /** \brief Create and compile shader objects.
  *         If successful, they are attached to the program object, which is then linked.
  *
@@ -1150,6 +1579,52 @@ static void initializeProgramObject(ProgramAndShadersIds* objectIdsPtr,
     ASSERT(linkStatus == GL_TRUE);
 }
 
+/** \brief Run one pass of the dual filter, writing a whole level of the mip chain.
+ *         The program object and the input textures must already be set up.
+ *
+ * \param destinationTextureObjectId Texture object the pass writes to.
+ * \param level                      Level of the mip chain \p destinationTextureObjectId belongs to.
+ * \param useComputeShaders          True if a compute program is active, false if a program drawing a quad into
+ *                                   dualFilterObjects' framebuffer object is active.
+ */
+static void renderDualFilterPass(GLuint destinationTextureObjectId,
+                                 int    level,
+                                 bool   useComputeShaders)
+{
+    const GLsizei width  = dualFilterObjects.levelWidths [level];
+    const GLsizei height = dualFilterObjects.levelHeights[level];
+
+    if (useComputeShaders)
+    {
+        GL_CHECK(glBindImageTexture(0,
+                                    destinationTextureObjectId,
+                                    0,
+                                    GL_FALSE,
+                                    0,
+                                    GL_WRITE_ONLY,
+                                    GL_RGBA8) );
+        GL_CHECK(glDispatchCompute ((width  + DUAL_FILTER_WORK_GROUP_SIZE - 1) / DUAL_FILTER_WORK_GROUP_SIZE,
+                                    (height + DUAL_FILTER_WORK_GROUP_SIZE - 1) / DUAL_FILTER_WORK_GROUP_SIZE,
+                                    1) );
+        /* The next pass, or the blending pass, samples the image just written. */
+        GL_CHECK(glMemoryBarrier   (GL_TEXTURE_FETCH_BARRIER_BIT) );
+    }
+    else
+    {
+        GL_CHECK(glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
+                                        GL_COLOR_ATTACHMENT0,
+                                        GL_TEXTURE_2D,
+                                        destinationTextureObjectId,
+                                        0) );
+        GL_CHECK(glViewport            (0,
+                                        0,
+                                        width,
+                                        height) );
+        /* Draw texture. */
+        GL_CHECK(glDrawArrays          (GL_TRIANGLE_FAN, 0, 4) );
+    }
+}
+
 /* \brief Render the luminance image (which then can be bloomed) and store the result in corresponding texture object.
  */
 static void renderDowscaledLuminanceTexture()
@@ -1264,6 +1739,317 @@ static void setUniformValuesForSceneRenderingProgram(const SceneRenderingProgram
     GL_CHECK(glUniform1f(locationsPtr->uniformLightPropertiesStrength,              lightStrength) );
 }
 
+/** \brief Apply the separable blur effect to the downscaled luminance image.
+ *         The result of the last iteration is stored in strongerBlurObjects' texture,
+ *         the result of the previous one in blurringObjects' vertical texture.
+ *
+ * \param numberOfIterations Number of horizontal and vertical blur pass pairs. Must be at least 2.
+ */
+static void applySeparableBlur(int numberOfIterations)
+{
+    /* [Blur loop] */
+    /* Apply the blur effect.
+    * The blur effect is applied in two basic steps (note that lower resolution textures are used).
+    *   a. First, we blur the downscaled bloom texture horizontally.
+    *   b. The result of horizontal blurring is then used for vertical blurring.
+    *      The result texture contains image blrured in both directions.
+    *   c. To amplify the blur effect, steps (a) and (b) are applied multiple times
+    *      (with an exception that we now use the resulting blurred texture from the previous pass
+    *       as an input to the horizontal blurring pass).
+    *   d. The result of last iteration of applying the total blur effect (which is the result after the vertical blur is applied)
+    *      is stored in a separate texture. Thanks to that, we have the last and previous blur result textures,
+    *      both of which will be then used for continuous sampling (for the blending pass).
+    *
+    */
+    /* Bind a framebuffer object to the GL_DRAW_FRAMEBUFFER framebuffer binding point,
+    * so that everything we render will end up in the FBO's attachments. */
+    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                               blurringObjects.framebufferObjectId) );
+    /* Set the lower viewport resolution. It corresponds to size of the texture we will be rendering to. */
+    GL_CHECK(glViewport(0,
+                        0,
+                        windowWidth  / WINDOW_RESOLUTION_DIVISOR,
+                        windowHeight / WINDOW_RESOLUTION_DIVISOR) );
+    GL_CHECK(glEnable  (GL_SCISSOR_TEST) );
+
+    /* Apply the blur effect multiple times. */
+    for (int blurIterationIndex = 0;
+             blurIterationIndex < numberOfIterations;
+             blurIterationIndex++)
+    {
+        /* FIRST PASS - HORIZONTAL BLUR
+         * Take the texture showing cubes which should be bloomed and apply a horizontal blur operation.
+         */
+        GL_CHECK(glUseProgram(blurringHorizontalProgramShaderObjects.programObjectId) );
+        {
+            /* Attach the texture we want the color data to be rendered to the current draw framebuffer.*/
+            GL_CHECK(glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
+                                            GL_COLOR_ATTACHMENT0,
+                                            GL_TEXTURE_2D,
+                                            blurringObjects.textureObjectIdHorizontal,
+                                            0) );
+
+            /* In first iteration we have to take the texture which shows the cubes we want blurred.
+            * Later, we have to take the same texture that has already been blurred vertically. */
+            if (blurIterationIndex == 0)
+            {
+                GL_CHECK(glUniform1i(blurringHorizontalProgramLocations.uniformTextureSampler,
+                                    TEXTURE_UNIT_BLOOM_SOURCE_TEXTURE) );
+            }
+            else
+            {
+                GL_CHECK(glUniform1i(blurringHorizontalProgramLocations.uniformTextureSampler,
+                                    TEXTURE_UNIT_BLURRED_TEXTURE) );
+            }
+
+            /* Draw texture. */
+            GL_CHECK(glDrawArrays(GL_TRIANGLE_FAN, 0, 4) );
+        } /* FIRST PASS - HORIZONTAL BLUR */
+
+        /* SECOND PASS - VERTICAL BLUR
+        * Take the result of the previous pass (horizontal blur) and apply a vertical blur to this texture.
+        */
+        GL_CHECK(glUseProgram(blurringVerticalProgramShaderObjects.programObjectId) );
+        {
+            if (blurIterationIndex == numberOfIterations - 1)
+            {
+                /* In case of the last iteration, use a different framebuffer object.
+                 * The rendering results will be written to the only color attachment of the fbo. */
+                GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                                           strongerBlurObjects.framebufferObjectId) );
+            }
+            else
+            {
+                /* Bind a texture object we want the result data to be stored in.*/
+                GL_CHECK(glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
+                                                GL_COLOR_ATTACHMENT0,
+                                                GL_TEXTURE_2D,
+                                                blurringObjects.textureObjectIdVertical,
+                                                0) );
+            }
+
+            /* Set uniform values. */
+            GL_CHECK(glUniform1i(blurringVerticalProgramLocations.uniformTextureSampler,
+                                 TEXTURE_UNIT_HORIZONTAL_BLUR_TEXTURE) ); /* Indicates which texture object content should be blurred. */
+
+            /* Draw texture. */
+            GL_CHECK(glDrawArrays(GL_TRIANGLE_FAN, 0, 4) );
+        } /* SECOND PASS - VERTICAL BLUR */
+    } /* for (int blur_iteration_index = 0; i < numberOfIterations; blur_iteration_index++) */
+
+    GL_CHECK(glDisable(GL_SCISSOR_TEST));
+    /* [Blur loop] */
+}
+
+/** \brief Map a bloom strength, expressed as the number of separable blur passes it corresponds to,
+ *         to the diffusion used by the dual filter upsampling passes.
+ *
+ * \param numberOfBlurPasses Strength of the effect, from MIN_NUMBER_OF_BLUR_PASSES to MAX_NUMBER_OF_BLUR_PASSES + 1.
+ *                           Fractional values are allowed.
+ *
+ * \return Diffusion, from DUAL_FILTER_MIN_DIFFUSION to 1.0.
+ */
+static float getDualFilterDiffusion(float numberOfBlurPasses)
+{
+    const float strength = (numberOfBlurPasses - MIN_NUMBER_OF_BLUR_PASSES) / (MAX_NUMBER_OF_BLUR_PASSES - MIN_NUMBER_OF_BLUR_PASSES + 1);
+
+    return DUAL_FILTER_MIN_DIFFUSION + (1.0f - DUAL_FILTER_MIN_DIFFUSION) * strength;
+}
+
+/** \brief Downsample the luminance image into all levels of the dual filter mip chain.
+ *
+ * \param useComputeShaders True to use the compute programs, false to use the fragment programs.
+ */
+static void applyDualFilterDownsampling(bool useComputeShaders)
+{
+    /* [Dual filter downsampling] */
+    if (useComputeShaders)
+    {
+        GL_CHECK(glUseProgram(dualFilterDownsampleComputeProgramShaderObjects.programObjectId) );
+    }
+    else
+    {
+        GL_CHECK(glUseProgram     (dualFilterDownsampleProgramShaderObjects.programObjectId) );
+        GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                                   dualFilterObjects.framebufferObjectId) );
+    }
+
+    GL_CHECK(glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_DUAL_FILTER_SOURCE) );
+
+    /* Each level is computed from the previous one at a quarter of its cost, so the whole chain
+     * costs about a third of a pass at the resolution of the luminance image. */
+    for (int level = 1; level <= DUAL_FILTER_NUMBER_OF_LEVELS; level++)
+    {
+        GL_CHECK(glBindTexture(GL_TEXTURE_2D,
+                               dualFilterObjects.downsampleTextureObjectIds[level - 1]) );
+
+        renderDualFilterPass(dualFilterObjects.downsampleTextureObjectIds[level], level, useComputeShaders);
+    }
+    /* [Dual filter downsampling] */
+}
+
+/** \brief Upsample the dual filter mip chain back to the resolution of the luminance image.
+ *         The result is stored in dualFilterObjects.upsampleTextureObjectIds[0].
+ *
+ * \param diffusion         Weight of the upsampled coarser levels against the detail of each level.
+ *                          The higher it is, the wider the bloom.
+ * \param useComputeShaders True to use the compute programs, false to use the fragment programs.
+ */
+static void applyDualFilterUpsampling(float diffusion,
+                                      bool  useComputeShaders)
+{
+    /* [Dual filter upsampling] */
+    const DualFilterUpsampleProgramLocations* locationsPtr = useComputeShaders ? &dualFilterUpsampleComputeProgramLocations
+                                                                               : &dualFilterUpsampleProgramLocations;
+
+    if (useComputeShaders)
+    {
+        GL_CHECK(glUseProgram(dualFilterUpsampleComputeProgramShaderObjects.programObjectId) );
+    }
+    else
+    {
+        GL_CHECK(glUseProgram     (dualFilterUpsampleProgramShaderObjects.programObjectId) );
+        GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
+                                   dualFilterObjects.framebufferObjectId) );
+    }
+
+    /* The strength of the effect is a mix weight, so it does not change the number of passes. */
+    GL_CHECK(glUniform1f(locationsPtr->uniformDiffusion, diffusion) );
+
+    for (int level = DUAL_FILTER_NUMBER_OF_LEVELS - 1; level >= 0; level--)
+    {
+        /* The coarsest level has nothing to add to it, so it is upsampled as it was downsampled. */
+        const GLuint sourceTextureObjectId = (level == DUAL_FILTER_NUMBER_OF_LEVELS - 1) ? dualFilterObjects.downsampleTextureObjectIds[level + 1]
+                                                                                         : dualFilterObjects.upsampleTextureObjectIds  [level + 1];
+
+        GL_CHECK(glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_DUAL_FILTER_SOURCE) );
+        GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                                 sourceTextureObjectId) );
+        GL_CHECK(glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_DUAL_FILTER_DETAIL) );
+        GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                                 dualFilterObjects.downsampleTextureObjectIds[level]) );
+
+        renderDualFilterPass(dualFilterObjects.upsampleTextureObjectIds[level], level, useComputeShaders);
+    }
+    /* [Dual filter upsampling] */
+}
+
+/** \brief Time the separable blur and both dual filter implementations for every strength of the effect,
+ *         and log the average time.
+ *
+ * The GPU is synchronised with glFinish() around every measurement. The dual filter times include
+ * the downsampling passes, although the application only needs them once, as the scene is static.
+ */
+static void benchmarkBloom()
+{
+    const int numberOfWarmUpFrames = 2;
+    const int numberOfTimedFrames  = 10;
+
+    LOGI("Bloom benchmark: average blur time in ms for a %dx%d luminance image\n",
+         windowWidth  / WINDOW_RESOLUTION_DIVISOR,
+         windowHeight / WINDOW_RESOLUTION_DIVISOR);
+    LOGI("%12s %14s %14s %14s\n", "blur passes", "separable", "dual filter", "dual compute");
+
+    for (int numberOfIterations = MIN_NUMBER_OF_BLUR_PASSES; numberOfIterations <= MAX_NUMBER_OF_BLUR_PASSES; numberOfIterations++)
+    {
+        const float diffusion  = getDualFilterDiffusion((float) numberOfIterations);
+        float       results[3] = {0.0f, 0.0f, 0.0f};
+
+        for (int method = 0; method < 3; method++)
+        {
+            double start = 0.0;
+
+            for (int frame = 0; frame < numberOfWarmUpFrames + numberOfTimedFrames; frame++)
+            {
+                if (frame == numberOfWarmUpFrames)
+                {
+                    GL_CHECK(glFinish() );
+                    start = getTimeInSeconds();
+                }
+
+                if (method == 0)
+                {
+                    applySeparableBlur(numberOfIterations);
+                }
+                else
+                {
+                    applyDualFilterDownsampling(method == 2);
+                    applyDualFilterUpsampling  (diffusion, method == 2);
+                }
+            }
+            GL_CHECK(glFinish() );
+
+            results[method] = (float) (1000.0 * (getTimeInSeconds() - start) / numberOfTimedFrames);
+        }
+
+        LOGI("%12d %14.2f %14.2f %14.2f\n", numberOfIterations, results[0], results[1], results[2]);
+    }
+}
+
+/** \brief Set the sampler uniforms of a pair of dual filter program objects, which are constant during rendering process.
+ *
+ * \param downsampleProgramObjectId A valid downsampling program object ID.
+ * \param upsampleProgramObjectId   A valid upsampling program object ID.
+ * \param upsampleLocationsPtr      Deref will be used to store the locations of the upsampling program's uniforms.
+ *                                  Cannot be NULL.
+ */
+static void setUniformValuesForDualFilterPrograms(GLuint                              downsampleProgramObjectId,
+                                                  GLuint                              upsampleProgramObjectId,
+                                                  DualFilterUpsampleProgramLocations* upsampleLocationsPtr)
+{
+    GL_CHECK(glUseProgram(downsampleProgramObjectId) );
+    {
+        GLint uniformSourceTexture = GL_CHECK(glGetUniformLocation(downsampleProgramObjectId, "source_texture") );
+
+        ASSERT(uniformSourceTexture != -1);
+
+        GL_CHECK(glUniform1i(uniformSourceTexture, TEXTURE_UNIT_DUAL_FILTER_SOURCE) );
+    }
+
+    GL_CHECK(glUseProgram(upsampleProgramObjectId) );
+    {
+        getLocationsForDualFilterUpsampleProgram(upsampleProgramObjectId,
+                                                 upsampleLocationsPtr);
+
+        GL_CHECK(glUniform1i(upsampleLocationsPtr->uniformSourceTexture, TEXTURE_UNIT_DUAL_FILTER_SOURCE) );
+        GL_CHECK(glUniform1i(upsampleLocationsPtr->uniformDetailTexture, TEXTURE_UNIT_DUAL_FILTER_DETAIL) );
+    }
+}
+
+/** \brief Create the objects and program objects used by the dual filter.
+ *         The luminance texture must already exist.
+ *
+ * \param createComputePrograms True to also create the compute program objects, which requires OpenGL ES 3.1.
+ */
+static void setupDualFilter(bool createComputePrograms)
+{
+    generateDualFilterObjects(&dualFilterObjects,
+                               getLuminanceImageBloomObjects.textureObjectId);
+
+    initializeProgramObject(&dualFilterDownsampleProgramShaderObjects,
+                             dualFilterDownsampleFragmentShaderSource,
+                             renderTextureVertexShaderSource);
+    initializeProgramObject(&dualFilterUpsampleProgramShaderObjects,
+                             dualFilterUpsampleFragmentShaderSource,
+                             renderTextureVertexShaderSource);
+
+    setUniformValuesForDualFilterPrograms(dualFilterDownsampleProgramShaderObjects.programObjectId,
+                                          dualFilterUpsampleProgramShaderObjects.programObjectId,
+                                         &dualFilterUpsampleProgramLocations);
+
+    if (createComputePrograms)
+    {
+        initializeComputeProgramObject(&dualFilterDownsampleComputeProgramShaderObjects,
+                                        dualFilterDownsampleComputeShaderSource);
+        initializeComputeProgramObject(&dualFilterUpsampleComputeProgramShaderObjects,
+                                        dualFilterUpsampleComputeShaderSource);
+
+        setUniformValuesForDualFilterPrograms(dualFilterDownsampleComputeProgramShaderObjects.programObjectId,
+                                              dualFilterUpsampleComputeProgramShaderObjects.programObjectId,
+                                             &dualFilterUpsampleComputeProgramLocations);
+    }
+}
+
 /** \brief Setup the environment: create and prepare objects for rendering purposes.
  *
  *  \param width  Window resolution: width.
@@ -1520,6 +2306,31 @@ void setupGraphics(int width, int height)
      * and blurring functions in the next steps. */
     renderSceneColourTexture();
     renderDowscaledLuminanceTexture();
+
+    if (bloomMode != BLOOM_SEPARABLE_BLUR || runBloomBenchmark)
+    {
+        setupDualFilter(bloomMode == BLOOM_DUAL_FILTER_COMPUTE || runBloomBenchmark);
+
+        if (runBloomBenchmark)
+        {
+            benchmarkBloom();
+        }
+
+        if (bloomMode != BLOOM_SEPARABLE_BLUR)
+        {
+            /* The luminance image does not change either, so the downsampled levels are only computed once. */
+            applyDualFilterDownsampling(bloomMode == BLOOM_DUAL_FILTER_COMPUTE);
+
+            /* Both blur textures of the blending program show the dual filter result.
+             * The strength is applied by the upsampling passes, so the mix factor has no effect. */
+            GL_CHECK(glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_BLURRED_TEXTURE) );
+            GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                                     dualFilterObjects.upsampleTextureObjectIds[0]) );
+            GL_CHECK(glActiveTexture(GL_TEXTURE0 + TEXTURE_UNIT_STRONGER_BLUR_TEXTURE) );
+            GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                                     dualFilterObjects.upsampleTextureObjectIds[0]) );
+        }
+    }
 }
 
 /** \brief Render one frame.
@@ -1582,101 +2393,18 @@ void renderFrame (float time)
     lastNumberOfIterations = currentNumberOfIterations;
     /* [Mix factor calculations] */
 
+    if (bloomMode != BLOOM_SEPARABLE_BLUR)
+    {
+        /* [Dual filter strength] */
+        /* The dual filter always runs the same passes: the strength only changes how much of the coarser levels is mixed in. */
+        applyDualFilterUpsampling(getDualFilterDiffusion(currentNumberOfIterations + mixFactor),
+                                  bloomMode == BLOOM_DUAL_FILTER_COMPUTE);
+        /* [Dual filter strength] */
+    }
     /* Update the scene only if needed. */
-    if (shouldSceneBeUpdated)
+    else if (shouldSceneBeUpdated)
     {
-        /* [Blur loop] */
-        /* Apply the blur effect.
-        * The blur effect is applied in two basic steps (note that lower resolution textures are used).
-        *   a. First, we blur the downscaled bloom texture horizontally.
-        *   b. The result of horizontal blurring is then used for vertical blurring.
-        *      The result texture contains image blrured in both directions.
-        *   c. To amplify the blur effect, steps (a) and (b) are applied multiple times
-        *      (with an exception that we now use the resulting blurred texture from the previous pass
-        *       as an input to the horizontal blurring pass).
-        *   d. The result of last iteration of applying the total blur effect (which is the result after the vertical blur is applied)
-        *      is stored in a separate texture. Thanks to that, we have the last and previous blur result textures,
-        *      both of which will be then used for continuous sampling (for the blending pass).
-        *
-        */
-        /* Bind a framebuffer object to the GL_DRAW_FRAMEBUFFER framebuffer binding point,
-        * so that everything we render will end up in the FBO's attachments. */
-        GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
-                                   blurringObjects.framebufferObjectId) );
-        /* Set the lower viewport resolution. It corresponds to size of the texture we will be rendering to. */
-        GL_CHECK(glViewport(0,
-                            0,
-                            windowWidth  / WINDOW_RESOLUTION_DIVISOR,
-                            windowHeight / WINDOW_RESOLUTION_DIVISOR) );
-        GL_CHECK(glEnable  (GL_SCISSOR_TEST) );
-
-        /* Apply the blur effect multiple times. */
-        for (int blurIterationIndex = 0;
-                 blurIterationIndex < currentNumberOfIterations;
-                 blurIterationIndex++)
-        {
-            /* FIRST PASS - HORIZONTAL BLUR
-             * Take the texture showing cubes which should be bloomed and apply a horizontal blur operation.
-             */
-            GL_CHECK(glUseProgram(blurringHorizontalProgramShaderObjects.programObjectId) );
-            {
-                /* Attach the texture we want the color data to be rendered to the current draw framebuffer.*/
-                GL_CHECK(glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
-                                                GL_COLOR_ATTACHMENT0,
-                                                GL_TEXTURE_2D,
-                                                blurringObjects.textureObjectIdHorizontal,
-                                                0) );
-
-                /* In first iteration we have to take the texture which shows the cubes we want blurred.
-                * Later, we have to take the same texture that has already been blurred vertically. */
-                if (blurIterationIndex == 0)
-                {
-                    GL_CHECK(glUniform1i(blurringHorizontalProgramLocations.uniformTextureSampler,
-                                        TEXTURE_UNIT_BLOOM_SOURCE_TEXTURE) );
-                }
-                else
-                {
-                    GL_CHECK(glUniform1i(blurringHorizontalProgramLocations.uniformTextureSampler,
-                                        TEXTURE_UNIT_BLURRED_TEXTURE) );
-                }
-
-                /* Draw texture. */
-                GL_CHECK(glDrawArrays(GL_TRIANGLE_FAN, 0, 4) );
-            } /* FIRST PASS - HORIZONTAL BLUR */
-
-            /* SECOND PASS - VERTICAL BLUR
-            * Take the result of the previous pass (horizontal blur) and apply a vertical blur to this texture.
-            */
-            GL_CHECK(glUseProgram(blurringVerticalProgramShaderObjects.programObjectId) );
-            {
-                if (blurIterationIndex == currentNumberOfIterations - 1)
-                {
-                    /* In case of the last iteration, use a different framebuffer object.
-                     * The rendering results will be written to the only color attachment of the fbo. */
-                    GL_CHECK(glBindFramebuffer(GL_DRAW_FRAMEBUFFER,
-                                               strongerBlurObjects.framebufferObjectId) );
-                }
-                else
-                {
-                    /* Bind a texture object we want the result data to be stored in.*/
-                    GL_CHECK(glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER,
-                                                    GL_COLOR_ATTACHMENT0,
-                                                    GL_TEXTURE_2D,
-                                                    blurringObjects.textureObjectIdVertical,
-                                                    0) );
-                }
-
-                /* Set uniform values. */
-                GL_CHECK(glUniform1i(blurringVerticalProgramLocations.uniformTextureSampler,
-                                     TEXTURE_UNIT_HORIZONTAL_BLUR_TEXTURE) ); /* Indicates which texture object content should be blurred. */
-
-                /* Draw texture. */
-                GL_CHECK(glDrawArrays(GL_TRIANGLE_FAN, 0, 4) );
-            } /* SECOND PASS - VERTICAL BLUR */
-        } /* for (int blur_iteration_index = 0; i < numberOfIterations; blur_iteration_index++) */
-
-        GL_CHECK(glDisable(GL_SCISSOR_TEST));
-        /* [Blur loop] */
+        applySeparableBlur(currentNumberOfIterations);
     } /* if (shouldSceneBeUpdated) */
 
     /* [Blending] */
@@ -1726,14 +2454,25 @@ void uninit()
     GL_CHECK(glBindTexture    (GL_TEXTURE_2D,
                                0) );
     GL_CHECK(glActiveTexture  (GL_TEXTURE0 + TEXTURE_UNIT_STRONGER_BLUR_TEXTURE) );
+    GL_CHECK(glBindTexture    (GL_TEXTURE_2D,
+                               0) );
+    GL_CHECK(glActiveTexture  (GL_TEXTURE0 + TEXTURE_UNIT_DUAL_FILTER_SOURCE) );
+    GL_CHECK(glBindTexture    (GL_TEXTURE_2D,
+                               0) );
+    GL_CHECK(glActiveTexture  (GL_TEXTURE0 + TEXTURE_UNIT_DUAL_FILTER_DETAIL) );
     GL_CHECK(glBindTexture    (GL_TEXTURE_2D,
                                0) );
 
     deleteBlurringObjects              (&blurringObjects);
+    deleteComputeProgramShaderObjects  (&dualFilterDownsampleComputeProgramShaderObjects);
+    deleteComputeProgramShaderObjects  (&dualFilterUpsampleComputeProgramShaderObjects);
+    deleteDualFilterObjects            (&dualFilterObjects);
     deleteGetLuminanceImageBloomObjects(&getLuminanceImageBloomObjects);
     deleteProgramShaderObjects         (&blendingProgramShaderObjects);
     deleteProgramShaderObjects         (&blurringHorizontalProgramShaderObjects);
     deleteProgramShaderObjects         (&blurringVerticalProgramShaderObjects);
+    deleteProgramShaderObjects         (&dualFilterDownsampleProgramShaderObjects);
+    deleteProgramShaderObjects         (&dualFilterUpsampleProgramShaderObjects);
     deleteProgramShaderObjects         (&getLuminanceImageProgramShaderObjects);
     deleteProgramShaderObjects         (&sceneRenderingProgramShaderObjects);
     deleteSceneRenderingObjects        (&sceneRenderingObjects);
@@ -1778,5 +2517,6 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_bloom_NativeLibrar
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_bloom_NativeLibrary_step(
         JNIEnv * env, jobject obj, jfloat time)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame(time);
 }
@@ -33,15 +33,7 @@
         exit(1); \
     }
 
-#define GL_CHECK(x) \
-    x; \
-    { \
-        GLenum glError = glGetError(); \
-        if(glError != GL_NO_ERROR) { \
-            LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1); \
-        } \
-    }
+#include "GLCheck.h"
 
 namespace MaliSDK
 {
@@ -61,7 +53,7 @@ namespace MaliSDK
          * \param[out] shaderPtr      The shader ID of the newly compiled shader. Cannot be NULL.
          * \param[in] shaderSourcePtr Contains OpenGL ES SL source code. Cannot be NULL.
          * \param[in] shaderType      Passed to glCreateShader to define the type of shader being processed.
-         *                            Must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
+         *                            Must be GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_COMPUTE_SHADER.
          */
         static void processShader(GLuint* shaderPtr, const char* shaderSourcePtr, GLint shaderType);
     };
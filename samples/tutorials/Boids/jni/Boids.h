@@ -21,15 +21,31 @@
 #ifndef BOIDS_H
 #define BOIDS_H
 
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.boids/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
+
 namespace MaliSDK
 {
     /** Name of a fragment shader file. */
-    #define FRAGMENT_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.boids/files/fragment_shader_source.frag")
+    #define FRAGMENT_SHADER_FILE_NAME (BASE_ASSET_PATH "fragment_shader_source.frag")
     /** Name of a vertex shader file. */
-    #define VERTEX_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.boids/files/vertex_shader_source.vert")
+    #define VERTEX_SHADER_FILE_NAME (BASE_ASSET_PATH "vertex_shader_source.vert")
     /** Name of a movement fragment shader file. */
-    #define MOVEMENT_FRAGMENT_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.boids/files/movement.frag")
+    #define MOVEMENT_FRAGMENT_SHADER_FILE_NAME (BASE_ASSET_PATH "movement.frag")
     /** Name of a movement vertex shader file. */
-    #define MOVEMENT_VERTEX_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.boids/files/movement.vert")
+    #define MOVEMENT_VERTEX_SHADER_FILE_NAME (BASE_ASSET_PATH "movement.vert")
+    /** Name of the vertex shader file used to draw large flocks with instancing. */
+    #define FLOCK_INSTANCED_VERTEX_SHADER_FILE_NAME (BASE_ASSET_PATH "flock_instanced.vert")
+    /** Name of the compute shader file which bins boids into grid cells. */
+    #define FLOCK_HASH_SHADER_FILE_NAME (BASE_ASSET_PATH "flock_hash.comp")
+    /** Name of the compute shader file which finds the first boid of each grid cell. */
+    #define FLOCK_SCAN_SHADER_FILE_NAME (BASE_ASSET_PATH "flock_scan.comp")
+    /** Name of the compute shader file which sorts boids by grid cell. */
+    #define FLOCK_SCATTER_SHADER_FILE_NAME (BASE_ASSET_PATH "flock_scatter.comp")
+    /** Name of the compute shader file which moves the boids of a large flock. */
+    #define FLOCK_UPDATE_SHADER_FILE_NAME (BASE_ASSET_PATH "flock_update.comp")
 }
 #endif /* BOIDS_H */
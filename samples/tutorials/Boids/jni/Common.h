@@ -21,15 +21,22 @@
 #ifndef COMMON_H
 #define COMMON_H
 
-#include <android/log.h>
 #include <cstdio>
 #include <cstdlib>
 #include <GLES3/gl3.h>
 
+#if defined(ANDROID)
+#include <android/log.h>
+
     #define LOG_TAG "libNative"
     #define LOGD(...) __android_log_print(ANDROID_LOG_DEBBUG, LOG_TAG, __VA_ARGS__)
     #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR,  LOG_TAG, __VA_ARGS__)
     #define LOGI(...) __android_log_print(ANDROID_LOG_INFO,   LOG_TAG, __VA_ARGS__)
+#else
+    #define LOGD(...) do { } while (0)
+    #define LOGE(...) do { fprintf(stderr, __VA_ARGS__); } while (0)
+    #define LOGI(...) do { fprintf(stdout, __VA_ARGS__); } while (0)
+#endif
     #define ASSERT(x, s)                                                    \
         if (!(x))                                                           \
         {                                                                   \
@@ -37,14 +44,6 @@
             exit(1);                                                        \
         }
 
-    #define GL_CHECK(x)                                                                              \
-        x;                                                                                           \
-        {                                                                                            \
-            GLenum glError = glGetError();                                                           \
-            if(glError != GL_NO_ERROR) {                                                             \
-                LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-                exit(1);                                                                             \
-            }                                                                                        \
-        }
+    #include "GLCheck.h"
 
 #endif /* COMMON_H */
@@ -33,17 +33,29 @@
  * transferred back to the CPU. Transform feedback buffers are used to store the output of the
  * movement vertex shader, this data is then used as the input data on the next pass.
  * The same data is used when rendering the scene.
+ *
+ * Setting flockMode switches to a much larger flock, where each boid only reacts to boids near it.
+ * Neighbours are found through a spatial hash, either in OpenGL ES 3.1 compute shaders or on the CPU
+ * (see SpatialHashFlock), and the boids are drawn with per-instance vertex attributes.
  */
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
+#include <GLES3/gl31.h>
 #include "Boids.h"
 #include "Common.h"
 #include "Shader.h"
+#include "SpatialHashFlock.h"
 #include "SphereModel.h"
 #include "Timer.h"
+#include <math.h>
 #include <stdlib.h>
+#include <vector>
+#include "Profiler.h"
+#include "Benchmark.h"
 using namespace MaliSDK;
 
 
@@ -126,6 +138,84 @@ GLuint spherePongPositionAndVelocityBufferObjectId = 0;
 /* Array holding positions and velocities of spheres in 3D space which are used to draw spheres for the first time. */
 float startPositionAndVelocity[spherePositionsAndVelocitiesLength] = {0};
 
+/* Large flock. */
+/* Ways of moving the boids. */
+enum FlockMode
+{
+    FLOCK_TRANSFORM_FEEDBACK,   /* The tutorial: 30 boids moved by transform feedback, every boid sees every other boid. */
+    FLOCK_COMPUTE_SPATIAL_HASH, /* numberOfBoidsInLargeFlock boids moved by compute shaders, neighbours found through a spatial hash. */
+    FLOCK_CPU_SPATIAL_HASH      /* Same as above, simulated on the CPU by SpatialHashFlock and uploaded every frame. */
+};
+/* Simulation used to move the boids. The large flock modes require OpenGL ES 3.1. */
+const FlockMode flockMode = FLOCK_TRANSFORM_FEEDBACK;
+/* Number of boids in the flock when flockMode is not FLOCK_TRANSFORM_FEEDBACK. */
+const int numberOfBoidsInLargeFlock = 10000;
+/* Spheres of a large flock are drawn with fewer samples, as the number of vertices grows with the number of boids. */
+const int largeFlockNumberOfSamples = 6;
+/* Number of threads used by the CPU flock. */
+const int numberOfFlockThreads = 4;
+/* If true, the O(N^2) and spatial hash simulations are timed for several flock sizes on startup, and the results are logged. */
+const bool runFlockBenchmark = false;
+/* Flock sizes used by the benchmark. */
+const int benchmarkFlockSizes[] = {1000, 10000, 100000};
+/* The O(N^2) simulation is skipped for flocks larger than this, as a single step would take seconds. */
+const int maximumBruteForceFlockSize = 10000;
+/* Number of boids processed by one work group of the flock compute shaders. */
+const int flockWorkGroupSize = 128;
+
+/* Uniform locations of a flock compute program. Uniforms not used by the program are -1. */
+struct FlockUniforms
+{
+    GLint numberOfBoids;
+    GLint tableSize;
+    GLint neighbourRadius;
+    GLint time;
+    GLint bruteForce;
+};
+
+/* True once setupLargeFlock() has created the objects below. */
+bool largeFlockInitialized = false;
+/* Largest number of boids the flock buffers can hold. */
+int flockCapacity = 0;
+/* Shader and program names of the flock programs: instanced rendering, hash, scan, scatter and update. */
+const int numberOfFlockPrograms = 5;
+GLuint flockShaderIds[numberOfFlockPrograms] = {0};
+GLuint flockFragmentShaderId = 0;
+GLuint flockProgramIds[numberOfFlockPrograms] = {0};
+GLuint flockRenderingProgramId = 0;
+GLuint flockHashProgramId = 0;
+GLuint flockScanProgramId = 0;
+GLuint flockScatterProgramId = 0;
+GLuint flockUpdateProgramId = 0;
+FlockUniforms flockHashUniforms;
+FlockUniforms flockScanUniforms;
+FlockUniforms flockScatterUniforms;
+FlockUniforms flockUpdateUniforms;
+/* "attributeBoidLocation" per-instance attribute's location. */
+GLint flockBoidLocationLocation = 0;
+/* Vertex array object holding the sphere attributes of the large flock. */
+GLuint flockVertexArrayId = 0;
+/* Number of points in the sphere drawn for each boid of a large flock. */
+int flockNumberOfSphereTrianglePoints = 0;
+/* Buffer objects of the large flock. */
+const int numberOfFlockBufferObjectIds = 9;
+GLuint flockBufferObjectIds[numberOfFlockBufferObjectIds] = {0};
+/* Sphere coordinates and colors. */
+GLuint flockSphereCoordinatesBufferObjectId = 0;
+GLuint flockSphereColorsBufferObjectId = 0;
+/* Boids, 8 floats each (location and velocity), ping-ponged between frames. flockBoidsBufferObjectIds[currentFlockBuffer] holds the current state. */
+GLuint flockBoidsBufferObjectIds[2] = {0};
+int currentFlockBuffer = 0;
+/* Number of boids in each hash table entry, hash table entry and rank of each boid, first sorted boid of each entry. */
+GLuint flockCellCountBufferObjectId = 0;
+GLuint flockBoidCellBufferObjectId = 0;
+GLuint flockCellStartBufferObjectId = 0;
+/* Boids sorted by hash table entry, and their original indices. */
+GLuint flockSortedBoidsBufferObjectId = 0;
+GLuint flockSortedIdsBufferObjectId = 0;
+/* Simulation used in FLOCK_CPU_SPATIAL_HASH mode. */
+SpatialHashFlock* cpuFlock = NULL;
+
 /**
 * \brief Generate random positions and velocities of spheres which are used during first draw call.
 */
@@ -374,6 +464,422 @@ void setupPrograms()
     /* [Fill position and velocity buffer with data] */
 }
 
+/**
+ * \brief Generate random positions of a large flock, spread so that its density is similar to the tutorial's flock.
+ *
+ * \param[in]  numberOfBoids Number of boids to generate.
+ * \param[out] boids         Receives 8 floats per boid: location followed by a zero velocity.
+ */
+void generateLargeFlock(int numberOfBoids, std::vector<float>& boids)
+{
+    const float side = 10.0f * cbrtf(numberOfBoids / float(numberOfSpheresToGenerate));
+
+    boids.assign(numberOfBoids * 8, 0.0f);
+
+    for (int boid = 0; boid < numberOfBoids; boid++)
+    {
+        for (int axis = 0; axis < 3; axis++)
+        {
+            boids[boid * 8 + axis] = side * (float(rand()) / float(RAND_MAX) - 0.5f);
+        }
+        boids[boid * 8 + 3] = 1.0f;
+    }
+}
+
+/**
+ * \brief Compile a compute shader and link it into a new program.
+ *
+ * \param[out] shaderId Deref will be used to store the shader object ID.
+ * \param[in]  fileName Name of the file holding the compute shader source.
+ * \param[out] uniforms Receives the locations of the flock uniforms.
+ *
+ * \return Name of the linked program.
+ */
+GLuint createFlockComputeProgram(GLuint* shaderId, const char* fileName, FlockUniforms* uniforms)
+{
+    GLuint programId  = GL_CHECK(glCreateProgram());
+    GLint linkStatus  = GL_FALSE;
+
+    Shader::processShader(shaderId, fileName, GL_COMPUTE_SHADER);
+
+    GL_CHECK(glAttachShader(programId, *shaderId));
+    GL_CHECK(glLinkProgram(programId));
+    GL_CHECK(glGetProgramiv(programId, GL_LINK_STATUS, &linkStatus));
+
+    ASSERT(linkStatus == GL_TRUE, "Could not link flock compute program.");
+
+    uniforms->numberOfBoids   = GL_CHECK(glGetUniformLocation(programId, "numberOfBoids"));
+    uniforms->tableSize       = GL_CHECK(glGetUniformLocation(programId, "tableSize"));
+    uniforms->neighbourRadius = GL_CHECK(glGetUniformLocation(programId, "neighbourRadius"));
+    uniforms->time            = GL_CHECK(glGetUniformLocation(programId, "time"));
+    uniforms->bruteForce      = GL_CHECK(glGetUniformLocation(programId, "bruteForce"));
+
+    return programId;
+}
+
+/**
+ * \brief Set the uniforms of the current flock compute program.
+ */
+void setFlockUniforms(const FlockUniforms& uniforms, int numberOfBoids, float time, bool bruteForce)
+{
+    GL_CHECK(glUniform1ui(uniforms.numberOfBoids,   numberOfBoids));
+    GL_CHECK(glUniform1ui(uniforms.tableSize,       SpatialHashFlock::getHashTableSize(numberOfBoids)));
+    GL_CHECK(glUniform1f (uniforms.neighbourRadius, SpatialHashFlock::neighbourRadius));
+    GL_CHECK(glUniform1f (uniforms.time,            time));
+    GL_CHECK(glUniform1i (uniforms.bruteForce,      bruteForce ? 1 : 0));
+}
+
+/**
+ * \brief Upload a new state of the large flock.
+ *
+ * \param[in] boids         8 floats per boid: location followed by velocity.
+ * \param[in] numberOfBoids Number of boids. Cannot exceed flockCapacity.
+ */
+void uploadLargeFlock(const float* boids, int numberOfBoids)
+{
+    GL_CHECK(glBindBuffer   (GL_ARRAY_BUFFER, flockBoidsBufferObjectIds[currentFlockBuffer]));
+    GL_CHECK(glBufferSubData(GL_ARRAY_BUFFER, 0, numberOfBoids * 8 * sizeof(float), boids));
+}
+
+/**
+ * \brief Move the large flock by one step with the compute shaders.
+ *
+ * The hash pass bins each boid into a grid cell and counts the boids per cell, the scan pass
+ * turns the counts into the first sorted index of each cell, and the scatter pass sorts the
+ * boids by cell. The update pass then only visits the 27 cells around each boid.
+ * With bruteForce set the first three passes are skipped and every boid visits all the others.
+ */
+void simulateLargeFlockOnGPU(int numberOfBoids, float time, bool bruteForce)
+{
+    const GLuint input      = flockBoidsBufferObjectIds[currentFlockBuffer];
+    const GLuint output     = flockBoidsBufferObjectIds[1 - currentFlockBuffer];
+    const GLuint workGroups = (numberOfBoids + flockWorkGroupSize - 1) / flockWorkGroupSize;
+
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, input));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, flockCellCountBufferObjectId));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, flockBoidCellBufferObjectId));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, flockCellStartBufferObjectId));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, flockSortedBoidsBufferObjectId));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, flockSortedIdsBufferObjectId));
+    GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, output));
+
+    if (!bruteForce)
+    {
+        GL_CHECK(glUseProgram(flockHashProgramId));
+        setFlockUniforms(flockHashUniforms, numberOfBoids, time, bruteForce);
+        GL_CHECK(glDispatchCompute(workGroups, 1, 1));
+        GL_CHECK(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+        /* A single work group scans the whole table. */
+        GL_CHECK(glUseProgram(flockScanProgramId));
+        setFlockUniforms(flockScanUniforms, numberOfBoids, time, bruteForce);
+        GL_CHECK(glDispatchCompute(1, 1, 1));
+        GL_CHECK(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+
+        GL_CHECK(glUseProgram(flockScatterProgramId));
+        setFlockUniforms(flockScatterUniforms, numberOfBoids, time, bruteForce);
+        GL_CHECK(glDispatchCompute(workGroups, 1, 1));
+        GL_CHECK(glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT));
+    }
+    else
+    {
+        /* Every boid is a neighbour candidate, in the original order. */
+        GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, input));
+    }
+
+    GL_CHECK(glUseProgram(flockUpdateProgramId));
+    setFlockUniforms(flockUpdateUniforms, numberOfBoids, time, bruteForce);
+    GL_CHECK(glDispatchCompute(workGroups, 1, 1));
+
+    /* The output is read as a vertex attribute when drawing, and as a storage buffer in the next step. */
+    GL_CHECK(glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT));
+
+    for (GLuint binding = 0; binding < 7; binding++)
+    {
+        GL_CHECK(glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, 0));
+    }
+
+    currentFlockBuffer = 1 - currentFlockBuffer;
+}
+
+/**
+ * \brief Create the programs, buffers and sphere used for large flocks.
+ *
+ * \param[in] capacity Largest number of boids that will be simulated.
+ */
+void setupLargeFlock(int capacity)
+{
+    const char* computeShaderFileNames[] = { FLOCK_HASH_SHADER_FILE_NAME,
+                                             FLOCK_SCAN_SHADER_FILE_NAME,
+                                             FLOCK_SCATTER_SHADER_FILE_NAME,
+                                             FLOCK_UPDATE_SHADER_FILE_NAME };
+    FlockUniforms* computeUniforms[]     = { &flockHashUniforms,
+                                             &flockScanUniforms,
+                                             &flockScatterUniforms,
+                                             &flockUpdateUniforms };
+    GLint linkStatus                     = GL_FALSE;
+
+    flockCapacity = capacity;
+
+    /* Rendering program: the sphere is positioned by a per-instance attribute instead of a uniform block. */
+    flockRenderingProgramId = GL_CHECK(glCreateProgram());
+    flockProgramIds[0]      = flockRenderingProgramId;
+
+    Shader::processShader(&flockShaderIds[0],     FLOCK_INSTANCED_VERTEX_SHADER_FILE_NAME, GL_VERTEX_SHADER);
+    Shader::processShader(&flockFragmentShaderId, FRAGMENT_SHADER_FILE_NAME,               GL_FRAGMENT_SHADER);
+
+    GL_CHECK(glAttachShader(flockRenderingProgramId, flockShaderIds[0]));
+    GL_CHECK(glAttachShader(flockRenderingProgramId, flockFragmentShaderId));
+    GL_CHECK(glLinkProgram (flockRenderingProgramId));
+    GL_CHECK(glGetProgramiv(flockRenderingProgramId, GL_LINK_STATUS, &linkStatus));
+
+    ASSERT(linkStatus == GL_TRUE, "Could not link flock rendering program.");
+
+    for (int program = 1; program < numberOfFlockPrograms; program++)
+    {
+        flockProgramIds[program] = createFlockComputeProgram(&flockShaderIds[program],
+                                                             computeShaderFileNames[program - 1],
+                                                             computeUniforms[program - 1]);
+    }
+
+    flockHashProgramId    = flockProgramIds[1];
+    flockScanProgramId    = flockProgramIds[2];
+    flockScatterProgramId = flockProgramIds[3];
+    flockUpdateProgramId  = flockProgramIds[4];
+
+    /* Buffers. */
+    const unsigned int tableSize = SpatialHashFlock::getHashTableSize(capacity);
+
+    GL_CHECK(glGenBuffers(numberOfFlockBufferObjectIds, flockBufferObjectIds));
+
+    flockSphereCoordinatesBufferObjectId = flockBufferObjectIds[0];
+    flockSphereColorsBufferObjectId      = flockBufferObjectIds[1];
+    flockBoidsBufferObjectIds[0]         = flockBufferObjectIds[2];
+    flockBoidsBufferObjectIds[1]         = flockBufferObjectIds[3];
+    flockCellCountBufferObjectId         = flockBufferObjectIds[4];
+    flockBoidCellBufferObjectId          = flockBufferObjectIds[5];
+    flockCellStartBufferObjectId         = flockBufferObjectIds[6];
+    flockSortedBoidsBufferObjectId       = flockBufferObjectIds[7];
+    flockSortedIdsBufferObjectId         = flockBufferObjectIds[8];
+
+    for (int buffer = 0; buffer < 2; buffer++)
+    {
+        GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, flockBoidsBufferObjectIds[buffer]));
+        GL_CHECK(glBufferData(GL_ARRAY_BUFFER, capacity * 8 * sizeof(float), NULL, GL_DYNAMIC_DRAW));
+    }
+
+    /* The counts must start at zero. The scan pass clears them again for the next step. */
+    std::vector<GLuint> zeroes(tableSize, 0);
+
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, flockCellCountBufferObjectId));
+    GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, tableSize * sizeof(GLuint), &zeroes[0], GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, flockCellStartBufferObjectId));
+    GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, (tableSize + 1) * sizeof(GLuint), NULL, GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, flockBoidCellBufferObjectId));
+    GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * 2 * sizeof(GLuint), NULL, GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, flockSortedBoidsBufferObjectId));
+    GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * 8 * sizeof(float), NULL, GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, flockSortedIdsBufferObjectId));
+    GL_CHECK(glBufferData(GL_SHADER_STORAGE_BUFFER, capacity * sizeof(GLuint), NULL, GL_DYNAMIC_COPY));
+    GL_CHECK(glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0));
+
+    /* Low detail sphere with one random color per vertex. */
+    int    numberOfCoordinates = 0;
+    float* coordinates         = NULL;
+
+    SphereModel::getTriangleRepresentation(10.0f,
+                                           largeFlockNumberOfSamples,
+                                          &numberOfCoordinates,
+                                          &flockNumberOfSphereTrianglePoints,
+                                          &coordinates);
+
+    std::vector<float> colors(flockNumberOfSphereTrianglePoints * 4);
+    for (size_t component = 0; component < colors.size(); component++)
+    {
+        colors[component] = float(rand()) / float(RAND_MAX);
+    }
+
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, flockSphereCoordinatesBufferObjectId));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER, numberOfCoordinates * sizeof(float), coordinates, GL_STATIC_DRAW));
+    GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, flockSphereColorsBufferObjectId));
+    GL_CHECK(glBufferData(GL_ARRAY_BUFFER, colors.size() * sizeof(float), &colors[0], GL_STATIC_DRAW));
+
+    free(coordinates);
+
+    /* Vertex array object, so that the tutorial's vertex attribute setup is left untouched. */
+    GLint flockPositionLocation = GL_CHECK(glGetAttribLocation(flockRenderingProgramId, "attributePosition"));
+    GLint flockColorLocation    = GL_CHECK(glGetAttribLocation(flockRenderingProgramId, "attributeColor"));
+    flockBoidLocationLocation   = GL_CHECK(glGetAttribLocation(flockRenderingProgramId, "attributeBoidLocation"));
+
+    ASSERT(flockPositionLocation     != -1, "Could not retrieve attribute location: attributePosition");
+    ASSERT(flockColorLocation        != -1, "Could not retrieve attribute location: attributeColor");
+    ASSERT(flockBoidLocationLocation != -1, "Could not retrieve attribute location: attributeBoidLocation");
+
+    GL_CHECK(glGenVertexArrays(1, &flockVertexArrayId));
+    GL_CHECK(glBindVertexArray(flockVertexArrayId));
+
+    GL_CHECK(glBindBuffer             (GL_ARRAY_BUFFER, flockSphereCoordinatesBufferObjectId));
+    GL_CHECK(glEnableVertexAttribArray(flockPositionLocation));
+    GL_CHECK(glVertexAttribPointer    (flockPositionLocation, 3, GL_FLOAT, GL_FALSE, 0, 0));
+
+    GL_CHECK(glBindBuffer             (GL_ARRAY_BUFFER, flockSphereColorsBufferObjectId));
+    GL_CHECK(glEnableVertexAttribArray(flockColorLocation));
+    GL_CHECK(glVertexAttribPointer    (flockColorLocation, 4, GL_FLOAT, GL_FALSE, 0, 0));
+
+    /* One location per sphere. The buffer is bound every frame, as it alternates between the two boid buffers. */
+    GL_CHECK(glEnableVertexAttribArray(flockBoidLocationLocation));
+    GL_CHECK(glVertexAttribDivisor    (flockBoidLocationLocation, 1));
+
+    GL_CHECK(glBindVertexArray(0));
+
+    /* Move the camera back as the flock grows. */
+    const float cameraDistance      = 60.0f * cbrtf(numberOfBoidsInLargeFlock / float(numberOfSpheresToGenerate));
+    float       scalingVector[]     = {0.1f, 0.1f, 0.1f};
+    float       perspectiveVector[] = {45.0f, float(windowWidth) / float(windowHeight), 0.1f, 10.0f * cameraDistance};
+    float       cameraVector[]      = {0.0f, 0.0f, -cameraDistance};
+
+    GLint flockScalingLocation     = GL_CHECK(glGetUniformLocation(flockRenderingProgramId, "scalingVector"));
+    GLint flockPerspectiveLocation = GL_CHECK(glGetUniformLocation(flockRenderingProgramId, "perspectiveVector"));
+    GLint flockCameraLocation      = GL_CHECK(glGetUniformLocation(flockRenderingProgramId, "cameraVector"));
+
+    GL_CHECK(glUseProgram(flockRenderingProgramId));
+    GL_CHECK(glUniform3fv(flockScalingLocation,     1, scalingVector));
+    GL_CHECK(glUniform4fv(flockPerspectiveLocation, 1, perspectiveVector));
+    GL_CHECK(glUniform3fv(flockCameraLocation,      1, cameraVector));
+
+    if (flockMode == FLOCK_CPU_SPATIAL_HASH)
+    {
+        cpuFlock = new SpatialHashFlock(numberOfBoidsInLargeFlock, numberOfFlockThreads);
+    }
+
+    largeFlockInitialized = true;
+}
+
+/**
+ * \brief Place the boids of the large flock at their random start positions.
+ */
+void resetLargeFlock()
+{
+    std::vector<float> boids;
+
+    generateLargeFlock(numberOfBoidsInLargeFlock, boids);
+    uploadLargeFlock(&boids[0], numberOfBoidsInLargeFlock);
+
+    if (cpuFlock != NULL)
+    {
+        cpuFlock->setBoids(&boids[0]);
+    }
+}
+
+/**
+ * \brief Time the O(N^2) and spatial hash simulations, on the GPU and on the CPU, and log the average step time.
+ *
+ * The GPU is synchronised with glFinish() around every measurement, so the times include the full step.
+ */
+void benchmarkFlock()
+{
+    const int numberOfWarmUpSteps = 2;
+    const int numberOfTimedSteps  = 10;
+
+    LOGI("Flock benchmark: average step time in ms (%d threads on the CPU)\n", numberOfFlockThreads);
+    LOGI("%10s %14s %14s %14s %14s\n", "boids", "GPU O(N^2)", "GPU hashed", "CPU O(N^2)", "CPU hashed");
+
+    for (size_t size = 0; size < sizeof(benchmarkFlockSizes) / sizeof(benchmarkFlockSizes[0]); size++)
+    {
+        const int numberOfBoids = benchmarkFlockSizes[size];
+        float     results[4]    = {-1.0f, -1.0f, -1.0f, -1.0f};
+
+        if (numberOfBoids > flockCapacity)
+        {
+            continue;
+        }
+
+        std::vector<float> boids;
+        generateLargeFlock(numberOfBoids, boids);
+
+        for (int method = 0; method < 4; method++)
+        {
+            const bool useGPU     = (method < 2);
+            const bool bruteForce = (method % 2 == 0);
+
+            if (bruteForce && numberOfBoids > maximumBruteForceFlockSize)
+            {
+                continue;
+            }
+
+            SpatialHashFlock* flock = NULL;
+            if (useGPU)
+            {
+                uploadLargeFlock(&boids[0], numberOfBoids);
+            }
+            else
+            {
+                flock = new SpatialHashFlock(numberOfBoids, numberOfFlockThreads);
+                flock->setBoids(&boids[0]);
+            }
+
+            float start = 0.0f;
+            for (int step = 0; step < numberOfWarmUpSteps + numberOfTimedSteps; step++)
+            {
+                if (step == numberOfWarmUpSteps)
+                {
+                    GL_CHECK(glFinish());
+                    start = timer.getTime();
+                }
+
+                if (useGPU)
+                {
+                    simulateLargeFlockOnGPU(numberOfBoids, step * 0.016f, bruteForce);
+                }
+                else
+                {
+                    flock->step(step * 0.016f, !bruteForce);
+                }
+            }
+            GL_CHECK(glFinish());
+
+            results[method] = 1000.0f * (timer.getTime() - start) / numberOfTimedSteps;
+
+            delete flock;
+        }
+
+        LOGI("%10d %14.2f %14.2f %14.2f %14.2f\n", numberOfBoids, results[0], results[1], results[2], results[3]);
+    }
+
+    LOGI("Entries of -1 were skipped.\n");
+}
+
+/**
+ * \brief Move and draw the large flock.
+ *
+ * \param[in] time Time used to place the leader on its path.
+ */
+void renderLargeFlock(float time)
+{
+    if (flockMode == FLOCK_CPU_SPATIAL_HASH)
+    {
+        cpuFlock->step(time, true);
+        uploadLargeFlock(cpuFlock->getBoids(), numberOfBoidsInLargeFlock);
+    }
+    else
+    {
+        simulateLargeFlockOnGPU(numberOfBoidsInLargeFlock, time, false);
+    }
+
+    GL_CHECK(glUseProgram(flockRenderingProgramId));
+    GL_CHECK(glBindVertexArray(flockVertexArrayId));
+
+    GL_CHECK(glBindBuffer         (GL_ARRAY_BUFFER, flockBoidsBufferObjectIds[currentFlockBuffer]));
+    GL_CHECK(glVertexAttribPointer(flockBoidLocationLocation, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), 0));
+
+    GL_CHECK(glDrawArraysInstanced(GL_TRIANGLES,
+                                   0,
+                                   flockNumberOfSphereTrianglePoints,
+                                   numberOfBoidsInLargeFlock));
+
+    GL_CHECK(glBindVertexArray(0));
+}
+
 /**
  * \brief Render new frame's contents into back buffer.
  */
@@ -385,6 +891,12 @@ void renderFrame()
     /* Value of time returned by timer used for determining leader's position and to keep the leader's velocity constant across different GPUs. */
     float timerTime = timer.getTime();
 
+    if (flockMode != FLOCK_TRANSFORM_FEEDBACK)
+    {
+        renderLargeFlock(timerTime);
+        return;
+    }
+
     /*
      * Transform feedback is used for setting position and velocity for each of the spheres.
      * You cannot read from and write to the same buffer object at a time, so we use a ping-pong approach.
@@ -512,6 +1024,29 @@ void setupGraphics(int width, int height)
     initializeData();
     /* Create programs. */
     setupPrograms();
+
+    if (flockMode != FLOCK_TRANSFORM_FEEDBACK || runFlockBenchmark)
+    {
+        int capacity = numberOfBoidsInLargeFlock;
+
+        if (runFlockBenchmark)
+        {
+            for (size_t size = 0; size < sizeof(benchmarkFlockSizes) / sizeof(benchmarkFlockSizes[0]); size++)
+            {
+                capacity = benchmarkFlockSizes[size] > capacity ? benchmarkFlockSizes[size] : capacity;
+            }
+        }
+
+        setupLargeFlock(capacity);
+
+        if (runFlockBenchmark)
+        {
+            benchmarkFlock();
+        }
+
+        resetLargeFlock();
+    }
+
     /* Start counting time. */
     timer.reset();
 
@@ -569,8 +1104,27 @@ void uninit()
     GL_CHECK(glDeleteShader (vertexShaderId));
     GL_CHECK(glDeleteProgram(renderingProgramId));
     GL_CHECK(glDeleteProgram(movementProgramId));
+
+    if (largeFlockInitialized)
+    {
+        GL_CHECK(glDeleteVertexArrays(1, &flockVertexArrayId));
+        GL_CHECK(glDeleteBuffers(numberOfFlockBufferObjectIds, flockBufferObjectIds));
+        GL_CHECK(glDeleteShader(flockFragmentShaderId));
+
+        for (int program = 0; program < numberOfFlockPrograms; program++)
+        {
+            GL_CHECK(glDeleteShader (flockShaderIds[program]));
+            GL_CHECK(glDeleteProgram(flockProgramIds[program]));
+        }
+
+        delete cpuFlock;
+        cpuFlock = NULL;
+
+        largeFlockInitialized = false;
+    }
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_boids_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -594,5 +1148,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_boids_NativeLibrar
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_boids_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Boids", setupGraphics, renderFrame)
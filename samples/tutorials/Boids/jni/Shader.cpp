@@ -21,6 +21,8 @@
 #include "Common.h"
 #include "Shader.h"
 
+#include <GLES3/gl31.h>
+
 #include <cstdio>
 #include <cstdlib>
 
@@ -64,7 +66,7 @@ namespace MaliSDK
         ASSERT(shaderObjectIdPtr != NULL,
                "NULL pointer used to store generated shader object ID.");
 
-        ASSERT(shaderType == GL_FRAGMENT_SHADER || shaderType == GL_VERTEX_SHADER,
+        ASSERT(shaderType == GL_FRAGMENT_SHADER || shaderType == GL_VERTEX_SHADER || shaderType == GL_COMPUTE_SHADER,
                "Invalid shader object type.");
 
         GLint       compileStatus = GL_FALSE;
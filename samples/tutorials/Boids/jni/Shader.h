@@ -52,7 +52,7 @@ namespace MaliSDK
         *                          Cannot be NULL.
         * \param filename          Name of a file containing OpenGL ES SL source code.
         * \param shaderType        Passed to glCreateShader to define the type of shader being processed.
-        *                          Must be GL_VERTEX_SHADER or GL_FRAGMENT_SHADER.
+        *                          Must be GL_VERTEX_SHADER, GL_FRAGMENT_SHADER or GL_COMPUTE_SHADER (OpenGL ES 3.1).
         */
         static void processShader(GLuint *shaderObjectIdPtr, const char *filename, GLint shaderType);
     };
@@ -0,0 +1,476 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "SpatialHashFlock.h"
+
+#include "ParallelBands.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define FLOCK_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FLOCK_USE_SSE2 1
+#endif
+
+namespace
+{
+    /** Number of floats describing one boid: xyzw location and xyzw velocity. */
+    const unsigned int floatsPerBoid = 8;
+
+    /** Lower bound on squared distances, so that a boid never divides by its own zero distance. */
+    const float minimumDistance2 = 1e-12f;
+}
+
+namespace MaliSDK
+{
+    /* These values must match the constants in flock_update.comp. */
+    const float SpatialHashFlock::neighbourRadius    = 8.0f;
+    const float SpatialHashFlock::separationDistance = 4.0f;
+    const float SpatialHashFlock::leaderAttraction   = 0.001f;
+    const float SpatialHashFlock::maximumSpeed       = 2.0f;
+
+    SpatialHashFlock::SpatialHashFlock(unsigned int numberOfBoids, unsigned int numberOfThreads)
+        : numberOfBoids(numberOfBoids < 1 ? 1 : numberOfBoids)
+        , numberOfThreads(numberOfThreads < 1 ? 1 : numberOfThreads)
+        , tableSize(0)
+        , current(0)
+        , time(0.0f)
+        , useSpatialHash(true)
+    {
+        tableSize = getHashTableSize(this->numberOfBoids);
+
+        boids[0].resize(this->numberOfBoids * floatsPerBoid, 0.0f);
+        boids[1].resize(this->numberOfBoids * floatsPerBoid, 0.0f);
+
+        sortedX.resize(this->numberOfBoids);
+        sortedY.resize(this->numberOfBoids);
+        sortedZ.resize(this->numberOfBoids);
+        sortedVX.resize(this->numberOfBoids);
+        sortedVY.resize(this->numberOfBoids);
+        sortedVZ.resize(this->numberOfBoids);
+        sortedIds.resize(this->numberOfBoids);
+        boidCells.resize(this->numberOfBoids);
+        cellStart.resize(tableSize + 1);
+
+        if (this->numberOfThreads > this->numberOfBoids)
+        {
+            this->numberOfThreads = this->numberOfBoids;
+        }
+
+        /* Split the boids evenly between threads. */
+        chunks.resize(this->numberOfThreads);
+        for (unsigned int chunkIndex = 0; chunkIndex < this->numberOfThreads; chunkIndex++)
+        {
+            chunks[chunkIndex].flock = this;
+            chunks[chunkIndex].first = (this->numberOfBoids * chunkIndex) / this->numberOfThreads;
+            chunks[chunkIndex].end   = (this->numberOfBoids * (chunkIndex + 1)) / this->numberOfThreads;
+        }
+    }
+
+    unsigned int SpatialHashFlock::getHashTableSize(unsigned int numberOfBoids)
+    {
+        /* A power of two with about two entries per boid keeps collisions rare. */
+        unsigned int size = 1024;
+        while (size < 2 * numberOfBoids)
+        {
+            size *= 2;
+        }
+        return size;
+    }
+
+    unsigned int SpatialHashFlock::hashCell(int x, int y, int z, unsigned int tableSize)
+    {
+        unsigned int hash = ((unsigned int)x * 73856093u) ^
+                            ((unsigned int)y * 19349663u) ^
+                            ((unsigned int)z * 83492791u);
+        return hash & (tableSize - 1);
+    }
+
+    void SpatialHashFlock::setBoids(const float* boids)
+    {
+        memcpy(&this->boids[current][0], boids, numberOfBoids * floatsPerBoid * sizeof(float));
+    }
+
+    void SpatialHashFlock::step(float time, bool useSpatialHash)
+    {
+        this->time           = time;
+        this->useSpatialHash = useSpatialHash;
+
+        sortBoids();
+        runChunks();
+
+        current = 1 - current;
+    }
+
+    void SpatialHashFlock::sortBoids()
+    {
+        const float* input = &boids[current][0];
+
+        if (!useSpatialHash)
+        {
+            /* All boids are visited by everyone, so keep them in their original order. */
+            for (unsigned int boid = 0; boid < numberOfBoids; boid++)
+            {
+                boidCells[boid] = boid;
+            }
+        }
+        else
+        {
+            const float inverseCellSize = 1.0f / neighbourRadius;
+
+            /* Count the boids in each cell. The counts are stored one entry to the right. */
+            memset(&cellStart[0], 0, cellStart.size() * sizeof(unsigned int));
+            for (unsigned int boid = 0; boid < numberOfBoids; boid++)
+            {
+                const float* location = input + boid * floatsPerBoid;
+                unsigned int cell     = hashCell((int)floorf(location[0] * inverseCellSize),
+                                                 (int)floorf(location[1] * inverseCellSize),
+                                                 (int)floorf(location[2] * inverseCellSize),
+                                                 tableSize);
+                boidCells[boid] = cell;
+                cellStart[cell + 1]++;
+            }
+
+            /* Turn the counts into the first sorted index of each cell. */
+            for (unsigned int cell = 1; cell <= tableSize; cell++)
+            {
+                cellStart[cell] += cellStart[cell - 1];
+            }
+
+            /* Place every boid, advancing the start of its cell. Afterwards cellStart[cell] holds the end of the cell. */
+            for (unsigned int boid = 0; boid < numberOfBoids; boid++)
+            {
+                boidCells[boid] = cellStart[boidCells[boid]]++;
+            }
+
+            /* Shift back so that cellStart[cell] is the start and cellStart[cell + 1] the end of the cell. */
+            for (unsigned int cell = tableSize; cell > 0; cell--)
+            {
+                cellStart[cell] = cellStart[cell - 1];
+            }
+            cellStart[0] = 0;
+        }
+
+        /* boidCells now holds the sorted index of every boid. */
+        for (unsigned int boid = 0; boid < numberOfBoids; boid++)
+        {
+            const float* data   = input + boid * floatsPerBoid;
+            unsigned int sorted = boidCells[boid];
+
+            sortedX[sorted]   = data[0];
+            sortedY[sorted]   = data[1];
+            sortedZ[sorted]   = data[2];
+            sortedVX[sorted]  = data[4];
+            sortedVY[sorted]  = data[5];
+            sortedVZ[sorted]  = data[6];
+            sortedIds[sorted] = boid;
+        }
+    }
+
+    void SpatialHashFlock::chunkEntry(void* argument)
+    {
+        const Chunk* chunk = (const Chunk*)argument;
+
+        chunk->flock->updateChunk(chunk);
+    }
+
+    void SpatialHashFlock::runChunks()
+    {
+        runBands(chunkEntry, &chunks[0], sizeof(Chunk), numberOfThreads);
+    }
+
+    void SpatialHashFlock::gatherNeighbours(const unsigned int* ranges, int numberOfRanges, const float* location, Neighbourhood* neighbourhood) const
+    {
+        const float radius2            = neighbourRadius * neighbourRadius;
+        const float separation2        = separationDistance * separationDistance;
+        const float inverseSeparation  = 1.0f / separationDistance;
+
+#if defined(FLOCK_USE_NEON) || defined(FLOCK_USE_SSE2)
+        /* Sums over 4 lanes, reduced once at the end. */
+        float lanes[10][4];
+#endif
+
+#if defined(FLOCK_USE_NEON)
+        const float32x4_t px          = vdupq_n_f32(location[0]);
+        const float32x4_t py          = vdupq_n_f32(location[1]);
+        const float32x4_t pz          = vdupq_n_f32(location[2]);
+        const float32x4_t zero        = vdupq_n_f32(0.0f);
+        const float32x4_t one         = vdupq_n_f32(1.0f);
+        float32x4_t       sums[10];
+
+        for (int sum = 0; sum < 10; sum++)
+        {
+            sums[sum] = zero;
+        }
+
+        for (int range = 0; range < numberOfRanges; range++)
+        for (unsigned int j = ranges[2 * range]; j + 4 <= ranges[2 * range + 1]; j += 4)
+        {
+            const float32x4_t x  = vld1q_f32(&sortedX[j]);
+            const float32x4_t y  = vld1q_f32(&sortedY[j]);
+            const float32x4_t z  = vld1q_f32(&sortedZ[j]);
+            const float32x4_t dx = vsubq_f32(x, px);
+            const float32x4_t dy = vsubq_f32(y, py);
+            const float32x4_t dz = vsubq_f32(z, pz);
+            const float32x4_t d2 = vmlaq_f32(vmlaq_f32(vmulq_f32(dx, dx), dy, dy), dz, dz);
+
+            const uint32x4_t inRange = vcltq_f32(d2, vdupq_n_f32(radius2));
+            const uint32x4_t isClose = vcltq_f32(d2, vdupq_n_f32(separation2));
+
+            sums[0] = vaddq_f32(sums[0], vbslq_f32(inRange, one, zero));
+            sums[1] = vaddq_f32(sums[1], vbslq_f32(inRange, x, zero));
+            sums[2] = vaddq_f32(sums[2], vbslq_f32(inRange, y, zero));
+            sums[3] = vaddq_f32(sums[3], vbslq_f32(inRange, z, zero));
+            sums[4] = vaddq_f32(sums[4], vbslq_f32(inRange, vld1q_f32(&sortedVX[j]), zero));
+            sums[5] = vaddq_f32(sums[5], vbslq_f32(inRange, vld1q_f32(&sortedVY[j]), zero));
+            sums[6] = vaddq_f32(sums[6], vbslq_f32(inRange, vld1q_f32(&sortedVZ[j]), zero));
+
+            /* Distance for the smoothstep falloff of the separation. */
+            const float32x4_t clamped = vmaxq_f32(d2, vdupq_n_f32(minimumDistance2));
+#if defined(__aarch64__)
+            const float32x4_t distance = vsqrtq_f32(clamped);
+#else
+            float32x4_t inverse = vrsqrteq_f32(clamped);
+            inverse = vmulq_f32(inverse, vrsqrtsq_f32(vmulq_f32(clamped, inverse), inverse));
+            inverse = vmulq_f32(inverse, vrsqrtsq_f32(vmulq_f32(clamped, inverse), inverse));
+            const float32x4_t distance = vmulq_f32(clamped, inverse);
+#endif
+            const float32x4_t t      = vminq_f32(vmulq_f32(distance, vdupq_n_f32(inverseSeparation)), one);
+            const float32x4_t smooth = vmulq_f32(vmulq_f32(t, t), vmlsq_f32(vdupq_n_f32(3.0f), vdupq_n_f32(2.0f), t));
+            const float32x4_t weight = vbslq_f32(isClose, vsubq_f32(vdupq_n_f32(1.1f), smooth), zero);
+
+            sums[7] = vmlsq_f32(sums[7], weight, dx);
+            sums[8] = vmlsq_f32(sums[8], weight, dy);
+            sums[9] = vmlsq_f32(sums[9], weight, dz);
+        }
+
+        for (int sum = 0; sum < 10; sum++)
+        {
+            vst1q_f32(lanes[sum], sums[sum]);
+        }
+#elif defined(FLOCK_USE_SSE2)
+        const __m128 px   = _mm_set1_ps(location[0]);
+        const __m128 py   = _mm_set1_ps(location[1]);
+        const __m128 pz   = _mm_set1_ps(location[2]);
+        const __m128 one  = _mm_set1_ps(1.0f);
+        __m128       sums[10];
+
+        for (int sum = 0; sum < 10; sum++)
+        {
+            sums[sum] = _mm_setzero_ps();
+        }
+
+        for (int range = 0; range < numberOfRanges; range++)
+        for (unsigned int j = ranges[2 * range]; j + 4 <= ranges[2 * range + 1]; j += 4)
+        {
+            const __m128 x  = _mm_loadu_ps(&sortedX[j]);
+            const __m128 y  = _mm_loadu_ps(&sortedY[j]);
+            const __m128 z  = _mm_loadu_ps(&sortedZ[j]);
+            const __m128 dx = _mm_sub_ps(x, px);
+            const __m128 dy = _mm_sub_ps(y, py);
+            const __m128 dz = _mm_sub_ps(z, pz);
+            const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+
+            const __m128 inRange = _mm_cmplt_ps(d2, _mm_set1_ps(radius2));
+            const __m128 isClose = _mm_cmplt_ps(d2, _mm_set1_ps(separation2));
+
+            sums[0] = _mm_add_ps(sums[0], _mm_and_ps(inRange, one));
+            sums[1] = _mm_add_ps(sums[1], _mm_and_ps(inRange, x));
+            sums[2] = _mm_add_ps(sums[2], _mm_and_ps(inRange, y));
+            sums[3] = _mm_add_ps(sums[3], _mm_and_ps(inRange, z));
+            sums[4] = _mm_add_ps(sums[4], _mm_and_ps(inRange, _mm_loadu_ps(&sortedVX[j])));
+            sums[5] = _mm_add_ps(sums[5], _mm_and_ps(inRange, _mm_loadu_ps(&sortedVY[j])));
+            sums[6] = _mm_add_ps(sums[6], _mm_and_ps(inRange, _mm_loadu_ps(&sortedVZ[j])));
+
+            /* Distance for the smoothstep falloff of the separation. */
+            const __m128 distance = _mm_sqrt_ps(_mm_max_ps(d2, _mm_set1_ps(minimumDistance2)));
+            const __m128 t        = _mm_min_ps(_mm_mul_ps(distance, _mm_set1_ps(inverseSeparation)), one);
+            const __m128 smooth   = _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(t, t)));
+            const __m128 weight   = _mm_and_ps(isClose, _mm_sub_ps(_mm_set1_ps(1.1f), smooth));
+
+            sums[7] = _mm_sub_ps(sums[7], _mm_mul_ps(weight, dx));
+            sums[8] = _mm_sub_ps(sums[8], _mm_mul_ps(weight, dy));
+            sums[9] = _mm_sub_ps(sums[9], _mm_mul_ps(weight, dz));
+        }
+
+        for (int sum = 0; sum < 10; sum++)
+        {
+            _mm_storeu_ps(lanes[sum], sums[sum]);
+        }
+#endif
+
+#if defined(FLOCK_USE_NEON) || defined(FLOCK_USE_SSE2)
+        neighbourhood->count       += lanes[0][0] + lanes[0][1] + lanes[0][2] + lanes[0][3];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            neighbourhood->location[axis]   += lanes[1 + axis][0] + lanes[1 + axis][1] + lanes[1 + axis][2] + lanes[1 + axis][3];
+            neighbourhood->velocity[axis]   += lanes[4 + axis][0] + lanes[4 + axis][1] + lanes[4 + axis][2] + lanes[4 + axis][3];
+            neighbourhood->separation[axis] += lanes[7 + axis][0] + lanes[7 + axis][1] + lanes[7 + axis][2] + lanes[7 + axis][3];
+        }
+#endif
+
+        /* Remaining boids of each range, or all of them without SIMD. */
+        for (int range = 0; range < numberOfRanges; range++)
+#if defined(FLOCK_USE_NEON) || defined(FLOCK_USE_SSE2)
+        for (unsigned int j = ranges[2 * range + 1] - (ranges[2 * range + 1] - ranges[2 * range]) % 4; j < ranges[2 * range + 1]; j++)
+#else
+        for (unsigned int j = ranges[2 * range]; j < ranges[2 * range + 1]; j++)
+#endif
+        {
+            const float dx = sortedX[j] - location[0];
+            const float dy = sortedY[j] - location[1];
+            const float dz = sortedZ[j] - location[2];
+            const float d2 = dx * dx + dy * dy + dz * dz;
+
+            if (d2 < radius2)
+            {
+                neighbourhood->count       += 1.0f;
+                neighbourhood->location[0] += sortedX[j];
+                neighbourhood->location[1] += sortedY[j];
+                neighbourhood->location[2] += sortedZ[j];
+                neighbourhood->velocity[0] += sortedVX[j];
+                neighbourhood->velocity[1] += sortedVY[j];
+                neighbourhood->velocity[2] += sortedVZ[j];
+
+                if (d2 < separation2)
+                {
+                    float t      = sqrtf(d2 > minimumDistance2 ? d2 : minimumDistance2) * inverseSeparation;
+                    t            = t < 1.0f ? t : 1.0f;
+                    float weight = 1.1f - t * t * (3.0f - 2.0f * t);
+
+                    neighbourhood->separation[0] -= weight * dx;
+                    neighbourhood->separation[1] -= weight * dy;
+                    neighbourhood->separation[2] -= weight * dz;
+                }
+            }
+        }
+    }
+
+    void SpatialHashFlock::updateChunk(const Chunk* chunk)
+    {
+        const float* input           = &boids[current][0];
+        float*       output          = &boids[1 - current][0];
+        const float  inverseCellSize = 1.0f / neighbourRadius;
+
+        for (unsigned int sorted = chunk->first; sorted < chunk->end; sorted++)
+        {
+            const unsigned int boid = sortedIds[sorted];
+            const float*       data = input + boid * floatsPerBoid;
+            float*             out  = output + boid * floatsPerBoid;
+
+            if (boid == 0)
+            {
+                /* The leader follows the same closed curve as in movement.vert. */
+                out[0] = 15.0f * cosf(time);
+                out[1] = 15.0f * sinf(time);
+                out[2] = 2.0f * 15.0f * sinf(time / 2.0f);
+                out[3] = 1.0f;
+                out[4] = out[5] = out[6] = out[7] = 0.0f;
+                continue;
+            }
+
+            Neighbourhood neighbourhood;
+            memset(&neighbourhood, 0, sizeof(neighbourhood));
+
+            if (useSpatialHash)
+            {
+                const int    cellX = (int)floorf(data[0] * inverseCellSize);
+                const int    cellY = (int)floorf(data[1] * inverseCellSize);
+                const int    cellZ = (int)floorf(data[2] * inverseCellSize);
+                unsigned int visited[27];
+                unsigned int ranges[2 * 27];
+                int          numberOfVisited = 0;
+
+                for (int z = cellZ - 1; z <= cellZ + 1; z++)
+                for (int y = cellY - 1; y <= cellY + 1; y++)
+                for (int x = cellX - 1; x <= cellX + 1; x++)
+                {
+                    const unsigned int cell = hashCell(x, y, z, tableSize);
+
+                    /* Neighbouring cells may share a table entry, which must only be visited once. */
+                    bool seen = false;
+                    for (int i = 0; i < numberOfVisited; i++)
+                    {
+                        seen = seen || (visited[i] == cell);
+                    }
+                    if (seen)
+                    {
+                        continue;
+                    }
+                    ranges[2 * numberOfVisited]     = cellStart[cell];
+                    ranges[2 * numberOfVisited + 1] = cellStart[cell + 1];
+                    visited[numberOfVisited++]      = cell;
+                }
+
+                gatherNeighbours(ranges, numberOfVisited, data, &neighbourhood);
+            }
+            else
+            {
+                const unsigned int ranges[2] = { 0, numberOfBoids };
+
+                gatherNeighbours(ranges, 1, data, &neighbourhood);
+            }
+
+            /* The boid saw itself: it contributed no separation, but remove it from the averages. */
+            neighbourhood.count -= 1.0f;
+
+            float velocity[3];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                velocity[axis] = data[4 + axis] + neighbourhood.separation[axis];
+
+                if (neighbourhood.count > 0.5f)
+                {
+                    const float center        = (neighbourhood.location[axis] - data[axis]) / neighbourhood.count;
+                    const float averageSpeed  = (neighbourhood.velocity[axis] - data[4 + axis]) / neighbourhood.count;
+
+                    /* Fly towards the centre of the neighbours and match their velocity. */
+                    velocity[axis] += (center - data[axis]) / 100.0f;
+                    velocity[axis] += (averageSpeed - data[4 + axis]) / 2.0f;
+                }
+
+                velocity[axis] += (input[axis] - data[axis]) * leaderAttraction;
+            }
+
+            const float speed2 = velocity[0] * velocity[0] + velocity[1] * velocity[1] + velocity[2] * velocity[2];
+            if (speed2 > maximumSpeed * maximumSpeed)
+            {
+                const float scale = maximumSpeed / sqrtf(speed2);
+
+                velocity[0] *= scale;
+                velocity[1] *= scale;
+                velocity[2] *= scale;
+            }
+
+            out[0] = data[0] + velocity[0];
+            out[1] = data[1] + velocity[1];
+            out[2] = data[2] + velocity[2];
+            out[3] = 1.0f;
+            out[4] = velocity[0];
+            out[5] = velocity[1];
+            out[6] = velocity[2];
+            out[7] = 0.0f;
+        }
+    }
+}
@@ -0,0 +1,145 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef SPATIAL_HASH_FLOCK_H
+#define SPATIAL_HASH_FLOCK_H
+
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief CPU reference implementation of the large flock simulation.
+     *
+     * Each follower steers towards the centre and average velocity of the boids within
+     * neighbourRadius, away from boids closer than separationDistance, and slightly towards
+     * the leader, which flies along the same closed curve as in movement.vert.
+     *
+     * Neighbours are found either by testing every pair of boids, which is O(N^2), or through
+     * a uniform grid with cells of neighbourRadius, hashed into a table and built with a
+     * counting sort, so that only the 27 cells around a boid have to be visited.
+     * Both give the same neighbour set. The pair tests are vectorised (NEON or SSE2 where
+     * available) and the boids are split between threads. The same rules are implemented by
+     * the flock_*.comp compute shaders.
+     *
+     * Boids are stored like in the GPU buffers: 8 floats per boid, location followed by velocity.
+     */
+    class SpatialHashFlock
+    {
+    public:
+        /** Radius within which boids see each other. Also the size of a grid cell. */
+        static const float neighbourRadius;
+        /** Boids closer than this push each other away. */
+        static const float separationDistance;
+        /** Weight of the steering towards the leader. */
+        static const float leaderAttraction;
+        /** Maximum distance a boid can fly in one step. */
+        static const float maximumSpeed;
+
+        /**
+         * \brief Create a flock.
+         * \param[in] numberOfBoids   Number of boids, including the leader. Must be at least 1.
+         * \param[in] numberOfThreads Number of threads used for each step. Values below 1 are treated as 1.
+         */
+        SpatialHashFlock(unsigned int numberOfBoids, unsigned int numberOfThreads);
+
+        /**
+         * \brief Replace the state of all boids.
+         * \param[in] boids 8 floats per boid: xyzw location, then xyzw velocity.
+         */
+        void setBoids(const float* boids);
+
+        /**
+         * \brief Read access to the current state of the boids, laid out as in setBoids().
+         */
+        const float* getBoids() const { return &boids[current][0]; }
+
+        /**
+         * \brief Advance the simulation by one step.
+         * \param[in] time          Time used to place the leader on its path.
+         * \param[in] useSpatialHash Find neighbours through the grid if true, by testing all pairs otherwise.
+         */
+        void step(float time, bool useSpatialHash);
+
+        /**
+         * \brief Number of boids in the flock.
+         */
+        unsigned int getNumberOfBoids() const { return numberOfBoids; }
+
+        /**
+         * \brief Number of entries in the cell hash table used for a flock of the given size.
+         *
+         * The compute path uses the same table size, so that both paths group boids identically.
+         */
+        static unsigned int getHashTableSize(unsigned int numberOfBoids);
+
+        /**
+         * \brief Index of the hash table entry holding the grid cell which contains a point.
+         */
+        static unsigned int hashCell(int x, int y, int z, unsigned int tableSize);
+
+    private:
+        /** Range of boids handed to a worker thread. */
+        struct Chunk
+        {
+            SpatialHashFlock* flock;
+            unsigned int      first;
+            unsigned int      end;
+        };
+
+        /** Sums over the neighbours of one boid. */
+        struct Neighbourhood
+        {
+            float location[3];
+            float velocity[3];
+            float separation[3];
+            float count;
+        };
+
+        unsigned int         numberOfBoids;
+        unsigned int         numberOfThreads;
+        unsigned int         tableSize;
+        unsigned int         current;
+        float                time;
+        bool                 useSpatialHash;
+
+        std::vector<float>   boids[2];
+
+        /* Boids in the order they are visited, as structure of arrays for vectorisation. */
+        std::vector<float>   sortedX;
+        std::vector<float>   sortedY;
+        std::vector<float>   sortedZ;
+        std::vector<float>   sortedVX;
+        std::vector<float>   sortedVY;
+        std::vector<float>   sortedVZ;
+        std::vector<unsigned int> sortedIds;
+
+        std::vector<unsigned int> boidCells;
+        std::vector<unsigned int> cellStart;
+        std::vector<Chunk>   chunks;
+
+        void sortBoids();
+        void runChunks();
+        static void chunkEntry(void* argument);
+        void updateChunk(const Chunk* chunk);
+        void gatherNeighbours(const unsigned int* ranges, int numberOfRanges, const float* location, Neighbourhood* neighbourhood) const;
+    };
+}
+#endif /* SPATIAL_HASH_FLOCK_H */
@@ -49,6 +49,11 @@ public class Boids extends Activity
         extractAsset("movement.frag");
         extractAsset("movement.vert");
         extractAsset("vertex_shader_source.vert");
+        extractAsset("flock_instanced.vert");
+        extractAsset("flock_hash.comp");
+        extractAsset("flock_scan.comp");
+        extractAsset("flock_scatter.comp");
+        extractAsset("flock_update.comp");
 
         /* [onCreateNew] */
         setContentView(tutorialView);
@@ -21,37 +21,43 @@
 #ifndef ETCTEXTURE_H
 #define ETCTEXTURE_H
 
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
+
 namespace MaliSDK
 {
     /** Name of a fragment shader file. */
-    #define FRAGMENT_SHADER_FILE_NAME                                      ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/fragment_shader_source.frag")
+    #define FRAGMENT_SHADER_FILE_NAME                                      (BASE_ASSET_PATH "fragment_shader_source.frag")
     /** Name of a fragment shader file that will be used to render text. */
-    #define FONT_FRAGMENT_SHADER_FILE_NAME                                 ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/font.frag")
+    #define FONT_FRAGMENT_SHADER_FILE_NAME                                 (BASE_ASSET_PATH "font.frag")
     /** Name of a image file that will be used to render text. */
-    #define FONT_TEXTURE_FILE_NAME                                         ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/font.raw")
+    #define FONT_TEXTURE_FILE_NAME                                         (BASE_ASSET_PATH "font.raw")
     /** Name of a vertex shader file that will be used to render text. */
-    #define FONT_VERTEX_SHADER_FILE_NAME                                   ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/font.vert")
+    #define FONT_VERTEX_SHADER_FILE_NAME                                   (BASE_ASSET_PATH "font.vert")
     /** Name of a GL_COMPRESSED_R11_EAC texture file. */
-    #define TEXTURE_GL_COMPRESSED_R11_EAC_FILE_NAME                        ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/HeightMap.pkm")
+    #define TEXTURE_GL_COMPRESSED_R11_EAC_FILE_NAME                        (BASE_ASSET_PATH "HeightMap.pkm")
     /** Name of a GL_COMPRESSED_SIGNED_R11_EAC texture file. */
-    #define TEXTURE_GL_COMPRESSED_SIGNED_R11_EAC_FILE_NAME                 ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/HeightMapSigned.pkm")
+    #define TEXTURE_GL_COMPRESSED_SIGNED_R11_EAC_FILE_NAME                 (BASE_ASSET_PATH "HeightMapSigned.pkm")
     /** Name of a GL_COMPRESSED_RG11_EAC texture file. */
-    #define TEXTURE_GL_COMPRESSED_RG11_EAC_FILE_NAME                       ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/BumpMap.pkm")
+    #define TEXTURE_GL_COMPRESSED_RG11_EAC_FILE_NAME                       (BASE_ASSET_PATH "BumpMap.pkm")
     /** Name of a GL_COMPRESSED_SIGNED_RG11_EAC texture file. */
-    #define TEXTURE_GL_COMPRESSED_SIGNED_RG11_EAC_FILE_NAME                ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/BumpMapSigned.pkm")
+    #define TEXTURE_GL_COMPRESSED_SIGNED_RG11_EAC_FILE_NAME                (BASE_ASSET_PATH "BumpMapSigned.pkm")
     /** Name of a GL_COMPRESSED_RGB8_ETC2 texture file. */
-    #define TEXTURE_GL_COMPRESSED_RGB8_ETC2_FILE_NAME                      ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/Texture.pkm")
+    #define TEXTURE_GL_COMPRESSED_RGB8_ETC2_FILE_NAME                      (BASE_ASSET_PATH "Texture.pkm")
     /** Name of a GL_COMPRESSED_SRGB8_ETC2 texture file. */
-    #define TEXTURE_GL_COMPRESSED_SRGB8_ETC2_FILE_NAME                     ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/Texture.pkm")
+    #define TEXTURE_GL_COMPRESSED_SRGB8_ETC2_FILE_NAME                     (BASE_ASSET_PATH "Texture.pkm")
     /** Name of a GL_COMPRESSED_RGBA8_ETC2_EAC texture file. */
-    #define TEXTURE_GL_COMPRESSED_RGBA8_ETC2_EAC_FILE_NAME                 ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/SemiAlpha.pkm")
+    #define TEXTURE_GL_COMPRESSED_RGBA8_ETC2_EAC_FILE_NAME                 (BASE_ASSET_PATH "SemiAlpha.pkm")
     /** Name of a GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EA texture file. */
-    #define TEXTURE_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC_FILE_NAME          ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/SemiAlpha.pkm")
+    #define TEXTURE_GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC_FILE_NAME          (BASE_ASSET_PATH "SemiAlpha.pkm")
     /** Name of a GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 texture file. */
-    #define TEXTURE_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2_FILE_NAME  ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/BinaryAlpha.pkm")
+    #define TEXTURE_GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2_FILE_NAME  (BASE_ASSET_PATH "BinaryAlpha.pkm")
     /** Name of a GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2 texture file. */
-    #define TEXTURE_GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/BinaryAlpha.pkm")
+    #define TEXTURE_GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2_FILE_NAME (BASE_ASSET_PATH "BinaryAlpha.pkm")
     /** Name of a vertex shader file. */
-    #define VERTEX_SHADER_FILE_NAME                                        ("/data/data/com.arm.malideveloper.openglessdk.etcTexture/files/vertex_shader_source.vert")
+    #define VERTEX_SHADER_FILE_NAME                                        (BASE_ASSET_PATH "vertex_shader_source.vert")
 }
 #endif /* ETCTEXTURE_H */
@@ -43,8 +43,10 @@
  *                                                 textures with binary alpha values.
  * - GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2: sRGB version of GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2.
  */
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
 #include "Common.h"
@@ -55,6 +57,8 @@
 #include "Text.h"
 #include "Texture.h"
 #include "Timer.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace MaliSDK;
 
@@ -461,6 +465,7 @@ void uninit()
     }
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcTexture_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -484,5 +489,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcTexture_NativeL
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_etcTexture_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("EtcTexture", setupGraphics, renderFrame)
@@ -55,22 +55,14 @@
 
 #include "model3d.h"
 
+#include "GLCheck.h"
 #include "Matrix.h"
+#include "Profiler.h"
 
 #define LOG_TAG "Foveated_Sample"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-#define GL_CHECK(x)                                                                              \
-    x;                                                                                           \
-    {                                                                                            \
-        GLenum glError = glGetError();                                                           \
-        if(glError != GL_NO_ERROR) {                                                             \
-            LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1);                                                                             \
-        }                                                                                        \
-    }
-
 using namespace MaliSDK;
 GLuint fboWidth;
 GLuint fboHeight;
@@ -917,5 +909,6 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_foveatedrendering_
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_foveatedrendering_NativeLibrary_step(
 		JNIEnv * env, jobject obj )
 {
+	MaliSDK::ProfileFrame profileFrame;
 	renderFrame();
 }
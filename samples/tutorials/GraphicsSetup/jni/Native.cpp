@@ -21,6 +21,7 @@
 #include <jni.h>
 #include <android/log.h>
 #include <unistd.h>
+#include "Profiler.h"
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -46,6 +47,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_graphicssetup_Nati
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_graphicssetup_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     /* Sleeping to avoid thrashing the Android log. */
     sleep(5);
     LOGI("New Frame Ready to be Drawn!!!!");
@@ -44,8 +44,10 @@
  *        Common elements for both classes are placed in an abstract Torus class.
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <cstdlib>
 #include <cmath>
@@ -59,12 +61,18 @@
 #include "Shader.h"
 #include "Torus.h"
 #include "WireframeTorus.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace std;
 using namespace MaliSDK;
 
 /* Asset directories and filenames */
+#if defined(ANDROID)
 const string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.instancedTessellation/files/";
+#else
+const string resourceDirectory = ASSET_DIRECTORY;
+#endif
 
 /* Window properties. */
 int windowWidth  = 0;
@@ -164,6 +172,7 @@ void uninit()
     delete solidTorus;
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancedTessellation_NativeLibrary_init  (JNIEnv*, jobject,
@@ -182,6 +191,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancedTessellat
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancedTessellation_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
 
@@ -189,3 +199,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancedTessellat
 {
     uninit();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("InstancedTessellation", setupGraphics, renderFrame)
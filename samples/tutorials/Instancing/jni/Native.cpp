@@ -27,8 +27,10 @@
  * By using gl_instanceID in the shader, each of the cubes can have a different position, rotation speed and colour.
  * This technique can be used everywhere repeated geometry is used in a scene.
  */
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
 #include "Common.h"
@@ -37,6 +39,8 @@
 #include "Shader.h"
 #include "Timer.h"
 #include <cstring>
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace MaliSDK;
 
@@ -430,6 +434,7 @@ void uninit()
     }
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancing_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -453,5 +458,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancing_NativeL
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_instancing_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Instancing", setupGraphics, renderFrame)
@@ -0,0 +1,44 @@
+#version 300 es
+
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+precision highp float;
+precision highp usampler2D;
+
+/* UV coordinates received from vertex shader. */
+in vec2 fragmentTexCoord;
+
+/* Sampler holding the packed cells written by the automaton compute shader, 32 cells per texel. */
+uniform usampler2D cellsTexture;
+/* Number of cells in a row and number of rows. */
+uniform uvec2      cellsSize;
+
+/* Output variable. */
+out vec4 fragColor;
+
+void main()
+{
+    /* The initial row is drawn at the top of the screen, as in the ping-pong rendering. */
+    uvec2 cell = min(uvec2(vec2(fragmentTexCoord.x, 1.0 - fragmentTexCoord.y) * vec2(cellsSize)), cellsSize - 1u);
+    uint  word = texelFetch(cellsTexture, ivec2(cell.x >> 5u, cell.y), 0).r;
+
+    fragColor = vec4(float((word >> (cell.x & 31u)) & 1u));
+}
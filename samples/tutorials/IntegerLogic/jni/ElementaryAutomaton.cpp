@@ -0,0 +1,198 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ElementaryAutomaton.h"
+
+#include "Common.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUTOMATON_USE_NEON 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define AUTOMATON_USE_SSE2 1
+#endif
+
+namespace
+{
+    /** Bitwise select: bits of b where s is set, bits of a elsewhere. */
+    inline uint64_t select(uint64_t s, uint64_t a, uint64_t b)
+    {
+        return a ^ ((a ^ b) & s);
+    }
+
+#if defined(AUTOMATON_USE_NEON)
+    inline uint64x2_t select(uint64x2_t s, uint64x2_t a, uint64x2_t b)
+    {
+        return vbslq_u64(s, b, a);
+    }
+#elif defined(AUTOMATON_USE_SSE2)
+    inline __m128i select(__m128i s, __m128i a, __m128i b)
+    {
+        return _mm_xor_si128(a, _mm_and_si128(_mm_xor_si128(a, b), s));
+    }
+#endif
+}
+
+namespace MaliSDK
+{
+    ElementaryAutomaton::ElementaryAutomaton(unsigned int width, unsigned int height)
+        : width(width < 1 ? 1 : width)
+        , height(height < 1 ? 1 : height)
+    {
+        wordsPerRow = (this->width + 63) / 64;
+        rowStride   = wordsPerRow + 2;
+
+        words.resize(rowStride * this->height, 0);
+
+        setRule(30);
+    }
+
+    void ElementaryAutomaton::setRule(unsigned int rule)
+    {
+        ASSERT(rule < 256, "Elementary cellular automaton rules are numbered 0 .. 255.");
+
+        for (unsigned int neighbourhood = 0; neighbourhood < 8; neighbourhood++)
+        {
+            ruleMasks[neighbourhood] = ((rule >> neighbourhood) & 1) ? ~(uint64_t)0 : 0;
+        }
+    }
+
+    void ElementaryAutomaton::setInitialRow(const unsigned char* cells)
+    {
+        uint64_t* row = &words[1];
+
+        for (unsigned int word = 0; word < wordsPerRow; word++)
+        {
+            row[word] = 0;
+        }
+        for (unsigned int x = 0; x < width; x++)
+        {
+            if (cells[x] != 0)
+            {
+                row[x / 64] |= (uint64_t)1 << (x % 64);
+            }
+        }
+
+        fillEdges(row);
+    }
+
+    void ElementaryAutomaton::run()
+    {
+        for (unsigned int y = 1; y < height; y++)
+        {
+            step(&words[(y - 1) * rowStride + 1], &words[y * rowStride + 1]);
+        }
+    }
+
+    bool ElementaryAutomaton::getCell(unsigned int x, unsigned int y) const
+    {
+        return (getRow(y)[x / 64] >> (x % 64)) & 1;
+    }
+
+    /*
+     * Clamp to edge: the guard word before the row provides cell 0 as the left neighbour of cell 0,
+     * the bits past the last cell and the guard word after the row provide the last cell as its own
+     * right neighbour.
+     */
+    void ElementaryAutomaton::fillEdges(uint64_t* row) const
+    {
+        const unsigned int lastBit  = (width - 1) % 64;
+        const uint64_t     usedBits = ((uint64_t)2 << lastBit) - 1;
+        uint64_t&          lastWord = row[wordsPerRow - 1];
+
+        if ((lastWord >> lastBit) & 1)
+        {
+            lastWord |= ~usedBits;
+        }
+        else
+        {
+            lastWord &= usedBits;
+        }
+
+        row[-1]          = (row[0] & 1) << 63;
+        row[wordsPerRow] = lastWord >> 63;
+    }
+
+    /*
+     * For every word, the left and right neighbours of its 64 cells are the word shifted by one bit,
+     * with the missing bit taken from the adjacent word. The new state is then picked out of the
+     * rule's eight bits by a three level select on the right, centre and left neighbours.
+     */
+    void ElementaryAutomaton::step(const uint64_t* source, uint64_t* destination) const
+    {
+        /* source[word - 1] and source[word + 1], without unsigned wrap-around for the first word. */
+        const uint64_t* previous = source - 1;
+        const uint64_t* next     = source + 1;
+        unsigned int    word     = 0;
+
+#if defined(AUTOMATON_USE_NEON)
+        uint64x2_t masks[8];
+        for (int neighbourhood = 0; neighbourhood < 8; neighbourhood++)
+        {
+            masks[neighbourhood] = vdupq_n_u64(ruleMasks[neighbourhood]);
+        }
+
+        for (; word + 2 <= wordsPerRow; word += 2)
+        {
+            uint64x2_t centre = vld1q_u64(&source[word]);
+            uint64x2_t left   = vorrq_u64(vshlq_n_u64(centre, 1), vshrq_n_u64(vld1q_u64(&previous[word]), 63));
+            uint64x2_t right  = vorrq_u64(vshrq_n_u64(centre, 1), vshlq_n_u64(vld1q_u64(&next[word]), 63));
+
+            uint64x2_t leftClear = select(centre, select(right, masks[0], masks[1]), select(right, masks[2], masks[3]));
+            uint64x2_t leftSet   = select(centre, select(right, masks[4], masks[5]), select(right, masks[6], masks[7]));
+
+            vst1q_u64(&destination[word], select(left, leftClear, leftSet));
+        }
+#elif defined(AUTOMATON_USE_SSE2)
+        __m128i masks[8];
+        for (int neighbourhood = 0; neighbourhood < 8; neighbourhood++)
+        {
+            masks[neighbourhood] = _mm_set1_epi64x((long long)ruleMasks[neighbourhood]);
+        }
+
+        for (; word + 2 <= wordsPerRow; word += 2)
+        {
+            __m128i centre = _mm_loadu_si128((const __m128i*)&source[word]);
+            __m128i left   = _mm_or_si128(_mm_slli_epi64(centre, 1), _mm_srli_epi64(_mm_loadu_si128((const __m128i*)&previous[word]), 63));
+            __m128i right  = _mm_or_si128(_mm_srli_epi64(centre, 1), _mm_slli_epi64(_mm_loadu_si128((const __m128i*)&next[word]), 63));
+
+            __m128i leftClear = select(centre, select(right, masks[0], masks[1]), select(right, masks[2], masks[3]));
+            __m128i leftSet   = select(centre, select(right, masks[4], masks[5]), select(right, masks[6], masks[7]));
+
+            _mm_storeu_si128((__m128i*)&destination[word], select(left, leftClear, leftSet));
+        }
+#endif
+
+        for (; word < wordsPerRow; word++)
+        {
+            uint64_t centre = source[word];
+            uint64_t left   = (centre << 1) | (previous[word] >> 63);
+            uint64_t right  = (centre >> 1) | (next[word] << 63);
+
+            uint64_t leftClear = select(centre, select(right, ruleMasks[0], ruleMasks[1]), select(right, ruleMasks[2], ruleMasks[3]));
+            uint64_t leftSet   = select(centre, select(right, ruleMasks[4], ruleMasks[5]), select(right, ruleMasks[6], ruleMasks[7]));
+
+            destination[word] = select(left, leftClear, leftSet);
+        }
+
+        fillEdges(destination);
+    }
+}
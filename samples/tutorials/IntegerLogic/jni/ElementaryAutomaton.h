@@ -0,0 +1,110 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef ELEMENTARY_AUTOMATON_H
+#define ELEMENTARY_AUTOMATON_H
+
+#include <stdint.h>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Bit-packed CPU implementation of an elementary (1D, two state, three neighbour) cellular automaton.
+     *
+     * Cell x of a row is stored in bit (x % 64) of 64-bit word (x / 64), so one word holds 64 cells and
+     * a generation is computed with a handful of shifts and bitwise operations per word, two words at a
+     * time with NEON or SSE2 where available. Any of the 256 Wolfram rules can be used.
+     *
+     * Cells outside of the row take the value of the nearest edge cell, which is what the tutorial gets
+     * from sampling its ping and pong textures with GL_CLAMP_TO_EDGE, so Rule 30 gives the same picture.
+     * The same layout and edge handling are used by IntegerLogic_Automaton_shader.comp, so on a little
+     * endian CPU the rows can be uploaded as they are to the R32UI texture written by the compute shader.
+     */
+    class ElementaryAutomaton
+    {
+    public:
+        /**
+         * \brief Create an automaton with all cells of all rows cleared.
+         * \param[in] width  Number of cells in a row. Must be at least 1.
+         * \param[in] height Number of rows, including the initial row. Must be at least 1.
+         */
+        ElementaryAutomaton(unsigned int width, unsigned int height);
+
+        /**
+         * \brief Select the rule used by run().
+         * \param[in] rule Wolfram code of the rule, 0 .. 255. Bit (4 * left + 2 * centre + right) of the
+         *                 code is the new state of a cell whose neighbourhood is (left, centre, right).
+         */
+        void setRule(unsigned int rule);
+
+        /**
+         * \brief Set the initial row.
+         * \param[in] cells width bytes, a non-zero byte being a live cell. The tutorial's R8UI texture rows can be passed directly.
+         */
+        void setInitialRow(const unsigned char* cells);
+
+        /**
+         * \brief Compute rows 1 .. height - 1 from the initial row.
+         */
+        void run();
+
+        /**
+         * \brief State of a single cell.
+         * \param[in] x Column, 0 .. width - 1.
+         * \param[in] y Row, 0 .. height - 1. Row 0 is the initial row.
+         */
+        bool getCell(unsigned int x, unsigned int y) const;
+
+        /**
+         * \brief Packed words of a row. Bits past the last cell replicate the last cell.
+         * \param[in] y Row, 0 .. height - 1.
+         */
+        const uint64_t* getRow(unsigned int y) const { return &words[y * rowStride + 1]; }
+
+        /**
+         * \brief Distance in words between consecutive rows returned by getRow().
+         */
+        unsigned int getRowStride() const { return rowStride; }
+
+        /**
+         * \brief Number of 64-bit words holding the cells of one row.
+         */
+        unsigned int getWordsPerRow() const { return wordsPerRow; }
+
+        unsigned int getWidth()  const { return width; }
+        unsigned int getHeight() const { return height; }
+
+    private:
+        unsigned int width;
+        unsigned int height;
+        unsigned int wordsPerRow;
+        /* Every row is surrounded by one guard word on each side, holding the clamped edge cells. */
+        unsigned int rowStride;
+        /* Bit p of the rule, 0 or ~0, for the 8 neighbourhoods p. */
+        uint64_t     ruleMasks[8];
+
+        std::vector<uint64_t> words;
+
+        void fillEdges(uint64_t* row) const;
+        void step(const uint64_t* source, uint64_t* destination) const;
+    };
+}
+#endif /* ELEMENTARY_AUTOMATON_H */
@@ -21,6 +21,12 @@
 #ifndef INTEGER_LOGIC_H
 #define INTEGER_LOGIC_H
 
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.integerLogic/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
+
 #include "VectorTypes.h"
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
@@ -28,13 +34,17 @@
 namespace MaliSDK
 {
     /* Name of the file in which "rule 30" vertex shader's body is located. */
-    #define  VERTEX_RULE_30_SHADER_FILENAME ("/data/data/com.arm.malideveloper.openglessdk.integerLogic/files/IntegerLogic_Rule30_shader.vert")
+    #define  VERTEX_RULE_30_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Rule30_shader.vert")
     /* Name of the file in which "merge" vertex shader's body is located. */
-    #define  VERTEX_MERGE_SHADER_FILENAME ("/data/data/com.arm.malideveloper.openglessdk.integerLogic/files/IntegerLogic_Merge_shader.vert")
+    #define  VERTEX_MERGE_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Merge_shader.vert")
     /* Name of the file in which "rule 30" fragment shader's body is located. */
-    #define  FRAGMENT_RULE_30_SHADER_FILENAME ("/data/data/com.arm.malideveloper.openglessdk.integerLogic/files/IntegerLogic_Rule30_shader.frag")
+    #define  FRAGMENT_RULE_30_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Rule30_shader.frag")
     /* Name of the file in which "merge" fragment shader's body is located. */
-    #define  FRAGMENT_MERGE_SHADER_FILENAME ("/data/data/com.arm.malideveloper.openglessdk.integerLogic/files/IntegerLogic_Merge_shader.frag")
+    #define  FRAGMENT_MERGE_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Merge_shader.frag")
+    /* Name of the file in which the bit-packed automaton compute shader's body is located. */
+    #define  COMPUTE_AUTOMATON_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Automaton_shader.comp")
+    /* Name of the file in which "unpack" fragment shader's body is located. */
+    #define  FRAGMENT_UNPACK_SHADER_FILENAME (BASE_ASSET_PATH "IntegerLogic_Unpack_shader.frag")
 
     /* Structure storing locations of attributes and uniforms for merge program. */
     struct MergeProgramLocations
@@ -78,6 +88,36 @@ namespace MaliSDK
         }
     };
 
+    /* Structure storing locations of uniforms for the bit-packed automaton compute program. */
+    struct AutomatonProgramLocations
+    {
+        GLint ruleLocation;
+        GLint widthLocation;
+        GLint heightLocation;
+
+        AutomatonProgramLocations()
+        {
+            ruleLocation   = -1;
+            widthLocation  = -1;
+            heightLocation = -1;
+        }
+    };
+
+    /* Structure storing locations of uniforms for unpack program. */
+    struct UnpackProgramLocations
+    {
+        GLint mvpMatrixLocation;
+        GLint cellsTextureLocation;
+        GLint cellsSizeLocation;
+
+        UnpackProgramLocations()
+        {
+            mvpMatrixLocation    = -1;
+            cellsTextureLocation = -1;
+            cellsSizeLocation    = -1;
+        }
+    };
+
     /*
      * Vertex array, storing coordinates for a single line filling whole row.
      * The 4th coordinate is set to 0.5 to reduce clip coordinates to [-0.5, 0.5].
@@ -39,14 +39,23 @@
  *        For the first run, the input line has only one pixel lit, so it generates
  *        the commonly known Rule 30 pattern. Then, every 5 seconds, textures are reset
  *        and the input is randomly generated.
+ *
+ *        Drawing a line per row costs a draw call and a framebuffer attachment change per row.
+ *        The automatonMode setting selects an alternative which stores 32 cells per texel of an R32UI
+ *        texture and generates all the rows with a single compute shader dispatch (OpenGL ES 3.1),
+ *        or on the CPU with 64 cells per word, for any elementary rule.
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
+#include <GLES3/gl31.h>
 #include "Common.h"
 #include "CubeModel.h"
+#include "ElementaryAutomaton.h"
 #include "Mathematics.h"
 #include "Matrix.h"
 #include "PlaneModel.h"
@@ -55,6 +64,9 @@
 #include "Texture.h"
 #include "Timer.h"
 #include <cstring>
+#include <vector>
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace MaliSDK;
 
@@ -109,6 +121,40 @@ Timer timer;
 /* Time interval in seconds. */
 const float timeInterval = 5.0f;
 
+/* Bit-packed automaton. */
+/* Ways of generating the rows. */
+enum AutomatonMode
+{
+    AUTOMATON_PING_PONG, /* The tutorial: Rule 30, one row per draw call, alternating between the ping and pong textures. */
+    AUTOMATON_COMPUTE,   /* 32 cells per uint, all rows generated by a single compute shader dispatch. */
+    AUTOMATON_CPU        /* 64 cells per word, generated on the CPU by ElementaryAutomaton and uploaded every frame. */
+};
+/* Way of generating the rows. AUTOMATON_COMPUTE requires OpenGL ES 3.1. */
+const AutomatonMode automatonMode = AUTOMATON_PING_PONG;
+/* Wolfram code of the rule followed by the bit-packed modes, 0 .. 255. The ping-pong rendering always follows Rule 30. */
+const unsigned int automatonRule = 30;
+/* If true, all the modes are timed for several rules on startup, and the results are logged. */
+const bool runAutomatonBenchmark = false;
+/* Rules used by the benchmark. */
+const unsigned int benchmarkAutomatonRules[] = {30, 90, 110, 184};
+/* Must match MAX_WORDS in IntegerLogic_Automaton_shader.comp. */
+const unsigned int maximumAutomatonWords = 1024;
+/* Texture unit used for the packed cells texture. */
+const GLuint cellsTextureUnit = 2;
+
+/* ID assigned by GL ES for the bit-packed automaton compute program. */
+GLuint automatonProgramID = 0;
+/* ID assigned by GL ES for "unpack" program, drawing the packed cells to the screen. */
+GLuint unpackProgramID    = 0;
+/* ID of the R32UI texture holding the packed cells, (windowWidth + 31) / 32 texels per row. */
+GLuint cellsTextureID     = 0;
+/* Automaton program locations. */
+AutomatonProgramLocations automatonProgramLocations;
+/* Unpack program locations. */
+UnpackProgramLocations    unpackProgramLocations;
+/* Packs the initial row for both modes, and generates the other rows in AUTOMATON_CPU mode. */
+ElementaryAutomaton*      packedAutomaton = NULL;
+
 
 /**
  * \brief Generates input for Rule 30 Cellular Automaton, setting a white dot in the top line of the texture
@@ -156,6 +202,12 @@ void setupGraphics(int width, int height);
 /* Perform a clean up. */
 void uninit();
 
+/* Creates the packed cells texture and the programs of the bit-packed modes. */
+void setupPackedAutomaton();
+
+/* Generates and draws the rows of the bit-packed modes. */
+void renderPackedAutomaton();
+
 /* [Generate input texture data] */
 /* Please see the specification above. */
 void generateRule30Input(unsigned int xoffset,
@@ -275,6 +327,279 @@ void renderToBackBuffer()
 }
 /* [Perform textures' merging] */
 
+/**
+ * \brief Upload the first rows of packedAutomaton to the packed cells texture.
+ *
+ * On a little endian CPU, every 64-bit word of a row is two consecutive texels, so the rows are
+ * uploaded as they are. The guard words between the rows are skipped with GL_UNPACK_ROW_LENGTH.
+ *
+ * \param[in] numberOfRows Number of rows to upload, starting from the initial row.
+ */
+void uploadPackedRows(unsigned int numberOfRows)
+{
+    GL_CHECK(glActiveTexture(GL_TEXTURE0 + cellsTextureUnit));
+    GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                             cellsTextureID));
+    GL_CHECK(glPixelStorei  (GL_UNPACK_ROW_LENGTH,
+                             packedAutomaton->getRowStride() * 2));
+    GL_CHECK(glTexSubImage2D(GL_TEXTURE_2D,
+                             0,
+                             0,
+                             0,
+                             (windowWidth + 31) / 32,
+                             numberOfRows,
+                             GL_RED_INTEGER,
+                             GL_UNSIGNED_INT,
+                             packedAutomaton->getRow(0)));
+    GL_CHECK(glPixelStorei  (GL_UNPACK_ROW_LENGTH,
+                             0));
+}
+
+/* [Dispatch the automaton compute shader] */
+/**
+ * \brief Generate all rows of the packed cells texture with a single compute shader dispatch.
+ *
+ * The initial row must already be in the texture. A single work group is used, which loops over the rows.
+ *
+ * \param[in] rule Wolfram code of the rule to follow.
+ */
+void runAutomatonOnGPU(unsigned int rule)
+{
+    GL_CHECK(glUseProgram      (automatonProgramID));
+    GL_CHECK(glUniform1ui      (automatonProgramLocations.ruleLocation, rule));
+    GL_CHECK(glBindImageTexture(0, cellsTextureID, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI));
+    GL_CHECK(glDispatchCompute (1, 1, 1));
+
+    /* The rows are read by texelFetch() in the unpack program, or by glReadPixels() in the benchmark. */
+    GL_CHECK(glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_FRAMEBUFFER_BARRIER_BIT));
+}
+/* [Dispatch the automaton compute shader] */
+
+/**
+ * \brief Fill the packed cells texture, starting from the first line of the ping texture data.
+ *
+ * \param[in] mode AUTOMATON_COMPUTE or AUTOMATON_CPU.
+ * \param[in] rule Wolfram code of the rule to follow.
+ */
+void generatePackedRows(AutomatonMode mode, unsigned int rule)
+{
+    /* The first line is stored at the top of the ping texture, see generateRule30Input(). */
+    const unsigned char* initialRow = (const unsigned char*) pingTextureData + (windowHeight - 1) * windowWidth;
+
+    packedAutomaton->setRule(rule);
+    packedAutomaton->setInitialRow(initialRow);
+
+    if (mode == AUTOMATON_CPU)
+    {
+        packedAutomaton->run();
+        uploadPackedRows(windowHeight);
+    }
+    else
+    {
+        uploadPackedRows(1);
+        runAutomatonOnGPU(rule);
+    }
+}
+
+/* Please see the specification above. */
+void renderPackedAutomaton()
+{
+    generatePackedRows(automatonMode, automatonRule);
+
+    GL_CHECK(glUseProgram     (unpackProgramID));
+    GL_CHECK(glBindVertexArray(quadVAOID));
+
+    /* Draw a quad as a triangle strip defined by 4 vertices. */
+    GL_CHECK(glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+}
+
+/**
+ * \brief Compare the packed cells texture with the rows computed by packedAutomaton for the same rule and initial row.
+ *
+ * \return true if all cells are equal.
+ */
+bool packedRowsMatchCPU()
+{
+    const unsigned int  texelsPerRow = (windowWidth + 31) / 32;
+    std::vector<GLuint> texels(texelsPerRow * windowHeight * 4);
+
+    GL_CHECK(glBindFramebuffer     (GL_READ_FRAMEBUFFER,
+                                    framebufferID));
+    GL_CHECK(glFramebufferTexture2D(GL_READ_FRAMEBUFFER,
+                                    GL_COLOR_ATTACHMENT0,
+                                    GL_TEXTURE_2D,
+                                    cellsTextureID,
+                                    0));
+    GL_CHECK(glReadBuffer          (GL_COLOR_ATTACHMENT0));
+    GL_CHECK(glReadPixels          (0,
+                                    0,
+                                    texelsPerRow,
+                                    windowHeight,
+                                    GL_RGBA_INTEGER,
+                                    GL_UNSIGNED_INT,
+                                   &texels[0]));
+    GL_CHECK(glBindFramebuffer     (GL_READ_FRAMEBUFFER,
+                                    0));
+
+    packedAutomaton->run();
+
+    for (int y = 0; y < windowHeight; ++y)
+    {
+        for (int x = 0; x < windowWidth; ++x)
+        {
+            bool gpuCell = ((texels[(y * texelsPerRow + x / 32) * 4] >> (x % 32)) & 1) != 0;
+
+            if (gpuCell != packedAutomaton->getCell(x, y))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Time the ping-pong rendering and both bit-packed modes for several rules, and log the average time per screen.
+ *
+ * The GPU is synchronised with glFinish() around every measurement. The CPU times include uploading the rows.
+ * The ping-pong rendering only implements Rule 30, so it is skipped for the other rules.
+ */
+void benchmarkAutomaton()
+{
+    const int numberOfWarmUpFrames = 2;
+    const int numberOfTimedFrames  = 10;
+
+    LOGI("Automaton benchmark: average time in ms to generate %d x %d cells\n", windowWidth, windowHeight);
+    LOGI("%6s %14s %14s %14s %12s\n", "rule", "ping-pong", "GPU packed", "CPU packed", "GPU == CPU");
+
+    for (size_t ruleIndex = 0; ruleIndex < sizeof(benchmarkAutomatonRules) / sizeof(benchmarkAutomatonRules[0]); ruleIndex++)
+    {
+        const unsigned int rule       = benchmarkAutomatonRules[ruleIndex];
+        float              results[3] = {-1.0f, -1.0f, -1.0f};
+
+        for (int method = 0; method < 3; method++)
+        {
+            if (method == 0 && rule != 30)
+            {
+                continue;
+            }
+
+            float start = 0.0f;
+            for (int frame = 0; frame < numberOfWarmUpFrames + numberOfTimedFrames; frame++)
+            {
+                if (frame == numberOfWarmUpFrames)
+                {
+                    GL_CHECK(glFinish());
+                    start = timer.getTime();
+                }
+
+                if (method == 0)
+                {
+                    performOffscreenRendering();
+                }
+                else
+                {
+                    generatePackedRows(method == 1 ? AUTOMATON_COMPUTE : AUTOMATON_CPU, rule);
+                }
+            }
+            GL_CHECK(glFinish());
+
+            results[method] = 1000.0f * (timer.getTime() - start) / numberOfTimedFrames;
+        }
+
+        generatePackedRows(AUTOMATON_COMPUTE, rule);
+        bool match = packedRowsMatchCPU();
+
+        LOGI("%6u %14.2f %14.2f %14.2f %12s\n", rule, results[0], results[1], results[2], match ? "yes" : "NO");
+    }
+
+    LOGI("Entries of -1 were skipped.\n");
+}
+
+/* Please see the specification above. */
+void setupPackedAutomaton()
+{
+    ASSERT((unsigned int) windowWidth <= maximumAutomatonWords * 32, "Window is too wide for the automaton compute shader.");
+
+    packedAutomaton = new ElementaryAutomaton(windowWidth, windowHeight);
+
+    /* Packed cells texture, written by the compute shader as an image or uploaded from the CPU. */
+    GL_CHECK(glGenTextures  (1, &cellsTextureID));
+    GL_CHECK(glActiveTexture(GL_TEXTURE0 + cellsTextureUnit));
+    GL_CHECK(glBindTexture  (GL_TEXTURE_2D,
+                             cellsTextureID));
+    GL_CHECK(glTexStorage2D (GL_TEXTURE_2D,
+                             1,
+                             GL_R32UI,
+                             (windowWidth + 31) / 32,
+                             windowHeight));
+    GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                             GL_TEXTURE_MAG_FILTER,
+                             GL_NEAREST));
+    GL_CHECK(glTexParameteri(GL_TEXTURE_2D,
+                             GL_TEXTURE_MIN_FILTER,
+                             GL_NEAREST));
+
+    /* The unpack program draws the quad set up for the merge program, so it uses the same attribute locations. */
+    GLuint vertexUnpackShaderID   = 0;
+    GLuint fragmentUnpackShaderID = 0;
+
+    Shader::processShader(&vertexUnpackShaderID,   VERTEX_MERGE_SHADER_FILENAME,    GL_VERTEX_SHADER);
+    Shader::processShader(&fragmentUnpackShaderID, FRAGMENT_UNPACK_SHADER_FILENAME, GL_FRAGMENT_SHADER);
+
+    unpackProgramID = GL_CHECK(glCreateProgram());
+
+    GL_CHECK(glAttachShader      (unpackProgramID, vertexUnpackShaderID));
+    GL_CHECK(glAttachShader      (unpackProgramID, fragmentUnpackShaderID));
+    GL_CHECK(glBindAttribLocation(unpackProgramID, mergeProgramLocations.positionLocation, "position"));
+    GL_CHECK(glBindAttribLocation(unpackProgramID, mergeProgramLocations.texCoordLocation, "vertexTexCoord"));
+    GL_CHECK(glLinkProgram       (unpackProgramID));
+    GL_CHECK(glUseProgram        (unpackProgramID));
+
+    unpackProgramLocations.mvpMatrixLocation    = GL_CHECK(glGetUniformLocation(unpackProgramID, "mvpMatrix")   );
+    unpackProgramLocations.cellsTextureLocation = GL_CHECK(glGetUniformLocation(unpackProgramID, "cellsTexture"));
+    unpackProgramLocations.cellsSizeLocation    = GL_CHECK(glGetUniformLocation(unpackProgramID, "cellsSize")   );
+
+    ASSERT(unpackProgramLocations.mvpMatrixLocation    != -1, "Could not find location of a uniform in unpack program: mvpMatrix");
+    ASSERT(unpackProgramLocations.cellsTextureLocation != -1, "Could not find location of a uniform in unpack program: cellsTexture");
+    ASSERT(unpackProgramLocations.cellsSizeLocation    != -1, "Could not find location of a uniform in unpack program: cellsSize");
+
+    GL_CHECK(glUniformMatrix4fv(unpackProgramLocations.mvpMatrixLocation,
+                                1,
+                                GL_FALSE,
+                                modelViewProjectionMatrix.getAsArray()));
+    GL_CHECK(glUniform1i       (unpackProgramLocations.cellsTextureLocation,
+                                cellsTextureUnit));
+    GL_CHECK(glUniform2ui      (unpackProgramLocations.cellsSizeLocation,
+                                windowWidth,
+                                windowHeight));
+
+    if (automatonMode == AUTOMATON_COMPUTE || runAutomatonBenchmark)
+    {
+        GLuint computeAutomatonShaderID = 0;
+
+        Shader::processShader(&computeAutomatonShaderID, COMPUTE_AUTOMATON_SHADER_FILENAME, GL_COMPUTE_SHADER);
+
+        automatonProgramID = GL_CHECK(glCreateProgram());
+
+        GL_CHECK(glAttachShader(automatonProgramID, computeAutomatonShaderID));
+        GL_CHECK(glLinkProgram (automatonProgramID));
+        GL_CHECK(glUseProgram  (automatonProgramID));
+
+        automatonProgramLocations.ruleLocation   = GL_CHECK(glGetUniformLocation(automatonProgramID, "rule")  );
+        automatonProgramLocations.widthLocation  = GL_CHECK(glGetUniformLocation(automatonProgramID, "width") );
+        automatonProgramLocations.heightLocation = GL_CHECK(glGetUniformLocation(automatonProgramID, "height"));
+
+        ASSERT(automatonProgramLocations.ruleLocation   != -1, "Could not find location of a uniform in automaton program: rule");
+        ASSERT(automatonProgramLocations.widthLocation  != -1, "Could not find location of a uniform in automaton program: width");
+        ASSERT(automatonProgramLocations.heightLocation != -1, "Could not find location of a uniform in automaton program: height");
+
+        GL_CHECK(glUniform1ui(automatonProgramLocations.widthLocation,  windowWidth));
+        GL_CHECK(glUniform1ui(automatonProgramLocations.heightLocation, windowHeight));
+    }
+}
+
 /* Please see the specification above. */
 void setupGraphics(int width, int height)
 {
@@ -565,14 +890,31 @@ void setupGraphics(int width, int height)
     /* Set line width to 1.5, to avoid rounding errors. */
     GL_CHECK(glLineWidth(1.5));
 
+    if (automatonMode != AUTOMATON_PING_PONG || runAutomatonBenchmark)
+    {
+        setupPackedAutomaton();
+
+        if (runAutomatonBenchmark)
+        {
+            benchmarkAutomaton();
+        }
+    }
+
     timer.reset();
 }
 
 /* Please see the specification above. */
 void renderFrame()
 {
-    performOffscreenRendering();
-    renderToBackBuffer();
+    if (automatonMode == AUTOMATON_PING_PONG)
+    {
+        performOffscreenRendering();
+        renderToBackBuffer();
+    }
+    else
+    {
+        renderPackedAutomaton();
+    }
 
     if (timer.getTime()> timeInterval)
     {
@@ -612,8 +954,12 @@ void uninit()
 {
     /* Delete texture data. */
     Texture::deleteTextureData(&pingTextureData);
+
+    delete packedAutomaton;
+    packedAutomaton = NULL;
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_integerLogic_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -637,5 +983,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_integerLogic_Nativ
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_integerLogic_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("IntegerLogic", setupGraphics, renderFrame)
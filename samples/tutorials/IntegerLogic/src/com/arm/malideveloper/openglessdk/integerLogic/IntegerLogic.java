@@ -49,6 +49,8 @@ public class IntegerLogic extends Activity
         extractAsset("IntegerLogic_Merge_shader.vert");
         extractAsset("IntegerLogic_Rule30_shader.frag");
         extractAsset("IntegerLogic_Merge_shader.frag");
+        extractAsset("IntegerLogic_Automaton_shader.comp");
+        extractAsset("IntegerLogic_Unpack_shader.frag");
 
         /* [onCreateNew] */
         setContentView(tutorialView);
@@ -38,8 +38,10 @@
  * luminance of additional edge layers and contrast modifier.
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <cstdlib>
 #include <cmath>
@@ -53,12 +55,18 @@
 #include "Texture.h"
 #include "Timer.h"
 #include "Shader.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace std;
 using namespace MaliSDK;
 
 /* Asset directories and filenames */
+#if defined(ANDROID)
 const string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.minMaxBlending/files/";
+#else
+const string resourceDirectory = ASSET_DIRECTORY;
+#endif
 const string imagesFilename    = "MRbrain";
 
 /* Number of images in resourceDirectory. */
@@ -524,6 +532,7 @@ void uninit()
     GL_CHECK(glDeleteProgram     (programID           ));
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_minMaxBlending_NativeLibrary_init(JNIEnv*, jobject, jint width, jint height);
@@ -538,6 +547,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_minMaxBlending_Nat
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_minMaxBlending_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
 
@@ -545,3 +555,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_minMaxBlending_Nat
 {
     uninit();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("MinMaxBlending", setupGraphics, renderFrame)
@@ -18,9 +18,6 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <jni.h>
-#include <android/log.h>
-
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 
@@ -30,10 +27,25 @@
 
 #include "Matrix.h"
 #include "Texture.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+
+#if defined(ANDROID)
+#include <jni.h>
+#include <android/log.h>
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include "Platform.h"
+#endif
+
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
 
 static const char glVertexShader[] =
         "attribute vec4 vertexPosition;\n"
@@ -196,16 +208,16 @@ bool setupGraphics(int width, int height)
 
 
     /* Load the Texture. */
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level0.raw", 0, 512, 512);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level1.raw", 1, 256, 256);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level2.raw", 2, 128, 128);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level3.raw", 3, 64, 64);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level4.raw", 4, 32, 32);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level5.raw", 5, 16, 16);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level6.raw", 6, 8, 8);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level7.raw", 7, 4, 4);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level8.raw", 8, 2, 2);
-    loadTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level9.raw", 9, 1, 1);
+    loadTexture(BASE_ASSET_PATH "level0.raw", 0, 512, 512);
+    loadTexture(BASE_ASSET_PATH "level1.raw", 1, 256, 256);
+    loadTexture(BASE_ASSET_PATH "level2.raw", 2, 128, 128);
+    loadTexture(BASE_ASSET_PATH "level3.raw", 3, 64, 64);
+    loadTexture(BASE_ASSET_PATH "level4.raw", 4, 32, 32);
+    loadTexture(BASE_ASSET_PATH "level5.raw", 5, 16, 16);
+    loadTexture(BASE_ASSET_PATH "level6.raw", 6, 8, 8);
+    loadTexture(BASE_ASSET_PATH "level7.raw", 7, 4, 4);
+    loadTexture(BASE_ASSET_PATH "level8.raw", 8, 2, 2);
+    loadTexture(BASE_ASSET_PATH "level9.raw", 9, 1, 1);
     /* [mipmapRegularTextures] */
 
     /* [mipmapCompressedTextures] */
@@ -215,16 +227,16 @@ bool setupGraphics(int width, int height)
     /* Bind the texture object. */
     glBindTexture(GL_TEXTURE_2D, textureIds[1]);
 
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level0.pkm", 0);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level1.pkm", 1);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level2.pkm", 2);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level3.pkm", 3);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level4.pkm", 4);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level5.pkm", 5);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level6.pkm", 6);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level7.pkm", 7);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level8.pkm", 8);
-    loadCompressedTexture("/data/data/com.arm.malideveloper.openglessdk.mipmapping/files/level9.pkm", 9);
+    loadCompressedTexture(BASE_ASSET_PATH "level0.pkm", 0);
+    loadCompressedTexture(BASE_ASSET_PATH "level1.pkm", 1);
+    loadCompressedTexture(BASE_ASSET_PATH "level2.pkm", 2);
+    loadCompressedTexture(BASE_ASSET_PATH "level3.pkm", 3);
+    loadCompressedTexture(BASE_ASSET_PATH "level4.pkm", 4);
+    loadCompressedTexture(BASE_ASSET_PATH "level5.pkm", 5);
+    loadCompressedTexture(BASE_ASSET_PATH "level6.pkm", 6);
+    loadCompressedTexture(BASE_ASSET_PATH "level7.pkm", 7);
+    loadCompressedTexture(BASE_ASSET_PATH "level8.pkm", 8);
+    loadCompressedTexture(BASE_ASSET_PATH "level9.pkm", 9);
     /* [mipmapCompressedTextures] */
     return true;
 }
@@ -279,6 +291,7 @@ void renderFrame()
     /* [rangeOfMovement] */
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_mipmapping_NativeLibrary_init (JNIEnv * env, jobject obj, jint width, jint height);
@@ -295,5 +308,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_mipmapping_NativeL
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_mipmapping_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Mipmapping", setupGraphics, renderFrame)
@@ -18,9 +18,6 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <jni.h>
-#include <android/log.h>
-
 #include <GLES3/gl3.h>
 #include <EGL/egl.h>
 
@@ -29,21 +26,21 @@
 #include <math.h>
 #include <cstring>
 
+#include "GLCheck.h"
 #include "Matrix.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+
+#if defined(ANDROID)
+#include <jni.h>
+#include <android/log.h>
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
-
-#define GL_CHECK(x)                                                                              \
-    x;                                                                                           \
-    {                                                                                            \
-        GLenum glError = glGetError();                                                           \
-        if(glError != GL_NO_ERROR) {                                                             \
-            LOGE("glGetError() = %i (0x%.8x) at %s:%i\n", glError, glError, __FILE__, __LINE__); \
-            exit(1);                                                                             \
-        }                                                                                        \
-    }
+#else
+#include "Platform.h"
+#endif
 
 using namespace MaliSDK;
 
@@ -639,6 +636,7 @@ void renderFrame()
     }
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_multiview_NativeLibrary_init(
@@ -656,5 +654,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_multiview_NativeLi
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_multiview_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("Multiview", setupGraphics, renderFrame)
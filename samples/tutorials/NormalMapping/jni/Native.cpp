@@ -18,9 +18,6 @@
  * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
-#include <jni.h>
-#include <android/log.h>
-
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 
@@ -30,10 +27,19 @@
 
 #include "Matrix.h"
 #include "Texture.h"
+#include "Profiler.h"
+#include "Benchmark.h"
+
+#if defined(ANDROID)
+#include <jni.h>
+#include <android/log.h>
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include "Platform.h"
+#endif
 
 /* [vertexShader] */
 static const char glVertexShader[] =
@@ -449,6 +455,7 @@ void renderFrame()
     }
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_normalmapping_NativeLibrary_init (JNIEnv * env, jobject obj, jint width, jint height);
@@ -465,5 +472,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_normalmapping_Nati
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_normalmapping_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("NormalMapping", setupGraphics, renderFrame)
@@ -23,11 +23,22 @@
 #include <GLES2/gl2ext.h>
 #include <cstdio>
 #include <cstdlib>
+
+#if defined(ANDROID)
 #include <android/log.h>
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include "Platform.h"
+#endif
+
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.normalmapping/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
 
 #define TEXTURE_WIDTH   256
 #define TEXTURE_HEIGHT  256
@@ -52,7 +63,7 @@ GLuint loadTexture()
     /* Bind the texture object. */
     glBindTexture(GL_TEXTURE_2D, textureId);
 
-    FILE * theFile = fopen("/data/data/com.arm.malideveloper.openglessdk.normalmapping/files/normalMap256.raw", "r");
+    FILE * theFile = fopen(BASE_ASSET_PATH "normalMap256.raw", "r");
 
     if(theFile == NULL)
     {
@@ -0,0 +1,120 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "BoundingVolumeHierarchy.h"
+#include "Common.h"
+
+#include <algorithm>
+
+namespace MaliSDK
+{
+    /** \brief Orders object indices along one axis of their positions. */
+    struct PositionComparator
+    {
+        const Vec2f* positions;
+        bool         alongX;
+
+        bool operator()(int first, int second) const
+        {
+            return alongX ? positions[first].x < positions[second].x
+                          : positions[first].y < positions[second].y;
+        }
+    };
+
+    void BoundingVolumeHierarchy::build(const Vec2f* positions, int numberOfObjects, float halfExtent)
+    {
+        ASSERT(positions       != NULL, "Cannot build a hierarchy from a null pointer.");
+        ASSERT(numberOfObjects >  0,    "Cannot build a hierarchy without objects.");
+
+        this->positions  = positions;
+        this->halfExtent = halfExtent;
+
+        objects.resize(numberOfObjects);
+
+        for (int i = 0; i < numberOfObjects; i++)
+        {
+            objects[i] = i;
+        }
+
+        nodes.clear();
+        nodes.reserve(2 * numberOfObjects - 1);
+
+        buildNode(0, numberOfObjects);
+    }
+
+    int BoundingVolumeHierarchy::buildNode(int firstObject, int endObject)
+    {
+        const int nodeIndex = (int)nodes.size();
+        Node      node;
+
+        node.minimum.x   = positions[objects[firstObject]].x;
+        node.minimum.y   = positions[objects[firstObject]].y;
+        node.maximum     = node.minimum;
+        node.children[0] = -1;
+        node.children[1] = -1;
+        node.object      = -1;
+
+        for (int i = firstObject + 1; i < endObject; i++)
+        {
+            const Vec2f& position = positions[objects[i]];
+
+            node.minimum.x = std::min(node.minimum.x, position.x);
+            node.minimum.y = std::min(node.minimum.y, position.y);
+            node.maximum.x = std::max(node.maximum.x, position.x);
+            node.maximum.y = std::max(node.maximum.y, position.y);
+        }
+
+        /* Split along the longer axis of the centres' bounds before they are grown by the objects' size. */
+        PositionComparator comparator;
+
+        comparator.positions = positions;
+        comparator.alongX    = (node.maximum.x - node.minimum.x) >= (node.maximum.y - node.minimum.y);
+
+        node.minimum.x -= halfExtent;
+        node.minimum.y -= halfExtent;
+        node.maximum.x += halfExtent;
+        node.maximum.y += halfExtent;
+
+        nodes.push_back(node);
+
+        if (endObject - firstObject == 1)
+        {
+            nodes[nodeIndex].object = objects[firstObject];
+
+            return nodeIndex;
+        }
+
+        const int middleObject = (firstObject + endObject) / 2;
+
+        std::nth_element(objects.begin() + firstObject,
+                         objects.begin() + middleObject,
+                         objects.begin() + endObject,
+                         comparator);
+
+        /* Children are appended to the nodes vector, so write through the index rather than a reference. */
+        const int firstChild  = buildNode(firstObject,  middleObject);
+        const int secondChild = buildNode(middleObject, endObject);
+
+        nodes[nodeIndex].children[0] = firstChild;
+        nodes[nodeIndex].children[1] = secondChild;
+
+        return nodeIndex;
+    }
+}
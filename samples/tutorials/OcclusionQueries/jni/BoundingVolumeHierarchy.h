@@ -0,0 +1,85 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef BOUNDING_VOLUME_HIERARCHY_H
+#define BOUNDING_VOLUME_HIERARCHY_H
+
+#include "VectorTypes.h"
+
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Binary bounding volume hierarchy over objects standing on the XZ plane.
+     *
+     * Every object is a square of the same size centred on a 2D position. Each node stores the XZ bounds
+     * of all objects below it, so a single occlusion query against the node's box tells whether any of them can be visible.
+     * The tree is built top-down by splitting the objects at the median along the longer axis of the bounds,
+     * which takes O(n log n) time and gives a balanced tree with one object per leaf.
+     */
+    class BoundingVolumeHierarchy
+    {
+    public:
+        /** \brief A node of the hierarchy. */
+        struct Node
+        {
+            Vec2f minimum;     /**< Lower XZ corner of the bounds. */
+            Vec2f maximum;     /**< Upper XZ corner of the bounds. */
+            int   children[2]; /**< Indices of the child nodes, -1 for leaves. */
+            int   object;      /**< Index of the object stored in a leaf, -1 for interior nodes. */
+        };
+
+        /**
+         * \brief Build the hierarchy.
+         *
+         * \param[in] positions       Centres of the objects.
+         * \param[in] numberOfObjects Number of objects. Must be at least 1.
+         * \param[in] halfExtent      Half of the size of each object.
+         */
+        void build(const Vec2f* positions, int numberOfObjects, float halfExtent);
+
+        /**
+         * \brief Index of the root node.
+         */
+        int getRoot() const { return 0; }
+
+        /**
+         * \brief Number of nodes in the hierarchy (2n - 1 for n objects).
+         */
+        int getNumberOfNodes() const { return (int)nodes.size(); }
+
+        /**
+         * \brief Access a node.
+         *
+         * \param[in] node Index of the node.
+         */
+        const Node& getNode(int node) const { return nodes[node]; }
+
+    private:
+        std::vector<Node> nodes;
+        std::vector<int>  objects;
+        const Vec2f*      positions;
+        float             halfExtent;
+
+        int buildNode(int firstObject, int endObject);
+    };
+}
+#endif /* BOUNDING_VOLUME_HIERARCHY_H */
@@ -45,34 +45,53 @@
 *
 *There is also text displayed (at the bottom left corner of the screen) showing whether the occlusion
 *query mode is currently on or off. The mode changes every 10 seconds.
+*
+*Occlusion queries are used in two ways. The synchronous mode reads every result in the frame in which
+*the query was issued, which makes the CPU wait for the GPU. The query ring mode (OcclusionQueryRing)
+*reads results a few frames later, only once they are available, and tests cubes which stay visible
+*less often. The hierarchical mode uses the same ring, but tests whole subtrees of a bounding volume
+*hierarchy built over the cubes, so an occluded region costs a single query.
+*The average frame time of each mode is logged whenever the mode changes.
  *
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
+#include <algorithm>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
 
+#include "BoundingVolumeHierarchy.h"
 #include "Common.h"
 #include "CubeModel.h"
 #include "Matrix.h"
 #include "Native.h"
+#include "OcclusionQueryRing.h"
 #include "PlaneModel.h"
 #include "Shader.h"
 #include "SuperEllipsoidModel.h"
 #include "Text.h"
 #include "Texture.h"
 #include "Timer.h"
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace std;
 using namespace MaliSDK;
 
 /* Asset directories and filenames */
+#if defined(ANDROID)
 const string resourceDirectory = "/data/data/com.arm.malideveloper.openglessdk.occlusionQueries/files/";
+#else
+const string resourceDirectory = ASSET_DIRECTORY;
+#endif
 
 /* Window properties. */
 int windowWidth  = 0;
@@ -84,6 +103,9 @@ Timer timer;
 /* Timer variable to calculate FPS. */
 Timer fpsTimer;
 
+/* Timer variable to measure the time between consecutive frames. */
+Timer frameTimer;
+
 /* Id of OpenGL program we use for rendering. */
 GLuint programId = 0;
 
@@ -111,8 +133,40 @@ const float minimumDistance = ROUNDED_CUBE_SCALE_FACTOR * 2.0f + 0.1f;
 /* Array of queries for each of numberOfCubes cubes. */
 GLuint cubeQuery[NUMBER_OF_CUBES] = {0};
 
-/* Flag that informs us what mode is turned on (if it's occlusion query mode or not). */
-bool occlusionQueriesOn = false;
+/* Multi-frame query pool used in OCCLUSION_QUERY_RING mode. */
+OcclusionQueryRing* queryRing = NULL;
+
+/* Bounding volume hierarchy built over the cubes' positions. */
+BoundingVolumeHierarchy cubesHierarchy;
+
+/* Multi-frame query pool with one entry per hierarchy node, used in OCCLUSION_QUERY_HIERARCHICAL mode. */
+OcclusionQueryRing* nodeQueryRing = NULL;
+
+/* Modes the application cycles through. */
+enum OcclusionQueryMode
+{
+    OCCLUSION_QUERY_OFF,          /* All rounded cubes are drawn. */
+    OCCLUSION_QUERY_SYNCHRONOUS,  /* Query results are read in the frame in which they were issued. */
+    OCCLUSION_QUERY_RING,         /* Query results are read a few frames later, once available. */
+    OCCLUSION_QUERY_HIERARCHICAL, /* As above, but whole subtrees of the cubes' hierarchy are tested with one query. */
+    NUMBER_OF_OCCLUSION_QUERY_MODES
+};
+
+/* Names of the modes, as displayed on screen. */
+const char* occlusionQueryModeNames[NUMBER_OF_OCCLUSION_QUERY_MODES] =
+{
+    "Occlusion query OFF",
+    "Occlusion query ON (synchronous)",
+    "Occlusion query ON (query ring)",
+    "Occlusion query ON (hierarchical)"
+};
+
+/* Informs us what mode is turned on. */
+OcclusionQueryMode occlusionQueryMode = OCCLUSION_QUERY_OFF;
+
+/* Sum of frame times and number of frames rendered since the current mode was turned on. */
+float accumulatedFrameTime = 0.0f;
+int   numberOfFramesInMode = 0;
 
 /* This is the angle that is used to rotate camera around Y axis. */
 float angleY = 0.0f;
@@ -145,6 +199,10 @@ GLint colorUniformLocation              = -1;
 /* Array to store sorted positions of the cubes. Each cube has 2 coordinates. */
 float sortedCubesPositions[2 * NUMBER_OF_CUBES] = {0.0f};
 
+/* Index of the cube (in randomCubesPositions) stored at each position of sortedCubesPositions.
+ * The query ring needs it to keep results attached to the same cube while the order changes. */
+int sortedCubesIds[NUMBER_OF_CUBES] = {0};
+
 /* Scaling factor to scale up the plane. */
 const float planeScalingFactor = 40.0f;
 
@@ -318,51 +376,42 @@ void generateCubesLocations(float planeWidth, float planeHeight, float minDistan
 /**
  * \brief Function that is used to sort cubes' center positions from the nearest to the furthest, relative to the camera position.
  *
- * We use bubble sort algorithm that checks whether an array is sorted or not.
+ * Each cube's depth in view space is computed once and the cubes are ordered with std::sort, which takes O(n log n) time.
+ * The cubes' identifiers in sortedCubesIds are reordered in the same way.
  *
  * \param[in,out] arrayToSort An array to be sorted.
  */
 void sortCubePositions(float* arrayToSort)
 {
-    /* The upper limit position of sorted elements. We subtract 4 because we will refer to the 4 array's
-     * cells ahead and we don't want to go out of bounds of the array. */
-    int max = (NUMBER_OF_CUBES * 2) - 4;
-
-    bool swapped = true;
+    /* Pairs of (negated view space depth, position in the array). The camera looks along the negative Z axis,
+     * so the nearest cube has the largest Z value and comes first when sorted by the negated depth. */
+    pair<float, int> cubesDepths[NUMBER_OF_CUBES];
 
-    while(swapped)
+    for (int i = 0; i < NUMBER_OF_CUBES; i++)
     {
-        swapped = false;
+        Vec3f cubeLocation            = {arrayToSort[2 * i], 1, arrayToSort[2 * i + 1]};
+        Vec3f transformedCubeLocation = Matrix::vertexTransform(&cubeLocation, &rotatedViewMatrix);
 
-        for (int i = 0; i <= max; i += 2)
-        {
-            /* Temporarily store location points. */
-            Vec2f firstCubeLocation, secondCubeLocation;
-
-            firstCubeLocation.x = arrayToSort[i];
-            firstCubeLocation.y = arrayToSort[i + 1];
+        cubesDepths[i] = make_pair(-transformedCubeLocation.z, i);
+    }
 
-            secondCubeLocation.x = arrayToSort[i + 2];
-            secondCubeLocation.y = arrayToSort[i + 3];
+    sort(cubesDepths, cubesDepths + NUMBER_OF_CUBES);
 
-            Vec3f first_cube_location              = {firstCubeLocation.x,  1, firstCubeLocation.y};
-            Vec3f second_cube_location             = {secondCubeLocation.x, 1, secondCubeLocation.y};
-            Vec3f transformed_first_cube_location  = Matrix::vertexTransform(&first_cube_location,  &rotatedViewMatrix);
-            Vec3f transformed_second_cube_location = Matrix::vertexTransform(&second_cube_location, &rotatedViewMatrix);
+    /* Rewrite the coordinates and identifiers in the sorted order. */
+    float previousPositions[2 * NUMBER_OF_CUBES];
+    int   previousIds[NUMBER_OF_CUBES];
 
-            if (transformed_first_cube_location.z < transformed_second_cube_location.z)
-            {
-                /* Swap coordinates' positions. */
-                arrayToSort[i]     = secondCubeLocation.x;
-                arrayToSort[i + 1] = secondCubeLocation.y;
+    memcpy(previousPositions, arrayToSort,    sizeof(previousPositions));
+    memcpy(previousIds,       sortedCubesIds, sizeof(previousIds));
 
-                arrayToSort[i + 2] = firstCubeLocation.x;
-                arrayToSort[i + 3] = firstCubeLocation.y;
+    for (int i = 0; i < NUMBER_OF_CUBES; i++)
+    {
+        const int from = cubesDepths[i].second;
 
-                swapped = true;
-            }
-        } /* for (int i = 0; i <= max; i += 2) */
-    }/* while(swapped) */
+        arrayToSort[2 * i]     = previousPositions[2 * from];
+        arrayToSort[2 * i + 1] = previousPositions[2 * from + 1];
+        sortedCubesIds[i]      = previousIds[from];
+    }
 }
 
 /**
@@ -377,27 +426,15 @@ void rewriteVec2fArrayToFloatArray()
     {
         sortedCubesPositions[i * 2]     = randomCubesPositions[i].x;
         sortedCubesPositions[i * 2 + 1] = randomCubesPositions[i].y;
+        sortedCubesIds[i]               = i;
     }
 }
 
 /**
- * \brief Sends center position of a cube to the vertex shader's uniform.
- *
- * \param[in] whichCube Determines which cube's center position we should send to the vertex shader.
+ * \brief Sends the matrices derived from cubeModelMatrix to the vertex shader's uniforms.
  */
-inline void sendCubeLocationVectorToUniform(int whichCube)
+inline void sendCubeModelMatrixToUniform(void)
 {
-    /* Array to be sent to the vertex shader.*/
-    float tempArray[3];
-
-    /* We send roundedCubeScaleFactor to translate cubes a little bit up so they won't intersect with the plane.*/
-    tempArray[0] = sortedCubesPositions[2 * whichCube];
-    tempArray[1] = ROUNDED_CUBE_SCALE_FACTOR;
-    tempArray[2] = sortedCubesPositions[2 * whichCube + 1];
-
-    cubeModelMatrix        = Matrix::createTranslation(tempArray[0],
-                                                       tempArray[1],
-                                                       tempArray[2]);
     cubeMvpMatrix          = projectionMatrix * rotatedViewMatrix * cubeModelMatrix;
     cubeWorldInverseMatrix = Matrix::matrixInvert(&cubeMvpMatrix);
     cubeNormalMatrix       = Matrix::matrixInvert     (&cubeModelMatrix);
@@ -419,6 +456,48 @@ inline void sendCubeLocationVectorToUniform(int whichCube)
                                 cubeMvpMatrix.getAsArray()));
 }
 
+/**
+ * \brief Sends center position of a cube to the vertex shader's uniform.
+ *
+ * \param[in] whichCube Determines which cube's center position we should send to the vertex shader.
+ */
+inline void sendCubeLocationVectorToUniform(int whichCube)
+{
+    /* Array to be sent to the vertex shader.*/
+    float tempArray[3];
+
+    /* We send roundedCubeScaleFactor to translate cubes a little bit up so they won't intersect with the plane.*/
+    tempArray[0] = sortedCubesPositions[2 * whichCube];
+    tempArray[1] = ROUNDED_CUBE_SCALE_FACTOR;
+    tempArray[2] = sortedCubesPositions[2 * whichCube + 1];
+
+    cubeModelMatrix = Matrix::createTranslation(tempArray[0],
+                                                tempArray[1],
+                                                tempArray[2]);
+
+    sendCubeModelMatrixToUniform();
+}
+
+/**
+ * \brief Sends a box enclosing all the cubes below a hierarchy node to the vertex shader's uniforms.
+ *
+ * The normal cube is scaled and translated to match the node's bounds, so it can be drawn to query the whole subtree.
+ *
+ * \param[in] node Node of the cubes' hierarchy.
+ */
+inline void sendNodeBoundsToUniform(const BoundingVolumeHierarchy::Node& node)
+{
+    Matrix nodeScalingMatrix = Matrix::createScaling(0.5f * (node.maximum.x - node.minimum.x) / NORMAL_CUBE_SCALE_FACTOR,
+                                                     1.0f,
+                                                     0.5f * (node.maximum.y - node.minimum.y) / NORMAL_CUBE_SCALE_FACTOR);
+
+    cubeModelMatrix = Matrix::createTranslation(0.5f * (node.minimum.x + node.maximum.x),
+                                                ROUNDED_CUBE_SCALE_FACTOR,
+                                                0.5f * (node.minimum.y + node.maximum.y)) * nodeScalingMatrix;
+
+    sendCubeModelMatrixToUniform();
+}
+
 /**
  * \brief Function that sets up shaders, programs, uniforms locations, generates buffer objects and query objects.
  *
@@ -428,7 +507,11 @@ inline void sendCubeLocationVectorToUniform(int whichCube)
 void setupGraphics(int width, int height)
 {
     /* This line ensures that everytime we run the new instance of the program, rand() will generate different numbers. */
-    srand((unsigned int)time(NULL));
+    /* Benchmark runs seed rand() themselves, so they all place the cubes the same way. */
+    if (!Benchmark::isRunning())
+    {
+        srand((unsigned int)time(NULL));
+    }
 
     /* Store window resolution. */
     windowHeight = height;
@@ -461,7 +544,7 @@ void setupGraphics(int width, int height)
 
     /* Set up the text object. */
     text = new Text(resourceDirectory.c_str(), windowWidth, windowHeight);
-    text->addString(0, 0, "Occlusion query OFF", 255, 0, 0, 255);
+    text->addString(0, 0, occlusionQueryModeNames[occlusionQueryMode], 255, 0, 0, 255);
 
     /* Set clear color. */
     GL_CHECK(glClearColor(0.3f, 0.6f, 0.70f, 1.0f));
@@ -558,6 +641,11 @@ void setupGraphics(int width, int height)
     /* Rewrite Vec2f randomCubesPosition array to simple array of floats. */
     rewriteVec2fArrayToFloatArray();
 
+    /* [Build cubes hierarchy] */
+    /* The cubes do not move, so the hierarchy is built once. Its bounds enclose the normal cubes used for the occlusion test. */
+    cubesHierarchy.build(randomCubesPositions, NUMBER_OF_CUBES, NORMAL_CUBE_SCALE_FACTOR);
+    /* [Build cubes hierarchy] */
+
     /* Generate buffer objects. */
     /* [Generate buffer objects for plane geometry] */
     GL_CHECK(glGenBuffers(1, &planeVerticesBufferId));
@@ -675,6 +763,12 @@ void setupGraphics(int width, int height)
     GL_CHECK(glGenQueries(NUMBER_OF_CUBES, cubeQuery));
     /* [Generate query objects] */
 
+    /* [Generate query ring] */
+    queryRing = new OcclusionQueryRing(NUMBER_OF_CUBES, QUERY_RING_DEPTH, QUERY_RING_MAXIMUM_INTERVAL);
+    /* [Generate query ring] */
+
+    nodeQueryRing = new OcclusionQueryRing(cubesHierarchy.getNumberOfNodes(), QUERY_RING_DEPTH, QUERY_RING_MAXIMUM_INTERVAL);
+
     /* Define blending function that will be used when enabled. */
     GL_CHECK(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
 
@@ -710,13 +804,216 @@ void setupGraphics(int width, int height)
     }
 
     fpsTimer.reset();
+    frameTimer.reset();
     timer.reset();
 }
 
+/**
+ * \brief Draw the rounded cubes using the results collected by the query ring.
+ *
+ * Results of queries issued in previous frames are collected without waiting for the GPU.
+ * All normal cubes are drawn front to back into the depth buffer, but only those due to be tested
+ * are wrapped in a query. Rounded cubes are then drawn for every cube the ring reports as visible.
+ */
+void drawCubesWithQueryRing(void)
+{
+    /* [Collect query ring results] */
+    queryRing->collectResults();
+    /* [Collect query ring results] */
+
+    GL_CHECK(glBindVertexArray(normalCubeVertexArrayObjectId));
+    GL_CHECK(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+
+    /* [Issue the occlusion test for the query ring] */
+    for (int i = 0; i < NUMBER_OF_CUBES; i++)
+    {
+        const int cubeId = sortedCubesIds[i];
+
+        sendCubeLocationVectorToUniform(i);
+
+        /* Cubes which are not tested in this frame are still drawn, so they occlude the cubes behind them. */
+        if (queryRing->needsQuery(cubeId))
+        {
+            queryRing->beginQuery(cubeId);
+            {
+                GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, numberOfCubeVertices));
+            }
+            queryRing->endQuery();
+        }
+        else
+        {
+            GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, numberOfCubeVertices));
+        }
+    }
+    /* [Issue the occlusion test for the query ring] */
+
+    GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+
+    /* Clear color and depth buffers. */
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    GL_CHECK(glBindVertexArray(roundedCubeVertexArrayObjectId));
+
+    for (int i = 0; i < NUMBER_OF_CUBES; i++)
+    {
+        if (queryRing->isVisible(sortedCubesIds[i]))
+        {
+            sendCubeLocationVectorToUniform(i);
+
+            GL_CHECK(glDrawArrays(GL_TRIANGLES,
+                                  0,
+                                  numberOfRoundedCubesVertices));
+
+            numberOfRoundedCubesDrawn++;
+        }
+    }
+
+    queryRing->nextFrame();
+}
+
+/**
+ * \brief Issue an occlusion query for the bounds of a hierarchy node without writing to the depth buffer.
+ *
+ * The bounds are larger than the cubes inside them, so they must not occlude anything drawn later.
+ *
+ * \param[in] nodeIndex Index of the node in cubesHierarchy.
+ */
+void queryNodeBounds(int nodeIndex)
+{
+    sendNodeBoundsToUniform(cubesHierarchy.getNode(nodeIndex));
+
+    GL_CHECK(glDepthMask(GL_FALSE));
+
+    nodeQueryRing->beginQuery(nodeIndex);
+    {
+        GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, numberOfCubeVertices));
+    }
+    nodeQueryRing->endQuery();
+
+    GL_CHECK(glDepthMask(GL_TRUE));
+}
+
+/**
+ * \brief Draw the rounded cubes, driving the occlusion queries with the cubes' hierarchy.
+ *
+ * The hierarchy is traversed front to back, visiting the nearer child of each node first.
+ * A node which was reported as occluded is not descended into: only its bounds are tested again,
+ * so a large occluded region costs a single query. Nodes which are visible are descended into, and their
+ * bounds are re-tested at the interval chosen by the query ring to find out when they become occluded.
+ * Leaves are handled like the cubes in drawCubesWithQueryRing().
+ */
+void drawCubesWithHierarchicalQueries(void)
+{
+    /* Cubes found visible during the traversal, in front to back order. */
+    int visibleCubes[NUMBER_OF_CUBES];
+    int numberOfVisibleCubes = 0;
+
+    /* A binary tree with n leaves is never deeper than n, so this stack is large enough. */
+    int nodesStack[2 * NUMBER_OF_CUBES];
+    int stackSize = 0;
+
+    nodeQueryRing->collectResults();
+
+    GL_CHECK(glBindVertexArray(normalCubeVertexArrayObjectId));
+    GL_CHECK(glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE));
+
+    /* [Traverse the cubes hierarchy] */
+    nodesStack[stackSize++] = cubesHierarchy.getRoot();
+
+    while (stackSize > 0)
+    {
+        const int                            nodeIndex = nodesStack[--stackSize];
+        const BoundingVolumeHierarchy::Node& node      = cubesHierarchy.getNode(nodeIndex);
+
+        if (!nodeQueryRing->isVisible(nodeIndex))
+        {
+            /* Skip the whole subtree, but keep testing its bounds so it reappears when uncovered. */
+            if (nodeQueryRing->needsQuery(nodeIndex))
+            {
+                queryNodeBounds(nodeIndex);
+            }
+
+            continue;
+        }
+
+        if (node.object >= 0)
+        {
+            cubeModelMatrix = Matrix::createTranslation(randomCubesPositions[node.object].x,
+                                                        ROUNDED_CUBE_SCALE_FACTOR,
+                                                        randomCubesPositions[node.object].y);
+
+            sendCubeModelMatrixToUniform();
+
+            /* The cube is drawn into the depth buffer whether it is tested or not, so it occludes the cubes behind it. */
+            if (nodeQueryRing->needsQuery(nodeIndex))
+            {
+                nodeQueryRing->beginQuery(nodeIndex);
+                {
+                    GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, numberOfCubeVertices));
+                }
+                nodeQueryRing->endQuery();
+            }
+            else
+            {
+                GL_CHECK(glDrawArrays(GL_TRIANGLES, 0, numberOfCubeVertices));
+            }
+
+            visibleCubes[numberOfVisibleCubes++] = node.object;
+
+            continue;
+        }
+
+        if (nodeQueryRing->needsQuery(nodeIndex))
+        {
+            queryNodeBounds(nodeIndex);
+        }
+
+        /* Push the further child first, so the nearer one is visited next. The camera looks along the negative Z axis. */
+        const BoundingVolumeHierarchy::Node& firstChild  = cubesHierarchy.getNode(node.children[0]);
+        const BoundingVolumeHierarchy::Node& secondChild = cubesHierarchy.getNode(node.children[1]);
+
+        Vec3f firstChildCenter  = {0.5f * (firstChild.minimum.x  + firstChild.maximum.x),  1, 0.5f * (firstChild.minimum.y  + firstChild.maximum.y)};
+        Vec3f secondChildCenter = {0.5f * (secondChild.minimum.x + secondChild.maximum.x), 1, 0.5f * (secondChild.minimum.y + secondChild.maximum.y)};
+
+        Vec3f transformedFirstChildCenter  = Matrix::vertexTransform(&firstChildCenter,  &rotatedViewMatrix);
+        Vec3f transformedSecondChildCenter = Matrix::vertexTransform(&secondChildCenter, &rotatedViewMatrix);
+
+        const bool firstChildIsNearer = transformedFirstChildCenter.z >= transformedSecondChildCenter.z;
+
+        nodesStack[stackSize++] = node.children[firstChildIsNearer ? 1 : 0];
+        nodesStack[stackSize++] = node.children[firstChildIsNearer ? 0 : 1];
+    }
+    /* [Traverse the cubes hierarchy] */
+
+    GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+
+    /* Clear color and depth buffers. */
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+
+    GL_CHECK(glBindVertexArray(roundedCubeVertexArrayObjectId));
+
+    for (int i = 0; i < numberOfVisibleCubes; i++)
+    {
+        cubeModelMatrix = Matrix::createTranslation(randomCubesPositions[visibleCubes[i]].x,
+                                                    ROUNDED_CUBE_SCALE_FACTOR,
+                                                    randomCubesPositions[visibleCubes[i]].y);
+
+        sendCubeModelMatrixToUniform();
+
+        GL_CHECK(glDrawArrays(GL_TRIANGLES,
+                              0,
+                              numberOfRoundedCubesVertices));
+    }
+
+    numberOfRoundedCubesDrawn = numberOfVisibleCubes;
+
+    nodeQueryRing->nextFrame();
+}
+
 /**
  * \brief Draw the plane and cubes.
  *
- * Renders all rounded cubes if occlusion queries turned on,
+ * Renders all rounded cubes if occlusion queries turned off,
  * otherwise just draws those visible.
  */
 void draw(void)
@@ -732,7 +1029,7 @@ void draw(void)
                               1,
                               cubeColor));
 
-        if (occlusionQueriesOn)
+        if (occlusionQueryMode == OCCLUSION_QUERY_SYNCHRONOUS)
         {
             /* [Bind normal cubes vertex array object] */
             GL_CHECK(glBindVertexArray(normalCubeVertexArrayObjectId));
@@ -796,6 +1093,14 @@ void draw(void)
                 }
             }
         }
+        else if (occlusionQueryMode == OCCLUSION_QUERY_RING)
+        {
+            drawCubesWithQueryRing();
+        }
+        else if (occlusionQueryMode == OCCLUSION_QUERY_HIERARCHICAL)
+        {
+            drawCubesWithHierarchicalQueries();
+        }
         else
         {
             /* [Draw for disabled occlusion query mode] */
@@ -846,6 +1151,10 @@ void draw(void)
  */
 void renderFrame()
 {
+    /* Time elapsed since the previous frame, including any time the CPU spent waiting for query results. */
+    accumulatedFrameTime += frameTimer.getInterval();
+    numberOfFramesInMode++;
+
     if(fpsTimer.isTimePassed(1.0f))
     {
         /* Calculate FPS. */
@@ -853,6 +1162,15 @@ void renderFrame()
 
         LOGI("FPS:\t%.1f", FPS);
         LOGI("Number of Cubes drawn: %d\n", numberOfRoundedCubesDrawn);
+
+        if (occlusionQueryMode == OCCLUSION_QUERY_RING)
+        {
+            LOGI("Queries issued: %d, queries in flight: %d\n", queryRing->getNumberOfQueriesIssued(), queryRing->getNumberOfPendingQueries());
+        }
+        else if (occlusionQueryMode == OCCLUSION_QUERY_HIERARCHICAL)
+        {
+            LOGI("Queries issued: %d, queries in flight: %d\n", nodeQueryRing->getNumberOfQueriesIssued(), nodeQueryRing->getNumberOfPendingQueries());
+        }
     }
 
     /* Clear color and depth buffers. */
@@ -884,27 +1202,37 @@ void renderFrame()
 
     modeChanged = false;
 
-    /* Check timer to know if we should turn off/on occlusion queries. */
+    /* Check timer to know if we should switch to the next occlusion query mode. */
     if(timer.getTime() > TIME_INTERVAL)
     {
-        occlusionQueriesOn = !occlusionQueriesOn;
+        LOGI("Average frame time (%s): %.2f ms\n",
+             occlusionQueryModeNames[occlusionQueryMode],
+             1000.0f * accumulatedFrameTime / float(numberOfFramesInMode));
 
-        if(occlusionQueriesOn)
+        accumulatedFrameTime = 0.0f;
+        numberOfFramesInMode = 0;
+        occlusionQueryMode   = OcclusionQueryMode((occlusionQueryMode + 1) % NUMBER_OF_OCCLUSION_QUERY_MODES);
+
+        if(occlusionQueryMode != OCCLUSION_QUERY_OFF)
         {
             /* Mark that mode has changed */
             modeChanged = true;
+        }
 
-            LOGI("\nOcclusion query ON\n");
-            text->clear();
-            text->addString(0, 0, "Occlusion query ON", 255, 0, 0, 255);
+        if(occlusionQueryMode == OCCLUSION_QUERY_RING)
+        {
+            /* Results collected before the mode was turned off again are out of date. */
+            queryRing->reset();
         }
-        else
+        else if(occlusionQueryMode == OCCLUSION_QUERY_HIERARCHICAL)
         {
-            LOGI("\nOcclusion query OFF\n");
-            text->clear();
-            text->addString(0, 0, "Occlusion query OFF", 255, 0, 0, 255);
+            nodeQueryRing->reset();
         }
 
+        LOGI("\n%s\n", occlusionQueryModeNames[occlusionQueryMode]);
+        text->clear();
+        text->addString(0, 0, occlusionQueryModeNames[occlusionQueryMode], 255, 0, 0, 255);
+
         timer.reset();
     }
 
@@ -941,8 +1269,15 @@ void uninit()
 
     /* Delete the query objects. */
     GL_CHECK(glDeleteQueries(NUMBER_OF_CUBES, cubeQuery));
+
+    delete queryRing;
+    queryRing = NULL;
+
+    delete nodeQueryRing;
+    nodeQueryRing = NULL;
 }
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_occlusionQueries_NativeLibrary_init  (JNIEnv*, jobject,
@@ -961,6 +1296,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_occlusionQueries_N
 
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_occlusionQueries_NativeLibrary_step(JNIEnv*, jobject)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
 
@@ -968,3 +1304,7 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_occlusionQueries_N
 {
     uninit();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("OcclusionQueries", setupGraphics, renderFrame)
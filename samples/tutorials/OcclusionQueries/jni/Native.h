@@ -42,4 +42,11 @@
     #define ROUNDED_CUBE_SCALE_FACTOR (2.5f)
     #define NORMAL_CUBE_SCALE_FACTOR  (2.3f)
 
+    /* Number of occlusion queries that can be in flight for one cube when the query ring is used.
+     * Results are consumed up to this many frames after the query was issued. */
+    #define QUERY_RING_DEPTH (3)
+
+    /* Maximum number of frames between two occlusion queries of a cube that stays visible. */
+    #define QUERY_RING_MAXIMUM_INTERVAL (16)
+
 #endif /* OCCLUSION_QUERIES_H */
@@ -0,0 +1,213 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "OcclusionQueryRing.h"
+#include "Common.h"
+
+namespace MaliSDK
+{
+    OcclusionQueryRing::OcclusionQueryRing(int numberOfObjects, int ringDepth, int maximumQueryInterval)
+        : numberOfObjects(numberOfObjects)
+        , ringDepth(ringDepth)
+        , maximumQueryInterval(maximumQueryInterval)
+        , frame(0)
+        , numberOfQueriesIssued(0)
+    {
+        ASSERT(numberOfObjects      > 0, "Query ring needs at least one object.");
+        ASSERT(ringDepth            > 0, "Query ring needs at least one query per object.");
+        ASSERT(maximumQueryInterval > 0, "Maximum query interval must be at least one frame.");
+
+        queries.resize    (numberOfObjects * ringDepth, 0);
+        queryFrames.resize(numberOfObjects * ringDepth, 0);
+
+        /* Value-initialised: no queries in flight. */
+        objects.resize(numberOfObjects, ObjectState());
+
+        GL_CHECK(glGenQueries(numberOfObjects * ringDepth, &queries[0]));
+
+        reset();
+    }
+
+    OcclusionQueryRing::~OcclusionQueryRing()
+    {
+        GL_CHECK(glDeleteQueries(numberOfObjects * ringDepth, &queries[0]));
+    }
+
+    void OcclusionQueryRing::reset()
+    {
+        for (int i = 0; i < numberOfObjects; i++)
+        {
+            ObjectState& state = objects[i];
+
+            state.numberOfDiscarded = state.numberOfPending;
+            state.hasResult         = false;
+            state.visible           = true;
+            state.stableResults     = 0;
+            state.queryInterval     = 1;
+            state.lastQueryFrame    = frame;
+            state.resultFrame       = frame;
+        }
+    }
+
+    /* [Collect available query results] */
+    void OcclusionQueryRing::collectResults()
+    {
+        numberOfQueriesIssued = 0;
+
+        for (int i = 0; i < numberOfObjects; i++)
+        {
+            ObjectState& state = objects[i];
+
+            /* Queries complete in the order they were issued, so stop at the first one which is not ready. */
+            while (state.numberOfPending > 0)
+            {
+                const int slot        = i * ringDepth + state.firstPending;
+                GLuint    isAvailable = GL_FALSE;
+                GLuint    result      = GL_FALSE;
+
+                GL_CHECK(glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &isAvailable));
+
+                if (isAvailable == GL_FALSE)
+                {
+                    break;
+                }
+
+                /* The result is ready, so reading it does not stall. */
+                GL_CHECK(glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT, &result));
+
+                state.firstPending     = (state.firstPending + 1) % ringDepth;
+                state.numberOfPending -= 1;
+
+                if (state.numberOfDiscarded > 0)
+                {
+                    state.numberOfDiscarded -= 1;
+
+                    continue;
+                }
+
+                const bool visible = (result != GL_FALSE);
+
+                if (state.hasResult && state.visible == visible)
+                {
+                    state.stableResults++;
+                }
+                else
+                {
+                    state.stableResults = 0;
+                }
+
+                state.hasResult   = true;
+                state.visible     = visible;
+                state.resultFrame = queryFrames[slot];
+
+                /* Occluded objects are tested every frame so they reappear with the latency of the ring only.
+                 * Objects which stay visible double their interval with every result that confirms it. */
+                if (visible)
+                {
+                    const int shift = state.stableResults < 16 ? state.stableResults : 16;
+
+                    state.queryInterval = (1 << shift) < maximumQueryInterval ? (1 << shift) : maximumQueryInterval;
+                }
+                else
+                {
+                    state.queryInterval = 1;
+                }
+            }
+        }
+    }
+    /* [Collect available query results] */
+
+    bool OcclusionQueryRing::needsQuery(int object) const
+    {
+        const ObjectState& state = objects[object];
+
+        if (state.numberOfPending == ringDepth)
+        {
+            /* The ring is full: rather than wait for the GPU, skip the test this frame. */
+            return false;
+        }
+
+        if (!state.hasResult && state.numberOfPending == 0)
+        {
+            return true;
+        }
+
+        return frame - state.lastQueryFrame >= (unsigned int)state.queryInterval;
+    }
+
+    void OcclusionQueryRing::beginQuery(int object)
+    {
+        ObjectState& state = objects[object];
+
+        ASSERT(state.numberOfPending < ringDepth, "No free query object left in the ring.");
+
+        const int slot = object * ringDepth + (state.firstPending + state.numberOfPending) % ringDepth;
+
+        queryFrames[slot]     = frame;
+        state.lastQueryFrame  = frame;
+        state.numberOfPending += 1;
+        numberOfQueriesIssued++;
+
+        GL_CHECK(glBeginQuery(GL_ANY_SAMPLES_PASSED, queries[slot]));
+    }
+
+    void OcclusionQueryRing::endQuery()
+    {
+        GL_CHECK(glEndQuery(GL_ANY_SAMPLES_PASSED));
+    }
+
+    /* [Conservative visibility] */
+    bool OcclusionQueryRing::isVisible(int object) const
+    {
+        const ObjectState& state = objects[object];
+
+        if (!state.hasResult)
+        {
+            return true;
+        }
+
+        /* An occluded result is only trusted while it is recent. If the GPU falls further behind
+         * than the ring depth, the object is drawn until a fresh result arrives. */
+        if (!state.visible && frame - state.resultFrame > (unsigned int)ringDepth)
+        {
+            return true;
+        }
+
+        return state.visible;
+    }
+    /* [Conservative visibility] */
+
+    void OcclusionQueryRing::nextFrame()
+    {
+        frame++;
+    }
+
+    int OcclusionQueryRing::getNumberOfPendingQueries() const
+    {
+        int numberOfPendingQueries = 0;
+
+        for (int i = 0; i < numberOfObjects; i++)
+        {
+            numberOfPendingQueries += objects[i].numberOfPending;
+        }
+
+        return numberOfPendingQueries;
+    }
+}
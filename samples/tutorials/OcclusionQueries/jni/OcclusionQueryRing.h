@@ -0,0 +1,140 @@
+/* Copyright (c) 2014-2017, ARM Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef OCCLUSION_QUERY_RING_H
+#define OCCLUSION_QUERY_RING_H
+
+#include <GLES3/gl3.h>
+#include <vector>
+
+namespace MaliSDK
+{
+    /**
+     * \brief Pool of occlusion queries whose results are consumed a few frames after they were issued.
+     *
+     * Every object owns a small ring of GL_ANY_SAMPLES_PASSED query objects. Results are only read once
+     * GL_QUERY_RESULT_AVAILABLE reports them as ready, so the CPU never waits for the GPU. Until a result
+     * arrives the object is treated conservatively: objects that have never been tested, or whose newest
+     * result is older than the ring depth, are reported as visible.
+     *
+     * Queries are spaced temporally. Occluded objects are tested every frame so that they reappear quickly,
+     * while objects that keep being reported visible are tested less and less often, up to a maximum interval.
+     */
+    class OcclusionQueryRing
+    {
+    public:
+        /**
+         * \brief Generate the query objects.
+         *
+         * \param[in] numberOfObjects      Number of objects tracked by the ring.
+         * \param[in] ringDepth            Number of queries which can be in flight for one object.
+         *                                 This is also the number of frames after which a pending result is considered stale.
+         * \param[in] maximumQueryInterval Maximum number of frames between two queries of an object which stays visible.
+         */
+        OcclusionQueryRing(int numberOfObjects, int ringDepth, int maximumQueryInterval);
+
+        /**
+         * \brief Delete the query objects.
+         */
+        ~OcclusionQueryRing();
+
+        /**
+         * \brief Read all results which are already available. Never blocks.
+         *
+         * Should be called once per frame, before isVisible() and needsQuery() are used.
+         */
+        void collectResults();
+
+        /**
+         * \brief Check if an object should be tested in the current frame.
+         *
+         * \param[in] object Index of the object.
+         *
+         * \return True if the object is due to be tested and a free query object is left in its ring.
+         */
+        bool needsQuery(int object) const;
+
+        /**
+         * \brief Begin an occlusion query for an object. Draw calls issued before endQuery() are counted by the query.
+         *
+         * \param[in] object Index of the object. needsQuery() must have returned true for it.
+         */
+        void beginQuery(int object);
+
+        /**
+         * \brief End the query started by beginQuery().
+         */
+        void endQuery();
+
+        /**
+         * \brief Check if an object should be rendered, based on the newest result collected for it.
+         *
+         * \param[in] object Index of the object.
+         *
+         * \return False only if the object has recently been reported as occluded.
+         */
+        bool isVisible(int object) const;
+
+        /**
+         * \brief Advance to the next frame.
+         */
+        void nextFrame();
+
+        /**
+         * \brief Forget all collected results. Queries which are still in flight are discarded once they complete.
+         */
+        void reset();
+
+        /**
+         * \brief Number of queries issued since the last call to collectResults().
+         */
+        int getNumberOfQueriesIssued() const { return numberOfQueriesIssued; }
+
+        /**
+         * \brief Number of queries which are in flight.
+         */
+        int getNumberOfPendingQueries() const;
+
+    private:
+        /** \brief Query state of a single object. */
+        struct ObjectState
+        {
+            int          firstPending;      /**< Ring slot of the oldest query in flight. */
+            int          numberOfPending;   /**< Number of queries in flight. */
+            int          numberOfDiscarded; /**< Number of the oldest queries in flight whose results are ignored. */
+            bool         hasResult;         /**< True once a result has been collected. */
+            bool         visible;           /**< Newest collected result. */
+            int          stableResults;     /**< Number of consecutive results equal to the newest one. */
+            int          queryInterval;     /**< Number of frames between two queries. */
+            unsigned int lastQueryFrame;    /**< Frame in which the newest query was issued. */
+            unsigned int resultFrame;       /**< Frame in which the query that produced the newest result was issued. */
+        };
+
+        int                       numberOfObjects;
+        int                       ringDepth;
+        int                       maximumQueryInterval;
+        unsigned int              frame;
+        int                       numberOfQueriesIssued;
+        std::vector<GLuint>       queries;
+        std::vector<unsigned int> queryFrames;
+        std::vector<ObjectState>  objects;
+    };
+}
+#endif /* OCCLUSION_QUERY_RING_H */
@@ -24,6 +24,8 @@
 #include "Shader.h"
 #include "VectorTypes.h"
 
+#include <cstring>
+
 using std::string;
 
 namespace MaliSDK
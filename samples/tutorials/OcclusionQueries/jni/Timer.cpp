@@ -75,6 +75,8 @@
 }
 #else
 
+#include "Benchmark.h"
+
 #include <sys/time.h>
 
 namespace MaliSDK
@@ -97,7 +99,7 @@ namespace MaliSDK
 
     void Timer::reset()
     {
-        gettimeofday(&startTime, NULL);
+        Benchmark::getTimeOfDay(&startTime);
         lastIntervalTime = 0.0;
 
         frameCount = 0;
@@ -106,7 +108,7 @@ namespace MaliSDK
 
     float Timer::getTime()
     {
-        gettimeofday(&currentTime, NULL);
+        Benchmark::getTimeOfDay(&currentTime);
         float seconds = (currentTime.tv_sec - startTime.tv_sec);
         float milliseconds = (float(currentTime.tv_usec - startTime.tv_usec)) / 1000000.0f;
         return seconds + milliseconds;
@@ -39,8 +39,10 @@
  *            d. Shadows are computed for the spot lighting (the result of the first step is now used).
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
 #include "Common.h"
@@ -53,6 +55,8 @@
 #include "Texture.h"
 #include "Timer.h"
 #include <cstring>
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace MaliSDK;
 
@@ -983,6 +987,7 @@ static void updateSpotLightDirection()
 }
 /* [Update spot light direction] */
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_projectedLights_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -1006,5 +1011,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_projectedLights_Na
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_projectedLights_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ProjectedLights", setupGraphics, renderFrame)
@@ -29,8 +29,10 @@
  * The application uses shadow mapping for rendering and displaying shadows.
  */
 
+#if defined(ANDROID)
 #include <jni.h>
 #include <android/log.h>
+#endif
 
 #include <GLES3/gl3.h>
 #include "Common.h"
@@ -43,6 +45,8 @@
 #include "Texture.h"
 #include "Timer.h"
 #include <cstring>
+#include "Profiler.h"
+#include "Benchmark.h"
 
 using namespace MaliSDK;
 
@@ -933,6 +937,7 @@ void uninit()
     /* Deallocate memory. */
     deallocateMemory();
 }
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_shadowMapping_NativeLibrary_init  (JNIEnv * env, jobject obj, jint width, jint height);
@@ -956,5 +961,10 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_shadowMapping_Nati
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_shadowMapping_NativeLibrary_step(
         JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("ShadowMapping", setupGraphics, renderFrame)
@@ -21,6 +21,12 @@
 #ifndef SHADOW_MAPPING_H
 #define SHADOW_MAPPING_H
 
+#if defined(ANDROID)
+#define BASE_ASSET_PATH "/data/data/com.arm.malideveloper.openglessdk.shadowMapping/files/"
+#else
+#define BASE_ASSET_PATH ASSET_DIRECTORY
+#endif
+
 #include "VectorTypes.h"
 #include <EGL/egl.h>
 #include <GLES3/gl3.h>
@@ -28,12 +34,12 @@
 namespace MaliSDK
 {
     /** Name of a fragment shader file that will be used to render a cube representing the spot light source. */
-    #define SPOT_LIGHT_CUBE_FRAGMENT_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.shadowMapping/files/cube_light_fragment_shader_source.frag")
+    #define SPOT_LIGHT_CUBE_FRAGMENT_SHADER_FILE_NAME (BASE_ASSET_PATH "cube_light_fragment_shader_source.frag")
     /** Name of a vertex shader file that will be used to render a cube representing the spot light source. */
-    #define SPOT_LIGHT_CUBE_VERTEX_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.shadowMapping/files/cube_light_vertex_shader_source.vert")
+    #define SPOT_LIGHT_CUBE_VERTEX_SHADER_FILE_NAME (BASE_ASSET_PATH "cube_light_vertex_shader_source.vert")
     /** Name of a fragment shader file that will be used to render a scene. */
-    #define FRAGMENT_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.shadowMapping/files/lighting_fragment_shader_source.frag")
+    #define FRAGMENT_SHADER_FILE_NAME (BASE_ASSET_PATH "lighting_fragment_shader_source.frag")
     /** Name of a vertex shader file that will be used to render a scene. */
-    #define VERTEX_SHADER_FILE_NAME ("/data/data/com.arm.malideveloper.openglessdk.shadowMapping/files/model_vertex.vert")
+    #define VERTEX_SHADER_FILE_NAME (BASE_ASSET_PATH "model_vertex.vert")
 }
 #endif /* SHADOW_MAPPING_H */
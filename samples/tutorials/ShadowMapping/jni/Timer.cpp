@@ -63,6 +63,8 @@ namespace MaliSDK
 }
 #else
 
+#include "Benchmark.h"
+
 #include <sys/time.h>
 
 namespace MaliSDK
@@ -85,7 +87,7 @@ namespace MaliSDK
 
     void Timer::reset()
     {
-        gettimeofday(&startTime, NULL);
+        Benchmark::getTimeOfDay(&startTime);
 
         lastIntervalTime = 0.0;
 
@@ -95,7 +97,7 @@ namespace MaliSDK
 
     float Timer::getTime()
     {
-        gettimeofday(&currentTime, NULL);
+        Benchmark::getTimeOfDay(&currentTime);
 
         float seconds      = (currentTime.tv_sec - startTime.tv_sec);
         float milliseconds = (float(currentTime.tv_usec - startTime.tv_usec)) / 1000000.0f;
@@ -19,19 +19,25 @@
  */
 
 /* [Includes] */
-#include <jni.h>
-#include <android/log.h>
-
 #include <GLES2/gl2.h>
 #include <GLES2/gl2ext.h>
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include "Profiler.h"
+#include "Benchmark.h"
+
+#if defined(ANDROID)
+#include <jni.h>
+#include <android/log.h>
 
 #define LOG_TAG "libNative"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+#else
+#include "Platform.h"
+#endif
 /* [Includes] */
 
 /* [Vertex source] */
@@ -183,6 +189,7 @@ void renderFrame()
 }
 /* [renderFrame] */
 
+#if defined(ANDROID)
 extern "C"
 {
     JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_simpletriangle_NativeLibrary_init(
@@ -201,6 +208,11 @@ JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_simpletriangle_Nat
 JNIEXPORT void JNICALL Java_com_arm_malideveloper_openglessdk_simpletriangle_NativeLibrary_step(
                        JNIEnv * env, jobject obj)
 {
+    MaliSDK::ProfileFrame profileFrame;
     renderFrame();
 }
 /* [Native functions] */
+#endif
+
+/* Entry points for malisdk-benchmark. */
+BENCHMARK_SAMPLE("SimpleTriangle", setupGraphics, renderFrame)